@@ -23,7 +23,12 @@
 #pragma once
 
 #include "cinder/PolyLine.h"
+#include "cinder/Shape2d.h"
+#include "cinder/Rect.h"
+#include "cinder/Noncopyable.h"
+#include "cinder/Exception.h"
 
+#include <memory>
 #include <vector>
 
 namespace cinder {
@@ -42,4 +47,62 @@ std::vector<cinder::PolyLine2f> calcMiterOffset( const std::vector<cinder::PolyL
 //! Calculates the squared offset curve of \a poly. Negative \a offset creates inset.
 std::vector<cinder::PolyLine2f> calcSquareOffset( const std::vector<cinder::PolyLine2f> &poly, float offset );
 
+//! Performs boolean operations while keeping converted paths and Clipper's scratch memory from one operation to the next, e.g. from frame to frame. Use one context per thread.
+class ClipperContext : private Noncopyable {
+  public:
+	enum ClipType { INTERSECTION, UNION, DIFFERENCE, XOR };
+	enum JoinType { JOIN_SQUARE, JOIN_ROUND, JOIN_MITER };
+
+	//! Coordinates within \a bounds are converted with as much precision as Clipper's fast 64-bit arithmetic allows. Coordinates beyond them are still handled correctly, but more slowly.
+	ClipperContext( const Rectf &bounds = Rectf( -16384, -16384, 16384, 16384 ) );
+	~ClipperContext();
+
+	//! Sets the bounds which determine the conversion scale. Paths already converted at the previous scale would be misinterpreted, so this throws ClipperExc unless no subject or clip has been set since construction or the last clear().
+	void	setBounds( const Rectf &bounds );
+	//! Discards the subject and clip, keeping their storage, so that setBounds() may be called again
+	void	clear();
+
+	//! Sets the subject, converting it once for any number of subsequent operations
+	void	setSubject( const std::vector<PolyLine2f> &subject );
+	//! Sets the subject to \a shape, flattened directly into Clipper's paths with a tolerance depending on \a approximationScale
+	void	setSubject( const Shape2d &shape, float approximationScale = 1.0f );
+	//! Sets the clip, converting it once for any number of subsequent operations
+	void	setClip( const std::vector<PolyLine2f> &clip );
+	//! Sets the clip to \a shape, flattened directly into Clipper's paths with a tolerance depending on \a approximationScale
+	void	setClip( const Shape2d &shape, float approximationScale = 1.0f );
+
+	//! Calculates \a type of the subject and clip, replacing the contents of \a result while reusing its storage
+	void					calc( ClipType type, std::vector<PolyLine2f> *result );
+	std::vector<PolyLine2f>	calc( ClipType type );
+	//! Calculates the offset curve of the subject, replacing the contents of \a result while reusing its storage. \a limit is the arc tolerance of JOIN_ROUND or the miter limit of JOIN_MITER.
+	void					calcOffset( float offset, JoinType join, double limit, std::vector<PolyLine2f> *result );
+
+  protected:
+	//! Holds Clipper's paths and engines, so that clipper.hpp stays out of this header
+	struct Impl;
+
+	double					mScale;
+	bool					mHasPaths;
+	std::unique_ptr<Impl>	mImpl;
+};
+
+class ClipperExc : public Exception {
+  public:
+	ClipperExc( const std::string &description ) : Exception( description ) {}
+};
+
+//! An independent boolean operation for calcClipOps()
+struct ClipJob {
+	ClipJob() : mType( ClipperContext::UNION ) {}
+	ClipJob( ClipperContext::ClipType type, const std::vector<PolyLine2f> &subject, const std::vector<PolyLine2f> &clip )
+		: mType( type ), mSubject( subject ), mClip( clip )
+	{}
+
+	ClipperContext::ClipType	mType;
+	std::vector<PolyLine2f>		mSubject, mClip;
+};
+
+//! Performs \a jobs in parallel, each converted at the precision its own bounds allow, replacing the contents of \a results with one result per job.
+void calcClipOps( const std::vector<ClipJob> &jobs, std::vector<std::vector<PolyLine2f>> *results );
+
 } // namespace cinder
\ No newline at end of file
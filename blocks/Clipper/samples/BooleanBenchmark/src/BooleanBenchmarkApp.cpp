@@ -0,0 +1,141 @@
+// Times thousands of small independent boolean operations: through the calc*() free functions, a reused ClipperContext, calcClipOps() and directly from Shape2ds.
+// Pass the number of operations as the first argument to benchmark a different size, e.g. BooleanBenchmark 20000
+
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/Rand.h"
+#include "cinder/Thread.h"
+#include "cinder/Timer.h"
+#include "cinder/Utilities.h"
+
+#include "CinderClipper.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+namespace {
+
+PolyLine2f makeStar( const vec2 &center, float innerRadius, float outerRadius, int numPoints )
+{
+	PolyLine2f result;
+	for( int p = 0; p < numPoints * 2; ++p ) {
+		const float angle = p * (float)M_PI / numPoints, radius = ( p & 1 ) ? innerRadius : outerRadius;
+		result.push_back( center + vec2( cos( angle ), sin( angle ) ) * radius );
+	}
+	result.setClosed();
+	return result;
+}
+
+Shape2d makeShape( const PolyLine2f &poly )
+{
+	Shape2d result;
+	result.moveTo( poly.getPoints()[0] );
+	for( size_t p = 1; p < poly.size(); ++p )
+		result.lineTo( poly.getPoints()[p] );
+	result.close();
+	return result;
+}
+
+double calcArea( const vector<PolyLine2f> &polys )
+{
+	double result = 0;
+	for( const auto &poly : polys )
+		result += poly.calcArea();
+	return result;
+}
+
+} // anonymous namespace
+
+class BooleanBenchmarkApp : public App {
+  public:
+	void setup() override;
+	void draw() override;
+
+	void	benchmark( const std::string &name, const std::function<void()> &fn );
+
+	static void prepareSettings( App::Settings *settings ) { getArgs() = Platform::get()->getCommandLineArgs(); }
+	static vector<string>& getArgs() { static vector<string> args; return args; }
+};
+
+void BooleanBenchmarkApp::benchmark( const std::string &name, const std::function<void()> &fn )
+{
+	Timer timer( true );
+	fn();
+	console() << "  " << name << ": " << timer.getSeconds() * 1000 << "ms" << std::endl;
+}
+
+void BooleanBenchmarkApp::setup()
+{
+	const int numOps = ( getArgs().size() >= 2 ) ? fromString<int>( getArgs()[1] ) : 5000;
+
+	// pairs of overlapping stars scattered over a 2000x2000 canvas
+	Rand rnd( 1234 );
+	vector<ClipJob> jobs;
+	vector<Shape2d> subjectShapes, clipShapes;
+	for( int i = 0; i < numOps; ++i ) {
+		const vec2 center( rnd.nextFloat( 2000 ), rnd.nextFloat( 2000 ) );
+		const PolyLine2f subject = makeStar( center, 10, 25, 5 + i % 16 );
+		const PolyLine2f clip = makeStar( center + rnd.nextVec2() * 10.0f, 8, 20, 5 + ( i + 7 ) % 16 );
+		jobs.emplace_back( ClipperContext::ClipType( i % 4 ), vector<PolyLine2f>{ subject }, vector<PolyLine2f>{ clip } );
+		subjectShapes.push_back( makeShape( subject ) );
+		clipShapes.push_back( makeShape( clip ) );
+	}
+	console() << numOps << " boolean operations, " << getNumParallelThreads() << " threads" << std::endl;
+
+	double freeArea = 0;
+	benchmark( "calc*() free functions", [&] {
+		for( auto &job : jobs ) {
+			switch( job.mType ) {
+				case ClipperContext::INTERSECTION: freeArea += calcArea( calcIntersection( job.mSubject, job.mClip ) ); break;
+				case ClipperContext::UNION: freeArea += calcArea( calcUnion( job.mSubject, job.mClip ) ); break;
+				case ClipperContext::DIFFERENCE: freeArea += calcArea( calcDifference( job.mSubject, job.mClip ) ); break;
+				case ClipperContext::XOR: freeArea += calcArea( calcXor( job.mSubject, job.mClip ) ); break;
+			}
+		}
+	} );
+
+	double contextArea = 0;
+	benchmark( "ClipperContext", [&] {
+		ClipperContext context( Rectf( 0, 0, 2048, 2048 ) );
+		vector<PolyLine2f> result;
+		for( const auto &job : jobs ) {
+			context.setSubject( job.mSubject );
+			context.setClip( job.mClip );
+			context.calc( job.mType, &result );
+			contextArea += calcArea( result );
+		}
+	} );
+
+	vector<vector<PolyLine2f>> results;
+	benchmark( "calcClipOps()", [&] {
+		calcClipOps( jobs, &results );
+	} );
+	double batchArea = 0;
+	for( const auto &result : results )
+		batchArea += calcArea( result );
+
+	double shapeArea = 0;
+	benchmark( "ClipperContext from Shape2d", [&] {
+		ClipperContext context( Rectf( 0, 0, 2048, 2048 ) );
+		vector<PolyLine2f> result;
+		for( size_t i = 0; i < jobs.size(); ++i ) {
+			context.setSubject( subjectShapes[i] );
+			context.setClip( clipShapes[i] );
+			context.calc( jobs[i].mType, &result );
+			shapeArea += calcArea( result );
+		}
+	} );
+
+	console() << "  total area: " << freeArea << " / " << contextArea << " / " << batchArea << " / " << shapeArea << std::endl;
+
+	quit();
+}
+
+void BooleanBenchmarkApp::draw()
+{
+	gl::clear();
+}
+
+CINDER_APP( BooleanBenchmarkApp, RendererGl, &BooleanBenchmarkApp::prepareSettings )
@@ -22,103 +22,234 @@
 
 #include "CinderClipper.h"
 #include "clipper.hpp"
+#include "cinder/Thread.h"
+
+#include <cmath>
 
 using namespace std;
 
 namespace cinder {
 
-template<typename T, typename U>
-ClipperLib::Paths toClipper( const vector<PolyLineT<T>> &polys, U mult )
+namespace {
+
+//! Returns the largest power of two which maps \a bounds into Clipper's 64-bit range. Beyond it Clipper switches to much slower 128-bit arithmetic.
+double calcScale( const Rectf &bounds )
 {
-	ClipperLib::Paths result;
-	result.resize( polys.size() );
-	for( size_t c = 0; c < polys.size(); ++c ) {
-		result[c].reserve( polys[c].size() );
-		auto &points = polys[c].getPoints();
-		for( size_t p = 0; p < points.size(); ++p ) {
-			result[c].emplace_back( static_cast<int64_t>(points[p].x * mult), static_cast<int64_t>(points[p].y * mult) ); 
-		}
-	}
-	
+	const double maxAbs = std::max( std::max( std::abs( bounds.x1 ), std::abs( bounds.x2 ) ), std::max( std::abs( bounds.y1 ), std::abs( bounds.y2 ) ) );
+	if( ! ( maxAbs > 0 ) )
+		return 2147483648.0;
+	int exponent;
+	std::frexp( ( ClipperLib::loRange - 1 ) / maxAbs, &exponent );
+	return std::ldexp( 1.0, exponent - 1 );
+}
+
+Rectf calcBounds( const vector<PolyLine2f> &polys, Rectf result = Rectf( 0, 0, 0, 0 ) )
+{
+	for( const auto &poly : polys )
+		for( const auto &point : poly )
+			result.include( point );
 	return result;
-} 
+}
 
-template<typename U>
-vector<PolyLine2f> fromClipper( const ClipperLib::Paths &paths, U mult )
+void toClipper( const vec2 *points, size_t numPoints, double scale, ClipperLib::Path *result )
 {
-	vector<PolyLine2f> result;
-	result.resize( paths.size() );
-	
-	const float invMult = 1.0f / mult;
-	
+	result->resize( numPoints );
+	for( size_t p = 0; p < numPoints; ++p )
+		(*result)[p] = ClipperLib::IntPoint( std::llround( points[p].x * scale ), std::llround( points[p].y * scale ) );
+}
+
+//! Converts \a polys into \a result, reusing the storage of its paths
+void toClipper( const vector<PolyLine2f> &polys, double scale, ClipperLib::Paths *result )
+{
+	result->resize( polys.size() );
+	for( size_t c = 0; c < polys.size(); ++c )
+		toClipper( polys[c].getPoints().data(), polys[c].size(), scale, &(*result)[c] );
+}
+
+void toClipper( const Shape2d &shape, float approximationScale, double scale, vector<vec2> *flattened, vector<uint32_t> *contourOffsets, ClipperLib::Paths *result )
+{
+	shape.flatten( flattened, contourOffsets, approximationScale );
+	result->resize( shape.getContours().size() );
+	for( size_t c = 0; c < result->size(); ++c )
+		toClipper( flattened->data() + (*contourOffsets)[c], (*contourOffsets)[c + 1] - (*contourOffsets)[c], scale, &(*result)[c] );
+}
+
+//! Converts \a paths into \a result, reusing the storage of its PolyLines
+void fromClipper( const ClipperLib::Paths &paths, double scale, vector<PolyLine2f> *result )
+{
+	const double invScale = 1.0 / scale;
+	result->resize( paths.size() );
 	for( size_t c = 0; c < paths.size(); ++c ) {
-		auto &path = paths[c];
-		result[c].getPoints().reserve( path.size() );
-		for( size_t p = 0; p < path.size(); ++p )
-			result[c].getPoints().emplace_back( path[p].X * invMult, path[p].Y * invMult );
-		result[c].setClosed();
+		auto &points = (*result)[c].getPoints();
+		points.resize( paths[c].size() );
+		for( size_t p = 0; p < paths[c].size(); ++p )
+			points[p] = vec2( paths[c][p].X * invScale, paths[c][p].Y * invScale );
+		(*result)[c].setClosed();
 	}
-	
-	return result;
 }
 
-vector<PolyLine2f> calcClipOp( ClipperLib::ClipType op, const vector<PolyLine2f> &subject, vector<PolyLine2f> &clip )
+} // anonymous namespace
+
+vector<PolyLine2f> calcClipOp( ClipperContext::ClipType op, const vector<PolyLine2f> &subject, vector<PolyLine2f> &clip )
 {
-	const float SCALE = 2147483648.0f;
-	auto aClipper = toClipper( subject, SCALE );
-	auto bClipper = toClipper( clip, SCALE );
-	ClipperLib::Paths solution;
-	ClipperLib::Clipper c;
-	c.AddPaths( aClipper, ClipperLib::ptSubject, true );
-	c.AddPaths( bClipper, ClipperLib::ptClip, true );
-	c.Execute( op, solution, ClipperLib::pftNonZero, ClipperLib::pftNonZero );
-	return fromClipper( solution, SCALE );
+	ClipperContext context( calcBounds( clip, calcBounds( subject ) ) );
+	context.setSubject( subject );
+	context.setClip( clip );
+	return context.calc( op );
 }
 
 vector<PolyLine2f> calcIntersection( const vector<PolyLine2f> &a, vector<PolyLine2f> &b )
 {
-	return calcClipOp( ClipperLib::ctIntersection, a, b );
+	return calcClipOp( ClipperContext::INTERSECTION, a, b );
 }
 
 vector<PolyLine2f> calcUnion( const vector<PolyLine2f> &a, vector<PolyLine2f> &b )
 {
-	return calcClipOp( ClipperLib::ctUnion, a, b );
+	return calcClipOp( ClipperContext::UNION, a, b );
 }
 
 vector<PolyLine2f> calcDifference( const vector<PolyLine2f> &subject, vector<PolyLine2f> &clip )
 {
-	return calcClipOp( ClipperLib::ctDifference, subject, clip );
+	return calcClipOp( ClipperContext::DIFFERENCE, subject, clip );
 }
 
 vector<PolyLine2f> calcXor( const vector<PolyLine2f> &a, vector<PolyLine2f> &b )
 {
-	return calcClipOp( ClipperLib::ctXor, a, b );
+	return calcClipOp( ClipperContext::XOR, a, b );
 }
 
-vector<PolyLine2f> calcOffsetOp( ClipperLib::JoinType op, const vector<PolyLine2f> &a, float offset, double miterLimit, double arcTolerance )
+vector<PolyLine2f> calcOffsetOp( ClipperContext::JoinType join, const vector<PolyLine2f> &a, float offset, double limit )
 {
-	const float SCALE = 2147483648.0f;
-	auto aClipper = toClipper( a, SCALE );
-	ClipperLib::Paths solution;
-	ClipperLib::ClipperOffset co( miterLimit, arcTolerance * SCALE ); 
-	co.AddPaths( aClipper, op, ClipperLib::etClosedPolygon );
-	co.Execute( solution, offset * SCALE );
-	return fromClipper( solution, SCALE );
+	// the offset curve extends beyond the input
+	Rectf bounds = calcBounds( a );
+	bounds.inflate( vec2( std::abs( offset ) ) );
+	ClipperContext context( bounds );
+	context.setSubject( a );
+	vector<PolyLine2f> result;
+	context.calcOffset( offset, join, limit, &result );
+	return result;
 }
 
 std::vector<cinder::PolyLine2f> calcRoundOffset( const std::vector<cinder::PolyLine2f> &poly, float offset, double arcTolerance )
 {
-	return calcOffsetOp( ClipperLib::jtRound, poly, offset, 0, arcTolerance );
+	return calcOffsetOp( ClipperContext::JOIN_ROUND, poly, offset, arcTolerance );
 }
 
 std::vector<cinder::PolyLine2f> calcMiterOffset( const std::vector<cinder::PolyLine2f> &poly, float offset, double miterLimit )
 {
-	return calcOffsetOp( ClipperLib::jtMiter, poly, offset, miterLimit, 0 );
+	return calcOffsetOp( ClipperContext::JOIN_MITER, poly, offset, miterLimit );
 }
 
 std::vector<cinder::PolyLine2f> calcSquareOffset( const std::vector<cinder::PolyLine2f> &poly, float offset )
 {
-	return calcOffsetOp( ClipperLib::jtSquare, poly, offset, 0, 0 );
+	return calcOffsetOp( ClipperContext::JOIN_SQUARE, poly, offset, 0 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// ClipperContext
+struct ClipperContext::Impl {
+	ClipperLib::Paths			mSubject, mClip, mSolution;
+	ClipperLib::Clipper			mClipper;
+	ClipperLib::ClipperOffset	mClipperOffset;
+	//! Scratch space for flattening Shape2ds
+	vector<vec2>				mFlattened;
+	vector<uint32_t>			mContourOffsets;
+};
+
+ClipperContext::ClipperContext( const Rectf &bounds )
+	: mHasPaths( false ), mImpl( new Impl )
+{
+	setBounds( bounds );
+}
+
+ClipperContext::~ClipperContext()
+{
+}
+
+void ClipperContext::setBounds( const Rectf &bounds )
+{
+	if( mHasPaths )
+		throw ClipperExc( "ClipperContext::setBounds() called after setSubject() or setClip(); call clear() first" );
+	mScale = calcScale( bounds );
+}
+
+void ClipperContext::clear()
+{
+	mImpl->mSubject.clear();
+	mImpl->mClip.clear();
+	mHasPaths = false;
+}
+
+void ClipperContext::setSubject( const std::vector<PolyLine2f> &subject )
+{
+	toClipper( subject, mScale, &mImpl->mSubject );
+	mHasPaths = true;
+}
+
+void ClipperContext::setSubject( const Shape2d &shape, float approximationScale )
+{
+	toClipper( shape, approximationScale, mScale, &mImpl->mFlattened, &mImpl->mContourOffsets, &mImpl->mSubject );
+	mHasPaths = true;
+}
+
+void ClipperContext::setClip( const std::vector<PolyLine2f> &clip )
+{
+	toClipper( clip, mScale, &mImpl->mClip );
+	mHasPaths = true;
+}
+
+void ClipperContext::setClip( const Shape2d &shape, float approximationScale )
+{
+	toClipper( shape, approximationScale, mScale, &mImpl->mFlattened, &mImpl->mContourOffsets, &mImpl->mClip );
+	mHasPaths = true;
+}
+
+void ClipperContext::calc( ClipType type, std::vector<PolyLine2f> *result )
+{
+	static const ClipperLib::ClipType sClipTypes[] = { ClipperLib::ctIntersection, ClipperLib::ctUnion, ClipperLib::ctDifference, ClipperLib::ctXor };
+
+	ClipperLib::Clipper &clipper = mImpl->mClipper;
+	clipper.Clear();
+	clipper.AddPaths( mImpl->mSubject, ClipperLib::ptSubject, true );
+	clipper.AddPaths( mImpl->mClip, ClipperLib::ptClip, true );
+	clipper.Execute( sClipTypes[type], mImpl->mSolution, ClipperLib::pftNonZero, ClipperLib::pftNonZero );
+	fromClipper( mImpl->mSolution, mScale, result );
+}
+
+std::vector<PolyLine2f> ClipperContext::calc( ClipType type )
+{
+	std::vector<PolyLine2f> result;
+	calc( type, &result );
+	return result;
+}
+
+void ClipperContext::calcOffset( float offset, JoinType join, double limit, std::vector<PolyLine2f> *result )
+{
+	static const ClipperLib::JoinType sJoinTypes[] = { ClipperLib::jtSquare, ClipperLib::jtRound, ClipperLib::jtMiter };
+
+	ClipperLib::ClipperOffset &clipperOffset = mImpl->mClipperOffset;
+	clipperOffset.Clear();
+	clipperOffset.MiterLimit = ( join == JOIN_MITER ) ? limit : 2.0;
+	clipperOffset.ArcTolerance = ( join == JOIN_ROUND ) ? limit * mScale : 0.0;
+	clipperOffset.AddPaths( mImpl->mSubject, sJoinTypes[join], ClipperLib::etClosedPolygon );
+	clipperOffset.Execute( mImpl->mSolution, offset * mScale );
+	fromClipper( mImpl->mSolution, mScale, result );
+}
+
+void calcClipOps( const std::vector<ClipJob> &jobs, std::vector<std::vector<PolyLine2f>> *results )
+{
+	results->resize( jobs.size() );
+	parallelFor( jobs.size(), [&]( size_t begin, size_t end ) {
+		ClipperContext context;
+		for( size_t j = begin; j < end; ++j ) {
+			const ClipJob &job = jobs[j];
+			context.clear();
+			context.setBounds( calcBounds( job.mClip, calcBounds( job.mSubject ) ) );
+			context.setSubject( job.mSubject );
+			context.setClip( job.mClip );
+			context.calc( job.mType, &(*results)[j] );
+		}
+	}, 8 );
 }
 
-} // namespace cinder
\ No newline at end of file
+} // namespace cinder
@@ -0,0 +1,127 @@
+#include "CinderClipper.h"
+
+#include "catch.hpp"
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+PolyLine2f makeRect( const Rectf &rect )
+{
+	PolyLine2f result( { rect.getUpperLeft(), rect.getUpperRight(), rect.getLowerRight(), rect.getLowerLeft() } );
+	result.setClosed();
+	return result;
+}
+
+Shape2d makeShape( const PolyLine2f &poly )
+{
+	Shape2d result;
+	result.moveTo( poly.getPoints()[0] );
+	for( size_t p = 1; p < poly.size(); ++p )
+		result.lineTo( poly.getPoints()[p] );
+	result.close();
+	return result;
+}
+
+double calcArea( const vector<PolyLine2f> &polys )
+{
+	double result = 0;
+	for( const auto &poly : polys )
+		result += poly.calcArea();
+	return result;
+}
+
+const vector<PolyLine2f> sSubject = { makeRect( Rectf( 0, 0, 10, 10 ) ) };
+const vector<PolyLine2f> sClip = { makeRect( Rectf( 5, 5, 15, 20 ) ) };
+
+} // anonymous namespace
+
+TEST_CASE( "ClipperContext" )
+{
+	SECTION( "Boolean operations" )
+	{
+		ClipperContext context;
+		context.setSubject( sSubject );
+		context.setClip( sClip );
+		REQUIRE( calcArea( context.calc( ClipperContext::INTERSECTION ) ) == Approx( 25 ) );
+		REQUIRE( calcArea( context.calc( ClipperContext::UNION ) ) == Approx( 100 + 150 - 25 ) );
+		REQUIRE( calcArea( context.calc( ClipperContext::DIFFERENCE ) ) == Approx( 75 ) );
+		REQUIRE( calcArea( context.calc( ClipperContext::XOR ) ) == Approx( 100 + 150 - 50 ) );
+
+		// reusing the result's storage
+		vector<PolyLine2f> result( 5 );
+		context.calc( ClipperContext::INTERSECTION, &result );
+		REQUIRE( result.size() == 1 );
+		REQUIRE( calcArea( result ) == Approx( 25 ) );
+	}
+
+	SECTION( "Matches the free functions" )
+	{
+		vector<PolyLine2f> clip = sClip;
+		ClipperContext context( Rectf( -100, -100, 100, 100 ) );
+		context.setSubject( sSubject );
+		context.setClip( sClip );
+		REQUIRE( calcArea( context.calc( ClipperContext::UNION ) ) == Approx( calcArea( calcUnion( sSubject, clip ) ) ) );
+		REQUIRE( calcArea( context.calc( ClipperContext::DIFFERENCE ) ) == Approx( calcArea( calcDifference( sSubject, clip ) ) ) );
+
+		vector<PolyLine2f> offset;
+		context.calcOffset( 1, ClipperContext::JOIN_MITER, 2.0, &offset );
+		REQUIRE( calcArea( offset ) == Approx( 144 ) );
+		REQUIRE( calcArea( offset ) == Approx( calcArea( calcMiterOffset( sSubject, 1 ) ) ) );
+	}
+
+	SECTION( "setBounds() requires clear() once paths are set" )
+	{
+		ClipperContext context;
+		context.setBounds( Rectf( 0, 0, 20, 20 ) );
+		context.setSubject( sSubject );
+		REQUIRE_THROWS_AS( context.setBounds( Rectf( 0, 0, 1000, 1000 ) ), ClipperExc );
+
+		context.clear();
+		REQUIRE( context.calc( ClipperContext::UNION ).empty() );
+		context.setBounds( Rectf( 0, 0, 1000, 1000 ) );
+		context.setSubject( sSubject );
+		context.setClip( sClip );
+		REQUIRE( calcArea( context.calc( ClipperContext::INTERSECTION ) ) == Approx( 25 ) );
+	}
+
+	SECTION( "Shape2d input" )
+	{
+		ClipperContext context;
+		context.setSubject( makeShape( sSubject[0] ) );
+		context.setClip( makeShape( sClip[0] ) );
+		REQUIRE( calcArea( context.calc( ClipperContext::INTERSECTION ) ) == Approx( 25 ) );
+
+		// curves are flattened, and mixed with PolyLine input
+		Shape2d circle;
+		circle.arc( vec2( 0 ), 5, 0, 2 * (float)M_PI );
+		circle.close();
+		context.setSubject( circle, 20.0f );
+		context.setClip( { makeRect( Rectf( 0, -10, 10, 10 ) ) } );
+		REQUIRE( calcArea( context.calc( ClipperContext::INTERSECTION ) ) == Approx( M_PI * 25 / 2 ).epsilon( 0.01 ) );
+	}
+}
+
+TEST_CASE( "calcClipOps" )
+{
+	// jobs at very different scales, each converted at its own precision
+	vector<ClipJob> jobs;
+	for( int i = 0; i < 100; ++i ) {
+		const float scale = ( i % 2 ) ? 1000.0f : 0.01f;
+		const vector<PolyLine2f> subject = { makeRect( Rectf( 0, 0, 10 * scale, 10 * scale ) ) };
+		const vector<PolyLine2f> clip = { makeRect( Rectf( 5 * scale, 5 * scale, 15 * scale, 20 * scale ) ) };
+		jobs.emplace_back( ClipperContext::ClipType( i % 4 ), subject, clip );
+	}
+
+	vector<vector<PolyLine2f>> results( 3 );
+	calcClipOps( jobs, &results );
+	REQUIRE( results.size() == jobs.size() );
+	for( size_t j = 0; j < jobs.size(); ++j ) {
+		ClipperContext context( Rectf( 0, 0, 15, 20 ).scaled( ( j % 2 ) ? 1000.0f : 0.01f ) );
+		context.setSubject( jobs[j].mSubject );
+		context.setClip( jobs[j].mClip );
+		REQUIRE( calcArea( results[j] ) == Approx( calcArea( context.calc( jobs[j].mType ) ) ) );
+		REQUIRE( calcArea( results[j] ) > 0 );
+	}
+}
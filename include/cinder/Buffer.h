@@ -23,10 +23,13 @@
 #pragma once
 
 #include "cinder/Cinder.h"
+#include <atomic>
 #include <deque>
+#include <memory>
 #include <mutex>
 
 #define DEFAULT_COMPRESSION_LEVEL 6
+#define DEFAULT_COMPRESSION_BLOCK_SIZE 131072
 
 namespace cinder {
 
@@ -81,27 +84,44 @@ class CI_API Buffer {
 	bool	mOwnsData;
 };
 
-//! Thread-safe single-producer, single-consumer block-based double-ended byte queue
+/** \brief Lock-free single-producer, single-consumer block-based double-ended byte queue
+ *
+ * Data is stored in a chain of fixed-size blocks. Fully consumed blocks are recycled through a free list, so once
+ * the buffer has grown to its working size the producer no longer allocates.
+ *
+ * One producer thread may call pushFront(), acquireWrite() and commitWrite() while one consumer thread calls popBack(),
+ * peekRead(), consume() and copyTo(). getSize(), empty(), clear() and shrinkToFit() may be called from any thread. */
 class CI_API StreamingBuffer {
   public:
-	StreamingBuffer( size_t blockSizeBytes = 65536 );
+	//! Constructs a StreamingBuffer of \a blockSizeBytes blocks, allocating \a numPreallocatedBlocks up front
+	StreamingBuffer( size_t blockSizeBytes = 65536, size_t numPreallocatedBlocks = 2 );
+	~StreamingBuffer();
 
-	//! pushes \a sizeBytes bytes at the front of the deque
+	//! pushes \a sizeBytes bytes at the front of the deque. Producer only.
 	void	pushFront( const void *data, size_t sizeBytes );
-	//! pops up to \a maxSize bytes from the back of the deque. Returns the number of bytes popped, which may be 0.
+	//! pops up to \a maxSize bytes from the back of the deque. Returns the number of bytes popped, which may be 0. Consumer only.
 	size_t	popBack( void *output, size_t maxSize );
 
-	//! returns the number of bytes currently in the deque
+	//! Returns contiguous space for writing up to \a maxSize bytes at the front of the deque, storing the available size in \a size. This may be less than \a maxSize when the current block is nearly full. Producer only.
+	void*		acquireWrite( size_t maxSize, size_t *size );
+	//! Publishes \a sizeBytes bytes written to the space returned by the previous acquireWrite() to the consumer. Producer only.
+	void		commitWrite( size_t sizeBytes );
+	//! Returns the contiguous readable data at the back of the deque, storing its size in \a size, which is 0 when empty. Consumer only.
+	const void*	peekRead( size_t *size );
+	//! Releases \a sizeBytes bytes from the back of the deque, which must not exceed the size returned by peekRead(). Consumer only.
+	void		consume( size_t sizeBytes );
+
+	//! returns the number of bytes currently in the deque. Any thread.
 	size_t	getSize() const;
 
-	//! returns \c true if the deque is empty
+	//! returns \c true if the deque is empty. Any thread.
 	bool 	empty() const { return getSize() == 0; }
-	//! clears all data in the deque but does not deallocate internal storage
+	//! clears all data in the deque but does not deallocate internal storage. Any thread. The consumer releases the discarded blocks on its next access.
 	void	clear();
-	//! deallocates internal storage to precisely fit current size
+	//! deallocates recycled blocks which are not currently in use. Any thread. Blocks the producer has already taken for reuse are deallocated on its next block change.
 	void	shrinkToFit();
 
-	//! Performs a non-destructive copy to \a output, up to \a maxSize bytes. Does not pop any data. Returns number of bytes written
+	//! Performs a non-destructive copy to \a output, up to \a maxSize bytes. Does not pop any data. Returns number of bytes written. Consumer only.
 	size_t	copyTo( void *output, size_t maxSize ) const;
 
   private:
@@ -111,18 +131,45 @@ class CI_API StreamingBuffer {
 	StreamingBuffer&	operator=( const StreamingBuffer &rhs ) = delete;
 	StreamingBuffer&	operator=( StreamingBuffer &&rhs ) = delete;
 
-	void	allocateNewWriteBlock();
-	void	releaseCurrentReadBlock();
-	size_t	calcSize() const;
+	struct Block {
+		Block( size_t size ) : mData( new uint8_t[size] ), mNext( nullptr ) {}
+
+		std::unique_ptr<uint8_t[]>	mData;
+		std::atomic<Block*>			mNext;
+	};
+
+	Block*	acquireFreeBlock();
+	void	releaseBlock( Block *block );
+	static void	deleteBlocks( Block *list );
+	void	advanceReadBlock();
+	void	advanceRead( size_t sizeBytes );
+	void	applyClear();
+
+	const size_t				mBlockSize;
+
+	// producer state
+	alignas( 64 ) Block*		mWriteBlock;
+	size_t						mWriteOffset; // expressed in bytes, within mWriteBlock
+	std::atomic<uint64_t>		mTotalWritten;
+	Block*						mProducerFreeBlocks; // recycled blocks taken from mFreeBlocks
+
+	// consumer state
+	alignas( 64 ) Block*		mReadBlock;
+	size_t						mReadOffset; // expressed in bytes, within mReadBlock
+	std::atomic<uint64_t>		mTotalRead;
 
-	std::deque<std::unique_ptr<uint8_t[]>>		mBlocks, mUnusedBlocks;
+	// everything written before this was discarded by clear(); applied by the consumer
+	std::atomic<uint64_t>		mClearedTo;
 
-	mutable std::mutex					mMutex;
-	const size_t						mBlockSize;
-	size_t								mWriteOffset, mReadOffset; // expressed in bytes
+	// recycled blocks; pushed one at a time by the consumer and taken all at once by the producer or shrinkToFit(), so no thread reads a block another may take
+	alignas( 64 ) std::atomic<Block*>	mFreeBlocks;
+	// set by shrinkToFit() so that the producer deletes mProducerFreeBlocks
+	std::atomic<bool>					mShrinkRequested;
 };
 
 CI_API Buffer compressBuffer( const Buffer &buffer, int8_t compressionLevel = DEFAULT_COMPRESSION_LEVEL, bool resizeResult = true );
+//! Deflates \a buffer as independently compressed blocks of \a blockSize bytes spread across all cores. The result is a standard zlib (or gzip, if \a useGZip) stream, readable by decompressBuffer(). \see CompressingOStream
+CI_API Buffer compressBufferChunked( const Buffer &buffer, int8_t compressionLevel = DEFAULT_COMPRESSION_LEVEL, bool useGZip = false, size_t blockSize = DEFAULT_COMPRESSION_BLOCK_SIZE );
 CI_API Buffer decompressBuffer( const Buffer &buffer, bool resizeResult = true, bool useGZip = false );
 
 } //namespace
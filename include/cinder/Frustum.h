@@ -47,6 +47,15 @@ class CI_API FrustumT {
 	typedef glm::tvec3<T, glm::defaultp> Vec3T;
 	typedef glm::tmat4x4<T, glm::defaultp> Mat4T;
 
+	//! Counts reported by the batch culling functions, for monitoring how much they cull
+	struct CullResult {
+		CullResult() : mNumTested( 0 ), mNumVisible( 0 ) {}
+
+		size_t	getNumCulled() const { return mNumTested - mNumVisible; }
+
+		size_t	mNumTested, mNumVisible;
+	};
+
   public:
 	FrustumT() {}
 	//! Creates a world space frustum based on the camera's parameters.
@@ -87,6 +96,14 @@ class CI_API FrustumT {
 	//! Returns true if the box is fully or partially contained within frustum. See also 'contains'.
 	bool intersects( const AxisAlignedBox &box ) const;
 
+	/*! Tests \a numSpheres spheres, given as separate arrays of center coordinates and radii, as intersects() would. Writes the indices of the
+		spheres that are fully or partially within the frustum to \a visibleIndices in increasing order, which must hold \a numSpheres entries.
+		Tests eight or four spheres at a time with SIMD instructions where available, in parallel for large batches. */
+	CullResult	cullSpheres( const float *centersX, const float *centersY, const float *centersZ, const float *radii, size_t numSpheres, uint32_t *visibleIndices ) const;
+	//! Like cullSpheres() for boxes given as separate arrays of center coordinates and extents, which are half the boxes' sizes.
+	CullResult	cullBoxes( const float *centersX, const float *centersY, const float *centersZ, const float *extentsX, const float *extentsY, const float *extentsZ,
+						size_t numBoxes, uint32_t *visibleIndices ) const;
+
 	//! Returns a const reference to the Plane associated with /a section of the Frustum.
 	const PlaneT<T>& getPlane( FrustumSection section ) const { return mFrustumPlanes[section]; }
 	
@@ -29,6 +29,7 @@
 #include "cinder/Vector.h"
 #include "cinder/Matrix.h"
 #include "cinder/Shape2d.h"
+#include "cinder/PolyLine.h"
 #include "cinder/Color.h"
 #include "cinder/AxisAlignedBox.h"
 
@@ -37,6 +38,13 @@
 #include <map>
 #include <algorithm>
 #include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
 
 // Forward declarations in cinder::
 namespace cinder {
@@ -136,6 +144,43 @@ class CI_API BufferLayout {
 	std::vector<AttribInfo>		mAttribs;
 };
 
+//! Identifies the geometry a Source or Modifier produces by its type and parameters, so that SourceCache can share it between equal Sources
+class CI_API CacheKey {
+  public:
+	//! Appends the bytes of \a value, which needs to be a plain value type (scalars, enums, glm vectors and matrices) without padding
+	template<typename T>
+	CacheKey&	operator<<( const T &value )
+	{
+		static_assert( std::is_standard_layout<T>::value && ! std::is_pointer<T>::value, "CacheKey only accepts plain values" );
+		mData.append( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+		return *this;
+	}
+	//! Appends the name of \a type, typically <tt>typeid( *this )</tt>
+	CacheKey&	operator<<( const std::type_info &type );
+	//! Appends \a key, prefixed by its length so that nested keys stay unambiguous
+	CacheKey&	operator<<( const CacheKey &key );
+	//! Appends the type of \a object, typically \c *this, and returns \c true if it is exactly \a T or one of \a StatelessSubclasses, which only preset parameters of \a T. Returns \c false for any other subclass, whose own members the parameters of \a T wouldn't capture.
+	template<typename T, typename... StatelessSubclasses>
+	bool		appendType( const T &object )
+	{
+		const std::type_info *types[] = { &typeid( T ), &typeid( StatelessSubclasses )... };
+		for( const std::type_info *type : types ) {
+			if( typeid( object ) == *type ) {
+				*this << *type;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool				operator==( const CacheKey &rhs ) const { return mData == rhs.mData; }
+	bool				operator!=( const CacheKey &rhs ) const { return mData != rhs.mData; }
+	const std::string&	getData() const { return mData; }
+
+  private:
+	std::string		mData;
+};
+
 class CI_API Source {
   public:
 	virtual ~Source() {}
@@ -147,6 +192,8 @@ class CI_API Source {
 	
 	virtual void		loadInto( Target *target, const AttribSet &requestedAttribs ) const = 0;
 	virtual Source*		clone() const = 0;
+	//! Appends the type and every parameter that affects loadInto() to \a key and returns \c true, or returns \c false if the Source can't be cached, which is the default. Subclasses of a cacheable Source aren't cached unless they override this as well, appending all of their parameters. \see CacheKey::appendType()
+	virtual bool		calcCacheKey( CacheKey * /*key*/ ) const { return false; }
 
   protected:
 	//! Builds a sequential list of vertices to simulate an indexed geometry when Source is non-indexed. Assumes \a dest contains storage for getNumVertices() entries
@@ -195,6 +242,9 @@ class CI_API Modifier {
 		size_t		mNumVertices, mNumIndices;
 		Primitive	mPrimitive;
 		AttribSet	mAvaliableAttribs;
+		//! The SourceMods and the number of its Modifiers upstream, which SourceModsContext( const Params& ) uses to capture the input of Modifiers whose counts depend on the data
+		const SourceMods	*mSourceMods;
+		size_t				mNumModifiers;
 		
 		friend class SourceMods;
 	};
@@ -210,6 +260,8 @@ class CI_API Modifier {
 	virtual AttribSet	getAvailableAttribs( const Modifier::Params &upstreamParams ) const;
 	
 	virtual void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const = 0;
+	//! Appends the type and every parameter that affects process() to \a key and returns \c true, or returns \c false if the Modifier can't be cached, which is the default and applies to Modifiers which call functions or write results outside the geometry. As with Source::calcCacheKey(), subclasses need to override this to be cached.
+	virtual bool		calcCacheKey( CacheKey * /*key*/ ) const { return false; }
 };
 
 class CI_API Rect : public Source {
@@ -297,6 +349,7 @@ class CI_API Cube : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Cube*		clone() const override { return new Cube( *this ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 
   protected:
 	ivec3					mSubdivisions;
@@ -381,6 +434,7 @@ class CI_API Icosphere : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Icosphere*	clone() const override { return new Icosphere( *this ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 
   protected:
 	void	calculate() const;
@@ -408,6 +462,7 @@ class CI_API Teapot : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Teapot*		clone() const override { return new Teapot( *this ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 
   protected:
 	void			calculate( std::vector<float> *positions, std::vector<float> *normals, std::vector<float> *texCoords, std::vector<uint32_t> *indices ) const;
@@ -500,6 +555,7 @@ class CI_API Sphere : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Sphere*		clone() const override { return new Sphere( *this ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 
   protected:
 	void		numRingsAndSegments( int *numRings, int *numSegments ) const;
@@ -534,6 +590,7 @@ class CI_API Capsule : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Capsule*	clone() const override { return new Capsule( *this ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 
   private:
 	void	updateCounts();
@@ -572,6 +629,7 @@ class CI_API Torus : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Torus*		clone() const override { return new Torus( *this ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 
   protected:
 	void		updateCounts();
@@ -614,6 +672,7 @@ public:
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	TorusKnot*	clone() const override { return new TorusKnot( *this ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 
 protected:
 	void		calculate( std::vector<vec3> *positions, std::vector<vec3> *normals, std::vector<vec2> *texCoords, std::vector<vec3> *colors, std::vector<vec3> *tangents, std::vector<uint32_t> *indices ) const;
@@ -699,6 +758,7 @@ class CI_API Cylinder : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Cylinder*	clone() const override { return new Cylinder( *this ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 
   protected:
 	void	updateCounts();
@@ -767,6 +827,7 @@ class CI_API Plane : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Plane*		clone() const override { return new Plane( *this ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 
   protected:
 	ivec2		mSubdivisions;
@@ -881,6 +942,160 @@ class CI_API BSpline : public Source {
 	std::vector<vec3>		mNormals;
 };
 
+/** Extracts the surface where a scalar field crosses an iso value with marching cubes, as TRIANGLES with positions and normals from the field's gradient.
+	The field is sampled on a grid of \a resolution points per axis spanning \a bounds, either from a callback or a dense grid with x varying fastest.
+	Values below the iso value are inside, and normals point towards increasing values, as for signed distance fields; negate fields like metaballs.
+	Extraction runs in parallel over slabs of grid layers, sharing vertices between cells, and caches each slab's output. After markDirty(), only the
+	slabs overlapping the changed region are extracted again. A callback is evaluated concurrently and must be thread-safe.
+	The const accessors may be called from several threads at once, which serialize on the cache; changing the field may not overlap them. */
+class CI_API Isosurface : public Source {
+  public:
+	typedef std::function<float( const vec3 &position )>	FieldFn;
+
+	//! Samples \a fieldFn at \a resolution grid points per axis spanning \a bounds.
+	Isosurface( const FieldFn &fieldFn, const AxisAlignedBox &bounds, const ivec3 &resolution );
+	//! Extracts the surface of the dense grid \a samples, which holds \a resolution points per axis spanning \a bounds, x varying fastest.
+	Isosurface( const std::vector<float> &samples, const AxisAlignedBox &bounds, const ivec3 &resolution );
+
+	//! Sets the field value of the surface. Default is \c 0.
+	Isosurface&		isoValue( float value ) { mIsoValue = value; markDirty(); return *this; }
+	//! Replaces the field callback, marking everything dirty.
+	Isosurface&		field( const FieldFn &fieldFn ) { mFieldFn = fieldFn; mSamples.clear(); markDirty(); return *this; }
+	//! Replaces the dense grid, which must hold as many samples as before, marking everything dirty.
+	Isosurface&		samples( const std::vector<float> &samples );
+
+	//! Returns the dense grid for in-place updates, which must be followed by markDirty(). Empty when sampling a callback.
+	std::vector<float>&	getSamples() { return mSamples; }
+	float				getIsoValue() const { return mIsoValue; }
+	const AxisAlignedBox&	getBounds() const { return mBounds; }
+	const ivec3&		getResolution() const { return mResolution; }
+	//! Returns the number of slabs the grid is divided into, each of which is extracted independently.
+	size_t				getNumSlabs() const { return mSlabs.size(); }
+	//! Returns the number of slabs which were extracted by the last extraction, for profiling incremental updates.
+	size_t				getNumSlabsExtracted() const { std::lock_guard<std::mutex> lock( mCacheMutex ); return mNumSlabsExtracted; }
+
+	//! Marks the field as changed everywhere.
+	Isosurface&		markDirty();
+	//! Marks the field as changed within \a region, so the next extraction only revisits the slabs it affects.
+	Isosurface&		markDirty( const AxisAlignedBox &region );
+
+	size_t		getNumVertices() const override;
+	size_t		getNumIndices() const override;
+	Primitive	getPrimitive() const override { return Primitive::TRIANGLES; }
+	uint8_t		getAttribDims( Attrib attr ) const override;
+	AttribSet	getAvailableAttribs() const override;
+	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
+	Isosurface*	clone() const override { std::lock_guard<std::mutex> lock( mCacheMutex ); return new Isosurface( *this ); }
+
+  protected:
+	//! The cached output of the cell layers [mBeginLayer, mEndLayer)
+	struct Slab {
+		int						mBeginLayer, mEndLayer;
+		bool					mDirty;
+		std::vector<vec3>		mPositions, mNormals;
+		//! Local vertex indices, or for edges in the next slab's first plane, NEXT_SLAB | that edge's index in mFirstPlaneVertices
+		std::vector<uint32_t>	mIndices;
+		//! Vertices of the x edges and then the y edges in the first grid plane, as the previous slab refers to them
+		std::vector<uint32_t>	mFirstPlaneVertices;
+	};
+
+	//! Guards the caches below, which the const accessors fill in. Copies get a mutex of their own.
+	struct CacheMutex : std::mutex {
+		CacheMutex() = default;
+		CacheMutex( const CacheMutex & ) {}
+		CacheMutex& operator=( const CacheMutex & ) { return *this; }
+	};
+
+	void		init();
+	//! Extracts the dirty slabs and assembles the output, if anything is dirty. Requires mCacheMutex to be locked.
+	void		update() const;
+	void		extractSlab( Slab *slab, bool lastSlab ) const;
+
+	FieldFn					mFieldFn;
+	std::vector<float>		mSamples;
+	AxisAlignedBox			mBounds;
+	ivec3					mResolution;
+	float					mIsoValue;
+
+	mutable CacheMutex				mCacheMutex;
+	mutable std::vector<Slab>		mSlabs;
+	mutable bool					mDirty;
+	mutable size_t					mNumSlabsExtracted;
+	mutable std::vector<vec3>		mPositions, mNormals;
+	mutable std::vector<uint32_t>	mIndices;
+};
+
+//! Generates triangles covering wide 2D lines, with miter, round or bevel joins, butt, round or square caps, dashes and optional per-point widths and colors.
+//! Any number of lines can be appended; they are stroked in parallel into a single mesh, which can be drawn with one gl::Batch. Where a line overlaps itself it is covered more than once.
+class CI_API Stroke : public Source {
+  public:
+	enum Join { JOIN_MITER, JOIN_ROUND, JOIN_BEVEL };
+	enum Cap { CAP_BUTT, CAP_ROUND, CAP_SQUARE };
+
+	Stroke();
+	Stroke( const PolyLine2f &polyLine, float width = 1.0f );
+	Stroke( const Path2d &path, float width = 1.0f, float approximationScale = 1.0f );
+	Stroke( const Shape2d &shape, float width = 1.0f, float approximationScale = 1.0f );
+
+	//! Appends \a polyLine, which is stroked as a loop when it is closed. \a widths and \a colors may hold a value per point, overriding width() and color() for this line.
+	Stroke&		append( const PolyLine2f &polyLine, const std::vector<float> &widths = std::vector<float>(), const std::vector<ColorAf> &colors = std::vector<ColorAf>() );
+	//! Appends \a path, flattened according to the current approximationScale()
+	Stroke&		append( const Path2d &path );
+	//! Appends each contour of \a shape, flattened according to the current approximationScale()
+	Stroke&		append( const Shape2d &shape );
+	//! Removes every line
+	Stroke&		clear();
+
+	//! Sets the width of lines without per-point widths. Default is \c 1.
+	Stroke&		width( float width ) { mWidth = width; mDirty = true; return *this; }
+	Stroke&		join( Join join ) { mJoin = join; mDirty = true; return *this; }
+	//! Sets the longest miter, as a multiple of the line width, before a miter join is beveled instead. Default is \c 4, as in SVG.
+	Stroke&		miterLimit( float limit ) { mMiterLimit = limit; mDirty = true; return *this; }
+	Stroke&		cap( Cap cap ) { mCap = cap; mDirty = true; return *this; }
+	//! Strokes only the dashes of \a pattern, which alternates the lengths of dashes and gaps, starting \a offset along the pattern. An empty pattern strokes solid lines.
+	Stroke&		dashes( const std::vector<float> &pattern, float offset = 0 ) { mDashPattern = pattern; mDashOffset = offset; mDirty = true; return *this; }
+	//! Enables the COLOR attrib, using \a color for lines without per-point colors
+	Stroke&		color( const ColorAf &color ) { mColor = color; mHasColors = true; mDirty = true; return *this; }
+	//! Sets the accuracy of round joins and caps and of the Path2ds and Shape2ds appended afterwards, with 1.0 corresponding to 1:1 with screen space. Default is \c 1.
+	Stroke&		approximationScale( float scale ) { mApproximationScale = scale; mDirty = true; return *this; }
+
+	size_t		getNumLines() const { return mLines.size(); }
+
+	size_t		getNumVertices() const override;
+	size_t		getNumIndices() const override;
+	Primitive	getPrimitive() const override { return Primitive::TRIANGLES; }
+	//! POSITION has 2 dimensions. TEX_COORD_0 holds the distance along the line and \c 0 to \c 1 across it. COLOR is available once color() is called or a line has per-point colors.
+	uint8_t		getAttribDims( Attrib attr ) const override;
+	AttribSet	getAvailableAttribs() const override;
+	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
+	Stroke*		clone() const override { return new Stroke( *this ); }
+
+  protected:
+	struct Line {
+		std::vector<vec2>		mPoints;
+		//! Empty when the line uses the uniform width and color
+		std::vector<float>		mWidths;
+		std::vector<ColorAf>	mColors;
+		bool					mClosed;
+	};
+
+	//! Strokes every line if anything changed
+	void		update() const;
+
+	std::vector<Line>		mLines;
+	float					mWidth, mMiterLimit, mDashOffset, mApproximationScale;
+	Join					mJoin;
+	Cap						mCap;
+	std::vector<float>		mDashPattern;
+	ColorAf					mColor;
+	bool					mHasColors;
+
+	mutable bool					mDirty;
+	mutable std::vector<vec2>		mPositions, mTexCoords;
+	mutable std::vector<ColorAf>	mColors;
+	mutable std::vector<uint32_t>	mIndices;
+};
+
 //////////////////////////////////////////////////////////////////////////////////////
 // Wireframe primitives
 class CI_API WireSource : public Source {
@@ -1220,6 +1435,7 @@ class CI_API Transform : public Modifier {
 	
 	// Inherited from Modifier
 	Modifier*			clone() const override { return new Transform( mTransform ); }
+	bool				calcCacheKey( CacheKey *key ) const override;
 	uint8_t				getAttribDims( Attrib attr, uint8_t upstreamDims ) const override;
 	void				process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
 
@@ -1267,6 +1483,7 @@ class CI_API Twist : public Modifier {
 	Twist&		endAngle( float radians ) { mEndAngle = radians; return *this; }
 
 	Modifier*	clone() const override { return new Twist( *this ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
 	
   protected:
@@ -1278,6 +1495,7 @@ class CI_API Twist : public Modifier {
 class CI_API Lines : public Modifier {
   public:
 	Modifier*	clone() const override { return new Lines(); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 
 	size_t		getNumIndices( const Modifier::Params &upstreamParams ) const override;
 	Primitive	getPrimitive( const Modifier::Params &/*upstreamParams*/ ) const override { return geom::LINES; }
@@ -1329,6 +1547,7 @@ class CI_API Constant : public Modifier {
 		: mAttrib( attrib ), mValue( v ), mDims( 4 ) {}
 
 	Modifier*	clone() const override { return new geom::Constant( *this ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 	uint8_t		getAttribDims( Attrib attr, uint8_t upstreamDims ) const override;
 	AttribSet	getAvailableAttribs( const Modifier::Params &upstreamParams ) const override;
 
@@ -1381,6 +1600,7 @@ class CI_API VertexNormalLines : public Modifier {
 	AttribSet	getAvailableAttribs( const Modifier::Params &upstreamParams ) const override;
 
 	Modifier*	clone() const override { return new VertexNormalLines( mLength, mAttrib ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
 
   protected:
@@ -1397,6 +1617,7 @@ class CI_API Tangents : public Modifier {
 	AttribSet	getAvailableAttribs( const Modifier::Params &upstreamParams ) const override;
 	
 	Modifier*	clone() const override { return new Tangents; }
+	bool		calcCacheKey( CacheKey *key ) const override;
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
 };
 
@@ -1408,6 +1629,7 @@ class CI_API Invert : public Modifier {
 	{}
 
 	Modifier*	clone() const override { return new Invert( mAttrib ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
 
   protected:
@@ -1425,6 +1647,7 @@ class CI_API Remove : public Modifier {
 	AttribSet	getAvailableAttribs( const Modifier::Params &upstreamParams ) const override;	
 	
 	Modifier*	clone() const override { return new Remove( mAttrib ); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
 	
   protected:
@@ -1458,9 +1681,75 @@ class CI_API Subdivide : public Modifier {
 	size_t		getNumIndices( const Modifier::Params &upstreamParams ) const override;
 	
 	Modifier*	clone() const override { return new Subdivide(); }
+	bool		calcCacheKey( CacheKey *key ) const override;
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
 };
 
+/*! Reduces the triangle count with quadric error metric edge collapses (Garland & Heckbert), keeping the surviving vertex of each collapse in place.
+	Weighted attributes extend the quadrics with their gradients across each triangle so that collapses which distort normals, texture coordinates or colors are deferred.
+	Vertices which share a position and all weighted attributes are merged first; unweighted attributes follow the surviving vertex.
+	Open boundaries and attribute seams only collapse along themselves. Requires TRIANGLES and 3D POSITION.
+	Reporting exact counts requires the simplified mesh, which is kept for the next process() of the same Source so that each load simplifies once. Every load after that simplifies the current upstream geometry again. */
+class CI_API Simplify : public Modifier {
+  public:
+	Simplify();
+
+	//! Sets the fraction of triangles to keep. Default is \c 0.5.
+	Simplify&	ratio( float ratio ) { mRatio = ratio; return *this; }
+	//! Stops once the next collapse would exceed \a error, a fraction of the largest bounding box extent. Unlimited by default.
+	Simplify&	maxError( float error ) { mMaxError = error; return *this; }
+	//! Locks every vertex on an open boundary when \a preserve is \c true. Otherwise boundary vertices may collapse along the boundary. Default is \c false.
+	Simplify&	preserveBoundaries( bool preserve = true ) { mPreserveBoundaries = preserve; return *this; }
+	//! Sets how strongly deviations in \a attrib count towards the error. \c 0 carries the attribute along without affecting the error. Defaults are \c 0.5 for NORMAL and \c 1 for TEX_COORD_0 and COLOR.
+	Simplify&	attribWeight( Attrib attrib, float weight ) { mAttribWeights[attrib] = weight; return *this; }
+	//! Receives the error of the simplified mesh, as a fraction of the largest bounding box extent.
+	Simplify&	resultError( float *result ) { mResultError = result; return *this; }
+
+	float		getRatio() const { return mRatio; }
+	float		getMaxError() const { return mMaxError; }
+	bool		getPreserveBoundaries() const { return mPreserveBoundaries; }
+	float		getAttribWeight( Attrib attrib ) const;
+
+	size_t		getNumVertices( const Modifier::Params &upstreamParams ) const override;
+	size_t		getNumIndices( const Modifier::Params &upstreamParams ) const override;
+
+	Modifier*	clone() const override;
+	//! Returns \c false when resultError() is set
+	bool		calcCacheKey( CacheKey *key ) const override;
+	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
+
+  protected:
+	struct Result;
+
+	//! Returns the attributes to load from upstream, which include every weighted attribute so that the result doesn't depend on \a requestedAttribs
+	AttribSet	calcUpstreamAttribs( const AttribSet &requestedAttribs ) const;
+	//! Simplifies the geometry in \a ctx, or returns \c nullptr if it isn't TRIANGLES with 3D POSITION
+	std::shared_ptr<Result>			simplify( SourceModsContext *ctx, const AttribSet &attribs ) const;
+	//! Returns the simplified input described by \a upstreamParams, reusing the result of an earlier count query for the same load
+	std::shared_ptr<const Result>	getResult( const Modifier::Params &upstreamParams ) const;
+	//! Removes the result of the count queries and returns it if it was simplified from \a source
+	std::shared_ptr<const Result>	takeResult( const Source *source ) const;
+
+	//! The result of the count queries preceding a load, which process() consumes. Guarded by \a mMutex and never copied.
+	struct PendingResult {
+		PendingResult() : mSource( nullptr ), mNumVertices( 0 ), mNumIndices( 0 ) {}
+		PendingResult( const PendingResult & ) : PendingResult() {}
+		PendingResult& operator=( const PendingResult & ) { return *this; }
+
+		std::mutex						mMutex;
+		const Source					*mSource;
+		size_t							mNumVertices, mNumIndices; // upstream counts
+		std::shared_ptr<const Result>	mResult;
+	};
+
+	float					mRatio, mMaxError;
+	bool					mPreserveBoundaries;
+	std::map<Attrib,float>	mAttribWeights;
+	float					*mResultError;
+
+	mutable PendingResult	mPending;
+};
+
 
 ////////////////////////////////////////////////////////////////////////////////
 //! Base class for SourceMods<> and SourceModsPtr<>
@@ -1470,6 +1759,8 @@ class CI_API SourceModsContext : public Target {
 	SourceModsContext( const SourceMods *sourceMods );
 	//! Can be used to capture a Source. Calling loadInto() in this case is an error.
 	SourceModsContext();
+	//! Captures the input of the Modifier which received \a upstreamParams when preload() is called. Calling loadInto() in this case is an error.
+	explicit SourceModsContext( const Modifier::Params &upstreamParams );
 
 	// called by SourceMods::loadInto()
 	void			loadInto( Target *target, const AttribSet &requestedAttribs );
@@ -1498,6 +1789,9 @@ class CI_API SourceModsContext : public Target {
 	uint32_t*		getIndicesData();
 	const uint32_t*	getIndicesData() const { return const_cast<SourceModsContext*>( this )->getIndicesData(); }
 	
+	//! Returns the Source at the start of the chain, which identifies the geometry being loaded
+	const Source*	getSource() const { return mSource; }
+
 	void			preload( const AttribSet &requestedAttribs );
 	void			combine( const SourceModsContext &rhs );
 	void			complete( Target *target, const AttribSet &requestedAttribs );
@@ -1583,6 +1877,8 @@ class CI_API SourceMods : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	SourceMods*	clone() const override { return new SourceMods( *this ); }
+	//! Combines the keys of the Source, children and Modifiers, and returns \c false if any of them can't be cached, such as a Modifier calling a function
+	bool		calcCacheKey( CacheKey *key ) const override;
 
   protected:
 	void		copyImpl( const SourceMods &rhs );
@@ -1644,6 +1940,81 @@ inline SourceMods operator&( const Source *source, const Modifier &modifier )
 	return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//! Geometry captured by loading a Source once. Copies share the captured attribute and index buffers, which are never modified, and loadInto() repeats the calls the Source made.
+class CI_API CachedSource : public Source {
+  public:
+	//! Captures \a source loaded with \a requestedAttribs
+	CachedSource( const Source &source, const AttribSet &requestedAttribs );
+
+	size_t			getNumVertices() const override;
+	size_t			getNumIndices() const override;
+	Primitive		getPrimitive() const override;
+	uint8_t			getAttribDims( Attrib attr ) const override;
+	AttribSet		getAvailableAttribs() const override;
+	void			loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
+	CachedSource*	clone() const override { return new CachedSource( *this ); }
+
+	//! Returns the captured data for \a attr, tightly packed with getAttribDims() floats per vertex, or \c nullptr if the Source didn't provide it
+	const float*	getAttribData( Attrib attr ) const;
+	//! Returns the captured indices, which are empty for non-indexed geometry
+	const std::vector<uint32_t>&	getIndices() const;
+	//! Returns the number of bytes of captured attribute and index data
+	size_t			getNumBytes() const;
+
+  private:
+	struct Data;
+	class CaptureTarget;
+
+	std::shared_ptr<const Data>		mData;
+};
+
+typedef std::shared_ptr<const CachedSource>	CachedSourceRef;
+
+//! Shares the geometry of equal Sources, identified by Source::calcCacheKey() and the requested attributes, so that procedural geometry is only generated once. Keeps the most recently used geometry up to a byte budget. Safe to use from multiple threads.
+class CI_API SourceCache {
+  public:
+	//! Creates a cache which keeps at most \a maxBytes of attribute and index data
+	explicit SourceCache( size_t maxBytes = 64 * 1024 * 1024 );
+
+	//! Returns the geometry of \a source loaded with \a requestedAttribs, loading it only if no equal Source was loaded before. Sources which can't be cached or whose estimated size exceeds the budget are loaded every time and not kept.
+	CachedSourceRef		get( const Source &source, const AttribSet &requestedAttribs );
+	//! Equivalent to <tt>source.loadInto( target, requestedAttribs )</tt>, but loads cacheable Sources through get(). Sources which aren't kept are loaded directly into \a target without capturing them.
+	void				loadInto( const Source &source, Target *target, const AttribSet &requestedAttribs );
+
+	//! Discards all cached geometry
+	void	clear();
+	//! Sets the budget for attribute and index data, discarding the least recently used geometry beyond it. \c 0 disables caching.
+	void	setMaxBytes( size_t maxBytes );
+	size_t	getMaxBytes() const;
+	size_t	getNumBytes() const;
+	size_t	getNumEntries() const;
+	//! Returns how many get() and loadInto() calls found their geometry in the cache
+	size_t	getNumHits() const;
+	//! Returns how many get() and loadInto() calls loaded a cacheable Source
+	size_t	getNumMisses() const;
+
+	//! Returns a process-wide cache with the default budget. Nothing is cached implicitly; pass it, or a cache of your own, to gl::draw() or gl::VboMesh::create() to opt in.
+	static SourceCache&	instance();
+
+  private:
+	struct Entry {
+		std::string			mKey;
+		CachedSourceRef		mSource;
+	};
+
+	//! Returns the entry for \a key, loading \a source on a miss, or \c nullptr if \a source is estimated from its vertex and index counts to exceed the budget
+	CachedSourceRef		getCached( const Source &source, const AttribSet &requestedAttribs, CacheKey *key );
+	//! Discards the least recently used entries until the budget is met. Requires mMutex to be locked.
+	void				trim();
+
+	mutable std::mutex											mMutex;
+	std::list<Entry>											mEntries; // most recently used first
+	std::unordered_map<std::string,std::list<Entry>::iterator>	mEntryMap;
+	size_t														mMaxBytes, mNumBytes;
+	size_t														mNumHits, mNumMisses;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 class CI_API Exc : public Exception {
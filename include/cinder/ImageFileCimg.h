@@ -0,0 +1,139 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Channel.h"
+#include "cinder/Exception.h"
+
+namespace cinder {
+
+typedef std::shared_ptr<class ImageSourceFileCimg>	ImageSourceFileCimgRef;
+
+/** \brief Cinder's native image container, registered for the ".cimg" extension.
+ *
+ * A .cimg file is a small fixed header followed by a table of mip levels. Each level stores tightly packed rows, padded to
+ * the row alignment chosen when writing, in the pixel layout of the image (data type and channel order). Levels are either
+ * stored raw, in which case they can be referenced in place through a memory mapping, or split into bands of rows which are
+ * individually deflate-compressed and decompressed in parallel. All values are little-endian. **/
+class CI_API ImageSourceFileCimg : public ImageSource {
+  public:
+	//! Compatible with ImageIoRegistrar. ImageSource::Options::index() selects the mip level to load.
+	static ImageSourceRef			create( DataSourceRef dataSource, ImageSource::Options options = ImageSource::Options() );
+	//! Returns an ImageSourceFileCimgRef, providing access to createSurfaceRef() and createChannelRef().
+	static ImageSourceFileCimgRef	createRef( DataSourceRef dataSource, ImageSource::Options options = ImageSource::Options() );
+
+	void	load( ImageTargetRef target ) override;
+
+	//! Returns the number of mip levels in the file, which is also reported by getCount()
+	int32_t		getNumMipLevels() const		{ return (int32_t)mLevels.size(); }
+	//! Returns whether mip level \a level is stored uncompressed and can be referenced in place by createSurfaceRef() or createChannelRef()
+	bool		isMappable( int32_t level = 0 ) const;
+
+	/** Returns a Surface which references the pixels of mip level \a level directly from the file mapping (or the DataSource's Buffer), with no decoding or copying.
+	 * Requires an uncompressed RGB level whose data type matches \a T: uint8_t for UINT8, uint16_t for UINT16 and float for FLOAT32. The Surface keeps the mapping alive;
+	 * writes to it are private to the process. Throws ImageSourceFileCimgException if these requirements are not met.
+	 * The result can be passed directly to gl::Texture2d::create(), which uploads from the mapping. **/
+	template<typename T>
+	std::shared_ptr<SurfaceT<T>>	createSurfaceRef( int32_t level = 0 ) const;
+	//! Returns a Channel which references the gray channel of mip level \a level in place, subject to the same requirements as createSurfaceRef() but for a CM_GRAY image.
+	template<typename T>
+	std::shared_ptr<ChannelT<T>>	createChannelRef( int32_t level = 0 ) const;
+
+	static void		registerSelf();
+
+  protected:
+	ImageSourceFileCimg( DataSourceRef dataSource, ImageSource::Options options );
+
+	struct Level {
+		int32_t		mWidth, mHeight;
+		size_t		mRowBytes;
+		uint64_t	mOffset, mSize;
+		uint32_t	mNumTiles;
+	};
+
+	const uint8_t*	getLevelData( int32_t level, ImageIo::DataType dataType ) const;
+
+	std::shared_ptr<void>	mStorage; // MemoryMappedFile or Buffer backing mData
+	const uint8_t*			mData;
+	size_t					mDataSize;
+	std::vector<Level>		mLevels;
+	int32_t					mLevel;
+	int32_t					mTileHeight;
+};
+
+class CI_API ImageTargetFileCimg : public ImageTarget {
+  public:
+	//! Options specific to writing .cimg files. \see create()
+	class CimgOptions {
+	  public:
+		CimgOptions() : mCompress( false ), mMipmap( false ), mRowAlignment( 16 ), mTileHeight( 64 ) {}
+
+		//! Deflate-compresses bands of tileHeight() rows independently, trading mmap-ability for size. Default is \c false.
+		CimgOptions&	compress( bool compress = true )		{ mCompress = compress; return *this; }
+		//! Stores a box-filtered mip chain down to 1x1 after the base level. Default is \c false.
+		CimgOptions&	mipmap( bool mipmap = true )			{ mMipmap = mipmap; return *this; }
+		//! Pads each row to a multiple of \a alignment bytes, which must be a power of two. Default is \c 16.
+		CimgOptions&	rowAlignment( size_t alignment )		{ mRowAlignment = alignment; return *this; }
+		//! Number of rows per compressed band. Smaller bands increase decompression parallelism at some cost in ratio. Default is \c 64.
+		CimgOptions&	tileHeight( int32_t rows )				{ mTileHeight = rows; return *this; }
+
+		bool	getCompress() const			{ return mCompress; }
+		bool	getMipmap() const			{ return mMipmap; }
+		size_t	getRowAlignment() const		{ return mRowAlignment; }
+		int32_t	getTileHeight() const		{ return mTileHeight; }
+
+	  protected:
+		bool	mCompress, mMipmap;
+		size_t	mRowAlignment;
+		int32_t	mTileHeight;
+	};
+
+	//! Compatible with ImageIoRegistrar. Writes an uncompressed file with no mip levels.
+	static ImageTargetRef	create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData );
+	//! Creates an ImageTarget which writes according to \a cimgOptions. Pass the result to writeImage( ImageTargetRef, const ImageSourceRef& ).
+	static ImageTargetRef	create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData, const CimgOptions &cimgOptions );
+
+	void*	getRowPointer( int32_t row ) override;
+	void	finalize() override;
+
+	static void		registerSelf();
+
+  protected:
+	ImageTargetFileCimg( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const CimgOptions &cimgOptions );
+
+	DataTargetRef			mDataTarget;
+	CimgOptions				mCimgOptions;
+	bool					mPremultiplied;
+	size_t					mRowBytes;
+	std::vector<uint8_t>	mData;
+};
+
+class CI_API ImageSourceFileCimgException : public ImageIoException {
+  public:
+	ImageSourceFileCimgException( const std::string &description ) : ImageIoException( description ) {}
+};
+
+} // namespace cinder
@@ -39,22 +39,78 @@ typedef std::shared_ptr<class ImageSourceFileTinyExr>	ImageSourceFileTinyExrRef;
 
 class ImageSourceFileTinyExr : public ImageSource {
   public:
+	//! OpenEXR-specific options for loading. \see create()
+	class ExrOptions {
+	  public:
+		ExrOptions() : mArea( Area::zero() ) {}
+
+		//! Loads the channels of layer \a layer ("layer.R", "layer.G", ...) rather than the unnamed default layer.
+		ExrOptions&	layer( const std::string &layer )						{ mLayer = layer; return *this; }
+		//! Loads exactly the channels named by \a channels, in order. One or two names result in a gray (+ alpha) image, three or four in RGB(A). Overrides layer().
+		ExrOptions&	channels( const std::vector<std::string> &channels )	{ mChannels = channels; return *this; }
+		//! Loads only \a area, expressed relative to the upper-left of the data window. An empty Area (the default) loads the entire data window.
+		ExrOptions&	area( const Area &area )								{ mArea = area; return *this; }
+
+		const std::string&				getLayer() const	{ return mLayer; }
+		const std::vector<std::string>&	getChannels() const	{ return mChannels; }
+		const Area&						getArea() const		{ return mArea; }
+
+	  protected:
+		std::string					mLayer;
+		std::vector<std::string>	mChannels;
+		Area						mArea;
+	};
+
 	static ImageSourceRef create( DataSourceRef dataSource, ImageSource::Options options = ImageSource::Options() );
+	//! Creates an ImageSource that loads the subset of channels and the region described by \a exrOptions.
+	static ImageSourceRef create( DataSourceRef dataSource, ImageSource::Options options, const ExrOptions &exrOptions );
 
+	//! Decodes only the selected channels and the blocks or tiles overlapping the selected area, using all available cores, then writes the rows to \a target in order from the calling thread. Half-float data is passed through as FLOAT16.
 	void load( ImageTargetRef target ) override;
 
+	//! Returns the names of every channel present in the file, such as "R" or "diffuse.G"
+	const std::vector<std::string>&	getChannelNames() const		{ return mChannelNames; }
+	//! Returns the names of the layers present in the file. The unnamed default layer is returned as an empty string.
+	std::vector<std::string>		getLayerNames() const;
+
 	static void		registerSelf();
 
 protected:
-	ImageSourceFileTinyExr( DataSourceRef dataSourceRef, ImageSource::Options options );
+	ImageSourceFileTinyExr( DataSourceRef dataSourceRef, ImageSource::Options options, const ExrOptions &exrOptions );
 
+	DataSourceRef				mDataSource;
 	std::unique_ptr<EXRHeader, std::function<int( EXRHeader * )>> mExrHeader; // We're using the provided FreeEXRHeader function as a custom deleter
-	std::unique_ptr<EXRImage, std::function<int( EXRImage * )>>   mExrImage;  // We're using the provided FreeEXRImage function as a custom deleter
+	std::vector<std::string>	mChannelNames;
+	std::vector<int>			mSelectedChannels; // indices into mExrHeader->channels, one per interleaved component
+	Area						mArea; // relative to the data window
 };
 
 class ImageTargetFileTinyExr : public ImageTarget {
   public:
+	//! Values match tinyexr's TINYEXR_COMPRESSIONTYPE_* constants
+	enum Compression { COMPRESSION_NONE = 0, COMPRESSION_RLE = 1, COMPRESSION_ZIPS = 2, COMPRESSION_ZIP = 3, COMPRESSION_PIZ = 4 };
+
+	//! OpenEXR-specific options for writing. \see create()
+	class ExrOptions {
+	  public:
+		ExrOptions() : mCompression( COMPRESSION_ZIP ), mDataType( ImageIo::FLOAT16 ) {}
+
+		//! Compression applied to each scanline block. Blocks are compressed in parallel. Default is \c COMPRESSION_ZIP.
+		ExrOptions&	compression( Compression compression )	{ mCompression = compression; return *this; }
+		//! Data type written to the file, either ImageIo::FLOAT16 (the default) or ImageIo::FLOAT32.
+		ExrOptions&	dataType( ImageIo::DataType dataType )	{ mDataType = dataType; return *this; }
+
+		Compression			getCompression() const	{ return mCompression; }
+		ImageIo::DataType	getDataType() const		{ return mDataType; }
+
+	  protected:
+		Compression			mCompression;
+		ImageIo::DataType	mDataType;
+	};
+
 	static ImageTargetRef		create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData );
+	//! Creates an ImageTarget which writes using the compression and data type described by \a exrOptions. Pass the result to writeImage( ImageTargetRef, const ImageSourceRef& ).
+	static ImageTargetRef		create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData, const ExrOptions &exrOptions );
 
 	void*	getRowPointer( int32_t row ) override;
 	void	finalize() override;
@@ -62,11 +118,12 @@ class ImageTargetFileTinyExr : public ImageTarget {
 	static void		registerSelf();
 	
   protected:
-	ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData );
+	ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData, const ExrOptions &exrOptions );
 
 	uint8_t                  mNumComponents;
 	fs::path                 mFilePath;
-	std::vector<float>       mData;
+	ExrOptions               mExrOptions;
+	std::vector<uint8_t>     mData; // interleaved FLOAT16 or FLOAT32 pixels, depending on getDataType()
 	std::vector<std::string> mChannelNames;
 };
 
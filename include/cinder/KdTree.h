@@ -59,6 +59,7 @@ struct NullLookupProc {
 	void process( uint32_t id, float distSqrd, float &maxDistSqrd ) {}
 };
 
+//! \see PointIndexT in cinder/PointIndex.h for k-nearest neighbor, radius and batched queries over a cache-friendly implicit tree
 template <typename NodeData, unsigned char K=3, class LookupProc = NullLookupProc> class KdTree {
 public:
 	typedef std::pair<const NodeData*, uint32_t> NodeDataIndex;
@@ -0,0 +1,69 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Exception.h"
+#include "cinder/Filesystem.h"
+#include "cinder/Noncopyable.h"
+
+namespace cinder {
+
+typedef std::shared_ptr<class MemoryMappedFile>	MemoryMappedFileRef;
+
+//! Maps the entire contents of a file into memory. The mapping is copy-on-write, so writes through getData() are private to the process and never reach the file.
+class CI_API MemoryMappedFile : public Noncopyable {
+  public:
+	//! Maps the file at \a path. Throws MemoryMappedFileExc on failure.
+	static MemoryMappedFileRef	create( const fs::path &path )	{ return MemoryMappedFileRef( new MemoryMappedFile( path ) ); }
+	~MemoryMappedFile();
+
+	//! Returns a pointer to the first byte of the file, or \c nullptr for an empty file
+	void*				getData()				{ return mData; }
+	//! Returns a pointer to the first byte of the file, or \c nullptr for an empty file
+	const void*			getData() const			{ return mData; }
+	//! Returns the size of the file in bytes
+	size_t				getSize() const			{ return mSize; }
+	const fs::path&		getFilePath() const		{ return mFilePath; }
+
+  protected:
+	MemoryMappedFile( const fs::path &path );
+
+	fs::path	mFilePath;
+	void*		mData;
+	size_t		mSize;
+#if defined( CINDER_MSW )
+	void*		mFileHandle;
+	void*		mMappingHandle;
+#endif
+};
+
+class CI_API MemoryMappedFileExc : public Exception {
+  public:
+	MemoryMappedFileExc( const fs::path &path, const std::string &description )
+		: Exception( "Failed to map " + path.string() + ": " + description )
+	{}
+};
+
+} // namespace cinder
@@ -0,0 +1,144 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/AxisAlignedBox.h"
+#include "cinder/GeomIo.h"
+#include "cinder/Ray.h"
+#include "cinder/Sphere.h"
+#include "cinder/TriMesh.h"
+
+#include <limits>
+#include <vector>
+
+namespace cinder {
+
+typedef std::shared_ptr<class MeshBvh>	MeshBvhRef;
+
+/*! Bounding volume hierarchy over the triangles of a TriMesh or geom::Source, for ray and proximity queries.
+	Built with a binned surface area heuristic, in parallel over subtrees, into a flat depth-first node array.
+	Triangle indices reported by queries refer to the source mesh. All queries are safe to call from several threads at once. */
+class CI_API MeshBvh {
+  public:
+	static const uint32_t INVALID_TRIANGLE = 0xFFFFFFFF;
+
+	class CI_API Options {
+	  public:
+		Options() : mMaxLeafTriangles( 4 ), mNumBins( 16 ) {}
+
+		//! Sets the number of triangles below which a node always becomes a leaf. Default is \c 4.
+		Options&	maxLeafTriangles( uint32_t maxLeafTriangles ) { mMaxLeafTriangles = maxLeafTriangles; return *this; }
+		//! Sets the number of bins each axis is divided into when evaluating splits. Default is \c 16.
+		Options&	numBins( uint32_t numBins ) { mNumBins = numBins; return *this; }
+
+		uint32_t	getMaxLeafTriangles() const { return mMaxLeafTriangles; }
+		uint32_t	getNumBins() const { return mNumBins; }
+
+	  protected:
+		uint32_t	mMaxLeafTriangles, mNumBins;
+	};
+
+	//! The result of a ray query
+	struct CI_API RayHit {
+		RayHit() : mDistance( std::numeric_limits<float>::max() ), mTriangle( INVALID_TRIANGLE ) {}
+
+		//! Returns whether the ray hit a triangle
+		bool	isHit() const { return mTriangle != INVALID_TRIANGLE; }
+
+		//! Distance along the ray, in multiples of the ray's direction as with Ray::calcPosition()
+		float		mDistance;
+		//! Index of the triangle that was hit, or \c INVALID_TRIANGLE
+		uint32_t	mTriangle;
+		//! Barycentric coordinates of the hit relative to the triangle's second and third vertices
+		vec2		mBarycentric;
+	};
+
+	static MeshBvhRef	create( const TriMesh &mesh, const Options &options = Options() ) { return MeshBvhRef( new MeshBvh( mesh, options ) ); }
+	static MeshBvhRef	create( const geom::Source &source, const Options &options = Options() ) { return MeshBvhRef( new MeshBvh( source, options ) ); }
+
+	//! Builds a hierarchy over \a mesh, which must have 3D positions.
+	MeshBvh( const TriMesh &mesh, const Options &options = Options() );
+	//! Builds a hierarchy over \a source, which is converted to triangles.
+	MeshBvh( const geom::Source &source, const Options &options = Options() );
+	//! Builds a hierarchy over the triangles in \a indices, which index \a numPositions entries of \a positions.
+	MeshBvh( const vec3 *positions, size_t numPositions, const uint32_t *indices, size_t numIndices, const Options &options = Options() );
+
+	//! Finds the nearest triangle hit by \a ray no further than \a maxDistance along it. Returns \c false if there's none.
+	bool	raycast( const Ray &ray, RayHit *result, float maxDistance = std::numeric_limits<float>::max() ) const;
+	//! Returns whether \a ray hits any triangle no further than \a maxDistance along it, stopping at the first one found.
+	bool	raycastAny( const Ray &ray, float maxDistance = std::numeric_limits<float>::max() ) const;
+	//! Casts \a numRays rays in parallel, storing the nearest hit for each in \a results, which must hold \a numRays entries.
+	void	raycast( const Ray *rays, size_t numRays, RayHit *results, float maxDistance = std::numeric_limits<float>::max() ) const;
+
+	/*! Finds the point on the mesh closest to \a point, no further than \a maxDistance from it. Optionally returns the index
+		of the triangle it lies on in \a triangle. Returns \c false if the mesh has no triangles within \a maxDistance. */
+	bool	calcClosestPoint( const vec3 &point, vec3 *result, uint32_t *triangle = nullptr, float maxDistance = std::numeric_limits<float>::max() ) const;
+	//! Returns whether any triangle overlaps \a sphere.
+	bool	intersects( const Sphere &sphere ) const;
+	//! Appends the indices of the triangles that overlap \a sphere to \a result.
+	void	findTriangles( const Sphere &sphere, std::vector<uint32_t> *result ) const;
+
+	/*! Updates the hierarchy's bounds for moved vertices without rebuilding it. \a positions must have the same
+		number of entries as the positions the hierarchy was built from, and the triangles must be unchanged.
+		Query quality degrades as the vertices drift from their original layout. */
+	void	refit( const vec3 *positions, size_t numPositions );
+	//! Updates the hierarchy's bounds for the current positions of \a mesh, which must have the topology it was built from.
+	void	refit( const TriMesh &mesh );
+
+	//! Returns the bounds of every triangle in the hierarchy
+	AxisAlignedBox	getBounds() const;
+	size_t			getNumTriangles() const { return mTriangleIds.size(); }
+	size_t			getNumNodes() const { return mNodes.size(); }
+
+  protected:
+	//! Interior nodes have mCount == 0 and children at mLeftOrFirst and mLeftOrFirst + 1. Leaves hold mCount triangles from mLeftOrFirst.
+	struct Node {
+		vec3		mMin;
+		uint32_t	mLeftOrFirst;
+		vec3		mMax;
+		uint32_t	mCount;
+	};
+
+	void	build( const vec3 *positions, size_t numPositions, const uint32_t *indices, size_t numIndices );
+	void	refitNodes();
+
+	template<typename VisitT>
+	void	traverseRay( const Ray &ray, float maxDistance, const VisitT &visitLeaf ) const;
+	template<typename VisitT>
+	void	traverseSphere( const Sphere &sphere, const VisitT &visitTriangle ) const;
+
+	Options					mOptions;
+	std::vector<Node>		mNodes;
+	std::vector<vec3>		mVertices; // three per triangle, in leaf order
+	std::vector<uint32_t>	mIndices; // three per triangle, in leaf order; used by refit()
+	std::vector<uint32_t>	mTriangleIds; // source triangle of each leaf-ordered triangle
+	size_t					mNumPositions;
+};
+
+class CI_API MeshBvhExc : public Exception {
+  public:
+	MeshBvhExc( const std::string &description ) : Exception( description ) {}
+};
+
+} // namespace cinder
@@ -125,16 +125,23 @@ class CI_API ObjLoader : public geom::Source {
 	typedef std::tuple<int,int> VertexPair;
 	typedef std::tuple<int,int,int> VertexTriple;
 
+	template<typename KeyT>
+	class UniqueVertexTable;
+
+	//! Parses the remainder of mStream
 	void	parse( bool includeNormals, bool includeTexCoords );
- 	void	parseFace( Group *group, const Material *material, const std::string &s, bool includeNormals, bool includeTexCoords );
+	//! Parses \a dataSource, memory-mapping it when it's a file and otherwise reading it through mStream
+	void	parse( const DataSourceRef &dataSource, bool includeNormals, bool includeTexCoords );
+	//! Parses line-aligned chunks of \a data in parallel and stitches the results together in file order
+	void	parseBuffer( const char *data, size_t size, bool includeNormals, bool includeTexCoords );
     void    parseMaterial( std::shared_ptr<IStreamCinder> material );
 
 	void	load() const;
 
-	void	loadGroupNormalsTextures( const Group &group, std::map<VertexTriple,int> &uniqueVerts ) const;
-	void	loadGroupNormals( const Group &group, std::map<VertexPair,int> &uniqueVerts ) const;
-	void	loadGroupTextures( const Group &group, std::map<VertexPair,int> &uniqueVerts ) const;
-	void	loadGroup( const Group &group, std::map<int,int> &uniqueVerts ) const;
+	void	loadGroupNormalsTextures( const Group &group, UniqueVertexTable<VertexTriple> &uniqueVerts ) const;
+	void	loadGroupNormals( const Group &group, UniqueVertexTable<VertexPair> &uniqueVerts ) const;
+	void	loadGroupTextures( const Group &group, UniqueVertexTable<VertexPair> &uniqueVerts ) const;
+	void	loadGroup( const Group &group, UniqueVertexTable<int> &uniqueVerts ) const;
 
 	std::shared_ptr<IStreamCinder>	mStream;
 
@@ -79,6 +79,14 @@ class CI_API Path2d {
 	std::vector<vec2>	subdivide( float approximationScale = 1.0f ) const;
 	//! if \a resultTangents aren't null then un-normalized tangents corresponding to \a resultPositions are calculated.
 	void				subdivide( std::vector<vec2> *resultPositions, std::vector<vec2> *resultTangents, float approximationScale = 1.0f ) const;
+	/** Appends a polyline within 0.5 / \a approximationScale of the path to \a resultPositions, the same tolerance as subdivide(). The number of points of each curve
+		follows from Wang's formula rather than recursive subdivision, and they are evaluated with SIMD instructions where available. Unlike subdivide(), points shared
+		by consecutive segments appear once. Clearing and reusing \a resultPositions across calls avoids reallocation. **/
+	void				flatten( std::vector<vec2> *resultPositions, float approximationScale = 1.0f ) const;
+	//! Returns the number of points flatten() produces for \a approximationScale.
+	size_t				calcNumFlattenedPoints( float approximationScale = 1.0f ) const;
+	//! Writes the calcNumFlattenedPoints() points of flatten() to \a result.
+	void				flatten( vec2 *result, float approximationScale = 1.0f ) const;
 
 	//! Translates the Path2d by \a offset
 	void		translate( const vec2 &offset );
@@ -202,25 +210,52 @@ CI_API inline std::ostream& operator<<( std::ostream &out, const Path2d &p )
 	return out;
 }
 
-//! Accelerates the calculation of various operations on Path2d. Useful if doing repeated calculations, otherwise just use Path2d member functions.
+/** Accelerates the calculation of various operations on Path2d. Useful if doing repeated calculations, otherwise just use Path2d member functions.
+	Arc length is tabulated per segment with Gauss-Legendre quadrature, so distance queries binary search the tables and refine with a few Newton steps. **/
 class CI_API Path2dCalcCache {
   public:
 	Path2dCalcCache( const Path2d &path );
 	
 	const Path2d&	getPath2d() const { return mPath; }
-	float			getLength() const { return mLength; }
+	float			getLength() const { return mSegmentStartLengths.back(); }
+	//! Returns the arc length of segment \a segment
+	float			getSegmentLength( size_t segment ) const { return mSegmentStartLengths[segment + 1] - mSegmentStartLengths[segment]; }
 
 	//! Calculates the t-value corresponding to \a relativeTime in the range [0,1) within epsilon of \a tolerance. For example, \a relativeTime of 0.5f returns the t-value corresponding to half the length. \a maxIterations dictates the number of refinement loop iterations allowed, setting an upper bound for worst-case performance.
 	float			calcNormalizedTime( float relativeTime, bool wrap = false, float tolerance = 1.0e-03f, int maxIterations = 16 ) const;
 	//! Calculates a t-value corresponding to arc length \a distance. If \a wrap then the t-value loops inside the 0-1 range as \a distance exceeds the arc length.
 	float			calcTimeForDistance( float distance, bool wrap = false, float tolerance = 1.0e-03f, int maxIterations = 16 ) const;
+	//! Calculates the t-values corresponding to \a count arc lengths \a distances into \a resultTimes, in parallel for large batches.
+	void			calcTimesForDistances( const float *distances, size_t count, float *resultTimes, bool wrap = false, float tolerance = 1.0e-03f ) const;
+	/** Calculates the positions and optionally the tangents at \a count arc lengths \a distances, in parallel for large batches. The curves are evaluated
+		four at a time with SIMD instructions where available. Either of \a resultPositions and \a resultTangents may be \c nullptr. **/
+	void			calcPositionsForDistances( const float *distances, size_t count, vec2 *resultPositions, vec2 *resultTangents = nullptr, bool wrap = false, float tolerance = 1.0e-03f ) const;
 	//! Returns the point on the curve at parameter \a t, which lies in the range <tt>[0,1]</tt>
 	vec2			getPosition( float t ) const { return mPath.getPosition( t ); }
+	//! Returns the tangent on the curve at parameter \a t, which lies in the range <tt>[0,1]</tt>
+	vec2			getTangent( float t ) const { return mPath.getTangent( t ); }
+
+	//! Moves point \a index of the cached path to \a point, recalculating the tables of only the segments that use it.
+	void			setPoint( size_t index, const vec2 &point );
 
   private:
+	//! Recalculates the arc length table of \a segment
+	void			updateSegment( size_t segment );
+	//! Updates mSegmentStartLengths after segment lengths changed
+	void			updateStartLengths();
+	//! Finds the segment and its parameter at \a distance, which is already wrapped or clamped to the path's length
+	void			solveDistance( float distance, float tolerance, int maxIterations, size_t *resultSegment, float *resultT ) const;
+	//! Maps \a distance to [0,getLength()] according to \a wrap
+	float			wrapDistance( float distance, bool wrap ) const;
+
 	Path2d				mPath;
-	float				mLength;
-	std::vector<float>	mSegmentLengths;
+	//! Every segment as an equivalent cubic Bezier, degree elevated where necessary
+	std::vector<vec2>	mCubics;
+	std::vector<size_t>	mSegmentFirstPoints;
+	//! The arc length at the start of each segment, plus the total length
+	std::vector<float>	mSegmentStartLengths;
+	//! The arc length from each segment's start at the same number of uniformly spaced t-values
+	std::vector<float>	mArcLengths;
 };
 
 class CI_API Path2dExc : public Exception {
@@ -24,9 +24,15 @@
 
 #include "cinder/Cinder.h"
 #include "cinder/Vector.h"
+#include "cinder/Area.h"
 
 namespace cinder {
 
+template<typename T> class ChannelT;
+typedef ChannelT<float> Channel32f;
+template<typename T> class SurfaceT;
+typedef SurfaceT<float> Surface32f;
+
 class CI_API Perlin
 {
  public:
@@ -63,6 +69,25 @@ class CI_API Perlin
 	vec2	dnoise( float x, float y ) const;
 	vec3	dnoise( float x, float y, float z ) const;
 
+	/// Fills \a result with noise() of each of \a count \a points. Batch functions evaluate several points per instruction and split large batches across threads, with results independent of the number of threads.
+	void	noise( const vec2 *points, size_t count, float *result ) const;
+	void	noise( const vec3 *points, size_t count, float *result ) const;
+	/// Fills \a result with fBm() of each of \a count \a points
+	void	fBm( const vec2 *points, size_t count, float *result ) const;
+	void	fBm( const vec3 *points, size_t count, float *result ) const;
+	/// Fills \a result with dfBm() of each of \a count \a points
+	void	dfBm( const vec2 *points, size_t count, vec2 *result ) const;
+	void	dfBm( const vec3 *points, size_t count, vec3 *result ) const;
+
+	/// Fills \a area of \a channel with fBm() sampled at <tt>origin + vec2( x, y ) * scale</tt> for each pixel (x, y)
+	void	fBm( Channel32f *channel, const Area &area, const vec2 &origin, const vec2 &scale = vec2( 1 ) ) const;
+	/// Fills \a area of \a channel with fBm() sampled at <tt>( origin.x + x * scale.x, origin.y + y * scale.y, origin.z )</tt> for each pixel (x, y), which animates through \a origin.z
+	void	fBm( Channel32f *channel, const Area &area, const vec3 &origin, const vec2 &scale = vec2( 1 ) ) const;
+	/// Fills the red and green channels of \a area of \a surface with dfBm() sampled at <tt>origin + vec2( x, y ) * scale</tt> for each pixel (x, y), e.g. for a flow field
+	void	dfBm( Surface32f *surface, const Area &area, const vec2 &origin, const vec2 &scale = vec2( 1 ) ) const;
+	/// Fills the red, green and blue channels of \a area of \a surface with dfBm() sampled at <tt>( origin.x + x * scale.x, origin.y + y * scale.y, origin.z )</tt> for each pixel (x, y)
+	void	dfBm( Surface32f *surface, const Area &area, const vec3 &origin, const vec2 &scale = vec2( 1 ) ) const;
+
  private:
 	void	initPermutationTable();
 
@@ -76,4 +101,56 @@ class CI_API Perlin
 	uint8_t		mPerms[512];
 };
 
+/// Simplex noise, which has fewer directional artifacts than Perlin noise and analytic derivatives at a similar cost. noise() ranges approximately from -1 to 1.
+class CI_API Simplex
+{
+ public:
+	Simplex( uint8_t aOctaves = 4, int32_t aSeed = 0x214 );
+
+	void	setSeed( int32_t aSeed );
+	uint8_t	getOctaves() const { return mOctaves; }
+	void	setOctaves( uint8_t aOctaves ) { mOctaves = aOctaves; }
+
+	/// Fractal Brownian motion, summing 'mOctaves' worth of noise
+	float	fBm( const vec2 &v ) const;
+	float	fBm( const vec3 &v ) const;
+	/// Derivative of fractal Brownian motion, corresponding with the values returned by fBm()
+	vec2	dfBm( const vec2 &v ) const;
+	vec3	dfBm( const vec3 &v ) const;
+
+	/// Calculates a single octave of noise
+	float	noise( const vec2 &v ) const;
+	float	noise( const vec3 &v ) const;
+	/// Calculates the derivative of a single octave of noise
+	vec2	dnoise( const vec2 &v ) const;
+	vec3	dnoise( const vec3 &v ) const;
+
+	/// Fills \a result with noise() of each of \a count \a points. Batch functions evaluate several points per instruction and split large batches across threads, with results independent of the number of threads.
+	void	noise( const vec2 *points, size_t count, float *result ) const;
+	void	noise( const vec3 *points, size_t count, float *result ) const;
+	/// Fills \a result with fBm() of each of \a count \a points
+	void	fBm( const vec2 *points, size_t count, float *result ) const;
+	void	fBm( const vec3 *points, size_t count, float *result ) const;
+	/// Fills \a result with dfBm() of each of \a count \a points
+	void	dfBm( const vec2 *points, size_t count, vec2 *result ) const;
+	void	dfBm( const vec3 *points, size_t count, vec3 *result ) const;
+
+	/// Fills \a area of \a channel with fBm() sampled at <tt>origin + vec2( x, y ) * scale</tt> for each pixel (x, y)
+	void	fBm( Channel32f *channel, const Area &area, const vec2 &origin, const vec2 &scale = vec2( 1 ) ) const;
+	/// Fills \a area of \a channel with fBm() sampled at <tt>( origin.x + x * scale.x, origin.y + y * scale.y, origin.z )</tt> for each pixel (x, y), which animates through \a origin.z
+	void	fBm( Channel32f *channel, const Area &area, const vec3 &origin, const vec2 &scale = vec2( 1 ) ) const;
+	/// Fills the red and green channels of \a area of \a surface with dfBm() sampled at <tt>origin + vec2( x, y ) * scale</tt> for each pixel (x, y), e.g. for a flow field
+	void	dfBm( Surface32f *surface, const Area &area, const vec2 &origin, const vec2 &scale = vec2( 1 ) ) const;
+	/// Fills the red, green and blue channels of \a area of \a surface with dfBm() sampled at <tt>( origin.x + x * scale.x, origin.y + y * scale.y, origin.z )</tt> for each pixel (x, y)
+	void	dfBm( Surface32f *surface, const Area &area, const vec3 &origin, const vec2 &scale = vec2( 1 ) ) const;
+
+ private:
+	uint8_t		mOctaves;
+	int32_t		mSeed;
+
+	uint8_t		mPerms[512];
+	/// mPerms modulo 12, selecting one of 12 gradients
+	uint8_t		mPermsMod12[512];
+};
+
 } // namespace cinder
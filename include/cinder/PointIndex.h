@@ -0,0 +1,121 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Vector.h"
+
+#include <limits>
+#include <vector>
+
+namespace cinder {
+
+/*! Spatial index over a fixed set of 2D or 3D points for nearest neighbor and radius queries, rebuilt rather than updated
+	when the points move. The tree is implicit: its shape follows from the number of points alone, so nodes are stored
+	breadth-first in a flat array with no child links, and points are copied into leaf order alongside their indices so each leaf is scanned contiguously.
+	Building runs in parallel over subtrees. Queries never allocate unless given a std::vector, and all queries are safe to call
+	from several threads at once. Reported indices refer to the points' positions in the array the index was built from. */
+template<typename VecT>
+class CI_API PointIndexT {
+  public:
+	typedef typename VecT::value_type	T;
+	static const int					DIMS = sizeof( VecT ) / sizeof( T );
+	static const uint32_t				INVALID_INDEX = 0xFFFFFFFF;
+
+	//! A point found by a query
+	struct Neighbor {
+		Neighbor() : mIndex( INVALID_INDEX ), mDistanceSquared( std::numeric_limits<float>::max() ) {}
+		Neighbor( uint32_t index, float distanceSquared ) : mIndex( index ), mDistanceSquared( distanceSquared ) {}
+
+		bool operator<( const Neighbor &rhs ) const { return mDistanceSquared < rhs.mDistanceSquared; }
+
+		uint32_t	mIndex;
+		float		mDistanceSquared;
+	};
+
+	//! Creates an empty index
+	PointIndexT() : mMaxLeafPoints( 16 ), mDepth( 0 ) {}
+	//! Builds an index over the \a numPoints entries of \a points, with at most \a maxLeafPoints points per leaf.
+	PointIndexT( const VecT *points, size_t numPoints, uint32_t maxLeafPoints = 16 );
+	//! Builds an index over \a points, with at most \a maxLeafPoints points per leaf.
+	PointIndexT( const std::vector<VecT> &points, uint32_t maxLeafPoints = 16 )
+		: PointIndexT( points.data(), points.size(), maxLeafPoints ) {}
+
+	//! Rebuilds the index over the \a numPoints entries of \a points, reusing its storage.
+	void	build( const VecT *points, size_t numPoints );
+	//! Rebuilds the index over \a points, reusing its storage.
+	void	build( const std::vector<VecT> &points ) { build( points.data(), points.size() ); }
+
+	//! Returns the index of the point nearest to \a point no further than \a maxDistance from it, or \c INVALID_INDEX if there's none. Optionally returns its squared distance in \a distanceSquared.
+	uint32_t	findNearest( const VecT &point, float *distanceSquared = nullptr, float maxDistance = std::numeric_limits<float>::max() ) const;
+	/*! Finds the \a k points nearest to \a point no further than \a maxDistance from it, storing them in \a result ordered by increasing distance.
+		\a result must hold \a k entries. Returns the number found, which is less than \a k when there aren't enough points in range. */
+	size_t		findNearest( const VecT &point, size_t k, Neighbor *result, float maxDistance = std::numeric_limits<float>::max() ) const;
+	/*! Finds the points within \a radius of \a point, in no particular order, storing up to \a maxResults of them in \a result.
+		Returns the number of points in range, which may exceed \a maxResults, in which case the stored ones are an arbitrary subset. */
+	size_t		findInRadius( const VecT &point, float radius, Neighbor *result, size_t maxResults ) const;
+	//! Appends the points within \a radius of \a point to \a result, in no particular order. Returns the number appended.
+	size_t		findInRadius( const VecT &point, float radius, std::vector<Neighbor> *result ) const;
+
+	/*! Runs findNearest( points[i], k, ... ) for each of the \a numPoints entries of \a points in parallel. The neighbors of point \c i are
+		stored from <tt>results[i * k]</tt>, so \a results must hold <tt>numPoints * k</tt> entries. Optionally stores each count in \a counts. */
+	void	findNearest( const VecT *points, size_t numPoints, size_t k, Neighbor *results, size_t *counts = nullptr, float maxDistance = std::numeric_limits<float>::max() ) const;
+	/*! Runs findInRadius( points[i], radius, ... ) for each of the \a numPoints entries of \a points in parallel. The neighbors of point \c i are
+		stored from <tt>results[i * maxResultsPerPoint]</tt>, so \a results must hold <tt>numPoints * maxResultsPerPoint</tt> entries.
+		The number of points in range of each, which may exceed \a maxResultsPerPoint, is stored in \a counts, which must hold \a numPoints entries. */
+	void	findInRadius( const VecT *points, size_t numPoints, float radius, Neighbor *results, size_t maxResultsPerPoint, size_t *counts ) const;
+
+	size_t		getNumPoints() const { return mEntries.size(); }
+	bool		empty() const { return mEntries.empty(); }
+	uint32_t	getMaxLeafPoints() const { return mMaxLeafPoints; }
+
+  protected:
+	/*! Interior node \c i has children <tt>2i + 1</tt> and <tt>2i + 2</tt>. Its points are split in half along mAxis;
+		every point in the left half has a coordinate no greater than mLeftMax and every point in the right half no less than mRightMin. */
+	struct Node {
+		T			mLeftMax, mRightMin;
+		uint32_t	mAxis;
+	};
+
+	struct Entry {
+		VecT		mPoint;
+		uint32_t	mId; // index in the array the index was built from
+	};
+
+	void	buildNode( size_t node, uint32_t depth, size_t begin, size_t end );
+	template<typename ResultSetT>
+	void	search( const VecT &point, ResultSetT &resultSet ) const;
+	template<typename ResultSetT>
+	void	searchNode( size_t node, uint32_t depth, size_t begin, size_t end, const VecT &point, VecT &offsets, float distanceSquared, ResultSetT &resultSet ) const;
+
+	uint32_t				mMaxLeafPoints;
+	uint32_t				mDepth; // levels of interior nodes; leaves lie below the last one
+	std::vector<Node>		mNodes;
+	std::vector<Entry>		mEntries; // in leaf order
+};
+
+typedef PointIndexT<vec2>	PointIndex2;
+typedef PointIndexT<vec3>	PointIndex3;
+
+} // namespace cinder
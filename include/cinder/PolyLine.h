@@ -31,6 +31,9 @@ namespace cinder {
 template<typename T>
 class CI_API PolyLineT {
   public:
+	enum SimplifyMethod { SIMPLIFY_DOUGLAS_PEUCKER, SIMPLIFY_VISVALINGAM };
+	enum SmoothMethod { SMOOTH_CHAIKIN, SMOOTH_CATMULL_ROM };
+
 	PolyLineT() : mClosed( false ) {}
 	PolyLineT( const std::vector<T> &aPoints, bool closed = false ) : mPoints( aPoints ), mClosed( closed ) {}
 	PolyLineT( std::vector<T> &&aPoints, bool closed = false ) : mPoints( std::move( aPoints ) ), mClosed( closed ) {}
@@ -68,6 +71,20 @@ class CI_API PolyLineT {
 	void			reverse();
 	PolyLineT<T>	reversed() const;
 
+	/*! Removes points which contribute little to the shape of the line, keeping the end points of open lines. With SIMPLIFY_DOUGLAS_PEUCKER every removed point lies within \a tolerance of the result;
+		with SIMPLIFY_VISVALINGAM points are removed while the smallest triangle formed by a point and its neighbors has an area below \a tolerance. */
+	void			simplify( typename T::value_type tolerance, SimplifyMethod method = SIMPLIFY_DOUGLAS_PEUCKER );
+	PolyLineT<T>	simplified( typename T::value_type tolerance, SimplifyMethod method = SIMPLIFY_DOUGLAS_PEUCKER ) const;
+	//! Simplifies each of \a polyLines in parallel. \sa simplify()
+	static void		simplify( std::vector<PolyLineT<T>> *polyLines, typename T::value_type tolerance, SimplifyMethod method = SIMPLIFY_DOUGLAS_PEUCKER );
+	//! Replaces the points with points evenly spaced along the line, about \a spacing apart. The spacing is adjusted to divide the line's length exactly, so open lines keep their end points.
+	void			resampleUniform( typename T::value_type spacing );
+	PolyLineT<T>	resampledUniform( typename T::value_type spacing ) const;
+	/*! Rounds off the line's corners, keeping the end points of open lines. SMOOTH_CHAIKIN cuts each corner \a count times, doubling the number of points each time.
+		SMOOTH_CATMULL_ROM inserts \a count points between each pair of points along a centripetal Catmull-Rom spline through them. */
+	void			smooth( SmoothMethod method = SMOOTH_CHAIKIN, int count = 1 );
+	PolyLineT<T>	smoothed( SmoothMethod method = SMOOTH_CHAIKIN, int count = 1 ) const;
+
 	//! Returns whether the point \a pt is contained within the boundaries of the PolyLine
 	bool	contains( const vec2 &pt ) const;
 
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <random>
 #include "cinder/Vector.h"
 
@@ -134,6 +135,8 @@ class CI_API Rand {
 	}
 
 	// STATICS
+	// The static functions share one generator, which isn't safe to use from several threads at once; use FastRand::threadLocal() there.
+
 	//! Resets the static random generator to a random seed
 	static void randomize()
 	{
@@ -284,4 +287,147 @@ CI_API inline vec2 randVec2() { return Rand::randVec2(); }
 //! returns a random float via Gaussian distribution with a mean of 0 and a standard deviation of 1.0
 CI_API inline float randGaussian() { return Rand::randGaussian(); }
 
+//! A random generator that runs four interleaved xoshiro256++ streams, which the compiler can vectorize, and is much faster than Rand for bulk generation. All values are drawn from a single sequence of 32-bit words, so the fill*() functions return exactly what the equivalent series of next*() calls would.
+class CI_API FastRand {
+ public:
+	//! Seeds the generator with \a seedValue and \a stream, see seed()
+	explicit FastRand( uint64_t seedValue = 310, uint64_t stream = 0 )
+	{
+		seed( seedValue, stream );
+	}
+
+	//! Re-seeds the generator. Each \a stream of a \a seedValue is an independent sequence, e.g. one per worker thread or task.
+	void seed( uint64_t seedValue, uint64_t stream = 0 );
+
+	//! returns a random boolean value
+	bool nextBool()
+	{
+		return ( nextUint() >> 31 ) != 0;
+	}
+
+	//! returns a random integer in the range [-2147483648,2147483647]
+	int32_t nextInt()
+	{
+		return (int32_t)nextUint();
+	}
+
+	//! returns a random integer in the range [0,4294967296)
+	uint32_t nextUint()
+	{
+		if( mWordIndex == NUM_WORDS )
+			refill();
+		return mWords[mWordIndex++];
+	}
+
+	//! returns a random integer in the range [0,v), or 0 when \a v is 0
+	uint32_t nextUint( uint32_t v )
+	{
+		return (uint32_t)( ( (uint64_t)nextUint() * v ) >> 32 );
+	}
+
+	//! returns a random integer in the range [0,2^64)
+	uint64_t nextUint64()
+	{
+		const uint64_t low = nextUint();
+		return low | ( (uint64_t)nextUint() << 32 );
+	}
+
+	//! returns a random integer in the range [0,v)
+	int32_t nextInt( int32_t v )
+	{
+		if( v <= 0 ) return 0;
+		return (int32_t)nextUint( (uint32_t)v );
+	}
+
+	//! returns a random integer in the range [a,b)
+	int32_t nextInt( int32_t a, int32_t b )
+	{
+		return nextInt( b - a ) + a;
+	}
+
+	//! returns a random float in the range [0.0f,1.0f)
+	float nextFloat()
+	{
+		return toFloat( nextUint() );
+	}
+
+	//! returns a random float in the range [0.0f,v)
+	float nextFloat( float v )
+	{
+		return nextFloat() * v;
+	}
+
+	//! returns a random float in the range [a,b)
+	float nextFloat( float a, float b )
+	{
+		return nextFloat() * ( b - a ) + a;
+	}
+
+	//! returns a random float in the range [a,b) or the range [-b,-a)
+	float posNegFloat( float a, float b )
+	{
+		if( nextBool() )
+			return nextFloat( a, b );
+		else
+			return -nextFloat( a, b );
+	}
+
+	//! returns a random vec3 that represents a point on the unit sphere
+	vec3 nextVec3()
+	{
+		float phi = nextFloat( (float)M_PI * 2.0f );
+		float costheta = nextFloat( -1.0f, 1.0f );
+
+		float rho = math<float>::sqrt( std::max( 0.0f, 1.0f - costheta * costheta ) );
+		return vec3( rho * math<float>::cos( phi ), rho * math<float>::sin( phi ), costheta );
+	}
+
+	//! returns a random vec2 that represents a point on the unit circle
+	vec2 nextVec2()
+	{
+		float theta = nextFloat( (float)M_PI * 2.0f );
+		return vec2( math<float>::cos( theta ), math<float>::sin( theta ) );
+	}
+
+	//! returns a random float via Gaussian distribution with a mean of 0 and a standard deviation of 1.0, using the ziggurat method
+	float nextGaussian();
+
+	//! Fills \a dst with \a count values of nextUint()
+	void fill( uint32_t *dst, size_t count );
+	//! Fills \a dst with \a count random floats in the range [a,b)
+	void fill( float *dst, size_t count, float a = 0.0f, float b = 1.0f );
+	//! Fills \a dst with \a count random floats via Gaussian distribution with a mean of \a mean and a standard deviation of \a stdDev
+	void fillGaussian( float *dst, size_t count, float mean = 0.0f, float stdDev = 1.0f );
+	//! Fills \a dst with \a count random points on the unit circle
+	void fillVec2OnCircle( vec2 *dst, size_t count );
+	//! Fills \a dst with \a count random points on the unit sphere
+	void fillVec3OnSphere( vec3 *dst, size_t count );
+
+	//! Returns the calling thread's generator. A thread's generator is seeded on first use with the seed 310 and a stream number counting up from 0 in the order threads first call threadLocal(), so results only repeat across runs for a fixed threading order. Call seedThreadLocal() with a stable stream number, such as the index of a task, for reproducible results from a thread pool.
+	static FastRand&	threadLocal();
+	//! Re-seeds the calling thread's generator, equivalent to <tt>threadLocal().seed( seedValue, stream )</tt>
+	static void			seedThreadLocal( uint64_t seedValue, uint64_t stream ) { threadLocal().seed( seedValue, stream ); }
+
+ private:
+	static const int	NUM_LANES = 4;
+	//! The number of generator steps buffered in mWords, each producing two 32-bit words per lane
+	static const int	NUM_STEPS = 8;
+	static const int	NUM_WORDS = NUM_STEPS * NUM_LANES * 2;
+
+	//! Maps the top 24 bits of \a v to [0,1)
+	static float	toFloat( uint32_t v ) { return ( v >> 8 ) * ( 1.0f / 16777216.0f ); }
+
+	//! Advances all lanes \a numSteps times, writing NUM_LANES * 2 words per step to \a dst
+	void	generate( uint32_t *dst, size_t numSteps );
+	void	refill();
+	//! Calls \a fn( words, count ) with consecutive runs of \a count words, in sequence order
+	template<typename FnT>
+	void	consumeWords( size_t count, const FnT &fn );
+
+	//! xoshiro256++ state, indexed [word][lane] so each step is a loop over lanes
+	uint64_t	mState[4][NUM_LANES];
+	uint32_t	mWords[NUM_WORDS];
+	int			mWordIndex;
+};
+
 } // namespace cinder
@@ -84,6 +84,10 @@ class CI_API Shape2d {
 	//! Returns the point on the Shape2d that is closest to point \a pt.
 	vec2	calcClosestPoint( const vec2 &pt ) const;
 
+	/** Flattens every contour with Path2d::flatten() into \a resultPositions, replacing its contents, in parallel for shapes with many contours. If \a resultContourOffsets
+		isn't null it receives the index of each contour's first point, followed by the total number of points. **/
+	void	flatten( std::vector<vec2> *resultPositions, std::vector<uint32_t> *resultContourOffsets, float approximationScale = 1.0f ) const;
+
 	//! Returns whether the point \a pt is contained within the boundaries of the Shape2d. If \a evenOddFill is \c true (the default) then Even-Odd fill rule is used, otherwise the Winding fill rule is applied.
 	bool	contains( const vec2 &pt, bool evenOddFill = true ) const;
 
@@ -121,4 +125,35 @@ class CI_API Shape2d {
 	std::vector<Path2d>	mContours;
 };
 
+//! Keeps a Shape2d together with its flattened contours, which are only recalculated after markDirty() or a change of approximation scale.
+class CI_API Shape2dFlattenCache {
+  public:
+	Shape2dFlattenCache( const Shape2d &shape = Shape2d(), float approximationScale = 1.0f );
+
+	const Shape2d&	getShape2d() const { return mShape; }
+	//! Returns the Shape2d for modification, which must be followed by markDirty().
+	Shape2d&		getShape2d() { return mShape; }
+	void			setShape2d( const Shape2d &shape ) { mShape = shape; mDirty = true; }
+
+	float			getApproximationScale() const { return mApproximationScale; }
+	void			setApproximationScale( float approximationScale );
+
+	void			markDirty() { mDirty = true; }
+	bool			isDirty() const { return mDirty; }
+
+	//! Returns the flattened points of every contour, flattening the Shape2d first if it is dirty.
+	const std::vector<vec2>&		getPoints() const { update(); return mPoints; }
+	//! Returns the index of each contour's first point in getPoints(), followed by the total number of points.
+	const std::vector<uint32_t>&	getContourOffsets() const { update(); return mContourOffsets; }
+
+  private:
+	void			update() const;
+
+	Shape2d							mShape;
+	float							mApproximationScale;
+	mutable bool					mDirty;
+	mutable std::vector<vec2>		mPoints;
+	mutable std::vector<uint32_t>	mContourOffsets;
+};
+
 } // namespace cinder
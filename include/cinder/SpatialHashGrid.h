@@ -0,0 +1,264 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Thread.h"
+#include "cinder/Vector.h"
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+namespace cinder {
+
+/*! Uniform grid over 2D or 3D points for neighbor queries on point sets that move every frame, such as particle systems.
+	Cells are hashed into a fixed-size table, so the grid is unbounded and its memory depends only on the number of points.
+	build() counting-sorts the points by cell in parallel and in linear time, copying their positions into cell order so
+	neighboring points are contiguous. Within a cell, points keep their source order, so results are deterministic.
+	The pair queries look up the cells around each run of points sharing a cell once, so they are fastest with the cell size close to the radius.
+	Queries report indices into the array the grid was built from, and are safe to call from several threads at once.
+	getSortedIndices() maps cell order back to those indices, which can be used to reorder per-point attributes for locality. */
+template<typename VecT>
+class CI_API SpatialHashGridT {
+  public:
+	typedef typename VecT::value_type							T;
+	static const int											DIMS = sizeof( VecT ) / sizeof( T );
+	typedef glm::vec<sizeof( VecT ) / sizeof( T ), int32_t>		CellT;
+
+	/*! Creates an empty grid with cubic cells of size \a cellSize, which works best at around the typical query radius.
+		\a tableSize sets the number of hash buckets, rounded up to a power of two; the default \c 0 uses twice the number of points at each build(). */
+	SpatialHashGridT( float cellSize, size_t tableSize = 0 );
+
+	//! Rebuilds the grid over the \a numPoints entries of \a points, reusing its storage.
+	void	build( const VecT *points, size_t numPoints );
+	//! Rebuilds the grid over \a points, reusing its storage.
+	void	build( const std::vector<VecT> &points ) { build( points.data(), points.size() ); }
+
+	//! Calls \a fn( uint32_t index, float distanceSquared ) for each point within \a radius of \a point.
+	template<typename FnT>
+	void	forEachInRadius( const VecT &point, float radius, const FnT &fn ) const;
+	//! Appends the indices of the points within \a radius of \a point to \a result. Returns the number appended.
+	size_t	findInRadius( const VecT &point, float radius, std::vector<uint32_t> *result ) const;
+	//! Calls \a fn( uint32_t index ) for each point in the cell containing \a point and the cells adjacent to it, regardless of distance.
+	template<typename FnT>
+	void	forEachInNeighborhood( const VecT &point, const FnT &fn ) const;
+
+	//! Calls \a fn( uint32_t indexA, uint32_t indexB, float distanceSquared ) once for each pair of points within \a radius of each other.
+	template<typename FnT>
+	void	forEachPair( float radius, const FnT &fn ) const { forEachPair( radius, 0, getNumPoints(), fn ); }
+	/*! Like forEachPair( radius, fn ), restricted to the pairs whose first point lies at positions [\a begin, \a end) of the cell order.
+		Chunks covering [0, getNumPoints()) together visit every pair once, so they can be processed on separate threads, for example
+		by parallelFor(), as long as \a fn accumulates each chunk's results separately. */
+	template<typename FnT>
+	void	forEachPair( float radius, size_t begin, size_t end, const FnT &fn ) const;
+	/*! Calls \a fn( uint32_t index, uint32_t neighborIndex, float distanceSquared ) for each point and each other point within \a radius of it,
+		in parallel. Every pair is visited in both directions. All calls for a given \a index are made consecutively from the same thread,
+		so \a fn can accumulate into per-point storage, such as forces, without synchronization. */
+	template<typename FnT>
+	void	forEachNeighborParallel( float radius, const FnT &fn ) const;
+
+	size_t	getNumPoints() const { return mIndices.size(); }
+	float	getCellSize() const { return mCellSize; }
+	size_t	getTableSize() const { return mCellStart.empty() ? 0 : mCellStart.size() - 1; }
+	//! Returns the cell containing \a point
+	CellT	getCell( const VecT &point ) const;
+	//! Returns the points in cell order
+	const std::vector<VecT>&		getSortedPoints() const { return mPoints; }
+	//! Returns the index in the source array of each point in cell order
+	const std::vector<uint32_t>&	getSortedIndices() const { return mIndices; }
+
+  protected:
+	uint32_t	hashCell( const CellT &cell ) const;
+	//! Calls \a fn( uint32_t position ) for the cell order position of each point in the cells from \a minCell to \a maxCell inclusive
+	template<typename FnT>
+	void		forEachInCells( const CellT &minCell, const CellT &maxCell, const FnT &fn ) const;
+	/*! Calls \a fn( uint32_t position, uint32_t neighborPosition, float distanceSquared ) for each point at positions [\a begin, \a end) of the
+		cell order and each other point within \a radius of it, or only those after it in cell order if \a onlyLater is \c true. Points sharing
+		a cell are contiguous, so the cells around them are looked up once for the whole run. */
+	template<typename FnT>
+	void		forEachNeighborOfRange( float radius, size_t begin, size_t end, bool onlyLater, const FnT &fn ) const;
+
+	float		mCellSize, mInvCellSize;
+	size_t		mTableSize;
+	uint32_t	mMask;
+
+	std::vector<uint32_t>		mCellStart; // first cell order position of each bucket, plus the total
+	std::vector<uint32_t>		mIndices; // in cell order
+	std::vector<VecT>			mPoints; // in cell order
+	std::vector<CellT>			mCells; // in cell order; distinguishes cells sharing a bucket, whose points are kept apart
+	std::vector<uint32_t>		mBuckets; // bucket of each source point, used while building
+	std::unique_ptr<std::atomic<uint32_t>[]>	mCursors; // per bucket counts and write positions, used while building
+	size_t						mCursorsCapacity;
+};
+
+typedef SpatialHashGridT<vec2>	SpatialHashGrid2;
+typedef SpatialHashGridT<vec3>	SpatialHashGrid3;
+
+template<typename VecT>
+inline typename SpatialHashGridT<VecT>::CellT SpatialHashGridT<VecT>::getCell( const VecT &point ) const
+{
+	CellT result;
+	for( int d = 0; d < DIMS; ++d )
+		result[d] = (int32_t)std::floor( point[d] * mInvCellSize );
+	return result;
+}
+
+// Buckets are the low bits of the cell's coordinates mixed by the splitmix64 finalizer, so every bit of every coordinate affects
+// the bucket. Cells spread evenly over the table even when the points lie in a plane or along a line, as they would not with
+// the coordinates' low bits alone.
+template<typename VecT>
+inline uint32_t SpatialHashGridT<VecT>::hashCell( const CellT &cell ) const
+{
+	uint64_t h = 0;
+	for( int d = 0; d < DIMS; ++d )
+		h = h * 0x9E3779B97F4A7C15ull + (uint32_t)cell[d];
+	h = ( h ^ ( h >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+	h = ( h ^ ( h >> 27 ) ) * 0x94D049BB133111EBull;
+	h ^= h >> 31;
+	return (uint32_t)h & mMask;
+}
+
+template<typename VecT>
+template<typename FnT>
+void SpatialHashGridT<VecT>::forEachInCells( const CellT &minCell, const CellT &maxCell, const FnT &fn ) const
+{
+	if( mIndices.empty() )
+		return;
+
+	CellT cell = minCell;
+	while( true ) {
+		const uint32_t bucket = hashCell( cell );
+		for( uint32_t p = mCellStart[bucket], end = mCellStart[bucket + 1]; p < end; ++p ) {
+			if( mCells[p] == cell )
+				fn( p );
+		}
+		// advance through the box of cells like an odometer
+		int d = 0;
+		for( ; d < DIMS; ++d ) {
+			if( cell[d] < maxCell[d] ) {
+				++cell[d];
+				break;
+			}
+			cell[d] = minCell[d];
+		}
+		if( d == DIMS )
+			break;
+	}
+}
+
+template<typename VecT>
+template<typename FnT>
+void SpatialHashGridT<VecT>::forEachInRadius( const VecT &point, float radius, const FnT &fn ) const
+{
+	if( radius < 0 )
+		return;
+
+	const float radiusSquared = radius * radius;
+	forEachInCells( getCell( point - VecT( radius ) ), getCell( point + VecT( radius ) ), [&]( uint32_t p ) {
+		const VecT delta = mPoints[p] - point;
+		const float d2 = glm::dot( delta, delta );
+		if( d2 <= radiusSquared )
+			fn( mIndices[p], d2 );
+	} );
+}
+
+template<typename VecT>
+template<typename FnT>
+void SpatialHashGridT<VecT>::forEachInNeighborhood( const VecT &point, const FnT &fn ) const
+{
+	const CellT cell = getCell( point );
+	forEachInCells( cell - CellT( 1 ), cell + CellT( 1 ), [&]( uint32_t p ) {
+		fn( mIndices[p] );
+	} );
+}
+
+template<typename VecT>
+template<typename FnT>
+void SpatialHashGridT<VecT>::forEachNeighborOfRange( float radius, size_t begin, size_t end, bool onlyLater, const FnT &fn ) const
+{
+	if( radius < 0 || begin >= end )
+		return;
+
+	const float radiusSquared = radius * radius;
+	const CellT reach( (int32_t)std::ceil( radius * mInvCellSize ) );
+	std::vector<std::pair<uint32_t, uint32_t>> ranges;
+	for( uint32_t runBegin = (uint32_t)begin; runBegin < end; ) {
+		const CellT cell = mCells[runBegin];
+		uint32_t runEnd = runBegin + 1;
+		while( runEnd < end && mCells[runEnd] == cell )
+			++runEnd;
+
+		// gather the contiguous ranges of points in the surrounding cells
+		ranges.clear();
+		uint32_t rangeBegin = 0, rangeEnd = 0;
+		forEachInCells( cell - reach, cell + reach, [&]( uint32_t q ) {
+			if( q != rangeEnd ) {
+				if( rangeBegin != rangeEnd )
+					ranges.push_back( std::make_pair( rangeBegin, rangeEnd ) );
+				rangeBegin = q;
+			}
+			rangeEnd = q + 1;
+		} );
+		if( rangeBegin != rangeEnd )
+			ranges.push_back( std::make_pair( rangeBegin, rangeEnd ) );
+
+		for( uint32_t p = runBegin; p < runEnd; ++p ) {
+			const VecT point = mPoints[p];
+			for( const auto &range : ranges ) {
+				for( uint32_t q = onlyLater ? std::max( range.first, p + 1 ) : range.first; q < range.second; ++q ) {
+					const VecT delta = mPoints[q] - point;
+					const float d2 = glm::dot( delta, delta );
+					if( d2 <= radiusSquared && q != p )
+						fn( p, q, d2 );
+				}
+			}
+		}
+		runBegin = runEnd;
+	}
+}
+
+template<typename VecT>
+template<typename FnT>
+void SpatialHashGridT<VecT>::forEachPair( float radius, size_t begin, size_t end, const FnT &fn ) const
+{
+	// each pair is reported from the point that comes first in cell order
+	forEachNeighborOfRange( radius, begin, end, true, [&]( uint32_t p, uint32_t q, float d2 ) {
+		fn( mIndices[p], mIndices[q], d2 );
+	} );
+}
+
+template<typename VecT>
+template<typename FnT>
+void SpatialHashGridT<VecT>::forEachNeighborParallel( float radius, const FnT &fn ) const
+{
+	parallelFor( getNumPoints(), [&]( size_t begin, size_t end ) {
+		forEachNeighborOfRange( radius, begin, end, false, [&]( uint32_t p, uint32_t q, float d2 ) {
+			fn( mIndices[p], mIndices[q], d2 );
+		} );
+	}, 256 );
+}
+
+} // namespace cinder
@@ -32,6 +32,9 @@
 #endif
 
 #include <string>
+#include <vector>
+
+struct z_stream_s;
 
 namespace cinder {
 
@@ -340,6 +343,82 @@ class CI_API OStreamMem : public OStream {
 };
 
 
+typedef std::shared_ptr<class CompressingOStream>	CompressingOStreamRef;
+
+/** \brief Deflates everything written to it into \a target as a single zlib (or gzip) stream.
+ *
+ * Input is split into blocks of \a blockSize bytes which are deflated independently across cores, pigz-style. Each block is
+ * primed with the preceding 32k of input so the ratio stays close to single-threaded deflate, and the result is a standard
+ * stream readable by any zlib decoder, including decompressBuffer() and DecompressingIStream. **/
+class CI_API CompressingOStream : public OStream {
+  public:
+	static CompressingOStreamRef	create( const OStreamRef &target, int8_t compressionLevel = DEFAULT_COMPRESSION_LEVEL, bool useGZip = false, size_t blockSize = DEFAULT_COMPRESSION_BLOCK_SIZE )
+	{ return CompressingOStreamRef( new CompressingOStream( target, compressionLevel, useGZip, blockSize ) ); }
+	//! Calls finish() if it hasn't been called already
+	~CompressingOStream();
+
+	//! Compresses any buffered input and writes the stream trailer to the target. Nothing may be written afterwards.
+	void				finish();
+
+	//! Returns the number of uncompressed bytes written so far
+	virtual off_t		tell() const { return static_cast<off_t>( mTotalIn ); }
+	//! Unsupported; throws StreamExc
+	virtual void		seekAbsolute( off_t absoluteOffset );
+	//! Unsupported; throws StreamExc
+	virtual void		seekRelative( off_t relativeOffset );
+
+  protected:
+	CompressingOStream( const OStreamRef &target, int8_t compressionLevel, bool useGZip, size_t blockSize );
+
+	virtual void		IOWrite( const void *t, size_t size );
+	void				compressPending( bool finalBlock );
+
+	OStreamRef				mTarget;
+	int						mCompressionLevel;
+	bool					mUseGZip, mFinished;
+	size_t					mBlockSize, mBatchSize;
+	std::vector<uint8_t>	mPending, mDictionary;
+	uint32_t				mCheck; // adler32 or crc32 of all input
+	uint64_t				mTotalIn;
+};
+
+
+typedef std::shared_ptr<class DecompressingIStream>	DecompressingIStreamRef;
+
+//! Incrementally inflates a zlib or gzip stream read from \a source, such as one produced by CompressingOStream or compressBuffer(). The format is detected automatically.
+class CI_API DecompressingIStream : public IStreamCinder {
+  public:
+	static DecompressingIStreamRef	create( const IStreamRef &source )	{ return DecompressingIStreamRef( new DecompressingIStream( source ) ); }
+	~DecompressingIStream();
+
+	size_t		readDataAvailable( void *dest, size_t maxSize );
+
+	//! Seeking forward decompresses and discards data. Seeking backward is limited to the most recently decompressed bytes, otherwise throws StreamExc.
+	void		seekAbsolute( off_t absoluteOffset );
+	void		seekRelative( off_t relativeOffset );
+	//! Returns the number of decompressed bytes consumed so far
+	off_t		tell() const { return static_cast<off_t>( mOutputOffset + mOutputPos ); }
+	//! Returns 0, as the decompressed size is unknown until the entire stream has been read
+	off_t		size() const { return 0; }
+
+	bool		isEof() const { return mStreamEnd && mOutputPos == mOutputEnd; }
+
+  protected:
+	DecompressingIStream( const IStreamRef &source );
+
+	virtual void	IORead( void *t, size_t size );
+	//! Inflates more data into mOutput, retaining a little history for short backward seeks
+	void			fill();
+
+	IStreamRef					mSource;
+	std::unique_ptr<z_stream_s>	mZStream;
+	std::vector<uint8_t>		mInput, mOutput;
+	size_t						mOutputPos, mOutputEnd;
+	uint64_t					mOutputOffset; // decompressed offset of mOutput[0]
+	bool						mStreamEnd;
+};
+
+
 // This class is a utility to save and restore a stream's state
 class CI_API IStreamStateRestore {
  public:
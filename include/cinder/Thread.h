@@ -34,6 +34,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <future>
+#include <functional>
 
 namespace cinder {
 //! Create an instance of this class at the beginning of any multithreaded code that makes use of Cinder functionality
@@ -51,4 +52,12 @@ class CI_API ThreadSetup {
 #endif
 };
 
+//! Returns the number of threads that participate in parallelFor(), including the calling thread. Matches std::thread::hardware_concurrency() and is always at least \c 1.
+CI_API size_t	getNumParallelThreads();
+
+/** Invokes \a fn( begin, end ) over consecutive ranges which together cover [0, \a count), distributing the ranges across a shared pool of worker threads.
+	Each range contains at least \a grainSize elements, except possibly the last. The calling thread executes ranges as well and the call returns once every range has completed.
+	Nested calls from within \a fn are safe. The first exception thrown by \a fn is rethrown on the calling thread after all ranges have finished. **/
+CI_API void		parallelFor( size_t count, const std::function<void( size_t begin, size_t end )> &fn, size_t grainSize = 1 );
+
 } // namespace cinder
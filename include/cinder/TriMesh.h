@@ -26,6 +26,8 @@
 #pragma once
 
 #include <vector>
+#include <set>
+#include <limits>
 #include "cinder/Vector.h"
 #include "cinder/AxisAlignedBox.h"
 #include "cinder/DataSource.h"
@@ -38,6 +40,7 @@
 namespace cinder {
 
 typedef std::shared_ptr<class TriMesh>		TriMeshRef;
+class TriMeshBinary;
 	
 class CI_API TriMesh : public geom::Source {
  public:
@@ -68,6 +71,35 @@ class CI_API TriMesh : public geom::Source {
 		uint8_t		mTexCoords0Dims, mTexCoords1Dims, mTexCoords2Dims, mTexCoords3Dims;
 	};
 
+	//! Options for writing the version 3 binary layout, which TriMeshBinary can load without intermediate copies.
+	class CI_API BinaryOptions {
+	  public:
+		BinaryOptions() : mAttribMask( ~0u ), mQuantizePositions( false ), mQuantizeNormals( false ) {}
+
+		//! Restricts the written attributes to \a attribs. All attributes are written by default.
+		BinaryOptions&	attribs( const std::set<geom::Attrib> &attribs );
+		//! Stores positions as half floats, halving their size at the cost of precision. Default is \c false.
+		BinaryOptions&	quantizePositions( bool quantize = true ) { mQuantizePositions = quantize; return *this; }
+		//! Stores normals, tangents and bitangents as 16-bit octahedral pairs, a third of their full size. Default is \c false.
+		BinaryOptions&	quantizeNormals( bool quantize = true ) { mQuantizeNormals = quantize; return *this; }
+
+		uint32_t	mAttribMask;
+		bool		mQuantizePositions, mQuantizeNormals;
+	};
+
+	//! Post-transform vertex cache efficiency of the triangle order, simulated with a FIFO cache
+	struct VertexCacheStats {
+		//! Average cache miss ratio: vertex shader invocations per triangle, from 3 down to about 0.5
+		float	mAcmr;
+		//! Average transform to vertex ratio: vertex shader invocations per referenced vertex, 1 at best
+		float	mAtvr;
+	};
+
+	//! Vertex cache statistics before and after an optimization pass
+	struct OptimizeResult {
+		VertexCacheStats	mBefore, mAfter;
+	};
+
 	static TriMeshRef	create() { return TriMeshRef( new TriMesh( Format().positions().normals().texCoords() ) ); }
 	static TriMeshRef	create( const Format &format ) { return TriMeshRef( new TriMesh( format ) ); }
 	static TriMeshRef	create( const geom::Source &source ) { return TriMeshRef( new TriMesh( source ) ); }
@@ -324,10 +356,12 @@ class CI_API TriMesh : public geom::Source {
 	//! Calculates the bounding box of all vertices as transformed by \a transform. Fails if the positions are not 3D.
 	AxisAlignedBox	calcBoundingBox( const mat4 &transform ) const;
 
-	//! Fills this TriMesh with the data from a binary file, which was created with TriMesh::write().
+	//! Fills this TriMesh with the data from a binary file, which was created with TriMesh::write(). Version 3 files are memory-mapped and copied in a single pass.
 	void		read( const DataSourceRef &dataSource );
 	//! Writes this TriMesh out to a binary data file.
 	void		write( const DataTargetRef &dataTarget ) const { write( dataTarget, ~0u ); }
+	//! Writes this TriMesh out to a version 3 binary data file, with 16-byte aligned attribute streams and 16-bit indices when they suffice.
+	void		write( const DataTargetRef &dataTarget, const BinaryOptions &options ) const;
 	//! Writes this TriMesh out to a binary data file. If \a writeNormals or \a writeTangents is \c true, normals and/or tangents are written to the file.
 	void		write( const DataTargetRef &dataTarget, bool writeNormals, bool writeTangents ) const;
 	//! Writes this TriMesh out to a binary data file. You can specify which attributes to write by supplying a list of \a attribs.
@@ -336,9 +370,11 @@ class CI_API TriMesh : public geom::Source {
 	/*! Adds or replaces normals by calculating them from the vertices and faces. If \a smooth is TRUE,
 		similar vertices are grouped together to calculate their average. This will not change the mesh,
 		nor will it affect texture mapping. If \a weighted is TRUE, larger polygons contribute more to
-		the calculated normal. Renormalization requires 3D vertices. */
+		the calculated normal. Renormalization requires 3D vertices. Large meshes are processed in parallel,
+		which makes this suitable for recalculating the normals of a deforming mesh every frame. */
 	bool		recalculateNormals( bool smooth = false, bool weighted = false );
-	//! Adds or replaces tangents by calculating them from the normals and texture coordinates. Requires 3D normals and 2D texture coordinates.
+	/*! Adds or replaces tangents by calculating them from the normals and texture coordinates. Requires 3D normals and 2D texture coordinates.
+		As in MikkTSpace, triangle tangents are projected onto each vertex's tangent plane and weighted by the corner angle. */
 	bool		recalculateTangents();
 	//! Adds or replaces bitangents by calculating them from the normals and tangents. Requires 3D normals and tangents.
 	bool		recalculateBitangents();
@@ -346,6 +382,27 @@ class CI_API TriMesh : public geom::Source {
 	/*! Subdivide each triangle of the TriMesh into \a division times division triangles. Division less than 2 leaves the mesh unaltered.
 		Optionally, vertices are normalized if \a normalize is TRUE. */
 	void		subdivide( int division = 2, bool normalize = false );
+	/*! Reduces the TriMesh to roughly \a targetRatio of its triangles with quadric error edge collapses, stopping early once the error would exceed \a targetError,
+		a fraction of the largest bounding box extent. Returns the resulting error. \see geom::Simplify */
+	float		simplify( float targetRatio, float targetError = std::numeric_limits<float>::max() );
+	/*! Returns a simplified copy of this TriMesh for each of the triangle fractions in \a ratios. A single sequence of collapses produces every level,
+		so each level is a coarsening of the previous one. \a options supplies the error limit and attribute weights; its ratio is ignored. */
+	std::vector<TriMeshRef>	buildLodChain( const std::vector<float> &ratios, const geom::Simplify &options = geom::Simplify() ) const;
+
+	//! Simulates a FIFO post-transform cache of \a cacheSize vertices over the triangle order.
+	VertexCacheStats	calcVertexCacheStats( uint32_t cacheSize = 16 ) const;
+	/*! Merges vertices whose positions and other attributes all lie within \a epsilon of each other, or which match exactly when \a epsilon is \c 0.
+		Removes unreferenced vertices and the triangles which become degenerate. */
+	OptimizeResult		weld( float epsilon = 0 );
+	//! Reorders triangles for post-transform vertex cache reuse with Tipsify (Sander et al. 2007), which runs in linear time.
+	OptimizeResult		optimizeVertexCache( uint32_t cacheSize = 16 );
+	/*! Reorders triangles as optimizeVertexCache() does, then splits the order into clusters whose cache miss ratio stays within \a threshold
+		of the optimized one and draws the clusters most likely to occlude others first. */
+	OptimizeResult		optimizeOverdraw( float threshold = 1.05f, uint32_t cacheSize = 16 );
+	//! Reorders vertices in the order the triangles first reference them, remapping every attribute and dropping unreferenced vertices.
+	OptimizeResult		optimizeVertexFetch();
+	//! Runs weld(), optimizeOverdraw() and optimizeVertexFetch() in turn.
+	OptimizeResult		optimize( uint32_t cacheSize = 16 );
 
 	//! Create TriMesh from vectors of vertex data.
 /*	static TriMesh		create( std::vector<uint32_t> &indices, const std::vector<ColorAf> &colors,
@@ -366,7 +423,12 @@ class CI_API TriMesh : public geom::Source {
 
 	//! Returns whether or not the vertex, color etc. at both indices is the same.
 	bool		verticesEqual( uint32_t indexA, uint32_t indexB ) const;
+	//! Returns whether \a attr holds a value for every vertex.
+	bool		hasAttribData( geom::Attrib attr ) const;
+	//! Rebuilds every attribute from the vertices listed in \a sourceVertices, in that order.
+	void		remapVertices( const std::vector<uint32_t> &sourceVertices );
 
+	void		readImplV3( const TriMeshBinary &binary );
 	void		readImplV2( const IStreamRef &in );
 	void		readImplV1( const IStreamRef &in );
 
@@ -394,6 +456,65 @@ class CI_API TriMesh : public geom::Source {
 	std::vector<uint32_t>	mIndices;
 	
 	friend class TriMeshGeomTarget;
+	friend class TriMeshBinary;
+};
+
+/*! A geom::Source over a version 3 TriMesh binary file, as written by TriMesh::write( DataTargetRef, BinaryOptions ).
+	Files are memory-mapped and unquantized attributes are handed to the geom::Target straight from the mapping,
+	so gl::VboMesh::create( TriMeshBinary( loadFile( "mesh.trimesh" ) ) ) uploads without building a TriMesh first.
+	Copies share the underlying data. */
+class CI_API TriMeshBinary : public geom::Source {
+  public:
+	/*! Loads the version 3 file in \a dataSource. Throws a TriMeshBinaryExc if the data isn't a valid version 3 file.
+		Verifying the checksum reads the whole file up front; pass \c false for \a verifyChecksum to skip it for trusted data. */
+	TriMeshBinary( const DataSourceRef &dataSource, bool verifyChecksum = true );
+
+	size_t				getNumVertices() const override { return mNumVertices; }
+	size_t				getNumIndices() const override { return mNumIndices; }
+	geom::Primitive		getPrimitive() const override { return geom::Primitive::TRIANGLES; }
+	uint8_t				getAttribDims( geom::Attrib attr ) const override;
+	geom::AttribSet		getAvailableAttribs() const override;
+
+	void				loadInto( geom::Target *target, const geom::AttribSet &requestedAttribs ) const override;
+	TriMeshBinary*		clone() const override { return new TriMeshBinary( *this ); }
+
+	//! Returns the stored data for \a attr if it's kept as 32-bit floats, or \c nullptr if it's absent or quantized.
+	const float*		getAttribData( geom::Attrib attr ) const;
+	//! Returns whether \a attr is stored quantized, and so is decoded on each load.
+	bool				isAttribQuantized( geom::Attrib attr ) const;
+
+  protected:
+	//! One stream, as described by the file's attribute table. The index stream uses geom::NUM_ATTRIBS.
+	struct AttribStream {
+		geom::Attrib	mAttrib;
+		uint8_t			mDims, mEncoding;
+		size_t			mCount; // in elements of mDims components
+		const uint8_t	*mData;
+	};
+
+	const AttribStream*	findStream( geom::Attrib attr ) const;
+	//! Decodes elements [\a begin, \a end) of \a stream into \a dest, which points at the output for element 0; floats for attributes, uint32_t for indices
+	static void			decodeElements( const AttribStream &stream, void *dest, size_t begin, size_t end );
+	//! Decodes all of \a stream into \a dest in parallel
+	static void			decodeStream( const AttribStream &stream, void *dest );
+	/*! Decodes each stream into its paired destination while verifying the checksum, block by block and in parallel,
+		so the file is only read once. Throws TriMeshBinaryExc on a mismatch. */
+	void				decodeVerified( const std::vector<std::pair<const AttribStream*, void*>> &destinations ) const;
+
+	std::shared_ptr<const void>	mStorage; // MemoryMappedFile or Buffer that owns the data
+	const uint8_t				*mData;
+	size_t						mHeaderSize, mFileSize;
+	uint64_t					mChecksum;
+	size_t						mNumVertices, mNumIndices;
+	AttribStream				mIndexStream;
+	std::vector<AttribStream>	mStreams;
+
+	friend class TriMesh;
+};
+
+class CI_API TriMeshBinaryExc : public Exception {
+  public:
+	TriMeshBinaryExc( const std::string &description ) : Exception( description ) {}
 };
 
 } // namespace cinder
@@ -28,15 +28,36 @@
 #include "cinder/Shape2d.h"
 #include "cinder/Path2d.h"
 
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
 struct TESStesselator;
 
 namespace cinder {
 
-//! Converts an arbitrary Shape2d into a TriMesh2d
+//! Converts an arbitrary Shape2d into a TriMesh2d. A single simple (non-self-intersecting) contour is triangulated by ear clipping; everything else is handed to libtess2.
 class CI_API Triangulator {
   public:
 	typedef enum Winding { WINDING_ODD, WINDING_NONZERO, WINDING_POSITIVE, WINDING_NEGATIVE, WINDING_ABS_GEQ_TWO } Winding;
 
+	//! The triangulations of a batch of shapes, sharing one vertex buffer and one index buffer. Indices refer to the shared vertex buffer, so the whole batch can be drawn at once.
+	struct CI_API Batch {
+		std::vector<vec2>		mPositions;
+		std::vector<uint32_t>	mIndices;
+		//! Index of each shape's first vertex in \a mPositions, followed by the total number of vertices
+		std::vector<uint32_t>	mVertexOffsets;
+		//! Index of each shape's first index in \a mIndices, followed by the total number of indices
+		std::vector<uint32_t>	mIndexOffsets;
+
+		//! Returns the number of shapes in the batch
+		size_t		getNumShapes() const { return mVertexOffsets.empty() ? 0 : mVertexOffsets.size() - 1; }
+		//! Returns a TriMesh2d containing the whole batch
+		TriMesh		calcMesh() const;
+	};
+
 	//! Default constructor
 	Triangulator();
 	//! Constructs using a Path2d. \a approximationScale represents how smooth the tesselation is, with 1.0 corresponding to 1:1 with screen space
@@ -59,7 +80,12 @@ class CI_API Triangulator {
 	TriMesh		calcMesh( Winding winding = WINDING_ODD );
 	//! Performs the tesselation, returning a TriMesh2d
 	TriMeshRef	createMesh( Winding winding = WINDING_ODD );
-	
+	//! Performs the tesselation, replacing the contents of \a resultPositions and \a resultIndices
+	void		calcMesh( std::vector<vec2> *resultPositions, std::vector<uint32_t> *resultIndices, Winding winding = WINDING_ODD );
+
+	//! Triangulates \a shapes in parallel, with one tesselator per worker, replacing the contents of \a result.
+	static void	calcMeshes( const std::vector<Shape2d> &shapes, Batch *result, float approximationScale = 1.0f, Winding winding = WINDING_ODD );
+
 	class CI_API Exception : public cinder::Exception {
 	};
 	
@@ -68,6 +94,56 @@ class CI_API Triangulator {
 	
 	int									mAllocated;
 	std::shared_ptr<TESStesselator>		mTess;
+	//! Contours added since the last tesselation
+	std::vector<vec2>					mPoints;
+	//! Index of each contour's first point in \a mPoints, followed by the total number of points
+	std::vector<uint32_t>				mContourOffsets;
+};
+
+//! Caches the triangulations of Shape2ds by content, so that identical shapes are tesselated only once. Holds at most getMaxEntries() triangulations, discarding the least recently used. Thread-safe.
+class CI_API TriangulatorCache {
+  public:
+	/*! Holds up to \a maxEntries triangulations. With \a admitOnRepeat, a shape is only cached the second time it's requested,
+		so that shapes which change on every request, such as animated ones, never evict the shapes that are drawn repeatedly. */
+	TriangulatorCache( size_t maxEntries = 256, bool admitOnRepeat = false );
+
+	//! Returns the triangulation of \a shape, tesselating it only if no identical shape with the same \a approximationScale and \a winding is cached
+	std::shared_ptr<const TriMesh>	get( const Shape2d &shape, float approximationScale = 1.0f, Triangulator::Winding winding = Triangulator::WINDING_ODD );
+	//! Returns the triangulation of \a path, tesselating it only if no identical path with the same \a approximationScale and \a winding is cached
+	std::shared_ptr<const TriMesh>	get( const Path2d &path, float approximationScale = 1.0f, Triangulator::Winding winding = Triangulator::WINDING_ODD );
+
+	//! Removes every cached triangulation
+	void		clear();
+	//! Returns the number of cached triangulations
+	size_t		getNumEntries() const;
+	size_t		getMaxEntries() const;
+	//! Sets the maximum number of cached triangulations, discarding the least recently used ones beyond it
+	void		setMaxEntries( size_t maxEntries );
+	//! Returns the number of get() calls that were answered from the cache
+	size_t		getNumHits() const;
+	//! Returns the number of get() calls that required a tesselation
+	size_t		getNumMisses() const;
+
+  protected:
+	struct Entry {
+		uint64_t						mHash;
+		std::vector<uint32_t>			mKey;
+		std::shared_ptr<const TriMesh>	mMesh;
+	};
+
+	std::shared_ptr<const TriMesh>	get( const std::vector<uint32_t> &key, const std::function<void( Triangulator *triangulator )> &addContours, Triangulator::Winding winding );
+	//! Returns whether a missed key with \a hash should be cached, recording it as seen once if not. Requires mMutex to be locked.
+	bool							admit( uint64_t hash );
+	void							trim();
+
+	mutable std::mutex											mMutex;
+	size_t														mMaxEntries, mNumHits, mNumMisses;
+	bool														mAdmitOnRepeat;
+	//! Hashes of the keys which missed once but weren't cached, oldest first and at most mMaxEntries of them
+	std::deque<uint64_t>										mSeenOnce;
+	//! Most recently used first
+	std::list<Entry>											mEntries;
+	std::unordered_multimap<uint64_t, std::list<Entry>::iterator>	mLookup;
 };
 
 } // namespace cinder
\ No newline at end of file
@@ -25,6 +25,7 @@
 #pragma once
 
 #include "cinder/Cinder.h"
+#include "cinder/Stream.h"
 
 #include <string>
 #include <functional>
@@ -46,6 +47,18 @@ CI_API std::string		toUtf8( const std::u32string &utf32Str );
 CI_API std::u16string	toUtf16( const std::u32string &utf32str );
 CI_API std::u32string	toUtf32( const std::u16string &utf16str );
 
+//! Reads UTF-8 text from \a utf8Input until EOF and writes it to \a utf16Output as native-endian UTF-16, a chunk at a time. Sequences split across chunk boundaries are carried over.
+CI_API void		transcodeUtf8ToUtf16( const IStreamRef &utf8Input, const OStreamRef &utf16Output );
+//! Reads UTF-8 text from \a utf8Input until EOF and writes it to \a utf32Output as native-endian UTF-32, a chunk at a time.
+CI_API void		transcodeUtf8ToUtf32( const IStreamRef &utf8Input, const OStreamRef &utf32Output );
+//! Reads native-endian UTF-16 text from \a utf16Input until EOF and writes it to \a utf8Output as UTF-8, a chunk at a time. Surrogate pairs split across chunk boundaries are carried over.
+CI_API void		transcodeUtf16ToUtf8( const IStreamRef &utf16Input, const OStreamRef &utf8Output );
+//! Reads native-endian UTF-32 text from \a utf32Input until EOF and writes it to \a utf8Output as UTF-8, a chunk at a time.
+CI_API void		transcodeUtf32ToUtf8( const IStreamRef &utf32Input, const OStreamRef &utf8Output );
+
+//! Returns whether \a str is well-formed UTF-8. Optimize operation by supplying a non-default \a lengthInBytes of \a str.
+CI_API bool		isValidUtf8( const char *str, size_t lengthInBytes = 0 );
+
 //! Returns the number of characters (not bytes) in the the UTF-8 string \a str. Optimize operation by supplying a non-default \a lengthInBytes of \a str.
 CI_API size_t	stringLengthUtf8( const char *str, size_t lengthInBytes = 0 );
 //!  Returns the UTF-32 code point of the next character in \a str, relative to the byte \a inOutByte. Increments \a inOutByte to be the first byte of the next character. Optimize operation by supplying a non-default \a lengthInBytes of \a str.
@@ -75,14 +75,14 @@ class CI_API VboMesh {
 		friend VboMesh;
 	};
   
-	//! Creates a VboMesh which represents the geom::Source \a source. Layout is derived from the contents of \a source.
-	static VboMeshRef	create( const geom::Source &source );
-	//! Creates a VboMesh which represents the geom::Source \a source using \a layout.
-	static VboMeshRef	create( const geom::Source &source, const geom::AttribSet &requestedAttribs );
-	//! Creates a VboMesh which represents the geom::Source \a source using 1 or more VboMesh::Layouts for vertex data.
-	static VboMeshRef	create( const geom::Source &source, const std::vector<VboMesh::Layout> &vertexArrayLayouts );
-	//! Creates a VboMesh which represents the geom::Source \a source using 1 or more Vbo/VboMesh::Layout pairs. A null VboRef requests allocation.
-	static VboMeshRef	create( const geom::Source &source, const std::vector<std::pair<VboMesh::Layout,VboRef>> &vertexArrayLayouts, const VboRef &indexVbo = nullptr );
+	//! Creates a VboMesh which represents the geom::Source \a source. Layout is derived from the contents of \a source. Loads \a source through \a cache when it isn't \c nullptr.
+	static VboMeshRef	create( const geom::Source &source, geom::SourceCache *cache = nullptr );
+	//! Creates a VboMesh which represents the geom::Source \a source using \a layout. Loads \a source through \a cache when it isn't \c nullptr.
+	static VboMeshRef	create( const geom::Source &source, const geom::AttribSet &requestedAttribs, geom::SourceCache *cache = nullptr );
+	//! Creates a VboMesh which represents the geom::Source \a source using 1 or more VboMesh::Layouts for vertex data. Loads \a source through \a cache when it isn't \c nullptr.
+	static VboMeshRef	create( const geom::Source &source, const std::vector<VboMesh::Layout> &vertexArrayLayouts, geom::SourceCache *cache = nullptr );
+	//! Creates a VboMesh which represents the geom::Source \a source using 1 or more Vbo/VboMesh::Layout pairs. A null VboRef requests allocation. Loads \a source through \a cache when it isn't \c nullptr.
+	static VboMeshRef	create( const geom::Source &source, const std::vector<std::pair<VboMesh::Layout,VboRef>> &vertexArrayLayouts, const VboRef &indexVbo = nullptr, geom::SourceCache *cache = nullptr );
 	//! Creates a VboMesh which represents the user's vertex buffer objects. Allows optional \a indexVbo to enable indexed vertices; creates a static index VBO if none provided.
 	static VboMeshRef	create( uint32_t numVertices, GLenum glPrimitive, const std::vector<std::pair<geom::BufferLayout,VboRef>> &vertexArrayBuffers, uint32_t numIndices = 0, GLenum indexType = GL_UNSIGNED_SHORT, const VboRef &indexVbo = VboRef() );
 	//! Creates a VboMesh which represents the user's vertex buffer objects. Allows optional \a indexVbo to enable indexed vertices; creates a static index VBO if none provided.
@@ -269,7 +269,7 @@ class CI_API VboMesh {
 #endif
 
   protected:
-	VboMesh( const geom::Source &source, std::vector<std::pair<Layout,VboRef>> vertexArrayBuffers, const VboRef &indexArrayVbo );
+	VboMesh( const geom::Source &source, std::vector<std::pair<Layout,VboRef>> vertexArrayBuffers, const VboRef &indexArrayVbo, geom::SourceCache *cache );
 	VboMesh( uint32_t numVertices, uint32_t numIndices, GLenum glPrimitive, GLenum indexType, const std::vector<std::pair<geom::BufferLayout,VboRef>> &vertexArrayBuffers, const VboRef &indexVbo );
 	VboMesh( uint32_t numVertices, uint32_t numIndices, GLenum glPrimitive, GLenum indexType, const std::vector<Layout> &vertexArrayLayouts, const VboRef &indexVbo );
 
@@ -37,6 +37,7 @@ namespace cinder {
 	class TriMesh;
 	class Path2d;
 	class Shape2d;
+	class Shape2dFlattenCache;
 }
 
 namespace cinder { namespace gl {
@@ -57,10 +58,12 @@ CI_API void draw( const std::vector<vec3> &points, bool isClosed = false );
 CI_API void draw( const Path2d &path, float approximationScale = 1.0f );
 //! Draws a Shaped2d \a shaped using approximation scale \a approximationScale. 1.0 corresponds to screenspace, 2.0 is double screen resolution, etc
 CI_API void draw( const Shape2d &shape, float approximationScale = 1.0f );
+//! Draws the cached flattened contours of \a shape, which are only recalculated when it is dirty
+CI_API void draw( const Shape2dFlattenCache &shape );
 //! Draws a TriMesh \a mesh at the origin. Currently only uses position and index information.
 CI_API void draw( const TriMesh &mesh );
-//! Draws a geom::Source \a source at the origin.
-CI_API void draw( const geom::Source &source );
+//! Draws a geom::Source \a source at the origin. Loads \a source through \a cache when it isn't \c nullptr, so that Sources drawn repeatedly are only generated once.
+CI_API void draw( const geom::Source &source, geom::SourceCache *cache = nullptr );
 
 //! Draws a CubeMapTex \a texture inside \a rect with an equirectangular projection. If \a lod is non-default then a specific mip-level is drawn. Typical aspect ratio should be 2:1.
 CI_API void drawEquirectangular( const gl::TextureCubeMapRef &texture, const Rectf &r, float lod = -1 );
@@ -69,9 +72,9 @@ CI_API void drawHorizontalCross( const gl::TextureCubeMapRef &texture, const Rec
 //! Draws a CubeMapTex \a texture as a vertical cross, fit inside \a rect. If \a lod is non-default then a specific mip-level is drawn. Typical aspect ratio should be 3:4.
 CI_API void drawVerticalCross( const gl::TextureCubeMapRef &texture, const Rectf &rect, float lod = -1 );
 
-//! Draws a solid (filled) Path2d \a path using approximation scale \a approximationScale. 1.0 corresponds to screenspace, 2.0 is double screen resolution, etc. Performance warning: This routine tesselates the polygon into triangles. Consider using Triangulator directly.
+//! Draws a solid (filled) Path2d \a path using approximation scale \a approximationScale. 1.0 corresponds to screenspace, 2.0 is double screen resolution, etc. Tesselations are cached by content once a path is drawn twice, so redrawing an unchanged path is cheap. Consider using Triangulator directly.
 CI_API void drawSolid( const Path2d &path2d, float approximationScale = 1.0f );
-//! Draws a solid (filled) Shape2d \a shape using approximation scale \a approximationScale. 1.0 corresponds to screenspace, 2.0 is double screen resolution, etc. Performance warning: This routine tesselates the polygon into triangles. Consider using Triangulator directly.
+//! Draws a solid (filled) Shape2d \a shape using approximation scale \a approximationScale. 1.0 corresponds to screenspace, 2.0 is double screen resolution, etc. Tesselations are cached by content once a shape is drawn twice, so redrawing an unchanged path is cheap. Consider using Triangulator directly.
 CI_API void drawSolid( const Shape2d &shape, float approximationScale = 1.0f );
 CI_API void drawSolid( const PolyLine2 &polyLine );
 
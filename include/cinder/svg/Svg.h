@@ -639,6 +639,8 @@ class CI_API Use : public Node {
 	virtual bool	isDrawable() const { return false; }
 	
 	virtual Shape2d	getShape() const{ if( mReferenced ) return mReferenced->getShape(); else return Shape2d(); }
+	//! Returns the Node this Use instantiates, or \c nullptr when its reference could not be resolved
+	const Node*		getReferenced() const { return mReferenced; }
 
   protected:
 	virtual void	renderSelf( Renderer &renderer ) const;  
@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include "cinder/gl/Batch.h"
+#include "cinder/gl/draw.h"
 #include "cinder/gl/Texture.h"
 #include "cinder/svg/Svg.h"
 #include "cinder/Triangulate.h"
@@ -172,6 +174,83 @@ class CI_API SvgRendererGl : public svg::Renderer {
 	std::vector<svg::FillRule>	mFillRuleStack;
 };
 
+namespace svg {
+
+typedef std::shared_ptr<class DocMesh>	DocMeshRef;
+
+/** Compiles a svg::Doc into tessellated fill and stroke geometry which draws with a single gl::Batch, in document order. Every drawable node is flattened and tessellated once,
+	in parallel and in its own coordinate system, so that update() only rewrites the vertices of nodes whose transform, visibility, paint or opacity changed.
+	Gradients are evaluated per vertex. Group opacity is multiplied into each node's paints rather than composited. Text and images are not drawn. */
+class CI_API DocMesh {
+  public:
+	//! \a doc must outlive the DocMesh. \a approximationScale sets the flattening accuracy relative to the document's coordinates.
+	static DocMeshRef	create( const Doc &doc, float approximationScale = 1.0f ) { return DocMeshRef( new DocMesh( doc, approximationScale ) ); }
+
+	//! Re-reads the Doc, rewriting the vertices of nodes whose transform, visibility, paint or opacity changed, and re-tessellating nodes whose stroke or fill style changed or which were marked with markDirty(). Rebuilds everything after nodes were added or removed.
+	void	update();
+	//! Marks every instance of \a node for re-tessellation on the next update(), which is necessary after changing its shape
+	void	markDirty( const Node *node );
+
+	//! Uploads any vertices changed by update() and draws the Doc
+	void			draw();
+	//! Returns the gl::Batch which draw() uses, creating it if necessary
+	gl::BatchRef	getBatch();
+
+	//! Returns the number of drawable node instances, counting a node once for each svg::Use which references it
+	size_t							getNumNodes() const { return mNodes.size(); }
+	//! Returns the positions of every vertex, in the Doc's coordinates. Vertices of invisible nodes are collapsed to the origin.
+	const std::vector<vec2>&		getPositions() const { return mPositions; }
+	const std::vector<ColorAf>&		getColors() const { return mColors; }
+	const std::vector<uint32_t>&	getIndices() const { return mIndices; }
+
+  protected:
+	DocMesh( const Doc &doc, float approximationScale );
+
+	//! A node's style with inherited attributes resolved, as rendering would apply it
+	struct NodeStyle {
+		mat3		mTransform;
+		Paint		mFill, mStroke;
+		float		mOpacity, mFillOpacity, mStrokeOpacity, mStrokeWidth;
+		FillRule	mFillRule;
+		LineCap		mLineCap;
+		LineJoin	mLineJoin;
+		bool		mVisible, mDisplayed;
+	};
+
+	struct NodeMesh {
+		const Node				*mNode;
+		NodeStyle				mStyle;
+		bool					mDirty;
+		//! Tessellation in the node's own coordinates; fill vertices precede stroke vertices
+		std::vector<vec2>		mLocalPositions;
+		std::vector<uint32_t>	mLocalIndices;
+		size_t					mNumFillVertices;
+		Rectf					mLocalBounds;
+		size_t					mVertexOffset, mIndexOffset;
+	};
+
+	void	collectNodes( const Node &node, NodeStyle style, std::vector<NodeMesh> *result ) const;
+	void	tessellateNodes();
+	void	layoutNodes();
+	void	updatePositions( const NodeMesh &node );
+	void	updateColors( const NodeMesh &node );
+
+	const Doc				&mDoc;
+	float					mApproximationScale;
+	std::vector<NodeMesh>	mNodes;
+	std::vector<vec2>		mPositions;
+	std::vector<ColorAf>	mColors;
+	std::vector<uint32_t>	mIndices;
+
+	//! Vertex ranges which changed since the last draw(), or the whole mesh when mBatch needs to be recreated
+	size_t					mDirtyPositionsBegin, mDirtyPositionsEnd, mDirtyColorsBegin, mDirtyColorsEnd;
+	bool					mBuffersDirty;
+	gl::VboRef				mPositionVbo, mColorVbo;
+	gl::BatchRef			mBatch;
+};
+
+} // namespace svg
+
 namespace gl {
 inline void draw( const svg::Doc &svg )
 {
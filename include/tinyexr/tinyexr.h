@@ -100,6 +100,12 @@ extern "C" {
 #define TINYEXR_USE_PIZ (1)
 #endif
 
+// Decode and encode scanline blocks/tiles on multiple std::threads. Requires
+// C++11.
+#ifndef TINYEXR_USE_THREAD
+#define TINYEXR_USE_THREAD (0)
+#endif
+
 #ifndef TINYEXR_USE_ZFP
 #define TINYEXR_USE_ZFP (0)  // TinyEXR extension.
 // http://computation.llnl.gov/projects/floating-point-compression
@@ -218,6 +224,18 @@ typedef struct _EXRHeader {
                                // channel)
 
   int compression_type;  // compression type(TINYEXR_COMPRESSIONTYPE_*)
+
+  // Decoding selection, set by the user before LoadEXRImageFrom(Memory|File)
+  // and never freed by tinyexr. Channels whose entry in `requested_channels`
+  // ([num_channels], optional) is 0 are neither allocated nor converted, which
+  // leaves NULL in `images`. When `has_requested_window` is set, scanline
+  // blocks and tiles outside of `requested_window` (min x, min y, max x, max y,
+  // inclusive and relative to the data window) are skipped, and skipped tiles
+  // have NULL `images`. Scanline `images` then cover only the requested window,
+  // and EXRImage's `width` and `height` are its size.
+  const unsigned char *requested_channels;
+  int has_requested_window;
+  int requested_window[4];
 } EXRHeader;
 
 typedef struct _EXRMultiPartHeader {
@@ -437,6 +455,11 @@ extern int LoadEXRFromMemory(float *out_rgba, const unsigned char *memory,
 #include <omp.h>
 #endif
 
+#if TINYEXR_USE_THREAD
+#include <atomic>
+#include <thread>
+#endif
+
 #if TINYEXR_USE_MINIZ
 #else
 #include "zlib.h"
@@ -9189,6 +9212,42 @@ bool CompressZfp(std::vector<unsigned char> *outBuf, unsigned int *outSize,
 // -----------------------------------------------------------------
 //
 
+// Calls `func(i)` for i in [0, count), spreading iterations across threads
+// when TINYEXR_USE_THREAD is enabled. Iterations must be independent.
+template <typename Func>
+static void ParallelFor(int count, const Func &func) {
+#if TINYEXR_USE_THREAD
+  int num_threads =
+      (std::min)(static_cast<int>(std::thread::hardware_concurrency()), count);
+  if (num_threads > 1) {
+    std::atomic<int> next_index(0);
+    std::vector<std::thread> workers;
+    workers.reserve(static_cast<size_t>(num_threads));
+    for (int t = 0; t < num_threads; t++) {
+      workers.emplace_back([&]() {
+        int i;
+        while ((i = next_index++) < count) {
+          func(i);
+        }
+      });
+    }
+    for (size_t t = 0; t < workers.size(); t++) {
+      workers[t].join();
+    }
+    return;
+  }
+#elif defined(_OPENMP)
+#pragma omp parallel for
+  for (int i = 0; i < count; i++) {
+    func(i);
+  }
+  return;
+#endif
+  for (int i = 0; i < count; i++) {
+    func(i);
+  }
+}
+
 static void DecodePixelData(/* out */ unsigned char **out_images,
                             const int *requested_pixel_types,
                             const unsigned char *data_ptr, size_t data_len,
@@ -9223,6 +9282,7 @@ static void DecodePixelData(/* out */ unsigned char **out_images,
     //   pixel sample data for channel n for scanline 1
     //   ...
     for (int c = 0; c < static_cast<int>(num_channels); c++) {
+      if (out_images[c] == NULL) continue;  // not requested
       if (channels[c].pixel_type == TINYEXR_PIXELTYPE_HALF) {
         for (int v = 0; v < num_lines; v++) {
           const unsigned short *line_ptr = reinterpret_cast<unsigned short *>(
@@ -9330,6 +9390,7 @@ static void DecodePixelData(/* out */ unsigned char **out_images,
     //   pixel sample data for channel n for scanline 1
     //   ...
     for (size_t c = 0; c < static_cast<size_t>(num_channels); c++) {
+      if (out_images[c] == NULL) continue;  // not requested
       if (channels[c].pixel_type == TINYEXR_PIXELTYPE_HALF) {
         for (size_t v = 0; v < static_cast<size_t>(num_lines); v++) {
           const unsigned short *line_ptr = reinterpret_cast<unsigned short *>(
@@ -9453,6 +9514,7 @@ static void DecodePixelData(/* out */ unsigned char **out_images,
     //   pixel sample data for channel n for scanline 1
     //   ...
     for (size_t c = 0; c < static_cast<size_t>(num_channels); c++) {
+      if (out_images[c] == NULL) continue;  // not requested
       if (channels[c].pixel_type == TINYEXR_PIXELTYPE_HALF) {
         for (size_t v = 0; v < static_cast<size_t>(num_lines); v++) {
           const unsigned short *line_ptr = reinterpret_cast<unsigned short *>(
@@ -9585,6 +9647,7 @@ static void DecodePixelData(/* out */ unsigned char **out_images,
     //   pixel sample data for channel n for scanline 1
     //   ...
     for (size_t c = 0; c < static_cast<size_t>(num_channels); c++) {
+      if (out_images[c] == NULL) continue;  // not requested
       assert(channels[c].pixel_type == TINYEXR_PIXELTYPE_FLOAT);
       if (channels[c].pixel_type == TINYEXR_PIXELTYPE_FLOAT) {
         assert(requested_pixel_types[c] == TINYEXR_PIXELTYPE_FLOAT);
@@ -9623,6 +9686,7 @@ static void DecodePixelData(/* out */ unsigned char **out_images,
 #endif
   } else if (compression_type == TINYEXR_COMPRESSIONTYPE_NONE) {
     for (size_t c = 0; c < num_channels; c++) {
+      if (out_images[c] == NULL) continue;  // not requested
       if (channels[c].pixel_type == TINYEXR_PIXELTYPE_HALF) {
         const unsigned short *line_ptr =
             reinterpret_cast<const unsigned short *>(
@@ -9772,12 +9836,17 @@ static void ComputeChannelLayout(std::vector<size_t> *channel_offset_list,
 static unsigned char **AllocateImage(int num_channels,
                                      const EXRChannelInfo *channels,
                                      const int *requested_pixel_types,
+                                     const unsigned char *requested_channels,
                                      int data_width, int data_height) {
   unsigned char **images =
       reinterpret_cast<unsigned char **>(static_cast<float **>(
           malloc(sizeof(float *) * static_cast<size_t>(num_channels))));
 
   for (size_t c = 0; c < static_cast<size_t>(num_channels); c++) {
+    if (requested_channels && !requested_channels[c]) {
+      images[c] = NULL;
+      continue;
+    }
     size_t data_len =
         static_cast<size_t>(data_width) * static_cast<size_t>(data_height);
     if (channels[c].pixel_type == TINYEXR_PIXELTYPE_HALF) {
@@ -10101,11 +10170,8 @@ static int DecodeChunk(EXRImage *exr_image, const EXRHeader *exr_header,
     exr_image->tiles = static_cast<EXRTile *>(
         malloc(sizeof(EXRTile) * static_cast<size_t>(num_tiles)));
 
-    for (size_t tile_idx = 0; tile_idx < num_tiles; tile_idx++) {
-      // Allocate memory for each tile.
-      exr_image->tiles[tile_idx].images = tinyexr::AllocateImage(
-          num_channels, exr_header->channels, exr_header->requested_pixel_types,
-          data_width, data_height);
+    tinyexr::ParallelFor(static_cast<int>(num_tiles), [&](int tile_i) {
+      size_t tile_idx = static_cast<size_t>(tile_i);
 
       // 16 byte: tile coordinates
       // 4 byte : data size
@@ -10124,6 +10190,28 @@ static int DecodeChunk(EXRImage *exr_image, const EXRHeader *exr_header,
       assert(tile_coordinates[2] == 0);
       assert(tile_coordinates[3] == 0);
 
+      exr_image->tiles[tile_idx].offset_x = tile_coordinates[0];
+      exr_image->tiles[tile_idx].offset_y = tile_coordinates[1];
+      exr_image->tiles[tile_idx].level_x = tile_coordinates[2];
+      exr_image->tiles[tile_idx].level_y = tile_coordinates[3];
+
+      if (exr_header->has_requested_window &&
+          (tile_coordinates[0] * exr_header->tile_size_x > exr_header->requested_window[2] ||
+           (tile_coordinates[0] + 1) * exr_header->tile_size_x <= exr_header->requested_window[0] ||
+           tile_coordinates[1] * exr_header->tile_size_y > exr_header->requested_window[3] ||
+           (tile_coordinates[1] + 1) * exr_header->tile_size_y <= exr_header->requested_window[1])) {
+        exr_image->tiles[tile_idx].images = NULL;
+        exr_image->tiles[tile_idx].width = 0;
+        exr_image->tiles[tile_idx].height = 0;
+        return;
+      }
+
+      // Allocate memory for each tile.
+      exr_image->tiles[tile_idx].images = tinyexr::AllocateImage(
+          num_channels, exr_header->channels, exr_header->requested_pixel_types,
+          exr_header->requested_channels, exr_header->tile_size_x,
+          exr_header->tile_size_y);
+
       int data_len;
       memcpy(&data_len, data_ptr + 16,
              sizeof(int));  // 16 = sizeof(tile_coordinates)
@@ -10146,24 +10234,34 @@ static int DecodeChunk(EXRImage *exr_image, const EXRHeader *exr_header,
           exr_header->custom_attributes,
           static_cast<size_t>(exr_header->num_channels), exr_header->channels,
           channel_offset_list);
+    });
 
-      exr_image->tiles[tile_idx].offset_x = tile_coordinates[0];
-      exr_image->tiles[tile_idx].offset_y = tile_coordinates[1];
-      exr_image->tiles[tile_idx].level_x = tile_coordinates[2];
-      exr_image->tiles[tile_idx].level_y = tile_coordinates[3];
+    exr_image->num_tiles = static_cast<int>(num_tiles);
+  } else {  // scanline format
 
-      exr_image->num_tiles = static_cast<int>(num_tiles);
+    // With a requested window, `images` covers only the window: each block
+    // inside it is decoded into rows of its own, and the window's part of
+    // them is copied out.
+    int image_x0 = 0, image_y0 = 0;
+    int image_width = data_width, image_height = data_height;
+    if (exr_header->has_requested_window) {
+      image_x0 = (std::max)(exr_header->requested_window[0], 0);
+      image_y0 = (std::max)(exr_header->requested_window[1], 0);
+      image_width = (std::max)(
+          (std::min)(exr_header->requested_window[2], data_width - 1) -
+              image_x0 + 1,
+          0);
+      image_height = (std::max)(
+          (std::min)(exr_header->requested_window[3], data_height - 1) -
+              image_y0 + 1,
+          0);
     }
-  } else {  // scanline format
 
     exr_image->images = tinyexr::AllocateImage(
         num_channels, exr_header->channels, exr_header->requested_pixel_types,
-        data_width, data_height);
+        exr_header->requested_channels, image_width, image_height);
 
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-    for (int y = 0; y < static_cast<int>(num_blocks); y++) {
+    tinyexr::ParallelFor(static_cast<int>(num_blocks), [&](int y) {
       size_t y_idx = static_cast<size_t>(y);
       const unsigned char *data_ptr =
           reinterpret_cast<const unsigned char *>(head + offsets[y_idx]);
@@ -10183,6 +10281,18 @@ static int DecodeChunk(EXRImage *exr_image, const EXRHeader *exr_header,
       int num_lines = end_line_no - line_no;
       assert(num_lines > 0);
 
+      // rows of the block within the data window, which are stored bottom-up
+      // for decreasing line order
+      int first_row = line_no - exr_header->data_window[1];
+      if (exr_header->line_order != 0) {
+        first_row = data_height - (first_row + num_lines);
+      }
+      if (exr_header->has_requested_window &&
+          (first_row >= image_y0 + image_height ||
+           first_row + num_lines <= image_y0)) {
+        return;
+      }
+
       // printf("num_blocks = %lu, y = %d, lineno = %d, end_line_no = %d,
       // num_lines = %d, data_len = %d\n", num_blocks, y, line_no, end_line_no,
       // num_lines, data_len);
@@ -10193,16 +10303,60 @@ static int DecodeChunk(EXRImage *exr_image, const EXRHeader *exr_header,
       // Adjust line_no with data_window.bmin.y
       line_no -= exr_header->data_window[1];
 
+      if (!exr_header->has_requested_window) {
+        tinyexr::DecodePixelData(
+            exr_image->images, exr_header->requested_pixel_types, data_ptr,
+            static_cast<size_t>(data_len), exr_header->compression_type,
+            exr_header->line_order, data_width, data_height, data_width, y,
+            line_no, num_lines, static_cast<size_t>(pixel_data_size),
+            static_cast<int>(exr_header->num_custom_attributes),
+            exr_header->custom_attributes,
+            static_cast<size_t>(exr_header->num_channels),
+            exr_header->channels, channel_offset_list);
+        return;
+      }
+
+      // row r of `block_images` is row first_row + r of the data window
+      unsigned char **block_images = tinyexr::AllocateImage(
+          num_channels, exr_header->channels,
+          exr_header->requested_pixel_types, exr_header->requested_channels,
+          data_width, num_lines);
       tinyexr::DecodePixelData(
-          exr_image->images, exr_header->requested_pixel_types, data_ptr,
+          block_images, exr_header->requested_pixel_types, data_ptr,
           static_cast<size_t>(data_len), exr_header->compression_type,
-          exr_header->line_order, data_width, data_height, data_width, y,
-          line_no, num_lines, static_cast<size_t>(pixel_data_size),
+          exr_header->line_order, data_width, num_lines, data_width, 0, 0,
+          num_lines, static_cast<size_t>(pixel_data_size),
           static_cast<int>(exr_header->num_custom_attributes),
           exr_header->custom_attributes,
           static_cast<size_t>(exr_header->num_channels), exr_header->channels,
           channel_offset_list);
-    }  // omp parallel
+
+      int row_begin = (std::max)(first_row, image_y0);
+      int row_end = (std::min)(first_row + num_lines, image_y0 + image_height);
+      for (int c = 0; c < num_channels; c++) {
+        if (block_images[c] == NULL) continue;  // not requested
+        size_t sample_size =
+            (exr_header->requested_pixel_types[c] == TINYEXR_PIXELTYPE_HALF)
+                ? sizeof(unsigned short)
+                : sizeof(float);
+        for (int row = row_begin; row < row_end; row++) {
+          memcpy(exr_image->images[c] +
+                     static_cast<size_t>(row - image_y0) *
+                         static_cast<size_t>(image_width) * sample_size,
+                 block_images[c] +
+                     (static_cast<size_t>(row - first_row) *
+                          static_cast<size_t>(data_width) +
+                      static_cast<size_t>(image_x0)) *
+                         sample_size,
+                 static_cast<size_t>(image_width) * sample_size);
+        }
+        free(block_images[c]);
+      }
+      free(block_images);
+    });
+
+    data_width = image_width;
+    data_height = image_height;
   }
 
   // Overwrite `pixel_type` with `requested_pixel_type`.
@@ -10822,12 +10976,7 @@ size_t SaveEXRImageToMemory(const EXRImage *exr_image,
   }
 #endif
 
-// Use signed int since some OpenMP compiler doesn't allow unsigned type for
-// `parallel for`
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-  for (int i = 0; i < num_blocks; i++) {
+  tinyexr::ParallelFor(num_blocks, [&](int i) {
     int start_y = num_scanlines * i;
     int endY = (std::min)(num_scanlines * (i + 1), exr_image->height);
     int h = endY - start_y;
@@ -11062,7 +11211,7 @@ size_t SaveEXRImageToMemory(const EXRImage *exr_image,
     } else {
       assert(0);
     }
-  }  // omp parallel
+  });
 
   for (int i = 0; i < num_blocks; i++) {
     data.insert(data.end(), data_list[i].begin(), data_list[i].end());
@@ -11812,6 +11961,7 @@ int FreeEXRImage(EXRImage *exr_image) {
         free(exr_image->tiles[tid].images);
       }
     }
+    free(exr_image->tiles);
   }
 
   return TINYEXR_SUCCESS;
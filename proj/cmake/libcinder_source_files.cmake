@@ -28,6 +28,7 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/Font.cpp
 	${CINDER_SRC_DIR}/cinder/Frustum.cpp
 	${CINDER_SRC_DIR}/cinder/GeomIo.cpp
+	${CINDER_SRC_DIR}/cinder/ImageFileCimg.cpp
 	${CINDER_SRC_DIR}/cinder/ImageFileTinyExr.cpp
 	${CINDER_SRC_DIR}/cinder/ImageIo.cpp
 	${CINDER_SRC_DIR}/cinder/ImageSourceFileRadiance.cpp
@@ -37,6 +38,7 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/Log.cpp
 	${CINDER_SRC_DIR}/cinder/Matrix.cpp
 	${CINDER_SRC_DIR}/cinder/MediaTime.cpp
+	${CINDER_SRC_DIR}/cinder/MemoryMappedFile.cpp
 	${CINDER_SRC_DIR}/cinder/ObjLoader.cpp
 	${CINDER_SRC_DIR}/cinder/Path2d.cpp
 	${CINDER_SRC_DIR}/cinder/Perlin.cpp
@@ -44,6 +46,15 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/PolyLine.cpp
 	${CINDER_SRC_DIR}/cinder/Rand.cpp
 	${CINDER_SRC_DIR}/cinder/Ray.cpp
+	${CINDER_SRC_DIR}/cinder/MeshBvh.cpp
+	${CINDER_SRC_DIR}/cinder/MeshSimplify.cpp
+	${CINDER_SRC_DIR}/cinder/MeshOptimize.cpp
+	${CINDER_SRC_DIR}/cinder/MeshNormals.cpp
+	${CINDER_SRC_DIR}/cinder/Isosurface.cpp
+	${CINDER_SRC_DIR}/cinder/SourceCache.cpp
+	${CINDER_SRC_DIR}/cinder/Stroke.cpp
+	${CINDER_SRC_DIR}/cinder/PointIndex.cpp
+	${CINDER_SRC_DIR}/cinder/SpatialHashGrid.cpp
 	${CINDER_SRC_DIR}/cinder/Rect.cpp
 	${CINDER_SRC_DIR}/cinder/Shape2d.cpp
 	${CINDER_SRC_DIR}/cinder/Signals.cpp
@@ -52,6 +63,7 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/Surface.cpp
 	${CINDER_SRC_DIR}/cinder/System.cpp
 	${CINDER_SRC_DIR}/cinder/Text.cpp
+	${CINDER_SRC_DIR}/cinder/Thread.cpp
 	${CINDER_SRC_DIR}/cinder/Timeline.cpp
 	${CINDER_SRC_DIR}/cinder/TimelineItem.cpp
 	${CINDER_SRC_DIR}/cinder/Timer.cpp
@@ -206,6 +218,7 @@ source_group( "cinder\\ip" FILES    ${SRC_SET_CINDER_IP} )
 
 list( APPEND SRC_SET_CINDER_SVG
 	${CINDER_SRC_DIR}/cinder/svg/Svg.cpp
+	${CINDER_SRC_DIR}/cinder/svg/SvgGl.cpp
 )
 
 list( APPEND CINDER_SRC_FILES       ${SRC_SET_CINDER_SVG} )
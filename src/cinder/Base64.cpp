@@ -25,6 +25,23 @@
 
 #include "cinder/Base64.h"
 
+#include <algorithm>
+#include <vector>
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+	#define CINDER_BASE64_X86
+	#include <immintrin.h>
+	#if defined( _MSC_VER )
+		#include <intrin.h>
+		#define CINDER_BASE64_TARGET( isa )
+	#else
+		#define CINDER_BASE64_TARGET( isa ) __attribute__(( target( isa ) ))
+	#endif
+#elif defined( __aarch64__ ) || defined( _M_ARM64 )
+	#define CINDER_BASE64_NEON
+	#include <arm_neon.h>
+#endif
+
 namespace {
 
 typedef enum { step_a, step_b, step_c, step_d } base64_decodestep;
@@ -38,7 +55,7 @@ int base64_decode_value( char value_in ) {
 	static const char decoding[] = {62,static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),63,52,53,54,55,56,57,58,59,60,61,static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-2),static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),static_cast<char>(-1),26,27,28,29,30,31,32,33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,48,49,50,51};
 	static const char decoding_size = sizeof(decoding);
 	value_in -= 43;
-	if (value_in < 0 || value_in > decoding_size) return -1;
+	if (value_in < 0 || value_in >= decoding_size) return -1;
 	return decoding[(int)value_in];
 }
 
@@ -218,6 +235,352 @@ ptrdiff_t base64_encode_blockend( char* code_out, base64_encodestate* state_in )
 	return codechar - code_out;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// vectorized paths
+// The vector loops only ever run while the libb64 state machines sit on a quantum boundary (step_a / step_A).
+// Anything they can't handle - padding, whitespace, line breaks or garbage in the input, a line break due in
+// the output - is left to the scalar code above, which steps over it and hands back once realigned.
+
+enum class SimdLevel { NONE, SSSE3, AVX2, NEON };
+
+SimdLevel detectSimdLevel()
+{
+#if defined( CINDER_BASE64_X86 )
+	bool ssse3, avx2 = false;
+  #if defined( _MSC_VER )
+	int info[4];
+	__cpuid( info, 0 );
+	const int maxLeaf = info[0];
+	__cpuid( info, 1 );
+	ssse3 = ( info[2] & ( 1 << 9 ) ) != 0;
+	const bool osAvx = ( info[2] & ( 1 << 27 ) ) && ( info[2] & ( 1 << 28 ) ) && ( ( _xgetbv( 0 ) & 6 ) == 6 );
+	if( maxLeaf >= 7 && osAvx ) {
+		__cpuidex( info, 7, 0 );
+		avx2 = ( info[1] & ( 1 << 5 ) ) != 0;
+	}
+  #else
+	__builtin_cpu_init();
+	ssse3 = __builtin_cpu_supports( "ssse3" ) != 0;
+	avx2 = __builtin_cpu_supports( "avx2" ) != 0;
+  #endif
+	if( avx2 )
+		return SimdLevel::AVX2;
+	else if( ssse3 )
+		return SimdLevel::SSSE3;
+	return SimdLevel::NONE;
+#elif defined( CINDER_BASE64_NEON )
+	return SimdLevel::NEON;
+#else
+	return SimdLevel::NONE;
+#endif
+}
+
+SimdLevel getSimdLevel()
+{
+	static const SimdLevel sLevel = detectSimdLevel();
+	return sLevel;
+}
+
+// Bytes past the decoded output that a vector store may touch
+const size_t DECODE_SLACK = 16;
+
+#if defined( CINDER_BASE64_X86 )
+// Vector formulations follow Wojciech Mula's and Alfred Klomp's SSSE3/AVX2 base64 codecs (BSD licensed)
+
+CINDER_BASE64_TARGET( "ssse3" )
+inline __m128i encReshuffle( __m128i in )
+{
+	in = _mm_shuffle_epi8( in, _mm_set_epi8( 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1 ) );
+	const __m128i t0 = _mm_and_si128( in, _mm_set1_epi32( 0x0FC0FC00 ) );
+	const __m128i t1 = _mm_mulhi_epu16( t0, _mm_set1_epi32( 0x04000040 ) );
+	const __m128i t2 = _mm_and_si128( in, _mm_set1_epi32( 0x003F03F0 ) );
+	const __m128i t3 = _mm_mullo_epi16( t2, _mm_set1_epi32( 0x01000010 ) );
+	return _mm_or_si128( t1, t3 );
+}
+
+CINDER_BASE64_TARGET( "ssse3" )
+inline __m128i encTranslate( __m128i in )
+{
+	const __m128i lut = _mm_setr_epi8( 65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0 );
+	__m128i indices = _mm_subs_epu8( in, _mm_set1_epi8( 51 ) );
+	indices = _mm_sub_epi8( indices, _mm_cmpgt_epi8( in, _mm_set1_epi8( 25 ) ) );
+	return _mm_add_epi8( in, _mm_shuffle_epi8( lut, indices ) );
+}
+
+// Encodes \a numBlocks blocks of 12 bytes into 16 characters each; reads 4 bytes past each block
+CINDER_BASE64_TARGET( "ssse3" )
+void encodeSsse3( const uint8_t *in, size_t numBlocks, char *out )
+{
+	for( size_t b = 0; b < numBlocks; ++b, in += 12, out += 16 ) {
+		__m128i str = _mm_loadu_si128( reinterpret_cast<const __m128i*>( in ) );
+		str = encTranslate( encReshuffle( str ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( out ), str );
+	}
+}
+
+CINDER_BASE64_TARGET( "avx2" )
+inline __m256i broadcast128( __m128i v )
+{
+	return _mm256_inserti128_si256( _mm256_castsi128_si256( v ), v, 1 );
+}
+
+// Encodes \a numBlocks blocks of 24 bytes into 32 characters each; reads 4 bytes past each block
+CINDER_BASE64_TARGET( "avx2" )
+void encodeAvx2( const uint8_t *in, size_t numBlocks, char *out )
+{
+	const __m256i shuffle = broadcast128( _mm_set_epi8( 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1 ) );
+	const __m256i lut = broadcast128( _mm_setr_epi8( 65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0 ) );
+	for( size_t b = 0; b < numBlocks; ++b, in += 24, out += 32 ) {
+		__m256i str = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( reinterpret_cast<const __m128i*>( in ) ) ),
+												_mm_loadu_si128( reinterpret_cast<const __m128i*>( in + 12 ) ), 1 );
+		str = _mm256_shuffle_epi8( str, shuffle );
+		const __m256i t0 = _mm256_and_si256( str, _mm256_set1_epi32( 0x0FC0FC00 ) );
+		const __m256i t1 = _mm256_mulhi_epu16( t0, _mm256_set1_epi32( 0x04000040 ) );
+		const __m256i t2 = _mm256_and_si256( str, _mm256_set1_epi32( 0x003F03F0 ) );
+		const __m256i t3 = _mm256_mullo_epi16( t2, _mm256_set1_epi32( 0x01000010 ) );
+		str = _mm256_or_si256( t1, t3 );
+		__m256i indices = _mm256_subs_epu8( str, _mm256_set1_epi8( 51 ) );
+		indices = _mm256_sub_epi8( indices, _mm256_cmpgt_epi8( str, _mm256_set1_epi8( 25 ) ) );
+		str = _mm256_add_epi8( str, _mm256_shuffle_epi8( lut, indices ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>( out ), str );
+	}
+}
+
+// Decodes 16-character blocks until one contains a non-alphabet character. Returns the number of characters consumed; writes 12 bytes per block plus 4 bytes of slack
+CINDER_BASE64_TARGET( "ssse3" )
+size_t decodeSsse3( const char *in, size_t inSize, char *out )
+{
+	const __m128i lutLo = _mm_setr_epi8( 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A );
+	const __m128i lutHi = _mm_setr_epi8( 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 );
+	const __m128i lutRoll = _mm_setr_epi8( 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 );
+	const __m128i mask2F = _mm_set1_epi8( 0x2F );
+
+	size_t consumed = 0;
+	for( ; consumed + 16 <= inSize; consumed += 16, out += 12 ) {
+		__m128i str = _mm_loadu_si128( reinterpret_cast<const __m128i*>( in + consumed ) );
+		const __m128i hiNibbles = _mm_and_si128( _mm_srli_epi32( str, 4 ), mask2F );
+		const __m128i loNibbles = _mm_and_si128( str, mask2F );
+		const __m128i hi = _mm_shuffle_epi8( lutHi, hiNibbles );
+		const __m128i lo = _mm_shuffle_epi8( lutLo, loNibbles );
+		if( _mm_movemask_epi8( _mm_cmpgt_epi8( _mm_and_si128( lo, hi ), _mm_setzero_si128() ) ) != 0 )
+			break;
+		const __m128i eq2F = _mm_cmpeq_epi8( str, mask2F );
+		str = _mm_add_epi8( str, _mm_shuffle_epi8( lutRoll, _mm_add_epi8( eq2F, hiNibbles ) ) );
+		// pack four 6-bit values per 32-bit lane into 24 bits, then gather the 3-byte groups big-endian
+		str = _mm_maddubs_epi16( str, _mm_set1_epi32( 0x01400140 ) );
+		str = _mm_madd_epi16( str, _mm_set1_epi32( 0x00011000 ) );
+		str = _mm_shuffle_epi8( str, _mm_setr_epi8( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( out ), str );
+	}
+
+	return consumed;
+}
+
+// Decodes 32-character blocks until one contains a non-alphabet character. Returns the number of characters consumed; writes 24 bytes per block plus 8 bytes of slack
+CINDER_BASE64_TARGET( "avx2" )
+size_t decodeAvx2( const char *in, size_t inSize, char *out )
+{
+	const __m256i lutLo = broadcast128( _mm_setr_epi8( 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A ) );
+	const __m256i lutHi = broadcast128( _mm_setr_epi8( 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10 ) );
+	const __m256i lutRoll = broadcast128( _mm_setr_epi8( 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 ) );
+	const __m256i pack = broadcast128( _mm_setr_epi8( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 ) );
+	const __m256i mask2F = _mm256_set1_epi8( 0x2F );
+
+	size_t consumed = 0;
+	for( ; consumed + 32 <= inSize; consumed += 32, out += 24 ) {
+		__m256i str = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( in + consumed ) );
+		const __m256i hiNibbles = _mm256_and_si256( _mm256_srli_epi32( str, 4 ), mask2F );
+		const __m256i loNibbles = _mm256_and_si256( str, mask2F );
+		const __m256i hi = _mm256_shuffle_epi8( lutHi, hiNibbles );
+		const __m256i lo = _mm256_shuffle_epi8( lutLo, loNibbles );
+		if( ! _mm256_testz_si256( lo, hi ) )
+			break;
+		const __m256i eq2F = _mm256_cmpeq_epi8( str, mask2F );
+		str = _mm256_add_epi8( str, _mm256_shuffle_epi8( lutRoll, _mm256_add_epi8( eq2F, hiNibbles ) ) );
+		str = _mm256_maddubs_epi16( str, _mm256_set1_epi32( 0x01400140 ) );
+		str = _mm256_madd_epi16( str, _mm256_set1_epi32( 0x00011000 ) );
+		str = _mm256_shuffle_epi8( str, pack );
+		str = _mm256_permutevar8x32_epi32( str, _mm256_setr_epi32( 0, 1, 2, 4, 5, 6, 3, 7 ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>( out ), str );
+	}
+
+	return consumed;
+}
+
+#elif defined( CINDER_BASE64_NEON )
+
+// Encodes \a numBlocks blocks of 48 bytes into 64 characters each
+void encodeNeon( const uint8_t *in, size_t numBlocks, char *out )
+{
+	static const uint8_t sAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	uint8x16x4_t lut;
+	for( int i = 0; i < 4; ++i )
+		lut.val[i] = vld1q_u8( sAlphabet + i * 16 );
+	const uint8x16_t mask3F = vdupq_n_u8( 0x3F );
+
+	for( size_t b = 0; b < numBlocks; ++b, in += 48, out += 64 ) {
+		const uint8x16x3_t src = vld3q_u8( in );
+		uint8x16x4_t dst;
+		dst.val[0] = vshrq_n_u8( src.val[0], 2 );
+		dst.val[1] = vandq_u8( vorrq_u8( vshlq_n_u8( src.val[0], 4 ), vshrq_n_u8( src.val[1], 4 ) ), mask3F );
+		dst.val[2] = vandq_u8( vorrq_u8( vshlq_n_u8( src.val[1], 2 ), vshrq_n_u8( src.val[2], 6 ) ), mask3F );
+		dst.val[3] = vandq_u8( src.val[2], mask3F );
+		for( int i = 0; i < 4; ++i )
+			dst.val[i] = vqtbl4q_u8( lut, dst.val[i] );
+		vst4q_u8( reinterpret_cast<uint8_t*>( out ), dst );
+	}
+}
+
+// Maps a vector of alphabet characters to their 6-bit values, clearing lanes of \a valid that aren't in the alphabet
+inline uint8x16_t decodeNeonLane( uint8x16_t c, uint8x16_t *valid )
+{
+	const uint8x16_t upper = vcleq_u8( vsubq_u8( c, vdupq_n_u8( 'A' ) ), vdupq_n_u8( 25 ) );
+	const uint8x16_t lower = vcleq_u8( vsubq_u8( c, vdupq_n_u8( 'a' ) ), vdupq_n_u8( 25 ) );
+	const uint8x16_t digit = vcleq_u8( vsubq_u8( c, vdupq_n_u8( '0' ) ), vdupq_n_u8( 9 ) );
+	const uint8x16_t plus = vceqq_u8( c, vdupq_n_u8( '+' ) );
+	const uint8x16_t slash = vceqq_u8( c, vdupq_n_u8( '/' ) );
+
+	uint8x16_t result = vandq_u8( upper, vsubq_u8( c, vdupq_n_u8( 'A' ) ) );
+	result = vorrq_u8( result, vandq_u8( lower, vsubq_u8( c, vdupq_n_u8( 'a' - 26 ) ) ) );
+	result = vorrq_u8( result, vandq_u8( digit, vaddq_u8( c, vdupq_n_u8( 52 - '0' ) ) ) );
+	result = vorrq_u8( result, vandq_u8( plus, vdupq_n_u8( 62 ) ) );
+	result = vorrq_u8( result, vandq_u8( slash, vdupq_n_u8( 63 ) ) );
+	*valid = vandq_u8( *valid, vorrq_u8( vorrq_u8( upper, lower ), vorrq_u8( digit, vorrq_u8( plus, slash ) ) ) );
+	return result;
+}
+
+// Decodes 64-character blocks until one contains a non-alphabet character. Returns the number of characters consumed; writes 48 bytes per block
+size_t decodeNeon( const char *in, size_t inSize, char *out )
+{
+	size_t consumed = 0;
+	for( ; consumed + 64 <= inSize; consumed += 64, out += 48 ) {
+		const uint8x16x4_t str = vld4q_u8( reinterpret_cast<const uint8_t*>( in + consumed ) );
+		uint8x16_t valid = vdupq_n_u8( 0xFF );
+		uint8x16_t v[4];
+		for( int i = 0; i < 4; ++i )
+			v[i] = decodeNeonLane( str.val[i], &valid );
+		if( vminvq_u8( valid ) != 0xFF )
+			break;
+		uint8x16x3_t dst;
+		dst.val[0] = vorrq_u8( vshlq_n_u8( v[0], 2 ), vshrq_n_u8( v[1], 4 ) );
+		dst.val[1] = vorrq_u8( vshlq_n_u8( v[1], 4 ), vshrq_n_u8( v[2], 2 ) );
+		dst.val[2] = vorrq_u8( vshlq_n_u8( v[2], 6 ), v[3] );
+		vst3q_u8( reinterpret_cast<uint8_t*>( out ), dst );
+	}
+
+	return consumed;
+}
+
+#endif
+
+// Encodes as many whole vector blocks of \a in as fit within \a maxGroups 3-byte groups; returns the number of groups consumed
+size_t encodeSimd( SimdLevel simd, const uint8_t *in, size_t inSize, size_t maxGroups, char *out )
+{
+	size_t groups = 0;
+#if defined( CINDER_BASE64_X86 )
+	// the x86 loads read 4 bytes past each block
+	if( simd == SimdLevel::AVX2 && inSize >= 28 ) {
+		size_t blocks = std::min( ( inSize - 4 ) / 24, maxGroups / 8 );
+		encodeAvx2( in, blocks, out );
+		groups += blocks * 8;
+	}
+	if( inSize >= groups * 3 + 16 ) {
+		size_t blocks = std::min( ( inSize - groups * 3 - 4 ) / 12, ( maxGroups - groups ) / 4 );
+		encodeSsse3( in + groups * 3, blocks, out + groups * 4 );
+		groups += blocks * 4;
+	}
+#elif defined( CINDER_BASE64_NEON )
+	size_t blocks = std::min( inSize / 48, maxGroups / 16 );
+	encodeNeon( in, blocks, out );
+	groups += blocks * 16;
+#endif
+	return groups;
+}
+
+// Decodes whole vector blocks of \a in until the first non-alphabet character; returns the number of characters consumed
+size_t decodeSimd( SimdLevel simd, const char *in, size_t inSize, char *out )
+{
+	size_t consumed = 0;
+#if defined( CINDER_BASE64_X86 )
+	if( simd == SimdLevel::AVX2 )
+		consumed = decodeAvx2( in, inSize, out );
+	consumed += decodeSsse3( in + consumed, inSize - consumed, out + consumed / 4 * 3 );
+#elif defined( CINDER_BASE64_NEON )
+	consumed = decodeNeon( in, inSize, out );
+#endif
+	return consumed;
+}
+
+// Resumable encoder: the vector path whenever the stream is on a group boundary with no line break due, libb64 otherwise
+ptrdiff_t encodeChunk( const uint8_t *in, size_t inSize, char *out, base64_encodestate *state, int charsPerLine )
+{
+	const SimdLevel simd = getSimdLevel();
+	if( simd == SimdLevel::NONE )
+		return base64_encode_block( reinterpret_cast<const char*>( in ), inSize, out, state, charsPerLine );
+
+	const size_t groupsPerLine = charsPerLine / 4;
+	char *outStart = out;
+	size_t pos = 0;
+	while( pos < inSize ) {
+		size_t n;
+		if( state->step != step_A ) {
+			n = std::min<size_t>( inSize - pos, ( state->step == step_B ) ? 2 : 1 );
+		}
+		else {
+			const size_t groupsLeft = groupsPerLine ? ( groupsPerLine - state->stepcount ) : inSize;
+			size_t groups = encodeSimd( simd, in + pos, inSize - pos, groupsLeft, out );
+			if( groups ) {
+				pos += groups * 3;
+				out += groups * 4;
+				if( groupsPerLine ) {
+					state->stepcount += (int)groups;
+					if( state->stepcount == (int)groupsPerLine ) {
+						*out++ = '\n';
+						state->stepcount = 0;
+					}
+				}
+				continue;
+			}
+			// too short for a vector block, or a line break falls within one
+			n = std::min( inSize - pos, groupsLeft * 3 );
+		}
+		out += base64_encode_block( reinterpret_cast<const char*>( in + pos ), n, out, state, charsPerLine );
+		pos += n;
+	}
+
+	return out - outStart;
+}
+
+// Resumable decoder: the vector path whenever the stream is on a quantum boundary, libb64 otherwise. \a out requires DECODE_SLACK bytes of room beyond the decoded data
+ptrdiff_t decodeChunk( const char *in, size_t inSize, char *out, base64_decodestate *state )
+{
+	const SimdLevel simd = getSimdLevel();
+	if( simd == SimdLevel::NONE )
+		return base64_decode_block( in, inSize, out, state );
+
+	char *outStart = out;
+	size_t pos = 0;
+	while( pos < inSize ) {
+		if( state->step == step_a ) {
+			size_t consumed = decodeSimd( simd, in + pos, inSize - pos, out );
+			pos += consumed;
+			out += consumed / 4 * 3;
+			if( pos == inSize )
+				break;
+		}
+		// let libb64 step over the offending block, then feed it single characters until it's back on a quantum boundary
+		size_t n = std::min<size_t>( inSize - pos, 16 );
+		out += base64_decode_block( in + pos, n, out, state );
+		pos += n;
+		while( state->step != step_a && pos < inSize ) {
+			out += base64_decode_block( in + pos, 1, out, state );
+			++pos;
+		}
+	}
+
+	return out - outStart;
+}
+
 } // anonymous namespace
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -240,19 +603,41 @@ std::string toBase64( const void *input, size_t inputSize, int charsPerLine )
 	if( charsPerLine != 0 )
 		charsPerLine -= charsPerLine % 4;
 	size_t lines = ( charsPerLine == 0 ) ? 0 : ( inputSize * 4 / 3 / charsPerLine + 1 ); // account for inserted carriage returns
-	char *buffer = new char[inputSize * 4 / 3 + 4 + lines];
+	std::string result( inputSize * 4 / 3 + 4 + lines, 0 );
 
 	base64_encodestate encs;
 	base64_init_encodestate( &encs );
-	ptrdiff_t resultSize = base64_encode_block( reinterpret_cast<const char*>(input), inputSize, &buffer[0], &encs, charsPerLine );
-	resultSize += base64_encode_blockend( &buffer[resultSize], &encs );
-	buffer[resultSize] = 0; // null terminate the string
-	
-	std::string result( buffer );
-	delete [] buffer;
+	ptrdiff_t resultSize = encodeChunk( reinterpret_cast<const uint8_t*>( input ), inputSize, &result[0], &encs, charsPerLine );
+	resultSize += base64_encode_blockend( &result[resultSize], &encs );
+	result.resize( resultSize );
 	return result;
 }
 
+void toBase64( const IStreamRef &input, const OStreamRef &output, int charsPerLine )
+{
+	if( charsPerLine != 0 )
+		charsPerLine -= charsPerLine % 4;
+
+	const size_t chunkSize = 48 * 1024; // a multiple of 3 keeps the encoder on a group boundary between full chunks
+	const size_t maxEncodedSize = chunkSize * 4 / 3 + 4;
+	std::vector<uint8_t> inChunk( chunkSize );
+	std::vector<char> outChunk( maxEncodedSize + ( ( charsPerLine == 0 ) ? 0 : ( maxEncodedSize / charsPerLine + 1 ) ) );
+
+	base64_encodestate encs;
+	base64_init_encodestate( &encs );
+	while( ! input->isEof() ) {
+		size_t bytesRead = input->readDataAvailable( inChunk.data(), chunkSize );
+		if( bytesRead == 0 )
+			break;
+		ptrdiff_t encodedSize = encodeChunk( inChunk.data(), bytesRead, outChunk.data(), &encs, charsPerLine );
+		output->writeData( outChunk.data(), encodedSize );
+	}
+
+	ptrdiff_t tailSize = base64_encode_blockend( outChunk.data(), &encs );
+	if( tailSize > 0 )
+		output->writeData( outChunk.data(), tailSize );
+}
+
 Buffer fromBase64( const std::string &input )
 {
 	return fromBase64( input.c_str(), input.size() );
@@ -266,15 +651,32 @@ Buffer fromBase64( const Buffer &input )
 Buffer fromBase64( const void *input, size_t inputSize )
 {
 	size_t outputSize = inputSize / 4 * 3;
-	Buffer result( outputSize );
+	Buffer result( outputSize + 3 + DECODE_SLACK );
+	result.setSize( outputSize );
 	if( inputSize >= 4 ) {
 		base64_decodestate decs;
 		base64_init_decodestate( &decs );
-		ptrdiff_t actualSize = base64_decode_block( reinterpret_cast<const char*>(input), inputSize, (char*)result.getData(), &decs );
+		ptrdiff_t actualSize = decodeChunk( reinterpret_cast<const char*>(input), inputSize, (char*)result.getData(), &decs );
 		result.setSize( actualSize );
 	}
 	return result;
 }
 
+void fromBase64( const IStreamRef &input, const OStreamRef &output )
+{
+	const size_t chunkSize = 64 * 1024;
+	std::vector<char> inChunk( chunkSize );
+	std::vector<char> outChunk( chunkSize / 4 * 3 + 3 + DECODE_SLACK );
+
+	base64_decodestate decs;
+	base64_init_decodestate( &decs );
+	while( ! input->isEof() ) {
+		size_t bytesRead = input->readDataAvailable( inChunk.data(), chunkSize );
+		if( bytesRead == 0 )
+			break;
+		ptrdiff_t decodedSize = decodeChunk( inChunk.data(), bytesRead, outChunk.data(), &decs );
+		output->writeData( outChunk.data(), decodedSize );
+	}
+}
 
 } // namespace cinder
@@ -24,6 +24,7 @@
 #include "cinder/Buffer.h"
 #include "cinder/DataSource.h"
 #include "cinder/DataTarget.h"
+#include "cinder/Stream.h"
 #include <zlib.h>
 #include <cmath>
 #include <iostream>
@@ -130,130 +131,221 @@ void Buffer::write( const DataTargetRef &dataTarget )
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // StreamingBuffer
 
-StreamingBuffer::StreamingBuffer( size_t blockSizeBytes )
-	: mBlockSize( std::max<size_t>( blockSizeBytes, 1 ) )
+StreamingBuffer::StreamingBuffer( size_t blockSizeBytes, size_t numPreallocatedBlocks )
+	: mBlockSize( std::max<size_t>( blockSizeBytes, 1 ) ), mWriteOffset( 0 ), mTotalWritten( 0 ), mProducerFreeBlocks( nullptr ), mReadOffset( 0 ), mTotalRead( 0 ), mClearedTo( 0 ), mFreeBlocks( nullptr ), mShrinkRequested( false )
 {
-	allocateNewWriteBlock();
-	mReadOffset = 0;
+	mWriteBlock = mReadBlock = new Block( mBlockSize );
+	for( size_t i = 1; i < numPreallocatedBlocks; ++i )
+		releaseBlock( new Block( mBlockSize ) );
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+	deleteBlocks( mFreeBlocks.load( std::memory_order_acquire ) );
+	deleteBlocks( mProducerFreeBlocks );
+	deleteBlocks( mReadBlock );
 }
 
 void StreamingBuffer::pushFront( const void *data, size_t dataSize )
 {
-	std::lock_guard<std::mutex> lock( mMutex );
 	size_t offset = 0;
 
 	while( offset < dataSize ) {
-		size_t copyCount = std::min( dataSize - offset, mBlockSize - mWriteOffset );
-		memcpy( &mBlocks.back()[mWriteOffset], &reinterpret_cast<const uint8_t*>(data)[offset], copyCount );
+		size_t copyCount;
+		void *dest = acquireWrite( dataSize - offset, &copyCount );
+		memcpy( dest, &reinterpret_cast<const uint8_t*>(data)[offset], copyCount );
 		offset += copyCount;
 		mWriteOffset += copyCount;
-		if( mWriteOffset == mBlockSize )
-			allocateNewWriteBlock();
 	}
+
+	// a single publish for the whole push
+	mTotalWritten.store( mTotalWritten.load( std::memory_order_relaxed ) + dataSize, std::memory_order_release );
 }
 
 size_t StreamingBuffer::popBack( void *output, size_t maxSize )
 {
-	std::lock_guard<std::mutex> lock( mMutex );
 	size_t offset = 0;
 
-	maxSize = std::min( maxSize, calcSize() );
-
-	while( offset < maxSize && ( ! mBlocks.empty() ) ) {
-		// for the last block, we can only read up to `mWriteOffset`; for other blocks we can read up to 'mBlockSize'
-		size_t copyCount = std::min( maxSize - offset, ( ( mBlocks.size() == 1 ) ? mWriteOffset : mBlockSize ) - mReadOffset );
-		memcpy( &reinterpret_cast<uint8_t*>(output)[offset], &mBlocks.front()[mReadOffset], copyCount );
+	while( offset < maxSize ) {
+		size_t available;
+		const void *src = peekRead( &available );
+		if( available == 0 )
+			break;
+		size_t copyCount = std::min( maxSize - offset, available );
+		memcpy( &reinterpret_cast<uint8_t*>(output)[offset], src, copyCount );
+		consume( copyCount );
 		offset += copyCount;
-		mReadOffset += copyCount;
-		if( mReadOffset == mBlockSize )
-			releaseCurrentReadBlock();
 	}
 
 	return offset;
 }
 
+void* StreamingBuffer::acquireWrite( size_t maxSize, size_t *size )
+{
+	// the next block is linked before any of its bytes are published, so the consumer can always follow the chain
+	if( mWriteOffset == mBlockSize && maxSize > 0 ) {
+		Block *block = acquireFreeBlock();
+		mWriteBlock->mNext.store( block, std::memory_order_release );
+		mWriteBlock = block;
+		mWriteOffset = 0;
+	}
+
+	*size = std::min( maxSize, mBlockSize - mWriteOffset );
+	return &mWriteBlock->mData[mWriteOffset];
+}
+
+void StreamingBuffer::commitWrite( size_t sizeBytes )
+{
+	mWriteOffset += sizeBytes;
+	mTotalWritten.store( mTotalWritten.load( std::memory_order_relaxed ) + sizeBytes, std::memory_order_release );
+}
+
+const void* StreamingBuffer::peekRead( size_t *size )
+{
+	applyClear();
+	const uint64_t totalRead = mTotalRead.load( std::memory_order_relaxed );
+	const size_t available = (size_t)( mTotalWritten.load( std::memory_order_acquire ) - totalRead );
+	if( available > 0 && mReadOffset == mBlockSize )
+		advanceReadBlock();
+
+	*size = std::min( available, mBlockSize - mReadOffset );
+	return &mReadBlock->mData[mReadOffset];
+}
+
+void StreamingBuffer::consume( size_t sizeBytes )
+{
+	// consumes the data returned by peekRead() first, so that a clear() since then can't discard newer data
+	advanceRead( sizeBytes );
+	applyClear();
+}
+
 size_t StreamingBuffer::getSize() const
 {
-	std::lock_guard<std::mutex> lock( mMutex );
-	return calcSize();
+	// read first, so that a concurrent consume() or clear() can't make the result negative
+	const uint64_t start = std::max( mTotalRead.load( std::memory_order_acquire ), mClearedTo.load( std::memory_order_acquire ) );
+	return (size_t)( mTotalWritten.load( std::memory_order_acquire ) - start );
 }
 
 void StreamingBuffer::clear()
 {
-	std::lock_guard<std::mutex> lock( mMutex );
-	while( mBlocks.size() > 1 )
-		releaseCurrentReadBlock();
-	mReadOffset = mWriteOffset = 0;
+	// only the consumer may move the read position, so clear() records how far to discard and leaves the rest to the consumer
+	const uint64_t totalWritten = mTotalWritten.load( std::memory_order_acquire );
+	uint64_t clearedTo = mClearedTo.load( std::memory_order_relaxed );
+	while( clearedTo < totalWritten && ! mClearedTo.compare_exchange_weak( clearedTo, totalWritten, std::memory_order_release, std::memory_order_relaxed ) )
+		;
 }
 
 void StreamingBuffer::shrinkToFit()
 {
-	std::lock_guard<std::mutex> lock( mMutex );
-	mUnusedBlocks.clear();
+	deleteBlocks( mFreeBlocks.exchange( nullptr, std::memory_order_acquire ) );
+	mShrinkRequested.store( true, std::memory_order_relaxed );
 }
 
 size_t StreamingBuffer::copyTo( void *output, size_t maxSize ) const
 {
-	std::lock_guard<std::mutex> lock( mMutex );
-	size_t offset = 0, copyCount;
-
-	// the first buffer we copy from read offset, up to either 'mBlockSize' or in the case of a single block, 'mWriteOffset'
-	size_t firstBlockSize = ( mBlocks.size() == 1 ) ? mWriteOffset : mBlockSize;
-	copyCount = std::min( maxSize, firstBlockSize - mReadOffset );
-	memcpy( &reinterpret_cast<uint8_t*>(output)[0], &mBlocks.front()[mReadOffset], copyCount );
-	offset += copyCount;
-	if( maxSize == offset || mBlocks.size() == 1 )
-		return offset;
-
-	// all but the first and last buffer we can copy in its entirety
-	for( size_t block = 1; block < mBlocks.size() - 1; ++block ) {
-		copyCount = std::min( maxSize - offset, mBlockSize );
-		memcpy( &reinterpret_cast<uint8_t*>(output)[offset], &mBlocks[block][0], copyCount );
-		offset += copyCount;
-		if( maxSize == offset )
-			return offset;
+	const uint64_t totalRead = mTotalRead.load( std::memory_order_relaxed );
+	const uint64_t clearedTo = mClearedTo.load( std::memory_order_acquire );
+	size_t skip = clearedTo > totalRead ? (size_t)( clearedTo - totalRead ) : 0;
+	maxSize = std::min<size_t>( maxSize, (size_t)( mTotalWritten.load( std::memory_order_acquire ) - totalRead ) - skip );
+	size_t offset = 0;
+	const Block *block = mReadBlock;
+	size_t blockOffset = mReadOffset;
+
+	// data a clear() discarded is still in place until the consumer releases it
+	while( skip > 0 ) {
+		if( blockOffset == mBlockSize ) {
+			block = block->mNext.load( std::memory_order_acquire );
+			blockOffset = 0;
+		}
+		size_t count = std::min( skip, mBlockSize - blockOffset );
+		blockOffset += count;
+		skip -= count;
 	}
 
-	// last block we should read up to 'writeOffset'
-	copyCount = std::min( maxSize - offset, mWriteOffset );
-	memcpy( &reinterpret_cast<uint8_t*>(output)[offset], &mBlocks.back()[0], copyCount );
-	offset += copyCount;
+	while( offset < maxSize ) {
+		if( blockOffset == mBlockSize ) {
+			block = block->mNext.load( std::memory_order_acquire );
+			blockOffset = 0;
+		}
+		size_t copyCount = std::min( maxSize - offset, mBlockSize - blockOffset );
+		memcpy( &reinterpret_cast<uint8_t*>(output)[offset], &block->mData[blockOffset], copyCount );
+		offset += copyCount;
+		blockOffset += copyCount;
+	}
 
 	return offset;
 }
 
-// implicitly thread-safe; only called by thread-safe methods
-void StreamingBuffer::allocateNewWriteBlock()
+// consumer only
+void StreamingBuffer::advanceRead( size_t sizeBytes )
 {
-	if( ! mUnusedBlocks.empty() ) {
-		mBlocks.push_back( std::move( mUnusedBlocks.back() ) );
-		mUnusedBlocks.pop_back();
+	while( sizeBytes > 0 ) {
+		if( mReadOffset == mBlockSize )
+			advanceReadBlock();
+		size_t count = std::min( sizeBytes, mBlockSize - mReadOffset );
+		mReadOffset += count;
+		sizeBytes -= count;
+		mTotalRead.store( mTotalRead.load( std::memory_order_relaxed ) + count, std::memory_order_release );
 	}
-	else
-		mBlocks.emplace_back( new uint8_t[mBlockSize] );
-	mWriteOffset = 0;
 }
 
-// implicitly thread-safe; only called by thread-safe methods
-void StreamingBuffer::releaseCurrentReadBlock()
+// consumer only; drops the data a clear() discarded
+void StreamingBuffer::applyClear()
 {
-	mUnusedBlocks.push_back( std::move( mBlocks.front() ) );
-	mBlocks.pop_front();
-	mReadOffset = 0;
+	const uint64_t clearedTo = mClearedTo.load( std::memory_order_acquire );
+	const uint64_t totalRead = mTotalRead.load( std::memory_order_relaxed );
+	if( clearedTo > totalRead )
+		advanceRead( (size_t)( clearedTo - totalRead ) );
 }
 
-// implicitly thread-safe; only called by thread-safe methods
-size_t StreamingBuffer::calcSize() const
+// producer only; falls back to allocating when no recycled block is available
+StreamingBuffer::Block* StreamingBuffer::acquireFreeBlock()
 {
-	if( mBlocks.size() == 1 )
-		return mWriteOffset - mReadOffset;
-	else {
-		size_t frontBlockSize = mBlockSize - mReadOffset;
-		size_t backBlockSize = mWriteOffset;
-		return ( mBlocks.size() - 2 ) * mBlockSize + frontBlockSize + backBlockSize;
+	if( mShrinkRequested.load( std::memory_order_relaxed ) && mShrinkRequested.exchange( false, std::memory_order_relaxed ) ) {
+		deleteBlocks( mProducerFreeBlocks );
+		mProducerFreeBlocks = nullptr;
+	}
+
+	// taking the whole list leaves nothing to pop concurrently, so there is no ABA problem and nothing for shrinkToFit() to delete underneath
+	if( ! mProducerFreeBlocks )
+		mProducerFreeBlocks = mFreeBlocks.exchange( nullptr, std::memory_order_acquire );
+
+	Block *block = mProducerFreeBlocks;
+	if( ! block )
+		return new Block( mBlockSize );
+
+	mProducerFreeBlocks = block->mNext.load( std::memory_order_relaxed );
+	block->mNext.store( nullptr, std::memory_order_relaxed );
+	return block;
+}
+
+// consumer only; pushing never reads the head block, so it is safe alongside the producer and shrinkToFit() taking the list
+void StreamingBuffer::releaseBlock( Block *block )
+{
+	Block *head = mFreeBlocks.load( std::memory_order_relaxed );
+	do {
+		block->mNext.store( head, std::memory_order_relaxed );
+	} while( ! mFreeBlocks.compare_exchange_weak( head, block, std::memory_order_release, std::memory_order_relaxed ) );
+}
+
+void StreamingBuffer::deleteBlocks( Block *list )
+{
+	while( list ) {
+		Block *next = list->mNext.load( std::memory_order_relaxed );
+		delete list;
+		list = next;
 	}
 }
 
+// consumer only; only called once data beyond the current read block has been published, so mNext is set
+void StreamingBuffer::advanceReadBlock()
+{
+	Block *block = mReadBlock;
+	mReadBlock = block->mNext.load( std::memory_order_acquire );
+	mReadOffset = 0;
+	releaseBlock( block );
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Compression
 Buffer compressBuffer( const Buffer &buffer, int8_t compressionLevel, bool resizeResult )
@@ -275,6 +367,48 @@ Buffer compressBuffer( const Buffer &buffer, int8_t compressionLevel, bool resiz
 	return outBuffer;
 }
 
+namespace {
+
+// Appends everything written to it to a Buffer, growing geometrically
+class OStreamBuffer : public OStream {
+  public:
+	OStreamBuffer( Buffer *buffer ) : mBuffer( buffer ) {}
+
+	off_t	tell() const override						{ return static_cast<off_t>( mBuffer->getSize() ); }
+	void	seekAbsolute( off_t /*absoluteOffset*/ ) override	{ throw StreamExc(); }
+	void	seekRelative( off_t /*relativeOffset*/ ) override	{ throw StreamExc(); }
+
+  protected:
+	void	IOWrite( const void *t, size_t size ) override
+	{
+		const size_t offset = mBuffer->getSize();
+		if( offset + size > mBuffer->getAllocatedSize() )
+			mBuffer->resize( std::max( mBuffer->getAllocatedSize() * 2, offset + size ) );
+		memcpy( reinterpret_cast<uint8_t*>( mBuffer->getData() ) + offset, t, size );
+		mBuffer->setSize( offset + size );
+	}
+
+	Buffer	*mBuffer;
+};
+
+} // anonymous namespace
+
+Buffer compressBufferChunked( const Buffer &buffer, int8_t compressionLevel, bool useGZip, size_t blockSize )
+{
+	Buffer outBuffer( buffer.getSize() / 2 + 64 );
+	outBuffer.setSize( 0 );
+
+	auto stream = std::make_shared<OStreamBuffer>( &outBuffer );
+	{
+		auto compressor = CompressingOStream::create( stream, compressionLevel, useGZip, blockSize );
+		compressor->writeData( buffer.getData(), buffer.getSize() );
+		compressor->finish();
+	}
+
+	outBuffer.resize( outBuffer.getSize() );
+	return outBuffer;
+}
+
 Buffer decompressBuffer( const Buffer &buffer, bool resizeResult, bool useGZip )
 {
 	int err;
@@ -611,12 +611,20 @@ union float32_t
 	};
 };
 
+// Aggregate initialization would set float32_t::f, so bit patterns are assigned through u explicitly
+static float32_t float32_from_bits( uint u )
+{
+	float32_t result;
+	result.u = u;
+	return result;
+}
+
 // Algorithm due to Fabian "ryg" Giesen.
 static half_float float_to_half( float32_t f )
 {
-    float32_t f32infty = { 255 << 23 };
-    float32_t f16infty = { 31 << 23 };
-    float32_t magic = { 15 << 23 };
+    float32_t f32infty = float32_from_bits( 255 << 23 );
+    float32_t f16infty = float32_from_bits( 31 << 23 );
+    float32_t magic = float32_from_bits( 15 << 23 );
     uint sign_mask = 0x80000000u;
     uint round_mask = ~0xfffu; 
     half_float o = { 0 };
@@ -653,7 +661,7 @@ cinder::half_float floatToHalf( float f )
 // Algorithm due to Fabian "ryg" Giesen.
 float halfToFloat( cinder::half_float h )
 {
-	static const float32_t magic = { 113 << 23 };
+	static const float32_t magic = float32_from_bits( 113 << 23 );
 	static const uint shifted_exp = 0x7c00 << 13; // exponent mask after shift
 	float32_t o;
 
@@ -24,14 +24,278 @@
 */
 
 #include "cinder/Frustum.h"
+#include "cinder/Thread.h"
+
+#include <cstring>
+#include <vector>
 
 #if defined( CINDER_MSW )
 	#undef NEAR
 	#undef FAR
 #endif
 
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+	#define CINDER_FRUSTUM_X86
+	#include <immintrin.h>
+	#if defined( _MSC_VER )
+		#include <intrin.h>
+		#define CINDER_FRUSTUM_TARGET( isa )
+	#else
+		#define CINDER_FRUSTUM_TARGET( isa ) __attribute__(( target( isa ) ))
+	#endif
+#elif defined( __aarch64__ ) || defined( _M_ARM64 )
+	#define CINDER_FRUSTUM_NEON
+	#include <arm_neon.h>
+#endif
+
 namespace cinder {
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// batch culling
+// A volume is culled when it lies entirely behind one of the planes: its center's signed distance is below minus its
+// radius, or for a box, minus the projection of its extents onto the plane's normal. Each kernel tests a block of volumes
+// against every plane, starting with the plane that last culled a whole block, since neighboring volumes tend to be culled
+// by the same plane, and stops early once the whole block is culled.
+
+const size_t	NUM_PLANES = 6;
+const size_t	CULL_CHUNK_SIZE = 16 * 1024;
+
+struct CullPlanes {
+	float	mNormalX[NUM_PLANES], mNormalY[NUM_PLANES], mNormalZ[NUM_PLANES], mDistance[NUM_PLANES];
+	float	mAbsNormalX[NUM_PLANES], mAbsNormalY[NUM_PLANES], mAbsNormalZ[NUM_PLANES];
+};
+
+// Spheres store their radii in mExtentX and leave the other extents null
+struct CullVolumes {
+	const float		*mX, *mY, *mZ, *mExtentX, *mExtentY, *mExtentZ;
+};
+
+// Appends the set bits of \a visibleMask as indices from \a base. Writes unconditionally, which stays within the output since it never runs ahead of the input.
+inline size_t appendVisible( uint32_t visibleMask, uint32_t base, size_t width, uint32_t *out )
+{
+	size_t count = 0;
+	for( size_t lane = 0; lane < width; ++lane ) {
+		out[count] = base + (uint32_t)lane;
+		count += ( visibleMask >> lane ) & 1;
+	}
+	return count;
+}
+
+template<bool BOXES>
+size_t cullScalar( const CullPlanes &planes, const CullVolumes &volumes, size_t begin, size_t end, uint32_t *out )
+{
+	size_t count = 0;
+	for( size_t i = begin; i < end; ++i ) {
+		bool visible = true;
+		for( size_t p = 0; p < NUM_PLANES && visible; ++p ) {
+			const float distance = planes.mNormalX[p] * volumes.mX[i] + planes.mNormalY[p] * volumes.mY[i] + planes.mNormalZ[p] * volumes.mZ[i] - planes.mDistance[p];
+			const float radius = BOXES ? planes.mAbsNormalX[p] * volumes.mExtentX[i] + planes.mAbsNormalY[p] * volumes.mExtentY[i] + planes.mAbsNormalZ[p] * volumes.mExtentZ[i] : volumes.mExtentX[i];
+			visible = ! ( distance < -radius );
+		}
+		out[count] = (uint32_t)i;
+		count += visible ? 1 : 0;
+	}
+	return count;
+}
+
+#if defined( CINDER_FRUSTUM_X86 )
+
+enum class CullSimdLevel { SSE2, AVX };
+
+CullSimdLevel detectCullSimdLevel()
+{
+  #if defined( _MSC_VER )
+	int info[4];
+	__cpuid( info, 1 );
+	const bool avx = ( info[2] & ( 1 << 28 ) ) && ( info[2] & ( 1 << 27 ) ) && ( ( _xgetbv( 0 ) & 6 ) == 6 );
+  #else
+	__builtin_cpu_init();
+	const bool avx = __builtin_cpu_supports( "avx" ) != 0;
+  #endif
+	return avx ? CullSimdLevel::AVX : CullSimdLevel::SSE2;
+}
+
+CullSimdLevel getCullSimdLevel()
+{
+	static const CullSimdLevel sLevel = detectCullSimdLevel();
+	return sLevel;
+}
+
+template<bool BOXES>
+CINDER_FRUSTUM_TARGET( "sse2" )
+size_t cullSse( const CullPlanes &planes, const CullVolumes &volumes, size_t begin, size_t end, uint32_t *out )
+{
+	__m128 nx[NUM_PLANES], ny[NUM_PLANES], nz[NUM_PLANES], nd[NUM_PLANES], ax[NUM_PLANES], ay[NUM_PLANES], az[NUM_PLANES];
+	for( size_t p = 0; p < NUM_PLANES; ++p ) {
+		nx[p] = _mm_set1_ps( planes.mNormalX[p] ); ny[p] = _mm_set1_ps( planes.mNormalY[p] ); nz[p] = _mm_set1_ps( planes.mNormalZ[p] );
+		nd[p] = _mm_set1_ps( planes.mDistance[p] );
+		ax[p] = _mm_set1_ps( planes.mAbsNormalX[p] ); ay[p] = _mm_set1_ps( planes.mAbsNormalY[p] ); az[p] = _mm_set1_ps( planes.mAbsNormalZ[p] );
+	}
+
+	const __m128 signMask = _mm_set1_ps( -0.0f );
+	size_t count = 0, firstPlane = 0;
+	for( size_t i = begin; i < end; i += 4 ) {
+		const __m128 x = _mm_loadu_ps( volumes.mX + i ), y = _mm_loadu_ps( volumes.mY + i ), z = _mm_loadu_ps( volumes.mZ + i );
+		const __m128 ex = _mm_loadu_ps( volumes.mExtentX + i );
+		__m128 ey = ex, ez = ex;
+		if( BOXES ) {
+			ey = _mm_loadu_ps( volumes.mExtentY + i );
+			ez = _mm_loadu_ps( volumes.mExtentZ + i );
+		}
+		__m128 culled = _mm_setzero_ps();
+		for( size_t k = 0, p = firstPlane; k < NUM_PLANES; ++k, p = ( p + 1 < NUM_PLANES ) ? p + 1 : 0 ) {
+			const __m128 distance = _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx[p], x ), _mm_mul_ps( ny[p], y ) ), _mm_mul_ps( nz[p], z ) ), nd[p] );
+			const __m128 radius = BOXES ? _mm_add_ps( _mm_add_ps( _mm_mul_ps( ax[p], ex ), _mm_mul_ps( ay[p], ey ) ), _mm_mul_ps( az[p], ez ) ) : ex;
+			culled = _mm_or_ps( culled, _mm_cmplt_ps( distance, _mm_xor_ps( radius, signMask ) ) );
+			if( _mm_movemask_ps( culled ) == 0xF ) {
+				firstPlane = p;
+				break;
+			}
+		}
+		count += appendVisible( ~_mm_movemask_ps( culled ) & 0xF, (uint32_t)i, 4, out + count );
+	}
+	return count;
+}
+
+template<bool BOXES>
+CINDER_FRUSTUM_TARGET( "avx" )
+size_t cullAvx( const CullPlanes &planes, const CullVolumes &volumes, size_t begin, size_t end, uint32_t *out )
+{
+	__m256 nx[NUM_PLANES], ny[NUM_PLANES], nz[NUM_PLANES], nd[NUM_PLANES], ax[NUM_PLANES], ay[NUM_PLANES], az[NUM_PLANES];
+	for( size_t p = 0; p < NUM_PLANES; ++p ) {
+		nx[p] = _mm256_set1_ps( planes.mNormalX[p] ); ny[p] = _mm256_set1_ps( planes.mNormalY[p] ); nz[p] = _mm256_set1_ps( planes.mNormalZ[p] );
+		nd[p] = _mm256_set1_ps( planes.mDistance[p] );
+		ax[p] = _mm256_set1_ps( planes.mAbsNormalX[p] ); ay[p] = _mm256_set1_ps( planes.mAbsNormalY[p] ); az[p] = _mm256_set1_ps( planes.mAbsNormalZ[p] );
+	}
+
+	const __m256 signMask = _mm256_set1_ps( -0.0f );
+	size_t count = 0, firstPlane = 0;
+	for( size_t i = begin; i < end; i += 8 ) {
+		const __m256 x = _mm256_loadu_ps( volumes.mX + i ), y = _mm256_loadu_ps( volumes.mY + i ), z = _mm256_loadu_ps( volumes.mZ + i );
+		const __m256 ex = _mm256_loadu_ps( volumes.mExtentX + i );
+		__m256 ey = ex, ez = ex;
+		if( BOXES ) {
+			ey = _mm256_loadu_ps( volumes.mExtentY + i );
+			ez = _mm256_loadu_ps( volumes.mExtentZ + i );
+		}
+		__m256 culled = _mm256_setzero_ps();
+		for( size_t k = 0, p = firstPlane; k < NUM_PLANES; ++k, p = ( p + 1 < NUM_PLANES ) ? p + 1 : 0 ) {
+			const __m256 distance = _mm256_sub_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( nx[p], x ), _mm256_mul_ps( ny[p], y ) ), _mm256_mul_ps( nz[p], z ) ), nd[p] );
+			const __m256 radius = BOXES ? _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( ax[p], ex ), _mm256_mul_ps( ay[p], ey ) ), _mm256_mul_ps( az[p], ez ) ) : ex;
+			culled = _mm256_or_ps( culled, _mm256_cmp_ps( distance, _mm256_xor_ps( radius, signMask ), _CMP_LT_OQ ) );
+			if( _mm256_movemask_ps( culled ) == 0xFF ) {
+				firstPlane = p;
+				break;
+			}
+		}
+		count += appendVisible( ~_mm256_movemask_ps( culled ) & 0xFF, (uint32_t)i, 8, out + count );
+	}
+	return count;
+}
+
+#elif defined( CINDER_FRUSTUM_NEON )
+
+template<bool BOXES>
+size_t cullNeon( const CullPlanes &planes, const CullVolumes &volumes, size_t begin, size_t end, uint32_t *out )
+{
+	static const uint32_t laneBits[4] = { 1, 2, 4, 8 };
+	const uint32x4_t bits = vld1q_u32( laneBits );
+	size_t count = 0, firstPlane = 0;
+	for( size_t i = begin; i < end; i += 4 ) {
+		const float32x4_t x = vld1q_f32( volumes.mX + i ), y = vld1q_f32( volumes.mY + i ), z = vld1q_f32( volumes.mZ + i );
+		const float32x4_t ex = vld1q_f32( volumes.mExtentX + i );
+		float32x4_t ey = ex, ez = ex;
+		if( BOXES ) {
+			ey = vld1q_f32( volumes.mExtentY + i );
+			ez = vld1q_f32( volumes.mExtentZ + i );
+		}
+		uint32x4_t culled = vdupq_n_u32( 0 );
+		for( size_t k = 0, p = firstPlane; k < NUM_PLANES; ++k, p = ( p + 1 < NUM_PLANES ) ? p + 1 : 0 ) {
+			float32x4_t distance = vmulq_n_f32( x, planes.mNormalX[p] );
+			distance = vaddq_f32( distance, vmulq_n_f32( y, planes.mNormalY[p] ) );
+			distance = vaddq_f32( distance, vmulq_n_f32( z, planes.mNormalZ[p] ) );
+			distance = vsubq_f32( distance, vdupq_n_f32( planes.mDistance[p] ) );
+			float32x4_t radius = ex;
+			if( BOXES )
+				radius = vaddq_f32( vaddq_f32( vmulq_n_f32( ex, planes.mAbsNormalX[p] ), vmulq_n_f32( ey, planes.mAbsNormalY[p] ) ), vmulq_n_f32( ez, planes.mAbsNormalZ[p] ) );
+			culled = vorrq_u32( culled, vcltq_f32( distance, vnegq_f32( radius ) ) );
+			if( vminvq_u32( culled ) != 0 ) {
+				firstPlane = p;
+				break;
+			}
+		}
+		count += appendVisible( ~vaddvq_u32( vandq_u32( culled, bits ) ) & 0xF, (uint32_t)i, 4, out + count );
+	}
+	return count;
+}
+
+#endif
+
+template<bool BOXES>
+size_t cullRange( const CullPlanes &planes, const CullVolumes &volumes, size_t begin, size_t end, uint32_t *out )
+{
+	size_t count = 0, vectorEnd = begin;
+#if defined( CINDER_FRUSTUM_X86 )
+	if( getCullSimdLevel() == CullSimdLevel::AVX ) {
+		vectorEnd = begin + ( end - begin ) / 8 * 8;
+		count = cullAvx<BOXES>( planes, volumes, begin, vectorEnd, out );
+	}
+	else {
+		vectorEnd = begin + ( end - begin ) / 4 * 4;
+		count = cullSse<BOXES>( planes, volumes, begin, vectorEnd, out );
+	}
+#elif defined( CINDER_FRUSTUM_NEON )
+	vectorEnd = begin + ( end - begin ) / 4 * 4;
+	count = cullNeon<BOXES>( planes, volumes, begin, vectorEnd, out );
+#endif
+	return count + cullScalar<BOXES>( planes, volumes, vectorEnd, end, out + count );
+}
+
+// Large batches are split into chunks culled in parallel, each compacting into its own part of the output, which are then joined up in order
+template<bool BOXES>
+size_t cullVolumes( const CullPlanes &planes, const CullVolumes &volumes, size_t numVolumes, uint32_t *out )
+{
+	if( numVolumes <= CULL_CHUNK_SIZE )
+		return cullRange<BOXES>( planes, volumes, 0, numVolumes, out );
+
+	const size_t numChunks = ( numVolumes + CULL_CHUNK_SIZE - 1 ) / CULL_CHUNK_SIZE;
+	std::vector<size_t> counts( numChunks );
+	parallelFor( numChunks, [&]( size_t begin, size_t end ) {
+		for( size_t c = begin; c < end; ++c ) {
+			const size_t chunkBegin = c * CULL_CHUNK_SIZE;
+			counts[c] = cullRange<BOXES>( planes, volumes, chunkBegin, std::min( chunkBegin + CULL_CHUNK_SIZE, numVolumes ), out + chunkBegin );
+		}
+	} );
+
+	size_t count = counts[0];
+	for( size_t c = 1; c < numChunks; ++c ) {
+		std::memmove( out + count, out + c * CULL_CHUNK_SIZE, counts[c] * sizeof( uint32_t ) );
+		count += counts[c];
+	}
+	return count;
+}
+
+template<typename T>
+CullPlanes makeCullPlanes( const PlaneT<T> *planes )
+{
+	CullPlanes result;
+	for( size_t p = 0; p < NUM_PLANES; ++p ) {
+		const auto &normal = planes[p].getNormal();
+		result.mNormalX[p] = (float)normal.x;
+		result.mNormalY[p] = (float)normal.y;
+		result.mNormalZ[p] = (float)normal.z;
+		result.mDistance[p] = (float)planes[p].getDistance();
+		result.mAbsNormalX[p] = std::abs( result.mNormalX[p] );
+		result.mAbsNormalY[p] = std::abs( result.mNormalY[p] );
+		result.mAbsNormalZ[p] = std::abs( result.mNormalZ[p] );
+	}
+	return result;
+}
+
+} // anonymous namespace
+
 template<typename T>
 FrustumT<T>::FrustumT( const Camera &cam )
 {
@@ -196,6 +460,27 @@ bool FrustumT<T>::intersects( const AxisAlignedBox &box ) const
 	return true;
 }
 
+template<typename T>
+typename FrustumT<T>::CullResult FrustumT<T>::cullSpheres( const float *centersX, const float *centersY, const float *centersZ, const float *radii, size_t numSpheres, uint32_t *visibleIndices ) const
+{
+	const CullVolumes volumes = { centersX, centersY, centersZ, radii, nullptr, nullptr };
+	CullResult result;
+	result.mNumTested = numSpheres;
+	result.mNumVisible = cullVolumes<false>( makeCullPlanes( mFrustumPlanes ), volumes, numSpheres, visibleIndices );
+	return result;
+}
+
+template<typename T>
+typename FrustumT<T>::CullResult FrustumT<T>::cullBoxes( const float *centersX, const float *centersY, const float *centersZ, const float *extentsX, const float *extentsY, const float *extentsZ,
+															size_t numBoxes, uint32_t *visibleIndices ) const
+{
+	const CullVolumes volumes = { centersX, centersY, centersZ, extentsX, extentsY, extentsZ };
+	CullResult result;
+	result.mNumTested = numBoxes;
+	result.mNumVisible = cullVolumes<true>( makeCullPlanes( mFrustumPlanes ), volumes, numBoxes, visibleIndices );
+	return result;
+}
+
 template class CI_API FrustumT<float>;
 template class CI_API FrustumT<double>;
 
@@ -31,6 +31,7 @@
 #include "cinder/BSpline.h"
 #include "cinder/Matrix.h"
 #include "cinder/Sphere.h"
+#include "cinder/Thread.h"
 #include <algorithm>
 
 #if defined( CINDER_ANDROID )
@@ -603,6 +604,20 @@ Primitive Target::determineCombinedPrimitive( Primitive a, Primitive b )
 		return Primitive::NUM_PRIMITIVES;
 }
 
+namespace {
+
+//! Calls \a fn( begin, end ) over ranges of [0, \a numRows), in parallel once there are enough vertices for each thread to outweigh scheduling them
+void parallelForRows( int numRows, int verticesPerRow, const std::function<void( size_t, size_t )> &fn )
+{
+	if( numRows <= 0 )
+		return;
+
+	const int MIN_VERTICES_PER_RANGE = 16384;
+	parallelFor( (size_t)numRows, fn, (size_t)std::max( 1, MIN_VERTICES_PER_RANGE / std::max( verticesPerRow, 1 ) ) );
+}
+
+} // anonymous namespace
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Rect
 
@@ -1016,6 +1031,16 @@ void generateFace( const vec3 &faceCenter, const vec3 &uAxis, const vec3 &vAxis,
 	}
 }
 
+bool Cube::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mSubdivisions << mSize << mHasColors;
+	for( const auto &color : mColors )
+		*key << color.r << color.g << color.b << color.a;
+	return true;
+}
+
 void Cube::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 {
 	vector<vec3> positions;
@@ -1501,6 +1526,14 @@ AttribSet Icosphere::getAvailableAttribs() const
 	return { Attrib::POSITION, Attrib::NORMAL, Attrib::TEX_COORD_0, Attrib::COLOR, Attrib::TANGENT };
 }
 
+bool Icosphere::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mSubdivision << mHasColors;
+	return true;
+}
+
 void Icosphere::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 {
 	calculate();
@@ -1794,6 +1827,14 @@ vec3 Teapot::evaluateNormal( int gridU, int gridV, const float *B, const float *
 	return normalize( cross( du, dv ) );
 }
 
+bool Teapot::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mSubdivision;
+	return true;
+}
+
 void Teapot::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 {
 	vector<float> positions, normals, texCoords;
@@ -2043,6 +2084,14 @@ AttribSet Sphere::getAvailableAttribs() const
 	return { Attrib::POSITION, Attrib::NORMAL, Attrib::TEX_COORD_0, Attrib::COLOR, Attrib::TANGENT };
 }
 
+bool Sphere::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mCenter << mRadius << mSubdivisions << mHasColors;
+	return true;
+}
+
 void Sphere::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 {
 	int numRings, numSegments;
@@ -2064,38 +2113,43 @@ void Sphere::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 	float segIncr = 1.0f / (float)( numSegments - 1 );
 	float radius = mRadius;
 
-	auto vertIt = positions.begin();
-	auto normIt = normals.begin();
-	auto texIt = texCoords.begin();
-	auto colorIt = colors.begin();
-	for( int r = 0; r < numRings; r++ ) {
-		float v = r * ringIncr;
-		for( int s = 0; s < numSegments; s++ ) {
-			float u = 1.0f - s * segIncr;
-			float x = math<float>::sin( float(M_PI * 2) * u ) * math<float>::sin( float(M_PI) * v );
-			float y = math<float>::sin( float(M_PI) * (v - 0.5f) );
-			float z = math<float>::cos( float(M_PI * 2) * u ) * math<float>::sin( float(M_PI) * v );
-
-			*vertIt++ = vec3( x * radius + mCenter.x, y * radius + mCenter.y, z * radius + mCenter.z );
-
-			*normIt++ = vec3( x, y, z );
-			*texIt++ = vec2( u, v );
-			*colorIt++ = vec3( x * 0.5f + 0.5f, y * 0.5f + 0.5f, z * 0.5f + 0.5f );
+	// each range of rings writes its own part of the buffers
+	parallelForRows( numRings, numSegments, [&]( size_t beginRing, size_t endRing ) {
+		auto vertIt = positions.begin() + beginRing * numSegments;
+		auto normIt = normals.begin() + beginRing * numSegments;
+		auto texIt = texCoords.begin() + beginRing * numSegments;
+		auto colorIt = colors.begin() + beginRing * numSegments;
+		for( int r = (int)beginRing; r < (int)endRing; r++ ) {
+			float v = r * ringIncr;
+			for( int s = 0; s < numSegments; s++ ) {
+				float u = 1.0f - s * segIncr;
+				float x = math<float>::sin( float(M_PI * 2) * u ) * math<float>::sin( float(M_PI) * v );
+				float y = math<float>::sin( float(M_PI) * (v - 0.5f) );
+				float z = math<float>::cos( float(M_PI * 2) * u ) * math<float>::sin( float(M_PI) * v );
+
+				*vertIt++ = vec3( x * radius + mCenter.x, y * radius + mCenter.y, z * radius + mCenter.z );
+
+				*normIt++ = vec3( x, y, z );
+				*texIt++ = vec2( u, v );
+				*colorIt++ = vec3( x * 0.5f + 0.5f, y * 0.5f + 0.5f, z * 0.5f + 0.5f );
+			}
 		}
-	}
-
-	auto indexIt = indices.begin();
-	for( int r = 0; r < numRings - 1; r++ ) {
-		for( int s = 0; s < numSegments - 1 ; s++ ) {
-			*indexIt++ = (uint32_t)(r * numSegments + ( s + 1 ));
-			*indexIt++ = (uint32_t)(r * numSegments + s);
-			*indexIt++ = (uint32_t)(( r + 1 ) * numSegments + ( s + 1 ));
-
-			*indexIt++ = (uint32_t)(( r + 1 ) * numSegments + s);
-			*indexIt++ = (uint32_t)(( r + 1 ) * numSegments + ( s + 1 ));
-			*indexIt++ = (uint32_t)(r * numSegments + s);
+	} );
+
+	parallelForRows( numRings - 1, numSegments, [&]( size_t beginRing, size_t endRing ) {
+		auto indexIt = indices.begin() + beginRing * ( numSegments - 1 ) * 6;
+		for( int r = (int)beginRing; r < (int)endRing; r++ ) {
+			for( int s = 0; s < numSegments - 1 ; s++ ) {
+				*indexIt++ = (uint32_t)(r * numSegments + ( s + 1 ));
+				*indexIt++ = (uint32_t)(r * numSegments + s);
+				*indexIt++ = (uint32_t)(( r + 1 ) * numSegments + ( s + 1 ));
+
+				*indexIt++ = (uint32_t)(( r + 1 ) * numSegments + s);
+				*indexIt++ = (uint32_t)(( r + 1 ) * numSegments + ( s + 1 ));
+				*indexIt++ = (uint32_t)(r * numSegments + s);
+			}
 		}
-	}
+	} );
 	
 	target->copyAttrib( Attrib::POSITION, 3, 0, value_ptr( *positions.data() ), positions.size() );
 	target->copyAttrib( Attrib::NORMAL, 3, 0, value_ptr( *normals.data() ), normals.size() );
@@ -2234,6 +2288,14 @@ AttribSet Capsule::getAvailableAttribs() const
 	return { Attrib::POSITION, Attrib::NORMAL, Attrib::TEX_COORD_0, Attrib::COLOR, Attrib::TANGENT };
 }
 
+bool Capsule::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mDirection << mCenter << mLength << mRadius << mSubdivisionsHeight << mSubdivisionsAxis << mNumSegments << mHasColors;
+	return true;
+}
+
 void Capsule::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 {
 	std::vector<vec3> positions, normals;
@@ -2301,12 +2363,12 @@ size_t Torus::getNumIndices() const
 
 void Torus::calculate( vector<vec3> *positions, vector<vec3> *normals, vector<vec2> *texCoords, vector<vec3> *colors, vector<uint32_t> *indices ) const
 {
-	positions->reserve( mNumAxis * mNumRings );
-	normals->reserve( mNumAxis * mNumRings );
-	texCoords->reserve( mNumAxis * mNumRings );
+	positions->resize( mNumAxis * mNumRings );
+	normals->resize( mNumAxis * mNumRings );
+	texCoords->resize( mNumAxis * mNumRings );
 	if( colors )
-		colors->reserve( mNumAxis * mNumRings );
-	indices->reserve( (mNumAxis - 1) * (mNumRings - 1) * 6 );
+		colors->resize( mNumAxis * mNumRings );
+	indices->resize( (mNumAxis - 1) * (mNumRings - 1) * 6 );
 
 	float majorIncr = 1.0f / (mNumAxis - 1);
 	float minorIncr = 1.0f / (mNumRings - 1);
@@ -2315,43 +2377,49 @@ void Torus::calculate( vector<vec3> *positions, vector<vec3> *normals, vector<ve
 	float twist = angle * mTwist * minorIncr * majorIncr;
 
 	// vertex, normal, tex coord and color buffers
-	for( int i = 0; i < mNumAxis; ++i ) {
-		float phi = i * majorIncr * angle;
-		float cosPhi = -math<float>::cos( phi );
-		float sinPhi =  math<float>::sin( phi );
-
-		for( int j = 0; j < mNumRings; ++j ) {
-			float theta = j * minorIncr * float(M_PI * 2) + i * twist + mTwistOffset;
-			float cosTheta = -math<float>::cos( theta );
-			float sinTheta =  math<float>::sin( theta );
-
-			float r = mRadiusMinor + cosTheta * radiusDiff;
-			float x = r * cosPhi;
-			float y = i * majorIncr * mHeight + sinTheta * radiusDiff;
-			float z = r * sinPhi;
-
-			positions->emplace_back( mCenter + vec3( x, y, z ) );
-			texCoords->emplace_back( i * majorIncr, j * minorIncr );
-			normals->emplace_back( cosPhi * cosTheta, sinTheta, sinPhi * cosTheta );
-
-			const vec3 &n = normals->back();
-			if( colors )
-				colors->emplace_back( n.x * 0.5f + 0.5f, n.y * 0.5f + 0.5f, n.z * 0.5f + 0.5f );
+	parallelForRows( mNumAxis, mNumRings, [&]( size_t beginAxis, size_t endAxis ) {
+		for( int i = (int)beginAxis; i < (int)endAxis; ++i ) {
+			float phi = i * majorIncr * angle;
+			float cosPhi = -math<float>::cos( phi );
+			float sinPhi =  math<float>::sin( phi );
+
+			for( int j = 0; j < mNumRings; ++j ) {
+				float theta = j * minorIncr * float(M_PI * 2) + i * twist + mTwistOffset;
+				float cosTheta = -math<float>::cos( theta );
+				float sinTheta =  math<float>::sin( theta );
+
+				float r = mRadiusMinor + cosTheta * radiusDiff;
+				float x = r * cosPhi;
+				float y = i * majorIncr * mHeight + sinTheta * radiusDiff;
+				float z = r * sinPhi;
+
+				const size_t v = i * mNumRings + j;
+				( *positions )[v] = mCenter + vec3( x, y, z );
+				( *texCoords )[v] = vec2( i * majorIncr, j * minorIncr );
+				( *normals )[v] = vec3( cosPhi * cosTheta, sinTheta, sinPhi * cosTheta );
+
+				const vec3 &n = ( *normals )[v];
+				if( colors )
+					( *colors )[v] = vec3( n.x * 0.5f + 0.5f, n.y * 0.5f + 0.5f, n.z * 0.5f + 0.5f );
+			}
 		}
-	}
+	} );
 
 	// index buffer
-	for( int i = 0; i < mNumAxis - 1; ++i ) {
-		for ( int j = 0; j < mNumRings - 1; ++j ) {
-			indices->push_back( (uint32_t)((i + 0) * mNumRings + (j + 0)) );
-			indices->push_back( (uint32_t)((i + 1) * mNumRings + (j + 1)) );
-			indices->push_back( (uint32_t)((i + 1) * mNumRings + (j + 0)) );
-
-			indices->push_back( (uint32_t)((i + 0) * mNumRings + (j + 0)) );
-			indices->push_back( (uint32_t)((i + 0) * mNumRings + (j + 1)) );
-			indices->push_back( (uint32_t)((i + 1) * mNumRings + (j + 1)) );
+	parallelForRows( mNumAxis - 1, mNumRings, [&]( size_t beginAxis, size_t endAxis ) {
+		auto indexIt = indices->begin() + beginAxis * ( mNumRings - 1 ) * 6;
+		for( int i = (int)beginAxis; i < (int)endAxis; ++i ) {
+			for ( int j = 0; j < mNumRings - 1; ++j ) {
+				*indexIt++ = (uint32_t)((i + 0) * mNumRings + (j + 0));
+				*indexIt++ = (uint32_t)((i + 1) * mNumRings + (j + 1));
+				*indexIt++ = (uint32_t)((i + 1) * mNumRings + (j + 0));
+
+				*indexIt++ = (uint32_t)((i + 0) * mNumRings + (j + 0));
+				*indexIt++ = (uint32_t)((i + 0) * mNumRings + (j + 1));
+				*indexIt++ = (uint32_t)((i + 1) * mNumRings + (j + 1));
+			}
 		}
-	}
+	} );
 }
 
 uint8_t Torus::getAttribDims( Attrib attr ) const
@@ -2372,6 +2440,15 @@ AttribSet Torus::getAvailableAttribs() const
 	return { Attrib::POSITION, Attrib::NORMAL, Attrib::TEX_COORD_0, Attrib::COLOR, Attrib::TANGENT };
 }
 
+bool Torus::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType<Torus, Helix>( *this ) )
+		return false;
+	*key << mCenter << mRadiusMajor << mRadiusMinor << mSubdivisionsAxis << mSubdivisionsHeight << mHeight << mCoils
+		<< mTwist << mTwistOffset << mHasColors << mNumRings << mNumAxis;
+	return true;
+}
+
 void Torus::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 {
 	std::vector<vec3> positions, normals;
@@ -2435,6 +2512,14 @@ AttribSet TorusKnot::getAvailableAttribs() const
 	return{ Attrib::POSITION, Attrib::NORMAL, Attrib::TEX_COORD_0, Attrib::COLOR, Attrib::TANGENT };
 }
 
+bool TorusKnot::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mP << mQ << mSubdivisionsAxis << mSubdivisionsHeight << mScale << mRadius << mHasColors;
+	return true;
+}
+
 void TorusKnot::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 {
 	auto numVertices = getNumVertices();
@@ -2473,52 +2558,56 @@ void TorusKnot::calculate( std::vector<vec3> *positions, std::vector<vec3> *norm
 	int _p = ( divider != 0 ) ? mP / divider : 1;
 	int _q = ( divider != 0 ) ? mQ / divider : 0;
 
-	for( int i = 0; i <= mSubdivisionsHeight; ++i ) {
-		float p = _p * i * stepHeight;
-		float q = _q * i * stepHeight;
-		float r = 0.5f * ( 2.0f + glm::cos( q ) );
-		vec3 center( r * glm::sin( p ) * mScale.x, r * glm::sin( q ) * mScale.y, r * glm::cos( p ) * mScale.z );
-
-		p = _p * ( i + 1 ) * stepHeight;
-		q = _q * ( i + 1 ) * stepHeight;
-		r = 0.5f * ( 2.0f + glm::cos( q ) );
-		vec3 next( r * glm::sin( p ) * mScale.x, r * glm::sin( q ) * mScale.y, r * glm::cos( p ) * mScale.z );
-
-		vec3 T = normalize( next - center );
-		vec3 B = normalize( cross( T, next + center ) );
-		vec3 N = normalize( cross( B, T ) );
-
-		for( int j = 0; j <= mSubdivisionsAxis; ++j ) {
-			float x = glm::cos( j * stepAxis ) * mRadius;
-			float y = glm::sin( j * stepAxis ) * mRadius;
-
-			int idx = i * ( mSubdivisionsAxis + 1 ) + j;
-			( *normals )[idx] = B * x + N * y;
-			( *positions )[idx] = ( *normals )[idx] + center;
-			( *normals )[idx] = glm::normalize( ( *normals )[idx] );
-			( *texCoords )[idx].y = float( j ) / mSubdivisionsAxis;
-			( *texCoords )[idx].x = float( i ) / mSubdivisionsHeight;
-
-			if( tangents )
-				( *tangents )[idx] = T; 
-			
-			if( colors )
-				( *colors )[idx] = ( *normals )[idx] * 0.5f + 0.5f;
+	parallelForRows( mSubdivisionsHeight + 1, mSubdivisionsAxis + 1, [&]( size_t beginHeight, size_t endHeight ) {
+		for( int i = (int)beginHeight; i < (int)endHeight; ++i ) {
+			float p = _p * i * stepHeight;
+			float q = _q * i * stepHeight;
+			float r = 0.5f * ( 2.0f + glm::cos( q ) );
+			vec3 center( r * glm::sin( p ) * mScale.x, r * glm::sin( q ) * mScale.y, r * glm::cos( p ) * mScale.z );
+
+			p = _p * ( i + 1 ) * stepHeight;
+			q = _q * ( i + 1 ) * stepHeight;
+			r = 0.5f * ( 2.0f + glm::cos( q ) );
+			vec3 next( r * glm::sin( p ) * mScale.x, r * glm::sin( q ) * mScale.y, r * glm::cos( p ) * mScale.z );
+
+			vec3 T = normalize( next - center );
+			vec3 B = normalize( cross( T, next + center ) );
+			vec3 N = normalize( cross( B, T ) );
+
+			for( int j = 0; j <= mSubdivisionsAxis; ++j ) {
+				float x = glm::cos( j * stepAxis ) * mRadius;
+				float y = glm::sin( j * stepAxis ) * mRadius;
+
+				int idx = i * ( mSubdivisionsAxis + 1 ) + j;
+				( *normals )[idx] = B * x + N * y;
+				( *positions )[idx] = ( *normals )[idx] + center;
+				( *normals )[idx] = glm::normalize( ( *normals )[idx] );
+				( *texCoords )[idx].y = float( j ) / mSubdivisionsAxis;
+				( *texCoords )[idx].x = float( i ) / mSubdivisionsHeight;
+
+				if( tangents )
+					( *tangents )[idx] = T; 
+				
+				if( colors )
+					( *colors )[idx] = ( *normals )[idx] * 0.5f + 0.5f;
+			}
 		}
-	}
+	} );
 
 	int nAxis = mSubdivisionsAxis + 1;
-	for( int j = 0; j < mSubdivisionsAxis; j++ ) {
-		for( int i = 0; i < mSubdivisionsHeight; i++ ) {
-			int idx = 6 * ( j * mSubdivisionsHeight + i );
-			( *indices )[idx + 0] = ( j + i * nAxis );
-			( *indices )[idx + 1] = ( j + ( i + 1 ) * nAxis );
-			( *indices )[idx + 2] = ( ( j + 1 ) + i * nAxis );
-			( *indices )[idx + 3] = ( ( j + 1 ) + i * nAxis );
-			( *indices )[idx + 4] = ( j + ( i + 1 ) * nAxis );
-			( *indices )[idx + 5] = ( ( j + 1 ) + ( i + 1 ) * nAxis );
+	parallelForRows( mSubdivisionsAxis, mSubdivisionsHeight, [&]( size_t beginAxis, size_t endAxis ) {
+		for( int j = (int)beginAxis; j < (int)endAxis; j++ ) {
+			for( int i = 0; i < mSubdivisionsHeight; i++ ) {
+				int idx = 6 * ( j * mSubdivisionsHeight + i );
+				( *indices )[idx + 0] = ( j + i * nAxis );
+				( *indices )[idx + 1] = ( j + ( i + 1 ) * nAxis );
+				( *indices )[idx + 2] = ( ( j + 1 ) + i * nAxis );
+				( *indices )[idx + 3] = ( ( j + 1 ) + i * nAxis );
+				( *indices )[idx + 4] = ( j + ( i + 1 ) * nAxis );
+				( *indices )[idx + 5] = ( ( j + 1 ) + ( i + 1 ) * nAxis );
+			}
 		}
-	}
+	} );
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -2571,48 +2660,54 @@ size_t Cylinder::getNumIndices() const
 
 void Cylinder::calculate( vector<vec3> *positions, vector<vec3> *normals, vector<vec2> *texCoords, vector<vec3> *colors, vector<uint32_t> *indices ) const
 {
-	positions->reserve( mNumSegments * mNumSlices );
-	normals->reserve( mNumSegments * mNumSlices );
-	texCoords->reserve( mNumSegments * mNumSlices );
-	indices->reserve( (mNumSegments - 1) * (mNumSlices - 1) * 6 );
+	positions->resize( mNumSegments * mNumSlices );
+	normals->resize( mNumSegments * mNumSlices );
+	texCoords->resize( mNumSegments * mNumSlices );
+	indices->resize( (mNumSegments - 1) * (mNumSlices - 1) * 6 );
 
-	colors->reserve( mNumSegments * mNumSlices );
+	colors->resize( mNumSegments * mNumSlices );
 
 	const float segmentIncr = 1.0f / (mNumSegments - 1);
 	const float ringIncr = 1.0f / (mNumSlices - 1);
 	const quat axis = glm::rotation( vec3( 0, 1, 0 ), mDirection );
 
 	// vertex, normal, tex coord and color buffers
-	for( int i = 0; i < mNumSegments; ++i ) {
-		for( int j = 0; j < mNumSlices; ++j ) {
-			float cosPhi = -math<float>::cos( i * segmentIncr * float(M_PI * 2) );
-			float sinPhi =  math<float>::sin( i * segmentIncr * float(M_PI * 2) );
-
-			float r = lerp<float>( mRadiusBase, mRadiusApex, j * ringIncr );
-			float x = r * cosPhi;
-			float y = mHeight * j * ringIncr;
-			float z = r * sinPhi;
-			const vec3 n = normalize( vec3( mHeight * cosPhi, mRadiusBase - mRadiusApex, mHeight * sinPhi ) );
-
-			positions->emplace_back( mOrigin + axis * vec3( x, y, z ) );
-			texCoords->emplace_back( i * segmentIncr, 1.0f - j * ringIncr );
-			normals->emplace_back( axis * n );
-			colors->emplace_back( n.x * 0.5f + 0.5f, n.y * 0.5f + 0.5f, n.z * 0.5f + 0.5f );
+	parallelForRows( mNumSegments, mNumSlices, [&]( size_t beginSegment, size_t endSegment ) {
+		for( int i = (int)beginSegment; i < (int)endSegment; ++i ) {
+			for( int j = 0; j < mNumSlices; ++j ) {
+				float cosPhi = -math<float>::cos( i * segmentIncr * float(M_PI * 2) );
+				float sinPhi =  math<float>::sin( i * segmentIncr * float(M_PI * 2) );
+
+				float r = lerp<float>( mRadiusBase, mRadiusApex, j * ringIncr );
+				float x = r * cosPhi;
+				float y = mHeight * j * ringIncr;
+				float z = r * sinPhi;
+				const vec3 n = normalize( vec3( mHeight * cosPhi, mRadiusBase - mRadiusApex, mHeight * sinPhi ) );
+
+				const size_t v = i * mNumSlices + j;
+				( *positions )[v] = mOrigin + axis * vec3( x, y, z );
+				( *texCoords )[v] = vec2( i * segmentIncr, 1.0f - j * ringIncr );
+				( *normals )[v] = axis * n;
+				( *colors )[v] = vec3( n.x * 0.5f + 0.5f, n.y * 0.5f + 0.5f, n.z * 0.5f + 0.5f );
+			}
 		}
-	}
+	} );
 
 	// index buffer
-	for ( int j = 0; j < mNumSlices - 1; ++j ) {
-		for( int i = 0; i < mNumSegments - 1; ++i ) {
-			indices->push_back( (uint32_t)((i + 0) * mNumSlices + (j + 0)) );
-			indices->push_back( (uint32_t)((i + 1) * mNumSlices + (j + 0)) );
-			indices->push_back( (uint32_t)((i + 1) * mNumSlices + (j + 1)) );
-
-			indices->push_back( (uint32_t)((i + 0) * mNumSlices + (j + 0)) );
-			indices->push_back( (uint32_t)((i + 1) * mNumSlices + (j + 1)) );
-			indices->push_back( (uint32_t)((i + 0) * mNumSlices + (j + 1)) );
+	parallelForRows( mNumSlices - 1, mNumSegments, [&]( size_t beginSlice, size_t endSlice ) {
+		auto indexIt = indices->begin() + beginSlice * ( mNumSegments - 1 ) * 6;
+		for ( int j = (int)beginSlice; j < (int)endSlice; ++j ) {
+			for( int i = 0; i < mNumSegments - 1; ++i ) {
+				*indexIt++ = (uint32_t)((i + 0) * mNumSlices + (j + 0));
+				*indexIt++ = (uint32_t)((i + 1) * mNumSlices + (j + 0));
+				*indexIt++ = (uint32_t)((i + 1) * mNumSlices + (j + 1));
+
+				*indexIt++ = (uint32_t)((i + 0) * mNumSlices + (j + 0));
+				*indexIt++ = (uint32_t)((i + 1) * mNumSlices + (j + 1));
+				*indexIt++ = (uint32_t)((i + 0) * mNumSlices + (j + 1));
+			}
 		}
-	}
+	} );
 
 	// caps
 	if( mRadiusBase > 0.0f )
@@ -2702,6 +2797,15 @@ AttribSet Cylinder::getAvailableAttribs() const
 	return { Attrib::POSITION, Attrib::NORMAL, Attrib::TEX_COORD_0, Attrib::COLOR, Attrib::TANGENT };
 }
 
+bool Cylinder::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType<Cylinder, Cone>( *this ) )
+		return false;
+	*key << mOrigin << mHeight << mDirection << mRadiusBase << mRadiusApex << mSubdivisionsAxis << mSubdivisionsHeight
+		<< mSubdivisionsCap << mHasColors << mNumSegments << mNumSlices;
+	return true;
+}
+
 void Cylinder::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 {
 	vector<vec3> positions, normals, colors;
@@ -2782,6 +2886,14 @@ AttribSet Plane::getAvailableAttribs() const
 	return { Attrib::POSITION, Attrib::NORMAL, Attrib::TEX_COORD_0, Attrib::TANGENT };
 }
 
+bool Plane::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mSubdivisions << mSize << mOrigin << mAxisU << mAxisV;
+	return true;
+}
+
 void Plane::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 {
 	std::vector<vec3> positions, normals;
@@ -2789,38 +2901,45 @@ void Plane::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 	std::vector<uint32_t> indices;
 
 	const size_t numVerts = ( mSubdivisions.x + 1 ) * ( mSubdivisions.y + 1 );
-	positions.reserve( numVerts );
-	normals.reserve( numVerts );
-	texCoords.reserve( numVerts );
+	positions.resize( numVerts );
+	normals.resize( numVerts );
+	texCoords.resize( numVerts );
+	indices.resize( getNumIndices() );
 
 	const vec2 stepIncr = vec2( 1, 1 ) / vec2( mSubdivisions );
 	const vec3 normal = cross( mAxisV, mAxisU );
 
 	// fill vertex data
-	for( int x = 0; x <= mSubdivisions.x; x++ ) {
-		for( int y = 0; y <= mSubdivisions.y; y++ ) {
-			float u = x * stepIncr.x;
-			float v = y * stepIncr.y;
-			positions.emplace_back( mOrigin + ( mSize.x * ( u - 0.5f ) ) * mAxisU + ( mSize.y * ( v - 0.5f ) ) * mAxisV );
-			normals.emplace_back( normal );
-			texCoords.emplace_back( u, v );
+	parallelForRows( mSubdivisions.x + 1, mSubdivisions.y + 1, [&]( size_t beginX, size_t endX ) {
+		for( int x = (int)beginX; x < (int)endX; x++ ) {
+			for( int y = 0; y <= mSubdivisions.y; y++ ) {
+				float u = x * stepIncr.x;
+				float v = y * stepIncr.y;
+				const size_t i = x * ( mSubdivisions.y + 1 ) + y;
+				positions[i] = mOrigin + ( mSize.x * ( u - 0.5f ) ) * mAxisU + ( mSize.y * ( v - 0.5f ) ) * mAxisV;
+				normals[i] = normal;
+				texCoords[i] = vec2( u, v );
+			}
 		}
-	}
+	} );
 
 	// fill indices
-	for( int x = 0; x < mSubdivisions.x; x++ ) {
-		for( int y = 0; y < mSubdivisions.y; y++ ) {
-			const uint32_t i = x * ( mSubdivisions.y + 1 ) + y;
-
-			indices.push_back( i );
-			indices.push_back( i + 1 );
-			indices.push_back( i + mSubdivisions.y + 1 );
-
-			indices.push_back( i + mSubdivisions.y + 1 );
-			indices.push_back( i + 1 );
-			indices.push_back( i + mSubdivisions.y + 2 );
+	parallelForRows( mSubdivisions.x, mSubdivisions.y, [&]( size_t beginX, size_t endX ) {
+		auto indexIt = indices.begin() + beginX * mSubdivisions.y * 6;
+		for( int x = (int)beginX; x < (int)endX; x++ ) {
+			for( int y = 0; y < mSubdivisions.y; y++ ) {
+				const uint32_t i = x * ( mSubdivisions.y + 1 ) + y;
+
+				*indexIt++ = i;
+				*indexIt++ = i + 1;
+				*indexIt++ = i + mSubdivisions.y + 1;
+
+				*indexIt++ = i + mSubdivisions.y + 1;
+				*indexIt++ = i + 1;
+				*indexIt++ = i + mSubdivisions.y + 2;
+			}
 		}
-	}
+	} );
 
 
 	target->copyAttrib( Attrib::POSITION, 3, 0, value_ptr( *positions.data() ), positions.size() );
@@ -2849,6 +2968,14 @@ uint8_t	Transform::getAttribDims( Attrib attr, uint8_t upstreamDims ) const
 		return upstreamDims;
 }
 
+bool Transform::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType<Transform, Translate, Scale, Rotate>( *this ) )
+		return false;
+	*key << mTransform;
+	return true;
+}
+
 void Transform::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	ctx->processUpstream( requestedAttribs );
@@ -2901,6 +3028,14 @@ void Transform::process( SourceModsContext *ctx, const AttribSet &requestedAttri
 
 ///////////////////////////////////////////////////////////////////////////////////////
 // Twist
+bool Twist::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mAxisStart << mAxisEnd << mStartAngle << mEndAngle;
+	return true;
+}
+
 void Twist::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	ctx->processUpstream( requestedAttribs );
@@ -2973,6 +3108,13 @@ size_t Lines::calcNumIndices( Primitive primitive, size_t upstreamNumIndices, si
 	}
 }
 
+bool Lines::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	return true;
+}
+
 void Lines::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	ctx->processUpstream( requestedAttribs );
@@ -3174,6 +3316,14 @@ AttribSet Constant::getAvailableAttribs( const Modifier::Params &upstreamParams
 	return result;
 }
 
+bool Constant::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mAttrib << mValue << mDims;
+	return true;
+}
+
 void Constant::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	ctx->processUpstream( requestedAttribs );
@@ -4402,6 +4552,14 @@ AttribSet VertexNormalLines::getAvailableAttribs( const Modifier::Params &upstre
 	return result;
 }
 
+bool VertexNormalLines::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mLength << mAttrib;
+	return true;
+}
+
 void VertexNormalLines::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	AttribSet request = requestedAttribs;
@@ -4497,6 +4655,13 @@ AttribSet Tangents::getAvailableAttribs( const Modifier::Params &upstreamParams
 	return result;
 }
 
+bool Tangents::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	return true;
+}
+
 void Tangents::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	AttribSet request = requestedAttribs;
@@ -4543,6 +4708,14 @@ void Tangents::process( SourceModsContext *ctx, const AttribSet &requestedAttrib
 
 ///////////////////////////////////////////////////////////////////////////////////////
 // Invert
+bool Invert::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mAttrib;
+	return true;
+}
+
 void Invert::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	ctx->processUpstream( requestedAttribs );
@@ -4577,6 +4750,14 @@ AttribSet Remove::getAvailableAttribs( const Modifier::Params &upstreamParams )
 	return result;
 }
 
+bool Remove::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mAttrib;
+	return true;
+}
+
 void Remove::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	ctx->processUpstream( requestedAttribs );
@@ -4690,6 +4871,13 @@ size_t Subdivide::getNumIndices( const Modifier::Params &upstreamParams ) const
 		return upstreamParams.getNumIndices();
 }
 
+bool Subdivide::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	return true;
+}
+
 void Subdivide::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	AttribSet request = requestedAttribs;
@@ -4881,7 +5069,10 @@ void SourceMods::cacheVariables() const
 	mParamsStack.back().mNumIndices = mSourcePtr->getNumIndices();
 	mParamsStack.back().mPrimitive = mSourcePtr->getPrimitive();
 	mParamsStack.back().mAvaliableAttribs = mSourcePtr->getAvailableAttribs();
-	for( auto &mod : mModifiers ) {
+	mParamsStack.back().mSourceMods = this;
+	mParamsStack.back().mNumModifiers = 0;
+	for( size_t m = 0; m < mModifiers.size(); ++m ) {
+		const auto &mod = mModifiers[m];
 		// we store these values in temporaries so that they aren't yet returned by get*()
 		auto numVertices = mod->getNumVertices( mParamsStack.back() );
 		auto numIndices = mod->getNumIndices( mParamsStack.back() );
@@ -4893,9 +5084,41 @@ void SourceMods::cacheVariables() const
 		mParamsStack.back().mNumIndices = numIndices;
 		mParamsStack.back().mPrimitive = primitive;
 		mParamsStack.back().mAvaliableAttribs = availableAttribs;
+		mParamsStack.back().mSourceMods = this;
+		mParamsStack.back().mNumModifiers = m + 1;
 	}
 }
 
+bool SourceMods::calcCacheKey( CacheKey *key ) const
+{
+	if( ! key->appendType( *this ) )
+		return false;
+	if( mSourcePtr ) {
+		CacheKey sourceKey;
+		if( ! mSourcePtr->calcCacheKey( &sourceKey ) )
+			return false;
+		*key << sourceKey;
+	}
+
+	*key << mChildren.size();
+	for( const auto &child : mChildren ) {
+		CacheKey childKey;
+		if( ! child->calcCacheKey( &childKey ) )
+			return false;
+		*key << childKey;
+	}
+
+	*key << mModifiers.size();
+	for( const auto &modifier : mModifiers ) {
+		CacheKey modifierKey;
+		if( ! modifier->calcCacheKey( &modifierKey ) )
+			return false;
+		*key << modifierKey;
+	}
+
+	return true;
+}
+
 void SourceMods::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 {
 	if( mSourcePtr ) { // normal, no children
@@ -4967,6 +5190,18 @@ SourceModsContext::SourceModsContext()
 {
 }
 
+SourceModsContext::SourceModsContext( const Modifier::Params &upstreamParams )
+	: mNumIndices( 0 ), mNumVertices( 0 ), mSource( nullptr ), mAttribMask( nullptr ), mPrimitive( upstreamParams.getPrimitive() )
+{
+	const SourceMods *sourceMods = upstreamParams.mSourceMods;
+	if( ! sourceMods )
+		return;
+
+	mSource = sourceMods->getSource();
+	for( size_t m = 0; m < upstreamParams.mNumModifiers && m < sourceMods->mModifiers.size(); ++m )
+		mModiferStack.push_back( sourceMods->mModifiers[m].get() );
+}
+
 void SourceModsContext::preload( const AttribSet &requestedAttribs )
 {
 	if( ! mSource ) {
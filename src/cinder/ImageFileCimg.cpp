@@ -0,0 +1,499 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ImageFileCimg.h"
+#include "cinder/MemoryMappedFile.h"
+#include "cinder/CinderMath.h"
+#include "cinder/Thread.h"
+
+#include <zlib.h>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+const uint16_t CIMG_VERSION = 1;
+const size_t HEADER_SIZE = 64;
+const size_t LEVEL_RECORD_SIZE = 40;
+const size_t TILE_RECORD_SIZE = 16;
+const size_t LEVEL_DATA_ALIGNMENT = 64;
+
+enum { FLAG_PREMULTIPLIED = 1 };
+enum { COMPRESSION_NONE = 0, COMPRESSION_DEFLATE = 1 };
+
+// Fixed-size header at the start of every .cimg file. Serialized field by field in little-endian order.
+struct Header {
+	uint16_t	mVersion;
+	uint32_t	mWidth, mHeight;
+	uint8_t		mDataType, mColorModel, mChannelOrder, mFlags;
+	uint8_t		mNumMipLevels, mCompression;
+	uint16_t	mRowAlignment;
+	uint32_t	mTileHeight;
+};
+
+template<typename T>
+T readLittle( const uint8_t *p )
+{
+	T result = 0;
+	for( size_t b = 0; b < sizeof(T); ++b )
+		result |= (T)p[b] << ( 8 * b );
+	return result;
+}
+
+template<typename T>
+void writeLittle( uint8_t *p, T value )
+{
+	for( size_t b = 0; b < sizeof(T); ++b )
+		p[b] = (uint8_t)( value >> ( 8 * b ) );
+}
+
+size_t alignUp( size_t value, size_t alignment )
+{
+	return ( value + alignment - 1 ) / alignment * alignment;
+}
+
+// Component accumulation for box filtering. Half floats are filtered as floats.
+template<typename T> float	toFloat( T v )							{ return (float)v; }
+template<> float			toFloat<half_float>( half_float v )		{ return halfToFloat( v ); }
+template<typename T> T		fromFloat( float v )					{ return (T)( v + 0.5f ); }
+template<> float			fromFloat<float>( float v )				{ return v; }
+template<> half_float		fromFloat<half_float>( float v )		{ return floatToHalf( v ); }
+
+// Box-filters \a src (srcWidth x srcHeight) into \a dst at half resolution, clamping at odd edges
+template<typename T>
+void downsample( const uint8_t *src, int32_t srcWidth, int32_t srcHeight, size_t srcRowBytes, uint8_t *dst, int32_t dstWidth, int32_t dstHeight, size_t dstRowBytes, int numComponents )
+{
+	parallelFor( dstHeight, [&]( size_t begin, size_t end ) {
+		for( int32_t y = (int32_t)begin; y < (int32_t)end; ++y ) {
+			const T *row0 = reinterpret_cast<const T*>( src + std::min( y * 2, srcHeight - 1 ) * srcRowBytes );
+			const T *row1 = reinterpret_cast<const T*>( src + std::min( y * 2 + 1, srcHeight - 1 ) * srcRowBytes );
+			T *dstRow = reinterpret_cast<T*>( dst + y * dstRowBytes );
+			for( int32_t x = 0; x < dstWidth; ++x ) {
+				const int32_t x0 = std::min( x * 2, srcWidth - 1 ) * numComponents;
+				const int32_t x1 = std::min( x * 2 + 1, srcWidth - 1 ) * numComponents;
+				for( int c = 0; c < numComponents; ++c ) {
+					float sum = toFloat( row0[x0 + c] ) + toFloat( row0[x1 + c] ) + toFloat( row1[x0 + c] ) + toFloat( row1[x1 + c] );
+					dstRow[x * numComponents + c] = fromFloat<T>( sum * 0.25f );
+				}
+			}
+		}
+	}, 16 );
+}
+
+} // anonymous namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// ImageSourceFileCimg
+ImageSourceRef ImageSourceFileCimg::create( DataSourceRef dataSource, ImageSource::Options options )
+{
+	return createRef( dataSource, options );
+}
+
+ImageSourceFileCimgRef ImageSourceFileCimg::createRef( DataSourceRef dataSource, ImageSource::Options options )
+{
+	return ImageSourceFileCimgRef( new ImageSourceFileCimg( dataSource, options ) );
+}
+
+void ImageSourceFileCimg::registerSelf()
+{
+	static bool sRegistered = false;
+	const int32_t PRIORITY = 1;
+
+	if( sRegistered )
+		return;
+
+	sRegistered = true;
+
+	ImageIoRegistrar::SourceCreationFunc sourceFunc = ImageSourceFileCimg::create;
+	ImageIoRegistrar::registerSourceType( "cimg", sourceFunc, PRIORITY );
+}
+
+ImageSourceFileCimg::ImageSourceFileCimg( DataSourceRef dataSource, ImageSource::Options options )
+{
+	// files are mapped rather than read, so that uncompressed levels are never copied
+	if( dataSource->isFilePath() ) {
+		auto mappedFile = MemoryMappedFile::create( dataSource->getFilePath() );
+		mData = static_cast<const uint8_t*>( mappedFile->getData() );
+		mDataSize = mappedFile->getSize();
+		mStorage = mappedFile;
+	}
+	else {
+		auto buffer = dataSource->getBuffer();
+		mData = static_cast<const uint8_t*>( buffer->getData() );
+		mDataSize = buffer->getSize();
+		mStorage = buffer;
+	}
+
+	if( mDataSize < HEADER_SIZE || memcmp( mData, "CIMG", 4 ) != 0 )
+		throw ImageSourceFileCimgException( "Not a .cimg file" );
+
+	Header header;
+	header.mVersion = readLittle<uint16_t>( mData + 4 );
+	const size_t headerSize = readLittle<uint16_t>( mData + 6 );
+	header.mWidth = readLittle<uint32_t>( mData + 8 );
+	header.mHeight = readLittle<uint32_t>( mData + 12 );
+	header.mDataType = mData[16];
+	header.mColorModel = mData[17];
+	header.mChannelOrder = mData[18];
+	header.mFlags = mData[19];
+	header.mNumMipLevels = mData[20];
+	header.mCompression = mData[21];
+	header.mRowAlignment = readLittle<uint16_t>( mData + 22 );
+	header.mTileHeight = readLittle<uint32_t>( mData + 24 );
+
+	if( header.mVersion != CIMG_VERSION )
+		throw ImageSourceFileCimgException( "Unsupported .cimg version " + to_string( header.mVersion ) );
+	if( headerSize < HEADER_SIZE || header.mDataType >= ImageIo::DATA_UNKNOWN || header.mColorModel >= ImageIo::CM_UNKNOWN || header.mChannelOrder >= ImageIo::CUSTOM
+		|| header.mNumMipLevels == 0 || header.mCompression > COMPRESSION_DEFLATE || ( header.mCompression == COMPRESSION_DEFLATE && header.mTileHeight == 0 )
+		|| header.mTileHeight > (uint32_t)std::numeric_limits<int32_t>::max() )
+		throw ImageSourceFileCimgException( "Corrupt .cimg header" );
+	if( headerSize + header.mNumMipLevels * LEVEL_RECORD_SIZE > mDataSize )
+		throw ImageSourceFileCimgException( "Truncated .cimg file" );
+
+	setDataType( (ImageIo::DataType)header.mDataType );
+	setColorModel( (ImageIo::ColorModel)header.mColorModel );
+	setChannelOrder( (ImageIo::ChannelOrder)header.mChannelOrder );
+	setPremultiplied( ( header.mFlags & FLAG_PREMULTIPLIED ) != 0 );
+	mTileHeight = (int32_t)header.mTileHeight;
+
+	const size_t pixelBytes = ImageIo::dataTypeBytes( mDataType ) * (size_t)ImageIo::channelOrderNumChannels( mChannelOrder );
+	for( uint8_t l = 0; l < header.mNumMipLevels; ++l ) {
+		const uint8_t *record = mData + headerSize + l * LEVEL_RECORD_SIZE;
+		Level level;
+		level.mWidth = (int32_t)readLittle<uint32_t>( record );
+		level.mHeight = (int32_t)readLittle<uint32_t>( record + 4 );
+		level.mNumTiles = readLittle<uint32_t>( record + 8 );
+		level.mRowBytes = (size_t)readLittle<uint64_t>( record + 16 );
+		level.mOffset = readLittle<uint64_t>( record + 24 );
+		level.mSize = readLittle<uint64_t>( record + 32 );
+
+		if( level.mWidth <= 0 || level.mHeight <= 0 || level.mRowBytes < level.mWidth * pixelBytes || level.mOffset > mDataSize || level.mSize > mDataSize - level.mOffset )
+			throw ImageSourceFileCimgException( "Corrupt .cimg level " + to_string( l ) );
+		if( level.mNumTiles == 0 ) {
+			if( level.mSize != level.mRowBytes * level.mHeight )
+				throw ImageSourceFileCimgException( "Corrupt .cimg level " + to_string( l ) );
+		}
+		else {
+			// an uncompressed writer leaves the tile height at 0, so it can only be trusted once a level claims tiles
+			if( header.mTileHeight == 0 || level.mNumTiles != ( level.mHeight + header.mTileHeight - 1 ) / header.mTileHeight || level.mSize < level.mNumTiles * TILE_RECORD_SIZE )
+				throw ImageSourceFileCimgException( "Corrupt .cimg level " + to_string( l ) );
+			for( uint32_t t = 0; t < level.mNumTiles; ++t ) {
+				uint64_t tileOffset = readLittle<uint64_t>( mData + level.mOffset + t * TILE_RECORD_SIZE );
+				uint64_t tileSize = readLittle<uint64_t>( mData + level.mOffset + t * TILE_RECORD_SIZE + 8 );
+				if( tileOffset > mDataSize || tileSize > mDataSize - tileOffset )
+					throw ImageSourceFileCimgException( "Corrupt .cimg tile table" );
+			}
+		}
+		mLevels.push_back( level );
+	}
+
+	mLevel = options.getIndex();
+	if( mLevel < 0 || mLevel >= (int32_t)mLevels.size() )
+		throw ImageSourceFileCimgException( "Mip level " + to_string( mLevel ) + " out of range" );
+
+	setSize( mLevels[mLevel].mWidth, mLevels[mLevel].mHeight );
+	setFrameCount( (int32_t)mLevels.size() );
+}
+
+void ImageSourceFileCimg::load( ImageTargetRef target )
+{
+	ImageSource::RowFunc func = setupRowFunc( target );
+	const Level &level = mLevels[mLevel];
+
+	// rows are handed to the target in order from the calling thread, as ImageTargets expect
+	if( level.mNumTiles == 0 ) {
+		const uint8_t *levelData = mData + level.mOffset;
+		for( int32_t row = 0; row < level.mHeight; ++row )
+			((*this).*func)( target, row, levelData + row * level.mRowBytes );
+	}
+	else {
+		// a batch of bands decompresses in parallel, each into its own scratch buffer, before its rows are emitted
+		const size_t tileBytes = level.mRowBytes * std::min( mTileHeight, level.mHeight );
+		const size_t batchSize = std::min<size_t>( getNumParallelThreads() * 2, level.mNumTiles );
+		vector<uint8_t> batchData( batchSize * tileBytes );
+		for( size_t batchBegin = 0; batchBegin < level.mNumTiles; batchBegin += batchSize ) {
+			const size_t batchEnd = std::min<size_t>( batchBegin + batchSize, level.mNumTiles );
+			parallelFor( batchEnd - batchBegin, [&]( size_t begin, size_t end ) {
+				for( size_t t = batchBegin + begin; t < batchBegin + end; ++t ) {
+					const uint8_t *record = mData + level.mOffset + t * TILE_RECORD_SIZE;
+					const uint64_t tileOffset = readLittle<uint64_t>( record );
+					const uint64_t tileSize = readLittle<uint64_t>( record + 8 );
+					const int32_t numRows = std::min( mTileHeight, level.mHeight - (int32_t)t * mTileHeight );
+					uLongf decompressedSize = (uLongf)( numRows * level.mRowBytes );
+					int err = uncompress( &batchData[( t - batchBegin ) * tileBytes], &decompressedSize, mData + tileOffset, (uLong)tileSize );
+					if( err != Z_OK || decompressedSize != numRows * level.mRowBytes )
+						throw ImageSourceFileCimgException( "Failed to decompress .cimg tile " + to_string( t ) );
+				}
+			} );
+
+			const int32_t firstRow = (int32_t)batchBegin * mTileHeight;
+			const int32_t endRow = (int32_t)std::min<int64_t>( (int64_t)batchEnd * mTileHeight, level.mHeight );
+			for( int32_t row = firstRow; row < endRow; ++row )
+				((*this).*func)( target, row, &batchData[( row - firstRow ) * level.mRowBytes] );
+		}
+	}
+}
+
+bool ImageSourceFileCimg::isMappable( int32_t level ) const
+{
+	return level >= 0 && level < (int32_t)mLevels.size() && mLevels[level].mNumTiles == 0;
+}
+
+const uint8_t* ImageSourceFileCimg::getLevelData( int32_t level, ImageIo::DataType dataType ) const
+{
+	if( ! isMappable( level ) )
+		throw ImageSourceFileCimgException( "Mip level " + to_string( level ) + " is compressed or out of range and cannot be referenced in place" );
+	if( getDataType() != dataType )
+		throw ImageSourceFileCimgException( "Requested type does not match the data type of the .cimg file" );
+	return mData + mLevels[level].mOffset;
+}
+
+template<typename T>
+std::shared_ptr<SurfaceT<T>> ImageSourceFileCimg::createSurfaceRef( int32_t level ) const
+{
+	const ImageIo::DataType dataType = std::is_same<T, uint8_t>::value ? ImageIo::UINT8 : ( std::is_same<T, uint16_t>::value ? ImageIo::UINT16 : ImageIo::FLOAT32 );
+	const uint8_t *data = getLevelData( level, dataType );
+	if( getColorModel() != ImageIo::CM_RGB )
+		throw ImageSourceFileCimgException( "createSurfaceRef() requires an RGB .cimg file" );
+
+	// SurfaceChannelOrder codes match ImageIo::ChannelOrder for every RGB order
+	const Level &l = mLevels[level];
+	auto storage = mStorage;
+	auto result = std::shared_ptr<SurfaceT<T>>( new SurfaceT<T>( reinterpret_cast<T*>( const_cast<uint8_t*>( data ) ), l.mWidth, l.mHeight, l.mRowBytes, SurfaceChannelOrder( getChannelOrder() ) ),
+									[storage]( SurfaceT<T> *surface ) { delete surface; } );
+	result->setPremultiplied( isPremultiplied() );
+	return result;
+}
+
+template<typename T>
+std::shared_ptr<ChannelT<T>> ImageSourceFileCimg::createChannelRef( int32_t level ) const
+{
+	const ImageIo::DataType dataType = std::is_same<T, uint8_t>::value ? ImageIo::UINT8 : ( std::is_same<T, uint16_t>::value ? ImageIo::UINT16 : ImageIo::FLOAT32 );
+	const uint8_t *data = getLevelData( level, dataType );
+	if( getColorModel() != ImageIo::CM_GRAY )
+		throw ImageSourceFileCimgException( "createChannelRef() requires a gray .cimg file" );
+
+	// the Channel's dataStore aliases the storage so that the mapping outlives it
+	const Level &l = mLevels[level];
+	T *channelData = reinterpret_cast<T*>( const_cast<uint8_t*>( data ) );
+	std::shared_ptr<T> dataStore( mStorage, channelData );
+	return std::make_shared<ChannelT<T>>( l.mWidth, l.mHeight, l.mRowBytes, (uint8_t)ImageIo::channelOrderNumChannels( getChannelOrder() ), channelData, dataStore );
+}
+
+template CI_API std::shared_ptr<SurfaceT<uint8_t>> ImageSourceFileCimg::createSurfaceRef<uint8_t>( int32_t ) const;
+template CI_API std::shared_ptr<SurfaceT<uint16_t>> ImageSourceFileCimg::createSurfaceRef<uint16_t>( int32_t ) const;
+template CI_API std::shared_ptr<SurfaceT<float>> ImageSourceFileCimg::createSurfaceRef<float>( int32_t ) const;
+template CI_API std::shared_ptr<ChannelT<uint8_t>> ImageSourceFileCimg::createChannelRef<uint8_t>( int32_t ) const;
+template CI_API std::shared_ptr<ChannelT<uint16_t>> ImageSourceFileCimg::createChannelRef<uint16_t>( int32_t ) const;
+template CI_API std::shared_ptr<ChannelT<float>> ImageSourceFileCimg::createChannelRef<float>( int32_t ) const;
+
+///////////////////////////////////////////////////////////////////////////////
+// ImageTargetFileCimg
+void ImageTargetFileCimg::registerSelf()
+{
+	static bool sRegistered = false;
+	const int32_t PRIORITY = 1;
+
+	if( sRegistered )
+		return;
+
+	sRegistered = true;
+
+	ImageIoRegistrar::TargetCreationFunc func = ImageTargetFileCimg::create;
+	ImageIoRegistrar::registerTargetType( "cimg", func, PRIORITY, "cimg" );
+}
+
+ImageTargetRef ImageTargetFileCimg::create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string & /*extensionData*/ )
+{
+	return ImageTargetRef( new ImageTargetFileCimg( dataTarget, imageSource, options, CimgOptions() ) );
+}
+
+ImageTargetRef ImageTargetFileCimg::create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string & /*extensionData*/, const CimgOptions &cimgOptions )
+{
+	return ImageTargetRef( new ImageTargetFileCimg( dataTarget, imageSource, options, cimgOptions ) );
+}
+
+ImageTargetFileCimg::ImageTargetFileCimg( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const CimgOptions &cimgOptions )
+	: mDataTarget( dataTarget ), mCimgOptions( cimgOptions ), mPremultiplied( imageSource->isPremultiplied() )
+{
+	const size_t alignment = mCimgOptions.getRowAlignment();
+	if( alignment == 0 || ( alignment & ( alignment - 1 ) ) != 0 || alignment > LEVEL_DATA_ALIGNMENT )
+		throw ImageIoExceptionFailedWrite( "ImageTargetFileCimg row alignment must be a power of two no larger than 64" );
+	if( mCimgOptions.getCompress() && mCimgOptions.getTileHeight() <= 0 )
+		throw ImageIoExceptionFailedWrite( "ImageTargetFileCimg tile height must be positive" );
+
+	setSize( imageSource->getWidth(), imageSource->getHeight() );
+
+	// the source's layout is preserved whenever it is representable, so that loading is a straight copy
+	ImageIo::ColorModel cm = options.isColorModelDefault() ? imageSource->getColorModel() : options.getColorModel();
+	if( cm == ImageIo::CM_UNKNOWN )
+		cm = ImageIo::CM_RGB;
+	setColorModel( cm );
+	if( cm == imageSource->getColorModel() && imageSource->getChannelOrder() != ImageIo::CUSTOM )
+		setChannelOrder( imageSource->getChannelOrder() );
+	else if( cm == ImageIo::CM_RGB )
+		setChannelOrder( imageSource->hasAlpha() ? ImageIo::RGBA : ImageIo::RGB );
+	else
+		setChannelOrder( imageSource->hasAlpha() ? ImageIo::YA : ImageIo::Y );
+
+	setDataType( ( imageSource->getDataType() == ImageIo::DATA_UNKNOWN ) ? ImageIo::UINT8 : imageSource->getDataType() );
+
+	const size_t pixelBytes = ImageIo::dataTypeBytes( getDataType() ) * (size_t)ImageIo::channelOrderNumChannels( getChannelOrder() );
+	mRowBytes = alignUp( mWidth * pixelBytes, alignment );
+	mData.resize( mRowBytes * mHeight );
+}
+
+void* ImageTargetFileCimg::getRowPointer( int32_t row )
+{
+	return &mData[row * mRowBytes];
+}
+
+void ImageTargetFileCimg::finalize()
+{
+	struct LevelData {
+		int32_t				mWidth, mHeight;
+		size_t				mRowBytes;
+		vector<uint8_t>		mPixels;
+		vector<vector<uint8_t>>	mTiles;
+	};
+
+	const int numComponents = ImageIo::channelOrderNumChannels( getChannelOrder() );
+	const size_t pixelBytes = ImageIo::dataTypeBytes( getDataType() ) * numComponents;
+
+	vector<LevelData> levels( 1 );
+	levels[0].mWidth = mWidth;
+	levels[0].mHeight = mHeight;
+	levels[0].mRowBytes = mRowBytes;
+	levels[0].mPixels = std::move( mData );
+
+	if( mCimgOptions.getMipmap() ) {
+		while( levels.back().mWidth > 1 || levels.back().mHeight > 1 ) {
+			const LevelData &src = levels.back();
+			LevelData dst;
+			dst.mWidth = std::max( src.mWidth / 2, 1 );
+			dst.mHeight = std::max( src.mHeight / 2, 1 );
+			dst.mRowBytes = alignUp( dst.mWidth * pixelBytes, mCimgOptions.getRowAlignment() );
+			dst.mPixels.resize( dst.mRowBytes * dst.mHeight );
+			switch( getDataType() ) {
+				case ImageIo::UINT8: downsample<uint8_t>( src.mPixels.data(), src.mWidth, src.mHeight, src.mRowBytes, dst.mPixels.data(), dst.mWidth, dst.mHeight, dst.mRowBytes, numComponents ); break;
+				case ImageIo::UINT16: downsample<uint16_t>( src.mPixels.data(), src.mWidth, src.mHeight, src.mRowBytes, dst.mPixels.data(), dst.mWidth, dst.mHeight, dst.mRowBytes, numComponents ); break;
+				case ImageIo::FLOAT32: downsample<float>( src.mPixels.data(), src.mWidth, src.mHeight, src.mRowBytes, dst.mPixels.data(), dst.mWidth, dst.mHeight, dst.mRowBytes, numComponents ); break;
+				default: downsample<half_float>( src.mPixels.data(), src.mWidth, src.mHeight, src.mRowBytes, dst.mPixels.data(), dst.mWidth, dst.mHeight, dst.mRowBytes, numComponents ); break;
+			}
+			levels.push_back( std::move( dst ) );
+		}
+	}
+
+	const int32_t tileHeight = mCimgOptions.getTileHeight();
+	if( mCimgOptions.getCompress() ) {
+		for( auto &level : levels ) {
+			level.mTiles.resize( ( level.mHeight + tileHeight - 1 ) / tileHeight );
+			parallelFor( level.mTiles.size(), [&]( size_t begin, size_t end ) {
+				for( size_t t = begin; t < end; ++t ) {
+					const int32_t firstRow = (int32_t)t * tileHeight;
+					const size_t srcSize = std::min( tileHeight, level.mHeight - firstRow ) * level.mRowBytes;
+					uLongf dstSize = compressBound( (uLong)srcSize );
+					level.mTiles[t].resize( dstSize );
+					// favor decode speed over ratio, as with LZ4-class codecs
+					if( compress2( level.mTiles[t].data(), &dstSize, level.mPixels.data() + firstRow * level.mRowBytes, (uLong)srcSize, Z_BEST_SPEED ) != Z_OK )
+						throw ImageIoExceptionFailedWrite( "Failed to compress .cimg tile" );
+					level.mTiles[t].resize( dstSize );
+				}
+			} );
+			level.mPixels = vector<uint8_t>();
+		}
+	}
+
+	// lay out the file: header, level table, then each level aligned for direct mapping
+	const size_t tableEnd = HEADER_SIZE + levels.size() * LEVEL_RECORD_SIZE;
+	vector<uint8_t> table( tableEnd, 0 );
+	memcpy( table.data(), "CIMG", 4 );
+	writeLittle<uint16_t>( &table[4], CIMG_VERSION );
+	writeLittle<uint16_t>( &table[6], (uint16_t)HEADER_SIZE );
+	writeLittle<uint32_t>( &table[8], (uint32_t)mWidth );
+	writeLittle<uint32_t>( &table[12], (uint32_t)mHeight );
+	table[16] = (uint8_t)getDataType();
+	table[17] = (uint8_t)getColorModel();
+	table[18] = (uint8_t)getChannelOrder();
+	table[19] = mPremultiplied ? FLAG_PREMULTIPLIED : 0;
+	table[20] = (uint8_t)levels.size(); // 31 at most, since halving a dimension of 2^31 - 1 reaches 1 after 30 steps
+	table[21] = mCimgOptions.getCompress() ? COMPRESSION_DEFLATE : COMPRESSION_NONE;
+	writeLittle<uint16_t>( &table[22], (uint16_t)mCimgOptions.getRowAlignment() );
+	writeLittle<uint32_t>( &table[24], mCimgOptions.getCompress() ? (uint32_t)tileHeight : 0 );
+
+	vector<size_t> levelOffsets;
+	size_t offset = tableEnd;
+	for( size_t l = 0; l < levels.size(); ++l ) {
+		const LevelData &level = levels[l];
+		offset = alignUp( offset, LEVEL_DATA_ALIGNMENT );
+		size_t levelSize = level.mTiles.size() * TILE_RECORD_SIZE;
+		for( const auto &tile : level.mTiles )
+			levelSize += tile.size();
+		if( level.mTiles.empty() )
+			levelSize = level.mPixels.size();
+
+		uint8_t *record = &table[HEADER_SIZE + l * LEVEL_RECORD_SIZE];
+		writeLittle<uint32_t>( record, (uint32_t)level.mWidth );
+		writeLittle<uint32_t>( record + 4, (uint32_t)level.mHeight );
+		writeLittle<uint32_t>( record + 8, (uint32_t)level.mTiles.size() );
+		writeLittle<uint64_t>( record + 16, (uint64_t)level.mRowBytes );
+		writeLittle<uint64_t>( record + 24, (uint64_t)offset );
+		writeLittle<uint64_t>( record + 32, (uint64_t)levelSize );
+		levelOffsets.push_back( offset );
+		offset += levelSize;
+	}
+
+	OStreamRef stream = mDataTarget->getStream();
+	stream->writeData( table.data(), table.size() );
+	size_t written = table.size();
+	const uint8_t padding[LEVEL_DATA_ALIGNMENT] = { 0 };
+	for( size_t l = 0; l < levels.size(); ++l ) {
+		const LevelData &level = levels[l];
+		stream->writeData( padding, levelOffsets[l] - written );
+		written = levelOffsets[l];
+		if( level.mTiles.empty() ) {
+			stream->writeData( level.mPixels.data(), level.mPixels.size() );
+			written += level.mPixels.size();
+		}
+		else {
+			vector<uint8_t> tileTable( level.mTiles.size() * TILE_RECORD_SIZE );
+			size_t tileOffset = written + tileTable.size();
+			for( size_t t = 0; t < level.mTiles.size(); ++t ) {
+				writeLittle<uint64_t>( &tileTable[t * TILE_RECORD_SIZE], (uint64_t)tileOffset );
+				writeLittle<uint64_t>( &tileTable[t * TILE_RECORD_SIZE + 8], (uint64_t)level.mTiles[t].size() );
+				tileOffset += level.mTiles[t].size();
+			}
+			stream->writeData( tileTable.data(), tileTable.size() );
+			for( const auto &tile : level.mTiles )
+				stream->writeData( tile.data(), tile.size() );
+			written = tileOffset;
+		}
+	}
+}
+
+} // namespace cinder
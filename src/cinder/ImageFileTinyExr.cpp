@@ -23,6 +23,7 @@
 
 #include "cinder/ImageFileTinyExr.h"
 #include "cinder/Log.h"
+#include "cinder/Thread.h"
 
 #include "tinyexr/tinyexr.h"
 
@@ -30,13 +31,86 @@ using namespace std;
 
 namespace cinder {
 
+namespace {
+
+// Returns the size in bytes of a single sample of tinyexr pixel type \a pixelType
+size_t exrPixelTypeBytes( int pixelType )
+{
+	return ( pixelType == TINYEXR_PIXELTYPE_HALF ) ? sizeof(uint16_t) : sizeof(float);
+}
+
+// Interleaves rows [rowBegin, rowEnd) of the planar \a planes, which are \a width wide, into consecutive rows of \a dst
+template<typename T>
+void interleaveRows( const vector<const T*> &planes, int32_t width, int32_t rowBegin, int32_t rowEnd, T *dst )
+{
+	const size_t numComponents = planes.size();
+	for( int32_t row = rowBegin; row < rowEnd; ++row ) {
+		const size_t planeOffset = row * (size_t)width;
+		for( size_t c = 0; c < numComponents; ++c ) {
+			const T *src = planes[c] + planeOffset;
+			T *rowDst = dst + c;
+			for( int32_t col = 0; col < width; ++col, rowDst += numComponents )
+				*rowDst = src[col];
+		}
+		dst += width * numComponents;
+	}
+}
+
+// Interleaves \a planes in parallel, a band of rows at a time, and hands the rows to \a rowFunc in order from the calling thread, as ImageTargets expect
+template<typename T>
+void emitRows( const vector<const uint8_t*> &planes, int32_t width, int32_t height, const std::function<void( int32_t, const void* )> &rowFunc )
+{
+	const int32_t BAND_HEIGHT = 64;
+	vector<const T*> typedPlanes;
+	for( auto plane : planes )
+		typedPlanes.push_back( reinterpret_cast<const T*>( plane ) );
+
+	const size_t rowSize = width * planes.size();
+	vector<T> band( rowSize * std::min( BAND_HEIGHT, height ) );
+	for( int32_t bandBegin = 0; bandBegin < height; bandBegin += BAND_HEIGHT ) {
+		const int32_t bandEnd = std::min( bandBegin + BAND_HEIGHT, height );
+		parallelFor( bandEnd - bandBegin, [&]( size_t rowBegin, size_t rowEnd ) {
+			interleaveRows( typedPlanes, width, bandBegin + (int32_t)rowBegin, bandBegin + (int32_t)rowEnd, band.data() + rowBegin * rowSize );
+		}, 8 );
+
+		for( int32_t row = bandBegin; row < bandEnd; ++row )
+			rowFunc( row, band.data() + ( row - bandBegin ) * rowSize );
+	}
+}
+
+// Splits interleaved \a data into \a numComponents planes
+template<typename T>
+vector<vector<T>> deinterleave( const T *data, int32_t width, int32_t height, size_t numComponents )
+{
+	vector<vector<T>> planes( numComponents, vector<T>( width * (size_t)height ) );
+	parallelFor( height, [&]( size_t rowBegin, size_t rowEnd ) {
+		for( size_t c = 0; c < numComponents; ++c ) {
+			for( size_t row = rowBegin; row < rowEnd; ++row ) {
+				const T *src = data + row * width * numComponents + c;
+				T *dst = planes[c].data() + row * width;
+				for( int32_t col = 0; col < width; ++col, src += numComponents )
+					dst[col] = *src;
+			}
+		}
+	}, 16 );
+
+	return planes;
+}
+
+} // anonymous namespace
+
 // ----------------------------------------------------------------------------------------------------
 // ImageSourceFileTinyExr
 // ----------------------------------------------------------------------------------------------------
 
 ImageSourceRef ImageSourceFileTinyExr::create( DataSourceRef dataSourceRef, ImageSource::Options options )
 {
-	return ImageSourceRef( new ImageSourceFileTinyExr( dataSourceRef, options ) );
+	return ImageSourceRef( new ImageSourceFileTinyExr( dataSourceRef, options, ExrOptions() ) );
+}
+
+ImageSourceRef ImageSourceFileTinyExr::create( DataSourceRef dataSourceRef, ImageSource::Options options, const ExrOptions &exrOptions )
+{
+	return ImageSourceRef( new ImageSourceFileTinyExr( dataSourceRef, options, exrOptions ) );
 }
 
 void ImageSourceFileTinyExr::registerSelf()
@@ -45,70 +119,103 @@ void ImageSourceFileTinyExr::registerSelf()
 	ImageIoRegistrar::registerSourceType( "exr", sourceFunc, 1 ); // lower is higher priority
 }
 
-ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageSource::Options /*options*/ )
-	: mExrHeader( new EXRHeader, FreeEXRHeader ) // We're using the provided FreeEXRHeader function as a custom deleter
-	, mExrImage( new EXRImage, FreeEXRImage )    // We're using the provided FreeEXRImage function as a custom deleter
+ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageSource::Options /*options*/, const ExrOptions &exrOptions )
+	: mDataSource( dataSource )
+	, mExrHeader( new EXRHeader, FreeEXRHeader ) // We're using the provided FreeEXRHeader function as a custom deleter
 {
 	InitEXRHeader( mExrHeader.get() );
-	InitEXRImage( mExrImage.get() );
 
 	int status = 0;
+	const char *error;
 
 	EXRVersion version;
-	status = ParseEXRVersionFromFile( &version, dataSource->getFilePath().string().c_str() );
-	if( status != TINYEXR_SUCCESS )
-		throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR version" ) );
-
-	if( version.multipart || version.non_image )
-		throw ImageIoExceptionFailedLoadTinyExr( string( "Multipart or DeepImage EXR's are not supported yet" ) );
-
 	if( dataSource->isFilePath() ) {
 		const string filename = dataSource->getFilePath().string();
 
-		const char *error;
-		status = ParseEXRHeaderFromFile( mExrHeader.get(), &version, filename.c_str(), &error );
+		status = ParseEXRVersionFromFile( &version, filename.c_str() );
 		if( status != TINYEXR_SUCCESS )
-			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR header; Error message: " ) + error );
+			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR version" ) );
+		if( version.multipart || version.non_image )
+			throw ImageIoExceptionFailedLoadTinyExr( string( "Multipart or DeepImage EXR's are not supported yet" ) );
 
-		status = LoadEXRImageFromFile( mExrImage.get(), mExrHeader.get(), filename.c_str(), &error );
-		if( status != TINYEXR_SUCCESS )
-			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR file; Error message: " ) + error );
+		status = ParseEXRHeaderFromFile( mExrHeader.get(), &version, filename.c_str(), &error );
 	}
 	else {
 		const auto memory = static_cast<const unsigned char *>( dataSource->getBuffer()->getData() );
 
-		const char *error;
-		status = ParseEXRHeaderFromMemory( mExrHeader.get(), &version, memory, &error );
-		if( status != TINYEXR_SUCCESS )
-			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR header; Error message: " ) + error );
-		
-		status = LoadEXRImageFromMemory( mExrImage.get(), mExrHeader.get(), memory, &error );
+		status = ParseEXRVersionFromMemory( &version, memory );
 		if( status != TINYEXR_SUCCESS )
-			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR file; Error message: " ) + error );
+			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR version" ) );
+		if( version.multipart || version.non_image )
+			throw ImageIoExceptionFailedLoadTinyExr( string( "Multipart or DeepImage EXR's are not supported yet" ) );
+
+		status = ParseEXRHeaderFromMemory( mExrHeader.get(), &version, memory, &error );
 	}
 
-	// verify that the channels are all the same size; currently we don't support variably sized channels
-	const int pixelType = mExrHeader->pixel_types[0];
-	for( int c = 1; c < mExrHeader->num_channels; ++c ) {
-		if( pixelType != mExrHeader->pixel_types[c] )
-			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: heterogneous channel data types not supported" );
+	if( status != TINYEXR_SUCCESS )
+		throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR header; Error message: " ) + error );
+
+	for( int c = 0; c < mExrHeader->num_channels; ++c )
+		mChannelNames.push_back( mExrHeader->channels[c].name );
+
+	auto findChannel = [this]( const string &name ) {
+		auto it = find( mChannelNames.begin(), mChannelNames.end(), name );
+		return ( it == mChannelNames.end() ) ? -1 : (int)( it - mChannelNames.begin() );
+	};
+
+	// select the channels that make up the image, either explicitly or by looking for R, G, B, (A) or Y, (A) within the requested layer
+	if( ! exrOptions.getChannels().empty() ) {
+		if( exrOptions.getChannels().size() > 4 )
+			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: at most 4 channels may be selected" );
+		for( const auto &name : exrOptions.getChannels() ) {
+			int index = findChannel( name );
+			if( index < 0 )
+				throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: no channel named '" + name + "'" );
+			mSelectedChannels.push_back( index );
+		}
+	}
+	else {
+		const string prefix = exrOptions.getLayer().empty() ? string() : exrOptions.getLayer() + ".";
+		int red = findChannel( prefix + "R" ), green = findChannel( prefix + "G" ), blue = findChannel( prefix + "B" );
+		int alpha = findChannel( prefix + "A" ), gray = findChannel( prefix + "Y" );
+		if( gray >= 0 )
+			mSelectedChannels = { gray };
+		else if( red >= 0 && green >= 0 && blue >= 0 )
+			mSelectedChannels = { red, green, blue };
+		else
+			throw ImageIoExceptionFailedLoadTinyExr( "Unable to locate channels for Y or RGB" );
+		if( alpha >= 0 )
+			mSelectedChannels.push_back( alpha );
 	}
 
-	switch( pixelType ) {
-		case TINYEXR_PIXELTYPE_HALF:
-			setDataType( ImageIo::FLOAT16 );
-			break;
-		case TINYEXR_PIXELTYPE_FLOAT:
-			setDataType( ImageIo::FLOAT32 );
-			break;
-		default:
-			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: Unknown data type" );
-			break;
+	// half-float data is preserved when all selected channels are half; mixed channels are all promoted to float
+	bool allHalf = true;
+	for( int c : mSelectedChannels ) {
+		if( mExrHeader->pixel_types[c] == TINYEXR_PIXELTYPE_UINT )
+			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: UINT channels are not supported" );
+		allHalf = allHalf && ( mExrHeader->pixel_types[c] == TINYEXR_PIXELTYPE_HALF );
+	}
+
+	if( allHalf )
+		setDataType( ImageIo::FLOAT16 );
+	else {
+		setDataType( ImageIo::FLOAT32 );
+		for( int c : mSelectedChannels )
+			mExrHeader->requested_pixel_types[c] = TINYEXR_PIXELTYPE_FLOAT;
 	}
 
-	setSize( mExrImage->width, mExrImage->height );
+	const Area dataWindow( 0, 0, mExrHeader->data_window[2] - mExrHeader->data_window[0] + 1, mExrHeader->data_window[3] - mExrHeader->data_window[1] + 1 );
+	mArea = exrOptions.getArea();
+	if( mArea.calcArea() <= 0 )
+		mArea = dataWindow;
+	else
+		mArea.clipBy( dataWindow );
+	if( mArea.calcArea() <= 0 )
+		throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: requested area lies outside of the data window" );
 
-	switch( mExrImage->num_channels ) {
+	setSize( mArea.getWidth(), mArea.getHeight() );
+
+	switch( mSelectedChannels.size() ) {
 		case 1:
 			setColorModel( ImageIo::CM_GRAY );
 			setChannelOrder( ImageIo::ChannelOrder::Y );
@@ -121,96 +228,98 @@ ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageS
 			setColorModel( ImageIo::CM_RGB );
 			setChannelOrder( ImageIo::ChannelOrder::RGB );
 			break;
-		case 4:
+		default:
 			setColorModel( ImageIo::CM_RGB );
 			setChannelOrder( ImageIo::ChannelOrder::RGBA );
 			break;
-		default:
-			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: Unsupported number of channels (" + to_string( mExrImage->num_channels ) + ")" );
 	}
 }
 
-void ImageSourceFileTinyExr::load( ImageTargetRef target )
+vector<string> ImageSourceFileTinyExr::getLayerNames() const
 {
-	ImageSource::RowFunc rowFunc = setupRowFunc( target );
-
-	const size_t numChannels = mExrHeader->num_channels;
-	const void * red = nullptr, *green = nullptr, *blue = nullptr, *alpha = nullptr;
-	const void * gray = nullptr;
-
-	for( size_t c = 0; c < numChannels; ++c ) {
-		if( strcmp( mExrHeader->channels[c].name, "R" ) == 0 )
-			red = mExrImage->images[c];
-		else if( strcmp( mExrHeader->channels[c].name, "G" ) == 0 )
-			green = mExrImage->images[c];
-		else if( strcmp( mExrHeader->channels[c].name, "B" ) == 0 )
-			blue = mExrImage->images[c];
-		else if( strcmp( mExrHeader->channels[c].name, "A" ) == 0 )
-			alpha = mExrImage->images[c];
-		else if( strcmp( mExrHeader->channels[c].name, "Y" ) == 0 )
-			gray = mExrImage->images[c];
+	vector<string> result;
+	for( const auto &name : mChannelNames ) {
+		size_t dot = name.rfind( '.' );
+		string layer = ( dot == string::npos ) ? string() : name.substr( 0, dot );
+		if( find( result.begin(), result.end(), layer ) == result.end() )
+			result.push_back( layer );
 	}
 
-	if( ( !gray ) && ( ( !red ) || ( !green ) || ( !blue ) ) )
-		throw ImageIoExceptionFailedLoadTinyExr( "Unable to locate channels for Y or RGB" );
-
-	if( gray ) {
-		if( getDataType() == ImageIo::FLOAT32 ) {
-			vector<float> rowData( mWidth * mExrImage->num_channels, 0 );
-			for( int32_t row = 0; row < mHeight; row++ ) {
-				for( int32_t col = 0; col < mWidth; col++ ) {
-					rowData.at( col * numChannels + 0 ) = static_cast<const float *>( gray )[row * mWidth + col];
-					if( alpha )
-						rowData.at( col * numChannels + 1 ) = static_cast<const float *>( alpha )[row * mWidth + col];
-				}
+	return result;
+}
 
-				( ( *this ).*rowFunc )( target, row, rowData.data() );
-			}
-		}
-		else { // float16
-			vector<uint16_t> rowData( mWidth * mExrImage->num_channels, 0 );
-			for( int32_t row = 0; row < mHeight; row++ ) {
-				for( int32_t col = 0; col < mWidth; col++ ) {
-					rowData.at( col * numChannels + 0 ) = static_cast<const uint16_t *>( gray )[row * mWidth + col];
-					if( alpha )
-						rowData.at( col * numChannels + 1 ) = static_cast<const float *>( alpha )[row * mWidth + col];
-				}
+void ImageSourceFileTinyExr::load( ImageTargetRef target )
+{
+	ImageSource::RowFunc rowFunc = setupRowFunc( target );
 
-				( ( *this ).*rowFunc )( target, row, rowData.data() );
+	// decode; tinyexr distributes scanline blocks or tiles across threads, skipping unselected channels and blocks or tiles outside of mArea
+	vector<unsigned char> requestedChannels( mExrHeader->num_channels, 0 );
+	for( int c : mSelectedChannels )
+		requestedChannels[c] = 1;
+	mExrHeader->requested_channels = requestedChannels.data();
+	mExrHeader->has_requested_window = 1;
+	mExrHeader->requested_window[0] = mArea.x1;
+	mExrHeader->requested_window[1] = mArea.y1;
+	mExrHeader->requested_window[2] = mArea.x2 - 1;
+	mExrHeader->requested_window[3] = mArea.y2 - 1;
+
+	std::unique_ptr<EXRImage, std::function<int( EXRImage * )>> exrImage( new EXRImage, FreeEXRImage );
+	InitEXRImage( exrImage.get() );
+
+	int status;
+	const char *error;
+	if( mDataSource->isFilePath() )
+		status = LoadEXRImageFromFile( exrImage.get(), mExrHeader.get(), mDataSource->getFilePath().string().c_str(), &error );
+	else
+		status = LoadEXRImageFromMemory( exrImage.get(), mExrHeader.get(), static_cast<const unsigned char *>( mDataSource->getBuffer()->getData() ), &error );
+	mExrHeader->requested_channels = nullptr;
+	if( status != TINYEXR_SUCCESS )
+		throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR file; Error message: " ) + error );
+
+	const size_t sampleBytes = ImageIo::dataTypeBytes( getDataType() );
+	const int32_t areaWidth = mArea.getWidth(), areaHeight = mArea.getHeight();
+
+	// gather one plane per selected channel, each covering mArea; tinyexr crops scanlines itself, while tiles are clipped and reassembled here
+	vector<const uint8_t*> planes;
+	vector<vector<uint8_t>> assembledPlanes;
+	if( exrImage->tiles ) {
+		assembledPlanes.resize( mSelectedChannels.size(), vector<uint8_t>( areaWidth * (size_t)areaHeight * sampleBytes ) );
+		const int32_t tileWidth = mExrHeader->tile_size_x, tileHeight = mExrHeader->tile_size_y;
+		parallelFor( exrImage->num_tiles, [&]( size_t tileBegin, size_t tileEnd ) {
+			for( size_t t = tileBegin; t < tileEnd; ++t ) {
+				const EXRTile &tile = exrImage->tiles[t];
+				if( ! tile.images ) // outside of mArea
+					continue;
+				const int32_t tileX = tile.offset_x * tileWidth, tileY = tile.offset_y * tileHeight;
+				Area covered( tileX, tileY, tileX + tile.width, tileY + tile.height );
+				covered.clipBy( mArea );
+				if( covered.calcArea() <= 0 )
+					continue;
+				for( size_t c = 0; c < mSelectedChannels.size(); ++c ) {
+					const uint8_t *src = tile.images[mSelectedChannels[c]];
+					for( int32_t y = covered.y1; y < covered.y2; ++y )
+						memcpy( &assembledPlanes[c][( ( y - mArea.y1 ) * (size_t)areaWidth + covered.x1 - mArea.x1 ) * sampleBytes],
+								src + ( ( y - tileY ) * (size_t)tileWidth + covered.x1 - tileX ) * sampleBytes, covered.getWidth() * sampleBytes );
+				}
 			}
-		}
+		} );
+		exrImage.reset();
+		for( const auto &plane : assembledPlanes )
+			planes.push_back( plane.data() );
 	}
 	else {
-		// load one interleaved row at a time
-		if( getDataType() == ImageIo::FLOAT32 ) {
-			vector<float> rowData( mWidth * mExrImage->num_channels, 0 );
-			for( int32_t row = 0; row < mHeight; row++ ) {
-				for( int32_t col = 0; col < mWidth; col++ ) {
-					rowData.at( col * numChannels + 0 ) = static_cast<const float *>( red )[row * mWidth + col];
-					rowData.at( col * numChannels + 1 ) = static_cast<const float *>( green )[row * mWidth + col];
-					rowData.at( col * numChannels + 2 ) = static_cast<const float *>( blue )[row * mWidth + col];
-					if( alpha )
-						rowData.at( col * numChannels + 3 ) = static_cast<const float *>( alpha )[row * mWidth + col];
-				}
+		for( int c : mSelectedChannels )
+			planes.push_back( exrImage->images[c] );
+	}
 
-				( ( *this ).*rowFunc )( target, row, rowData.data() );
-			}
-		}
-		else { // float16
-			vector<uint16_t> rowData( mWidth * mExrImage->num_channels, 0 );
-			for( int32_t row = 0; row < mHeight; row++ ) {
-				for( int32_t col = 0; col < mWidth; col++ ) {
-					rowData.at( col * numChannels + 0 ) = static_cast<const uint16_t *>( red )[row * mWidth + col];
-					rowData.at( col * numChannels + 1 ) = static_cast<const uint16_t *>( green )[row * mWidth + col];
-					rowData.at( col * numChannels + 2 ) = static_cast<const uint16_t *>( blue )[row * mWidth + col];
-					if( alpha )
-						rowData.at( col * numChannels + 3 ) = static_cast<const uint16_t *>( alpha )[row * mWidth + col];
-				}
+	std::function<void( int32_t, const void* )> emitRow = [&]( int32_t row, const void *data ) {
+		( ( *this ).*rowFunc )( target, row, data );
+	};
 
-				( ( *this ).*rowFunc )( target, row, rowData.data() );
-			}
-		}
-	}
+	if( getDataType() == ImageIo::FLOAT16 )
+		emitRows<uint16_t>( planes, areaWidth, areaHeight, emitRow );
+	else
+		emitRows<float>( planes, areaWidth, areaHeight, emitRow );
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -233,10 +342,16 @@ void ImageTargetFileTinyExr::registerSelf()
 
 ImageTargetRef ImageTargetFileTinyExr::create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData )
 {
-	return ImageTargetRef( new ImageTargetFileTinyExr( dataTarget, imageSource, options, extensionData ) );
+	return ImageTargetRef( new ImageTargetFileTinyExr( dataTarget, imageSource, options, extensionData, ExrOptions() ) );
 }
 
-ImageTargetFileTinyExr::ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string & /*extensionData*/ )
+ImageTargetRef ImageTargetFileTinyExr::create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData, const ExrOptions &exrOptions )
+{
+	return ImageTargetRef( new ImageTargetFileTinyExr( dataTarget, imageSource, options, extensionData, exrOptions ) );
+}
+
+ImageTargetFileTinyExr::ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string & /*extensionData*/, const ExrOptions &exrOptions )
+	: mExrOptions( exrOptions )
 {
 	if( ! dataTarget->providesFilePath() ) {
 		throw ImageIoExceptionFailedWrite( "ImageTargetFileTinyExr only supports writing to files." );
@@ -270,36 +385,48 @@ ImageTargetFileTinyExr::ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageS
 			throw ImageIoExceptionIllegalColorModel();
 	}
 
-	// TODO: consider supporting half float and uint types as well
-	setDataType( ImageIo::DataType::FLOAT32 );
-	mData.resize( mHeight * mWidth * mNumComponents );
+	// half-float sources are kept as half in memory, avoiding a float round trip
+	if( imageSource->getDataType() == ImageIo::DataType::FLOAT16 && mExrOptions.getDataType() == ImageIo::DataType::FLOAT16 )
+		setDataType( ImageIo::DataType::FLOAT16 );
+	else
+		setDataType( ImageIo::DataType::FLOAT32 );
+
+	mData.resize( mHeight * mWidth * mNumComponents * (size_t)ImageIo::dataTypeBytes( getDataType() ) );
 }
 
 void *ImageTargetFileTinyExr::getRowPointer( int32_t row )
 {
-	return &mData[row * mWidth * mNumComponents];
+	return &mData[row * mWidth * mNumComponents * (size_t)ImageIo::dataTypeBytes( getDataType() )];
 }
 
 void ImageTargetFileTinyExr::finalize()
 {
 	// turn interleaved data into a series of planar channels
-	vector<Channel32f> channels;
-	channels.reserve( mNumComponents );
-	unsigned char *    imagePtr[4];
-	for( int c = 0; c < mNumComponents; ++c ) {
-		channels.emplace_back( getWidth(), getHeight() );
-		Channel32f srcChannel( getWidth(), getHeight(), mNumComponents * mWidth * sizeof(float), mNumComponents, mData.data() + c );
-		channels.back().copyFrom( srcChannel, srcChannel.getBounds() );
-
-		imagePtr[c] = reinterpret_cast<unsigned char *>( channels[c].getData() );
+	vector<vector<uint16_t>> halfPlanes;
+	vector<vector<float>> floatPlanes;
+	unsigned char *imagePtr[4];
+	int pixelTypes[4], requestedPixelTypes[4];
+	const int requestedPixelType = ( mExrOptions.getDataType() == ImageIo::DataType::FLOAT32 ) ? TINYEXR_PIXELTYPE_FLOAT : TINYEXR_PIXELTYPE_HALF;
+	if( getDataType() == ImageIo::DataType::FLOAT16 ) {
+		halfPlanes = deinterleave( reinterpret_cast<const uint16_t*>( mData.data() ), mWidth, mHeight, mNumComponents );
+		for( int c = 0; c < mNumComponents; ++c ) {
+			imagePtr[c] = reinterpret_cast<unsigned char *>( halfPlanes[c].data() );
+			pixelTypes[c] = TINYEXR_PIXELTYPE_HALF;
+			requestedPixelTypes[c] = requestedPixelType;
+		}
 	}
-
-	int pixelTypes[4], requested_pixel_types[4];
-	for( int i = 0; i < mNumComponents; i++ ) {
-		pixelTypes[i] = TINYEXR_PIXELTYPE_FLOAT;
-		requested_pixel_types[i] = TINYEXR_PIXELTYPE_HALF; // export as half-floats to reduce file size
+	else {
+		floatPlanes = deinterleave( reinterpret_cast<const float*>( mData.data() ), mWidth, mHeight, mNumComponents );
+		for( int c = 0; c < mNumComponents; ++c ) {
+			imagePtr[c] = reinterpret_cast<unsigned char *>( floatPlanes[c].data() );
+			pixelTypes[c] = TINYEXR_PIXELTYPE_FLOAT;
+			requestedPixelTypes[c] = requestedPixelType;
+		}
 	}
 
+	// the interleaved copy is no longer needed
+	mData = vector<uint8_t>();
+
 	std::vector<EXRChannelInfo> info( mNumComponents );
 
 	// create image descriptor
@@ -321,8 +448,8 @@ void ImageTargetFileTinyExr::finalize()
 		strncpy( exrHeader.channels[i].name, mChannelNames[i].data(), mChannelNames[i].size() );
 	}
 	exrHeader.pixel_types = pixelTypes;
-	exrHeader.requested_pixel_types = requested_pixel_types;
-	exrHeader.compression_type = TINYEXR_COMPRESSIONTYPE_NONE; // TODO add option to enable compression
+	exrHeader.requested_pixel_types = requestedPixelTypes;
+	exrHeader.compression_type = mExrOptions.getCompression(); // scanline blocks are compressed in parallel by tinyexr
 
 	const char *error;
 
@@ -0,0 +1,395 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/GeomIo.h"
+#include "cinder/Thread.h"
+
+#include <cmath>
+
+using namespace std;
+
+namespace cinder { namespace geom {
+
+namespace {
+
+//! Cell layers per slab, which is the granularity of both the parallelism and the incremental updates
+const int		SLAB_LAYERS = 4;
+const uint32_t	INVALID = 0xFFFFFFFF;
+const uint32_t	NEXT_SLAB = 0x80000000;
+
+/*! The marching cubes cases, generated by tracing the surface's boundary across the six faces of a cell rather than transcribed. Corner c of a cell lies at
+	offset ( c & 1, ( c >> 1 ) & 1, ( c >> 2 ) & 1 ), and edges 0-3 run along x, 4-7 along y and 8-11 along z. Ambiguous faces always separate their inside
+	corners, which only depends on the face itself, so neighboring cells agree and the surface is watertight. */
+struct MarchingCubesTable {
+	MarchingCubesTable();
+
+	struct Edge {
+		int		mAxis;
+		ivec3	mOffset;
+	};
+
+	Edge		mEdges[12];
+	uint8_t		mNumIndices[256];
+	uint8_t		mIndices[256][36]; // three cell edges per triangle
+};
+
+MarchingCubesTable::MarchingCubesTable()
+{
+	auto cornerIndex = []( const ivec3 &offset ) { return offset.x | ( offset.y << 1 ) | ( offset.z << 2 ); };
+
+	int edgeBetween[8][8];
+	for( int axis = 0; axis < 3; ++axis ) {
+		for( int n = 0; n < 4; ++n ) {
+			ivec3 offset( 0 );
+			offset[( axis + 1 ) % 3] = n & 1;
+			offset[( axis + 2 ) % 3] = n >> 1;
+			const int e = axis * 4 + n;
+			mEdges[e].mAxis = axis;
+			mEdges[e].mOffset = offset;
+			const int c0 = cornerIndex( offset ), c1 = c0 | ( 1 << axis );
+			edgeBetween[c0][c1] = edgeBetween[c1][c0] = e;
+		}
+	}
+
+	// the corners of each face, counterclockwise seen from outside the cell
+	int faces[6][4];
+	for( int axis = 0; axis < 3; ++axis ) {
+		for( int side = 0; side < 2; ++side ) {
+			const ivec2 square[4] = { ivec2( 0, 0 ), ivec2( 1, 0 ), ivec2( 1, 1 ), ivec2( 0, 1 ) };
+			for( int k = 0; k < 4; ++k ) {
+				const ivec2 &uv = square[side ? k : 3 - k];
+				ivec3 offset( 0 );
+				offset[axis] = side;
+				offset[( axis + 1 ) % 3] = uv.x;
+				offset[( axis + 2 ) % 3] = uv.y;
+				faces[axis * 2 + side][k] = cornerIndex( offset );
+			}
+		}
+	}
+
+	for( int mask = 0; mask < 256; ++mask ) {
+		auto inside = [mask]( int corner ) { return ( mask >> corner ) & 1; };
+
+		// On every face the boundary runs from where the traversal enters the inside corners to where it next leaves them,
+		// which orients the triangles counterclockwise around normals pointing outside.
+		int next[12];
+		std::fill( next, next + 12, -1 );
+		for( const auto &face : faces ) {
+			int crossings[4], numCrossings = 0;
+			bool entering[4];
+			for( int k = 0; k < 4; ++k ) {
+				const int c = face[k], d = face[( k + 1 ) % 4];
+				if( inside( c ) != inside( d ) ) {
+					entering[numCrossings] = inside( d ) != 0;
+					crossings[numCrossings++] = edgeBetween[c][d];
+				}
+			}
+			for( int k = 0; k < numCrossings; ++k )
+				if( entering[k] )
+					next[crossings[k]] = crossings[( k + 1 ) % numCrossings];
+		}
+
+		// triangulate each boundary loop as a fan
+		mNumIndices[mask] = 0;
+		bool visited[12] = {};
+		for( int start = 0; start < 12; ++start ) {
+			if( next[start] < 0 || visited[start] )
+				continue;
+			int loop[12], loopSize = 0;
+			for( int e = start; ! visited[e]; e = next[e] ) {
+				visited[e] = true;
+				loop[loopSize++] = e;
+			}
+			for( int k = 1; k + 1 < loopSize; ++k ) {
+				mIndices[mask][mNumIndices[mask]++] = (uint8_t)loop[0];
+				mIndices[mask][mNumIndices[mask]++] = (uint8_t)loop[k];
+				mIndices[mask][mNumIndices[mask]++] = (uint8_t)loop[k + 1];
+			}
+		}
+	}
+}
+
+const MarchingCubesTable& getMarchingCubesTable()
+{
+	static const MarchingCubesTable sTable;
+	return sTable;
+}
+
+vec3 normalizeOrZero( const vec3 &v )
+{
+	const float len2 = length2( v );
+	return len2 > 0 ? v / std::sqrt( len2 ) : vec3( 0 );
+}
+
+} // anonymous namespace
+
+Isosurface::Isosurface( const FieldFn &fieldFn, const AxisAlignedBox &bounds, const ivec3 &resolution )
+	: mFieldFn( fieldFn ), mBounds( bounds ), mResolution( glm::max( resolution, ivec3( 2 ) ) ), mIsoValue( 0 )
+{
+	init();
+}
+
+Isosurface::Isosurface( const std::vector<float> &samples, const AxisAlignedBox &bounds, const ivec3 &resolution )
+	: mBounds( bounds ), mResolution( glm::max( resolution, ivec3( 2 ) ) ), mIsoValue( 0 )
+{
+	init();
+	this->samples( samples );
+}
+
+void Isosurface::init()
+{
+	const int numLayers = mResolution.z - 1;
+	mSlabs.resize( ( numLayers + SLAB_LAYERS - 1 ) / SLAB_LAYERS );
+	for( size_t s = 0; s < mSlabs.size(); ++s ) {
+		mSlabs[s].mBeginLayer = int( s ) * SLAB_LAYERS;
+		mSlabs[s].mEndLayer = std::min( mSlabs[s].mBeginLayer + SLAB_LAYERS, numLayers );
+	}
+	mNumSlabsExtracted = 0;
+	markDirty();
+}
+
+Isosurface& Isosurface::samples( const std::vector<float> &samples )
+{
+	if( samples.size() != size_t( mResolution.x ) * mResolution.y * mResolution.z )
+		throw ExcIllegalSourceDimensions();
+
+	mSamples = samples;
+	mFieldFn = nullptr;
+	return markDirty();
+}
+
+Isosurface& Isosurface::markDirty()
+{
+	for( auto &slab : mSlabs )
+		slab.mDirty = true;
+	mDirty = true;
+	return *this;
+}
+
+Isosurface& Isosurface::markDirty( const AxisAlignedBox &region )
+{
+	// the grid planes holding changed samples
+	const float spacing = mBounds.getSize().z / ( mResolution.z - 1 );
+	const int minPlane = (int)std::floor( ( region.getMin().z - mBounds.getMin().z ) / spacing );
+	const int maxPlane = (int)std::ceil( ( region.getMax().z - mBounds.getMin().z ) / spacing );
+
+	// layer l interpolates planes l and l + 1, with gradients from planes l - 1 to l + 2
+	for( auto &slab : mSlabs ) {
+		if( slab.mBeginLayer <= maxPlane + 1 && slab.mEndLayer > minPlane - 2 ) {
+			slab.mDirty = true;
+			mDirty = true;
+		}
+	}
+	return *this;
+}
+
+void Isosurface::extractSlab( Slab *slab, bool lastSlab ) const
+{
+	const MarchingCubesTable &table = getMarchingCubesTable();
+	const int nx = mResolution.x, ny = mResolution.y, nz = mResolution.z;
+	const int z0 = slab->mBeginLayer, z1 = slab->mEndLayer;
+	const vec3 origin = mBounds.getMin();
+	const vec3 spacing = mBounds.getSize() / vec3( mResolution - ivec3( 1 ) );
+	const size_t planeSize = size_t( nx ) * ny;
+
+	// the slab's planes [z0, z1], plus one on either side for the gradients
+	const int zBegin = std::max( z0 - 1, 0 ), zEnd = std::min( z1 + 2, nz );
+	vector<float> sampled;
+	const float *samples;
+	if( mSamples.empty() ) {
+		sampled.resize( planeSize * ( zEnd - zBegin ) );
+		float *out = sampled.data();
+		for( int k = zBegin; k < zEnd; ++k )
+			for( int j = 0; j < ny; ++j )
+				for( int i = 0; i < nx; ++i )
+					*out++ = mFieldFn( origin + spacing * vec3( i, j, k ) );
+		samples = sampled.data();
+	}
+	else
+		samples = mSamples.data() + planeSize * zBegin;
+
+	auto sample = [&]( int i, int j, int k ) {
+		return samples[( k - zBegin ) * planeSize + size_t( j ) * nx + i];
+	};
+	// central differences, one-sided at the grid's boundary
+	auto gradient = [&]( int i, int j, int k ) {
+		const int i0 = std::max( i - 1, 0 ), i1 = std::min( i + 1, nx - 1 );
+		const int j0 = std::max( j - 1, 0 ), j1 = std::min( j + 1, ny - 1 );
+		const int k0 = std::max( k - 1, 0 ), k1 = std::min( k + 1, nz - 1 );
+		return vec3( ( sample( i1, j, k ) - sample( i0, j, k ) ) / ( ( i1 - i0 ) * spacing.x ),
+					 ( sample( i, j1, k ) - sample( i, j0, k ) ) / ( ( j1 - j0 ) * spacing.y ),
+					 ( sample( i, j, k1 ) - sample( i, j, k0 ) ) / ( ( k1 - k0 ) * spacing.z ) );
+	};
+
+	slab->mPositions.clear();
+	slab->mNormals.clear();
+	slab->mIndices.clear();
+
+	// Every grid edge the surface crosses gets one vertex, shared by the cells around it. The slab owns the x and y edges of its planes [z0, z1) and
+	// the z edges between them; the edges of plane z1 belong to the next slab, except for the last one.
+	const size_t xCount = size_t( nx - 1 ) * ny, planeEdges = xCount + size_t( nx ) * ( ny - 1 );
+	vector<uint32_t> planeVertices( planeEdges * ( z1 - z0 + 1 ), INVALID ), zVertices( planeSize * ( z1 - z0 ), INVALID );
+	auto addVertex = [&]( int i, int j, int k, int axis ) {
+		ivec3 a( i, j, k ), b = a;
+		b[axis] += 1;
+		const float va = sample( a.x, a.y, a.z ), vb = sample( b.x, b.y, b.z );
+		if( ( va < mIsoValue ) == ( vb < mIsoValue ) )
+			return INVALID;
+
+		const float t = ( mIsoValue - va ) / ( vb - va );
+		vec3 position = vec3( a );
+		position[axis] += t;
+		slab->mPositions.push_back( origin + spacing * position );
+		slab->mNormals.push_back( normalizeOrZero( glm::mix( gradient( a.x, a.y, a.z ), gradient( b.x, b.y, b.z ), t ) ) );
+		return uint32_t( slab->mPositions.size() - 1 );
+	};
+
+	const int lastOwnedPlane = lastSlab ? z1 : z1 - 1;
+	for( int k = z0; k <= lastOwnedPlane; ++k ) {
+		uint32_t *plane = &planeVertices[( k - z0 ) * planeEdges];
+		for( int j = 0; j < ny; ++j )
+			for( int i = 0; i + 1 < nx; ++i )
+				plane[j * ( nx - 1 ) + i] = addVertex( i, j, k, 0 );
+		for( int j = 0; j + 1 < ny; ++j )
+			for( int i = 0; i < nx; ++i )
+				plane[xCount + j * nx + i] = addVertex( i, j, k, 1 );
+		if( k < z1 ) {
+			for( int j = 0; j < ny; ++j )
+				for( int i = 0; i < nx; ++i )
+					zVertices[( k - z0 ) * planeSize + j * nx + i] = addVertex( i, j, k, 2 );
+		}
+	}
+
+	for( int k = z0; k < z1; ++k ) {
+		for( int j = 0; j + 1 < ny; ++j ) {
+			for( int i = 0; i + 1 < nx; ++i ) {
+				int mask = 0;
+				for( int c = 0; c < 8; ++c )
+					if( sample( i + ( c & 1 ), j + ( ( c >> 1 ) & 1 ), k + ( c >> 2 ) ) < mIsoValue )
+						mask |= 1 << c;
+
+				for( uint8_t n = 0; n < table.mNumIndices[mask]; ++n ) {
+					const MarchingCubesTable::Edge &edge = table.mEdges[table.mIndices[mask][n]];
+					const int gi = i + edge.mOffset.x, gj = j + edge.mOffset.y, gk = k + edge.mOffset.z;
+					if( edge.mAxis == 2 ) {
+						slab->mIndices.push_back( zVertices[( gk - z0 ) * planeSize + gj * nx + gi] );
+						continue;
+					}
+
+					const size_t planeIndex = ( edge.mAxis == 0 ) ? gj * ( nx - 1 ) + gi : xCount + gj * nx + gi;
+					if( gk == z1 && ! lastSlab )
+						slab->mIndices.push_back( NEXT_SLAB | uint32_t( planeIndex ) );
+					else
+						slab->mIndices.push_back( planeVertices[( gk - z0 ) * planeEdges + planeIndex] );
+				}
+			}
+		}
+	}
+
+	slab->mFirstPlaneVertices.assign( planeVertices.begin(), planeVertices.begin() + planeEdges );
+	slab->mDirty = false;
+}
+
+void Isosurface::update() const
+{
+	if( ! mDirty )
+		return;
+
+	vector<size_t> dirtySlabs;
+	for( size_t s = 0; s < mSlabs.size(); ++s )
+		if( mSlabs[s].mDirty )
+			dirtySlabs.push_back( s );
+	parallelFor( dirtySlabs.size(), [&]( size_t begin, size_t end ) {
+		for( size_t d = begin; d < end; ++d )
+			extractSlab( &mSlabs[dirtySlabs[d]], dirtySlabs[d] + 1 == mSlabs.size() );
+	} );
+	mNumSlabsExtracted = dirtySlabs.size();
+
+	// concatenate the slabs, resolving the references into each next slab's first plane
+	vector<size_t> vertexOffsets( mSlabs.size() + 1, 0 ), indexOffsets( mSlabs.size() + 1, 0 );
+	for( size_t s = 0; s < mSlabs.size(); ++s ) {
+		vertexOffsets[s + 1] = vertexOffsets[s] + mSlabs[s].mPositions.size();
+		indexOffsets[s + 1] = indexOffsets[s] + mSlabs[s].mIndices.size();
+	}
+	mPositions.resize( vertexOffsets.back() );
+	mNormals.resize( vertexOffsets.back() );
+	mIndices.resize( indexOffsets.back() );
+	parallelFor( mSlabs.size(), [&]( size_t begin, size_t end ) {
+		for( size_t s = begin; s < end; ++s ) {
+			const Slab &slab = mSlabs[s];
+			std::copy( slab.mPositions.begin(), slab.mPositions.end(), mPositions.begin() + vertexOffsets[s] );
+			std::copy( slab.mNormals.begin(), slab.mNormals.end(), mNormals.begin() + vertexOffsets[s] );
+			uint32_t *indices = &mIndices[indexOffsets[s]];
+			for( uint32_t index : slab.mIndices ) {
+				if( index & NEXT_SLAB )
+					*indices++ = mSlabs[s + 1].mFirstPlaneVertices[index & ~NEXT_SLAB] + uint32_t( vertexOffsets[s + 1] );
+				else
+					*indices++ = index + uint32_t( vertexOffsets[s] );
+			}
+		}
+	} );
+
+	mDirty = false;
+}
+
+size_t Isosurface::getNumVertices() const
+{
+	std::lock_guard<std::mutex> lock( mCacheMutex );
+	update();
+	return mPositions.size();
+}
+
+size_t Isosurface::getNumIndices() const
+{
+	std::lock_guard<std::mutex> lock( mCacheMutex );
+	update();
+	return mIndices.size();
+}
+
+uint8_t Isosurface::getAttribDims( Attrib attr ) const
+{
+	switch( attr ) {
+		case Attrib::POSITION: return 3;
+		case Attrib::NORMAL: return 3;
+		default:
+			return 0;
+	}
+}
+
+AttribSet Isosurface::getAvailableAttribs() const
+{
+	return { Attrib::POSITION, Attrib::NORMAL };
+}
+
+void Isosurface::loadInto( Target *target, const AttribSet &requestedAttribs ) const
+{
+	std::lock_guard<std::mutex> lock( mCacheMutex );
+	update();
+
+	target->copyAttrib( Attrib::POSITION, 3, 0, (const float*)mPositions.data(), mPositions.size() );
+	if( requestedAttribs.count( Attrib::NORMAL ) )
+		target->copyAttrib( Attrib::NORMAL, 3, 0, (const float*)mNormals.data(), mNormals.size() );
+	target->copyIndices( Primitive::TRIANGLES, mIndices.data(), mIndices.size(), ( mPositions.size() <= 65536 ) ? 2 : 4 );
+}
+
+} } // namespace cinder::geom
@@ -0,0 +1,117 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/MemoryMappedFile.h"
+
+#if defined( CINDER_MSW )
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <cerrno>
+	#include <cstring>
+#endif
+
+namespace cinder {
+
+#if defined( CINDER_MSW )
+
+MemoryMappedFile::MemoryMappedFile( const fs::path &path )
+	: mFilePath( path ), mData( nullptr ), mSize( 0 ), mFileHandle( INVALID_HANDLE_VALUE ), mMappingHandle( nullptr )
+{
+	mFileHandle = ::CreateFileW( path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+	if( mFileHandle == INVALID_HANDLE_VALUE )
+		throw MemoryMappedFileExc( path, "could not open file" );
+
+	LARGE_INTEGER size;
+	if( ! ::GetFileSizeEx( mFileHandle, &size ) ) {
+		::CloseHandle( mFileHandle );
+		throw MemoryMappedFileExc( path, "could not determine file size" );
+	}
+	mSize = (size_t)size.QuadPart;
+	if( mSize == 0 )
+		return;
+
+	mMappingHandle = ::CreateFileMappingW( mFileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr );
+	if( mMappingHandle )
+		mData = ::MapViewOfFile( mMappingHandle, FILE_MAP_COPY, 0, 0, 0 );
+	if( ! mData ) {
+		if( mMappingHandle )
+			::CloseHandle( mMappingHandle );
+		::CloseHandle( mFileHandle );
+		throw MemoryMappedFileExc( path, "could not map file" );
+	}
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	if( mData )
+		::UnmapViewOfFile( mData );
+	if( mMappingHandle )
+		::CloseHandle( mMappingHandle );
+	if( mFileHandle != INVALID_HANDLE_VALUE )
+		::CloseHandle( mFileHandle );
+}
+
+#else
+
+MemoryMappedFile::MemoryMappedFile( const fs::path &path )
+	: mFilePath( path ), mData( nullptr ), mSize( 0 )
+{
+	int fd = ::open( path.c_str(), O_RDONLY );
+	if( fd < 0 )
+		throw MemoryMappedFileExc( path, strerror( errno ) );
+
+	struct stat fileStat;
+	if( ::fstat( fd, &fileStat ) != 0 ) {
+		int error = errno;
+		::close( fd );
+		throw MemoryMappedFileExc( path, strerror( error ) );
+	}
+
+	mSize = (size_t)fileStat.st_size;
+	if( mSize > 0 ) {
+		void *data = ::mmap( nullptr, mSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+		if( data == MAP_FAILED ) {
+			int error = errno;
+			::close( fd );
+			throw MemoryMappedFileExc( path, strerror( error ) );
+		}
+		mData = data;
+	}
+
+	// the mapping remains valid once the descriptor is closed
+	::close( fd );
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+	if( mData )
+		::munmap( mData, mSize );
+}
+
+#endif
+
+} // namespace cinder
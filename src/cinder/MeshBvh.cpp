@@ -0,0 +1,603 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/MeshBvh.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_MESHBVH_SSE
+	#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+const float		FLOAT_MAX = std::numeric_limits<float>::max();
+const float		MISS = std::numeric_limits<float>::infinity(); // compares greater than any maximum distance
+const size_t	STACK_SIZE = 64;
+const uint32_t	MAX_BUILD_DEPTH = STACK_SIZE - 4; // a traversal stack holds at most one entry per level
+const uint32_t	MAX_BINS = 64;
+const uint32_t	MAX_SAH_LEAF_TRIANGLES = 16; // nodes this small become leaves whenever splitting doesn't pay off
+const size_t	PARALLEL_SUBTREE_TRIANGLES = 8 * 1024;
+const float		TRAVERSAL_COST = 1.0f; // relative to one triangle test
+
+struct Bounds {
+	Bounds() : mMin( FLOAT_MAX ), mMax( -FLOAT_MAX ) {}
+
+	void	include( const vec3 &point ) { mMin = glm::min( mMin, point ); mMax = glm::max( mMax, point ); }
+	void	include( const Bounds &bounds ) { mMin = glm::min( mMin, bounds.mMin ); mMax = glm::max( mMax, bounds.mMax ); }
+	//! Half the surface area, which is all the surface area heuristic needs
+	float	halfArea() const
+	{
+		vec3 e = glm::max( mMax - mMin, vec3( 0 ) );
+		return e.x * e.y + e.y * e.z + e.z * e.x;
+	}
+
+	vec3	mMin, mMax;
+};
+
+// Ray data prepared for repeated slab tests. The fourth lane is zeroed so a node's count or child index, which follows
+// its min or max corner in memory, can be loaded alongside it and masked off.
+struct RaySlab {
+	RaySlab( const Ray &ray )
+	{
+		const vec3 &origin = ray.getOrigin(), &invDir = ray.getInverseDirection();
+#if defined( CINDER_MESHBVH_SSE )
+		mOrigin = _mm_setr_ps( origin.x, origin.y, origin.z, 0 );
+		mInvDir = _mm_setr_ps( invDir.x, invDir.y, invDir.z, 0 );
+#else
+		mOrigin = origin;
+		mInvDir = invDir;
+#endif
+	}
+
+#if defined( CINDER_MESHBVH_SSE )
+	__m128	mOrigin, mInvDir;
+#else
+	vec3	mOrigin, mInvDir;
+#endif
+};
+
+// Returns the distance at which the ray enters the box [boxMin, boxMax], or MISS if it misses it within [0, tMax].
+// \a boxMin and \a boxMax must each be followed by four readable bytes.
+inline float slabEntry( const RaySlab &ray, const float *boxMin, const float *boxMax, float tMax )
+{
+#if defined( CINDER_MESHBVH_SSE )
+	const __m128 xyzMask = _mm_castsi128_ps( _mm_setr_epi32( -1, -1, -1, 0 ) );
+	__m128 t0 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( boxMin ), ray.mOrigin ), ray.mInvDir );
+	__m128 t1 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( boxMax ), ray.mOrigin ), ray.mInvDir );
+	__m128 tNear = _mm_and_ps( _mm_min_ps( t0, t1 ), xyzMask ); // lane 3 becomes 0, clamping entry to the ray's origin
+	__m128 tFar = _mm_or_ps( _mm_and_ps( _mm_max_ps( t0, t1 ), xyzMask ), _mm_andnot_ps( xyzMask, _mm_set1_ps( tMax ) ) );
+
+	tNear = _mm_max_ps( tNear, _mm_shuffle_ps( tNear, tNear, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	tNear = _mm_max_ps( tNear, _mm_shuffle_ps( tNear, tNear, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	tFar = _mm_min_ps( tFar, _mm_shuffle_ps( tFar, tFar, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	tFar = _mm_min_ps( tFar, _mm_shuffle_ps( tFar, tFar, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	const float entry = _mm_cvtss_f32( tNear );
+	return ( entry <= _mm_cvtss_f32( tFar ) ) ? entry : MISS;
+#else
+	float entry = 0, exit = tMax;
+	for( int axis = 0; axis < 3; ++axis ) {
+		float t0 = ( boxMin[axis] - ray.mOrigin[axis] ) * ray.mInvDir[axis];
+		float t1 = ( boxMax[axis] - ray.mOrigin[axis] ) * ray.mInvDir[axis];
+		entry = std::max( entry, std::min( t0, t1 ) );
+		exit = std::min( exit, std::max( t0, t1 ) );
+	}
+	return ( entry <= exit ) ? entry : MISS;
+#endif
+}
+
+// Moller-Trumbore, matching Ray::calcTriangleIntersection() but also reporting the barycentric coordinates
+inline bool intersectTriangle( const Ray &ray, const vec3 *v, float *t, vec2 *barycentric )
+{
+	const vec3 edge1 = v[1] - v[0], edge2 = v[2] - v[0];
+	const vec3 pvec = cross( ray.getDirection(), edge2 );
+	const float det = dot( edge1, pvec );
+	if( det > -0.000001f && det < 0.000001f )
+		return false;
+
+	const float invDet = 1.0f / det;
+	const vec3 tvec = ray.getOrigin() - v[0];
+	const float u = dot( tvec, pvec ) * invDet;
+	if( u < 0.0f || u > 1.0f )
+		return false;
+
+	const vec3 qvec = cross( tvec, edge1 );
+	const float v2 = dot( ray.getDirection(), qvec ) * invDet;
+	if( v2 < 0.0f || u + v2 > 1.0f )
+		return false;
+
+	*t = dot( edge2, qvec ) * invDet;
+	*barycentric = vec2( u, v2 );
+	return true;
+}
+
+// Real-Time Collision Detection, Ericson, section 5.1.5
+vec3 closestPointOnTriangle( const vec3 &p, const vec3 &a, const vec3 &b, const vec3 &c )
+{
+	const vec3 ab = b - a, ac = c - a, ap = p - a;
+	const float d1 = dot( ab, ap ), d2 = dot( ac, ap );
+	if( d1 <= 0 && d2 <= 0 )
+		return a;
+
+	const vec3 bp = p - b;
+	const float d3 = dot( ab, bp ), d4 = dot( ac, bp );
+	if( d3 >= 0 && d4 <= d3 )
+		return b;
+
+	const float vc = d1 * d4 - d3 * d2;
+	if( vc <= 0 && d1 >= 0 && d3 <= 0 )
+		return a + ab * ( d1 / ( d1 - d3 ) );
+
+	const vec3 cp = p - c;
+	const float d5 = dot( ab, cp ), d6 = dot( ac, cp );
+	if( d6 >= 0 && d5 <= d6 )
+		return c;
+
+	const float vb = d5 * d2 - d1 * d6;
+	if( vb <= 0 && d2 >= 0 && d6 <= 0 )
+		return a + ac * ( d2 / ( d2 - d6 ) );
+
+	const float va = d3 * d6 - d5 * d4;
+	if( va <= 0 && ( d4 - d3 ) >= 0 && ( d5 - d6 ) >= 0 )
+		return b + ( c - b ) * ( ( d4 - d3 ) / ( ( d4 - d3 ) + ( d5 - d6 ) ) );
+
+	const float denom = 1.0f / ( va + vb + vc );
+	return a + ab * ( vb * denom ) + ac * ( vc * denom );
+}
+
+inline float distance2ToBox( const vec3 &p, const vec3 &boxMin, const vec3 &boxMax )
+{
+	const vec3 d = glm::max( glm::max( boxMin - p, p - boxMax ), vec3( 0 ) );
+	return dot( d, d );
+}
+
+} // anonymous namespace
+
+MeshBvh::MeshBvh( const TriMesh &mesh, const Options &options )
+	: mOptions( options )
+{
+	if( mesh.getNumVertices() > 0 && mesh.getAttribDims( geom::POSITION ) != 3 )
+		throw MeshBvhExc( "MeshBvh requires 3D positions" );
+	build( mesh.getPositions<3>(), mesh.getNumVertices(), mesh.getIndices().data(), mesh.getNumIndices() );
+}
+
+MeshBvh::MeshBvh( const geom::Source &source, const Options &options )
+	: mOptions( options )
+{
+	TriMesh mesh( source, TriMesh::Format().positions( 3 ) );
+	build( mesh.getPositions<3>(), mesh.getNumVertices(), mesh.getIndices().data(), mesh.getNumIndices() );
+}
+
+MeshBvh::MeshBvh( const vec3 *positions, size_t numPositions, const uint32_t *indices, size_t numIndices, const Options &options )
+	: mOptions( options )
+{
+	build( positions, numPositions, indices, numIndices );
+}
+
+void MeshBvh::build( const vec3 *positions, size_t numPositions, const uint32_t *indices, size_t numIndices )
+{
+	if( numIndices % 3 != 0 )
+		throw MeshBvhExc( "MeshBvh requires a multiple of three indices" );
+	if( numIndices / 3 >= INVALID_TRIANGLE )
+		throw MeshBvhExc( "MeshBvh supports at most 2^32 - 2 triangles" );
+	if( std::any_of( indices, indices + numIndices, [numPositions]( uint32_t index ) { return index >= numPositions; } ) )
+		throw MeshBvhExc( "MeshBvh index out of range" );
+
+	mNumPositions = numPositions;
+	const size_t numTriangles = numIndices / 3;
+	mNodes.clear();
+	if( numTriangles == 0 ) {
+		mVertices.clear();
+		mIndices.clear();
+		mTriangleIds.clear();
+		return;
+	}
+
+	std::vector<Bounds> triangleBounds( numTriangles );
+	std::vector<vec3> centroids( numTriangles );
+	parallelFor( numTriangles, [&]( size_t begin, size_t end ) {
+		for( size_t t = begin; t < end; ++t ) {
+			const vec3 &a = positions[indices[t * 3]], &b = positions[indices[t * 3 + 1]], &c = positions[indices[t * 3 + 2]];
+			triangleBounds[t].include( a );
+			triangleBounds[t].include( b );
+			triangleBounds[t].include( c );
+			centroids[t] = ( triangleBounds[t].mMin + triangleBounds[t].mMax ) * 0.5f;
+		}
+	}, 4096 );
+
+	std::vector<uint32_t> ids( numTriangles );
+	std::iota( ids.begin(), ids.end(), 0 );
+
+	// nodes are claimed in child pairs from a shared counter so subtrees can be built concurrently
+	std::vector<Node> nodes( numTriangles * 2 - 1 );
+	std::atomic<uint32_t> numNodes( 1 );
+	const uint32_t numBins = glm::clamp<uint32_t>( mOptions.getNumBins(), 2, MAX_BINS );
+	const uint32_t maxLeafTriangles = std::max<uint32_t>( mOptions.getMaxLeafTriangles(), 1 );
+
+	std::function<void( uint32_t, size_t, size_t, uint32_t )> buildNode = [&]( uint32_t nodeIndex, size_t begin, size_t end, uint32_t depth ) {
+		Bounds bounds, centroidBounds;
+		for( size_t i = begin; i < end; ++i ) {
+			bounds.include( triangleBounds[ids[i]] );
+			centroidBounds.include( centroids[ids[i]] );
+		}
+
+		Node &node = nodes[nodeIndex];
+		node.mMin = bounds.mMin;
+		node.mMax = bounds.mMax;
+		node.mLeftOrFirst = (uint32_t)begin;
+		node.mCount = (uint32_t)( end - begin );
+		const size_t count = end - begin;
+		if( count <= maxLeafTriangles || depth >= MAX_BUILD_DEPTH )
+			return;
+
+		// binned SAH over all three axes
+		struct Bin { Bounds mBounds; size_t mCount = 0; };
+		float bestCost = FLOAT_MAX;
+		int bestAxis = -1;
+		uint32_t bestSplit = 0;
+		for( int axis = 0; axis < 3; ++axis ) {
+			const float axisMin = centroidBounds.mMin[axis], extent = centroidBounds.mMax[axis] - axisMin;
+			if( ! ( extent > 0 ) )
+				continue;
+
+			Bin bins[MAX_BINS];
+			const float scale = numBins / extent;
+			for( size_t i = begin; i < end; ++i ) {
+				uint32_t b = std::min( numBins - 1, (uint32_t)( ( centroids[ids[i]][axis] - axisMin ) * scale ) );
+				bins[b].mBounds.include( triangleBounds[ids[i]] );
+				++bins[b].mCount;
+			}
+
+			float rightCosts[MAX_BINS];
+			Bounds right;
+			size_t rightCount = 0;
+			for( uint32_t b = numBins - 1; b > 0; --b ) {
+				right.include( bins[b].mBounds );
+				rightCount += bins[b].mCount;
+				rightCosts[b] = right.halfArea() * rightCount;
+			}
+			Bounds left;
+			size_t leftCount = 0;
+			for( uint32_t split = 1; split < numBins; ++split ) {
+				left.include( bins[split - 1].mBounds );
+				leftCount += bins[split - 1].mCount;
+				const float cost = left.halfArea() * leftCount + rightCosts[split];
+				if( leftCount > 0 && leftCount < count && cost < bestCost ) {
+					bestCost = cost;
+					bestAxis = axis;
+					bestSplit = split;
+				}
+			}
+		}
+
+		const float leafCost = bounds.halfArea() * count;
+		if( bestAxis >= 0 && bestCost + TRAVERSAL_COST * bounds.halfArea() >= leafCost && count <= MAX_SAH_LEAF_TRIANGLES )
+			return;
+
+		size_t mid;
+		if( bestAxis >= 0 ) {
+			const float axisMin = centroidBounds.mMin[bestAxis], scale = numBins / ( centroidBounds.mMax[bestAxis] - axisMin );
+			mid = std::partition( ids.begin() + begin, ids.begin() + end, [&]( uint32_t id ) {
+				return std::min( numBins - 1, (uint32_t)( ( centroids[id][bestAxis] - axisMin ) * scale ) ) < bestSplit;
+			} ) - ids.begin();
+		}
+		else // every centroid coincides; any split is as good as another
+			mid = begin + count / 2;
+
+		const uint32_t children = numNodes.fetch_add( 2 );
+		node.mLeftOrFirst = children;
+		node.mCount = 0;
+		if( count > PARALLEL_SUBTREE_TRIANGLES ) {
+			parallelFor( 2, [&]( size_t first, size_t last ) {
+				for( size_t c = first; c < last; ++c )
+					buildNode( children + (uint32_t)c, c ? mid : begin, c ? end : mid, depth + 1 );
+			} );
+		}
+		else {
+			buildNode( children, begin, mid, depth + 1 );
+			buildNode( children + 1, mid, end, depth + 1 );
+		}
+	};
+	buildNode( 0, 0, numTriangles, 0 );
+
+	// lay the nodes out depth-first, so a node's first child usually shares its cache line
+	mNodes.reserve( numNodes );
+	mNodes.push_back( nodes[0] );
+	std::vector<std::pair<uint32_t, uint32_t>> stack = { { 0, 0 } }; // source index, destination index
+	while( ! stack.empty() ) {
+		const auto entry = stack.back();
+		stack.pop_back();
+		const Node &source = nodes[entry.first];
+		if( source.mCount == 0 ) {
+			const uint32_t children = (uint32_t)mNodes.size();
+			mNodes[entry.second].mLeftOrFirst = children;
+			mNodes.push_back( nodes[source.mLeftOrFirst] );
+			mNodes.push_back( nodes[source.mLeftOrFirst + 1] );
+			stack.emplace_back( source.mLeftOrFirst + 1, children + 1 );
+			stack.emplace_back( source.mLeftOrFirst, children );
+		}
+	}
+
+	// store the triangles in leaf order so each leaf's vertices are contiguous
+	mTriangleIds = std::move( ids );
+	mIndices.resize( numIndices );
+	mVertices.resize( numIndices );
+	parallelFor( numTriangles, [&]( size_t begin, size_t end ) {
+		for( size_t t = begin; t < end; ++t ) {
+			for( int v = 0; v < 3; ++v ) {
+				mIndices[t * 3 + v] = indices[mTriangleIds[t] * 3 + v];
+				mVertices[t * 3 + v] = positions[mIndices[t * 3 + v]];
+			}
+		}
+	}, 4096 );
+}
+
+void MeshBvh::refit( const vec3 *positions, size_t numPositions )
+{
+	if( numPositions != mNumPositions )
+		throw MeshBvhExc( "MeshBvh::refit() requires the number of positions the hierarchy was built with" );
+
+	parallelFor( mIndices.size(), [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			mVertices[i] = positions[mIndices[i]];
+	}, 16 * 1024 );
+	refitNodes();
+}
+
+void MeshBvh::refit( const TriMesh &mesh )
+{
+	if( mesh.getNumVertices() > 0 && mesh.getAttribDims( geom::POSITION ) != 3 )
+		throw MeshBvhExc( "MeshBvh requires 3D positions" );
+	refit( mesh.getPositions<3>(), mesh.getNumVertices() );
+}
+
+void MeshBvh::refitNodes()
+{
+	// leaves in parallel, then interior nodes bottom-up; children always follow their parent in the array
+	parallelFor( mNodes.size(), [&]( size_t begin, size_t end ) {
+		for( size_t n = begin; n < end; ++n ) {
+			Node &node = mNodes[n];
+			if( node.mCount == 0 )
+				continue;
+			Bounds bounds;
+			for( size_t v = node.mLeftOrFirst * 3; v < ( node.mLeftOrFirst + node.mCount ) * 3; ++v )
+				bounds.include( mVertices[v] );
+			node.mMin = bounds.mMin;
+			node.mMax = bounds.mMax;
+		}
+	}, 1024 );
+
+	for( size_t n = mNodes.size(); n-- > 0; ) {
+		Node &node = mNodes[n];
+		if( node.mCount == 0 ) {
+			const Node &left = mNodes[node.mLeftOrFirst], &right = mNodes[node.mLeftOrFirst + 1];
+			node.mMin = glm::min( left.mMin, right.mMin );
+			node.mMax = glm::max( left.mMax, right.mMax );
+		}
+	}
+}
+
+template<typename VisitT>
+void MeshBvh::traverseRay( const Ray &ray, float maxDistance, const VisitT &visitLeaf ) const
+{
+	if( mNodes.empty() )
+		return;
+
+	const RaySlab slab( ray );
+	float tMax = maxDistance;
+	if( slabEntry( slab, &mNodes[0].mMin.x, &mNodes[0].mMax.x, tMax ) > tMax )
+		return;
+
+	struct Entry { uint32_t mNode; float mDistance; };
+	Entry stack[STACK_SIZE];
+	size_t stackSize = 0;
+	uint32_t nodeIndex = 0;
+	while( true ) {
+		const Node &node = mNodes[nodeIndex];
+		if( node.mCount ) {
+			if( visitLeaf( node.mLeftOrFirst, node.mCount, &tMax ) )
+				return;
+		}
+		else {
+			// visit the nearer child first and defer the other
+			uint32_t nearIndex = node.mLeftOrFirst, farIndex = node.mLeftOrFirst + 1;
+			float nearDistance = slabEntry( slab, &mNodes[nearIndex].mMin.x, &mNodes[nearIndex].mMax.x, tMax );
+			float farDistance = slabEntry( slab, &mNodes[farIndex].mMin.x, &mNodes[farIndex].mMax.x, tMax );
+			if( farDistance < nearDistance ) {
+				std::swap( nearIndex, farIndex );
+				std::swap( nearDistance, farDistance );
+			}
+			if( nearDistance <= tMax ) {
+				if( farDistance <= tMax )
+					stack[stackSize++] = { farIndex, farDistance };
+				nodeIndex = nearIndex;
+				continue;
+			}
+		}
+
+		// pop the next deferred node that's still closer than the best hit
+		do {
+			if( stackSize == 0 )
+				return;
+			--stackSize;
+		} while( stack[stackSize].mDistance > tMax );
+		nodeIndex = stack[stackSize].mNode;
+	}
+}
+
+bool MeshBvh::raycast( const Ray &ray, RayHit *result, float maxDistance ) const
+{
+	RayHit hit;
+	traverseRay( ray, maxDistance, [&]( uint32_t first, uint32_t count, float *tMax ) {
+		for( uint32_t t = first; t < first + count; ++t ) {
+			float distance;
+			vec2 barycentric;
+			if( intersectTriangle( ray, &mVertices[t * 3], &distance, &barycentric ) && distance >= 0 && distance <= *tMax ) {
+				*tMax = distance;
+				hit.mDistance = distance;
+				hit.mTriangle = mTriangleIds[t];
+				hit.mBarycentric = barycentric;
+			}
+		}
+		return false;
+	} );
+
+	if( result )
+		*result = hit;
+	return hit.isHit();
+}
+
+bool MeshBvh::raycastAny( const Ray &ray, float maxDistance ) const
+{
+	bool found = false;
+	traverseRay( ray, maxDistance, [&]( uint32_t first, uint32_t count, float *tMax ) {
+		for( uint32_t t = first; t < first + count; ++t ) {
+			float distance;
+			vec2 barycentric;
+			if( intersectTriangle( ray, &mVertices[t * 3], &distance, &barycentric ) && distance >= 0 && distance <= *tMax ) {
+				found = true;
+				return true;
+			}
+		}
+		return false;
+	} );
+
+	return found;
+}
+
+void MeshBvh::raycast( const Ray *rays, size_t numRays, RayHit *results, float maxDistance ) const
+{
+	parallelFor( numRays, [&]( size_t begin, size_t end ) {
+		for( size_t r = begin; r < end; ++r )
+			raycast( rays[r], &results[r], maxDistance );
+	}, 64 );
+}
+
+bool MeshBvh::calcClosestPoint( const vec3 &point, vec3 *result, uint32_t *triangle, float maxDistance ) const
+{
+	if( mNodes.empty() )
+		return false;
+
+	float bestDistance2 = ( maxDistance < std::sqrt( FLOAT_MAX ) ) ? maxDistance * maxDistance : FLOAT_MAX;
+	uint32_t bestTriangle = INVALID_TRIANGLE;
+	vec3 bestPoint;
+
+	struct Entry { uint32_t mNode; float mDistance2; };
+	Entry stack[STACK_SIZE];
+	size_t stackSize = 0;
+	stack[stackSize++] = { 0, distance2ToBox( point, mNodes[0].mMin, mNodes[0].mMax ) };
+	while( stackSize > 0 ) {
+		const Entry entry = stack[--stackSize];
+		if( entry.mDistance2 > bestDistance2 )
+			continue;
+
+		const Node &node = mNodes[entry.mNode];
+		if( node.mCount ) {
+			for( uint32_t t = node.mLeftOrFirst; t < node.mLeftOrFirst + node.mCount; ++t ) {
+				const vec3 candidate = closestPointOnTriangle( point, mVertices[t * 3], mVertices[t * 3 + 1], mVertices[t * 3 + 2] );
+				const float distance2 = length2( candidate - point );
+				if( distance2 <= bestDistance2 ) {
+					bestDistance2 = distance2;
+					bestTriangle = t;
+					bestPoint = candidate;
+				}
+			}
+		}
+		else {
+			// push the farther child first so the nearer one is searched first
+			Entry left = { node.mLeftOrFirst, distance2ToBox( point, mNodes[node.mLeftOrFirst].mMin, mNodes[node.mLeftOrFirst].mMax ) };
+			Entry right = { node.mLeftOrFirst + 1, distance2ToBox( point, mNodes[node.mLeftOrFirst + 1].mMin, mNodes[node.mLeftOrFirst + 1].mMax ) };
+			if( left.mDistance2 < right.mDistance2 )
+				std::swap( left, right );
+			if( left.mDistance2 <= bestDistance2 )
+				stack[stackSize++] = left;
+			if( right.mDistance2 <= bestDistance2 )
+				stack[stackSize++] = right;
+		}
+	}
+
+	if( bestTriangle == INVALID_TRIANGLE )
+		return false;
+	if( result )
+		*result = bestPoint;
+	if( triangle )
+		*triangle = mTriangleIds[bestTriangle];
+	return true;
+}
+
+template<typename VisitT>
+void MeshBvh::traverseSphere( const Sphere &sphere, const VisitT &visitTriangle ) const
+{
+	if( mNodes.empty() )
+		return;
+
+	const vec3 center = sphere.getCenter();
+	const float radius2 = sphere.getRadius() * sphere.getRadius();
+	uint32_t stack[STACK_SIZE];
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while( stackSize > 0 ) {
+		const Node &node = mNodes[stack[--stackSize]];
+		if( distance2ToBox( center, node.mMin, node.mMax ) > radius2 )
+			continue;
+
+		if( node.mCount ) {
+			for( uint32_t t = node.mLeftOrFirst; t < node.mLeftOrFirst + node.mCount; ++t ) {
+				const vec3 closest = closestPointOnTriangle( center, mVertices[t * 3], mVertices[t * 3 + 1], mVertices[t * 3 + 2] );
+				if( length2( closest - center ) <= radius2 && visitTriangle( mTriangleIds[t] ) )
+					return;
+			}
+		}
+		else {
+			stack[stackSize++] = node.mLeftOrFirst + 1;
+			stack[stackSize++] = node.mLeftOrFirst;
+		}
+	}
+}
+
+bool MeshBvh::intersects( const Sphere &sphere ) const
+{
+	bool found = false;
+	traverseSphere( sphere, [&found]( uint32_t ) { found = true; return true; } );
+	return found;
+}
+
+void MeshBvh::findTriangles( const Sphere &sphere, std::vector<uint32_t> *result ) const
+{
+	traverseSphere( sphere, [result]( uint32_t triangle ) { result->push_back( triangle ); return false; } );
+}
+
+AxisAlignedBox MeshBvh::getBounds() const
+{
+	return mNodes.empty() ? AxisAlignedBox() : AxisAlignedBox( mNodes[0].mMin, mNodes[0].mMax );
+}
+
+} // namespace cinder
@@ -0,0 +1,336 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/TriMesh.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <unordered_map>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_MESHNORMALS_SSE
+	#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+const uint32_t	INVALID = 0xFFFFFFFF;
+//! Triangles below which a range is not worth its own partial accumulation buffer
+const size_t	TRIANGLES_PER_RANGE = 16384;
+const size_t	VERTEX_GRAIN = 4096;
+//! Squared ratio of a triangle's shortest to longest edge below which it does not contribute tangents
+const float		MIN_EDGE_RATIO2 = 1e-8f;
+
+/*! Runs \a triangleFn( begin, end, sums ) over ranges of \a numTriangles, each scattering into its own buffer of \a numVertices sums so no atomics are needed.
+	The partial buffers are then reduced in parallel over the vertices, and \a vertexFn( vertex, sum ) finishes each vertex. The first range scatters into \a result directly. */
+template<typename TriangleFn, typename VertexFn>
+void accumulateTriangles( size_t numTriangles, size_t numVertices, vector<vec3> *result, const TriangleFn &triangleFn, const VertexFn &vertexFn )
+{
+	result->assign( numVertices, vec3( 0 ) );
+
+	const size_t numRanges = std::max<size_t>( 1, std::min( getNumParallelThreads(), numTriangles / TRIANGLES_PER_RANGE ) );
+	vector<vector<vec3>> partials( numRanges - 1 );
+	parallelFor( numRanges, [&]( size_t begin, size_t end ) {
+		for( size_t r = begin; r < end; ++r ) {
+			vec3 *sums = result->data();
+			if( r > 0 ) {
+				partials[r - 1].assign( numVertices, vec3( 0 ) );
+				sums = partials[r - 1].data();
+			}
+			triangleFn( numTriangles * r / numRanges, numTriangles * ( r + 1 ) / numRanges, sums );
+		}
+	} );
+
+	parallelFor( numVertices, [&]( size_t begin, size_t end ) {
+		for( size_t v = begin; v < end; ++v ) {
+			vec3 sum = (*result)[v];
+			for( const auto &partial : partials )
+				sum += partial[v];
+			vertexFn( v, sum );
+			(*result)[v] = sum;
+		}
+	}, VERTEX_GRAIN );
+}
+
+vec3 normalizeOrZero( const vec3 &v )
+{
+	const float len2 = length2( v );
+	return len2 > 0 ? v / std::sqrt( len2 ) : vec3( 0 );
+}
+
+/*! Adds the normal of each triangle in [\a begin, \a end) to its three vertices in \a sums. Triangles with an edge shorter than sqrt( FLT_EPSILON ) are skipped, and
+	unless \a weighted the normals are unit length. The SSE path computes four triangles at a time, laid out as structures of arrays. */
+void accumulateFaceNormals( const uint32_t *indices, const vec3 *positions, size_t begin, size_t end, bool weighted, vec3 *sums )
+{
+	size_t t = begin;
+#if defined( CINDER_MESHNORMALS_SSE )
+	const __m128 minLength2 = _mm_set1_ps( FLT_EPSILON );
+	for( ; t + 4 <= end; t += 4 ) {
+		const uint32_t *tri = &indices[t * 3];
+		__m128 p[3][3]; // corner, axis
+		for( int k = 0; k < 3; ++k ) {
+			const vec3 &a = positions[tri[k]], &b = positions[tri[3 + k]], &c = positions[tri[6 + k]], &d = positions[tri[9 + k]];
+			p[k][0] = _mm_setr_ps( a.x, b.x, c.x, d.x );
+			p[k][1] = _mm_setr_ps( a.y, b.y, c.y, d.y );
+			p[k][2] = _mm_setr_ps( a.z, b.z, c.z, d.z );
+		}
+		__m128 e0[3], e1[3], e2[3];
+		for( int d = 0; d < 3; ++d ) {
+			e0[d] = _mm_sub_ps( p[1][d], p[0][d] );
+			e1[d] = _mm_sub_ps( p[2][d], p[0][d] );
+			e2[d] = _mm_sub_ps( p[2][d], p[1][d] );
+		}
+		auto dot3 = []( const __m128 *a, const __m128 *b ) {
+			return _mm_add_ps( _mm_add_ps( _mm_mul_ps( a[0], b[0] ), _mm_mul_ps( a[1], b[1] ) ), _mm_mul_ps( a[2], b[2] ) );
+		};
+		const __m128 valid = _mm_and_ps( _mm_and_ps( _mm_cmpge_ps( dot3( e0, e0 ), minLength2 ), _mm_cmpge_ps( dot3( e1, e1 ), minLength2 ) ),
+										_mm_cmpge_ps( dot3( e2, e2 ), minLength2 ) );
+		__m128 n[3] = {
+			_mm_sub_ps( _mm_mul_ps( e0[1], e1[2] ), _mm_mul_ps( e0[2], e1[1] ) ),
+			_mm_sub_ps( _mm_mul_ps( e0[2], e1[0] ), _mm_mul_ps( e0[0], e1[2] ) ),
+			_mm_sub_ps( _mm_mul_ps( e0[0], e1[1] ), _mm_mul_ps( e0[1], e1[0] ) )
+		};
+		if( ! weighted ) {
+			const __m128 len = _mm_sqrt_ps( dot3( n, n ) );
+			// zero length normals of (nearly) collinear triangles contribute nothing
+			const __m128 nonZero = _mm_cmpgt_ps( len, _mm_setzero_ps() );
+			for( int d = 0; d < 3; ++d )
+				n[d] = _mm_and_ps( _mm_div_ps( n[d], len ), nonZero );
+		}
+		alignas( 16 ) float out[3][4];
+		for( int d = 0; d < 3; ++d )
+			_mm_store_ps( out[d], _mm_and_ps( n[d], valid ) );
+		for( int i = 0; i < 4; ++i ) {
+			const vec3 normal( out[0][i], out[1][i], out[2][i] );
+			sums[tri[i * 3]] += normal;
+			sums[tri[i * 3 + 1]] += normal;
+			sums[tri[i * 3 + 2]] += normal;
+		}
+	}
+#endif
+	for( ; t < end; ++t ) {
+		const uint32_t *tri = &indices[t * 3];
+		const vec3 &v0 = positions[tri[0]], &v1 = positions[tri[1]], &v2 = positions[tri[2]];
+		const vec3 e0 = v1 - v0, e1 = v2 - v0, e2 = v2 - v1;
+		if( length2( e0 ) < FLT_EPSILON || length2( e1 ) < FLT_EPSILON || length2( e2 ) < FLT_EPSILON )
+			continue;
+
+		vec3 normal = cross( e0, e1 );
+		// if not weighted, every normal has an equal contribution
+		if( ! weighted )
+			normal = normalizeOrZero( normal );
+
+		sums[tri[0]] += normal;
+		sums[tri[1]] += normal;
+		sums[tri[2]] += normal;
+	}
+}
+
+/*! Returns for each of \a numPositions 3D positions the first earlier position closer than sqrt( FLT_EPSILON ), or the position itself. Representatives are bucketed
+	in a hash grid of cells twice that distance wide, so a match lies in one of the (at most 2 per axis) cells overlapping the box around a position. */
+vector<uint32_t> findCoincidentPositions( const vec3 *positions, size_t numPositions )
+{
+	const float radius = std::sqrt( FLT_EPSILON );
+	const float cellSize = 2 * radius;
+	auto cellKey = []( const ivec3 &cell ) {
+		uint64_t key = 0;
+		for( int d = 0; d < 3; ++d )
+			key = ( key ^ uint32_t( cell[d] ) ) * 0x100000001b3ull;
+		return key;
+	};
+
+	unordered_map<uint64_t, uint32_t> buckets; // most recent representative of each cell
+	buckets.reserve( numPositions );
+	vector<uint32_t> nextInBucket( numPositions, INVALID ), result( numPositions );
+	for( uint32_t v = 0; v < (uint32_t)numPositions; ++v ) {
+		const vec3 scaled = positions[v] / cellSize;
+		const ivec3 cell( glm::floor( scaled ) );
+		// the neighboring cell on each side the box crosses, or none
+		ivec3 neighbor;
+		for( int d = 0; d < 3; ++d ) {
+			const float inCell = ( scaled[d] - std::floor( scaled[d] ) ) * cellSize;
+			neighbor[d] = ( inCell < radius ) ? -1 : ( ( cellSize - inCell < radius ) ? 1 : 0 );
+		}
+
+		uint32_t match = INVALID;
+		for( int c = 0; c < 8; ++c ) {
+			ivec3 probe = cell;
+			bool distinct = true;
+			for( int d = 0; d < 3; ++d ) {
+				if( c & ( 1 << d ) ) {
+					probe[d] += neighbor[d];
+					distinct = distinct && neighbor[d] != 0;
+				}
+			}
+			if( ! distinct )
+				continue;
+			auto it = buckets.find( cellKey( probe ) );
+			for( uint32_t r = ( it != buckets.end() ) ? it->second : INVALID; r != INVALID; r = nextInBucket[r] )
+				if( length2( positions[r] - positions[v] ) < FLT_EPSILON && r < match )
+					match = r;
+		}
+
+		if( match != INVALID )
+			result[v] = match;
+		else {
+			result[v] = v;
+			auto inserted = buckets.insert( make_pair( cellKey( cell ), v ) );
+			if( ! inserted.second ) {
+				nextInBucket[v] = inserted.first->second;
+				inserted.first->second = v;
+			}
+		}
+	}
+
+	return result;
+}
+
+//! Returns the angle at \a corner between the edges toward \a a and \a b, projected onto the plane perpendicular to \a normal
+float projectedCornerAngle( const vec3 &corner, const vec3 &a, const vec3 &b, const vec3 &normal )
+{
+	vec3 ea = a - corner, eb = b - corner;
+	ea = normalizeOrZero( ea - normal * dot( normal, ea ) );
+	eb = normalizeOrZero( eb - normal * dot( normal, eb ) );
+	return std::acos( glm::clamp( dot( ea, eb ), -1.0f, 1.0f ) );
+}
+
+} // anonymous namespace
+
+bool TriMesh::recalculateNormals( bool smooth, bool weighted )
+{
+	// requires valid indices and 3D vertices
+	if( mIndices.empty() || mPositions.empty() || mPositionsDims != 3 )
+		return false;
+
+	const size_t numPositions = mPositions.size() / 3;
+	const vec3 *positions = reinterpret_cast<const vec3*>( mPositions.data() );
+
+	// for smooth renormalization, triangles are accumulated onto the first of each group of coincident positions
+	vector<uint32_t> representatives, smoothIndices;
+	const uint32_t *indices = mIndices.data();
+	if( smooth ) {
+		representatives = findCoincidentPositions( positions, numPositions );
+		smoothIndices.resize( mIndices.size() );
+		parallelFor( mIndices.size(), [&]( size_t begin, size_t end ) {
+			for( size_t i = begin; i < end; ++i )
+				smoothIndices[i] = representatives[mIndices[i]];
+		}, VERTEX_GRAIN );
+		indices = smoothIndices.data();
+	}
+
+	accumulateTriangles( getNumTriangles(), numPositions, &mNormals,
+		[&]( size_t begin, size_t end, vec3 *sums ) { accumulateFaceNormals( indices, positions, begin, end, weighted, sums ); },
+		[]( size_t, vec3 &sum ) { sum = normalizeOrZero( sum ); } );
+
+	// copy normals to corresponding non-unique vertices; representatives map to themselves and are only read
+	if( smooth ) {
+		parallelFor( numPositions, [&]( size_t begin, size_t end ) {
+			for( size_t i = begin; i < end; ++i )
+				mNormals[i] = mNormals[representatives[i]];
+		}, VERTEX_GRAIN );
+	}
+
+	mNormalsDims = 3;
+
+	return true;
+}
+
+bool TriMesh::recalculateTangents()
+{
+	// requires valid 2D texture coords and 3D normals
+	if( mTexCoords0.empty() || mTexCoords0Dims != 2 )
+		return false;
+
+	if( ! hasNormals() || mPositionsDims != 3 )
+		return false;
+
+	const vec3 *positions = reinterpret_cast<const vec3*>( mPositions.data() );
+	const vec3 *normals = mNormals.data();
+	const vec2 *texCoords = reinterpret_cast<const vec2*>( mTexCoords0.data() );
+	const uint32_t *indices = mIndices.data();
+
+	// Following MikkTSpace, each triangle's texture space tangent is projected onto the tangent plane of every corner's normal
+	// and weighted by the corner's angle in that plane, which makes the result independent of how a surface is triangulated.
+	accumulateTriangles( getNumTriangles(), getNumVertices(), &mTangents,
+		[&]( size_t begin, size_t end, vec3 *sums ) {
+			for( size_t t = begin; t < end; ++t ) {
+				const uint32_t *tri = &indices[t * 3];
+				const vec3 &v0 = positions[tri[0]], &v1 = positions[tri[1]], &v2 = positions[tri[2]];
+				const vec2 &w0 = texCoords[tri[0]], &w1 = texCoords[tri[1]], &w2 = texCoords[tri[2]];
+				const vec3 e1 = v1 - v0, e2 = v2 - v0;
+				const vec2 st1 = w1 - w0, st2 = w2 - w0;
+				// triangles with a vanishing edge, like the ones at a sphere's poles, have meaningless tangents and corner angles
+				const float edges2[3] = { length2( e1 ), length2( e2 ), length2( v2 - v1 ) };
+				if( *std::min_element( edges2, edges2 + 3 ) <= MIN_EDGE_RATIO2 * *std::max_element( edges2, edges2 + 3 ) )
+					continue;
+
+				// the sign of the texture space area flips the tangent of mirrored triangles
+				const float area = st1.x * st2.y - st2.x * st1.y;
+				if( area == 0 )
+					continue;
+				const vec3 tangent = normalizeOrZero( ( area < 0 ? -1.0f : 1.0f ) * ( st2.y * e1 - st1.y * e2 ) );
+				if( tangent == vec3( 0 ) )
+					continue;
+
+				for( int k = 0; k < 3; ++k ) {
+					const vec3 &normal = normals[tri[k]];
+					const vec3 projected = normalizeOrZero( tangent - normal * dot( normal, tangent ) );
+					const float angle = projectedCornerAngle( positions[tri[k]], positions[tri[( k + 1 ) % 3]], positions[tri[( k + 2 ) % 3]], normal );
+					sums[tri[k]] += projected * angle;
+				}
+			}
+		},
+		[&]( size_t v, vec3 &sum ) {
+			const vec3 &normal = normals[v];
+			sum = normalizeOrZero( sum - normal * dot( normal, sum ) );
+		} );
+
+	mTangentsDims = 3;
+
+	return true;
+}
+
+bool TriMesh::recalculateBitangents()
+{
+	// requires valid 3D tangents and normals
+	if( ! ( hasTangents() || recalculateTangents() ) )
+		return false;
+
+	mBitangents.resize( mNormals.size() );
+	parallelFor( mNormals.size(), [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			mBitangents[i] = normalizeOrZero( cross( mNormals[i], mTangents[i] ) );
+	}, VERTEX_GRAIN );
+
+	mBitangentsDims = 3;
+
+	return true;
+}
+
+} // namespace cinder
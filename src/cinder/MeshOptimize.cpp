@@ -0,0 +1,465 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/TriMesh.h"
+#include "cinder/Log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+const uint32_t INVALID = 0xFFFFFFFF;
+
+//! FIFO cache simulation shared by the statistics and the cluster splitting. Only misses advance time, as in a FIFO.
+class CacheSimulator {
+  public:
+	CacheSimulator( size_t numVertices, uint32_t cacheSize )
+		: mTimestamps( numVertices, 0 ), mTime( cacheSize + 1 ), mCacheSize( cacheSize )
+	{}
+
+	//! Returns the number of misses for the triangle \a triangle points to
+	uint32_t	addTriangle( const uint32_t *triangle )
+	{
+		uint32_t misses = 0;
+		for( int k = 0; k < 3; ++k ) {
+			if( mTime - mTimestamps[triangle[k]] > mCacheSize ) {
+				mTimestamps[triangle[k]] = mTime++;
+				++misses;
+			}
+		}
+		return misses;
+	}
+
+	void	flush() { mTime += mCacheSize + 1; }
+
+  private:
+	vector<uint32_t>	mTimestamps;
+	uint32_t			mTime, mCacheSize;
+};
+
+/*! Tipsify (Sander, Nehab & Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw", 2007). Fans around one vertex at a time
+	and picks the next fanning vertex among the ones just referenced, preferring vertices which will still be cached once their remaining triangles are drawn.
+	Returns the new order as triangle indices and appends the first triangle of every run which had to restart outside the cache to \a hardBoundaries. */
+vector<uint32_t> tipsify( const vector<uint32_t> &indices, size_t numVertices, uint32_t cacheSize, vector<uint32_t> *hardBoundaries )
+{
+	const size_t numTriangles = indices.size() / 3;
+
+	// vertex to triangle adjacency
+	vector<uint32_t> liveTriangles( numVertices, 0 ), offsets( numVertices + 1, 0 ), adjacency( indices.size() );
+	for( uint32_t v : indices )
+		++liveTriangles[v];
+	for( size_t v = 0; v < numVertices; ++v )
+		offsets[v + 1] = offsets[v] + liveTriangles[v];
+	vector<uint32_t> fill( offsets.begin(), offsets.end() - 1 );
+	for( size_t i = 0; i < indices.size(); ++i )
+		adjacency[fill[indices[i]]++] = uint32_t( i / 3 );
+
+	vector<uint32_t> timestamps( numVertices, 0 ), deadEnd, result;
+	vector<uint8_t> emitted( numTriangles, 0 );
+	deadEnd.reserve( indices.size() );
+	result.reserve( numTriangles );
+	uint32_t time = cacheSize + 1;
+
+	uint32_t cursor = 0;
+	while( cursor < numVertices && liveTriangles[cursor] == 0 )
+		++cursor;
+	uint32_t fanning = cursor < numVertices ? cursor : INVALID;
+	if( fanning != INVALID )
+		hardBoundaries->push_back( 0 );
+
+	while( fanning != INVALID ) {
+		const size_t candidatesBegin = deadEnd.size();
+		for( uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; ++a ) {
+			const uint32_t t = adjacency[a];
+			if( emitted[t] )
+				continue;
+			for( int k = 0; k < 3; ++k ) {
+				const uint32_t v = indices[t * 3 + k];
+				deadEnd.push_back( v );
+				--liveTriangles[v];
+				if( time - timestamps[v] > cacheSize )
+					timestamps[v] = time++;
+			}
+			emitted[t] = 1;
+			result.push_back( t );
+		}
+
+		// prefer the oldest candidate which stays cached while its remaining triangles are drawn
+		uint32_t next = INVALID;
+		int64_t bestPriority = -1;
+		for( size_t i = candidatesBegin; i < deadEnd.size(); ++i ) {
+			const uint32_t v = deadEnd[i];
+			if( liveTriangles[v] == 0 )
+				continue;
+			int64_t priority = 0;
+			if( time - timestamps[v] + 2 * liveTriangles[v] <= cacheSize )
+				priority = time - timestamps[v];
+			if( priority > bestPriority ) {
+				bestPriority = priority;
+				next = v;
+			}
+		}
+
+		if( next == INVALID ) {
+			// dead end: fall back to the most recently referenced vertex with triangles left, then to the next vertex in input order
+			while( ! deadEnd.empty() && next == INVALID ) {
+				if( liveTriangles[deadEnd.back()] > 0 )
+					next = deadEnd.back();
+				deadEnd.pop_back();
+			}
+			while( next == INVALID && cursor < numVertices ) {
+				if( liveTriangles[cursor] > 0 )
+					next = cursor;
+				else
+					++cursor;
+			}
+			if( next != INVALID )
+				hardBoundaries->push_back( (uint32_t)result.size() );
+		}
+		fanning = next;
+	}
+
+	return result;
+}
+
+vector<uint32_t> gatherTriangles( const vector<uint32_t> &indices, const vector<uint32_t> &order )
+{
+	vector<uint32_t> result( indices.size() );
+	for( size_t t = 0; t < order.size(); ++t )
+		memcpy( &result[t * 3], &indices[order[t] * 3], 3 * sizeof( uint32_t ) );
+	return result;
+}
+
+} // anonymous namespace
+
+TriMesh::VertexCacheStats TriMesh::calcVertexCacheStats( uint32_t cacheSize ) const
+{
+	const size_t numVertices = getNumVertices();
+	CacheSimulator cache( numVertices, cacheSize );
+	size_t misses = 0;
+	for( size_t i = 0; i + 2 < mIndices.size(); i += 3 )
+		misses += cache.addTriangle( &mIndices[i] );
+
+	vector<uint8_t> referenced( numVertices, 0 );
+	size_t numReferenced = 0;
+	for( uint32_t v : mIndices ) {
+		numReferenced += ! referenced[v];
+		referenced[v] = 1;
+	}
+
+	VertexCacheStats result;
+	result.mAcmr = getNumTriangles() ? float( misses ) / getNumTriangles() : 0;
+	result.mAtvr = numReferenced ? float( misses ) / numReferenced : 0;
+	return result;
+}
+
+TriMesh::OptimizeResult TriMesh::weld( float epsilon )
+{
+	OptimizeResult result;
+	result.mBefore = calcVertexCacheStats();
+
+	const size_t numVertices = getNumVertices();
+	const uint8_t positionDims = mPositionsDims;
+
+	// every other attribute has to match as well
+	struct Stream { const float *mData; uint8_t mDims; };
+	vector<Stream> streams;
+	for( geom::Attrib attr : getAvailableAttribs() ) {
+		Stream stream;
+		size_t strideBytes;
+		getAttribPointer( attr, &stream.mData, &strideBytes, &stream.mDims );
+		if( attr != geom::Attrib::POSITION && hasAttribData( attr ) )
+			streams.push_back( stream );
+	}
+	auto withinEpsilon = [&]( const float *a, const float *b, uint8_t dims ) {
+		for( uint8_t d = 0; d < dims; ++d )
+			if( ! ( std::abs( a[d] - b[d] ) <= epsilon ) )
+				return false;
+		return true;
+	};
+	auto matches = [&]( uint32_t a, uint32_t b ) {
+		if( ! withinEpsilon( &mPositions[a * positionDims], &mPositions[b * positionDims], positionDims ) )
+			return false;
+		for( const auto &stream : streams )
+			if( ! withinEpsilon( &stream.mData[a * stream.mDims], &stream.mData[b * stream.mDims], stream.mDims ) )
+				return false;
+		return true;
+	};
+
+	// Representatives are bucketed by grid cells twice as wide as epsilon, so any match lies in one of the (at most 2 per axis) cells overlapping
+	// the epsilon box around a vertex. Exact welding buckets by the position bits instead.
+	const float cellSize = 2 * epsilon;
+	auto cellKey = [&]( const float *p, const int *offset ) {
+		uint64_t key = 0;
+		for( uint8_t d = 0; d < positionDims; ++d ) {
+			uint32_t bits;
+			if( epsilon > 0 ) {
+				const int64_t cell = (int64_t)std::floor( p[d] / cellSize ) + offset[d];
+				bits = uint32_t( cell );
+			}
+			else {
+				const float value = p[d] == 0 ? 0.0f : p[d]; // -0 welds with 0
+				memcpy( &bits, &value, sizeof( bits ) );
+			}
+			key = ( key ^ bits ) * 0x100000001b3ull;
+		}
+		return key;
+	};
+
+	unordered_map<uint64_t, uint32_t> buckets; // first representative of each cell
+	buckets.reserve( numVertices );
+	vector<uint32_t> nextInBucket( numVertices, INVALID ), remap( numVertices );
+	vector<uint32_t> sourceVertices;
+	const int zero[4] = { 0, 0, 0, 0 };
+	for( uint32_t v = 0; v < (uint32_t)numVertices; ++v ) {
+		const float *p = &mPositions[v * positionDims];
+		uint32_t match = INVALID;
+		// the cells overlapping the epsilon box; a single cell for exact welding
+		const int numCells = epsilon > 0 ? 1 << positionDims : 1;
+		for( int c = 0; c < numCells && match == INVALID; ++c ) {
+			int offset[4] = { 0, 0, 0, 0 };
+			bool distinct = true;
+			for( uint8_t d = 0; d < positionDims && epsilon > 0; ++d ) {
+				if( c & ( 1 << d ) ) {
+					// the neighboring cell on the side the epsilon box crosses, if it crosses one
+					const float inCell = p[d] / cellSize - std::floor( p[d] / cellSize );
+					if( inCell * cellSize <= epsilon )
+						offset[d] = -1;
+					else if( ( 1 - inCell ) * cellSize <= epsilon )
+						offset[d] = 1;
+					else
+						distinct = false;
+				}
+			}
+			if( ! distinct )
+				continue;
+			auto it = buckets.find( cellKey( p, offset ) );
+			for( uint32_t r = ( it != buckets.end() ) ? it->second : INVALID; r != INVALID && match == INVALID; r = nextInBucket[r] )
+				if( matches( r, v ) )
+					match = r;
+		}
+
+		if( match != INVALID )
+			remap[v] = remap[match];
+		else {
+			remap[v] = (uint32_t)sourceVertices.size();
+			sourceVertices.push_back( v );
+			auto inserted = buckets.insert( make_pair( cellKey( p, zero ), v ) );
+			if( ! inserted.second ) {
+				nextInBucket[v] = inserted.first->second;
+				inserted.first->second = v;
+			}
+		}
+	}
+
+	// remap the triangles, dropping the ones which collapsed
+	size_t numIndices = 0;
+	vector<uint8_t> referenced( sourceVertices.size(), 0 );
+	for( size_t i = 0; i + 2 < mIndices.size(); i += 3 ) {
+		const uint32_t a = remap[mIndices[i]], b = remap[mIndices[i + 1]], c = remap[mIndices[i + 2]];
+		if( a == b || b == c || c == a )
+			continue;
+		mIndices[numIndices++] = a;
+		mIndices[numIndices++] = b;
+		mIndices[numIndices++] = c;
+		referenced[a] = referenced[b] = referenced[c] = 1;
+	}
+	mIndices.resize( numIndices );
+
+	// keep the surviving vertices in their original order
+	vector<uint32_t> compacted( sourceVertices.size(), INVALID );
+	size_t numReferenced = 0;
+	for( size_t v = 0; v < sourceVertices.size(); ++v ) {
+		if( referenced[v] ) {
+			compacted[v] = (uint32_t)numReferenced;
+			sourceVertices[numReferenced++] = sourceVertices[v];
+		}
+	}
+	sourceVertices.resize( numReferenced );
+	for( auto &index : mIndices )
+		index = compacted[index];
+	remapVertices( sourceVertices );
+
+	result.mAfter = calcVertexCacheStats();
+	return result;
+}
+
+TriMesh::OptimizeResult TriMesh::optimizeVertexCache( uint32_t cacheSize )
+{
+	OptimizeResult result;
+	result.mBefore = calcVertexCacheStats( cacheSize );
+
+	vector<uint32_t> hardBoundaries;
+	mIndices = gatherTriangles( mIndices, tipsify( mIndices, getNumVertices(), cacheSize, &hardBoundaries ) );
+
+	result.mAfter = calcVertexCacheStats( cacheSize );
+	return result;
+}
+
+TriMesh::OptimizeResult TriMesh::optimizeOverdraw( float threshold, uint32_t cacheSize )
+{
+	OptimizeResult result;
+	result.mBefore = calcVertexCacheStats( cacheSize );
+	if( mPositionsDims != 3 ) {
+		CI_LOG_E( "TriMesh::optimizeOverdraw requires 3D positions." );
+		result.mAfter = result.mBefore;
+		return result;
+	}
+
+	const size_t numVertices = getNumVertices(), numTriangles = getNumTriangles();
+	vector<uint32_t> hardBoundaries;
+	mIndices = gatherTriangles( mIndices, tipsify( mIndices, numVertices, cacheSize, &hardBoundaries ) );
+
+	// Split each hard cluster as soon as its miss ratio so far drops within the threshold of the whole cluster's.
+	// The cache restarts with each cluster since clusters get reordered, and the last, incomplete cluster merges into the previous one.
+	vector<uint32_t> clusters;
+	CacheSimulator cache( numVertices, cacheSize );
+	for( size_t h = 0; h < hardBoundaries.size(); ++h ) {
+		const uint32_t begin = hardBoundaries[h];
+		const uint32_t end = ( h + 1 < hardBoundaries.size() ) ? hardBoundaries[h + 1] : (uint32_t)numTriangles;
+
+		cache.flush();
+		uint32_t clusterMisses = 0;
+		for( uint32_t t = begin; t < end; ++t )
+			clusterMisses += cache.addTriangle( &mIndices[t * 3] );
+		const float clusterThreshold = threshold * float( clusterMisses ) / float( end - begin );
+
+		clusters.push_back( begin );
+		cache.flush();
+		uint32_t runningMisses = 0, runningTriangles = 0;
+		for( uint32_t t = begin; t < end; ++t ) {
+			runningMisses += cache.addTriangle( &mIndices[t * 3] );
+			++runningTriangles;
+			if( float( runningMisses ) <= clusterThreshold * runningTriangles ) {
+				clusters.push_back( t + 1 );
+				cache.flush();
+				runningMisses = runningTriangles = 0;
+			}
+		}
+		if( clusters.back() != begin )
+			clusters.pop_back();
+	}
+
+	// clusters facing away from the mesh center, far out along their normal, tend to occlude the rest and draw first
+	const vec3 *positions = reinterpret_cast<const vec3*>( mPositions.data() );
+	vec3 meshCentroid( 0 );
+	float meshArea = 0;
+	vector<vec3> clusterCentroids( clusters.size() ), clusterNormals( clusters.size() );
+	for( size_t c = 0; c < clusters.size(); ++c ) {
+		const uint32_t end = ( c + 1 < clusters.size() ) ? clusters[c + 1] : (uint32_t)numTriangles;
+		vec3 centroid( 0 ), normal( 0 );
+		float area = 0;
+		for( uint32_t t = clusters[c]; t < end; ++t ) {
+			const vec3 &a = positions[mIndices[t * 3]], &b = positions[mIndices[t * 3 + 1]], &d = positions[mIndices[t * 3 + 2]];
+			const vec3 n = cross( b - a, d - a );
+			const float triangleArea = length( n );
+			centroid += ( a + b + d ) * ( triangleArea / 3 );
+			normal += n;
+			area += triangleArea;
+		}
+		meshCentroid += centroid;
+		meshArea += area;
+		clusterCentroids[c] = area > 0 ? centroid / area : positions[mIndices[clusters[c] * 3]];
+		clusterNormals[c] = length( normal ) > 0 ? normalize( normal ) : vec3( 0 );
+	}
+	if( meshArea > 0 )
+		meshCentroid /= meshArea;
+
+	vector<float> sortKeys( clusters.size() );
+	for( size_t c = 0; c < clusters.size(); ++c )
+		sortKeys[c] = dot( clusterCentroids[c] - meshCentroid, clusterNormals[c] );
+	vector<uint32_t> clusterOrder( clusters.size() );
+	iota( clusterOrder.begin(), clusterOrder.end(), 0 );
+	stable_sort( clusterOrder.begin(), clusterOrder.end(), [&]( uint32_t a, uint32_t b ) { return sortKeys[a] > sortKeys[b]; } );
+
+	vector<uint32_t> triangleOrder;
+	triangleOrder.reserve( numTriangles );
+	for( uint32_t c : clusterOrder ) {
+		const uint32_t end = ( c + 1 < clusters.size() ) ? clusters[c + 1] : (uint32_t)numTriangles;
+		for( uint32_t t = clusters[c]; t < end; ++t )
+			triangleOrder.push_back( t );
+	}
+	mIndices = gatherTriangles( mIndices, triangleOrder );
+
+	result.mAfter = calcVertexCacheStats( cacheSize );
+	return result;
+}
+
+TriMesh::OptimizeResult TriMesh::optimizeVertexFetch()
+{
+	OptimizeResult result;
+	result.mBefore = calcVertexCacheStats();
+
+	vector<uint32_t> remap( getNumVertices(), INVALID ), sourceVertices;
+	for( auto &index : mIndices ) {
+		if( remap[index] == INVALID ) {
+			remap[index] = (uint32_t)sourceVertices.size();
+			sourceVertices.push_back( index );
+		}
+		index = remap[index];
+	}
+	remapVertices( sourceVertices );
+
+	result.mAfter = calcVertexCacheStats();
+	return result;
+}
+
+TriMesh::OptimizeResult TriMesh::optimize( uint32_t cacheSize )
+{
+	OptimizeResult result;
+	result.mBefore = calcVertexCacheStats( cacheSize );
+
+	weld();
+	optimizeOverdraw( 1.05f, cacheSize );
+	optimizeVertexFetch();
+
+	result.mAfter = calcVertexCacheStats( cacheSize );
+	return result;
+}
+
+void TriMesh::remapVertices( const vector<uint32_t> &sourceVertices )
+{
+	vector<float> gathered;
+	for( geom::Attrib attr : getAvailableAttribs() ) {
+		const float *data;
+		size_t strideBytes;
+		uint8_t dims;
+		getAttribPointer( attr, &data, &strideBytes, &dims );
+		if( ! hasAttribData( attr ) )
+			continue;
+		gathered.resize( sourceVertices.size() * dims );
+		for( size_t v = 0; v < sourceVertices.size(); ++v )
+			memcpy( &gathered[v * dims], &data[sourceVertices[v] * dims], dims * sizeof( float ) );
+		copyAttrib( attr, dims, 0, gathered.data(), sourceVertices.size() );
+	}
+}
+
+} // namespace cinder
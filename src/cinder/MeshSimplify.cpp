@@ -0,0 +1,904 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/GeomIo.h"
+#include "cinder/TriMesh.h"
+#include "cinder/Log.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <numeric>
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+const uint32_t	INVALID = 0xFFFFFFFF;
+const double	BOUNDARY_WEIGHT = 10.0; // perpendicular planes along open boundaries, relative to the faces' own planes
+const float		MIN_NORMAL_COS = 0.2f; // collapses which tilt a remaining triangle further than this are rejected
+const size_t	PARALLEL_GRAIN = 4096;
+
+struct AttribStream {
+	geom::Attrib	mAttrib;
+	const float		*mData;
+	uint8_t			mDims;
+	float			mWeight;
+};
+
+//! Symmetric 4x4 error quadric, plus the area which accumulated it
+struct Quadric {
+	Quadric() { memset( this, 0, sizeof( Quadric ) ); }
+
+	//! Adds the squared error of the linear function dot( \a g, p ) + \a d, weighted by \a weight
+	void	add( const dvec3 &g, double d, double weight )
+	{
+		mA00 += weight * g.x * g.x; mA01 += weight * g.x * g.y; mA02 += weight * g.x * g.z;
+		mA11 += weight * g.y * g.y; mA12 += weight * g.y * g.z; mA22 += weight * g.z * g.z;
+		mB0 += weight * g.x * d; mB1 += weight * g.y * d; mB2 += weight * g.z * d;
+		mC += weight * d * d;
+	}
+
+	double	eval( const vec3 &p ) const
+	{
+		const double x = p.x, y = p.y, z = p.z;
+		return mA00 * x * x + mA11 * y * y + mA22 * z * z + 2 * ( mA01 * x * y + mA02 * x * z + mA12 * y * z )
+			+ 2 * ( mB0 * x + mB1 * y + mB2 * z ) + mC;
+	}
+
+	Quadric&	operator+=( const Quadric &rhs )
+	{
+		mA00 += rhs.mA00; mA01 += rhs.mA01; mA02 += rhs.mA02; mA11 += rhs.mA11; mA12 += rhs.mA12; mA22 += rhs.mA22;
+		mB0 += rhs.mB0; mB1 += rhs.mB1; mB2 += rhs.mB2; mC += rhs.mC; mWeight += rhs.mWeight;
+		return *this;
+	}
+
+	double	mA00, mA01, mA02, mA11, mA12, mA22;
+	double	mB0, mB1, mB2, mC;
+	double	mWeight;
+};
+
+uint32_t hashFloats( const float *data, size_t count, uint32_t hash )
+{
+	for( size_t i = 0; i < count; ++i ) {
+		uint32_t k;
+		memcpy( &k, &data[i], sizeof( k ) );
+		k *= 0xcc9e2d51; k = ( k << 15 ) | ( k >> 17 ); k *= 0x1b873593;
+		hash ^= k; hash = ( hash << 13 ) | ( hash >> 19 ); hash = hash * 5 + 0xe6546b64;
+	}
+	return hash ^ ( hash >> 16 );
+}
+
+//! Maps every vertex to the first vertex which \a equal considers identical, using an open addressing table
+template<typename HashFn, typename EqualFn>
+void buildRemap( size_t count, vector<uint32_t> *result, const HashFn &hash, const EqualFn &equal )
+{
+	size_t tableSize = 1;
+	while( tableSize < count + count / 4 )
+		tableSize *= 2;
+	const size_t mask = tableSize - 1;
+
+	vector<uint32_t> table( tableSize, INVALID );
+	result->resize( count );
+	for( uint32_t v = 0; v < (uint32_t)count; ++v ) {
+		size_t slot = hash( v ) & mask;
+		for( size_t probe = 1; ; ++probe ) {
+			const uint32_t existing = table[slot];
+			if( existing == INVALID ) {
+				table[slot] = v;
+				(*result)[v] = v;
+				break;
+			}
+			if( equal( existing, v ) ) {
+				(*result)[v] = existing;
+				break;
+			}
+			slot = ( slot + probe ) & mask;
+		}
+	}
+}
+
+//! Renumbers the vertices referenced by \a indices in order of first use and returns the original index of each
+vector<uint32_t> compactVertices( vector<uint32_t> *indices, size_t numVertices )
+{
+	vector<uint32_t> remap( numVertices, INVALID ), result;
+	for( auto &index : *indices ) {
+		if( remap[index] == INVALID ) {
+			remap[index] = (uint32_t)result.size();
+			result.push_back( index );
+		}
+		index = remap[index];
+	}
+	return result;
+}
+
+vector<float> gatherVertices( const float *data, uint8_t dims, const vector<uint32_t> &vertices )
+{
+	vector<float> result( vertices.size() * dims );
+	for( size_t v = 0; v < vertices.size(); ++v )
+		memcpy( &result[v * dims], &data[vertices[v] * dims], dims * sizeof( float ) );
+	return result;
+}
+
+/*! Half-edge collapse simplifier. Positions are welded across attribute seams, so each group of coincident vertices (keyed by its first vertex)
+	is one node of the topology, while the distinct vertices of a group ("wedges") keep their own attributes and attribute quadrics.
+	Candidate collapses live in a heap whose stale entries are discarded lazily by comparing per-vertex version stamps. */
+class QuadricSimplifier {
+  public:
+	QuadricSimplifier( const float *positions, size_t numVertices, const uint32_t *indices, size_t numIndices, const vector<AttribStream> &attribs, bool preserveBoundaries );
+
+	//! Collapses edges until at most \a targetTriangles remain or the cheapest collapse exceeds \a maxError. Can be called repeatedly with decreasing targets.
+	void	run( size_t targetTriangles, float maxError );
+
+	size_t	getNumTriangles() const { return mNumTriangles; }
+	//! Returns the largest collapse error so far, as a fraction of the largest bounding box extent
+	float	getError() const { return (float)sqrt( mError ); }
+	//! Returns the remaining triangles in terms of the input vertices
+	void	getIndices( vector<uint32_t> *result ) const;
+
+  private:
+	enum Kind : uint8_t { MANIFOLD, BOUNDARY, LOCKED, COLLAPSED };
+
+	struct Collapse {
+		//! Orders the heap by increasing cost
+		bool	operator<( const Collapse &rhs ) const { return mCost > rhs.mCost; }
+
+		float		mCost;
+		uint32_t	mFrom, mTo;
+		uint32_t	mVersion; //!< sum of both endpoints' versions, which only ever grow
+	};
+
+	typedef vector<pair<uint32_t,uint32_t>>	WedgeMap;
+
+	uint32_t	vertexAt( uint32_t corner ) const { return mCanonical[mTriangles[corner]]; }
+	bool		isLive( uint32_t corner ) const { return ! mDeadTriangles[corner / 3]; }
+	static uint32_t	nextCorner( uint32_t corner ) { return corner % 3 == 2 ? corner - 2 : corner + 1; }
+	static uint32_t	prevCorner( uint32_t corner ) { return corner % 3 == 0 ? corner + 2 : corner - 1; }
+
+	void	classify( uint32_t vertex, vector<pair<uint32_t,uint32_t>> *edges );
+	double	attribError( uint32_t wedge, const vec3 &position, uint32_t target ) const;
+	bool	evaluate( uint32_t from, uint32_t to, WedgeMap *wedgeMap, double *cost ) const;
+	bool	findCollapse( uint32_t a, uint32_t b, WedgeMap *scratch, Collapse *result ) const;
+	bool	isLinkValid( uint32_t from, uint32_t to );
+	bool	preservesOrientation( uint32_t from, uint32_t to ) const;
+	void	collapse( uint32_t from, uint32_t to, const WedgeMap &wedgeMap );
+	void	gatherNeighbors( uint32_t vertex, vector<uint32_t> *result ) const;
+
+	bool				mPreserveBoundaries;
+	size_t				mNumComponents, mAttribStride, mNumTriangles;
+	double				mError;
+	uint32_t			mStamp;
+
+	vector<vec3>		mPositions; // normalized to the unit box
+	vector<uint32_t>	mCanonical, mFirstWedge, mNextWedge;
+	vector<uint32_t>	mTriangles, mFirstCorner, mNextCorner;
+	vector<uint8_t>		mDeadTriangles, mKinds;
+	vector<uint32_t>	mVersions, mMarks;
+	vector<Quadric>		mQuadrics;
+	vector<float>		mAttribValues; // weighted, mNumComponents per wedge
+	vector<float>		mAttribQuadrics; // area, then gradient and offset per component, for each wedge
+	vector<Collapse>	mHeap;
+};
+
+QuadricSimplifier::QuadricSimplifier( const float *positions, size_t numVertices, const uint32_t *indices, size_t numIndices, const vector<AttribStream> &attribs, bool preserveBoundaries )
+	: mPreserveBoundaries( preserveBoundaries ), mNumComponents( 0 ), mNumTriangles( 0 ), mError( 0 ), mStamp( 0 )
+{
+	const vec3 *inPositions = reinterpret_cast<const vec3*>( positions );
+
+	// normalize positions so that errors are relative to the extent
+	vec3 minimum( numeric_limits<float>::max() ), maximum( -numeric_limits<float>::max() );
+	for( size_t v = 0; v < numVertices; ++v ) {
+		minimum = glm::min( minimum, inPositions[v] );
+		maximum = glm::max( maximum, inPositions[v] );
+	}
+	const vec3 extent = maximum - minimum;
+	const float maxExtent = std::max( extent.x, std::max( extent.y, extent.z ) );
+	const float scale = maxExtent > 0 ? 1 / maxExtent : 1;
+	mPositions.resize( numVertices );
+	for( size_t v = 0; v < numVertices; ++v )
+		mPositions[v] = ( inPositions[v] - minimum ) * scale;
+
+	// weld vertices which agree on position and weighted attributes into wedges, then coincident wedges into vertices.
+	// Unweighted attributes such as per-face tangents would otherwise turn every edge into a seam.
+	vector<uint32_t> wedges;
+	buildRemap( numVertices, &wedges,
+		[&]( uint32_t v ) {
+			uint32_t hash = hashFloats( &positions[v * 3], 3, 0 );
+			for( const auto &attrib : attribs )
+				if( attrib.mWeight > 0 )
+					hash = hashFloats( &attrib.mData[v * attrib.mDims], attrib.mDims, hash );
+			return hash;
+		},
+		[&]( uint32_t a, uint32_t b ) {
+			if( memcmp( &positions[a * 3], &positions[b * 3], 3 * sizeof( float ) ) != 0 )
+				return false;
+			for( const auto &attrib : attribs )
+				if( attrib.mWeight > 0 && memcmp( &attrib.mData[a * attrib.mDims], &attrib.mData[b * attrib.mDims], attrib.mDims * sizeof( float ) ) != 0 )
+					return false;
+			return true;
+		} );
+	buildRemap( numVertices, &mCanonical,
+		[&]( uint32_t v ) { return hashFloats( &positions[v * 3], 3, 0 ); },
+		[&]( uint32_t a, uint32_t b ) { return memcmp( &positions[a * 3], &positions[b * 3], 3 * sizeof( float ) ) == 0; } );
+
+	// drop triangles which are degenerate after welding
+	mTriangles.reserve( numIndices );
+	for( size_t i = 0; i + 2 < numIndices; i += 3 ) {
+		const uint32_t a = wedges[indices[i]], b = wedges[indices[i + 1]], c = wedges[indices[i + 2]];
+		if( mCanonical[a] == mCanonical[b] || mCanonical[b] == mCanonical[c] || mCanonical[c] == mCanonical[a] )
+			continue;
+		mTriangles.push_back( a ); mTriangles.push_back( b ); mTriangles.push_back( c );
+	}
+	mNumTriangles = mTriangles.size() / 3;
+	mDeadTriangles.assign( mNumTriangles, 0 );
+
+	// per-vertex corner lists, in ascending order
+	mFirstCorner.assign( numVertices, INVALID );
+	mNextCorner.resize( mTriangles.size() );
+	for( size_t c = mTriangles.size(); c-- > 0; ) {
+		const uint32_t v = vertexAt( (uint32_t)c );
+		mNextCorner[c] = mFirstCorner[v];
+		mFirstCorner[v] = (uint32_t)c;
+	}
+
+	// circular lists of the wedges each vertex's triangles reference
+	mFirstWedge.assign( numVertices, INVALID );
+	mNextWedge.assign( numVertices, INVALID );
+	for( uint32_t w : mTriangles ) {
+		if( mNextWedge[w] != INVALID )
+			continue;
+		const uint32_t v = mCanonical[w];
+		if( mFirstWedge[v] == INVALID ) {
+			mFirstWedge[v] = w;
+			mNextWedge[w] = w;
+		}
+		else {
+			mNextWedge[w] = mNextWedge[mFirstWedge[v]];
+			mNextWedge[mFirstWedge[v]] = w;
+		}
+	}
+
+	// weighted attribute values
+	for( const auto &attrib : attribs )
+		if( attrib.mWeight > 0 )
+			mNumComponents += attrib.mDims;
+	mAttribStride = 1 + 4 * mNumComponents;
+	if( mNumComponents ) {
+		mAttribValues.resize( numVertices * mNumComponents );
+		mAttribQuadrics.assign( numVertices * mAttribStride, 0 );
+		size_t component = 0;
+		for( const auto &attrib : attribs ) {
+			if( attrib.mWeight <= 0 )
+				continue;
+			for( size_t v = 0; v < numVertices; ++v )
+				for( uint8_t d = 0; d < attrib.mDims; ++d )
+					mAttribValues[v * mNumComponents + component + d] = attrib.mData[v * attrib.mDims + d] * attrib.mWeight;
+			component += attrib.mDims;
+		}
+	}
+
+	// classification and quadrics only touch each vertex's own data, so vertices are independent
+	mKinds.assign( numVertices, LOCKED );
+	mQuadrics.resize( numVertices );
+	mVersions.assign( numVertices, 0 );
+	mMarks.assign( numVertices, 0 );
+	parallelFor( numVertices, [&]( size_t begin, size_t end ) {
+		vector<pair<uint32_t,uint32_t>> edges;
+		for( size_t v = begin; v < end; ++v )
+			if( mFirstCorner[v] != INVALID )
+				classify( (uint32_t)v, &edges );
+	}, PARALLEL_GRAIN );
+
+	// initial candidates, one per edge. Each range keeps its own candidates, which are merged in vertex order so that
+	// the heap, and therefore the order of equal cost collapses, doesn't depend on how the ranges were scheduled
+	mutex rangesMutex;
+	map<size_t,vector<Collapse>> ranges;
+	parallelFor( numVertices, [&]( size_t begin, size_t end ) {
+		vector<uint32_t> neighbors;
+		WedgeMap scratch;
+		vector<Collapse> candidates;
+		for( size_t v = begin; v < end; ++v ) {
+			if( mFirstCorner[v] == INVALID )
+				continue;
+			gatherNeighbors( (uint32_t)v, &neighbors );
+			for( uint32_t n : neighbors ) {
+				Collapse candidate;
+				if( n > v && findCollapse( (uint32_t)v, n, &scratch, &candidate ) )
+					candidates.push_back( candidate );
+			}
+		}
+		lock_guard<mutex> lock( rangesMutex );
+		ranges[begin] = std::move( candidates );
+	}, PARALLEL_GRAIN );
+	for( const auto &range : ranges )
+		mHeap.insert( mHeap.end(), range.second.begin(), range.second.end() );
+	make_heap( mHeap.begin(), mHeap.end() );
+}
+
+void QuadricSimplifier::classify( uint32_t vertex, vector<pair<uint32_t,uint32_t>> *edges )
+{
+	// count the triangles on each incident edge
+	edges->clear();
+	for( uint32_t c = mFirstCorner[vertex]; c != INVALID; c = mNextCorner[c] ) {
+		edges->emplace_back( vertexAt( nextCorner( c ) ), 1 );
+		edges->emplace_back( vertexAt( prevCorner( c ) ), 1 );
+	}
+	sort( edges->begin(), edges->end() );
+	size_t numEdges = 0, numBoundaryEdges = 0;
+	bool manifold = true;
+	for( size_t i = 0; i < edges->size(); ) {
+		size_t j = i + 1;
+		while( j < edges->size() && (*edges)[j].first == (*edges)[i].first )
+			++j;
+		const uint32_t count = uint32_t( j - i );
+		(*edges)[numEdges++] = make_pair( (*edges)[i].first, count );
+		manifold = manifold && count <= 2;
+		numBoundaryEdges += count == 1;
+		i = j;
+	}
+	edges->resize( numEdges );
+	auto isBoundaryEdge = [&]( uint32_t other ) {
+		return lower_bound( edges->begin(), edges->end(), make_pair( other, 0u ) )->second == 1;
+	};
+
+	if( ! manifold || numBoundaryEdges > 2 || numBoundaryEdges == 1 )
+		mKinds[vertex] = LOCKED;
+	else if( numBoundaryEdges == 2 )
+		mKinds[vertex] = mPreserveBoundaries ? LOCKED : BOUNDARY;
+	else
+		mKinds[vertex] = MANIFOLD;
+
+	Quadric &quadric = mQuadrics[vertex];
+	for( uint32_t c = mFirstCorner[vertex]; c != INVALID; c = mNextCorner[c] ) {
+		const uint32_t a = vertexAt( nextCorner( c ) ), b = vertexAt( prevCorner( c ) );
+		const dvec3 p0( mPositions[vertex] ), p1( mPositions[a] ), p2( mPositions[b] );
+		const dvec3 e1 = p1 - p0, e2 = p2 - p0;
+		const dvec3 n = cross( e1, e2 );
+		const double lengthSquared = dot( n, n );
+		if( lengthSquared <= 0 )
+			continue;
+		const double length = sqrt( lengthSquared ), area = 0.5 * length;
+		const dvec3 normal = n / length;
+		quadric.add( normal, -dot( normal, p0 ), area );
+		quadric.mWeight += area;
+
+		// planes through open boundary edges, perpendicular to the face, keep the outline in place
+		if( isBoundaryEdge( a ) ) {
+			const double weight = BOUNDARY_WEIGHT * dot( e1, e1 );
+			const dvec3 perpendicular = normalize( cross( e1, normal ) );
+			quadric.add( perpendicular, -dot( perpendicular, p0 ), weight );
+			quadric.mWeight += weight;
+		}
+		if( isBoundaryEdge( b ) ) {
+			const double weight = BOUNDARY_WEIGHT * dot( e2, e2 );
+			const dvec3 perpendicular = normalize( cross( -e2, normal ) );
+			quadric.add( perpendicular, -dot( perpendicular, p0 ), weight );
+			quadric.mWeight += weight;
+		}
+
+		if( ! mNumComponents )
+			continue;
+
+		// each attribute component varies linearly across the face; its gradient turns the deviation from that plane into a quadric.
+		// Terms independent of the attribute value merge into the vertex quadric, the rest stay with the wedge.
+		const uint32_t w0 = mTriangles[c], w1 = mTriangles[nextCorner( c )], w2 = mTriangles[prevCorner( c )];
+		const float *s0 = &mAttribValues[w0 * mNumComponents], *s1 = &mAttribValues[w1 * mNumComponents], *s2 = &mAttribValues[w2 * mNumComponents];
+		const dvec3 g1 = cross( e2, n ) / lengthSquared, g2 = cross( n, e1 ) / lengthSquared;
+		float *wedgeQuadric = &mAttribQuadrics[w0 * mAttribStride];
+		wedgeQuadric[0] += (float)area;
+		for( size_t k = 0; k < mNumComponents; ++k ) {
+			const dvec3 gradient = double( s1[k] - s0[k] ) * g1 + double( s2[k] - s0[k] ) * g2;
+			const double offset = s0[k] - dot( gradient, p0 );
+			quadric.add( gradient, offset, area );
+			float *component = &wedgeQuadric[1 + k * 4];
+			component[0] += float( area * gradient.x );
+			component[1] += float( area * gradient.y );
+			component[2] += float( area * gradient.z );
+			component[3] += float( area * offset );
+		}
+	}
+}
+
+double QuadricSimplifier::attribError( uint32_t wedge, const vec3 &position, uint32_t target ) const
+{
+	const float *wedgeQuadric = &mAttribQuadrics[wedge * mAttribStride];
+	const float *values = &mAttribValues[target * mNumComponents];
+	const double area = wedgeQuadric[0];
+	double result = 0;
+	for( size_t k = 0; k < mNumComponents; ++k ) {
+		const float *component = &wedgeQuadric[1 + k * 4];
+		const double s = values[k];
+		result += s * s * area - 2 * s * ( component[0] * position.x + component[1] * position.y + component[2] * position.z + component[3] );
+	}
+	return result;
+}
+
+bool QuadricSimplifier::evaluate( uint32_t from, uint32_t to, WedgeMap *wedgeMap, double *cost ) const
+{
+	if( mKinds[from] != MANIFOLD && mKinds[from] != BOUNDARY )
+		return false;
+
+	// each wedge of 'from' has to follow a single wedge of 'to' across the triangles which the collapse removes
+	wedgeMap->clear();
+	size_t numShared = 0;
+	for( uint32_t c = mFirstCorner[from]; c != INVALID; c = mNextCorner[c] ) {
+		if( ! isLive( c ) )
+			continue;
+		uint32_t other = nextCorner( c );
+		if( vertexAt( other ) != to ) {
+			other = prevCorner( c );
+			if( vertexAt( other ) != to )
+				continue;
+		}
+		++numShared;
+		const uint32_t source = mTriangles[c], target = mTriangles[other];
+		auto existing = find_if( wedgeMap->begin(), wedgeMap->end(), [source]( const pair<uint32_t,uint32_t> &entry ) { return entry.first == source; } );
+		if( existing == wedgeMap->end() )
+			wedgeMap->emplace_back( source, target );
+		else if( existing->second != target )
+			return false;
+	}
+
+	// a boundary vertex may only slide along its boundary
+	if( numShared == 0 || ( mKinds[from] == BOUNDARY && numShared != 1 ) )
+		return false;
+
+	size_t numWedges = 0;
+	uint32_t w = mFirstWedge[from];
+	do {
+		++numWedges;
+		w = mNextWedge[w];
+	} while( w != mFirstWedge[from] );
+	if( numWedges != wedgeMap->size() )
+		return false;
+	for( size_t i = 1; i < wedgeMap->size(); ++i )
+		for( size_t j = 0; j < i; ++j )
+			if( (*wedgeMap)[i].second == (*wedgeMap)[j].second )
+				return false;
+
+	const vec3 &position = mPositions[to];
+	const double weight = mQuadrics[from].mWeight + mQuadrics[to].mWeight;
+	double error = mQuadrics[from].eval( position ) + mQuadrics[to].eval( position );
+	if( mNumComponents ) {
+		for( const auto &entry : *wedgeMap )
+			error += attribError( entry.first, position, entry.second );
+		w = mFirstWedge[to];
+		do {
+			error += attribError( w, position, w );
+			w = mNextWedge[w];
+		} while( w != mFirstWedge[to] );
+	}
+
+	*cost = weight > 0 ? std::max( error, 0.0 ) / weight : 0;
+	return true;
+}
+
+bool QuadricSimplifier::findCollapse( uint32_t a, uint32_t b, WedgeMap *scratch, Collapse *result ) const
+{
+	double costAB, costBA;
+	const bool validAB = evaluate( a, b, scratch, &costAB );
+	const bool validBA = evaluate( b, a, scratch, &costBA );
+	if( ! validAB && ! validBA )
+		return false;
+
+	if( validAB && ( ! validBA || costAB <= costBA ) )
+		*result = { (float)costAB, a, b, mVersions[a] + mVersions[b] };
+	else
+		*result = { (float)costBA, b, a, mVersions[a] + mVersions[b] };
+	return true;
+}
+
+bool QuadricSimplifier::isLinkValid( uint32_t from, uint32_t to )
+{
+	// the vertices adjacent to both endpoints must be exactly the apexes of the triangles which the collapse removes
+	if( mStamp >= INVALID - 2 ) {
+		fill( mMarks.begin(), mMarks.end(), 0 );
+		mStamp = 0;
+	}
+	mStamp += 2;
+	for( uint32_t c = mFirstCorner[to]; c != INVALID; c = mNextCorner[c] ) {
+		if( isLive( c ) ) {
+			mMarks[vertexAt( nextCorner( c ) )] = mStamp;
+			mMarks[vertexAt( prevCorner( c ) )] = mStamp;
+		}
+	}
+
+	size_t numShared = 0, numCommon = 0;
+	for( uint32_t c = mFirstCorner[from]; c != INVALID; c = mNextCorner[c] ) {
+		if( ! isLive( c ) )
+			continue;
+		const uint32_t a = vertexAt( nextCorner( c ) ), b = vertexAt( prevCorner( c ) );
+		numShared += a == to || b == to;
+		for( uint32_t n : { a, b } ) {
+			if( n != to && mMarks[n] == mStamp ) {
+				mMarks[n] = mStamp + 1;
+				++numCommon;
+			}
+		}
+	}
+
+	return numCommon == numShared;
+}
+
+bool QuadricSimplifier::preservesOrientation( uint32_t from, uint32_t to ) const
+{
+	const vec3 &p0 = mPositions[from], &p1 = mPositions[to];
+	for( uint32_t c = mFirstCorner[from]; c != INVALID; c = mNextCorner[c] ) {
+		if( ! isLive( c ) )
+			continue;
+		const uint32_t a = vertexAt( nextCorner( c ) ), b = vertexAt( prevCorner( c ) );
+		if( a == to || b == to )
+			continue;
+		const vec3 &pa = mPositions[a], &pb = mPositions[b];
+		const vec3 before = cross( pa - p0, pb - p0 ), after = cross( pa - p1, pb - p1 );
+		if( dot( before, after ) < MIN_NORMAL_COS * sqrt( dot( before, before ) * dot( after, after ) ) )
+			return false;
+	}
+
+	return true;
+}
+
+void QuadricSimplifier::collapse( uint32_t from, uint32_t to, const WedgeMap &wedgeMap )
+{
+	mQuadrics[to] += mQuadrics[from];
+	if( mNumComponents ) {
+		for( const auto &entry : wedgeMap ) {
+			const float *source = &mAttribQuadrics[entry.first * mAttribStride];
+			float *target = &mAttribQuadrics[entry.second * mAttribStride];
+			for( size_t i = 0; i < mAttribStride; ++i )
+				target[i] += source[i];
+		}
+	}
+
+	// retarget the surviving corners of 'from' and splice them into the list of 'to', dropping dead corners along the way
+	uint32_t head = INVALID, *tail = &head;
+	for( uint32_t c = mFirstCorner[from], next; c != INVALID; c = next ) {
+		next = mNextCorner[c];
+		if( ! isLive( c ) )
+			continue;
+		if( vertexAt( nextCorner( c ) ) == to || vertexAt( prevCorner( c ) ) == to ) {
+			mDeadTriangles[c / 3] = 1;
+			--mNumTriangles;
+			continue;
+		}
+		for( const auto &entry : wedgeMap ) {
+			if( entry.first == mTriangles[c] ) {
+				mTriangles[c] = entry.second;
+				break;
+			}
+		}
+		*tail = c;
+		tail = &mNextCorner[c];
+	}
+	for( uint32_t c = mFirstCorner[to], next; c != INVALID; c = next ) {
+		next = mNextCorner[c];
+		if( ! isLive( c ) )
+			continue;
+		*tail = c;
+		tail = &mNextCorner[c];
+	}
+	*tail = INVALID;
+
+	mFirstCorner[to] = head;
+	mFirstCorner[from] = INVALID;
+	mKinds[from] = COLLAPSED;
+	++mVersions[to];
+}
+
+void QuadricSimplifier::gatherNeighbors( uint32_t vertex, vector<uint32_t> *result ) const
+{
+	result->clear();
+	for( uint32_t c = mFirstCorner[vertex]; c != INVALID; c = mNextCorner[c] ) {
+		if( isLive( c ) ) {
+			result->push_back( vertexAt( nextCorner( c ) ) );
+			result->push_back( vertexAt( prevCorner( c ) ) );
+		}
+	}
+	sort( result->begin(), result->end() );
+	result->erase( unique( result->begin(), result->end() ), result->end() );
+}
+
+void QuadricSimplifier::run( size_t targetTriangles, float maxError )
+{
+	const double maxCost = (double)maxError * maxError;
+	WedgeMap wedgeMap, scratch;
+	vector<uint32_t> neighbors;
+	while( mNumTriangles > targetTriangles && ! mHeap.empty() ) {
+		const Collapse top = mHeap.front();
+		if( top.mCost > maxCost )
+			break;
+		pop_heap( mHeap.begin(), mHeap.end() );
+		mHeap.pop_back();
+
+		if( mKinds[top.mFrom] == COLLAPSED || mKinds[top.mTo] == COLLAPSED || mVersions[top.mFrom] + mVersions[top.mTo] != top.mVersion )
+			continue;
+		// the neighborhood may have changed through other vertices since this entry was pushed
+		double cost;
+		if( ! evaluate( top.mFrom, top.mTo, &wedgeMap, &cost ) || ! isLinkValid( top.mFrom, top.mTo ) || ! preservesOrientation( top.mFrom, top.mTo ) )
+			continue;
+
+		mError = std::max( mError, cost );
+		collapse( top.mFrom, top.mTo, wedgeMap );
+
+		gatherNeighbors( top.mTo, &neighbors );
+		for( uint32_t n : neighbors ) {
+			Collapse candidate;
+			if( findCollapse( top.mTo, n, &scratch, &candidate ) ) {
+				mHeap.push_back( candidate );
+				push_heap( mHeap.begin(), mHeap.end() );
+			}
+		}
+	}
+}
+
+void QuadricSimplifier::getIndices( vector<uint32_t> *result ) const
+{
+	result->clear();
+	result->reserve( mNumTriangles * 3 );
+	for( size_t t = 0; t < mDeadTriangles.size(); ++t )
+		if( ! mDeadTriangles[t] )
+			result->insert( result->end(), &mTriangles[t * 3], &mTriangles[t * 3] + 3 );
+}
+
+size_t targetTriangles( size_t numTriangles, float ratio )
+{
+	return size_t( numTriangles * glm::clamp( ratio, 0.0f, 1.0f ) );
+}
+
+} // anonymous namespace
+
+namespace geom {
+
+///////////////////////////////////////////////////////////////////////////////////////
+// Simplify
+struct Simplify::Result {
+	struct Attribute {
+		Attrib			mAttrib;
+		uint8_t			mDims;
+		vector<float>	mData;
+	};
+
+	vector<Attribute>	mAttribData;
+	size_t				mNumVertices;
+	vector<uint32_t>	mIndices;
+	float				mError;
+};
+
+Simplify::Simplify()
+	: mRatio( 0.5f ), mMaxError( numeric_limits<float>::max() ), mPreserveBoundaries( false ), mResultError( nullptr )
+{
+	mAttribWeights[NORMAL] = 0.5f;
+	mAttribWeights[TEX_COORD_0] = 1;
+	mAttribWeights[COLOR] = 1;
+}
+
+float Simplify::getAttribWeight( Attrib attrib ) const
+{
+	auto it = mAttribWeights.find( attrib );
+	return it != mAttribWeights.end() ? it->second : 0;
+}
+
+bool Simplify::calcCacheKey( CacheKey *key ) const
+{
+	if( mResultError )
+		return false;
+
+	if( ! key->appendType( *this ) )
+		return false;
+	*key << mRatio << mMaxError << mPreserveBoundaries << mAttribWeights.size();
+	for( const auto &weight : mAttribWeights )
+		*key << weight.first << weight.second;
+	return true;
+}
+
+Modifier* Simplify::clone() const
+{
+	return new Simplify( *this );
+}
+
+size_t Simplify::getNumVertices( const Modifier::Params &upstreamParams ) const
+{
+	auto result = getResult( upstreamParams );
+	return result ? result->mNumVertices : upstreamParams.getNumVertices();
+}
+
+size_t Simplify::getNumIndices( const Modifier::Params &upstreamParams ) const
+{
+	auto result = getResult( upstreamParams );
+	return result ? result->mIndices.size() : upstreamParams.getNumIndices();
+}
+
+AttribSet Simplify::calcUpstreamAttribs( const AttribSet &requestedAttribs ) const
+{
+	AttribSet result = requestedAttribs;
+	result.insert( POSITION );
+	for( const auto &weight : mAttribWeights )
+		if( weight.second > 0 )
+			result.insert( weight.first );
+	return result;
+}
+
+shared_ptr<const Simplify::Result> Simplify::getResult( const Modifier::Params &upstreamParams ) const
+{
+	if( upstreamParams.getPrimitive() != Primitive::TRIANGLES || ! upstreamParams.mSourceMods )
+		return nullptr;
+
+	// getNumVertices() and getNumIndices() are typically queried back to back before the load
+	const Source *source = upstreamParams.mSourceMods->getSource();
+	{
+		lock_guard<mutex> lock( mPending.mMutex );
+		if( mPending.mResult && mPending.mSource == source && mPending.mNumVertices == upstreamParams.getNumVertices() && mPending.mNumIndices == upstreamParams.getNumIndices() )
+			return mPending.mResult;
+	}
+
+	// load everything upstream provides, so that process() can use the result for any request
+	const AttribSet attribs = calcUpstreamAttribs( upstreamParams.getAvailableAttribs() );
+	SourceModsContext upstream( upstreamParams );
+	upstream.preload( attribs );
+	shared_ptr<Result> result = simplify( &upstream, attribs );
+	if( result ) {
+		lock_guard<mutex> lock( mPending.mMutex );
+		mPending.mSource = source;
+		mPending.mNumVertices = upstreamParams.getNumVertices();
+		mPending.mNumIndices = upstreamParams.getNumIndices();
+		mPending.mResult = result;
+	}
+	return result;
+}
+
+shared_ptr<const Simplify::Result> Simplify::takeResult( const Source *source ) const
+{
+	lock_guard<mutex> lock( mPending.mMutex );
+	shared_ptr<const Result> result;
+	if( mPending.mSource == source )
+		result = std::move( mPending.mResult );
+	mPending.mResult.reset();
+	mPending.mSource = nullptr;
+	return result;
+}
+
+shared_ptr<Simplify::Result> Simplify::simplify( SourceModsContext *ctx, const AttribSet &attribs ) const
+{
+	if( ctx->getPrimitive() != Primitive::TRIANGLES || ctx->getAttribDims( POSITION ) != 3 )
+		return nullptr;
+
+	const size_t numVertices = ctx->getNumVertices();
+	auto result = make_shared<Result>();
+	vector<uint32_t> &indices = result->mIndices;
+	if( ctx->getNumIndices() )
+		indices.assign( ctx->getIndicesData(), ctx->getIndicesData() + ctx->getNumIndices() );
+	else {
+		indices.resize( numVertices );
+		iota( indices.begin(), indices.end(), 0 );
+	}
+
+	const AttribSet available = ctx->getAvailableAttribs();
+	vector<AttribStream> streams;
+	for( Attrib attr : available )
+		if( attr != POSITION )
+			streams.push_back( { attr, ctx->getAttribData( attr ), ctx->getAttribDims( attr ), getAttribWeight( attr ) } );
+
+	QuadricSimplifier simplifier( ctx->getAttribData( POSITION ), numVertices, indices.data(), indices.size(), streams, mPreserveBoundaries );
+	simplifier.run( targetTriangles( indices.size() / 3, mRatio ), mMaxError );
+	simplifier.getIndices( &indices );
+	result->mError = simplifier.getError();
+
+	const vector<uint32_t> vertices = compactVertices( &indices, numVertices );
+	result->mNumVertices = vertices.size();
+	for( Attrib attr : available ) {
+		const uint8_t dims = ctx->getAttribDims( attr );
+		result->mAttribData.push_back( { attr, dims, gatherVertices( ctx->getAttribData( attr ), dims, vertices ) } );
+	}
+	return result;
+}
+
+void Simplify::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
+{
+	const AttribSet attribs = calcUpstreamAttribs( requestedAttribs );
+	shared_ptr<const Result> result = takeResult( ctx->getSource() );
+	if( ! result ) {
+		ctx->processUpstream( attribs );
+
+		if( ctx->getPrimitive() != Primitive::TRIANGLES ) {
+			CI_LOG_E( "geom::Simplify only supports TRIANGLES primitive." );
+			return;
+		}
+
+		if( ctx->getAttribDims( POSITION ) != 3 ) {
+			CI_LOG_E( "geom::Simplify requires 3D POSITION." );
+			return;
+		}
+
+		result = simplify( ctx, attribs );
+	}
+
+	if( mResultError )
+		*mResultError = result->mError;
+	for( const auto &attrib : result->mAttribData )
+		ctx->copyAttrib( attrib.mAttrib, attrib.mDims, 0, attrib.mData.data(), result->mNumVertices );
+	ctx->copyIndices( Primitive::TRIANGLES, result->mIndices.data(), result->mIndices.size(), 4 );
+}
+
+} // namespace geom
+
+///////////////////////////////////////////////////////////////////////////////////////
+// TriMesh
+float TriMesh::simplify( float targetRatio, float targetError )
+{
+	float error = 0;
+	*this = TriMesh( *this >> geom::Simplify().ratio( targetRatio ).maxError( targetError ).resultError( &error ) );
+	return error;
+}
+
+vector<TriMeshRef> TriMesh::buildLodChain( const vector<float> &ratios, const geom::Simplify &options ) const
+{
+	vector<TriMeshRef> result;
+	if( mPositionsDims != 3 ) {
+		CI_LOG_E( "TriMesh::buildLodChain requires 3D positions." );
+		return result;
+	}
+
+	const size_t numVertices = getNumVertices();
+	const geom::AttribSet available = getAvailableAttribs();
+	vector<AttribStream> attribs;
+	for( geom::Attrib attr : available ) {
+		const float *data;
+		size_t stride;
+		uint8_t dims;
+		getAttribPointer( attr, &data, &stride, &dims );
+		if( attr != geom::Attrib::POSITION )
+			attribs.push_back( { attr, data, dims, options.getAttribWeight( attr ) } );
+	}
+
+	QuadricSimplifier simplifier( mPositions.data(), numVertices, mIndices.data(), mIndices.size(), attribs, options.getPreserveBoundaries() );
+
+	// every level continues from the previous one, so visit them from the finest to the coarsest
+	vector<size_t> order( ratios.size() );
+	iota( order.begin(), order.end(), 0 );
+	stable_sort( order.begin(), order.end(), [&]( size_t a, size_t b ) { return ratios[a] > ratios[b]; } );
+
+	const Format format = formatFromSource( *this );
+	result.resize( ratios.size() );
+	for( size_t level : order ) {
+		simplifier.run( targetTriangles( getNumTriangles(), ratios[level] ), options.getMaxError() );
+
+		TriMeshRef lod = TriMesh::create( format );
+		simplifier.getIndices( &lod->mIndices );
+		const vector<uint32_t> vertices = compactVertices( &lod->mIndices, numVertices );
+		for( geom::Attrib attr : available ) {
+			const float *data;
+			size_t stride;
+			uint8_t dims;
+			getAttribPointer( attr, &data, &stride, &dims );
+			lod->copyAttrib( attr, dims, 0, gatherVertices( data, dims, vertices ).data(), vertices.size() );
+		}
+		result[level] = lod;
+	}
+
+	return result;
+}
+
+} // namespace cinder
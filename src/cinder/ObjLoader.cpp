@@ -24,8 +24,20 @@
 */
 
 #include "cinder/ObjLoader.h"
+#include "cinder/MemoryMappedFile.h"
+#include "cinder/Thread.h"
 
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
+#include <stdexcept>
+
+#if defined( __has_include )
+	#if __has_include( <charconv> ) && ( __cplusplus >= 201703L || ( defined( _MSVC_LANG ) && _MSVC_LANG >= 201703L ) )
+		#include <charconv>
+	#endif
+#endif
+
 using namespace std;
 
 // For stoi
@@ -35,6 +47,463 @@ using namespace std;
 
 namespace cinder {
 
+namespace {
+
+// Per-face record of how a face affects its group's mHasTexCoords / mHasNormals, which depends on whether it's the group's first face
+enum FaceFlags : uint8_t {
+	FACE_HAS_VERTICES		= 1 << 0,
+	FACE_LAST_TEXCOORD		= 1 << 1, // the last vertex had a tex coord index
+	FACE_EMPTY_TEXCOORD		= 1 << 2, // some vertex had an empty tex coord index, as in "1//1"
+	FACE_LAST_NORMAL		= 1 << 3, // the last vertex had a normal index
+	FACE_ANY_NORMAL			= 1 << 4, // some vertex had a normal index
+	FACE_RELATIVE_INDICES	= 1 << 5  // negative indices are relative to the group's base offsets
+};
+
+struct GroupStart {
+	size_t			mFirstFace;
+	size_t			mNumVertices, mNumTexCoords, mNumNormals; // chunk-local attribute counts at the "g" line
+	std::string		mName;
+};
+
+// Everything parsed from one line-aligned chunk of the file. Anything that depends on earlier chunks - group base offsets,
+// group flags, the material in effect - is recorded here and resolved when the chunks are stitched together in order.
+struct ParsedChunk {
+	ParsedChunk()
+		: mMaterialChanged( false ), mMaterial( nullptr ), mNumFacesBeforeMaterial( 0 )
+	{}
+
+	std::vector<vec3>				mVertices, mNormals;
+	std::vector<vec2>				mTexCoords;
+	std::vector<ObjLoader::Face>	mFaces;
+	std::vector<uint8_t>			mFaceFlags;
+	std::vector<GroupStart>			mGroupStarts;
+
+	bool							mMaterialChanged; // whether any "usemtl" in this chunk named a known material
+	const ObjLoader::Material*		mMaterial;
+	size_t							mNumFacesBeforeMaterial; // faces inheriting the material from the previous chunk
+};
+
+inline bool isSpace( char c )
+{
+	return c == ' ' || ( c >= '\t' && c <= '\r' );
+}
+
+// Equivalent to std::stoi( std::string( str, length ).substr( pos, count ) ), including its exceptions
+int substrToInt( const char *str, size_t length, size_t pos, size_t count )
+{
+	if( pos > length )
+		throw std::out_of_range( "substr" );
+
+	const char *it = str + pos;
+	const char *end = it + std::min( count, length - pos );
+	while( it != end && isSpace( *it ) )
+		++it;
+	bool negative = false;
+	if( it != end && ( *it == '-' || *it == '+' ) )
+		negative = ( *it++ == '-' );
+	if( it == end || *it < '0' || *it > '9' )
+		throw std::invalid_argument( "stoi" );
+
+	int64_t value = 0;
+	for( ; it != end && *it >= '0' && *it <= '9'; ++it ) {
+		value = value * 10 + ( *it - '0' );
+		if( value > int64_t( numeric_limits<int>::max() ) + 1 )
+			throw std::out_of_range( "stoi" );
+	}
+	value = negative ? -value : value;
+	if( value > numeric_limits<int>::max() )
+		throw std::out_of_range( "stoi" );
+
+	return static_cast<int>( value );
+}
+
+// Extracts the next float like operator>> would, advancing \a it. On failure \a result is 0 and false is returned
+bool parseFloat( const char *&it, const char *end, float *result )
+{
+	*result = 0;
+	while( it != end && isSpace( *it ) )
+		++it;
+	// from_chars() doesn't accept a leading '+', and unlike operator>> it does accept "inf" and "nan"
+	const char *number = ( it != end && *it == '+' ) ? it + 1 : it;
+	const char *digits = ( number != end && *number == '-' ) ? number + 1 : number;
+	if( digits == end || ! ( ( *digits >= '0' && *digits <= '9' ) || *digits == '.' ) )
+		return false;
+
+#if defined( __cpp_lib_to_chars )
+	auto parsed = std::from_chars( number, end, *result );
+	if( parsed.ec != std::errc() ) {
+		*result = 0;
+		return false;
+	}
+	it = parsed.ptr;
+#else
+	char buffer[64];
+	size_t length = std::min<size_t>( end - number, sizeof( buffer ) - 1 );
+	memcpy( buffer, number, length );
+	buffer[length] = 0;
+	char *parsedEnd;
+	*result = strtof( buffer, &parsedEnd );
+	if( parsedEnd == buffer )
+		return false;
+	it = number + ( parsedEnd - buffer );
+#endif
+
+	return true;
+}
+
+// Extracts up to \a count floats, leaving the remainder at 0 after the first failure like a chain of operator>> would
+void parseFloats( const char *it, const char *end, float *result, int count )
+{
+	for( int i = 0; i < count; ++i )
+		if( ! parseFloat( it, end, &result[i] ) )
+			break;
+}
+
+// Returns the end of the line beginning at \a p: the first '\n' or '\r', or \a end
+const char* findLineEnd( const char *p, const char *end )
+{
+	const char *lf = static_cast<const char*>( memchr( p, '\n', end - p ) );
+	if( ! lf )
+		lf = end;
+	const char *cr = static_cast<const char*>( memchr( p, '\r', lf - p ) );
+	return cr ? cr : lf;
+}
+
+// Returns the start of the line following the terminator at \a lineEnd, treating "\r\n" as a single terminator like readLine()
+const char* skipLineTerminator( const char *lineEnd, const char *end )
+{
+	if( lineEnd == end )
+		return end;
+	if( *lineEnd == '\r' && lineEnd + 1 != end && lineEnd[1] == '\n' )
+		return lineEnd + 2;
+	return lineEnd + 1;
+}
+
+// Returns the start of the first line after \a p that isn't joined to its predecessor by a trailing '\'
+const char* findChunkBoundary( const char *p, const char *begin, const char *end )
+{
+	while( p < end ) {
+		const char *lf = static_cast<const char*>( memchr( p, '\n', end - p ) );
+		if( ! lf )
+			return end;
+		const char *last = ( lf > begin && lf[-1] == '\r' ) ? lf - 1 : lf;
+		p = lf + 1;
+		if( last == begin || last[-1] != '\\' )
+			return p;
+	}
+
+	return end;
+}
+
+void pushFaceIndex( int index, std::vector<int32_t> *indices, uint8_t *flags )
+{
+	if( index < 0 ) {
+		indices->push_back( index );
+		*flags |= FACE_RELATIVE_INDICES;
+	}
+	else
+		indices->push_back( index - 1 );
+}
+
+size_t findChar( const char *s, size_t length, char c, size_t offset )
+{
+	if( offset >= length )
+		return string::npos;
+	const char *found = static_cast<const char*>( memchr( s + offset, c, length - offset ) );
+	return found ? size_t( found - s ) : string::npos;
+}
+
+// Parses the "f" line \a s of \a length characters. Mirrors the original std::string-based parser exactly, including its
+// std::stoi() semantics and its search for slashes beyond the current vertex.
+void parseFace( const char *s, size_t length, const ObjLoader::Material *material, bool includeNormals, bool includeTexCoords, ParsedChunk *chunk )
+{
+	ObjLoader::Face result;
+	result.mNumVertices = 0;
+	result.mMaterial = material;
+	uint8_t flags = 0;
+
+	size_t offset = 2; // account for "f "
+	while( offset < length ) {
+		size_t endOfTriple, firstSlashOffset, secondSlashOffset;
+
+		while( offset < length && s[offset] == ' ' )
+			++offset;
+
+		// find the end of this triple "v/vt/vn"
+		endOfTriple = findChar( s, length, ' ', offset );
+		if( endOfTriple == string::npos ) endOfTriple = length;
+		firstSlashOffset = findChar( s, length, '/', offset );
+		if( firstSlashOffset != string::npos ) {
+			secondSlashOffset = findChar( s, length, '/', firstSlashOffset + 1 );
+			if( secondSlashOffset > endOfTriple ) secondSlashOffset = string::npos;
+		}
+		else
+			secondSlashOffset = string::npos;
+
+		// process the vertex index
+		int vertexIndex = ( firstSlashOffset != string::npos ) ?
+			substrToInt( s, length, offset, firstSlashOffset - offset ) :
+			substrToInt( s, length, offset, endOfTriple - offset );
+		pushFaceIndex( vertexIndex, &result.mVertexIndices, &flags );
+
+		// process the tex coord index
+		bool hasTexCoord = false;
+		if( includeTexCoords && ( firstSlashOffset != string::npos ) ) {
+			size_t numSize = ( secondSlashOffset == string::npos ) ? ( endOfTriple - firstSlashOffset - 1 ) : secondSlashOffset - firstSlashOffset - 1;
+			if( numSize > 0 ) {
+				pushFaceIndex( substrToInt( s, length, firstSlashOffset + 1, numSize ), &result.mTexCoordIndices, &flags );
+				hasTexCoord = true;
+			}
+			else
+				flags |= FACE_EMPTY_TEXCOORD;
+		}
+
+		// process the normal index
+		bool hasNormal = false;
+		if( includeNormals && ( secondSlashOffset != string::npos ) ) {
+			pushFaceIndex( substrToInt( s, length, secondSlashOffset + 1, endOfTriple - secondSlashOffset - 1 ), &result.mNormalIndices, &flags );
+			flags |= FACE_ANY_NORMAL;
+			hasNormal = true;
+		}
+
+		flags &= ~( FACE_LAST_TEXCOORD | FACE_LAST_NORMAL );
+		flags |= FACE_HAS_VERTICES | ( hasTexCoord ? FACE_LAST_TEXCOORD : 0 ) | ( hasNormal ? FACE_LAST_NORMAL : 0 );
+
+		offset = endOfTriple + 1;
+		result.mNumVertices++;
+	}
+
+	chunk->mFaces.push_back( std::move( result ) );
+	chunk->mFaceFlags.push_back( flags );
+}
+
+// Parses the lines in [begin, end). \a fileEnd bounds line continuations, which never cross a chunk boundary.
+void parseChunk( const char *begin, const char *end, const char *fileEnd, const std::map<std::string, ObjLoader::Material> &materials,
+				bool includeNormals, bool includeTexCoords, ParsedChunk *chunk )
+{
+	const ObjLoader::Material *currentMaterial = nullptr;
+	std::string joined;
+
+	const char *p = begin;
+	while( p < end ) {
+		const char *line = p;
+		const char *lineEnd = findLineEnd( p, fileEnd );
+		size_t length = lineEnd - line;
+		p = skipLineTerminator( lineEnd, fileEnd );
+		if( length == 0 || line[0] == '#' )
+			continue;
+
+		if( line[length - 1] == '\\' && p != fileEnd ) {
+			joined.assign( line, length );
+			while( ! joined.empty() && joined.back() == '\\' && p != fileEnd ) {
+				const char *nextEnd = findLineEnd( p, fileEnd );
+				joined.pop_back();
+				joined.append( p, nextEnd );
+				p = skipLineTerminator( nextEnd, fileEnd );
+			}
+			line = joined.data();
+			length = joined.size();
+		}
+
+		// the tag is the first whitespace-delimited token
+		const char *it = line, *lineLast = line + length;
+		while( it != lineLast && isSpace( *it ) )
+			++it;
+		const char *tag = it;
+		while( it != lineLast && ! isSpace( *it ) )
+			++it;
+		const size_t tagLength = it - tag;
+
+		if( tagLength == 1 && tag[0] == 'v' ) { // vertex
+			vec3 v;
+			parseFloats( it, lineLast, &v.x, 3 );
+			chunk->mVertices.push_back( v );
+		}
+		else if( tagLength == 2 && tag[0] == 'v' && tag[1] == 't' ) { // vertex texture coordinates
+			if( includeTexCoords ) {
+				vec2 tex;
+				parseFloats( it, lineLast, &tex.x, 2 );
+				chunk->mTexCoords.push_back( tex );
+			}
+		}
+		else if( tagLength == 2 && tag[0] == 'v' && tag[1] == 'n' ) { // vertex normals
+			if( includeNormals ) {
+				vec3 v;
+				parseFloats( it, lineLast, &v.x, 3 );
+				chunk->mNormals.push_back( normalize( v ) );
+			}
+		}
+		else if( tagLength == 1 && tag[0] == 'f' ) { // face
+			parseFace( line, length, currentMaterial, includeNormals, includeTexCoords, chunk );
+		}
+		else if( tagLength == 1 && tag[0] == 'g' ) { // group
+			GroupStart group;
+			group.mFirstFace = chunk->mFaces.size();
+			group.mNumVertices = chunk->mVertices.size();
+			group.mNumTexCoords = chunk->mTexCoords.size();
+			group.mNumNormals = chunk->mNormals.size();
+			size_t space = findChar( line, length, ' ', 0 );
+			group.mName.assign( line + ( ( space == string::npos ) ? 0 : space + 1 ), lineLast );
+			chunk->mGroupStarts.push_back( std::move( group ) );
+		}
+		else if( tagLength == 6 && memcmp( tag, "usemtl", 6 ) == 0 ) { // material
+			while( it != lineLast && isSpace( *it ) )
+				++it;
+			const char *name = it;
+			while( it != lineLast && ! isSpace( *it ) )
+				++it;
+			auto m = materials.find( std::string( name, it ) );
+			if( m != materials.end() ) {
+				if( ! chunk->mMaterialChanged ) {
+					chunk->mMaterialChanged = true;
+					chunk->mNumFacesBeforeMaterial = chunk->mFaces.size();
+				}
+				currentMaterial = &m->second;
+			}
+		}
+	}
+
+	if( ! chunk->mMaterialChanged )
+		chunk->mNumFacesBeforeMaterial = chunk->mFaces.size();
+	chunk->mMaterial = currentMaterial;
+}
+
+// Appends \a face to \a group, applying its effect on the group's flags and resolving relative indices
+void appendFace( ObjLoader::Group *group, ObjLoader::Face &&face, uint8_t flags )
+{
+	if( flags & FACE_HAS_VERTICES ) {
+		if( group->mFaces.empty() ) {
+			group->mHasTexCoords = ( flags & FACE_LAST_TEXCOORD ) != 0;
+			group->mHasNormals = ( flags & FACE_LAST_NORMAL ) != 0;
+		}
+		else {
+			if( flags & FACE_EMPTY_TEXCOORD )
+				group->mHasTexCoords = false;
+			if( flags & FACE_ANY_NORMAL )
+				group->mHasNormals = true;
+		}
+	}
+
+	if( flags & FACE_RELATIVE_INDICES ) {
+		for( auto &index : face.mVertexIndices )
+			if( index < 0 ) index += group->mBaseVertexOffset;
+		for( auto &index : face.mTexCoordIndices )
+			if( index < 0 ) index += group->mBaseTexCoordOffset;
+		for( auto &index : face.mNormalIndices )
+			if( index < 0 ) index += group->mBaseNormalOffset;
+	}
+
+	group->mFaces.push_back( std::move( face ) );
+}
+
+template<typename T>
+void concatenateParallel( std::vector<ParsedChunk> &chunks, std::vector<T> ParsedChunk::*member, std::vector<T> *result )
+{
+	std::vector<size_t> offsets( chunks.size() + 1, 0 );
+	for( size_t c = 0; c < chunks.size(); ++c )
+		offsets[c + 1] = offsets[c] + ( chunks[c].*member ).size();
+	result->resize( offsets.back() );
+	parallelFor( chunks.size(), [&]( size_t begin, size_t end ) {
+		for( size_t c = begin; c < end; ++c ) {
+			std::vector<T> &source = chunks[c].*member;
+			std::copy( source.begin(), source.end(), result->begin() + offsets[c] );
+			std::vector<T>().swap( source );
+		}
+	}, 1 );
+}
+
+// Reads the remainder of \a stream into memory
+Buffer readStreamRemainder( IStreamCinder *stream )
+{
+	off_t remaining = stream->size() - stream->tell();
+	Buffer result( std::max<size_t>( ( remaining > 0 ) ? remaining : 0, 64 * 1024 ) );
+	size_t size = 0;
+	while( ! stream->isEof() ) {
+		if( size == result.getAllocatedSize() )
+			result.resize( size * 2 );
+		size_t bytesRead = stream->readDataAvailable( static_cast<char*>( result.getData() ) + size, result.getAllocatedSize() - size );
+		if( bytesRead == 0 )
+			break;
+		size += bytesRead;
+	}
+	result.setSize( size );
+	return result;
+}
+
+} // anonymous namespace
+
+// Open-addressing hash table mapping a face's attribute indices to the output vertex they were first emitted as
+template<typename KeyT>
+class ObjLoader::UniqueVertexTable {
+  public:
+	explicit UniqueVertexTable( size_t expectedSize = 0 )
+		: mSize( 0 )
+	{
+		size_t capacity = 64;
+		while( capacity < expectedSize * 2 )
+			capacity *= 2;
+		mKeys.resize( capacity );
+		mValues.assign( capacity, -1 );
+	}
+
+	//! Returns the output vertex already associated with \a key, or associates it with \a index. The second member is true for a new key.
+	std::pair<int,bool> insert( const KeyT &key, int index )
+	{
+		if( ( mSize + 1 ) * 2 > mValues.size() )
+			grow();
+
+		const size_t mask = mValues.size() - 1;
+		for( size_t slot = hash( key ) & mask; ; slot = ( slot + 1 ) & mask ) {
+			if( mValues[slot] < 0 ) {
+				mKeys[slot] = key;
+				mValues[slot] = index;
+				++mSize;
+				return std::make_pair( index, true );
+			}
+			else if( mKeys[slot] == key )
+				return std::make_pair( mValues[slot], false );
+		}
+	}
+
+  private:
+	static size_t mix( uint64_t h )
+	{
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		return static_cast<size_t>( h );
+	}
+
+	static size_t hash( int key )					{ return mix( uint32_t( key ) ); }
+	static size_t hash( const VertexPair &key )		{ return mix( ( uint64_t( uint32_t( std::get<0>( key ) ) ) << 32 ) | uint32_t( std::get<1>( key ) ) ); }
+	static size_t hash( const VertexTriple &key )
+	{
+		return mix( ( ( uint64_t( uint32_t( std::get<0>( key ) ) ) << 32 ) | uint32_t( std::get<1>( key ) ) ) ^ ( uint64_t( uint32_t( std::get<2>( key ) ) ) * 0x9E3779B97F4A7C15ULL ) );
+	}
+
+	void grow()
+	{
+		std::vector<KeyT> keys( mKeys.size() * 2 );
+		std::vector<int> values( mValues.size() * 2, -1 );
+		const size_t mask = values.size() - 1;
+		for( size_t i = 0; i < mValues.size(); ++i ) {
+			if( mValues[i] < 0 )
+				continue;
+			size_t slot = hash( mKeys[i] ) & mask;
+			while( values[slot] >= 0 )
+				slot = ( slot + 1 ) & mask;
+			keys[slot] = mKeys[i];
+			values[slot] = mValues[i];
+		}
+		mKeys.swap( keys );
+		mValues.swap( values );
+	}
+
+	std::vector<KeyT>	mKeys;
+	std::vector<int>	mValues; // -1 marks an empty slot
+	size_t				mSize;
+};
+
 ObjLoader::ObjLoader( shared_ptr<IStreamCinder> stream, bool includeNormals, bool includeTexCoords, bool optimize )
 	: mStream( stream ), mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
 {
@@ -42,16 +511,16 @@ ObjLoader::ObjLoader( shared_ptr<IStreamCinder> stream, bool includeNormals, boo
 }
 
 ObjLoader::ObjLoader( DataSourceRef dataSource, bool includeNormals, bool includeTexCoords, bool optimize )
-	: mStream( dataSource->createStream() ), mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
+	: mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
 {
-	parse( includeNormals, includeTexCoords );
+	parse( dataSource, includeNormals, includeTexCoords );
 }
 
 ObjLoader::ObjLoader( DataSourceRef dataSource, DataSourceRef materialSource, bool includeNormals, bool includeTexCoords, bool optimize )
-	: mStream( dataSource->createStream() ), mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
+	: mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
 {
 	parseMaterial( materialSource->createStream() );
-	parse( includeNormals, includeTexCoords );
+	parse( dataSource, includeNormals, includeTexCoords );
 }
 
 ObjLoader& ObjLoader::groupIndex( size_t groupIndex )
@@ -108,7 +577,7 @@ void ObjLoader::loadInto( geom::Target *target, const geom::AttribSet & /*reques
 
 	// copy indices
 	if( getNumIndices() )
-		target->copyIndices( geom::Primitive::TRIANGLES, mOutputIndices.data(), getNumIndices(), 4 /* bytes per index */ );
+		target->copyIndices( geom::Primitive::TRIANGLES, mOutputIndices.data(), getNumIndices(), ( getNumVertices() <= 65536 ) ? 2 : 4 );
 }
 
 uint8_t	ObjLoader::getAttribDims( geom::Attrib attr ) const
@@ -183,139 +652,86 @@ void ObjLoader::parseMaterial( std::shared_ptr<IStreamCinder> material )
 
 void ObjLoader::parse( bool includeNormals, bool includeTexCoords )
 {
-	Group *currentGroup;
-	mGroups.push_back( Group() );
-	currentGroup = &mGroups[mGroups.size()-1];
-	currentGroup->mBaseVertexOffset = currentGroup->mBaseTexCoordOffset = currentGroup->mBaseNormalOffset = 0;
-
-    const Material *currentMaterial = 0;
-
-	size_t lineNumber = 0;
-	while( ! mStream->isEof() ) {
-		lineNumber++;
-		string line = mStream->readLine(), tag;
-        if( line.empty() || line[0] == '#' )
-            continue;
-
-		while( line.back() == '\\' && ! mStream->isEof() ) {
-			auto next = mStream->readLine();
-			line = line.substr( 0, line.size() - 1 ) + next;
-		}
+	Buffer contents = readStreamRemainder( mStream.get() );
+	parseBuffer( static_cast<const char*>( contents.getData() ), contents.getSize(), includeNormals, includeTexCoords );
+}
 
-		stringstream ss( line );
-		ss >> tag;
-		if( tag == "v" ) { // vertex
-			vec3 v;
-			ss >> v.x >> v.y >> v.z;
-			mInternalVertices.push_back( v );
-		}
-		else if( tag == "vt" ) { // vertex texture coordinates
-			if( includeTexCoords ) {
-				vec2 tex;
-				ss >> tex.x >> tex.y;
-				mInternalTexCoords.push_back( tex );
-			}
+void ObjLoader::parse( const DataSourceRef &dataSource, bool includeNormals, bool includeTexCoords )
+{
+	if( dataSource->isFilePath() ) {
+		MemoryMappedFileRef file;
+		try {
+			file = MemoryMappedFile::create( dataSource->getFilePath() );
 		}
-		else if( tag == "vn" ) { // vertex normals
-			if ( includeNormals ) {
-				vec3 v;
-				ss >> v.x >> v.y >> v.z;
-				mInternalNormals.push_back( normalize( v ) );
-			}
+		catch( const MemoryMappedFileExc & ) {
+			// fall back to reading the stream, e.g. for an empty file
 		}
-		else if( tag == "f" ) { // face
-			parseFace( currentGroup, currentMaterial, line, includeNormals, includeTexCoords );
+		if( file ) {
+			parseBuffer( static_cast<const char*>( file->getData() ), file->getSize(), includeNormals, includeTexCoords );
+			return;
 		}
-		else if( tag == "g" ) { // group
-			if( ! currentGroup->mFaces.empty() )
-				mGroups.push_back( Group() );
-			currentGroup = &mGroups[mGroups.size()-1];
-			currentGroup->mBaseVertexOffset = (int32_t)mInternalVertices.size();
-			currentGroup->mBaseTexCoordOffset = (int32_t)mInternalTexCoords.size();
-			currentGroup->mBaseNormalOffset = (int32_t)mInternalNormals.size();
-			currentGroup->mName = line.substr( line.find( ' ' ) + 1 );
-		}
-        else if( tag == "usemtl") { // material
-            string tag;
-            ss >> tag;
-            std::map<std::string, Material>::const_iterator m = mMaterials.find(tag);
-            if( m != mMaterials.end() ) {
-                currentMaterial = &m->second;
-            }
-        }
 	}
+
+	mStream = dataSource->createStream();
+	parse( includeNormals, includeTexCoords );
 }
 
-void ObjLoader::parseFace( Group *group, const Material *material, const std::string &s, bool includeNormals, bool includeTexCoords )
+void ObjLoader::parseBuffer( const char *data, size_t size, bool includeNormals, bool includeTexCoords )
 {
-	ObjLoader::Face result;
-	result.mNumVertices = 0;
-    result.mMaterial = material;
-
-	size_t offset = 2; // account for "f "
-	size_t length = s.length();
-	while( offset < length ) {
-		size_t endOfTriple, firstSlashOffset, secondSlashOffset;
-
-		while( s[offset] == ' ' )
-			++offset;
+	const char *dataEnd = data + size;
+
+	// split into chunks of whole lines, never separating a line from its '\' continuation
+	const size_t chunkSize = std::max<size_t>( 1024 * 1024, size / ( getNumParallelThreads() * 4 ) + 1 );
+	std::vector<const char*> chunkStarts( 1, data );
+	while( chunkStarts.back() != dataEnd ) {
+		const char *next = ( size_t( dataEnd - chunkStarts.back() ) > chunkSize ) ? findChunkBoundary( chunkStarts.back() + chunkSize, data, dataEnd ) : dataEnd;
+		chunkStarts.push_back( next );
+	}
 
-		// find the end of this triple "v/vt/vn"
-		endOfTriple = s.find( ' ', offset );
-		if( endOfTriple == string::npos ) endOfTriple = length;
-		firstSlashOffset = s.find( '/', offset );
-		if( firstSlashOffset != string::npos ) {
-			secondSlashOffset = s.find( '/', firstSlashOffset + 1 );
-			if( secondSlashOffset > endOfTriple ) secondSlashOffset = string::npos;
-		}
-		else
-			secondSlashOffset = string::npos;
+	std::vector<ParsedChunk> chunks( chunkStarts.size() - 1 );
+	parallelFor( chunks.size(), [&]( size_t begin, size_t end ) {
+		for( size_t c = begin; c < end; ++c )
+			parseChunk( chunkStarts[c], chunkStarts[c + 1], dataEnd, mMaterials, includeNormals, includeTexCoords, &chunks[c] );
+	}, 1 );
 
-		// process the vertex index
-		int vertexIndex = (firstSlashOffset != string::npos) ?
-            stoi( s.substr( offset, firstSlashOffset - offset ) ) :
-            stoi( s.substr( offset, endOfTriple - offset));
+	// stitch the chunks together in file order, resolving everything that depends on preceding chunks
+	mGroups.push_back( Group() );
+	Group *currentGroup = &mGroups.back();
+	currentGroup->mBaseVertexOffset = currentGroup->mBaseTexCoordOffset = currentGroup->mBaseNormalOffset = 0;
 
-		if( vertexIndex < 0 )
-			result.mVertexIndices.push_back( group->mBaseVertexOffset + vertexIndex );
-		else
-			result.mVertexIndices.push_back( vertexIndex - 1 );
+	const Material *currentMaterial = nullptr;
+	size_t numVertices = 0, numTexCoords = 0, numNormals = 0;
+	for( auto &chunk : chunks ) {
+		for( size_t f = 0; f < chunk.mNumFacesBeforeMaterial; ++f )
+			chunk.mFaces[f].mMaterial = currentMaterial;
+		if( chunk.mMaterialChanged )
+			currentMaterial = chunk.mMaterial;
 
-		// process the tex coord index
-		if( includeTexCoords && ( firstSlashOffset != string::npos ) ) {
-			size_t numSize = ( secondSlashOffset == string::npos ) ? ( endOfTriple - firstSlashOffset - 1 ) : secondSlashOffset - firstSlashOffset - 1;
-			if( numSize > 0 ) {
-				int texCoordIndex = stoi( s.substr( firstSlashOffset + 1, numSize ) );
-				if( texCoordIndex < 0 )
-					result.mTexCoordIndices.push_back( group->mBaseTexCoordOffset + texCoordIndex );
-				else
-					result.mTexCoordIndices.push_back( texCoordIndex - 1 );
-				if( group->mFaces.empty() )
-					group->mHasTexCoords = true;
-			}
-			else
-				group->mHasTexCoords = false;
-		}
-		else if( group->mFaces.empty() ) // if this is the first face, let's note that this group has no tex coords
-			group->mHasTexCoords = false;
+		size_t face = 0;
+		for( auto &groupStart : chunk.mGroupStarts ) {
+			for( ; face < groupStart.mFirstFace; ++face )
+				appendFace( currentGroup, std::move( chunk.mFaces[face] ), chunk.mFaceFlags[face] );
 
-		// process the normal index
-		if( includeNormals && ( secondSlashOffset != string::npos ) ) {
-			int normalIndex = stoi( s.substr( secondSlashOffset + 1, endOfTriple - secondSlashOffset - 1 ) );
-			if( normalIndex < 0 )
-				result.mNormalIndices.push_back( group->mBaseNormalOffset + normalIndex );
-			else
-				result.mNormalIndices.push_back( normalIndex - 1 );
-			group->mHasNormals = true;
+			if( ! currentGroup->mFaces.empty() )
+				mGroups.push_back( Group() );
+			currentGroup = &mGroups.back();
+			currentGroup->mBaseVertexOffset = (int32_t)( numVertices + groupStart.mNumVertices );
+			currentGroup->mBaseTexCoordOffset = (int32_t)( numTexCoords + groupStart.mNumTexCoords );
+			currentGroup->mBaseNormalOffset = (int32_t)( numNormals + groupStart.mNumNormals );
+			currentGroup->mName = std::move( groupStart.mName );
 		}
-		else if( group->mFaces.empty() ) // if this is the first face, let's note that this group has no normals
-			group->mHasNormals = false;
+		for( ; face < chunk.mFaces.size(); ++face )
+			appendFace( currentGroup, std::move( chunk.mFaces[face] ), chunk.mFaceFlags[face] );
+		std::vector<Face>().swap( chunk.mFaces );
 
-		offset = endOfTriple + 1;
-		result.mNumVertices++;
+		numVertices += chunk.mVertices.size();
+		numTexCoords += chunk.mTexCoords.size();
+		numNormals += chunk.mNormals.size();
 	}
 
-	group->mFaces.push_back( result );
+	concatenateParallel( chunks, &ParsedChunk::mVertices, &mInternalVertices );
+	concatenateParallel( chunks, &ParsedChunk::mTexCoords, &mInternalTexCoords );
+	concatenateParallel( chunks, &ParsedChunk::mNormals, &mInternalNormals );
 }
 
 void ObjLoader::load() const
@@ -331,6 +747,17 @@ void ObjLoader::load() const
 
 	bool hasGroupIndex = ( mGroupIndex != numeric_limits<size_t>::max() );
 
+	// size the indices and the unique vertex table up front; closed meshes share each vertex between several faces
+	size_t numFaceVertices = 0, numTriangleIndices = 0;
+	for( size_t g = ( hasGroupIndex ? mGroupIndex : 0 ); g < ( hasGroupIndex ? mGroupIndex + 1 : mGroups.size() ); ++g ) {
+		for( const auto &face : mGroups[g].mFaces ) {
+			numFaceVertices += face.mNumVertices;
+			numTriangleIndices += ( face.mNumVertices > 2 ) ? ( face.mNumVertices - 2 ) * 3 : 0;
+		}
+	}
+	mOutputIndices.reserve( numTriangleIndices );
+	const size_t expectedVertices = numFaceVertices / 4;
+
 	bool texCoords;
 	if( hasGroupIndex ) {
 		texCoords = mGroups[mGroupIndex].mHasTexCoords;
@@ -361,44 +788,44 @@ void ObjLoader::load() const
 
 	if( normals && texCoords ) {
 		if( hasGroupIndex ) {
-			map<VertexTriple,int> uniqueVerts;
+			UniqueVertexTable<VertexTriple> uniqueVerts( expectedVertices );
 			loadGroupNormalsTextures( mGroups[mGroupIndex], uniqueVerts );
 		}
 		else {
-			map<VertexTriple,int> uniqueVerts;
+			UniqueVertexTable<VertexTriple> uniqueVerts( expectedVertices );
 			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
 				loadGroupNormalsTextures( *groupIt, uniqueVerts );
 		}
 	}
 	else if( normals ) {
 		if( hasGroupIndex ) {
-			map<VertexPair,int> uniqueVerts;
+			UniqueVertexTable<VertexPair> uniqueVerts( expectedVertices );
 			loadGroupNormals( mGroups[mGroupIndex], uniqueVerts );
 		}
 		else {
-			map<VertexPair,int> uniqueVerts;
+			UniqueVertexTable<VertexPair> uniqueVerts( expectedVertices );
 			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
 				loadGroupNormals( *groupIt, uniqueVerts );
 		}
 	}
 	else if( texCoords ) {
 		if( hasGroupIndex ) {
-			map<VertexPair,int> uniqueVerts;
+			UniqueVertexTable<VertexPair> uniqueVerts( expectedVertices );
 			loadGroupTextures( mGroups[mGroupIndex], uniqueVerts );
 		}
 		else {
-			map<VertexPair,int> uniqueVerts;
+			UniqueVertexTable<VertexPair> uniqueVerts( expectedVertices );
 			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
 				loadGroupTextures( *groupIt, uniqueVerts );
 		}
 	}
 	else {
 		if( hasGroupIndex ) {
-			map<int,int> uniqueVerts;
+			UniqueVertexTable<int> uniqueVerts( expectedVertices );
 			loadGroup( mGroups[mGroupIndex], uniqueVerts );
 		}
 		else {
-			map<int,int> uniqueVerts;
+			UniqueVertexTable<int> uniqueVerts( expectedVertices );
 			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
 				loadGroup( *groupIt, uniqueVerts );
 		}
@@ -407,7 +834,7 @@ void ObjLoader::load() const
 	mOutputCached = true;
 }
 
-void ObjLoader::loadGroupNormalsTextures( const Group &group, map<VertexTriple,int> &uniqueVerts ) const
+void ObjLoader::loadGroupNormalsTextures( const Group &group, UniqueVertexTable<VertexTriple> &uniqueVerts ) const
 {
     bool hasColors = mMaterials.size() > 0;
 	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
@@ -442,7 +869,7 @@ void ObjLoader::loadGroupNormalsTextures( const Group &group, map<VertexTriple,i
 		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
 			if( ! forceUnique ) {
 				VertexTriple vTriple = make_tuple( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mTexCoordIndices[v], group.mFaces[f].mNormalIndices[v] );
-				pair<map<VertexTriple,int>::iterator,bool> result = uniqueVerts.insert( make_pair( vTriple, mOutputVertices.size() ) );
+				pair<int,bool> result = uniqueVerts.insert( vTriple, (int)mOutputVertices.size() );
 				if( result.second ) { // we've got a new, unique vertex here, so let's append it
 					mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
 					mOutputNormals.push_back( mInternalNormals[group.mFaces[f].mNormalIndices[v]] );
@@ -451,7 +878,7 @@ void ObjLoader::loadGroupNormalsTextures( const Group &group, map<VertexTriple,i
 						mOutputColors.push_back( rgb );
 				}
 				// the unique ID of the vertex is appended for this vert
-				faceIndices.push_back( result.first->second );
+				faceIndices.push_back( result.first );
 			}
 			else { // have to force unique because this group lacks either normals or texCoords
 				faceIndices.push_back( (int32_t)mOutputVertices.size() );
@@ -477,7 +904,7 @@ void ObjLoader::loadGroupNormalsTextures( const Group &group, map<VertexTriple,i
 	}
 }
 
-void ObjLoader::loadGroupNormals( const Group &group, map<VertexPair,int> &uniqueVerts ) const
+void ObjLoader::loadGroupNormals( const Group &group, UniqueVertexTable<VertexPair> &uniqueVerts ) const
 {
     bool hasColors = mMaterials.size() > 0;
 	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
@@ -509,7 +936,7 @@ void ObjLoader::loadGroupNormals( const Group &group, map<VertexPair,int> &uniqu
 		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
 			if( ! forceUnique ) {
 				VertexPair vPair = make_tuple( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mNormalIndices[v] );
-				pair<map<VertexPair,int>::iterator,bool> result = uniqueVerts.insert( make_pair( vPair, mOutputVertices.size() ) );
+				pair<int,bool> result = uniqueVerts.insert( vPair, (int)mOutputVertices.size() );
 				if( result.second ) { // we've got a new, unique vertex here, so let's append it
 					mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
 					mOutputNormals.push_back( mInternalNormals[group.mFaces[f].mNormalIndices[v]] );
@@ -517,7 +944,7 @@ void ObjLoader::loadGroupNormals( const Group &group, map<VertexPair,int> &uniqu
                         mOutputColors.push_back( rgb );
 				}
 				// the unique ID of the vertex is appended for this vert
-				faceIndices.push_back( result.first->second );
+				faceIndices.push_back( result.first );
 			}
 			else { // have to force unique because this group lacks normals
 				faceIndices.push_back( (int32_t)mOutputVertices.size() );
@@ -539,7 +966,7 @@ void ObjLoader::loadGroupNormals( const Group &group, map<VertexPair,int> &uniqu
 	}
 }
 
-void ObjLoader::loadGroupTextures( const Group &group, map<VertexPair,int> &uniqueVerts ) const
+void ObjLoader::loadGroupTextures( const Group &group, UniqueVertexTable<VertexPair> &uniqueVerts ) const
 {
     bool hasColors = mMaterials.size() > 0;
 	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
@@ -566,7 +993,7 @@ void ObjLoader::loadGroupTextures( const Group &group, map<VertexPair,int> &uniq
 		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
 			if( ! forceUnique ) {
 				VertexPair vPair = make_tuple( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mTexCoordIndices[v] );
-				pair<map<VertexPair,int>::iterator,bool> result = uniqueVerts.insert( make_pair( vPair, mOutputVertices.size() ) );
+				pair<int,bool> result = uniqueVerts.insert( vPair, (int)mOutputVertices.size() );
 				if( result.second ) { // we've got a new, unique vertex here, so let's append it
 					mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
 					mOutputTexCoords.push_back( mInternalTexCoords[group.mFaces[f].mTexCoordIndices[v]] );
@@ -574,7 +1001,7 @@ void ObjLoader::loadGroupTextures( const Group &group, map<VertexPair,int> &uniq
                         mOutputColors.push_back( rgb );
 				}
 				// the unique ID of the vertex is appended for this vert
-				faceIndices.push_back( result.first->second );
+				faceIndices.push_back( result.first );
 			}
 			else { // have to force unique because this group lacks texCoords
 				faceIndices.push_back( (int32_t)mOutputVertices.size() );
@@ -596,7 +1023,7 @@ void ObjLoader::loadGroupTextures( const Group &group, map<VertexPair,int> &uniq
 	}
 }
 
-void ObjLoader::loadGroup( const Group &group, map<int,int> &uniqueVerts ) const
+void ObjLoader::loadGroup( const Group &group, UniqueVertexTable<int> &uniqueVerts ) const
 {
     bool hasColors = mMaterials.size() > 0;
 	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
@@ -617,14 +1044,14 @@ void ObjLoader::loadGroup( const Group &group, map<int,int> &uniqueVerts ) const
 		vector<int> faceIndices;
 		faceIndices.reserve( group.mFaces[f].mNumVertices );
 		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
-			pair<map<int,int>::iterator,bool> result = uniqueVerts.insert( make_pair( group.mFaces[f].mVertexIndices[v], mOutputVertices.size() ) );
+			pair<int,bool> result = uniqueVerts.insert( group.mFaces[f].mVertexIndices[v], (int)mOutputVertices.size() );
 			if( result.second ) { // we've got a new, unique vertex here, so let's append it
 				mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
                 if( hasColors )
                     mOutputColors.push_back( rgb );
 			}
 			// the unique ID of the vertex is appended for this vert
-			faceIndices.push_back( result.first->second );
+			faceIndices.push_back( result.first );
 		}
 
 		int32_t triangles = (int32_t)faceIndices.size() - 2;
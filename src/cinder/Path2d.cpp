@@ -30,10 +30,16 @@
 
 #include "cinder/CinderMath.h"
 #include "cinder/Path2d.h"
+#include "cinder/Thread.h"
 
 #include <algorithm>
 #include <iterator>
 
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_PATH2D_SSE
+	#include <emmintrin.h>
+#endif
+
 using std::vector;
 
 namespace cinder {
@@ -721,6 +727,114 @@ void Path2d::subdivide( std::vector<vec2> *resultPositions, std::vector<vec2> *r
 	}
 }
 
+namespace {
+
+//! Upper bound on the number of lines per curve, which only degenerate control points reach
+const int MAX_FLATTENED_SEGMENTS = 4096;
+
+//! Wang's formula: the number of uniform parameter steps that keep a Bezier of \a degree within \a tolerance of its chords
+int calcWangSegments( const vec2 *p, int degree, float tolerance )
+{
+	float maxSecondDifference = 0;
+	for( int i = 0; i + 2 <= degree; ++i )
+		maxSecondDifference = std::max( maxSecondDifference, length( p[i + 2] - 2.0f * p[i + 1] + p[i] ) );
+	const float steps = std::ceil( std::sqrt( degree * ( degree - 1 ) * maxSecondDifference / ( 8 * tolerance ) ) );
+	return (int)math<float>::clamp( steps, 1, MAX_FLATTENED_SEGMENTS );
+}
+
+/*! Writes the points at t = i / \a numSegments for i in [1, numSegments) of the cubic a t^3 + b t^2 + c t + d to \a result, followed by \a end. With SSE, each register
+	holds two points' interleaved x and y, so the results are stored directly. */
+void evaluateCubicPolynomial( const vec2 &a, const vec2 &b, const vec2 &c, const vec2 &d, const vec2 &end, int numSegments, vec2 *result )
+{
+	const float step = 1.0f / numSegments;
+	int i = 1;
+#if defined( CINDER_PATH2D_SSE )
+	const __m128 a2 = _mm_setr_ps( a.x, a.y, a.x, a.y ), b2 = _mm_setr_ps( b.x, b.y, b.x, b.y );
+	const __m128 c2 = _mm_setr_ps( c.x, c.y, c.x, c.y ), d2 = _mm_setr_ps( d.x, d.y, d.x, d.y );
+	for( ; i + 1 < numSegments; i += 2 ) {
+		const float t0 = i * step, t1 = ( i + 1 ) * step;
+		const __m128 t = _mm_setr_ps( t0, t0, t1, t1 );
+		const __m128 value = _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps( a2, t ), b2 ), t ), c2 ), t ), d2 );
+		_mm_storeu_ps( &result[i - 1].x, value );
+	}
+#endif
+	for( ; i < numSegments; ++i ) {
+		const float t = i * step;
+		result[i - 1] = ( ( a * t + b ) * t + c ) * t + d;
+	}
+	// the end point exactly, which the next segment starts from
+	result[numSegments - 1] = end;
+}
+
+} // anonymous namespace
+
+size_t Path2d::calcNumFlattenedPoints( float approximationScale ) const
+{
+	if( mPoints.empty() )
+		return 0;
+
+	const float tolerance = 0.5f / approximationScale;
+	size_t result = 1;
+	size_t firstPoint = 0;
+	for( size_t s = 0; s < mSegments.size(); ++s ) {
+		switch( mSegments[s] ) {
+			case CUBICTO:
+				result += calcWangSegments( &mPoints[firstPoint], 3, tolerance );
+			break;
+			case QUADTO:
+				result += calcWangSegments( &mPoints[firstPoint], 2, tolerance );
+			break;
+			default:
+				result += 1;
+		}
+		firstPoint += sSegmentTypePointCounts[mSegments[s]];
+	}
+	return result;
+}
+
+void Path2d::flatten( vec2 *result, float approximationScale ) const
+{
+	if( mPoints.empty() )
+		return;
+
+	const float tolerance = 0.5f / approximationScale;
+	*result++ = mPoints[0];
+	size_t firstPoint = 0;
+	for( size_t s = 0; s < mSegments.size(); ++s ) {
+		const vec2 *p = &mPoints[firstPoint];
+		switch( mSegments[s] ) {
+			case CUBICTO: {
+				const int numSegments = calcWangSegments( p, 3, tolerance );
+				evaluateCubicPolynomial( p[3] - p[0] + 3.0f * ( p[1] - p[2] ), 3.0f * ( p[0] - 2.0f * p[1] + p[2] ), 3.0f * ( p[1] - p[0] ), p[0], p[3], numSegments, result );
+				result += numSegments;
+			}
+			break;
+			case QUADTO: {
+				const int numSegments = calcWangSegments( p, 2, tolerance );
+				evaluateCubicPolynomial( vec2( 0 ), p[0] - 2.0f * p[1] + p[2], 2.0f * ( p[1] - p[0] ), p[0], p[2], numSegments, result );
+				result += numSegments;
+			}
+			break;
+			case LINETO:
+				*result++ = p[1];
+			break;
+			case CLOSE:
+				*result++ = mPoints[0];
+			break;
+			default:
+				throw Path2dExc();
+		}
+		firstPoint += sSegmentTypePointCounts[mSegments[s]];
+	}
+}
+
+void Path2d::flatten( std::vector<vec2> *resultPositions, float approximationScale ) const
+{
+	const size_t offset = resultPositions->size();
+	resultPositions->resize( offset + calcNumFlattenedPoints( approximationScale ) );
+	flatten( resultPositions->data() + offset, approximationScale );
+}
+
 void Path2d::translate( const vec2 &offset )
 {
 	for( vector<vec2>::iterator ptIt = mPoints.begin(); ptIt != mPoints.end(); ++ptIt )
@@ -1793,11 +1907,169 @@ float Path2d::segmentSolveTimeForDistance( size_t segment, float segmentLength,
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Path2dCalcCache
+namespace {
+
+//! Uniform t-intervals per segment in the arc length tables, each integrated with 5-point Gauss-Legendre quadrature
+const int		ARC_LENGTH_INTERVALS = 16;
+const size_t	ARC_LENGTH_ENTRIES = ARC_LENGTH_INTERVALS + 1;
+const size_t	BATCH_GRAIN = 1024;
+
+const float sGaussLegendreNodes[5] = { 0.0f, -0.5384693101056831f, 0.5384693101056831f, -0.9061798459386640f, 0.9061798459386640f };
+const float sGaussLegendreWeights[5] = { 0.5688888888888889f, 0.4786286704993665f, 0.4786286704993665f, 0.2369268850561891f, 0.2369268850561891f };
+
+vec2 cubicDerivative( const vec2 p[4], float t )
+{
+	const float t1 = 1 - t;
+	return 3.0f * ( ( p[1] - p[0] ) * ( t1 * t1 ) + ( p[2] - p[1] ) * ( 2 * t * t1 ) + ( p[3] - p[2] ) * ( t * t ) );
+}
+
+vec2 cubicPosition( const vec2 p[4], float t )
+{
+	const float t1 = 1 - t;
+	return p[0] * ( t1 * t1 * t1 ) + p[1] * ( 3 * t * t1 * t1 ) + p[2] * ( 3 * t * t * t1 ) + p[3] * ( t * t * t );
+}
+
+//! Returns the arc length of the cubic \a p between \a t0 and \a t1
+float cubicArcLength( const vec2 p[4], float t0, float t1 )
+{
+	const float halfWidth = 0.5f * ( t1 - t0 ), center = 0.5f * ( t0 + t1 );
+	float result = 0;
+	for( int i = 0; i < 5; ++i )
+		result += sGaussLegendreWeights[i] * length( cubicDerivative( p, center + halfWidth * sGaussLegendreNodes[i] ) );
+	return result * halfWidth;
+}
+
+} // anonymous namespace
+
 Path2dCalcCache::Path2dCalcCache( const Path2d &path )
-	: mPath( path ), mLength( path.calcLength() )
+	: mPath( path )
 {
-	for( size_t i = 0; i < mPath.getNumSegments(); ++i )
-		mSegmentLengths.push_back( mPath.calcSegmentLength( i ) );
+	const size_t numSegments = mPath.mSegments.size();
+	mCubics.resize( numSegments * 4 );
+	mSegmentFirstPoints.resize( numSegments );
+	mArcLengths.resize( numSegments * ARC_LENGTH_ENTRIES );
+
+	size_t firstPoint = 0;
+	for( size_t s = 0; s < numSegments; ++s ) {
+		mSegmentFirstPoints[s] = firstPoint;
+		firstPoint += Path2d::sSegmentTypePointCounts[mPath.mSegments[s]];
+		updateSegment( s );
+	}
+	updateStartLengths();
+}
+
+void Path2dCalcCache::updateSegment( size_t segment )
+{
+	// lines and quadratics are degree elevated, which keeps their parameterization
+	const vec2 *p = &mPath.mPoints[mSegmentFirstPoints[segment]];
+	vec2 *cubic = &mCubics[segment * 4];
+	switch( mPath.mSegments[segment] ) {
+		case Path2d::CUBICTO:
+			std::copy( p, p + 4, cubic );
+		break;
+		case Path2d::QUADTO:
+			cubic[0] = p[0];
+			cubic[1] = p[0] + ( p[1] - p[0] ) * ( 2.0f / 3.0f );
+			cubic[2] = p[2] + ( p[1] - p[2] ) * ( 2.0f / 3.0f );
+			cubic[3] = p[2];
+		break;
+		default: {
+			const vec2 &end = ( mPath.mSegments[segment] == Path2d::CLOSE ) ? mPath.mPoints[0] : p[1];
+			cubic[0] = p[0];
+			cubic[1] = p[0] + ( end - p[0] ) * ( 1.0f / 3.0f );
+			cubic[2] = p[0] + ( end - p[0] ) * ( 2.0f / 3.0f );
+			cubic[3] = end;
+		}
+	}
+
+	float *arcLengths = &mArcLengths[segment * ARC_LENGTH_ENTRIES];
+	arcLengths[0] = 0;
+	if( mPath.mSegments[segment] == Path2d::LINETO || mPath.mSegments[segment] == Path2d::CLOSE ) {
+		const float len = distance( cubic[0], cubic[3] );
+		for( int i = 1; i <= ARC_LENGTH_INTERVALS; ++i )
+			arcLengths[i] = len * i / ARC_LENGTH_INTERVALS;
+	}
+	else {
+		for( int i = 0; i < ARC_LENGTH_INTERVALS; ++i )
+			arcLengths[i + 1] = arcLengths[i] + cubicArcLength( cubic, float( i ) / ARC_LENGTH_INTERVALS, float( i + 1 ) / ARC_LENGTH_INTERVALS );
+	}
+}
+
+void Path2dCalcCache::updateStartLengths()
+{
+	mSegmentStartLengths.resize( mPath.mSegments.size() + 1 );
+	mSegmentStartLengths[0] = 0;
+	for( size_t s = 0; s < mPath.mSegments.size(); ++s )
+		mSegmentStartLengths[s + 1] = mSegmentStartLengths[s] + mArcLengths[s * ARC_LENGTH_ENTRIES + ARC_LENGTH_INTERVALS];
+}
+
+void Path2dCalcCache::setPoint( size_t index, const vec2 &point )
+{
+	mPath.setPoint( index, point );
+
+	// a segment uses the points from its first one through the first one of its successor, so the preceding segments ending at index are affected too
+	size_t segment = std::upper_bound( mSegmentFirstPoints.begin(), mSegmentFirstPoints.end(), index ) - mSegmentFirstPoints.begin();
+	while( segment-- > 0 && mSegmentFirstPoints[segment] + Path2d::sSegmentTypePointCounts[mPath.mSegments[segment]] >= index )
+		updateSegment( segment );
+	// CLOSE segments end at the first point
+	if( index == 0 && ! mPath.mSegments.empty() && mPath.mSegments.back() == Path2d::CLOSE )
+		updateSegment( mPath.mSegments.size() - 1 );
+	updateStartLengths();
+}
+
+float Path2dCalcCache::wrapDistance( float distance, bool wrap ) const
+{
+	const float totalLength = getLength();
+	if( distance > totalLength || distance < 0 ) {
+		if( wrap && totalLength > 0 ) {
+			distance = math<float>::fmod( distance, totalLength );
+			if( distance < 0 )
+				distance += totalLength;
+		}
+		else
+			distance = math<float>::clamp( distance, 0.0f, totalLength );
+	}
+	return distance;
+}
+
+void Path2dCalcCache::solveDistance( float distance, float tolerance, int maxIterations, size_t *resultSegment, float *resultT ) const
+{
+	// the segment, skipping zero length segments, and then the table interval containing distance
+	auto segmentIt = std::upper_bound( mSegmentStartLengths.begin() + 1, mSegmentStartLengths.end() - 1, distance );
+	const size_t segment = segmentIt - mSegmentStartLengths.begin() - 1;
+	const float segmentDistance = distance - mSegmentStartLengths[segment];
+	const float *arcLengths = &mArcLengths[segment * ARC_LENGTH_ENTRIES];
+	const int interval = std::max<int>( 0, int( std::upper_bound( arcLengths + 1, arcLengths + ARC_LENGTH_INTERVALS, segmentDistance ) - arcLengths ) - 1 );
+
+	const float intervalLength = arcLengths[interval + 1] - arcLengths[interval];
+	const float target = segmentDistance - arcLengths[interval];
+	float a = float( interval ) / ARC_LENGTH_INTERVALS, b = float( interval + 1 ) / ARC_LENGTH_INTERVALS;
+	const float t0 = a;
+	*resultSegment = segment;
+	if( intervalLength <= 0 ) {
+		*resultT = a;
+		return;
+	}
+
+	// linear interpolation within the interval is exact for lines and a close first guess otherwise, refined by Newton-Raphson with a bisection fallback
+	float t = a + ( b - a ) * math<float>::clamp( target / intervalLength, 0.0f, 1.0f );
+	const Path2d::SegmentType type = mPath.mSegments[segment];
+	if( type == Path2d::CUBICTO || type == Path2d::QUADTO ) {
+		const vec2 *cubic = &mCubics[segment * 4];
+		for( int i = 0; i < maxIterations; ++i ) {
+			const float delta = cubicArcLength( cubic, t0, t ) - target;
+			if( math<float>::abs( delta ) < tolerance )
+				break;
+			if( delta < 0 )
+				a = t;
+			else
+				b = t;
+			const float speed = length( cubicDerivative( cubic, t ) );
+			const float next = ( speed > 0 ) ? t - delta / speed : a - 1;
+			t = ( next > a && next < b ) ? next : 0.5f * ( a + b );
+		}
+	}
+	*resultT = t;
 }
 
 float Path2dCalcCache::calcNormalizedTime( float relativeTime, bool wrap, float tolerance, int maxIterations ) const
@@ -1820,41 +2092,95 @@ float Path2dCalcCache::calcNormalizedTime( float relativeTime, bool wrap, float
 	}
 
 	// We're looking for a length that is relativeTime * totalPathLength
-	float targetLength = mLength * math<float>::clamp( relativeTime, 0.0f, 1.0f );
-
-	// Iterate the segments to find the segment defining the range containing our targetLength
-	int currentSegment = 0;
-	float currentSegmentLength = mSegmentLengths[0];
-	while( targetLength > currentSegmentLength ) {
-		targetLength -= currentSegmentLength;
-		currentSegmentLength = mSegmentLengths[++currentSegment];
-	}
-
-	return mPath.segmentSolveTimeForDistance( currentSegment, currentSegmentLength, targetLength, tolerance, maxIterations );
+	size_t segment;
+	float t;
+	solveDistance( getLength() * math<float>::clamp( relativeTime, 0.0f, 1.0f ), tolerance, maxIterations, &segment, &t );
+	return ( segment + t ) / mPath.mSegments.size();
 }
 
 float Path2dCalcCache::calcTimeForDistance( float distance, bool wrap, float tolerance, int maxIterations ) const
 {
-	if( mPath.mSegments.empty() || mLength == 0 )
+	if( mPath.mSegments.empty() || getLength() == 0 )
 		return 0;
 
-	if( distance > mLength ) {
-		if( wrap )
-			distance = fmodf( distance, mLength );
-		else
-			return 1.0f;
-	}
+	if( distance > getLength() && ! wrap )
+		return 1.0f;
 
-	// Iterate the segments to find the segment defining the range containing our targetLength
-	int currentSegment = 0;
-	float currentSegmentLength = mSegmentLengths[0];
-	while( distance > currentSegmentLength ) {
-		distance -= currentSegmentLength;
-		currentSegmentLength = mSegmentLengths[++currentSegment];
-	}
+	size_t segment;
+	float t;
+	solveDistance( wrapDistance( distance, wrap ), tolerance, maxIterations, &segment, &t );
+	return ( segment + t ) / mPath.mSegments.size();
+}
 
-	return mPath.segmentSolveTimeForDistance( currentSegment, currentSegmentLength, distance, tolerance, maxIterations );
+void Path2dCalcCache::calcTimesForDistances( const float *distances, size_t count, float *resultTimes, bool wrap, float tolerance ) const
+{
+	parallelFor( count, [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			resultTimes[i] = calcTimeForDistance( distances[i], wrap, tolerance );
+	}, BATCH_GRAIN );
 }
 
+void Path2dCalcCache::calcPositionsForDistances( const float *distances, size_t count, vec2 *resultPositions, vec2 *resultTangents, bool wrap, float tolerance ) const
+{
+	if( mPath.mSegments.empty() ) {
+		for( size_t i = 0; i < count; ++i ) {
+			if( resultPositions )
+				resultPositions[i] = mPath.mPoints.empty() ? vec2() : mPath.mPoints[0];
+			if( resultTangents )
+				resultTangents[i] = vec2();
+		}
+		return;
+	}
+
+	parallelFor( count, [&]( size_t begin, size_t end ) {
+		size_t i = begin;
+#if defined( CINDER_PATH2D_SSE )
+		// Bernstein weights for four curves at once; the control points are transposed into one register per coordinate
+		for( ; i + 4 <= end; i += 4 ) {
+			size_t segments[4];
+			alignas( 16 ) float times[4];
+			for( int k = 0; k < 4; ++k )
+				solveDistance( wrapDistance( distances[i + k], wrap ), tolerance, 16, &segments[k], &times[k] );
+
+			__m128 x[4], y[4];
+			for( int c = 0; c < 4; ++c ) {
+				const vec2 &p0 = mCubics[segments[0] * 4 + c], &p1 = mCubics[segments[1] * 4 + c], &p2 = mCubics[segments[2] * 4 + c], &p3 = mCubics[segments[3] * 4 + c];
+				x[c] = _mm_setr_ps( p0.x, p1.x, p2.x, p3.x );
+				y[c] = _mm_setr_ps( p0.y, p1.y, p2.y, p3.y );
+			}
+			const __m128 t = _mm_load_ps( times ), t1 = _mm_sub_ps( _mm_set1_ps( 1 ), t ), three = _mm_set1_ps( 3 );
+			alignas( 16 ) float outX[4], outY[4];
+			if( resultPositions ) {
+				const __m128 w0 = _mm_mul_ps( _mm_mul_ps( t1, t1 ), t1 );
+				const __m128 w1 = _mm_mul_ps( _mm_mul_ps( three, t ), _mm_mul_ps( t1, t1 ) );
+				const __m128 w2 = _mm_mul_ps( _mm_mul_ps( three, t ), _mm_mul_ps( t, t1 ) );
+				const __m128 w3 = _mm_mul_ps( _mm_mul_ps( t, t ), t );
+				_mm_store_ps( outX, _mm_add_ps( _mm_add_ps( _mm_mul_ps( x[0], w0 ), _mm_mul_ps( x[1], w1 ) ), _mm_add_ps( _mm_mul_ps( x[2], w2 ), _mm_mul_ps( x[3], w3 ) ) ) );
+				_mm_store_ps( outY, _mm_add_ps( _mm_add_ps( _mm_mul_ps( y[0], w0 ), _mm_mul_ps( y[1], w1 ) ), _mm_add_ps( _mm_mul_ps( y[2], w2 ), _mm_mul_ps( y[3], w3 ) ) ) );
+				for( int k = 0; k < 4; ++k )
+					resultPositions[i + k] = vec2( outX[k], outY[k] );
+			}
+			if( resultTangents ) {
+				const __m128 w0 = _mm_mul_ps( three, _mm_mul_ps( t1, t1 ) );
+				const __m128 w1 = _mm_mul_ps( _mm_set1_ps( 6 ), _mm_mul_ps( t, t1 ) );
+				const __m128 w2 = _mm_mul_ps( three, _mm_mul_ps( t, t ) );
+				_mm_store_ps( outX, _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_sub_ps( x[1], x[0] ), w0 ), _mm_mul_ps( _mm_sub_ps( x[2], x[1] ), w1 ) ), _mm_mul_ps( _mm_sub_ps( x[3], x[2] ), w2 ) ) );
+				_mm_store_ps( outY, _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_sub_ps( y[1], y[0] ), w0 ), _mm_mul_ps( _mm_sub_ps( y[2], y[1] ), w1 ) ), _mm_mul_ps( _mm_sub_ps( y[3], y[2] ), w2 ) ) );
+				for( int k = 0; k < 4; ++k )
+					resultTangents[i + k] = vec2( outX[k], outY[k] );
+			}
+		}
+#endif
+		for( ; i < end; ++i ) {
+			size_t segment;
+			float t;
+			solveDistance( wrapDistance( distances[i], wrap ), tolerance, 16, &segment, &t );
+			if( resultPositions )
+				resultPositions[i] = cubicPosition( &mCubics[segment * 4], t );
+			if( resultTangents )
+				resultTangents[i] = cubicDerivative( &mCubics[segment * 4], t );
+		}
+	}, BATCH_GRAIN );
+}
 
 } // namespace cinder
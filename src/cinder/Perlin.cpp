@@ -26,7 +26,34 @@
 
 #include "cinder/Perlin.h"
 #include "cinder/CinderMath.h"
+#include "cinder/Channel.h"
 #include "cinder/Rand.h"
+#include "cinder/Surface.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+#include <vector>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_PERLIN_SSE
+	#define CINDER_PERLIN_AVX2
+	#include <immintrin.h>
+	#if defined( _MSC_VER )
+		#include <intrin.h>
+		#define CINDER_PERLIN_TARGET( isa )
+	#else
+		#define CINDER_PERLIN_TARGET( isa ) __attribute__(( target( isa ) ))
+	#endif
+#elif defined( __aarch64__ ) || defined( _M_ARM64 )
+	#define CINDER_PERLIN_NEON
+	#include <arm_neon.h>
+#endif
+
+#if defined( _MSC_VER )
+	#define CINDER_PERLIN_INLINE __forceinline
+#else
+	#define CINDER_PERLIN_INLINE inline __attribute__(( always_inline ))
+#endif
 
 namespace cinder {
 
@@ -306,6 +333,907 @@ float Perlin::grad( int32_t hash, float x, float y, float z ) const
 	return ((h&1) == 0 ? u : -u) + ((h&2) == 0 ? v : -v);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Batch evaluation
+namespace {
+
+// Noise is evaluated for several points at a time: 8 through AVX2 when the CPU supports it, otherwise 4 through SSE2 or NEON,
+// or plain floats. Every lane type performs the same operations in the same order, so results don't depend on the path taken.
+// Hashing remains per lane.
+#if defined( CINDER_PERLIN_SSE )
+struct Float4 {
+	Float4() {}
+	Float4( float f ) : v( _mm_set1_ps( f ) ) {}
+	Float4( float a, float b, float c, float d ) : v( _mm_setr_ps( a, b, c, d ) ) {}
+	Float4( __m128 m ) : v( m ) {}
+
+	__m128	v;
+};
+
+inline Float4 operator+( const Float4 &a, const Float4 &b ) { return _mm_add_ps( a.v, b.v ); }
+inline Float4 operator-( const Float4 &a, const Float4 &b ) { return _mm_sub_ps( a.v, b.v ); }
+inline Float4 operator*( const Float4 &a, const Float4 &b ) { return _mm_mul_ps( a.v, b.v ); }
+inline Float4 lanesMax( const Float4 &a, const Float4 &b ) { return _mm_max_ps( a.v, b.v ); }
+inline Float4 lanesFloor( const Float4 &a )
+{
+	const __m128 truncated = _mm_cvtepi32_ps( _mm_cvttps_epi32( a.v ) );
+	return _mm_sub_ps( truncated, _mm_and_ps( _mm_cmpgt_ps( truncated, a.v ), _mm_set1_ps( 1.0f ) ) );
+}
+//! Replaces lanes smaller than \a epsilon with \c 1
+inline Float4 lanesReplaceSmall( const Float4 &a, float epsilon )
+{
+	const __m128 small = _mm_cmplt_ps( a.v, _mm_set1_ps( epsilon ) );
+	return _mm_or_ps( _mm_and_ps( small, _mm_set1_ps( 1.0f ) ), _mm_andnot_ps( small, a.v ) );
+}
+inline void lanesStore( const Float4 &a, float *result ) { _mm_storeu_ps( result, a.v ); }
+//! Truncates each lane towards zero
+inline void lanesToInts( const Float4 &a, int32_t *result ) { _mm_storeu_si128( reinterpret_cast<__m128i*>( result ), _mm_cvttps_epi32( a.v ) ); }
+#elif defined( CINDER_PERLIN_NEON )
+struct Float4 {
+	Float4() {}
+	Float4( float f ) : v( vdupq_n_f32( f ) ) {}
+	Float4( float a, float b, float c, float d ) { const float lanes[4] = { a, b, c, d }; v = vld1q_f32( lanes ); }
+	Float4( float32x4_t m ) : v( m ) {}
+
+	float32x4_t	v;
+};
+
+inline Float4 operator+( const Float4 &a, const Float4 &b ) { return vaddq_f32( a.v, b.v ); }
+inline Float4 operator-( const Float4 &a, const Float4 &b ) { return vsubq_f32( a.v, b.v ); }
+inline Float4 operator*( const Float4 &a, const Float4 &b ) { return vmulq_f32( a.v, b.v ); }
+inline Float4 lanesMax( const Float4 &a, const Float4 &b ) { return vmaxq_f32( a.v, b.v ); }
+inline Float4 lanesFloor( const Float4 &a ) { return vrndmq_f32( a.v ); }
+inline Float4 lanesReplaceSmall( const Float4 &a, float epsilon ) { return vbslq_f32( vcltq_f32( a.v, vdupq_n_f32( epsilon ) ), vdupq_n_f32( 1.0f ), a.v ); }
+inline void lanesStore( const Float4 &a, float *result ) { vst1q_f32( result, a.v ); }
+inline void lanesToInts( const Float4 &a, int32_t *result ) { vst1q_s32( result, vcvtq_s32_f32( a.v ) ); }
+#else
+struct Float4 {
+	Float4() {}
+	Float4( float f ) { v[0] = v[1] = v[2] = v[3] = f; }
+	Float4( float a, float b, float c, float d ) { v[0] = a; v[1] = b; v[2] = c; v[3] = d; }
+
+	float	v[4];
+};
+
+inline Float4 operator+( const Float4 &a, const Float4 &b ) { return Float4( a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] ); }
+inline Float4 operator-( const Float4 &a, const Float4 &b ) { return Float4( a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] ); }
+inline Float4 operator*( const Float4 &a, const Float4 &b ) { return Float4( a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] ); }
+inline Float4 lanesMax( const Float4 &a, const Float4 &b ) { return Float4( std::max( a.v[0], b.v[0] ), std::max( a.v[1], b.v[1] ), std::max( a.v[2], b.v[2] ), std::max( a.v[3], b.v[3] ) ); }
+inline Float4 lanesFloor( const Float4 &a ) { return Float4( floorf( a.v[0] ), floorf( a.v[1] ), floorf( a.v[2] ), floorf( a.v[3] ) ); }
+inline Float4 lanesReplaceSmall( const Float4 &a, float epsilon )
+{
+	Float4 result( a );
+	for( int l = 0; l < 4; ++l )
+		if( result.v[l] < epsilon )
+			result.v[l] = 1.0f;
+	return result;
+}
+inline void lanesStore( const Float4 &a, float *result ) { std::copy( a.v, a.v + 4, result ); }
+inline void lanesToInts( const Float4 &a, int32_t *result ) { for( int l = 0; l < 4; ++l ) result[l] = (int32_t)a.v[l]; }
+#endif
+
+// the scalar counterparts, so that Simplex evaluates single points with the same code as batches
+inline float lanesMax( float a, float b ) { return std::max( a, b ); }
+inline float lanesFloor( float a ) { return floorf( a ); }
+inline void lanesStore( float a, float *result ) { *result = a; }
+inline void lanesToInts( float a, int32_t *result ) { *result = (int32_t)a; }
+
+template<typename F> struct Lanes {};
+template<> struct Lanes<float> { enum { size = 1 }; static float load( const float *p ) { return *p; } };
+template<> struct Lanes<Float4> {
+	enum { size = 4 };
+	static Float4 load( const float *p ) { return Float4( p[0], p[1], p[2], p[3] ); }
+	static Float4 gather( const float *table, const int32_t *indices ) { return Float4( table[indices[0]], table[indices[1]], table[indices[2]], table[indices[3]] ); }
+};
+
+#if defined( CINDER_PERLIN_AVX2 )
+// Only used inside evalLanesAvx2(), which is compiled for AVX2 and inlines the lane-generic code that calls these
+struct Float8 {
+	Float8() {}
+	CINDER_PERLIN_TARGET( "avx2" ) Float8( float f ) : v( _mm256_set1_ps( f ) ) {}
+	CINDER_PERLIN_TARGET( "avx2" ) Float8( __m256 m ) : v( m ) {}
+
+	__m256	v;
+};
+
+CINDER_PERLIN_TARGET( "avx2" ) inline Float8 operator+( const Float8 &a, const Float8 &b ) { return _mm256_add_ps( a.v, b.v ); }
+CINDER_PERLIN_TARGET( "avx2" ) inline Float8 operator-( const Float8 &a, const Float8 &b ) { return _mm256_sub_ps( a.v, b.v ); }
+CINDER_PERLIN_TARGET( "avx2" ) inline Float8 operator*( const Float8 &a, const Float8 &b ) { return _mm256_mul_ps( a.v, b.v ); }
+CINDER_PERLIN_TARGET( "avx2" ) inline Float8 lanesMax( const Float8 &a, const Float8 &b ) { return _mm256_max_ps( a.v, b.v ); }
+CINDER_PERLIN_TARGET( "avx2" ) inline Float8 lanesFloor( const Float8 &a )
+{
+	const __m256 truncated = _mm256_cvtepi32_ps( _mm256_cvttps_epi32( a.v ) );
+	return _mm256_sub_ps( truncated, _mm256_and_ps( _mm256_cmp_ps( truncated, a.v, _CMP_GT_OQ ), _mm256_set1_ps( 1.0f ) ) );
+}
+CINDER_PERLIN_TARGET( "avx2" ) inline Float8 lanesReplaceSmall( const Float8 &a, float epsilon )
+{
+	return _mm256_blendv_ps( a.v, _mm256_set1_ps( 1.0f ), _mm256_cmp_ps( a.v, _mm256_set1_ps( epsilon ), _CMP_LT_OQ ) );
+}
+CINDER_PERLIN_TARGET( "avx2" ) inline void lanesStore( const Float8 &a, float *result ) { _mm256_storeu_ps( result, a.v ); }
+CINDER_PERLIN_TARGET( "avx2" ) inline void lanesToInts( const Float8 &a, int32_t *result ) { _mm256_storeu_si256( reinterpret_cast<__m256i*>( result ), _mm256_cvttps_epi32( a.v ) ); }
+
+template<> struct Lanes<Float8> {
+	enum { size = 8 };
+	CINDER_PERLIN_TARGET( "avx2" ) static Float8 load( const float *p ) { return _mm256_loadu_ps( p ); }
+	CINDER_PERLIN_TARGET( "avx2" ) static Float8 gather( const float *table, const int32_t *indices ) { return _mm256_i32gather_ps( table, _mm256_loadu_si256( reinterpret_cast<const __m256i*>( indices ) ), 4 ); }
+};
+
+enum class NoiseSimdLevel { SSE2, AVX2 };
+
+NoiseSimdLevel detectNoiseSimdLevel()
+{
+  #if defined( _MSC_VER )
+	int info[4];
+	__cpuid( info, 0 );
+	const int maxLeaf = info[0];
+	__cpuid( info, 1 );
+	const bool osAvx = ( info[2] & ( 1 << 27 ) ) && ( info[2] & ( 1 << 28 ) ) && ( ( _xgetbv( 0 ) & 6 ) == 6 );
+	bool avx2 = false;
+	if( maxLeaf >= 7 && osAvx ) {
+		__cpuidex( info, 7, 0 );
+		avx2 = ( info[1] & ( 1 << 5 ) ) != 0;
+	}
+  #else
+	__builtin_cpu_init();
+	const bool avx2 = __builtin_cpu_supports( "avx2" ) != 0;
+  #endif
+	return avx2 ? NoiseSimdLevel::AVX2 : NoiseSimdLevel::SSE2;
+}
+
+NoiseSimdLevel getNoiseSimdLevel()
+{
+	static const NoiseSimdLevel sLevel = detectNoiseSimdLevel();
+	return sLevel;
+}
+#endif
+
+template<typename F> CINDER_PERLIN_INLINE F fade( const F &t ) { return t * t * t * ( t * ( t * F( 6.0f ) - F( 15.0f ) ) + F( 10.0f ) ); }
+template<typename F> CINDER_PERLIN_INLINE F dfade( const F &t ) { return F( 30.0f ) * t * t * ( t * ( t - F( 2.0f ) ) + F( 1.0f ) ); }
+template<typename F> CINDER_PERLIN_INLINE F nlerp( const F &t, const F &a, const F &b ) { return a + t * ( b - a ); }
+
+//! Perlin::grad() is linear in x, y and z; these are its coefficients for each 4-bit hash
+struct PerlinGradients {
+	PerlinGradients()
+	{
+		for( int32_t h = 0; h < 16; ++h ) {
+			// u = h<8 ? x : y, v = h<4 ? y : h==12||h==14 ? x : z
+			const vec3 u = ( h < 8 ) ? vec3( 1, 0, 0 ) : vec3( 0, 1, 0 );
+			const vec3 v = ( h < 4 ) ? vec3( 0, 1, 0 ) : ( h == 12 || h == 14 ) ? vec3( 1, 0, 0 ) : vec3( 0, 0, 1 );
+			const vec3 g = ( ( h & 1 ) ? -u : u ) + ( ( h & 2 ) ? -v : v );
+			mX[h] = g.x; mY[h] = g.y; mZ[h] = g.z;
+		}
+	}
+
+	float	mX[16], mY[16], mZ[16];
+};
+
+const PerlinGradients sPerlinGradients;
+
+//! Per-lane gradient coefficients of a lattice corner, looked up from its hash
+template<typename F>
+struct Gradients {
+	CINDER_PERLIN_INLINE void set( int lane, int32_t hash ) { h[lane] = hash & 15; }
+	CINDER_PERLIN_INLINE F dot( const F &px, const F &py ) const { return Lanes<F>::gather( sPerlinGradients.mX, h ) * px + Lanes<F>::gather( sPerlinGradients.mY, h ) * py; }
+	CINDER_PERLIN_INLINE F dot( const F &px, const F &py, const F &pz ) const { return Lanes<F>::gather( sPerlinGradients.mX, h ) * px + Lanes<F>::gather( sPerlinGradients.mY, h ) * py + Lanes<F>::gather( sPerlinGradients.mZ, h ) * pz; }
+
+	int32_t		h[Lanes<F>::size];
+};
+
+//! Matches Perlin::noise( float, float )
+template<typename F>
+CINDER_PERLIN_INLINE F perlinNoise( const uint8_t *perms, const F &xIn, const F &yIn )
+{
+	const int N = Lanes<F>::size;
+	const F floorX = lanesFloor( xIn ), floorY = lanesFloor( yIn );
+	int32_t X[N], Y[N];
+	lanesToInts( floorX, X );
+	lanesToInts( floorY, Y );
+
+	Gradients<F> gAA, gBA, gAB, gBB;
+	for( int l = 0; l < N; ++l ) {
+		const int32_t xi = X[l] & 255, yi = Y[l] & 255;
+		const int32_t A = perms[xi] + yi, AA = perms[A], AB = perms[A + 1], B = perms[xi + 1] + yi, BA = perms[B], BB = perms[B + 1];
+		gAA.set( l, perms[AA] ); gBA.set( l, perms[BA] ); gAB.set( l, perms[AB] ); gBB.set( l, perms[BB] );
+	}
+
+	const F x = xIn - floorX, y = yIn - floorY, one( 1.0f );
+	const F u = fade( x ), v = fade( y );
+	return nlerp( v, nlerp( u, gAA.dot( x, y ), gBA.dot( x - one, y ) ),
+					 nlerp( u, gAB.dot( x, y - one ), gBB.dot( x - one, y - one ) ) );
+}
+
+//! Matches Perlin::noise( float, float, float )
+template<typename F>
+CINDER_PERLIN_INLINE F perlinNoise( const uint8_t *perms, const F &xIn, const F &yIn, const F &zIn )
+{
+	const int N = Lanes<F>::size;
+	const F floorX = lanesFloor( xIn ), floorY = lanesFloor( yIn ), floorZ = lanesFloor( zIn );
+	int32_t X[N], Y[N], Z[N];
+	lanesToInts( floorX, X );
+	lanesToInts( floorY, Y );
+	lanesToInts( floorZ, Z );
+
+	Gradients<F> ga, gb, gc, gd, ge, gf, gg, gh;
+	for( int l = 0; l < N; ++l ) {
+		const int32_t xi = X[l] & 255, yi = Y[l] & 255, zi = Z[l] & 255;
+		const int32_t A = perms[xi] + yi, AA = perms[A] + zi, AB = perms[A + 1] + zi, B = perms[xi + 1] + yi, BA = perms[B] + zi, BB = perms[B + 1] + zi;
+		ga.set( l, perms[AA] ); gb.set( l, perms[BA] ); gc.set( l, perms[AB] ); gd.set( l, perms[BB] );
+		ge.set( l, perms[AA + 1] ); gf.set( l, perms[BA + 1] ); gg.set( l, perms[AB + 1] ); gh.set( l, perms[BB + 1] );
+	}
+
+	const F x = xIn - floorX, y = yIn - floorY, z = zIn - floorZ, one( 1.0f );
+	const F u = fade( x ), v = fade( y ), w = fade( z );
+	const F a = ga.dot( x, y, z ), b = gb.dot( x - one, y, z ), c = gc.dot( x, y - one, z ), d = gd.dot( x - one, y - one, z );
+	const F e = ge.dot( x, y, z - one ), f = gf.dot( x - one, y, z - one ), g = gg.dot( x, y - one, z - one ), h = gh.dot( x - one, y - one, z - one );
+	return nlerp( w, nlerp( v, nlerp( u, a, b ), nlerp( u, c, d ) ),
+					 nlerp( v, nlerp( u, e, f ), nlerp( u, g, h ) ) );
+}
+
+//! Matches Perlin::dnoise( float, float ), including its truncation of the lattice coordinates
+template<typename F>
+CINDER_PERLIN_INLINE void perlinDNoise( const uint8_t *perms, const F &xIn, const F &yIn, F *dx, F *dy )
+{
+	const int N = Lanes<F>::size;
+	int32_t X[N], Y[N];
+	lanesToInts( xIn, X );
+	lanesToInts( yIn, Y );
+
+	Gradients<F> gAA, gBA, gAB, gBB;
+	for( int l = 0; l < N; ++l ) {
+		const int32_t xi = X[l] & 255, yi = Y[l] & 255;
+		const int32_t A = perms[xi] + yi, AA = perms[A], AB = perms[A + 1], B = perms[xi + 1] + yi, BA = perms[B], BB = perms[B + 1];
+		gAA.set( l, perms[AA] ); gBA.set( l, perms[BA] ); gAB.set( l, perms[AB] ); gBB.set( l, perms[BB] );
+	}
+
+	const F x = xIn - lanesFloor( xIn ), y = yIn - lanesFloor( yIn ), one( 1.0f );
+	const F u = fade( x ), v = fade( y );
+	const F du = lanesReplaceSmall( dfade( x ), 0.000001f ), dv = lanesReplaceSmall( dfade( y ), 0.000001f );
+	const F a = gAA.dot( x, y ), b = gBA.dot( x - one, y ), c = gAB.dot( x, y - one ), d = gBB.dot( x - one, y - one );
+	const F k1 = b - a, k2 = c - a, k4 = a - b - c + d;
+	*dx = du * ( k1 + k4 * v );
+	*dy = dv * ( k2 + k4 * u );
+}
+
+//! Matches Perlin::dnoise( float, float, float )
+template<typename F>
+CINDER_PERLIN_INLINE void perlinDNoise( const uint8_t *perms, const F &xIn, const F &yIn, const F &zIn, F *dx, F *dy, F *dz )
+{
+	const int N = Lanes<F>::size;
+	const F floorX = lanesFloor( xIn ), floorY = lanesFloor( yIn ), floorZ = lanesFloor( zIn );
+	int32_t X[N], Y[N], Z[N];
+	lanesToInts( floorX, X );
+	lanesToInts( floorY, Y );
+	lanesToInts( floorZ, Z );
+
+	Gradients<F> ga, gb, gc, gd, ge, gf, gg, gh;
+	for( int l = 0; l < N; ++l ) {
+		const int32_t xi = X[l] & 255, yi = Y[l] & 255, zi = Z[l] & 255;
+		const int32_t A = perms[xi] + yi, AA = perms[A] + zi, AB = perms[A + 1] + zi, B = perms[xi + 1] + yi, BA = perms[B] + zi, BB = perms[B + 1] + zi;
+		ga.set( l, perms[AA] ); gb.set( l, perms[BA] ); gc.set( l, perms[AB] ); gd.set( l, perms[BB] );
+		ge.set( l, perms[AA + 1] ); gf.set( l, perms[BA + 1] ); gg.set( l, perms[AB + 1] ); gh.set( l, perms[BB + 1] );
+	}
+
+	const F x = xIn - floorX, y = yIn - floorY, z = zIn - floorZ, one( 1.0f );
+	const F u = fade( x ), v = fade( y ), w = fade( z );
+	const F du = lanesReplaceSmall( dfade( x ), 0.000001f ), dv = lanesReplaceSmall( dfade( y ), 0.000001f ), dw = lanesReplaceSmall( dfade( z ), 0.000001f );
+	const F a = ga.dot( x, y, z ), b = gb.dot( x - one, y, z ), c = gc.dot( x, y - one, z ), d = gd.dot( x - one, y - one, z );
+	const F e = ge.dot( x, y, z - one ), f = gf.dot( x - one, y, z - one ), g = gg.dot( x, y - one, z - one ), h = gh.dot( x - one, y - one, z - one );
+
+	const F k1 = b - a, k2 = c - a, k3 = e - a, k4 = a - b - c + d, k5 = a - c - e + g, k6 = a - b - e + f;
+	const F k7 = F( 0.0f ) - a + b + c - d + e - f - g + h;
+	*dx = du * ( k1 + k4 * v + k6 * w + k7 * v * w );
+	*dy = dv * ( k2 + k5 * w + k4 * u + k7 * w * u );
+	*dz = dw * ( k3 + k6 * u + k5 * v + k7 * u * v );
+}
+
+// Simplex noise after Stefan Gustavson's "Simplex noise demystified", with derivatives after his sdnoise
+const float sSimplexGradients[12][3] = {	{ 1, 1, 0 }, { -1, 1, 0 }, { 1, -1, 0 }, { -1, -1, 0 }, { 1, 0, 1 }, { -1, 0, 1 },
+											{ 1, 0, -1 }, { -1, 0, -1 }, { 0, 1, 1 }, { 0, -1, 1 }, { 0, 1, -1 }, { 0, -1, -1 } };
+
+template<typename F>
+CINDER_PERLIN_INLINE void addSimplexCorner( float radiusSquared, const F &x, const F &y, const float *gx, const float *gy, F *n, F *dx, F *dy )
+{
+	const F gxs = Lanes<F>::load( gx ), gys = Lanes<F>::load( gy );
+	const F t = lanesMax( F( radiusSquared ) - x * x - y * y, F( 0.0f ) );
+	const F t2 = t * t, t4 = t2 * t2, gdot = gxs * x + gys * y;
+	*n = *n + t4 * gdot;
+	if( dx ) {
+		const F temp = t2 * t * gdot * F( -8.0f );
+		*dx = *dx + temp * x + t4 * gxs;
+		*dy = *dy + temp * y + t4 * gys;
+	}
+}
+
+template<typename F>
+CINDER_PERLIN_INLINE void addSimplexCorner( float radiusSquared, const F &x, const F &y, const F &z, const float *gx, const float *gy, const float *gz, F *n, F *dx, F *dy, F *dz )
+{
+	const F gxs = Lanes<F>::load( gx ), gys = Lanes<F>::load( gy ), gzs = Lanes<F>::load( gz );
+	const F t = lanesMax( F( radiusSquared ) - x * x - y * y - z * z, F( 0.0f ) );
+	const F t2 = t * t, t4 = t2 * t2, gdot = gxs * x + gys * y + gzs * z;
+	*n = *n + t4 * gdot;
+	if( dx ) {
+		const F temp = t2 * t * gdot * F( -8.0f );
+		*dx = *dx + temp * x + t4 * gxs;
+		*dy = *dy + temp * y + t4 * gys;
+		*dz = *dz + temp * z + t4 * gzs;
+	}
+}
+
+//! Returns 2D simplex noise of every lane, and its derivative when \a dx and \a dy aren't null
+template<typename F>
+CINDER_PERLIN_INLINE F simplexNoise( const uint8_t *perms, const uint8_t *permsMod12, const F &x, const F &y, F *dx, F *dy )
+{
+	const int N = Lanes<F>::size;
+	const float F2 = 0.366025403784f, G2 = 0.211324865405f;
+
+	// skew into the simplex grid and find the first corner of the containing triangle
+	const F s = ( x + y ) * F( F2 );
+	const F i = lanesFloor( x + s ), j = lanesFloor( y + s );
+	const F t = ( i + j ) * F( G2 );
+	const F x0 = x - ( i - t ), y0 = y - ( j - t );
+
+	float x0s[N], y0s[N], i1s[N], j1s[N], gx[3][N], gy[3][N];
+	int32_t is[N], js[N];
+	lanesStore( x0, x0s ); lanesStore( y0, y0s );
+	lanesToInts( i, is ); lanesToInts( j, js );
+	for( int l = 0; l < N; ++l ) {
+		const int32_t i1 = ( x0s[l] > y0s[l] ) ? 1 : 0, j1 = 1 - i1;
+		const int32_t ii = is[l] & 255, jj = js[l] & 255;
+		const uint8_t h[3] = { permsMod12[ii + perms[jj]], permsMod12[ii + i1 + perms[jj + j1]], permsMod12[ii + 1 + perms[jj + 1]] };
+		for( int c = 0; c < 3; ++c ) {
+			gx[c][l] = sSimplexGradients[h[c]][0];
+			gy[c][l] = sSimplexGradients[h[c]][1];
+		}
+		i1s[l] = (float)i1;
+		j1s[l] = (float)j1;
+	}
+
+	const F x1 = x0 - Lanes<F>::load( i1s ) + F( G2 ), y1 = y0 - Lanes<F>::load( j1s ) + F( G2 );
+	const F x2 = x0 - F( 1 - 2 * G2 ), y2 = y0 - F( 1 - 2 * G2 );
+	F n( 0.0f ), ddx( 0.0f ), ddy( 0.0f );
+	F *ddxPtr = dx ? &ddx : nullptr;
+	addSimplexCorner( 0.5f, x0, y0, gx[0], gy[0], &n, ddxPtr, &ddy );
+	addSimplexCorner( 0.5f, x1, y1, gx[1], gy[1], &n, ddxPtr, &ddy );
+	addSimplexCorner( 0.5f, x2, y2, gx[2], gy[2], &n, ddxPtr, &ddy );
+
+	// scales the result to about [-1,1]
+	if( dx ) {
+		*dx = ddx * F( 70.0f );
+		*dy = ddy * F( 70.0f );
+	}
+	return n * F( 70.0f );
+}
+
+//! Returns 3D simplex noise of every lane, and its derivative when \a dx, \a dy and \a dz aren't null
+template<typename F>
+CINDER_PERLIN_INLINE F simplexNoise( const uint8_t *perms, const uint8_t *permsMod12, const F &x, const F &y, const F &z, F *dx, F *dy, F *dz )
+{
+	const int N = Lanes<F>::size;
+	const float F3 = 1.0f / 3.0f, G3 = 1.0f / 6.0f;
+
+	const F s = ( x + y + z ) * F( F3 );
+	const F i = lanesFloor( x + s ), j = lanesFloor( y + s ), k = lanesFloor( z + s );
+	const F t = ( i + j + k ) * F( G3 );
+	const F x0 = x - ( i - t ), y0 = y - ( j - t ), z0 = z - ( k - t );
+
+	// the offsets of the second and third corners depend on the order of x0, y0 and z0
+	float x0s[N], y0s[N], z0s[N], offsets1[3][N], offsets2[3][N], gx[4][N], gy[4][N], gz[4][N];
+	int32_t is[N], js[N], ks[N];
+	lanesStore( x0, x0s ); lanesStore( y0, y0s ); lanesStore( z0, z0s );
+	lanesToInts( i, is ); lanesToInts( j, js ); lanesToInts( k, ks );
+	for( int l = 0; l < N; ++l ) {
+		int32_t i1, j1, k1, i2, j2, k2;
+		if( x0s[l] >= y0s[l] ) {
+			if( y0s[l] >= z0s[l] )		{ i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 1; k2 = 0; }
+			else if( x0s[l] >= z0s[l] )	{ i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 0; k2 = 1; }
+			else						{ i1 = 0; j1 = 0; k1 = 1; i2 = 1; j2 = 0; k2 = 1; }
+		}
+		else {
+			if( y0s[l] < z0s[l] )		{ i1 = 0; j1 = 0; k1 = 1; i2 = 0; j2 = 1; k2 = 1; }
+			else if( x0s[l] < z0s[l] )	{ i1 = 0; j1 = 1; k1 = 0; i2 = 0; j2 = 1; k2 = 1; }
+			else						{ i1 = 0; j1 = 1; k1 = 0; i2 = 1; j2 = 1; k2 = 0; }
+		}
+		const int32_t ii = is[l] & 255, jj = js[l] & 255, kk = ks[l] & 255;
+		const uint8_t h[4] = {	permsMod12[ii + perms[jj + perms[kk]]],
+								permsMod12[ii + i1 + perms[jj + j1 + perms[kk + k1]]],
+								permsMod12[ii + i2 + perms[jj + j2 + perms[kk + k2]]],
+								permsMod12[ii + 1 + perms[jj + 1 + perms[kk + 1]]] };
+		for( int c = 0; c < 4; ++c ) {
+			gx[c][l] = sSimplexGradients[h[c]][0];
+			gy[c][l] = sSimplexGradients[h[c]][1];
+			gz[c][l] = sSimplexGradients[h[c]][2];
+		}
+		offsets1[0][l] = (float)i1; offsets1[1][l] = (float)j1; offsets1[2][l] = (float)k1;
+		offsets2[0][l] = (float)i2; offsets2[1][l] = (float)j2; offsets2[2][l] = (float)k2;
+	}
+
+	const F x1 = x0 - Lanes<F>::load( offsets1[0] ) + F( G3 ), y1 = y0 - Lanes<F>::load( offsets1[1] ) + F( G3 ), z1 = z0 - Lanes<F>::load( offsets1[2] ) + F( G3 );
+	const F x2 = x0 - Lanes<F>::load( offsets2[0] ) + F( 2 * G3 ), y2 = y0 - Lanes<F>::load( offsets2[1] ) + F( 2 * G3 ), z2 = z0 - Lanes<F>::load( offsets2[2] ) + F( 2 * G3 );
+	const F x3 = x0 - F( 1 - 3 * G3 ), y3 = y0 - F( 1 - 3 * G3 ), z3 = z0 - F( 1 - 3 * G3 );
+	F n( 0.0f ), ddx( 0.0f ), ddy( 0.0f ), ddz( 0.0f );
+	F *ddxPtr = dx ? &ddx : nullptr;
+	addSimplexCorner( 0.5f, x0, y0, z0, gx[0], gy[0], gz[0], &n, ddxPtr, &ddy, &ddz );
+	addSimplexCorner( 0.5f, x1, y1, z1, gx[1], gy[1], gz[1], &n, ddxPtr, &ddy, &ddz );
+	addSimplexCorner( 0.5f, x2, y2, z2, gx[2], gy[2], gz[2], &n, ddxPtr, &ddy, &ddz );
+	addSimplexCorner( 0.5f, x3, y3, z3, gx[3], gy[3], gz[3], &n, ddxPtr, &ddy, &ddz );
+
+	// a radius of 0.5 keeps each corner's contribution inside its simplex so the derivative is continuous; scales the result to about [-1,1]
+	if( dx ) {
+		*dx = ddx * F( 76.0f );
+		*dy = ddy * F( 76.0f );
+		*dz = ddz * F( 76.0f );
+	}
+	return n * F( 76.0f );
+}
+
+
+//! Loads component \a c of the next Lanes<F>::size points
+template<typename F, typename VecT>
+CINDER_PERLIN_INLINE F loadLanes( const VecT *p, int c )
+{
+	float v[Lanes<F>::size];
+	for( int l = 0; l < Lanes<F>::size; ++l )
+		v[l] = p[l][c];
+	return Lanes<F>::load( v );
+}
+
+template<typename F>
+CINDER_PERLIN_INLINE void storeResults( const F &x, const F &y, vec2 *result )
+{
+	float xv[Lanes<F>::size], yv[Lanes<F>::size];
+	lanesStore( x, xv ); lanesStore( y, yv );
+	for( int l = 0; l < Lanes<F>::size; ++l )
+		result[l] = vec2( xv[l], yv[l] );
+}
+
+template<typename F>
+CINDER_PERLIN_INLINE void storeResults( const F &x, const F &y, const F &z, vec3 *result )
+{
+	float xv[Lanes<F>::size], yv[Lanes<F>::size], zv[Lanes<F>::size];
+	lanesStore( x, xv ); lanesStore( y, yv ); lanesStore( z, zv );
+	for( int l = 0; l < Lanes<F>::size; ++l )
+		result[l] = vec3( xv[l], yv[l], zv[l] );
+}
+
+//! Evaluates \a kernel, which maps Lanes<F>::size points to as many results, over \a count points. The last group is padded, so every point goes through the same code.
+template<typename F, typename PointT, typename ResultT, typename KernelT>
+CINDER_PERLIN_INLINE void evalLanes( const PointT *points, size_t count, ResultT *result, const KernelT &kernel )
+{
+	const size_t N = Lanes<F>::size;
+	size_t p = 0;
+	for( ; p + N <= count; p += N )
+		kernel.template eval<F>( points + p, result + p );
+	if( p < count ) {
+		PointT paddedPoints[N];
+		ResultT paddedResult[N];
+		for( size_t l = 0; l < N; ++l )
+			paddedPoints[l] = points[std::min( p + l, count - 1 )];
+		kernel.template eval<F>( paddedPoints, paddedResult );
+		std::copy( paddedResult, paddedResult + ( count - p ), result + p );
+	}
+}
+
+#if defined( CINDER_PERLIN_AVX2 )
+//! evalLanes() over Float8. The lane-generic code is forced inline, so all of it is compiled for AVX2 here.
+template<typename PointT, typename ResultT, typename KernelT>
+CINDER_PERLIN_TARGET( "avx2" )
+void evalLanesAvx2( const PointT *points, size_t count, ResultT *result, const KernelT &kernel )
+{
+	evalLanes<Float8>( points, count, result, kernel );
+}
+#endif
+
+//! Evaluates \a kernel over \a count points with the widest lanes the CPU supports
+template<typename PointT, typename ResultT, typename KernelT>
+void evalGroups( const PointT *points, size_t count, ResultT *result, const KernelT &kernel )
+{
+#if defined( CINDER_PERLIN_AVX2 )
+	if( getNoiseSimdLevel() == NoiseSimdLevel::AVX2 ) {
+		evalLanesAvx2( points, count, result, kernel );
+		return;
+	}
+#endif
+	evalLanes<Float4>( points, count, result, kernel );
+}
+
+//! Evaluates \a kernel over \a count points in parallel. Each point's result is independent of how the points are split among threads.
+template<typename PointT, typename ResultT, typename KernelT>
+void evalPoints( const PointT *points, size_t count, ResultT *result, const KernelT &kernel )
+{
+	const size_t groupSize = 256;
+	parallelFor( ( count + groupSize - 1 ) / groupSize, [&]( size_t begin, size_t end ) {
+		const size_t first = begin * groupSize, last = std::min( end * groupSize, count );
+		evalGroups( points + first, last - first, result + first, kernel );
+	} );
+}
+
+inline vec2 makeAreaPoint( const vec2 &origin, const vec2 &scale, int32_t x, int32_t y ) { return origin + vec2( x, y ) * scale; }
+inline vec3 makeAreaPoint( const vec3 &origin, const vec2 &scale, int32_t x, int32_t y ) { return vec3( origin.x + x * scale.x, origin.y + y * scale.y, origin.z ); }
+
+//! Evaluates \a kernel for each pixel of \a area, in parallel rows, passing each row's results to \a write( y, results )
+template<typename PointT, typename ResultT, typename KernelT, typename WriteT>
+void evalArea( const Area &area, const PointT &origin, const vec2 &scale, const KernelT &kernel, const WriteT &write )
+{
+	const int32_t width = area.getWidth();
+	if( width <= 0 || area.getHeight() <= 0 )
+		return;
+
+	parallelFor( (size_t)area.getHeight(), [&]( size_t begin, size_t end ) {
+		std::vector<PointT> points( width );
+		std::vector<ResultT> results( width );
+		for( size_t row = begin; row < end; ++row ) {
+			const int32_t y = area.y1 + (int32_t)row;
+			for( int32_t x = 0; x < width; ++x )
+				points[x] = makeAreaPoint( origin, scale, area.x1 + x, y );
+			evalGroups( points.data(), points.size(), results.data(), kernel );
+			write( y, results.data() );
+		}
+	}, 4 );
+}
+
+void writeChannel( Channel32f *channel, const Area &area, int32_t y, const float *results )
+{
+	float *dst = channel->getData( ivec2( area.x1, y ) );
+	const uint8_t inc = channel->getIncrement();
+	for( int32_t x = 0; x < area.getWidth(); ++x )
+		dst[x * inc] = results[x];
+}
+
+template<typename VecT>
+void writeSurface( Surface32f *surface, const Area &area, int32_t y, const VecT *results )
+{
+	float *dst = surface->getData( ivec2( area.x1, y ) );
+	const uint8_t inc = surface->getPixelInc();
+	const uint8_t offsets[3] = { surface->getRedOffset(), surface->getGreenOffset(), surface->getBlueOffset() };
+	for( int32_t x = 0; x < area.getWidth(); ++x )
+		for( int c = 0; c < VecT::length(); ++c )
+			dst[x * inc + offsets[c]] = results[x][c];
+}
+
+
+// Kernels behind the batch functions, which evaluate Lanes<F>::size points at a time
+struct PerlinNoiseKernel {
+	template<typename F> CINDER_PERLIN_INLINE void eval( const vec2 *p, float *r ) const { lanesStore( perlinNoise( mPerms, loadLanes<F>( p, 0 ), loadLanes<F>( p, 1 ) ), r ); }
+	template<typename F> CINDER_PERLIN_INLINE void eval( const vec3 *p, float *r ) const { lanesStore( perlinNoise( mPerms, loadLanes<F>( p, 0 ), loadLanes<F>( p, 1 ), loadLanes<F>( p, 2 ) ), r ); }
+
+	const uint8_t	*mPerms;
+};
+
+struct PerlinFBmKernel {
+	template<typename F>
+	CINDER_PERLIN_INLINE void eval( const vec2 *p, float *r ) const
+	{
+		F x = loadLanes<F>( p, 0 ), y = loadLanes<F>( p, 1 ), sum( 0.0f );
+		float amp = 0.5f;
+		for( uint8_t i = 0; i < mOctaves; i++ ) {
+			sum = sum + perlinNoise( mPerms, x, y ) * F( amp );
+			x = x * F( 2.0f ); y = y * F( 2.0f );
+			amp *= 0.5f;
+		}
+		lanesStore( sum, r );
+	}
+
+	template<typename F>
+	CINDER_PERLIN_INLINE void eval( const vec3 *p, float *r ) const
+	{
+		F x = loadLanes<F>( p, 0 ), y = loadLanes<F>( p, 1 ), z = loadLanes<F>( p, 2 ), sum( 0.0f );
+		float amp = 0.5f;
+		for( uint8_t i = 0; i < mOctaves; i++ ) {
+			sum = sum + perlinNoise( mPerms, x, y, z ) * F( amp );
+			x = x * F( 2.0f ); y = y * F( 2.0f ); z = z * F( 2.0f );
+			amp *= 0.5f;
+		}
+		lanesStore( sum, r );
+	}
+
+	const uint8_t	*mPerms;
+	uint8_t			mOctaves;
+};
+
+struct PerlinDFBmKernel {
+	template<typename F>
+	CINDER_PERLIN_INLINE void eval( const vec2 *p, vec2 *r ) const
+	{
+		F x = loadLanes<F>( p, 0 ), y = loadLanes<F>( p, 1 ), sumX( 0.0f ), sumY( 0.0f );
+		float amp = 0.5f;
+		for( uint8_t i = 0; i < mOctaves; i++ ) {
+			F dx, dy;
+			perlinDNoise( mPerms, x, y, &dx, &dy );
+			sumX = sumX + dx * F( amp ); sumY = sumY + dy * F( amp );
+			x = x * F( 2.0f ); y = y * F( 2.0f );
+			amp *= 0.5f;
+		}
+		storeResults( sumX, sumY, r );
+	}
+
+	template<typename F>
+	CINDER_PERLIN_INLINE void eval( const vec3 *p, vec3 *r ) const
+	{
+		F x = loadLanes<F>( p, 0 ), y = loadLanes<F>( p, 1 ), z = loadLanes<F>( p, 2 ), sumX( 0.0f ), sumY( 0.0f ), sumZ( 0.0f );
+		float amp = 0.5f;
+		for( uint8_t i = 0; i < mOctaves; i++ ) {
+			F dx, dy, dz;
+			perlinDNoise( mPerms, x, y, z, &dx, &dy, &dz );
+			sumX = sumX + dx * F( amp ); sumY = sumY + dy * F( amp ); sumZ = sumZ + dz * F( amp );
+			x = x * F( 2.0f ); y = y * F( 2.0f ); z = z * F( 2.0f );
+			amp *= 0.5f;
+		}
+		storeResults( sumX, sumY, sumZ, r );
+	}
+
+	const uint8_t	*mPerms;
+	uint8_t			mOctaves;
+};
+
+struct SimplexNoiseKernel {
+	template<typename F> CINDER_PERLIN_INLINE void eval( const vec2 *p, float *r ) const { lanesStore( simplexNoise<F>( mPerms, mPermsMod12, loadLanes<F>( p, 0 ), loadLanes<F>( p, 1 ), nullptr, nullptr ), r ); }
+	template<typename F> CINDER_PERLIN_INLINE void eval( const vec3 *p, float *r ) const { lanesStore( simplexNoise<F>( mPerms, mPermsMod12, loadLanes<F>( p, 0 ), loadLanes<F>( p, 1 ), loadLanes<F>( p, 2 ), nullptr, nullptr, nullptr ), r ); }
+
+	const uint8_t	*mPerms, *mPermsMod12;
+};
+
+struct SimplexFBmKernel {
+	template<typename F>
+	CINDER_PERLIN_INLINE void eval( const vec2 *p, float *r ) const
+	{
+		F x = loadLanes<F>( p, 0 ), y = loadLanes<F>( p, 1 ), sum( 0.0f );
+		float amp = 0.5f;
+		for( uint8_t i = 0; i < mOctaves; i++ ) {
+			sum = sum + simplexNoise<F>( mPerms, mPermsMod12, x, y, nullptr, nullptr ) * F( amp );
+			x = x * F( 2.0f ); y = y * F( 2.0f );
+			amp *= 0.5f;
+		}
+		lanesStore( sum, r );
+	}
+
+	template<typename F>
+	CINDER_PERLIN_INLINE void eval( const vec3 *p, float *r ) const
+	{
+		F x = loadLanes<F>( p, 0 ), y = loadLanes<F>( p, 1 ), z = loadLanes<F>( p, 2 ), sum( 0.0f );
+		float amp = 0.5f;
+		for( uint8_t i = 0; i < mOctaves; i++ ) {
+			sum = sum + simplexNoise<F>( mPerms, mPermsMod12, x, y, z, nullptr, nullptr, nullptr ) * F( amp );
+			x = x * F( 2.0f ); y = y * F( 2.0f ); z = z * F( 2.0f );
+			amp *= 0.5f;
+		}
+		lanesStore( sum, r );
+	}
+
+	const uint8_t	*mPerms, *mPermsMod12;
+	uint8_t			mOctaves;
+};
+
+// unlike Perlin::dfBm(), these are the true derivatives of fBm(): each octave's slope is scaled by its frequency as well as its amplitude
+struct SimplexDFBmKernel {
+	template<typename F>
+	CINDER_PERLIN_INLINE void eval( const vec2 *p, vec2 *r ) const
+	{
+		F x = loadLanes<F>( p, 0 ), y = loadLanes<F>( p, 1 ), sumX( 0.0f ), sumY( 0.0f );
+		float amp = 0.5f, frequency = 1.0f;
+		for( uint8_t i = 0; i < mOctaves; i++ ) {
+			F dx, dy;
+			simplexNoise<F>( mPerms, mPermsMod12, x, y, &dx, &dy );
+			const F slope( amp * frequency );
+			sumX = sumX + dx * slope; sumY = sumY + dy * slope;
+			x = x * F( 2.0f ); y = y * F( 2.0f );
+			amp *= 0.5f; frequency *= 2.0f;
+		}
+		storeResults( sumX, sumY, r );
+	}
+
+	template<typename F>
+	CINDER_PERLIN_INLINE void eval( const vec3 *p, vec3 *r ) const
+	{
+		F x = loadLanes<F>( p, 0 ), y = loadLanes<F>( p, 1 ), z = loadLanes<F>( p, 2 ), sumX( 0.0f ), sumY( 0.0f ), sumZ( 0.0f );
+		float amp = 0.5f, frequency = 1.0f;
+		for( uint8_t i = 0; i < mOctaves; i++ ) {
+			F dx, dy, dz;
+			simplexNoise<F>( mPerms, mPermsMod12, x, y, z, &dx, &dy, &dz );
+			const F slope( amp * frequency );
+			sumX = sumX + dx * slope; sumY = sumY + dy * slope; sumZ = sumZ + dz * slope;
+			x = x * F( 2.0f ); y = y * F( 2.0f ); z = z * F( 2.0f );
+			amp *= 0.5f; frequency *= 2.0f;
+		}
+		storeResults( sumX, sumY, sumZ, r );
+	}
+
+	const uint8_t	*mPerms, *mPermsMod12;
+	uint8_t			mOctaves;
+};
+
+} // anonymous namespace
+
+void Perlin::noise( const vec2 *points, size_t count, float *result ) const
+{
+	evalPoints( points, count, result, PerlinNoiseKernel{ mPerms } );
+}
+
+void Perlin::noise( const vec3 *points, size_t count, float *result ) const
+{
+	evalPoints( points, count, result, PerlinNoiseKernel{ mPerms } );
+}
+
+void Perlin::fBm( const vec2 *points, size_t count, float *result ) const
+{
+	evalPoints( points, count, result, PerlinFBmKernel{ mPerms, mOctaves } );
+}
+
+void Perlin::fBm( const vec3 *points, size_t count, float *result ) const
+{
+	evalPoints( points, count, result, PerlinFBmKernel{ mPerms, mOctaves } );
+}
+
+void Perlin::dfBm( const vec2 *points, size_t count, vec2 *result ) const
+{
+	evalPoints( points, count, result, PerlinDFBmKernel{ mPerms, mOctaves } );
+}
+
+void Perlin::dfBm( const vec3 *points, size_t count, vec3 *result ) const
+{
+	evalPoints( points, count, result, PerlinDFBmKernel{ mPerms, mOctaves } );
+}
+
+void Perlin::fBm( Channel32f *channel, const Area &area, const vec2 &origin, const vec2 &scale ) const
+{
+	const Area clipped = area.getClipBy( channel->getBounds() );
+	evalArea<vec2, float>( clipped, origin, scale, PerlinFBmKernel{ mPerms, mOctaves },
+		[&]( int32_t y, const float *results ) { writeChannel( channel, clipped, y, results ); } );
+}
+
+void Perlin::fBm( Channel32f *channel, const Area &area, const vec3 &origin, const vec2 &scale ) const
+{
+	const Area clipped = area.getClipBy( channel->getBounds() );
+	evalArea<vec3, float>( clipped, origin, scale, PerlinFBmKernel{ mPerms, mOctaves },
+		[&]( int32_t y, const float *results ) { writeChannel( channel, clipped, y, results ); } );
+}
+
+void Perlin::dfBm( Surface32f *surface, const Area &area, const vec2 &origin, const vec2 &scale ) const
+{
+	const Area clipped = area.getClipBy( surface->getBounds() );
+	evalArea<vec2, vec2>( clipped, origin, scale, PerlinDFBmKernel{ mPerms, mOctaves },
+		[&]( int32_t y, const vec2 *results ) { writeSurface( surface, clipped, y, results ); } );
+}
+
+void Perlin::dfBm( Surface32f *surface, const Area &area, const vec3 &origin, const vec2 &scale ) const
+{
+	const Area clipped = area.getClipBy( surface->getBounds() );
+	evalArea<vec3, vec3>( clipped, origin, scale, PerlinDFBmKernel{ mPerms, mOctaves },
+		[&]( int32_t y, const vec3 *results ) { writeSurface( surface, clipped, y, results ); } );
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// Simplex
+Simplex::Simplex( uint8_t aOctaves, int32_t aSeed )
+	: mOctaves( aOctaves )
+{
+	setSeed( aSeed );
+}
+
+void Simplex::setSeed( int32_t aSeed )
+{
+	mSeed = aSeed;
+
+	// a shuffled permutation, repeated to avoid wrapping indices
+	Rand rand( mSeed );
+	for( int t = 0; t < 256; ++t )
+		mPerms[t] = (uint8_t)t;
+	for( int t = 255; t > 0; --t )
+		std::swap( mPerms[t], mPerms[rand.nextUint( t + 1 )] );
+	for( int t = 0; t < 512; ++t ) {
+		mPerms[t] = mPerms[t & 255];
+		mPermsMod12[t] = mPerms[t] % 12;
+	}
+}
+
+float Simplex::noise( const vec2 &v ) const
+{
+	return simplexNoise<float>( mPerms, mPermsMod12, v.x, v.y, nullptr, nullptr );
+}
 
+float Simplex::noise( const vec3 &v ) const
+{
+	return simplexNoise<float>( mPerms, mPermsMod12, v.x, v.y, v.z, nullptr, nullptr, nullptr );
+}
+
+vec2 Simplex::dnoise( const vec2 &v ) const
+{
+	vec2 result;
+	simplexNoise<float>( mPerms, mPermsMod12, v.x, v.y, &result.x, &result.y );
+	return result;
+}
+
+vec3 Simplex::dnoise( const vec3 &v ) const
+{
+	vec3 result;
+	simplexNoise<float>( mPerms, mPermsMod12, v.x, v.y, v.z, &result.x, &result.y, &result.z );
+	return result;
+}
+
+// single points go through the batch kernels, so that they match batches exactly
+float Simplex::fBm( const vec2 &v ) const
+{
+	float result;
+	evalLanes<Float4>( &v, 1, &result, SimplexFBmKernel{ mPerms, mPermsMod12, mOctaves } );
+	return result;
+}
+
+float Simplex::fBm( const vec3 &v ) const
+{
+	float result;
+	evalLanes<Float4>( &v, 1, &result, SimplexFBmKernel{ mPerms, mPermsMod12, mOctaves } );
+	return result;
+}
+
+vec2 Simplex::dfBm( const vec2 &v ) const
+{
+	vec2 result;
+	evalLanes<Float4>( &v, 1, &result, SimplexDFBmKernel{ mPerms, mPermsMod12, mOctaves } );
+	return result;
+}
+
+vec3 Simplex::dfBm( const vec3 &v ) const
+{
+	vec3 result;
+	evalLanes<Float4>( &v, 1, &result, SimplexDFBmKernel{ mPerms, mPermsMod12, mOctaves } );
+	return result;
+}
+
+void Simplex::noise( const vec2 *points, size_t count, float *result ) const
+{
+	evalPoints( points, count, result, SimplexNoiseKernel{ mPerms, mPermsMod12 } );
+}
+
+void Simplex::noise( const vec3 *points, size_t count, float *result ) const
+{
+	evalPoints( points, count, result, SimplexNoiseKernel{ mPerms, mPermsMod12 } );
+}
+
+void Simplex::fBm( const vec2 *points, size_t count, float *result ) const
+{
+	evalPoints( points, count, result, SimplexFBmKernel{ mPerms, mPermsMod12, mOctaves } );
+}
+
+void Simplex::fBm( const vec3 *points, size_t count, float *result ) const
+{
+	evalPoints( points, count, result, SimplexFBmKernel{ mPerms, mPermsMod12, mOctaves } );
+}
+
+void Simplex::dfBm( const vec2 *points, size_t count, vec2 *result ) const
+{
+	evalPoints( points, count, result, SimplexDFBmKernel{ mPerms, mPermsMod12, mOctaves } );
+}
+
+void Simplex::dfBm( const vec3 *points, size_t count, vec3 *result ) const
+{
+	evalPoints( points, count, result, SimplexDFBmKernel{ mPerms, mPermsMod12, mOctaves } );
+}
+
+void Simplex::fBm( Channel32f *channel, const Area &area, const vec2 &origin, const vec2 &scale ) const
+{
+	const Area clipped = area.getClipBy( channel->getBounds() );
+	evalArea<vec2, float>( clipped, origin, scale, SimplexFBmKernel{ mPerms, mPermsMod12, mOctaves },
+		[&]( int32_t y, const float *results ) { writeChannel( channel, clipped, y, results ); } );
+}
+
+void Simplex::fBm( Channel32f *channel, const Area &area, const vec3 &origin, const vec2 &scale ) const
+{
+	const Area clipped = area.getClipBy( channel->getBounds() );
+	evalArea<vec3, float>( clipped, origin, scale, SimplexFBmKernel{ mPerms, mPermsMod12, mOctaves },
+		[&]( int32_t y, const float *results ) { writeChannel( channel, clipped, y, results ); } );
+}
+
+void Simplex::dfBm( Surface32f *surface, const Area &area, const vec2 &origin, const vec2 &scale ) const
+{
+	const Area clipped = area.getClipBy( surface->getBounds() );
+	evalArea<vec2, vec2>( clipped, origin, scale, SimplexDFBmKernel{ mPerms, mPermsMod12, mOctaves },
+		[&]( int32_t y, const vec2 *results ) { writeSurface( surface, clipped, y, results ); } );
+}
+
+void Simplex::dfBm( Surface32f *surface, const Area &area, const vec3 &origin, const vec2 &scale ) const
+{
+	const Area clipped = area.getClipBy( surface->getBounds() );
+	evalArea<vec3, vec3>( clipped, origin, scale, SimplexDFBmKernel{ mPerms, mPermsMod12, mOctaves },
+		[&]( int32_t y, const vec3 *results ) { writeSurface( surface, clipped, y, results ); } );
+}
 
 } // namespace cinder
@@ -0,0 +1,339 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/PointIndex.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+const uint32_t	MAX_DEPTH = 31;
+const size_t	PARALLEL_SUBTREE_POINTS = 16 * 1024;
+const size_t	QUERY_GRAIN_SIZE = 64;
+const size_t	MAX_INSERTION_K = 32;
+
+// Queries accept points at exactly their maximum distance, while candidates are tested with a strict comparison
+float inclusiveLimit( float maxDistance )
+{
+	return nextafter( maxDistance * maxDistance, numeric_limits<float>::infinity() );
+}
+
+template<typename NeighborT>
+class NearestSet {
+  public:
+	NearestSet( float maxDistance ) : mWorst( inclusiveLimit( maxDistance ) ) {}
+
+	float	worst() const { return mWorst; }
+	void	add( uint32_t index, float distanceSquared ) { mResult = NeighborT( index, distanceSquared ); mWorst = distanceSquared; }
+
+	NeighborT	mResult;
+
+  private:
+	float		mWorst;
+};
+
+// Keeps the k nearest candidates in the caller's buffer. Small k keeps them sorted by insertion, which beats a heap's
+// scattered accesses; larger k uses a max-heap with the furthest candidate on top.
+template<typename NeighborT>
+class KnnSet {
+  public:
+	KnnSet( NeighborT *result, size_t k, float maxDistance )
+		: mResult( result ), mK( k ), mCount( 0 ), mUseHeap( k > MAX_INSERTION_K ), mWorst( k ? inclusiveLimit( maxDistance ) : -1.0f )
+	{}
+
+	float	worst() const { return mWorst; }
+	void	add( uint32_t index, float distanceSquared )
+	{
+		if( mUseHeap ) {
+			if( mCount == mK )
+				pop_heap( mResult, mResult + mCount-- );
+			mResult[mCount++] = NeighborT( index, distanceSquared );
+			push_heap( mResult, mResult + mCount );
+			if( mCount == mK )
+				mWorst = mResult[0].mDistanceSquared;
+		}
+		else {
+			size_t pos = ( mCount < mK ) ? mCount++ : mK - 1;
+			for( ; pos > 0 && mResult[pos - 1].mDistanceSquared > distanceSquared; --pos )
+				mResult[pos] = mResult[pos - 1];
+			mResult[pos] = NeighborT( index, distanceSquared );
+			if( mCount == mK )
+				mWorst = mResult[mK - 1].mDistanceSquared;
+		}
+	}
+	size_t	finish()
+	{
+		if( mUseHeap )
+			sort_heap( mResult, mResult + mCount );
+		return mCount;
+	}
+
+  private:
+	NeighborT	*mResult;
+	size_t		mK, mCount;
+	bool		mUseHeap;
+	float		mWorst;
+};
+
+template<typename NeighborT>
+class RadiusSet {
+  public:
+	RadiusSet( NeighborT *result, size_t maxResults, float radius )
+		: mCount( 0 ), mResult( result ), mMaxResults( maxResults ), mWorst( radius >= 0 ? inclusiveLimit( radius ) : -1.0f )
+	{}
+
+	float	worst() const { return mWorst; }
+	void	add( uint32_t index, float distanceSquared )
+	{
+		if( mCount < mMaxResults )
+			mResult[mCount] = NeighborT( index, distanceSquared );
+		++mCount;
+	}
+
+	size_t	mCount;
+
+  private:
+	NeighborT	*mResult;
+	size_t		mMaxResults;
+	float		mWorst;
+};
+
+template<typename NeighborT>
+class VectorRadiusSet {
+  public:
+	VectorRadiusSet( vector<NeighborT> *result, float radius )
+		: mResult( result ), mWorst( radius >= 0 ? inclusiveLimit( radius ) : -1.0f )
+	{}
+
+	float	worst() const { return mWorst; }
+	void	add( uint32_t index, float distanceSquared ) { mResult->emplace_back( index, distanceSquared ); }
+
+  private:
+	vector<NeighborT>	*mResult;
+	float				mWorst;
+};
+
+} // anonymous namespace
+
+template<typename VecT>
+const int PointIndexT<VecT>::DIMS;
+template<typename VecT>
+const uint32_t PointIndexT<VecT>::INVALID_INDEX;
+
+template<typename VecT>
+PointIndexT<VecT>::PointIndexT( const VecT *points, size_t numPoints, uint32_t maxLeafPoints )
+	: mMaxLeafPoints( std::max<uint32_t>( maxLeafPoints, 1 ) ), mDepth( 0 )
+{
+	build( points, numPoints );
+}
+
+template<typename VecT>
+void PointIndexT<VecT>::build( const VecT *points, size_t numPoints )
+{
+	mEntries.resize( numPoints );
+	parallelFor( numPoints, [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i ) {
+			mEntries[i].mPoint = points[i];
+			mEntries[i].mId = (uint32_t)i;
+		}
+	}, PARALLEL_SUBTREE_POINTS );
+
+	// Split until the largest leaf, which holds the rounded up share of the points, is small enough
+	mDepth = 0;
+	while( mDepth < MAX_DEPTH && ( ( numPoints + ( size_t( 1 ) << mDepth ) - 1 ) >> mDepth ) > mMaxLeafPoints )
+		++mDepth;
+	mNodes.resize( ( size_t( 1 ) << mDepth ) - 1 );
+
+	buildNode( 0, 0, 0, numPoints );
+}
+
+template<typename VecT>
+void PointIndexT<VecT>::buildNode( size_t node, uint32_t depth, size_t begin, size_t end )
+{
+	if( depth == mDepth )
+		return;
+
+	// Split along the axis of greatest extent
+	VecT minCorner( numeric_limits<T>::max() ), maxCorner( -numeric_limits<T>::max() );
+	for( size_t i = begin; i < end; ++i ) {
+		minCorner = glm::min( minCorner, mEntries[i].mPoint );
+		maxCorner = glm::max( maxCorner, mEntries[i].mPoint );
+	}
+	const VecT extent = maxCorner - minCorner;
+	uint32_t axis = 0;
+	for( int d = 1; d < DIMS; ++d ) {
+		if( extent[d] > extent[axis] )
+			axis = d;
+	}
+
+	const size_t mid = begin + ( end - begin ) / 2;
+	Entry *entries = mEntries.data();
+	nth_element( entries + begin, entries + mid, entries + end, [axis]( const Entry &a, const Entry &b ) {
+		return a.mPoint[axis] < b.mPoint[axis];
+	} );
+
+	Node &n = mNodes[node];
+	n.mAxis = axis;
+	n.mRightMin = ( mid < end ) ? entries[mid].mPoint[axis] : 0;
+	n.mLeftMax = ( begin < mid ) ? entries[begin].mPoint[axis] : n.mRightMin;
+	for( size_t i = begin + 1; i < mid; ++i )
+		n.mLeftMax = std::max( n.mLeftMax, entries[i].mPoint[axis] );
+
+	if( end - begin > PARALLEL_SUBTREE_POINTS ) {
+		parallelFor( 2, [&]( size_t first, size_t last ) {
+			for( size_t c = first; c < last; ++c )
+				buildNode( 2 * node + 1 + c, depth + 1, c ? mid : begin, c ? end : mid );
+		} );
+	}
+	else {
+		buildNode( 2 * node + 1, depth + 1, begin, mid );
+		buildNode( 2 * node + 2, depth + 1, mid, end );
+	}
+}
+
+template<typename VecT>
+template<typename ResultSetT>
+void PointIndexT<VecT>::search( const VecT &point, ResultSetT &resultSet ) const
+{
+	if( mEntries.empty() || resultSet.worst() < 0 )
+		return;
+
+	VecT offsets( 0 );
+	searchNode( 0, 0, 0, mEntries.size(), point, offsets, 0, resultSet );
+}
+
+// Descends into the nearer child first. The lower bound on the squared distance to a subtree sums the squared offsets to the
+// split planes crossed along each axis, replacing an axis' previous offset as a nested split tightens it.
+template<typename VecT>
+template<typename ResultSetT>
+void PointIndexT<VecT>::searchNode( size_t node, uint32_t depth, size_t begin, size_t end, const VecT &point, VecT &offsets, float distanceSquared, ResultSetT &resultSet ) const
+{
+	if( depth == mDepth ) {
+		for( size_t i = begin; i < end; ++i ) {
+			const VecT delta = mEntries[i].mPoint - point;
+			const float d2 = glm::dot( delta, delta );
+			if( d2 < resultSet.worst() )
+				resultSet.add( mEntries[i].mId, d2 );
+		}
+		return;
+	}
+
+	const Node &n = mNodes[node];
+	const size_t mid = begin + ( end - begin ) / 2;
+	const T value = point[n.mAxis];
+	const T toLeft = value - n.mLeftMax, toRight = value - n.mRightMin;
+
+	size_t nearChild, farChild, nearBegin, nearEnd, farBegin, farEnd;
+	float cut;
+	if( toLeft + toRight < 0 ) {
+		nearChild = 2 * node + 1; nearBegin = begin; nearEnd = mid;
+		farChild = 2 * node + 2; farBegin = mid; farEnd = end;
+		cut = toRight * toRight;
+	}
+	else {
+		nearChild = 2 * node + 2; nearBegin = mid; nearEnd = end;
+		farChild = 2 * node + 1; farBegin = begin; farEnd = mid;
+		cut = toLeft * toLeft;
+	}
+
+	searchNode( nearChild, depth + 1, nearBegin, nearEnd, point, offsets, distanceSquared, resultSet );
+
+	const T previous = offsets[n.mAxis];
+	const float farDistanceSquared = distanceSquared + cut - previous;
+	if( farDistanceSquared < resultSet.worst() ) {
+		offsets[n.mAxis] = cut;
+		searchNode( farChild, depth + 1, farBegin, farEnd, point, offsets, farDistanceSquared, resultSet );
+		offsets[n.mAxis] = previous;
+	}
+}
+
+template<typename VecT>
+uint32_t PointIndexT<VecT>::findNearest( const VecT &point, float *distanceSquared, float maxDistance ) const
+{
+	NearestSet<Neighbor> resultSet( maxDistance );
+	search( point, resultSet );
+	if( distanceSquared )
+		*distanceSquared = resultSet.mResult.mDistanceSquared;
+
+	return resultSet.mResult.mIndex;
+}
+
+template<typename VecT>
+size_t PointIndexT<VecT>::findNearest( const VecT &point, size_t k, Neighbor *result, float maxDistance ) const
+{
+	KnnSet<Neighbor> resultSet( result, k, maxDistance );
+	search( point, resultSet );
+
+	return resultSet.finish();
+}
+
+template<typename VecT>
+size_t PointIndexT<VecT>::findInRadius( const VecT &point, float radius, Neighbor *result, size_t maxResults ) const
+{
+	RadiusSet<Neighbor> resultSet( result, maxResults, radius );
+	search( point, resultSet );
+
+	return resultSet.mCount;
+}
+
+template<typename VecT>
+size_t PointIndexT<VecT>::findInRadius( const VecT &point, float radius, std::vector<Neighbor> *result ) const
+{
+	const size_t prevSize = result->size();
+	VectorRadiusSet<Neighbor> resultSet( result, radius );
+	search( point, resultSet );
+
+	return result->size() - prevSize;
+}
+
+template<typename VecT>
+void PointIndexT<VecT>::findNearest( const VecT *points, size_t numPoints, size_t k, Neighbor *results, size_t *counts, float maxDistance ) const
+{
+	parallelFor( numPoints, [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i ) {
+			size_t count = findNearest( points[i], k, results + i * k, maxDistance );
+			if( counts )
+				counts[i] = count;
+		}
+	}, QUERY_GRAIN_SIZE );
+}
+
+template<typename VecT>
+void PointIndexT<VecT>::findInRadius( const VecT *points, size_t numPoints, float radius, Neighbor *results, size_t maxResultsPerPoint, size_t *counts ) const
+{
+	parallelFor( numPoints, [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			counts[i] = findInRadius( points[i], radius, results + i * maxResultsPerPoint, maxResultsPerPoint );
+	}, QUERY_GRAIN_SIZE );
+}
+
+template class CI_API PointIndexT<vec2>;
+template class CI_API PointIndexT<vec3>;
+
+} // namespace cinder
@@ -22,8 +22,10 @@
 */
 
 #include "cinder/PolyLine.h"
+#include "cinder/Thread.h"
 
 #include <algorithm>
+#include <cmath>
 
 namespace cinder {
 
@@ -143,6 +145,314 @@ PolyLineT<T> PolyLineT<T>::reversed() const
 	return result;
 }
 
+namespace {
+
+template<typename T>
+typename T::value_type distanceToSegmentSquared( const T &p, const T &a, const T &b )
+{
+	typedef typename T::value_type V;
+	const T ab = b - a;
+	const V lengthSquared = dot( ab, ab );
+	const V t = ( lengthSquared > 0 ) ? glm::clamp( dot( p - a, ab ) / lengthSquared, V( 0 ), V( 1 ) ) : V( 0 );
+	const T delta = p - ( a + ab * t );
+	return dot( delta, delta );
+}
+
+template<typename T>
+typename T::value_type triangleArea( const T &a, const T &b, const T &c )
+{
+	return std::abs( ( b.x - a.x ) * ( c.y - a.y ) - ( b.y - a.y ) * ( c.x - a.x ) ) / 2;
+}
+
+//! Scratch space for simplification, reused across the lines of a batch
+template<typename V>
+struct SimplifyBuffers {
+	std::vector<uint8_t>						mKeep;
+	std::vector<std::pair<uint32_t, uint32_t>>	mStack;
+	std::vector<uint32_t>						mPrev, mNext;
+	std::vector<V>								mAreas;
+	std::vector<std::pair<V, uint32_t>>			mHeap;
+};
+
+//! Keeps the points of \a points farther than the tolerance from the line through the points kept so far, subdividing with an explicit stack
+template<typename T>
+void markDouglasPeucker( const std::vector<T> &points, uint32_t first, uint32_t last, typename T::value_type toleranceSquared, SimplifyBuffers<typename T::value_type> *buffers )
+{
+	auto &stack = buffers->mStack;
+	stack.clear();
+	stack.emplace_back( first, last );
+	while( ! stack.empty() ) {
+		const auto range = stack.back();
+		stack.pop_back();
+		typename T::value_type maxDistanceSquared = toleranceSquared;
+		uint32_t farthest = 0;
+		for( uint32_t i = range.first + 1; i < range.second; ++i ) {
+			const auto distanceSquared = distanceToSegmentSquared( points[i], points[range.first], points[range.second] );
+			if( distanceSquared > maxDistanceSquared ) {
+				maxDistanceSquared = distanceSquared;
+				farthest = i;
+			}
+		}
+		if( farthest ) {
+			buffers->mKeep[farthest] = 1;
+			stack.emplace_back( range.first, farthest );
+			stack.emplace_back( farthest, range.second );
+		}
+	}
+}
+
+//! Repeatedly drops the point whose triangle with its neighbors has the smallest area, using a lazily updated min-heap
+template<typename T>
+void markVisvalingam( const std::vector<T> &points, bool closed, typename T::value_type minArea, SimplifyBuffers<typename T::value_type> *buffers )
+{
+	typedef typename T::value_type V;
+	const uint32_t n = (uint32_t)points.size();
+	auto &prev = buffers->mPrev, &next = buffers->mNext;
+	auto &areas = buffers->mAreas;
+	auto &heap = buffers->mHeap;
+	auto &keep = buffers->mKeep;
+	prev.resize( n );
+	next.resize( n );
+	areas.resize( n );
+	heap.clear();
+	for( uint32_t i = 0; i < n; ++i ) {
+		prev[i] = ( i + n - 1 ) % n;
+		next[i] = ( i + 1 ) % n;
+	}
+	auto isRemovable = [&]( uint32_t i ) { return closed || ( i > 0 && i + 1 < n ); };
+	auto greater = []( const std::pair<V, uint32_t> &a, const std::pair<V, uint32_t> &b ) { return a.first > b.first; };
+	for( uint32_t i = 0; i < n; ++i ) {
+		if( isRemovable( i ) ) {
+			areas[i] = triangleArea( points[prev[i]], points[i], points[next[i]] );
+			heap.emplace_back( areas[i], i );
+		}
+	}
+	std::make_heap( heap.begin(), heap.end(), greater );
+
+	uint32_t remaining = n;
+	const uint32_t minRemaining = closed ? 3 : 2;
+	while( ! heap.empty() && remaining > minRemaining ) {
+		std::pop_heap( heap.begin(), heap.end(), greater );
+		const auto entry = heap.back();
+		heap.pop_back();
+		const uint32_t i = entry.second;
+		// entries are superseded rather than updated when a neighbor's removal changes a point's area
+		if( ! keep[i] || entry.first != areas[i] )
+			continue;
+		if( entry.first >= minArea )
+			break;
+		keep[i] = 0;
+		--remaining;
+		next[prev[i]] = next[i];
+		prev[next[i]] = prev[i];
+		// a neighbor never becomes cheaper to remove than the point just removed, so removal order follows the area threshold
+		for( uint32_t neighbor : { prev[i], next[i] } ) {
+			if( isRemovable( neighbor ) ) {
+				areas[neighbor] = std::max( triangleArea( points[prev[neighbor]], points[neighbor], points[next[neighbor]] ), entry.first );
+				heap.emplace_back( areas[neighbor], neighbor );
+				std::push_heap( heap.begin(), heap.end(), greater );
+			}
+		}
+	}
+}
+
+template<typename T>
+void simplifyPoints( std::vector<T> *points, bool closed, typename T::value_type tolerance, typename PolyLineT<T>::SimplifyMethod method, SimplifyBuffers<typename T::value_type> *buffers )
+{
+	const uint32_t n = (uint32_t)points->size();
+	if( n < 3 )
+		return;
+
+	auto &keep = buffers->mKeep;
+	if( method == PolyLineT<T>::SIMPLIFY_VISVALINGAM ) {
+		keep.assign( n, 1 );
+		markVisvalingam( *points, closed, tolerance, buffers );
+	}
+	else if( closed ) {
+		// anchor the loop at its first point and the point farthest from it, repeating the first point to close the second half
+		uint32_t farthest = 0;
+		typename T::value_type maxDistanceSquared = 0;
+		for( uint32_t i = 1; i < n; ++i ) {
+			const T delta = (*points)[i] - (*points)[0];
+			if( dot( delta, delta ) > maxDistanceSquared ) {
+				maxDistanceSquared = dot( delta, delta );
+				farthest = i;
+			}
+		}
+		keep.assign( n + 1, 0 );
+		keep[0] = keep[farthest] = 1;
+		points->push_back( (*points)[0] );
+		markDouglasPeucker( *points, 0, farthest, tolerance * tolerance, buffers );
+		markDouglasPeucker( *points, farthest, n, tolerance * tolerance, buffers );
+		points->pop_back();
+	}
+	else {
+		keep.assign( n, 0 );
+		keep[0] = keep[n - 1] = 1;
+		markDouglasPeucker( *points, 0, n - 1, tolerance * tolerance, buffers );
+	}
+
+	size_t numKept = 0;
+	for( uint32_t i = 0; i < n; ++i ) {
+		if( keep[i] )
+			(*points)[numKept++] = (*points)[i];
+	}
+	points->resize( numKept );
+}
+
+//! Returns the point at \a t between \a p1 and \a p2 on the centripetal Catmull-Rom spline through \a p0 to \a p3, evaluated with the Barry-Goldman pyramid
+template<typename T>
+T evalCentripetalCatmullRom( const T &p0, const T &p1, const T &p2, const T &p3, typename T::value_type s )
+{
+	typedef typename T::value_type V;
+	// coincident points would make knot intervals vanish
+	const V minInterval = V( 1e-4 );
+	const V t0 = 0;
+	const V t1 = t0 + std::max( std::sqrt( glm::distance( p0, p1 ) ), minInterval );
+	const V t2 = t1 + std::max( std::sqrt( glm::distance( p1, p2 ) ), minInterval );
+	const V t3 = t2 + std::max( std::sqrt( glm::distance( p2, p3 ) ), minInterval );
+	const V t = t1 + ( t2 - t1 ) * s;
+	const T a1 = p0 * ( ( t1 - t ) / ( t1 - t0 ) ) + p1 * ( ( t - t0 ) / ( t1 - t0 ) );
+	const T a2 = p1 * ( ( t2 - t ) / ( t2 - t1 ) ) + p2 * ( ( t - t1 ) / ( t2 - t1 ) );
+	const T a3 = p2 * ( ( t3 - t ) / ( t3 - t2 ) ) + p3 * ( ( t - t2 ) / ( t3 - t2 ) );
+	const T b1 = a1 * ( ( t2 - t ) / ( t2 - t0 ) ) + a2 * ( ( t - t0 ) / ( t2 - t0 ) );
+	const T b2 = a2 * ( ( t3 - t ) / ( t3 - t1 ) ) + a3 * ( ( t - t1 ) / ( t3 - t1 ) );
+	return b1 * ( ( t2 - t ) / ( t2 - t1 ) ) + b2 * ( ( t - t1 ) / ( t2 - t1 ) );
+}
+
+} // anonymous namespace
+
+template<typename T>
+void PolyLineT<T>::simplify( typename T::value_type tolerance, SimplifyMethod method )
+{
+	SimplifyBuffers<typename T::value_type> buffers;
+	simplifyPoints( &mPoints, mClosed, tolerance, method, &buffers );
+}
+
+template<typename T>
+PolyLineT<T> PolyLineT<T>::simplified( typename T::value_type tolerance, SimplifyMethod method ) const
+{
+	PolyLineT result( *this );
+	result.simplify( tolerance, method );
+	return result;
+}
+
+template<typename T>
+void PolyLineT<T>::simplify( std::vector<PolyLineT<T>> *polyLines, typename T::value_type tolerance, SimplifyMethod method )
+{
+	const size_t grainSize = 16;
+	parallelFor( polyLines->size(), [&]( size_t begin, size_t end ) {
+		SimplifyBuffers<typename T::value_type> buffers;
+		for( size_t i = begin; i < end; ++i )
+			simplifyPoints( &(*polyLines)[i].mPoints, (*polyLines)[i].mClosed, tolerance, method, &buffers );
+	}, grainSize );
+}
+
+template<typename T>
+void PolyLineT<T>::resampleUniform( typename T::value_type spacing )
+{
+	typedef typename T::value_type V;
+	const size_t numPoints = mPoints.size();
+	const size_t numSegments = mClosed ? numPoints : numPoints - 1;
+	if( numPoints < 2 || spacing <= 0 )
+		return;
+
+	V length = 0;
+	for( size_t s = 0; s < numSegments; ++s )
+		length += glm::distance( mPoints[s], mPoints[( s + 1 ) % numPoints] );
+	if( length <= 0 )
+		return;
+
+	const size_t numIntervals = std::max<size_t>( mClosed ? 3 : 1, (size_t)std::round( length / spacing ) );
+	const size_t numSamples = mClosed ? numIntervals : numIntervals + 1;
+	const V step = length / numIntervals;
+	std::vector<T> result;
+	result.reserve( numSamples );
+	size_t segment = 0;
+	V segmentStart = 0, segmentLength = glm::distance( mPoints[0], mPoints[1 % numPoints] );
+	for( size_t i = 0; i < numSamples; ++i ) {
+		const V distance = i * step;
+		while( segmentStart + segmentLength < distance && segment + 1 < numSegments ) {
+			segmentStart += segmentLength;
+			++segment;
+			segmentLength = glm::distance( mPoints[segment], mPoints[( segment + 1 ) % numPoints] );
+		}
+		const V t = ( segmentLength > 0 ) ? glm::clamp( ( distance - segmentStart ) / segmentLength, V( 0 ), V( 1 ) ) : V( 0 );
+		result.push_back( glm::mix( mPoints[segment], mPoints[( segment + 1 ) % numPoints], t ) );
+	}
+	if( ! mClosed )
+		result.back() = mPoints.back();
+
+	mPoints.swap( result );
+}
+
+template<typename T>
+PolyLineT<T> PolyLineT<T>::resampledUniform( typename T::value_type spacing ) const
+{
+	PolyLineT result( *this );
+	result.resampleUniform( spacing );
+	return result;
+}
+
+template<typename T>
+void PolyLineT<T>::smooth( SmoothMethod method, int count )
+{
+	typedef typename T::value_type V;
+	if( mPoints.size() < 3 || count < 1 )
+		return;
+
+	std::vector<T> result;
+	if( method == SMOOTH_CHAIKIN ) {
+		for( int iteration = 0; iteration < count; ++iteration ) {
+			const size_t numPoints = mPoints.size(), numSegments = mClosed ? numPoints : numPoints - 1;
+			result.clear();
+			result.reserve( numSegments * 2 + 2 );
+			if( ! mClosed )
+				result.push_back( mPoints.front() );
+			for( size_t s = 0; s < numSegments; ++s ) {
+				const T &a = mPoints[s], &b = mPoints[( s + 1 ) % numPoints];
+				result.push_back( a * V( 0.75 ) + b * V( 0.25 ) );
+				result.push_back( a * V( 0.25 ) + b * V( 0.75 ) );
+			}
+			if( ! mClosed )
+				result.push_back( mPoints.back() );
+			// the previous points become the next iteration's output buffer
+			mPoints.swap( result );
+		}
+	}
+	else {
+		const size_t numPoints = mPoints.size(), numSegments = mClosed ? numPoints : numPoints - 1;
+		result.reserve( numSegments * ( count + 1 ) + 1 );
+		auto point = [&]( ptrdiff_t i ) -> T {
+			if( mClosed )
+				return mPoints[( i + numPoints ) % numPoints];
+			// open ends are extended by reflecting their neighbors
+			if( i < 0 )
+				return mPoints[0] * V( 2 ) - mPoints[1];
+			if( i >= (ptrdiff_t)numPoints )
+				return mPoints[numPoints - 1] * V( 2 ) - mPoints[numPoints - 2];
+			return mPoints[i];
+		};
+		for( size_t s = 0; s < numSegments; ++s ) {
+			const T p0 = point( (ptrdiff_t)s - 1 ), p1 = point( s ), p2 = point( s + 1 ), p3 = point( s + 2 );
+			result.push_back( p1 );
+			for( int i = 1; i <= count; ++i )
+				result.push_back( evalCentripetalCatmullRom( p0, p1, p2, p3, i / V( count + 1 ) ) );
+		}
+		if( ! mClosed )
+			result.push_back( mPoints.back() );
+		mPoints.swap( result );
+	}
+}
+
+template<typename T>
+PolyLineT<T> PolyLineT<T>::smoothed( SmoothMethod method, int count ) const
+{
+	PolyLineT result( *this );
+	result.smooth( method, count );
+	return result;
+}
+
 template<typename T>
 T linearYatX( const glm::tvec2<T, glm::defaultp> p[2], T x )
 {
@@ -24,9 +24,242 @@
 
 #include "cinder/Rand.h"
 
+#include <atomic>
+#include <cmath>
+
 namespace cinder {
 
 std::mt19937 Rand::sBase( 310u );
 std::uniform_real_distribution<float> Rand::sFloatGen;
 
+namespace {
+
+inline uint64_t rotl( uint64_t x, int k )
+{
+	return ( x << k ) | ( x >> ( 64 - k ) );
+}
+
+//! Returns the next output of the splitmix64 generator with state \a x, which xoshiro's authors recommend for seeding
+inline uint64_t splitMix64( uint64_t *x )
+{
+	uint64_t z = ( *x += 0x9E3779B97F4A7C15ull );
+	z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+	z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+	return z ^ ( z >> 31 );
+}
+
+//! Marsaglia and Tsang's ziggurat tables for the normal distribution, with 128 layers and 24-bit magnitudes
+struct Ziggurat {
+	static const int	NUM_LAYERS = 128;
+	//! x coordinate of the start of the tail
+	static constexpr double	R = 3.442619855899;
+
+	Ziggurat()
+	{
+		const double m = 16777216.0, v = 9.91256303526217e-3;
+		double dn = R, tn = R;
+		const double q = v / std::exp( -0.5 * dn * dn );
+		k[0] = (uint32_t)( ( dn / q ) * m );
+		k[1] = 0;
+		w[0] = (float)( q / m );
+		w[NUM_LAYERS - 1] = (float)( dn / m );
+		f[0] = 1.0f;
+		f[NUM_LAYERS - 1] = (float)std::exp( -0.5 * dn * dn );
+		for( int i = NUM_LAYERS - 2; i >= 1; --i ) {
+			dn = std::sqrt( -2.0 * std::log( v / dn + std::exp( -0.5 * dn * dn ) ) );
+			k[i + 1] = (uint32_t)( ( dn / tn ) * m );
+			tn = dn;
+			f[i] = (float)std::exp( -0.5 * dn * dn );
+			w[i] = (float)( dn / m );
+		}
+		for( int i = 0; i < NUM_LAYERS; ++i )
+			w[NUM_LAYERS + i] = -w[i];
+	}
+
+	//! a 24-bit magnitude below k[i] lies inside layer i's rectangle
+	uint32_t	k[NUM_LAYERS];
+	//! scales a 24-bit magnitude of layer i to x, followed by the same for negative x
+	float		w[NUM_LAYERS * 2];
+	//! the density at the bottom edge of layer i
+	float		f[NUM_LAYERS];
+};
+
+const Ziggurat& getZiggurat()
+{
+	static const Ziggurat sZiggurat;
+	return sZiggurat;
+}
+
+//! Handles the word \a u that fell outside its layer's rectangle, drawing more words while samples are rejected
+float gaussianSlowPath( FastRand *rand, const Ziggurat &z, uint32_t u )
+{
+	while( true ) {
+		const int layer = u & ( Ziggurat::NUM_LAYERS - 1 );
+		const uint32_t magnitude = u >> 8;
+		const float sign = ( u & 0x80 ) ? -1.0f : 1.0f;
+		const float x = magnitude * z.w[layer];
+		if( magnitude < z.k[layer] )
+			return sign * x;
+
+		if( layer == 0 ) {
+			// the tail beyond R, sampled with Marsaglia's method
+			float tailX, tailY;
+			do {
+				tailX = -std::log( ( ( rand->nextUint() >> 8 ) + 0.5f ) * ( 1.0f / 16777216.0f ) ) * (float)( 1.0 / Ziggurat::R );
+				tailY = -std::log( ( ( rand->nextUint() >> 8 ) + 0.5f ) * ( 1.0f / 16777216.0f ) );
+			} while( tailY + tailY < tailX * tailX );
+			return sign * ( (float)Ziggurat::R + tailX );
+		}
+
+		// the wedge between the layer's rectangle and the curve
+		if( z.f[layer] + rand->nextFloat() * ( z.f[layer - 1] - z.f[layer] ) < std::exp( -0.5f * x * x ) )
+			return sign * x;
+
+		u = rand->nextUint();
+	}
+}
+
+//! Returns a standard normal sample; 7 bits of each word select the layer, 1 bit the sign and 24 bits the magnitude
+inline float gaussian( FastRand *rand, const Ziggurat &z )
+{
+	const uint32_t u = rand->nextUint();
+	const int layer = u & ( Ziggurat::NUM_LAYERS - 1 );
+	const uint32_t magnitude = u >> 8;
+	// the sign bit selects the negated half of w, as a branch on it would be mispredicted half the time
+	if( magnitude < z.k[layer] )
+		return magnitude * z.w[u & 0xFF];
+	return gaussianSlowPath( rand, z, u );
+}
+
+//! Stream numbers of threadLocal() generators that haven't been explicitly seeded
+std::atomic<uint64_t> sNextThreadStream( 0 );
+
+} // anonymous namespace
+
+void FastRand::seed( uint64_t seedValue, uint64_t stream )
+{
+	// lane l of stream s takes splitmix64 outputs 4 * ( s * NUM_LANES + l ) onward, so no two lanes of any stream share a seed
+	for( int lane = 0; lane < NUM_LANES; ++lane ) {
+		uint64_t x = seedValue + ( stream * NUM_LANES + lane ) * 4 * 0x9E3779B97F4A7C15ull;
+		for( int word = 0; word < 4; ++word )
+			mState[word][lane] = splitMix64( &x );
+	}
+	mWordIndex = NUM_WORDS;
+}
+
+void FastRand::generate( uint32_t *dst, size_t numSteps )
+{
+	uint64_t s0[NUM_LANES], s1[NUM_LANES], s2[NUM_LANES], s3[NUM_LANES];
+	for( int l = 0; l < NUM_LANES; ++l ) {
+		s0[l] = mState[0][l];
+		s1[l] = mState[1][l];
+		s2[l] = mState[2][l];
+		s3[l] = mState[3][l];
+	}
+
+	for( size_t step = 0; step < numSteps; ++step, dst += NUM_LANES * 2 ) {
+		uint64_t result[NUM_LANES];
+		for( int l = 0; l < NUM_LANES; ++l ) {
+			result[l] = rotl( s0[l] + s3[l], 23 ) + s0[l];
+			const uint64_t t = s1[l] << 17;
+			s2[l] ^= s0[l];
+			s3[l] ^= s1[l];
+			s1[l] ^= s2[l];
+			s0[l] ^= s3[l];
+			s2[l] ^= t;
+			s3[l] = rotl( s3[l], 45 );
+		}
+		for( int l = 0; l < NUM_LANES; ++l ) {
+			dst[l * 2] = (uint32_t)result[l];
+			dst[l * 2 + 1] = (uint32_t)( result[l] >> 32 );
+		}
+	}
+
+	for( int l = 0; l < NUM_LANES; ++l ) {
+		mState[0][l] = s0[l];
+		mState[1][l] = s1[l];
+		mState[2][l] = s2[l];
+		mState[3][l] = s3[l];
+	}
+}
+
+void FastRand::refill()
+{
+	generate( mWords, NUM_STEPS );
+	mWordIndex = 0;
+}
+
+template<typename FnT>
+void FastRand::consumeWords( size_t count, const FnT &fn )
+{
+	// the rest of the buffer first, then whole chunks generated directly, then the start of a new buffer
+	const size_t buffered = std::min<size_t>( count, NUM_WORDS - mWordIndex );
+	fn( mWords + mWordIndex, buffered );
+	mWordIndex += (int)buffered;
+	count -= buffered;
+
+	const size_t CHUNK_STEPS = 64;
+	uint32_t chunk[CHUNK_STEPS * NUM_LANES * 2];
+	while( count >= NUM_WORDS ) {
+		const size_t numSteps = std::min( CHUNK_STEPS, count / ( NUM_LANES * 2 ) );
+		generate( chunk, numSteps );
+		fn( chunk, numSteps * NUM_LANES * 2 );
+		count -= numSteps * NUM_LANES * 2;
+	}
+
+	if( count ) {
+		refill();
+		fn( mWords, count );
+		mWordIndex = (int)count;
+	}
+}
+
+float FastRand::nextGaussian()
+{
+	return gaussian( this, getZiggurat() );
+}
+
+void FastRand::fill( uint32_t *dst, size_t count )
+{
+	consumeWords( count, [&dst]( const uint32_t *words, size_t n ) {
+		std::copy( words, words + n, dst );
+		dst += n;
+	} );
+}
+
+void FastRand::fill( float *dst, size_t count, float a, float b )
+{
+	const float range = b - a;
+	consumeWords( count, [&]( const uint32_t *words, size_t n ) {
+		for( size_t i = 0; i < n; ++i )
+			dst[i] = toFloat( words[i] ) * range + a;
+		dst += n;
+	} );
+}
+
+void FastRand::fillGaussian( float *dst, size_t count, float mean, float stdDev )
+{
+	const Ziggurat &z = getZiggurat();
+	for( size_t i = 0; i < count; ++i )
+		dst[i] = gaussian( this, z ) * stdDev + mean;
+}
+
+void FastRand::fillVec2OnCircle( vec2 *dst, size_t count )
+{
+	for( size_t i = 0; i < count; ++i )
+		dst[i] = nextVec2();
+}
+
+void FastRand::fillVec3OnSphere( vec3 *dst, size_t count )
+{
+	for( size_t i = 0; i < count; ++i )
+		dst[i] = nextVec3();
+}
+
+FastRand& FastRand::threadLocal()
+{
+	thread_local FastRand sRand( 310, sNextThreadStream++ );
+	return sRand;
+}
+
 } // ci
\ No newline at end of file
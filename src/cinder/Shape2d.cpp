@@ -21,6 +21,7 @@
 */
 
 #include "cinder/Shape2d.h"
+#include "cinder/Thread.h"
 
 using std::vector;
 
@@ -175,6 +176,28 @@ vec2 Shape2d::calcClosestPoint( const vec2 &pt ) const
 	return result;
 }
 
+void Shape2d::flatten( std::vector<vec2> *resultPositions, std::vector<uint32_t> *resultContourOffsets, float approximationScale ) const
+{
+	// the point counts are known up front, so every contour is written to its own range in parallel
+	vector<uint32_t> localOffsets;
+	vector<uint32_t> &offsets = resultContourOffsets ? *resultContourOffsets : localOffsets;
+	offsets.resize( mContours.size() + 1 );
+	const size_t grainSize = 16;
+	parallelFor( mContours.size(), [&]( size_t begin, size_t end ) {
+		for( size_t c = begin; c < end; ++c )
+			offsets[c + 1] = (uint32_t)mContours[c].calcNumFlattenedPoints( approximationScale );
+	}, grainSize );
+	offsets[0] = 0;
+	for( size_t c = 0; c < mContours.size(); ++c )
+		offsets[c + 1] += offsets[c];
+
+	resultPositions->resize( offsets.back() );
+	parallelFor( mContours.size(), [&]( size_t begin, size_t end ) {
+		for( size_t c = begin; c < end; ++c )
+			mContours[c].flatten( resultPositions->data() + offsets[c], approximationScale );
+	}, grainSize );
+}
+
 bool Shape2d::contains( const vec2 &pt, bool evenOddFill ) const
 {
 	int w = 0;
@@ -195,4 +218,29 @@ bool Shape2d::contains( const vec2 &pt, bool evenOddFill ) const
 	return false;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////
+// Shape2dFlattenCache
+Shape2dFlattenCache::Shape2dFlattenCache( const Shape2d &shape, float approximationScale )
+	: mShape( shape ), mApproximationScale( approximationScale ), mDirty( true )
+{
+}
+
+void Shape2dFlattenCache::setApproximationScale( float approximationScale )
+{
+	if( approximationScale != mApproximationScale ) {
+		mApproximationScale = approximationScale;
+		mDirty = true;
+	}
+}
+
+void Shape2dFlattenCache::update() const
+{
+	if( ! mDirty )
+		return;
+
+	// reuses the capacity of the previous result
+	mShape.flatten( &mPoints, &mContourOffsets, mApproximationScale );
+	mDirty = false;
+}
+
 } // namespace cinder
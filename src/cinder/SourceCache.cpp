@@ -0,0 +1,323 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/GeomIo.h"
+
+using namespace std;
+
+namespace cinder { namespace geom {
+
+///////////////////////////////////////////////////////////////////////////////////////
+// CacheKey
+CacheKey& CacheKey::operator<<( const std::type_info &type )
+{
+	const string name = type.name();
+	*this << name.size();
+	mData += name;
+	return *this;
+}
+
+CacheKey& CacheKey::operator<<( const CacheKey &key )
+{
+	*this << key.mData.size();
+	mData += key.mData;
+	return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+// CachedSource
+struct CachedSource::Data {
+	struct CapturedAttrib {
+		Attrib			mAttrib;
+		uint8_t			mDims;
+		size_t			mCount;
+		vector<float>	mData;
+	};
+
+	size_t						mNumVertices, mNumIndices;
+	Primitive					mPrimitive;
+	AttribSet					mAvailableAttribs;
+	map<Attrib,uint8_t>			mAttribDims;
+
+	//! every copyAttrib() call of the Source, in order
+	vector<CapturedAttrib>		mAttribs;
+	bool						mHasIndices;
+	Primitive					mIndicesPrimitive;
+	vector<uint32_t>			mIndices;
+	uint8_t						mIndicesRequiredBytes;
+};
+
+//! Records the data a Source loads, in the dimensions it reports for each attribute
+class CachedSource::CaptureTarget : public Target {
+  public:
+	CaptureTarget( const Source &source, const AttribSet &requestedAttribs, CachedSource::Data *data )
+		: mSource( source ), mRequestedAttribs( requestedAttribs ), mData( data )
+	{}
+
+	uint8_t getAttribDims( Attrib attr ) const override
+	{
+		return mSource.getAttribDims( attr );
+	}
+
+	void copyAttrib( Attrib attr, uint8_t dims, size_t strideBytes, const float *srcData, size_t count ) override
+	{
+		// Sources provide some attributes regardless of the request; keeping those would only waste memory
+		if( mRequestedAttribs.count( attr ) == 0 )
+			return;
+
+		CachedSource::Data::CapturedAttrib attrib;
+		attrib.mAttrib = attr;
+		attrib.mDims = dims;
+		attrib.mCount = count;
+		attrib.mData.resize( dims * count );
+		if( dims && count )
+			copyData( dims, strideBytes, srcData, count, dims, 0, attrib.mData.data() );
+		mData->mAttribs.push_back( std::move( attrib ) );
+	}
+
+	void copyIndices( Primitive primitive, const uint32_t *source, size_t numIndices, uint8_t requiredBytesPerIndex ) override
+	{
+		mData->mHasIndices = true;
+		mData->mIndicesPrimitive = primitive;
+		mData->mIndices.assign( source, source + numIndices );
+		mData->mIndicesRequiredBytes = requiredBytesPerIndex;
+	}
+
+  private:
+	const Source		&mSource;
+	const AttribSet		&mRequestedAttribs;
+	CachedSource::Data	*mData;
+};
+
+CachedSource::CachedSource( const Source &source, const AttribSet &requestedAttribs )
+{
+	auto data = make_shared<Data>();
+	data->mNumVertices = source.getNumVertices();
+	data->mNumIndices = source.getNumIndices();
+	data->mPrimitive = source.getPrimitive();
+	data->mAvailableAttribs = source.getAvailableAttribs();
+	for( Attrib attrib : data->mAvailableAttribs )
+		data->mAttribDims[attrib] = source.getAttribDims( attrib );
+	data->mHasIndices = false;
+	data->mIndicesPrimitive = data->mPrimitive;
+	data->mIndicesRequiredBytes = 4;
+
+	CaptureTarget target( source, requestedAttribs, data.get() );
+	source.loadInto( &target, requestedAttribs );
+
+	mData = data;
+}
+
+size_t CachedSource::getNumVertices() const
+{
+	return mData->mNumVertices;
+}
+
+size_t CachedSource::getNumIndices() const
+{
+	return mData->mNumIndices;
+}
+
+Primitive CachedSource::getPrimitive() const
+{
+	return mData->mPrimitive;
+}
+
+uint8_t CachedSource::getAttribDims( Attrib attr ) const
+{
+	auto it = mData->mAttribDims.find( attr );
+	return ( it != mData->mAttribDims.end() ) ? it->second : 0;
+}
+
+AttribSet CachedSource::getAvailableAttribs() const
+{
+	return mData->mAvailableAttribs;
+}
+
+void CachedSource::loadInto( Target *target, const AttribSet & /*requestedAttribs*/ ) const
+{
+	for( const auto &attrib : mData->mAttribs )
+		target->copyAttrib( attrib.mAttrib, attrib.mDims, 0, attrib.mData.data(), attrib.mCount );
+
+	if( mData->mHasIndices )
+		target->copyIndices( mData->mIndicesPrimitive, mData->mIndices.data(), mData->mIndices.size(), mData->mIndicesRequiredBytes );
+}
+
+const float* CachedSource::getAttribData( Attrib attr ) const
+{
+	// the last copy of an attribute is the one a Target keeps
+	for( auto it = mData->mAttribs.rbegin(); it != mData->mAttribs.rend(); ++it )
+		if( it->mAttrib == attr )
+			return it->mData.data();
+	return nullptr;
+}
+
+const std::vector<uint32_t>& CachedSource::getIndices() const
+{
+	return mData->mIndices;
+}
+
+size_t CachedSource::getNumBytes() const
+{
+	size_t result = mData->mIndices.size() * sizeof( uint32_t );
+	for( const auto &attrib : mData->mAttribs )
+		result += attrib.mData.size() * sizeof( float );
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+// SourceCache
+SourceCache::SourceCache( size_t maxBytes )
+	: mMaxBytes( maxBytes ), mNumBytes( 0 ), mNumHits( 0 ), mNumMisses( 0 )
+{
+}
+
+CachedSourceRef SourceCache::get( const Source &source, const AttribSet &requestedAttribs )
+{
+	CacheKey key;
+	CachedSourceRef result;
+	if( source.calcCacheKey( &key ) )
+		result = getCached( source, requestedAttribs, &key );
+
+	return result ? result : make_shared<CachedSource>( source, requestedAttribs );
+}
+
+void SourceCache::loadInto( const Source &source, Target *target, const AttribSet &requestedAttribs )
+{
+	CacheKey key;
+	CachedSourceRef cached;
+	if( getMaxBytes() > 0 && source.calcCacheKey( &key ) )
+		cached = getCached( source, requestedAttribs, &key );
+
+	if( cached )
+		cached->loadInto( target, requestedAttribs );
+	else
+		source.loadInto( target, requestedAttribs );
+}
+
+CachedSourceRef SourceCache::getCached( const Source &source, const AttribSet &requestedAttribs, CacheKey *key )
+{
+	*key << requestedAttribs.size();
+	for( Attrib attrib : requestedAttribs )
+		*key << attrib;
+
+	size_t maxBytes;
+	{
+		lock_guard<mutex> lock( mMutex );
+		auto it = mEntryMap.find( key->getData() );
+		if( it != mEntryMap.end() ) {
+			mEntries.splice( mEntries.begin(), mEntries, it->second );
+			++mNumHits;
+			return it->second->mSource;
+		}
+		++mNumMisses;
+		maxBytes = mMaxBytes;
+	}
+
+	// geometry which wouldn't fit the budget isn't captured at all
+	size_t floatsPerVertex = 0;
+	for( Attrib attrib : requestedAttribs )
+		floatsPerVertex += source.getAttribDims( attrib );
+	if( ( source.getNumVertices() * floatsPerVertex + source.getNumIndices() ) * sizeof( float ) > maxBytes )
+		return nullptr;
+
+	// load without holding the lock; should another thread load the same Source meanwhile, the first result is kept
+	auto result = make_shared<CachedSource>( source, requestedAttribs );
+
+	lock_guard<mutex> lock( mMutex );
+	auto it = mEntryMap.find( key->getData() );
+	if( it != mEntryMap.end() )
+		return it->second->mSource;
+
+	const size_t numBytes = result->getNumBytes();
+	if( numBytes <= mMaxBytes ) {
+		mEntries.push_front( Entry{ key->getData(), result } );
+		mEntryMap[key->getData()] = mEntries.begin();
+		mNumBytes += numBytes;
+		trim();
+	}
+
+	return result;
+}
+
+void SourceCache::trim()
+{
+	while( mNumBytes > mMaxBytes && ! mEntries.empty() ) {
+		mNumBytes -= mEntries.back().mSource->getNumBytes();
+		mEntryMap.erase( mEntries.back().mKey );
+		mEntries.pop_back();
+	}
+}
+
+void SourceCache::clear()
+{
+	lock_guard<mutex> lock( mMutex );
+	mEntries.clear();
+	mEntryMap.clear();
+	mNumBytes = 0;
+}
+
+void SourceCache::setMaxBytes( size_t maxBytes )
+{
+	lock_guard<mutex> lock( mMutex );
+	mMaxBytes = maxBytes;
+	trim();
+}
+
+size_t SourceCache::getMaxBytes() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mMaxBytes;
+}
+
+size_t SourceCache::getNumBytes() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mNumBytes;
+}
+
+size_t SourceCache::getNumEntries() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mEntries.size();
+}
+
+size_t SourceCache::getNumHits() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mNumHits;
+}
+
+size_t SourceCache::getNumMisses() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mNumMisses;
+}
+
+SourceCache& SourceCache::instance()
+{
+	static SourceCache sInstance;
+	return sInstance;
+}
+
+} } // namespace cinder::geom
@@ -0,0 +1,133 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/SpatialHashGrid.h"
+#include "cinder/CinderMath.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+const size_t	GRAIN_SIZE = 16 * 1024;
+const size_t	MIN_TABLE_SIZE = 16;
+
+} // anonymous namespace
+
+template<typename VecT>
+const int SpatialHashGridT<VecT>::DIMS;
+
+template<typename VecT>
+SpatialHashGridT<VecT>::SpatialHashGridT( float cellSize, size_t tableSize )
+	: mCellSize( cellSize ), mInvCellSize( 1.0f / cellSize ), mTableSize( tableSize ), mMask( 0 ), mCursorsCapacity( 0 )
+{
+}
+
+template<typename VecT>
+void SpatialHashGridT<VecT>::build( const VecT *points, size_t numPoints )
+{
+	size_t tableSize = std::max( mTableSize ? mTableSize : numPoints * 2, MIN_TABLE_SIZE );
+	if( ! isPowerOf2( tableSize ) )
+		tableSize = nextPowerOf2( (uint32_t)tableSize );
+	mMask = (uint32_t)tableSize - 1;
+
+	mCellStart.resize( tableSize + 1 );
+	mIndices.resize( numPoints );
+	mPoints.resize( numPoints );
+	mCells.resize( numPoints );
+	mBuckets.resize( numPoints );
+	if( mCursorsCapacity < tableSize ) {
+		mCursors.reset( new atomic<uint32_t>[tableSize] );
+		mCursorsCapacity = tableSize;
+	}
+	atomic<uint32_t> *cursors = mCursors.get();
+
+	// count the points in each bucket
+	parallelFor( tableSize, [&]( size_t begin, size_t end ) {
+		for( size_t b = begin; b < end; ++b )
+			cursors[b].store( 0, memory_order_relaxed );
+	}, GRAIN_SIZE );
+	parallelFor( numPoints, [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i ) {
+			const uint32_t bucket = hashCell( getCell( points[i] ) );
+			mBuckets[i] = bucket;
+			cursors[bucket].fetch_add( 1, memory_order_relaxed );
+		}
+	}, GRAIN_SIZE );
+
+	// turn the counts into starting positions, then scatter the points
+	uint32_t total = 0;
+	for( size_t b = 0; b < tableSize; ++b ) {
+		mCellStart[b] = total;
+		total += cursors[b].load( memory_order_relaxed );
+		cursors[b].store( mCellStart[b], memory_order_relaxed );
+	}
+	mCellStart[tableSize] = total;
+
+	parallelFor( numPoints, [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			mIndices[cursors[mBuckets[i]].fetch_add( 1, memory_order_relaxed )] = (uint32_t)i;
+	}, GRAIN_SIZE );
+
+	// threads scatter in any order, so sort each bucket by cell, keeping cells sharing it apart, and then by source order
+	parallelFor( tableSize, [&]( size_t begin, size_t end ) {
+		for( size_t b = begin; b < end; ++b ) {
+			if( mCellStart[b + 1] - mCellStart[b] > 1 ) {
+				sort( mIndices.begin() + mCellStart[b], mIndices.begin() + mCellStart[b + 1], [&]( uint32_t i, uint32_t j ) {
+					const CellT cellI = getCell( points[i] ), cellJ = getCell( points[j] );
+					for( int d = 0; d < DIMS; ++d ) {
+						if( cellI[d] != cellJ[d] )
+							return cellI[d] < cellJ[d];
+					}
+					return i < j;
+				} );
+			}
+		}
+	}, GRAIN_SIZE );
+
+	parallelFor( numPoints, [&]( size_t begin, size_t end ) {
+		for( size_t p = begin; p < end; ++p ) {
+			mPoints[p] = points[mIndices[p]];
+			mCells[p] = getCell( mPoints[p] );
+		}
+	}, GRAIN_SIZE );
+}
+
+template<typename VecT>
+size_t SpatialHashGridT<VecT>::findInRadius( const VecT &point, float radius, std::vector<uint32_t> *result ) const
+{
+	const size_t prevSize = result->size();
+	forEachInRadius( point, radius, [result]( uint32_t index, float ) {
+		result->push_back( index );
+	} );
+
+	return result->size() - prevSize;
+}
+
+template class CI_API SpatialHashGridT<vec2>;
+template class CI_API SpatialHashGridT<vec3>;
+
+} // namespace cinder
@@ -24,8 +24,11 @@
 
 #include "cinder/Cinder.h"
 #include "cinder/Stream.h"
+#include "cinder/Thread.h"
 #include "cinder/Utilities.h"
 
+#include <zlib.h>
+
 #include <stdio.h>
 #include <limits>
 #include <iostream>
@@ -792,6 +795,255 @@ StreamExc::StreamExc( const std::string &fontName ) throw()
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+// CompressingOStream
+namespace {
+
+const size_t DEFLATE_WINDOW_SIZE = 32768;
+
+// Deflates \a size bytes of \a data as a raw deflate fragment, primed with \a dictionary. Non-final fragments end
+// byte-aligned on a sync flush, so fragments can be concatenated into a single stream.
+void deflateFragment( const uint8_t *data, size_t size, const uint8_t *dictionary, size_t dictionarySize, int level, bool finalFragment, std::vector<uint8_t> *output )
+{
+	z_stream strm;
+	memset( &strm, 0, sizeof(strm) );
+	if( deflateInit2( &strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+		throw StreamExc( "deflateInit2 failed" );
+	if( dictionarySize )
+		deflateSetDictionary( &strm, dictionary, (uInt)dictionarySize );
+
+	output->resize( deflateBound( &strm, (uLong)size ) + 16 );
+	strm.next_in = const_cast<Bytef*>( data );
+	strm.avail_in = (uInt)size;
+	const int flush = finalFragment ? Z_FINISH : Z_SYNC_FLUSH;
+	int err;
+	do {
+		if( strm.total_out == output->size() )
+			output->resize( output->size() * 2 );
+		strm.next_out = output->data() + strm.total_out;
+		strm.avail_out = (uInt)( output->size() - strm.total_out );
+		err = deflate( &strm, flush );
+		if( err == Z_STREAM_ERROR ) {
+			deflateEnd( &strm );
+			throw StreamExc( "deflate failed" );
+		}
+	} while( strm.avail_out == 0 || ( finalFragment && err != Z_STREAM_END ) );
+
+	output->resize( strm.total_out );
+	deflateEnd( &strm );
+}
+
+} // anonymous namespace
+
+CompressingOStream::CompressingOStream( const OStreamRef &target, int8_t compressionLevel, bool useGZip, size_t blockSize )
+	: mTarget( target ), mCompressionLevel( compressionLevel ), mUseGZip( useGZip ), mFinished( false ), mBlockSize( std::max<size_t>( blockSize, 1024 ) ), mTotalIn( 0 )
+{
+	// buffer one block per thread so each batch compresses fully in parallel
+	mBatchSize = mBlockSize * getNumParallelThreads();
+	mPending.reserve( mBatchSize );
+	mCheck = mUseGZip ? (uint32_t)crc32( 0, Z_NULL, 0 ) : (uint32_t)adler32( 0, Z_NULL, 0 );
+
+	if( mUseGZip ) {
+		const uint8_t header[10] = { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, 0, 0xff };
+		mTarget->writeData( header, sizeof(header) );
+	}
+	else {
+		// FLEVEL reflects the compression level, FCHECK makes the header a multiple of 31
+		const uint8_t cmf = 0x78;
+		const int level = ( mCompressionLevel < 0 ) ? 6 : mCompressionLevel;
+		uint8_t flg = (uint8_t)( ( level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3 ) << 6 );
+		flg += (uint8_t)( 31 - ( cmf * 256 + flg ) % 31 );
+		const uint8_t header[2] = { cmf, flg };
+		mTarget->writeData( header, sizeof(header) );
+	}
+}
+
+CompressingOStream::~CompressingOStream()
+{
+	try {
+		if( ! mFinished )
+			finish();
+	}
+	catch( ... ) {
+	}
+}
+
+void CompressingOStream::IOWrite( const void *t, size_t size )
+{
+	if( mFinished )
+		throw StreamExc( "CompressingOStream written after finish()" );
+
+	const uint8_t *data = reinterpret_cast<const uint8_t*>( t );
+	while( size > 0 ) {
+		size_t copySize = std::min( size, mBatchSize - mPending.size() );
+		mPending.insert( mPending.end(), data, data + copySize );
+		data += copySize;
+		size -= copySize;
+		mTotalIn += copySize;
+		// retain the last full batch until more data arrives, as the final block must be marked as such
+		if( mPending.size() == mBatchSize && size > 0 )
+			compressPending( false );
+	}
+}
+
+void CompressingOStream::compressPending( bool finalBlock )
+{
+	const size_t numBlocks = std::max<size_t>( ( mPending.size() + mBlockSize - 1 ) / mBlockSize, 1 );
+	std::vector<std::vector<uint8_t>> compressed( numBlocks );
+	std::vector<uint32_t> checks( numBlocks );
+
+	parallelFor( numBlocks, [&]( size_t begin, size_t end ) {
+		for( size_t b = begin; b < end; ++b ) {
+			const size_t offset = b * mBlockSize;
+			const size_t size = std::min( mBlockSize, mPending.size() - std::min( offset, mPending.size() ) );
+			const uint8_t *data = mPending.data() + offset;
+			// the preceding input primes the window; for the first block it is carried over from the previous batch
+			const uint8_t *dictionary = ( b == 0 ) ? mDictionary.data() : data - std::min( offset, DEFLATE_WINDOW_SIZE );
+			const size_t dictionarySize = ( b == 0 ) ? mDictionary.size() : std::min( offset, DEFLATE_WINDOW_SIZE );
+			deflateFragment( data, size, dictionary, dictionarySize, mCompressionLevel, finalBlock && b == numBlocks - 1, &compressed[b] );
+			checks[b] = mUseGZip ? (uint32_t)crc32( 0, data, (uInt)size ) : (uint32_t)adler32( 1, data, (uInt)size );
+		}
+	} );
+
+	for( size_t b = 0; b < numBlocks; ++b ) {
+		const size_t size = std::min( mBlockSize, mPending.size() - std::min( b * mBlockSize, mPending.size() ) );
+		mCheck = mUseGZip ? (uint32_t)crc32_combine( mCheck, checks[b], (z_off_t)size ) : (uint32_t)adler32_combine( mCheck, checks[b], (z_off_t)size );
+		mTarget->writeData( compressed[b].data(), compressed[b].size() );
+	}
+
+	// carry the end of this batch over as the next batch's dictionary
+	if( mPending.size() >= DEFLATE_WINDOW_SIZE )
+		mDictionary.assign( mPending.end() - DEFLATE_WINDOW_SIZE, mPending.end() );
+	else {
+		mDictionary.insert( mDictionary.end(), mPending.begin(), mPending.end() );
+		if( mDictionary.size() > DEFLATE_WINDOW_SIZE )
+			mDictionary.erase( mDictionary.begin(), mDictionary.end() - DEFLATE_WINDOW_SIZE );
+	}
+	mPending.clear();
+}
+
+void CompressingOStream::finish()
+{
+	if( mFinished )
+		return;
+
+	compressPending( true );
+	mFinished = true;
+
+	if( mUseGZip ) {
+		mTarget->writeLittle( mCheck );
+		mTarget->writeLittle( (uint32_t)mTotalIn );
+	}
+	else
+		mTarget->writeBig( mCheck );
+}
+
+void CompressingOStream::seekAbsolute( off_t /*absoluteOffset*/ )
+{
+	throw StreamExc( "CompressingOStream does not support seeking" );
+}
+
+void CompressingOStream::seekRelative( off_t /*relativeOffset*/ )
+{
+	throw StreamExc( "CompressingOStream does not support seeking" );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// DecompressingIStream
+namespace {
+
+const size_t INFLATE_CHUNK_SIZE = 65536;
+const size_t INFLATE_HISTORY_SIZE = 64; // bytes retained across fills for seekRelative( -n )
+
+} // anonymous namespace
+
+DecompressingIStream::DecompressingIStream( const IStreamRef &source )
+	: mSource( source ), mZStream( new z_stream ), mInput( INFLATE_CHUNK_SIZE ), mOutput( INFLATE_CHUNK_SIZE ), mOutputPos( 0 ), mOutputEnd( 0 ), mOutputOffset( 0 ), mStreamEnd( false )
+{
+	memset( mZStream.get(), 0, sizeof(z_stream) );
+	// 32 enables automatic zlib / gzip header detection
+	if( inflateInit2( mZStream.get(), 32 + MAX_WBITS ) != Z_OK )
+		throw StreamExc( "inflateInit2 failed" );
+
+	fill();
+}
+
+DecompressingIStream::~DecompressingIStream()
+{
+	inflateEnd( mZStream.get() );
+}
+
+void DecompressingIStream::fill()
+{
+	// keep a little history, then inflate until at least one new byte is available or the stream ends
+	const size_t history = std::min( mOutputPos, INFLATE_HISTORY_SIZE );
+	memmove( mOutput.data(), mOutput.data() + mOutputPos - history, mOutputEnd - mOutputPos + history );
+	mOutputOffset += mOutputPos - history;
+	mOutputEnd = mOutputEnd - mOutputPos + history;
+	mOutputPos = history;
+
+	while( ! mStreamEnd && mOutputEnd == mOutputPos ) {
+		if( mZStream->avail_in == 0 && ! mSource->isEof() ) {
+			mZStream->next_in = mInput.data();
+			mZStream->avail_in = (uInt)mSource->readDataAvailable( mInput.data(), mInput.size() );
+		}
+
+		mZStream->next_out = mOutput.data() + mOutputEnd;
+		mZStream->avail_out = (uInt)( mOutput.size() - mOutputEnd );
+		int err = inflate( mZStream.get(), Z_NO_FLUSH );
+		if( err == Z_STREAM_END )
+			mStreamEnd = true;
+		else if( err == Z_BUF_ERROR && mZStream->avail_in == 0 && mSource->isEof() )
+			throw StreamExc( "DecompressingIStream: truncated stream" );
+		else if( err != Z_OK && err != Z_BUF_ERROR )
+			throw StreamExc( "DecompressingIStream: corrupt stream" );
+		mOutputEnd = mOutput.size() - mZStream->avail_out;
+	}
+}
+
+size_t DecompressingIStream::readDataAvailable( void *dest, size_t maxSize )
+{
+	uint8_t *out = reinterpret_cast<uint8_t*>( dest );
+	size_t result = 0;
+	while( result < maxSize && ! isEof() ) {
+		const size_t copySize = std::min( maxSize - result, mOutputEnd - mOutputPos );
+		memcpy( out + result, mOutput.data() + mOutputPos, copySize );
+		mOutputPos += copySize;
+		result += copySize;
+		if( mOutputPos == mOutputEnd )
+			fill();
+	}
+
+	return result;
+}
+
+void DecompressingIStream::IORead( void *t, size_t size )
+{
+	if( readDataAvailable( t, size ) != size )
+		throw StreamExc();
+}
+
+void DecompressingIStream::seekAbsolute( off_t absoluteOffset )
+{
+	if( absoluteOffset < 0 || (uint64_t)absoluteOffset < mOutputOffset )
+		throw StreamExc( "DecompressingIStream: cannot seek backward beyond recently read data" );
+
+	while( (uint64_t)absoluteOffset > mOutputOffset + mOutputEnd ) {
+		if( isEof() )
+			throw StreamExc();
+		mOutputPos = mOutputEnd;
+		fill();
+	}
+	mOutputPos = static_cast<size_t>( absoluteOffset - mOutputOffset );
+	if( mOutputPos == mOutputEnd && ! mStreamEnd )
+		fill();
+}
+
+void DecompressingIStream::seekRelative( off_t relativeOffset )
+{
+	seekAbsolute( tell() + relativeOffset );
+}
+
 /////////////////////////////////////////////////////////////////////
 
 #define STREAM_PROTOTYPES(T)\
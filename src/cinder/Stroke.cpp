@@ -0,0 +1,513 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/GeomIo.h"
+#include "cinder/Thread.h"
+
+#include <cmath>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_STROKE_SSE
+	#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace cinder { namespace geom {
+
+namespace {
+
+//! Round joins and caps use at most this many segments per arc
+const int MAX_ARC_SEGMENTS = 64;
+
+struct StrokeSettings {
+	Stroke::Join	mJoin;
+	Stroke::Cap		mCap;
+	float			mMiterLimit, mTolerance;
+	ColorAf			mColor;
+	bool			mHasColors;
+};
+
+//! A solid line, or one dash of it, prepared for stroking. Closed pieces repeat their first point at the end.
+struct Piece {
+	vector<vec2>		mPoints;
+	vector<float>		mHalfWidths, mDistances;
+	//! Empty when the piece uses the uniform color
+	vector<ColorAf>		mColors;
+	bool				mClosed;
+
+	//! The left normal of each segment
+	vector<vec2>		mNormals;
+	//! The number of fan points of the join at the start of each segment, 0 for none. Only a closed piece has a join at its first segment.
+	vector<uint16_t>	mJoinPoints;
+	int					mStartCapPoints, mEndCapPoints;
+	size_t				mNumVertices, mNumIndices, mFirstVertex, mFirstIndex;
+
+	void	push( const vec2 &point, float halfWidth, float distance, const ColorAf *color )
+	{
+		mPoints.push_back( point );
+		mHalfWidths.push_back( halfWidth );
+		mDistances.push_back( distance );
+		if( color )
+			mColors.push_back( *color );
+	}
+};
+
+//! Returns the number of points on an arc spanning \a angle which keeps its chords within \a tolerance of the circle of \a radius
+int calcArcPoints( float angle, float radius, float tolerance )
+{
+	const float ratio = ( radius > 0 ) ? std::min( tolerance / radius, 1.0f ) : 1.0f;
+	const float step = 2 * acos( 1 - ratio );
+	return std::max( 1, std::min( (int)ceil( angle / step ), MAX_ARC_SEGMENTS ) ) + 1;
+}
+
+//! Drops repeated points and measures the distance along the line
+Piece makePiece( const vector<vec2> &points, const vector<float> &widths, const vector<ColorAf> &colors, bool closed, float width )
+{
+	Piece result;
+	for( size_t i = 0; i < points.size(); ++i ) {
+		if( ! result.mPoints.empty() && points[i] == result.mPoints.back() )
+			continue;
+		const float distance = result.mPoints.empty() ? 0 : result.mDistances.back() + glm::distance( result.mPoints.back(), points[i] );
+		result.push( points[i], 0.5f * ( widths.empty() ? width : widths[i] ), distance, colors.empty() ? nullptr : &colors[i] );
+	}
+	while( closed && result.mPoints.size() > 1 && result.mPoints.back() == result.mPoints.front() ) {
+		result.mPoints.pop_back();
+		result.mHalfWidths.pop_back();
+		result.mDistances.pop_back();
+		if( ! result.mColors.empty() )
+			result.mColors.pop_back();
+	}
+
+	result.mClosed = closed && result.mPoints.size() > 2;
+	if( result.mClosed )
+		result.push( result.mPoints.front(), result.mHalfWidths.front(), result.mDistances.back() + glm::distance( result.mPoints.back(), result.mPoints.front() ), result.mColors.empty() ? nullptr : &result.mColors.front() );
+
+	return result;
+}
+
+//! Returns the open piece of \a line between the distances \a start and \a end
+Piece extractDash( const Piece &line, float start, float end )
+{
+	const auto &distances = line.mDistances;
+	const size_t lastSegment = line.mPoints.size() - 2;
+	auto findSegment = [&]( float distance ) {
+		const size_t upper = upper_bound( distances.begin(), distances.end(), distance ) - distances.begin();
+		return std::min( ( upper > 0 ) ? upper - 1 : 0, lastSegment );
+	};
+	Piece result;
+	result.mClosed = false;
+	auto pushAt = [&]( float distance, size_t segment ) {
+		const float t = ( distance - distances[segment] ) / ( distances[segment + 1] - distances[segment] );
+		const vec2 point = mix( line.mPoints[segment], line.mPoints[segment + 1], t );
+		if( ! result.mPoints.empty() && point == result.mPoints.back() )
+			return;
+		const ColorAf color = line.mColors.empty() ? ColorAf() : lerp( line.mColors[segment], line.mColors[segment + 1], t );
+		result.push( point, mix( line.mHalfWidths[segment], line.mHalfWidths[segment + 1], t ), distance, line.mColors.empty() ? nullptr : &color );
+	};
+
+	const size_t startSegment = findSegment( start ), endSegment = findSegment( end );
+	pushAt( start, startSegment );
+	for( size_t s = startSegment + 1; s <= endSegment; ++s )
+		pushAt( distances[s], s );
+	pushAt( end, endSegment );
+
+	return result;
+}
+
+//! Appends the dashes of \a line to \a result. A closed line is dashed once around, starting at its first point.
+void splitDashes( const Piece &line, vector<float> pattern, float offset, vector<Piece> *result )
+{
+	// as in SVG, an odd number of entries is repeated to alternate dashes and gaps
+	if( pattern.size() % 2 )
+		pattern.insert( pattern.end(), pattern.begin(), pattern.end() );
+	float period = 0;
+	for( float length : pattern )
+		period += std::max( length, 0.0f );
+	if( period <= 0 ) {
+		result->push_back( line );
+		return;
+	}
+
+	float phase = fmod( offset, period );
+	if( phase < 0 )
+		phase += period;
+	size_t entry = 0;
+	while( phase >= std::max( pattern[entry], 0.0f ) ) {
+		phase -= std::max( pattern[entry], 0.0f );
+		entry = ( entry + 1 ) % pattern.size();
+	}
+
+	const float length = line.mDistances.back();
+	for( float position = -phase; position < length; entry = ( entry + 1 ) % pattern.size() ) {
+		const float start = std::max( position, 0.0f );
+		position += std::max( pattern[entry], 0.0f );
+		const float end = std::min( position, length );
+		if( entry % 2 == 0 && end > start ) {
+			result->push_back( extractDash( line, start, end ) );
+			if( result->back().mPoints.size() < 2 )
+				result->pop_back();
+		}
+	}
+}
+
+void calcSegmentNormals( const vec2 *points, size_t numSegments, vec2 *result )
+{
+	size_t s = 0;
+#if defined( CINDER_STROKE_SSE )
+	// two segments per register
+	const __m128 flipX = _mm_setr_ps( -1, 1, -1, 1 );
+	for( ; s + 2 <= numSegments; s += 2 ) {
+		const __m128 delta = _mm_sub_ps( _mm_loadu_ps( &points[s + 1].x ), _mm_loadu_ps( &points[s].x ) );
+		const __m128 squared = _mm_mul_ps( delta, delta );
+		const __m128 length = _mm_sqrt_ps( _mm_add_ps( squared, _mm_shuffle_ps( squared, squared, _MM_SHUFFLE( 2, 3, 0, 1 ) ) ) );
+		const __m128 normal = _mm_mul_ps( _mm_shuffle_ps( delta, delta, _MM_SHUFFLE( 2, 3, 0, 1 ) ), flipX );
+		_mm_storeu_ps( &result[s].x, _mm_div_ps( normal, length ) );
+	}
+#endif
+	for( ; s < numSegments; ++s ) {
+		const vec2 direction = normalize( points[s + 1] - points[s] );
+		result[s] = vec2( -direction.y, direction.x );
+	}
+}
+
+//! Returns the number of fan points of the join between segments with normals \a n0 and \a n1, 0 when the turn leaves no visible gap
+int calcJoinPoints( const vec2 &n0, const vec2 &n1, float halfWidth, const StrokeSettings &settings )
+{
+	const float turn = n0.x * n1.y - n0.y * n1.x, cosAngle = dot( n0, n1 );
+	if( cosAngle > 0 && fabs( turn ) * halfWidth < settings.mTolerance * 0.01f )
+		return 0;
+	switch( settings.mJoin ) {
+		case Stroke::JOIN_MITER: {
+			// the miter is 1 / cos( angle / 2 ) times as long as the line is wide
+			const float cosHalfAngle = sqrt( std::max( 0.0f, ( 1 + cosAngle ) * 0.5f ) );
+			return ( cosHalfAngle * settings.mMiterLimit >= 1 ) ? 3 : 2;
+		}
+		case Stroke::JOIN_ROUND:
+			return calcArcPoints( acos( glm::clamp( cosAngle, -1.0f, 1.0f ) ), halfWidth, settings.mTolerance );
+		default:
+			return 2;
+	}
+}
+
+void prepare( Piece *piece, const StrokeSettings &settings )
+{
+	const size_t numSegments = piece->mPoints.size() - 1;
+	piece->mNormals.resize( numSegments );
+	calcSegmentNormals( piece->mPoints.data(), numSegments, piece->mNormals.data() );
+
+	piece->mNumVertices = numSegments * 4;
+	piece->mNumIndices = numSegments * 6;
+	piece->mJoinPoints.assign( numSegments, 0 );
+	for( size_t s = piece->mClosed ? 0 : 1; s < numSegments; ++s ) {
+		const int joinPoints = calcJoinPoints( piece->mNormals[( s + numSegments - 1 ) % numSegments], piece->mNormals[s], piece->mHalfWidths[s], settings );
+		piece->mJoinPoints[s] = (uint16_t)joinPoints;
+		if( joinPoints ) {
+			piece->mNumVertices += joinPoints + 1;
+			piece->mNumIndices += ( joinPoints - 1 ) * 3;
+		}
+	}
+
+	piece->mStartCapPoints = piece->mEndCapPoints = 0;
+	if( ! piece->mClosed && settings.mCap == Stroke::CAP_ROUND ) {
+		piece->mStartCapPoints = calcArcPoints( (float)M_PI, piece->mHalfWidths.front(), settings.mTolerance );
+		piece->mEndCapPoints = calcArcPoints( (float)M_PI, piece->mHalfWidths.back(), settings.mTolerance );
+		piece->mNumVertices += piece->mStartCapPoints + piece->mEndCapPoints + 2;
+		piece->mNumIndices += ( piece->mStartCapPoints + piece->mEndCapPoints - 2 ) * 3;
+	}
+}
+
+//! Writes the triangle fan around \a center through the points on an arc from \a radius rotated by \a angle, or through \a fanPoints when it isn't null
+void emitFan( const vec2 &center, const vec2 *fanPoints, const vec2 &radius, float angle, int numPoints, float distance, float side0, float side1, const ColorAf &color,
+		uint32_t vertex, vec2 *positions, vec2 *texCoords, ColorAf *colors, uint32_t *indices )
+{
+	positions[vertex] = center;
+	texCoords[vertex] = vec2( distance, 0.5f );
+	const float step = angle / ( numPoints - 1 );
+	for( int p = 0; p < numPoints; ++p ) {
+		if( fanPoints )
+			positions[vertex + 1 + p] = fanPoints[p];
+		else {
+			const float c = cos( step * p ), s = sin( step * p );
+			positions[vertex + 1 + p] = center + vec2( radius.x * c - radius.y * s, radius.x * s + radius.y * c );
+		}
+		texCoords[vertex + 1 + p] = vec2( distance, mix( side0, side1, p / (float)( numPoints - 1 ) ) );
+	}
+	if( colors )
+		std::fill( colors + vertex, colors + vertex + numPoints + 1, color );
+	for( int p = 0; p + 1 < numPoints; ++p ) {
+		*indices++ = vertex;
+		*indices++ = vertex + 1 + p;
+		*indices++ = vertex + 2 + p;
+	}
+}
+
+void generate( const Piece &piece, const StrokeSettings &settings, vec2 *positions, vec2 *texCoords, ColorAf *colors, uint32_t *indices )
+{
+	const size_t numSegments = piece.mNormals.size();
+	const vec2 *points = piece.mPoints.data();
+	const float *halfWidths = piece.mHalfWidths.data(), *distances = piece.mDistances.data();
+	uint32_t vertex = (uint32_t)piece.mFirstVertex;
+	indices += piece.mFirstIndex;
+
+	// each segment is a quad: its left edge, then its right edge
+	for( size_t s = 0; s < numSegments; ++s, vertex += 4 ) {
+#if defined( CINDER_STROKE_SSE )
+		const __m128 point = _mm_loadu_ps( &points[s].x );
+		const __m128 normal = _mm_castpd_ps( _mm_load1_pd( (const double*)&piece.mNormals[s] ) );
+		const __m128 halfWidth = _mm_castpd_ps( _mm_load_sd( (const double*)&halfWidths[s] ) );
+		const __m128 offset = _mm_mul_ps( normal, _mm_unpacklo_ps( halfWidth, halfWidth ) );
+		_mm_storeu_ps( &positions[vertex].x, _mm_add_ps( point, offset ) );
+		_mm_storeu_ps( &positions[vertex + 2].x, _mm_sub_ps( point, offset ) );
+		const __m128 distance = _mm_unpacklo_ps( _mm_castpd_ps( _mm_load_sd( (const double*)&distances[s] ) ), _mm_setzero_ps() );
+		_mm_storeu_ps( &texCoords[vertex].x, distance );
+		_mm_storeu_ps( &texCoords[vertex + 2].x, _mm_add_ps( distance, _mm_setr_ps( 0, 1, 0, 1 ) ) );
+#else
+		const vec2 &normal = piece.mNormals[s];
+		positions[vertex] = points[s] + normal * halfWidths[s];
+		positions[vertex + 1] = points[s + 1] + normal * halfWidths[s + 1];
+		positions[vertex + 2] = points[s] - normal * halfWidths[s];
+		positions[vertex + 3] = points[s + 1] - normal * halfWidths[s + 1];
+		texCoords[vertex] = vec2( distances[s], 0 );
+		texCoords[vertex + 1] = vec2( distances[s + 1], 0 );
+		texCoords[vertex + 2] = vec2( distances[s], 1 );
+		texCoords[vertex + 3] = vec2( distances[s + 1], 1 );
+#endif
+		if( colors ) {
+			const ColorAf &c0 = piece.mColors.empty() ? settings.mColor : piece.mColors[s];
+			const ColorAf &c1 = piece.mColors.empty() ? settings.mColor : piece.mColors[s + 1];
+			colors[vertex] = colors[vertex + 2] = c0;
+			colors[vertex + 1] = colors[vertex + 3] = c1;
+		}
+		const uint32_t quad[6] = { vertex, vertex + 2, vertex + 3, vertex, vertex + 3, vertex + 1 };
+		std::copy( quad, quad + 6, indices );
+		indices += 6;
+	}
+
+	if( ! piece.mClosed && settings.mCap == Stroke::CAP_SQUARE ) {
+		const uint32_t first = (uint32_t)piece.mFirstVertex, last = vertex - 4;
+		const vec2 startExtension = vec2( piece.mNormals.front().y, -piece.mNormals.front().x ) * halfWidths[0];
+		const vec2 endExtension = vec2( piece.mNormals.back().y, -piece.mNormals.back().x ) * halfWidths[numSegments];
+		positions[first] -= startExtension;
+		positions[first + 2] -= startExtension;
+		positions[last + 1] += endExtension;
+		positions[last + 3] += endExtension;
+	}
+
+	for( size_t s = 0; s < numSegments; ++s ) {
+		const int numPoints = piece.mJoinPoints[s];
+		if( ! numPoints )
+			continue;
+		// the fan covers the gap on the outer side of the turn, from the end of the previous segment to the start of this one
+		const vec2 &n0 = piece.mNormals[( s + numSegments - 1 ) % numSegments], &n1 = piece.mNormals[s];
+		const float turn = n0.x * n1.y - n0.y * n1.x;
+		const float side = ( turn > 0 ) ? -1.0f : 1.0f;
+		const vec2 &center = points[s];
+		const float halfWidth = halfWidths[s];
+		const ColorAf &color = piece.mColors.empty() ? settings.mColor : piece.mColors[s];
+		const float side0 = ( side > 0 ) ? 0.0f : 1.0f;
+		if( settings.mJoin == Stroke::JOIN_ROUND ) {
+			const float angle = acos( glm::clamp( dot( n0, n1 ), -1.0f, 1.0f ) ) * ( ( turn > 0 ) ? 1.0f : -1.0f );
+			emitFan( center, nullptr, n0 * ( side * halfWidth ), angle, numPoints, distances[s], side0, side0, color, vertex, positions, texCoords, colors, indices );
+		}
+		else {
+			vec2 fanPoints[3];
+			fanPoints[0] = center + n0 * ( side * halfWidth );
+			fanPoints[numPoints - 1] = center + n1 * ( side * halfWidth );
+			if( numPoints == 3 ) {
+				const vec2 miter = normalize( n0 + n1 );
+				fanPoints[1] = center + miter * ( side * halfWidth / dot( miter, n0 ) );
+			}
+			emitFan( center, fanPoints, vec2( 0 ), 0, numPoints, distances[s], side0, side0, color, vertex, positions, texCoords, colors, indices );
+		}
+		vertex += numPoints + 1;
+		indices += ( numPoints - 1 ) * 3;
+	}
+
+	if( piece.mStartCapPoints ) {
+		const ColorAf &startColor = piece.mColors.empty() ? settings.mColor : piece.mColors.front();
+		emitFan( points[0], nullptr, piece.mNormals.front() * halfWidths[0], (float)M_PI, piece.mStartCapPoints, distances[0], 0, 1, startColor, vertex, positions, texCoords, colors, indices );
+		vertex += piece.mStartCapPoints + 1;
+		indices += ( piece.mStartCapPoints - 1 ) * 3;
+		const ColorAf &endColor = piece.mColors.empty() ? settings.mColor : piece.mColors.back();
+		emitFan( points[numSegments], nullptr, -piece.mNormals.back() * halfWidths[numSegments], (float)M_PI, piece.mEndCapPoints, distances[numSegments], 1, 0, endColor, vertex, positions, texCoords, colors, indices );
+	}
+}
+
+} // anonymous namespace
+
+Stroke::Stroke()
+	: mWidth( 1 ), mMiterLimit( 4 ), mDashOffset( 0 ), mApproximationScale( 1 ), mJoin( JOIN_MITER ), mCap( CAP_BUTT ), mColor( 1, 1, 1, 1 ), mHasColors( false ), mDirty( true )
+{
+}
+
+Stroke::Stroke( const PolyLine2f &polyLine, float width )
+	: Stroke()
+{
+	mWidth = width;
+	append( polyLine );
+}
+
+Stroke::Stroke( const Path2d &path, float width, float approximationScale )
+	: Stroke()
+{
+	mWidth = width;
+	mApproximationScale = approximationScale;
+	append( path );
+}
+
+Stroke::Stroke( const Shape2d &shape, float width, float approximationScale )
+	: Stroke()
+{
+	mWidth = width;
+	mApproximationScale = approximationScale;
+	append( shape );
+}
+
+Stroke& Stroke::append( const PolyLine2f &polyLine, const std::vector<float> &widths, const std::vector<ColorAf> &colors )
+{
+	if( ( ! widths.empty() && widths.size() != polyLine.size() ) || ( ! colors.empty() && colors.size() != polyLine.size() ) )
+		throw Exc();
+
+	mLines.push_back( Line{ polyLine.getPoints(), widths, colors, polyLine.isClosed() } );
+	mHasColors = mHasColors || ! colors.empty();
+	mDirty = true;
+	return *this;
+}
+
+Stroke& Stroke::append( const Path2d &path )
+{
+	Line line;
+	path.flatten( &line.mPoints, mApproximationScale );
+	line.mClosed = path.isClosed();
+	mLines.push_back( std::move( line ) );
+	mDirty = true;
+	return *this;
+}
+
+Stroke& Stroke::append( const Shape2d &shape )
+{
+	for( const auto &contour : shape.getContours() )
+		append( contour );
+	return *this;
+}
+
+Stroke& Stroke::clear()
+{
+	mLines.clear();
+	mDirty = true;
+	return *this;
+}
+
+void Stroke::update() const
+{
+	if( ! mDirty )
+		return;
+
+	const StrokeSettings settings = { mJoin, mCap, mMiterLimit, 0.5f / mApproximationScale, mColor, mHasColors };
+	const size_t grainSize = 16;
+
+	vector<vector<Piece>> linePieces( mLines.size() );
+	parallelFor( mLines.size(), [&]( size_t begin, size_t end ) {
+		for( size_t l = begin; l < end; ++l ) {
+			const Line &line = mLines[l];
+			Piece solid = makePiece( line.mPoints, line.mWidths, line.mColors, line.mClosed, mWidth );
+			if( solid.mPoints.size() < 2 )
+				continue;
+			if( mDashPattern.empty() )
+				linePieces[l].push_back( std::move( solid ) );
+			else
+				splitDashes( solid, mDashPattern, mDashOffset, &linePieces[l] );
+			for( auto &piece : linePieces[l] )
+				prepare( &piece, settings );
+		}
+	}, grainSize );
+
+	vector<Piece*> pieces;
+	size_t numVertices = 0, numIndices = 0;
+	for( auto &line : linePieces ) {
+		for( auto &piece : line ) {
+			piece.mFirstVertex = numVertices;
+			piece.mFirstIndex = numIndices;
+			numVertices += piece.mNumVertices;
+			numIndices += piece.mNumIndices;
+			pieces.push_back( &piece );
+		}
+	}
+
+	mPositions.resize( numVertices );
+	mTexCoords.resize( numVertices );
+	mColors.resize( mHasColors ? numVertices : 0 );
+	mIndices.resize( numIndices );
+	parallelFor( pieces.size(), [&]( size_t begin, size_t end ) {
+		for( size_t p = begin; p < end; ++p )
+			generate( *pieces[p], settings, mPositions.data(), mTexCoords.data(), mHasColors ? mColors.data() : nullptr, mIndices.data() );
+	}, grainSize );
+
+	mDirty = false;
+}
+
+size_t Stroke::getNumVertices() const
+{
+	update();
+	return mPositions.size();
+}
+
+size_t Stroke::getNumIndices() const
+{
+	update();
+	return mIndices.size();
+}
+
+uint8_t Stroke::getAttribDims( Attrib attr ) const
+{
+	switch( attr ) {
+		case Attrib::POSITION: return 2;
+		case Attrib::TEX_COORD_0: return 2;
+		case Attrib::COLOR: return mHasColors ? 4 : 0;
+		default:
+			return 0;
+	}
+}
+
+AttribSet Stroke::getAvailableAttribs() const
+{
+	if( mHasColors )
+		return { Attrib::POSITION, Attrib::TEX_COORD_0, Attrib::COLOR };
+	else
+		return { Attrib::POSITION, Attrib::TEX_COORD_0 };
+}
+
+void Stroke::loadInto( Target *target, const AttribSet &requestedAttribs ) const
+{
+	update();
+
+	target->copyAttrib( Attrib::POSITION, 2, 0, (const float*)mPositions.data(), mPositions.size() );
+	if( requestedAttribs.count( Attrib::TEX_COORD_0 ) )
+		target->copyAttrib( Attrib::TEX_COORD_0, 2, 0, (const float*)mTexCoords.data(), mTexCoords.size() );
+	if( mHasColors && requestedAttribs.count( Attrib::COLOR ) )
+		target->copyAttrib( Attrib::COLOR, 4, 0, (const float*)mColors.data(), mColors.size() );
+	target->copyIndices( Primitive::TRIANGLES, mIndices.data(), mIndices.size(), ( mPositions.size() <= 65536 ) ? 2 : 4 );
+}
+
+} } // namespace cinder::geom
@@ -0,0 +1,180 @@
+/*
+ Copyright (c) 2010, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/Thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <vector>
+
+namespace cinder {
+
+namespace {
+
+// A single parallelFor() invocation. Ranges are claimed through an atomic counter, so a thread only ever
+// waits on ranges that are actively executing elsewhere, which keeps nested invocations deadlock-free.
+struct ParallelForJob {
+	ParallelForJob( const std::function<void( size_t, size_t )> &fn, size_t count, size_t rangeSize )
+		: mFn( fn ), mCount( count ), mRangeSize( rangeSize ), mNumRanges( ( count + rangeSize - 1 ) / rangeSize ),
+			mNextRange( 0 ), mCompletedRanges( 0 )
+	{}
+
+	// Executes ranges until none remain unclaimed
+	void run()
+	{
+		size_t range;
+		while( ( range = mNextRange.fetch_add( 1 ) ) < mNumRanges ) {
+			size_t begin = range * mRangeSize;
+			size_t end = std::min( begin + mRangeSize, mCount );
+			try {
+				mFn( begin, end );
+			}
+			catch( ... ) {
+				std::lock_guard<std::mutex> lock( mMutex );
+				if( ! mException )
+					mException = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock( mMutex );
+			if( ++mCompletedRanges == mNumRanges )
+				mCompletedCond.notify_all();
+		}
+	}
+
+	void waitUntilComplete()
+	{
+		std::unique_lock<std::mutex> lock( mMutex );
+		mCompletedCond.wait( lock, [this] { return mCompletedRanges == mNumRanges; } );
+		if( mException )
+			std::rethrow_exception( mException );
+	}
+
+	const std::function<void( size_t, size_t )>	&mFn;
+	const size_t			mCount, mRangeSize, mNumRanges;
+	std::atomic<size_t>		mNextRange;
+	size_t					mCompletedRanges; // guarded by mMutex
+	std::exception_ptr		mException; // guarded by mMutex
+	std::mutex				mMutex;
+	std::condition_variable	mCompletedCond;
+};
+
+class WorkerPool {
+  public:
+	static WorkerPool* instance()
+	{
+		static WorkerPool sInstance;
+		return &sInstance;
+	}
+
+	size_t getNumThreads() const	{ return mThreads.size() + 1; }
+
+	// Enqueues \a job for up to \a numHelpers workers; stale entries simply find no ranges left to claim
+	void submit( const std::shared_ptr<ParallelForJob> &job, size_t numHelpers )
+	{
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			for( size_t i = 0; i < numHelpers; ++i )
+				mJobs.push_back( job );
+		}
+		if( numHelpers == 1 )
+			mJobsCond.notify_one();
+		else
+			mJobsCond.notify_all();
+	}
+
+  private:
+	WorkerPool()
+		: mShouldQuit( false )
+	{
+		size_t numThreads = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+		for( size_t i = 0; i < numThreads - 1; ++i )
+			mThreads.emplace_back( &WorkerPool::workerMain, this );
+	}
+
+	~WorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			mShouldQuit = true;
+		}
+		mJobsCond.notify_all();
+		for( auto &thread : mThreads )
+			thread.join();
+	}
+
+	void workerMain()
+	{
+		ThreadSetup threadSetup;
+		while( true ) {
+			std::shared_ptr<ParallelForJob> job;
+			{
+				std::unique_lock<std::mutex> lock( mMutex );
+				mJobsCond.wait( lock, [this] { return mShouldQuit || ! mJobs.empty(); } );
+				if( mShouldQuit )
+					return;
+				job = std::move( mJobs.front() );
+				mJobs.pop_front();
+			}
+			job->run();
+		}
+	}
+
+	std::vector<std::thread>						mThreads;
+	std::deque<std::shared_ptr<ParallelForJob>>		mJobs;
+	std::mutex										mMutex;
+	std::condition_variable							mJobsCond;
+	bool											mShouldQuit;
+};
+
+} // anonymous namespace
+
+size_t getNumParallelThreads()
+{
+	return WorkerPool::instance()->getNumThreads();
+}
+
+void parallelFor( size_t count, const std::function<void( size_t begin, size_t end )> &fn, size_t grainSize )
+{
+	if( count == 0 )
+		return;
+
+	auto pool = WorkerPool::instance();
+	grainSize = std::max<size_t>( grainSize, 1 );
+	const size_t numThreads = pool->getNumThreads();
+	if( numThreads == 1 || count <= grainSize ) {
+		fn( 0, count );
+		return;
+	}
+
+	// oversubscribe ranges 4:1 relative to threads so uneven ranges still balance
+	size_t numRanges = std::min( ( count + grainSize - 1 ) / grainSize, numThreads * 4 );
+	size_t rangeSize = ( count + numRanges - 1 ) / numRanges;
+	auto job = std::make_shared<ParallelForJob>( fn, count, rangeSize );
+
+	pool->submit( job, std::min( job->mNumRanges, numThreads ) - 1 );
+	job->run();
+	job->waitUntilComplete();
+}
+
+} // namespace cinder
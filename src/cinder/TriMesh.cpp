@@ -26,6 +26,10 @@
 #include "cinder/TriMesh.h"
 #include "cinder/Exception.h"
 #include "cinder/Log.h"
+#include "cinder/MemoryMappedFile.h"
+#include "cinder/Thread.h"
+#include <algorithm>
+#include <cstring>
 #if defined( CINDER_ANDROID )
 	#include "cinder/android/CinderAndroid.h"
 #endif 
@@ -34,6 +38,156 @@ using namespace std;
 
 namespace cinder {
 
+namespace {
+
+// Version 3 binary layout: a 48 byte header, a table of ATTRIB_RECORD_SIZE records, then the index and attribute
+// streams, each aligned to STREAM_ALIGNMENT. Header fields are little-endian; stream data is stored in native order.
+const uint8_t	BINARY_VERSION = 3;
+const size_t	HEADER_SIZE = 48;
+const size_t	ATTRIB_RECORD_SIZE = 32;
+const size_t	STREAM_ALIGNMENT = 16;
+const size_t	DECODE_GRAIN = 16 * 1024;
+
+enum Encoding { ENCODING_FLOAT32, ENCODING_FLOAT16, ENCODING_OCT16, ENCODING_UINT16, ENCODING_UINT32 };
+
+template<typename T>
+T readLittle( const uint8_t *p )
+{
+	T result = 0;
+	for( size_t b = 0; b < sizeof(T); ++b )
+		result |= (T)p[b] << ( 8 * b );
+	return result;
+}
+
+template<typename T>
+void writeLittle( uint8_t *p, T value )
+{
+	for( size_t b = 0; b < sizeof(T); ++b )
+		p[b] = (uint8_t)( value >> ( 8 * b ) );
+}
+
+size_t alignUp( size_t value, size_t alignment )
+{
+	return ( value + alignment - 1 ) / alignment * alignment;
+}
+
+size_t encodedComponentBytes( uint8_t encoding )
+{
+	switch( encoding ) {
+		case ENCODING_FLOAT32: case ENCODING_UINT32: return 4;
+		default: return 2;
+	}
+}
+
+size_t encodedElementBytes( uint8_t encoding, uint8_t dims )
+{
+	return ( ( encoding == ENCODING_OCT16 ) ? 2 : dims ) * encodedComponentBytes( encoding );
+}
+
+// The checksum hashes the file in fixed CHECKSUM_BLOCK_SIZE blocks with an xxHash64-style function, so blocks can be
+// verified in parallel and alongside decoding; the block hashes are then folded together in file order.
+const size_t	CHECKSUM_BLOCK_SIZE = 64 * 1024;
+const uint64_t	PRIME64_1 = 0x9E3779B185EBCA87ULL, PRIME64_2 = 0xC2B2AE3D27D4EB4FULL, PRIME64_3 = 0x165667B19E3779F9ULL;
+const uint64_t	PRIME64_4 = 0x85EBCA77C2B2AE63ULL, PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl64( uint64_t x, int r )
+{
+	return ( x << r ) | ( x >> ( 64 - r ) );
+}
+
+inline uint64_t load64( const uint8_t *p )
+{
+	uint64_t result;
+	memcpy( &result, p, sizeof( result ) );
+	return result;
+}
+
+inline uint64_t checksumRound( uint64_t acc, uint64_t input )
+{
+	return rotl64( acc + input * PRIME64_2, 31 ) * PRIME64_1;
+}
+
+uint64_t checksumBlock( const uint8_t *p, size_t size )
+{
+	uint64_t lanes[4] = { PRIME64_1 + PRIME64_2, PRIME64_2, 0, 0 - PRIME64_1 };
+	size_t i = 0;
+	for( ; i + 32 <= size; i += 32 ) {
+		lanes[0] = checksumRound( lanes[0], load64( p + i ) );
+		lanes[1] = checksumRound( lanes[1], load64( p + i + 8 ) );
+		lanes[2] = checksumRound( lanes[2], load64( p + i + 16 ) );
+		lanes[3] = checksumRound( lanes[3], load64( p + i + 24 ) );
+	}
+
+	uint64_t h = rotl64( lanes[0], 1 ) + rotl64( lanes[1], 7 ) + rotl64( lanes[2], 12 ) + rotl64( lanes[3], 18 ) + size;
+	for( ; i + 8 <= size; i += 8 )
+		h = rotl64( h ^ checksumRound( 0, load64( p + i ) ), 27 ) * PRIME64_1 + PRIME64_4;
+	for( ; i < size; ++i )
+		h = rotl64( h ^ ( p[i] * PRIME64_5 ), 11 ) * PRIME64_1;
+
+	h ^= h >> 33; h *= PRIME64_2;
+	h ^= h >> 29; h *= PRIME64_3;
+	return h ^ ( h >> 32 );
+}
+
+uint64_t combineBlockChecksums( const std::vector<uint64_t> &blockChecksums )
+{
+	uint64_t result = PRIME64_5;
+	for( uint64_t blockChecksum : blockChecksums )
+		result = checksumRound( result, blockChecksum );
+	return result;
+}
+
+size_t numChecksumBlocks( size_t size )
+{
+	return ( size + CHECKSUM_BLOCK_SIZE - 1 ) / CHECKSUM_BLOCK_SIZE;
+}
+
+uint64_t calcChecksum( const uint8_t *data, size_t size )
+{
+	std::vector<uint64_t> blockChecksums( numChecksumBlocks( size ) );
+	parallelFor( blockChecksums.size(), [&]( size_t begin, size_t end ) {
+		for( size_t b = begin; b < end; ++b )
+			blockChecksums[b] = checksumBlock( data + b * CHECKSUM_BLOCK_SIZE, std::min( CHECKSUM_BLOCK_SIZE, size - b * CHECKSUM_BLOCK_SIZE ) );
+	} );
+	return combineBlockChecksums( blockChecksums );
+}
+
+// Octahedral mapping of a unit vector onto [-1,1]^2, stored as a pair of snorm16s
+void encodeOctahedral( const float *n, int16_t *dest )
+{
+	const float sum = std::abs( n[0] ) + std::abs( n[1] ) + std::abs( n[2] );
+	float x = ( sum > 0 ) ? n[0] / sum : 0, y = ( sum > 0 ) ? n[1] / sum : 0;
+	if( n[2] < 0 ) {
+		const float foldedX = ( 1 - std::abs( y ) ) * ( x >= 0 ? 1 : -1 );
+		y = ( 1 - std::abs( x ) ) * ( y >= 0 ? 1 : -1 );
+		x = foldedX;
+	}
+	dest[0] = (int16_t)std::lround( glm::clamp( x, -1.0f, 1.0f ) * 32767 );
+	dest[1] = (int16_t)std::lround( glm::clamp( y, -1.0f, 1.0f ) * 32767 );
+}
+
+void decodeOctahedral( const int16_t *src, float *dest )
+{
+	vec3 n( src[0] / 32767.0f, src[1] / 32767.0f, 0 );
+	n.z = 1 - std::abs( n.x ) - std::abs( n.y );
+	const float t = std::max( -n.z, 0.0f );
+	n.x += ( n.x >= 0 ) ? -t : t;
+	n.y += ( n.y >= 0 ) ? -t : t;
+	n = normalize( n );
+	dest[0] = n.x; dest[1] = n.y; dest[2] = n.z;
+}
+
+// returns whether all \a count of \a indices refer to one of \a numVertices vertices
+bool indicesInRange( const uint32_t *indices, size_t count, size_t numVertices )
+{
+	uint32_t maxIndex = 0;
+	for( size_t i = 0; i < count; ++i )
+		maxIndex = std::max( maxIndex, indices[i] );
+	return count == 0 || maxIndex < numVertices;
+}
+
+} // anonymous namespace
+
 /////////////////////////////////////////////////////////////////////////////////////////////////
 // TriMeshGeomTarget
 class TriMeshGeomTarget : public geom::Target {
@@ -212,7 +366,7 @@ void TriMesh::loadInto( geom::Target *target, const geom::AttribSet &requestedAt
 	
 	// copy indices
 	if( getNumIndices() )
-		target->copyIndices( geom::Primitive::TRIANGLES, mIndices.data(), getNumIndices(), 4 /* bytes per index */ );
+		target->copyIndices( geom::Primitive::TRIANGLES, mIndices.data(), getNumIndices(), ( getNumVertices() <= 65536 ) ? 2 : 4 );
 }
 
 void TriMesh::clear()
@@ -504,8 +658,15 @@ void TriMesh::read( const DataSourceRef &dataSource )
 		clear();
 		readImplV2( in );
 	}
+	else if( versionNumber == BINARY_VERSION ) {
+		in.reset();
+		// the checksum is verified while the streams are copied, rather than in a separate pass
+		TriMeshBinary binary( dataSource, false );
+		clear();
+		readImplV3( binary );
+	}
 	else {
-		throw Exception( "TriMesh::read() error: wrong version number. expected version = 1 or 2, version read: " + std::to_string( versionNumber ) );
+		throw Exception( "TriMesh::read() error: wrong version number. expected version = 1, 2 or 3, version read: " + std::to_string( versionNumber ) );
 	}
 }
 
@@ -560,6 +721,221 @@ void TriMesh::write( const DataTargetRef &dataTarget, uint32_t writeMask ) const
 	writeAttrib( toMask( geom::BONE_WEIGHT ), mBoneWeightsDims, mBoneWeights.size() * 4, mBoneWeights.data() );
 }
 
+void TriMesh::write( const DataTargetRef &dataTarget, const BinaryOptions &options ) const
+{
+	struct StreamOut {
+		uint32_t				mAttrib;
+		uint8_t					mDims, mEncoding;
+		size_t					mCount;
+		const void				*mData;
+		size_t					mSize, mOffset;
+		std::vector<uint8_t>	mEncoded;
+	};
+
+	const size_t numVertices = getNumVertices();
+	std::vector<StreamOut> streams;
+	streams.reserve( 12 );
+
+	// indices are narrowed whenever every vertex is addressable in 16 bits
+	StreamOut indices;
+	indices.mAttrib = 0;
+	indices.mDims = 1;
+	indices.mCount = mIndices.size();
+	indices.mEncoding = ( numVertices <= 65536 ) ? ENCODING_UINT16 : ENCODING_UINT32;
+	if( indices.mEncoding == ENCODING_UINT16 ) {
+		indices.mEncoded.resize( mIndices.size() * 2 );
+		uint16_t *dest = reinterpret_cast<uint16_t*>( indices.mEncoded.data() );
+		for( size_t i = 0; i < mIndices.size(); ++i )
+			dest[i] = (uint16_t)mIndices[i];
+		indices.mData = indices.mEncoded.data();
+	}
+	else
+		indices.mData = mIndices.data();
+	indices.mSize = mIndices.size() * encodedComponentBytes( indices.mEncoding );
+	streams.push_back( std::move( indices ) );
+
+	auto addStream = [&]( geom::Attrib attrib, uint8_t dims, size_t numFloats, const float *data, uint8_t encoding ) {
+		if( numFloats == 0 || dims == 0 || ! ( options.mAttribMask & toMask( attrib ) ) )
+			return;
+		if( encoding == ENCODING_OCT16 && dims != 3 )
+			encoding = ENCODING_FLOAT32;
+
+		StreamOut stream;
+		stream.mAttrib = toMask( attrib );
+		stream.mDims = dims;
+		stream.mEncoding = encoding;
+		stream.mCount = numFloats / dims;
+		if( encoding == ENCODING_FLOAT32 ) {
+			stream.mData = data;
+			stream.mSize = stream.mCount * dims * sizeof( float );
+		}
+		else {
+			const size_t componentsOut = ( encoding == ENCODING_OCT16 ) ? 2 : dims;
+			stream.mEncoded.resize( stream.mCount * componentsOut * 2 );
+			int16_t *octDest = reinterpret_cast<int16_t*>( stream.mEncoded.data() );
+			half_float *halfDest = reinterpret_cast<half_float*>( stream.mEncoded.data() );
+			parallelFor( stream.mCount, [&]( size_t begin, size_t end ) {
+				for( size_t v = begin; v < end; ++v ) {
+					if( encoding == ENCODING_OCT16 )
+						encodeOctahedral( data + v * 3, octDest + v * 2 );
+					else
+						for( uint8_t c = 0; c < dims; ++c )
+							halfDest[v * dims + c] = floatToHalf( data[v * dims + c] );
+				}
+			}, DECODE_GRAIN );
+			stream.mData = stream.mEncoded.data();
+			stream.mSize = stream.mEncoded.size();
+		}
+		streams.push_back( std::move( stream ) );
+	};
+
+	const uint8_t normalEncoding = options.mQuantizeNormals ? ENCODING_OCT16 : ENCODING_FLOAT32;
+	addStream( geom::POSITION, mPositionsDims, mPositions.size(), mPositions.data(), options.mQuantizePositions ? ENCODING_FLOAT16 : ENCODING_FLOAT32 );
+	addStream( geom::COLOR, mColorsDims, mColors.size(), mColors.data(), ENCODING_FLOAT32 );
+	addStream( geom::NORMAL, 3, mNormals.size() * 3, reinterpret_cast<const float*>( mNormals.data() ), normalEncoding );
+	addStream( geom::TEX_COORD_0, mTexCoords0Dims, mTexCoords0.size(), mTexCoords0.data(), ENCODING_FLOAT32 );
+	addStream( geom::TEX_COORD_1, mTexCoords1Dims, mTexCoords1.size(), mTexCoords1.data(), ENCODING_FLOAT32 );
+	addStream( geom::TEX_COORD_2, mTexCoords2Dims, mTexCoords2.size(), mTexCoords2.data(), ENCODING_FLOAT32 );
+	addStream( geom::TEX_COORD_3, mTexCoords3Dims, mTexCoords3.size(), mTexCoords3.data(), ENCODING_FLOAT32 );
+	addStream( geom::TANGENT, 3, mTangents.size() * 3, reinterpret_cast<const float*>( mTangents.data() ), normalEncoding );
+	addStream( geom::BITANGENT, 3, mBitangents.size() * 3, reinterpret_cast<const float*>( mBitangents.data() ), normalEncoding );
+	addStream( geom::BONE_INDEX, 4, mBoneIndices.size() * 4, reinterpret_cast<const float*>( mBoneIndices.data() ), ENCODING_FLOAT32 );
+	addStream( geom::BONE_WEIGHT, 4, mBoneWeights.size() * 4, reinterpret_cast<const float*>( mBoneWeights.data() ), ENCODING_FLOAT32 );
+
+	// lay out the file: header, attribute table (the index stream is the first record), then the aligned streams
+	std::vector<uint8_t> table( streams.size() * ATTRIB_RECORD_SIZE, 0 );
+	size_t offset = HEADER_SIZE + table.size();
+	for( size_t s = 0; s < streams.size(); ++s ) {
+		auto &stream = streams[s];
+		offset = alignUp( offset, STREAM_ALIGNMENT );
+		stream.mOffset = offset;
+		offset += stream.mSize;
+
+		uint8_t *record = table.data() + s * ATTRIB_RECORD_SIZE;
+		writeLittle<uint32_t>( record, stream.mAttrib );
+		record[4] = stream.mDims;
+		record[5] = stream.mEncoding;
+		writeLittle<uint64_t>( record + 8, stream.mCount );
+		writeLittle<uint64_t>( record + 16, stream.mOffset );
+		writeLittle<uint64_t>( record + 24, stream.mSize );
+	}
+	const size_t fileSize = offset;
+
+	// the checksum covers everything after the header, including alignment padding. Blocks that lie within a single
+	// stream are hashed in place; the rest are assembled from their pieces first.
+	struct Piece { size_t mBegin, mSize; const uint8_t *mData; };
+	std::vector<Piece> pieces = { { 0, table.size(), table.data() } };
+	for( const auto &stream : streams )
+		pieces.push_back( { stream.mOffset - HEADER_SIZE, stream.mSize, static_cast<const uint8_t*>( stream.mData ) } );
+	const size_t regionSize = fileSize - HEADER_SIZE;
+	std::vector<uint64_t> blockChecksums( numChecksumBlocks( regionSize ) );
+	parallelFor( blockChecksums.size(), [&]( size_t begin, size_t end ) {
+		std::vector<uint8_t> staging;
+		for( size_t b = begin; b < end; ++b ) {
+			const size_t blockBegin = b * CHECKSUM_BLOCK_SIZE, blockSize = std::min( CHECKSUM_BLOCK_SIZE, regionSize - blockBegin );
+			auto piece = std::upper_bound( pieces.begin(), pieces.end(), blockBegin, []( size_t offset, const Piece &p ) { return offset < p.mBegin; } ) - 1;
+			if( piece->mBegin + piece->mSize >= blockBegin + blockSize ) {
+				blockChecksums[b] = checksumBlock( piece->mData + ( blockBegin - piece->mBegin ), blockSize );
+				continue;
+			}
+
+			staging.assign( blockSize, 0 );
+			for( ; piece != pieces.end() && piece->mBegin < blockBegin + blockSize; ++piece ) {
+				const size_t overlapBegin = std::max( piece->mBegin, blockBegin ), overlapEnd = std::min( piece->mBegin + piece->mSize, blockBegin + blockSize );
+				if( overlapBegin < overlapEnd )
+					memcpy( staging.data() + ( overlapBegin - blockBegin ), piece->mData + ( overlapBegin - piece->mBegin ), overlapEnd - overlapBegin );
+			}
+			blockChecksums[b] = checksumBlock( staging.data(), blockSize );
+		}
+	} );
+	const uint64_t checksum = combineBlockChecksums( blockChecksums );
+
+	const uint8_t padding[STREAM_ALIGNMENT] = {};
+	uint8_t header[HEADER_SIZE] = {};
+	header[0] = BINARY_VERSION;
+	memcpy( header + 1, "TRI", 3 );
+	writeLittle<uint16_t>( header + 4, (uint16_t)HEADER_SIZE );
+	writeLittle<uint16_t>( header + 6, (uint16_t)streams.size() );
+	writeLittle<uint64_t>( header + 8, checksum );
+	writeLittle<uint64_t>( header + 16, numVertices );
+	writeLittle<uint64_t>( header + 24, fileSize );
+
+	OStreamRef out = dataTarget->getStream();
+	out->writeData( header, HEADER_SIZE );
+	out->writeData( table.data(), table.size() );
+	size_t position = HEADER_SIZE + table.size();
+	for( const auto &stream : streams ) {
+		if( stream.mOffset > position )
+			out->writeData( padding, stream.mOffset - position );
+		if( stream.mSize )
+			out->writeData( stream.mData, stream.mSize );
+		position = stream.mOffset + stream.mSize;
+	}
+}
+
+// written by write( DataTargetRef, BinaryOptions ); every stream is decoded straight into its destination vector
+void TriMesh::readImplV3( const TriMeshBinary &binary )
+{
+	mIndices.resize( binary.getNumIndices() );
+	std::vector<std::pair<const TriMeshBinary::AttribStream*, void*>> destinations;
+	destinations.emplace_back( &binary.mIndexStream, mIndices.data() );
+
+	for( const auto &stream : binary.mStreams ) {
+		const uint8_t dims = stream.mDims;
+		const size_t numFloats = stream.mCount * dims;
+		float *dest = nullptr;
+		auto requireDims = [dims]( uint8_t required ) {
+			if( dims != required )
+				throw Exception( "TriMesh::read() error: Invalid file contents." );
+		};
+
+		switch( stream.mAttrib ) {
+			case geom::POSITION:
+				mPositionsDims = dims; mPositions.resize( numFloats ); dest = mPositions.data();
+			break;
+			case geom::COLOR:
+				mColorsDims = dims; mColors.resize( numFloats ); dest = mColors.data();
+			break;
+			case geom::NORMAL:
+				requireDims( 3 ); mNormalsDims = dims; mNormals.resize( stream.mCount ); dest = reinterpret_cast<float*>( mNormals.data() );
+			break;
+			case geom::TEX_COORD_0:
+				mTexCoords0Dims = dims; mTexCoords0.resize( numFloats ); dest = mTexCoords0.data();
+			break;
+			case geom::TEX_COORD_1:
+				mTexCoords1Dims = dims; mTexCoords1.resize( numFloats ); dest = mTexCoords1.data();
+			break;
+			case geom::TEX_COORD_2:
+				mTexCoords2Dims = dims; mTexCoords2.resize( numFloats ); dest = mTexCoords2.data();
+			break;
+			case geom::TEX_COORD_3:
+				mTexCoords3Dims = dims; mTexCoords3.resize( numFloats ); dest = mTexCoords3.data();
+			break;
+			case geom::TANGENT:
+				requireDims( 3 ); mTangentsDims = dims; mTangents.resize( stream.mCount ); dest = reinterpret_cast<float*>( mTangents.data() );
+			break;
+			case geom::BITANGENT:
+				requireDims( 3 ); mBitangentsDims = dims; mBitangents.resize( stream.mCount ); dest = reinterpret_cast<float*>( mBitangents.data() );
+			break;
+			case geom::BONE_INDEX:
+				requireDims( 4 ); mBoneIndicesDims = dims; mBoneIndices.resize( stream.mCount ); dest = reinterpret_cast<float*>( mBoneIndices.data() );
+			break;
+			case geom::BONE_WEIGHT:
+				requireDims( 4 ); mBoneWeightsDims = dims; mBoneWeights.resize( stream.mCount ); dest = reinterpret_cast<float*>( mBoneWeights.data() );
+			break;
+			default:
+				throw Exception( "TriMesh::read() error: Invalid file contents." );
+			break;
+		}
+
+		destinations.emplace_back( &stream, dest );
+	}
+
+	binary.decodeVerified( destinations );
+	if( ! indicesInRange( mIndices.data(), mIndices.size(), binary.getNumVertices() ) )
+		throw TriMeshBinaryExc( "TriMesh file index out of range" );
+}
+
 // used in 0.9.0
 void TriMesh::readImplV2( const IStreamRef &in )
 {
@@ -694,129 +1070,6 @@ void TriMesh::readImplV1( const IStreamRef &in )
 	mTexCoords0Dims = 2;
 }
 
-bool TriMesh::recalculateNormals( bool smooth, bool weighted )
-{
-	// requires valid indices and 3D vertices
-	if( mIndices.empty() || mPositions.empty() || mPositionsDims != 3 )
-		return false;
-
-	size_t numPositions = mPositions.size() / 3;
-	mNormals.assign( numPositions, vec3() );
-
-	// for smooth renormalization, we first find all unique vertices and keep track of them
-	std::vector<uint32_t> uniquePositions;
-	if( smooth ) {
-		uniquePositions.assign( numPositions, 0 );
-
-		for( uint32_t i = 0; i < numPositions; ++i ) {
-			if( uniquePositions[i] == 0 ) {
-				uniquePositions[i] = i + 1;
-				const vec3 &v0 = *(const vec3*)(&mPositions[i * 3]);
-				for( size_t j = i + 1; j < numPositions; ++j ) {
-					const vec3 &v1 = *(const vec3*)(&mPositions[j * 3]);
-					if( length2( v1 - v0 ) < FLT_EPSILON )
-						uniquePositions[j] = uniquePositions[i];
-				}
-			}
-		}
-	}
-
-	// perform surface normalization
-	uint32_t index0, index1, index2;
-	size_t numTriangles = getNumTriangles();
-	for( size_t i = 0; i < numTriangles; ++i ) {
-		if( smooth ) {
-			index0 = uniquePositions[mIndices[i * 3 + 0]] - 1;
-			index1 = uniquePositions[mIndices[i * 3 + 1]] - 1;
-			index2 = uniquePositions[mIndices[i * 3 + 2]] - 1;
-		}
-		else {
-			index0 = mIndices[i*3+0];
-			index1 = mIndices[i*3+1];
-			index2 = mIndices[i*3+2];
-		}
-
-		const vec3 &v0 = *(const vec3*)(&mPositions[index0 * 3]);
-		const vec3 &v1 = *(const vec3*)(&mPositions[index1 * 3]);
-		const vec3 &v2 = *(const vec3*)(&mPositions[index2 * 3]);
-
-		vec3 e0 = v1 - v0;
-		vec3 e1 = v2 - v0;
-		vec3 e2 = v2 - v1;
-
-		if( length2( e0 ) < FLT_EPSILON )
-			continue;
-		if( length2( e1 ) < FLT_EPSILON )
-			continue;
-		if( length2( e2 ) < FLT_EPSILON )
-			continue;
-
-		vec3 normal = cross( e0, e1 );
-
-		// if not weighted, every normal has an equal contribution
-		if( ! weighted )
-			normal = normalize( normal );
-
-		mNormals[ index0 ] += normal;
-		mNormals[ index1 ] += normal;
-		mNormals[ index2 ] += normal;
-	}
-
-	// now normalize the summed normals
-	for( auto &normal : mNormals ) {
-		normal = normalize( normal );
-	}
-
-	// copy normals to corresponding non-unique vertices
-	if( smooth ) {
-		for( size_t i = 0; i < numPositions; ++i ) {
-			mNormals[i] = mNormals[uniquePositions[i]-1];
-		}
-	}
-
-	mNormalsDims = 3;
-
-	return true;
-}
-
-bool TriMesh::recalculateTangents()
-{
-	// requires valid 2D texture coords and 3D normals
-	if( mTexCoords0.empty() || mTexCoords0Dims != 2 )
-		return false;
-
-	if( ! hasNormals() )
-		return false;
-
-	mTangents.clear();
-
-	const vec3 *positions = reinterpret_cast<const vec3*>( mPositions.data() );
-	const vec3 *normals = reinterpret_cast<const vec3*>( mNormals.data() );
-	const vec2 *texCoords = reinterpret_cast<const vec2*>( mTexCoords0.data() );
-	geom::calculateTangents( mIndices.size(), mIndices.data(), mPositions.size() / 3, positions, normals, texCoords, &mTangents, nullptr );
-
-	mTangentsDims = 3;
-
-	return true;
-}
-
-bool TriMesh::recalculateBitangents()
-{
-	// requires valid 3D tangents and normals
-	if( ! ( hasTangents() || recalculateTangents() ) )
-		return false;
-
-	mBitangents.assign( mNormals.size(), vec3() );
-
-	size_t n = getNumVertices();
-	for( size_t i = 0; i < n; ++i )
-		mBitangents[i] = normalize( cross( mNormals[i], mTangents[i] ) );
-
-	mBitangentsDims = 3;
-
-	return true;
-}
-
 //! TODO: optimize memory allocations
 void TriMesh::subdivide( int division, bool normalize )
 {
@@ -1121,6 +1374,30 @@ void TriMesh::getAttribPointer( geom::Attrib attr, const float **resultPtr, size
 	}
 }
 
+bool TriMesh::hasAttribData( geom::Attrib attr ) const
+{
+	const uint8_t dims = getAttribDims( attr );
+	if( dims == 0 )
+		return false;
+
+	const size_t numVertices = getNumVertices();
+	switch( attr ) {
+		case geom::Attrib::POSITION: return mPositions.size() == numVertices * dims;
+		case geom::Attrib::COLOR: return mColors.size() == numVertices * dims;
+		case geom::Attrib::TEX_COORD_0: return mTexCoords0.size() == numVertices * dims;
+		case geom::Attrib::TEX_COORD_1: return mTexCoords1.size() == numVertices * dims;
+		case geom::Attrib::TEX_COORD_2: return mTexCoords2.size() == numVertices * dims;
+		case geom::Attrib::TEX_COORD_3: return mTexCoords3.size() == numVertices * dims;
+		case geom::Attrib::NORMAL: return mNormals.size() == numVertices;
+		case geom::Attrib::TANGENT: return mTangents.size() == numVertices;
+		case geom::Attrib::BITANGENT: return mBitangents.size() == numVertices;
+		case geom::Attrib::BONE_INDEX: return mBoneIndices.size() == numVertices;
+		case geom::Attrib::BONE_WEIGHT: return mBoneWeights.size() == numVertices;
+		default:
+			return false;
+	}
+}
+
 void TriMesh::copyAttrib( geom::Attrib attr, uint8_t dims, size_t strideBytes, const float *srcData, size_t numVertices )
 {
 	if( getAttribDims( attr ) == 0 )
@@ -1389,4 +1666,231 @@ geom::Attrib TriMesh::fromMask( uint32_t attrib )
 	}
 }
 
+TriMesh::BinaryOptions& TriMesh::BinaryOptions::attribs( const std::set<geom::Attrib> &attribs )
+{
+	mAttribMask = 0;
+	for( auto &attrib : attribs )
+		mAttribMask |= TriMesh::toMask( attrib );
+	return *this;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// TriMeshBinary
+TriMeshBinary::TriMeshBinary( const DataSourceRef &dataSource, bool verifyChecksum )
+{
+	// files are mapped rather than read, so that float streams are never copied on their way to a geom::Target
+	const uint8_t *data;
+	size_t dataSize;
+	mIndexStream.mAttrib = geom::NUM_ATTRIBS;
+	if( dataSource->isFilePath() ) {
+		auto mappedFile = MemoryMappedFile::create( dataSource->getFilePath() );
+		data = static_cast<const uint8_t*>( mappedFile->getData() );
+		dataSize = mappedFile->getSize();
+		mStorage = mappedFile;
+	}
+	else {
+		auto buffer = dataSource->getBuffer();
+		data = static_cast<const uint8_t*>( buffer->getData() );
+		dataSize = buffer->getSize();
+		mStorage = buffer;
+	}
+
+	if( dataSize < HEADER_SIZE || data[0] != BINARY_VERSION || memcmp( data + 1, "TRI", 3 ) != 0 )
+		throw TriMeshBinaryExc( "Not a version 3 TriMesh file" );
+
+	const size_t headerSize = readLittle<uint16_t>( data + 4 );
+	const size_t numStreams = readLittle<uint16_t>( data + 6 );
+	const uint64_t checksum = readLittle<uint64_t>( data + 8 );
+	const uint64_t numVertices = readLittle<uint64_t>( data + 16 );
+	const uint64_t fileSize = readLittle<uint64_t>( data + 24 );
+	if( headerSize < HEADER_SIZE || numStreams == 0 || fileSize < headerSize + numStreams * ATTRIB_RECORD_SIZE )
+		throw TriMeshBinaryExc( "Corrupt TriMesh header" );
+	if( fileSize > dataSize )
+		throw TriMeshBinaryExc( "Truncated TriMesh file" );
+	if( verifyChecksum && calcChecksum( data + headerSize, (size_t)fileSize - headerSize ) != checksum )
+		throw TriMeshBinaryExc( "TriMesh file checksum mismatch" );
+
+	mData = data;
+	mHeaderSize = headerSize;
+	mFileSize = (size_t)fileSize;
+	mChecksum = checksum;
+	mNumVertices = (size_t)numVertices;
+	mStreams.reserve( numStreams - 1 );
+	for( size_t s = 0; s < numStreams; ++s ) {
+		const uint8_t *record = data + headerSize + s * ATTRIB_RECORD_SIZE;
+		const uint32_t attribMask = readLittle<uint32_t>( record );
+		const uint8_t dims = record[4], encoding = record[5];
+		const uint64_t count = readLittle<uint64_t>( record + 8 );
+		const uint64_t offset = readLittle<uint64_t>( record + 16 );
+		const uint64_t size = readLittle<uint64_t>( record + 24 );
+
+		bool valid = encoding <= ENCODING_UINT32 && dims > 0 && offset % STREAM_ALIGNMENT == 0 && offset <= fileSize && size <= fileSize - offset;
+		if( valid )
+			valid = ( encoding != ENCODING_OCT16 || dims == 3 ) && count <= size && size == count * encodedElementBytes( encoding, dims );
+		if( valid && s == 0 )
+			valid = attribMask == 0 && dims == 1 && ( encoding == ENCODING_UINT16 || encoding == ENCODING_UINT32 );
+		else if( valid )
+			valid = attribMask != 0 && encoding <= ENCODING_OCT16;
+		if( ! valid )
+			throw TriMeshBinaryExc( "Corrupt TriMesh attribute record " + std::to_string( s ) );
+
+		AttribStream &stream = ( s == 0 ) ? mIndexStream : *mStreams.emplace( mStreams.end() );
+		if( s != 0 )
+			stream.mAttrib = TriMesh::fromMask( attribMask );
+		stream.mDims = dims;
+		stream.mEncoding = encoding;
+		stream.mCount = (size_t)count;
+		stream.mData = data + offset;
+	}
+	mNumIndices = mIndexStream.mCount;
+
+	// the positions define the vertex count, and no other stream may reach past it
+	bool hasPositions = false;
+	for( const auto &stream : mStreams ) {
+		if( stream.mCount > mNumVertices || ( stream.mAttrib == geom::POSITION && stream.mCount != mNumVertices ) )
+			throw TriMeshBinaryExc( "TriMesh attribute stream doesn't match the vertex count" );
+		hasPositions = hasPositions || stream.mAttrib == geom::POSITION;
+	}
+	if( mNumVertices != 0 && ! hasPositions )
+		throw TriMeshBinaryExc( "TriMesh file has vertices but no positions" );
+}
+
+const TriMeshBinary::AttribStream* TriMeshBinary::findStream( geom::Attrib attr ) const
+{
+	// streams shorter than the positions can't be handed to a geom::Target, but TriMesh::read() still restores them
+	for( const auto &stream : mStreams )
+		if( stream.mAttrib == attr && stream.mCount == mNumVertices )
+			return &stream;
+	return nullptr;
+}
+
+uint8_t TriMeshBinary::getAttribDims( geom::Attrib attr ) const
+{
+	const AttribStream *stream = findStream( attr );
+	return stream ? stream->mDims : 0;
+}
+
+geom::AttribSet TriMeshBinary::getAvailableAttribs() const
+{
+	geom::AttribSet result;
+	for( const auto &stream : mStreams )
+		if( stream.mCount == mNumVertices )
+			result.insert( stream.mAttrib );
+	return result;
+}
+
+const float* TriMeshBinary::getAttribData( geom::Attrib attr ) const
+{
+	const AttribStream *stream = findStream( attr );
+	return ( stream && stream->mEncoding == ENCODING_FLOAT32 ) ? reinterpret_cast<const float*>( stream->mData ) : nullptr;
+}
+
+bool TriMeshBinary::isAttribQuantized( geom::Attrib attr ) const
+{
+	const AttribStream *stream = findStream( attr );
+	return stream && stream->mEncoding != ENCODING_FLOAT32;
+}
+
+void TriMeshBinary::decodeElements( const AttribStream &stream, void *dest, size_t begin, size_t end )
+{
+	const uint8_t dims = stream.mDims;
+	switch( stream.mEncoding ) {
+		case ENCODING_FLOAT32:
+		case ENCODING_UINT32:
+			if( end > begin )
+				memcpy( static_cast<uint8_t*>( dest ) + begin * dims * 4, stream.mData + begin * dims * 4, ( end - begin ) * dims * 4 );
+		break;
+		case ENCODING_FLOAT16: {
+			const half_float *src = reinterpret_cast<const half_float*>( stream.mData );
+			float *floatDest = static_cast<float*>( dest );
+			for( size_t i = begin * dims; i < end * dims; ++i )
+				floatDest[i] = halfToFloat( src[i] );
+		}
+		break;
+		case ENCODING_OCT16: {
+			const int16_t *src = reinterpret_cast<const int16_t*>( stream.mData );
+			float *floatDest = static_cast<float*>( dest );
+			for( size_t v = begin; v < end; ++v )
+				decodeOctahedral( src + v * 2, floatDest + v * 3 );
+		}
+		break;
+		case ENCODING_UINT16: {
+			const uint16_t *src = reinterpret_cast<const uint16_t*>( stream.mData );
+			uint32_t *indexDest = static_cast<uint32_t*>( dest );
+			for( size_t i = begin; i < end; ++i )
+				indexDest[i] = src[i];
+		}
+		break;
+	}
+}
+
+void TriMeshBinary::decodeStream( const AttribStream &stream, void *dest )
+{
+	parallelFor( stream.mCount, [&]( size_t begin, size_t end ) {
+		decodeElements( stream, dest, begin, end );
+	}, DECODE_GRAIN );
+}
+
+void TriMeshBinary::decodeVerified( const std::vector<std::pair<const AttribStream*, void*>> &destinations ) const
+{
+	// returns how many of the stream's elements start before \a p
+	auto elementsBefore = []( const AttribStream &stream, const uint8_t *p ) -> size_t {
+		if( p <= stream.mData )
+			return 0;
+		const size_t elementBytes = encodedElementBytes( stream.mEncoding, stream.mDims );
+		return std::min( stream.mCount, ( (size_t)( p - stream.mData ) + elementBytes - 1 ) / elementBytes );
+	};
+
+	// each block is hashed and then the elements starting inside it are decoded, while it's still in cache
+	const uint8_t *region = mData + mHeaderSize;
+	const size_t regionSize = mFileSize - mHeaderSize;
+	std::vector<uint64_t> blockChecksums( numChecksumBlocks( regionSize ) );
+	parallelFor( blockChecksums.size(), [&]( size_t begin, size_t end ) {
+		for( size_t b = begin; b < end; ++b ) {
+			const uint8_t *block = region + b * CHECKSUM_BLOCK_SIZE;
+			const size_t blockSize = std::min( CHECKSUM_BLOCK_SIZE, regionSize - b * CHECKSUM_BLOCK_SIZE );
+			blockChecksums[b] = checksumBlock( block, blockSize );
+			for( const auto &destination : destinations ) {
+				const size_t first = elementsBefore( *destination.first, block ), last = elementsBefore( *destination.first, block + blockSize );
+				if( first < last )
+					decodeElements( *destination.first, destination.second, first, last );
+			}
+		}
+	} );
+
+	if( combineBlockChecksums( blockChecksums ) != mChecksum )
+		throw TriMeshBinaryExc( "TriMesh file checksum mismatch" );
+}
+
+void TriMeshBinary::loadInto( geom::Target *target, const geom::AttribSet &requestedAttribs ) const
+{
+	std::vector<float> decoded;
+	for( auto &attrib : requestedAttribs ) {
+		const AttribStream *stream = findStream( attrib );
+		if( ! stream )
+			continue;
+
+		if( stream->mEncoding == ENCODING_FLOAT32 )
+			target->copyAttrib( attrib, stream->mDims, 0, reinterpret_cast<const float*>( stream->mData ), mNumVertices );
+		else {
+			decoded.resize( mNumVertices * stream->mDims );
+			decodeStream( *stream, decoded.data() );
+			target->copyAttrib( attrib, stream->mDims, 0, decoded.data(), mNumVertices );
+		}
+	}
+
+	if( mNumIndices ) {
+		std::vector<uint32_t> decodedIndices;
+		const uint32_t *indices = reinterpret_cast<const uint32_t*>( mIndexStream.mData );
+		if( mIndexStream.mEncoding != ENCODING_UINT32 ) {
+			decodedIndices.resize( mNumIndices );
+			decodeStream( mIndexStream, decodedIndices.data() );
+			indices = decodedIndices.data();
+		}
+		if( ! indicesInRange( indices, mNumIndices, mNumVertices ) )
+			throw TriMeshBinaryExc( "TriMesh file index out of range" );
+		target->copyIndices( geom::Primitive::TRIANGLES, indices, mNumIndices, ( mIndexStream.mEncoding == ENCODING_UINT32 ) ? 4 : 2 );
+	}
+}
+
 } // namespace cinder
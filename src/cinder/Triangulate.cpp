@@ -22,8 +22,12 @@
 
 #include "cinder/Triangulate.h"
 #include "cinder/Shape2d.h"
+#include "cinder/Thread.h"
 #include "../libtess2/tesselator.h"
 
+#include <algorithm>
+#include <cstring>
+
 using namespace std;
 
 namespace cinder {
@@ -40,6 +44,200 @@ void stdFree( void* /*userData*/, void* ptr )
 	free( ptr );
 }
 
+namespace {
+
+// Contours with more points than this are left to libtess2, whose sweep scales better than ear clipping's quadratic ear search
+const size_t EAR_CLIP_MAX_POINTS = 256;
+
+inline double cross( const vec2 &a, const vec2 &b, const vec2 &c )
+{
+	return ( (double)b.x - a.x ) * ( (double)c.y - a.y ) - ( (double)b.y - a.y ) * ( (double)c.x - a.x );
+}
+
+// assumes \a p is collinear with \a a and \a b
+inline bool isWithinBounds( const vec2 &a, const vec2 &b, const vec2 &p )
+{
+	return p.x >= std::min( a.x, b.x ) && p.x <= std::max( a.x, b.x ) && p.y >= std::min( a.y, b.y ) && p.y <= std::max( a.y, b.y );
+}
+
+// touching counts as intersecting
+bool segmentsIntersect( const vec2 &p0, const vec2 &p1, const vec2 &q0, const vec2 &q1 )
+{
+	const double d0 = cross( q0, q1, p0 ), d1 = cross( q0, q1, p1 );
+	const double d2 = cross( p0, p1, q0 ), d3 = cross( p0, p1, q1 );
+	if( ( ( d0 > 0 && d1 < 0 ) || ( d0 < 0 && d1 > 0 ) ) && ( ( d2 > 0 && d3 < 0 ) || ( d2 < 0 && d3 > 0 ) ) )
+		return true;
+	return ( d0 == 0 && isWithinBounds( q0, q1, p0 ) ) || ( d1 == 0 && isWithinBounds( q0, q1, p1 ) )
+		|| ( d2 == 0 && isWithinBounds( p0, p1, q0 ) ) || ( d3 == 0 && isWithinBounds( p0, p1, q1 ) );
+}
+
+// Returns whether the closed polygon \a points neither crosses nor touches itself. Edges are swept in order of their minimum x, so only edges with overlapping x extents are tested against each other.
+bool isSimplePolygon( const vector<vec2> &points )
+{
+	const size_t n = points.size();
+	for( size_t i = 0; i < n; ++i ) {
+		// adjacent edges only share their common point, unless the contour doubles back on itself
+		const vec2 &prev = points[( i + n - 1 ) % n], &p = points[i], &next = points[( i + 1 ) % n];
+		if( cross( prev, p, next ) == 0 && dot( prev - p, next - p ) > 0 )
+			return false;
+	}
+
+	vector<uint32_t> edges( n );
+	for( size_t i = 0; i < n; ++i )
+		edges[i] = (uint32_t)i;
+	auto minX = [&]( uint32_t e ) { return std::min( points[e].x, points[( e + 1 ) % n].x ); };
+	std::sort( edges.begin(), edges.end(), [&]( uint32_t a, uint32_t b ) { return minX( a ) < minX( b ); } );
+	for( size_t i = 0; i < n; ++i ) {
+		const uint32_t a = edges[i];
+		const vec2 &a0 = points[a], &a1 = points[( a + 1 ) % n];
+		const float maxX = std::max( a0.x, a1.x ), minY = std::min( a0.y, a1.y ), maxY = std::max( a0.y, a1.y );
+		for( size_t j = i + 1; j < n && minX( edges[j] ) <= maxX; ++j ) {
+			const uint32_t b = edges[j];
+			const vec2 &b0 = points[b], &b1 = points[( b + 1 ) % n];
+			if( b == ( a + 1 ) % n || a == ( b + 1 ) % n || std::max( b0.y, b1.y ) < minY || std::min( b0.y, b1.y ) > maxY )
+				continue;
+			if( segmentsIntersect( a0, a1, b0, b1 ) )
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// Triangulates the closed polygon \a points by ear clipping, writing the unique points to \a resultPositions. Triangles share the polygon's orientation.
+// Returns false when the polygon is too large, is not simple or runs into numerical trouble, leaving it to libtess2.
+bool earClip( const vec2 *points, size_t numPoints, vector<vec2> *resultPositions, vector<uint32_t> *resultIndices )
+{
+	if( numPoints > EAR_CLIP_MAX_POINTS )
+		return false;
+
+	// drop repeated points, including a closing point equal to the first one
+	vector<vec2> &positions = *resultPositions;
+	positions.clear();
+	resultIndices->clear();
+	for( size_t i = 0; i < numPoints; ++i ) {
+		if( positions.empty() || points[i] != positions.back() )
+			positions.push_back( points[i] );
+	}
+	while( positions.size() > 1 && positions.back() == positions.front() )
+		positions.pop_back();
+
+	const size_t n = positions.size();
+	if( n < 3 ) {
+		positions.clear();
+		return true;
+	}
+	if( ! isSimplePolygon( positions ) )
+		return false;
+
+	double area = 0;
+	for( size_t i = 1; i + 1 < n; ++i )
+		area += cross( positions[0], positions[i], positions[i + 1] );
+	const double orientation = ( area < 0 ) ? -1 : 1;
+
+	vector<uint32_t> prev( n ), next( n );
+	for( size_t i = 0; i < n; ++i ) {
+		prev[i] = (uint32_t)( ( i + n - 1 ) % n );
+		next[i] = (uint32_t)( ( i + 1 ) % n );
+	}
+	// only reflex vertices can lie inside an ear of a simple polygon; clipping a vertex changes the convexity of its neighbors alone
+	vector<uint8_t> reflex( n );
+	auto updateReflex = [&]( uint32_t v ) {
+		reflex[v] = cross( positions[prev[v]], positions[v], positions[next[v]] ) * orientation <= 0;
+	};
+	for( uint32_t i = 0; i < n; ++i )
+		updateReflex( i );
+	auto unlink = [&]( uint32_t v ) {
+		next[prev[v]] = next[v];
+		prev[next[v]] = prev[v];
+		updateReflex( prev[v] );
+		updateReflex( next[v] );
+	};
+	// a convex vertex is an ear when no reflex vertex lies inside or on its triangle
+	auto isEar = [&]( uint32_t a, uint32_t v, uint32_t c ) {
+		const vec2 &pa = positions[a], &pv = positions[v], &pc = positions[c];
+		const vec2 minCorner = glm::min( pa, glm::min( pv, pc ) ), maxCorner = glm::max( pa, glm::max( pv, pc ) );
+		for( uint32_t p = next[c]; p != a; p = next[p] ) {
+			const vec2 &pp = positions[p];
+			if( ! reflex[p] || pp.x < minCorner.x || pp.y < minCorner.y || pp.x > maxCorner.x || pp.y > maxCorner.y )
+				continue;
+			if( cross( pa, pv, pp ) * orientation >= 0 && cross( pv, pc, pp ) * orientation >= 0 && cross( pc, pa, pp ) * orientation >= 0 )
+				return false;
+		}
+		return true;
+	};
+
+	vector<uint32_t> &indices = *resultIndices;
+	indices.reserve( ( n - 2 ) * 3 );
+	size_t remaining = n, sinceLastClip = 0;
+	uint32_t v = 0;
+	while( remaining > 3 ) {
+		const uint32_t a = prev[v], c = next[v];
+		const double turn = cross( positions[a], positions[v], positions[c] ) * orientation;
+		if( turn == 0 ) {
+			// a collinear point contributes no area
+			unlink( v );
+			--remaining;
+			v = a;
+			sinceLastClip = 0;
+		}
+		else if( turn > 0 && isEar( a, v, c ) ) {
+			indices.push_back( a );
+			indices.push_back( v );
+			indices.push_back( c );
+			unlink( v );
+			--remaining;
+			v = c;
+			sinceLastClip = 0;
+		}
+		else if( ++sinceLastClip > remaining ) {
+			return false;
+		}
+		else
+			v = c;
+	}
+	if( cross( positions[prev[v]], positions[v], positions[next[v]] ) != 0 ) {
+		indices.push_back( prev[v] );
+		indices.push_back( v );
+		indices.push_back( next[v] );
+	}
+
+	return true;
+}
+
+void appendKey( const Path2d &path, vector<uint32_t> *key )
+{
+	const auto &segments = path.getSegments();
+	const auto &points = path.getPoints();
+	key->push_back( (uint32_t)segments.size() );
+	key->push_back( (uint32_t)points.size() );
+	for( auto segment : segments )
+		key->push_back( (uint32_t)segment );
+	const size_t offset = key->size();
+	key->resize( offset + points.size() * 2 );
+	if( ! points.empty() )
+		memcpy( &(*key)[offset], points.data(), points.size() * sizeof( vec2 ) );
+}
+
+vector<uint32_t> makeKey( float approximationScale, Triangulator::Winding winding, size_t numContours )
+{
+	vector<uint32_t> result( 3 );
+	memcpy( &result[0], &approximationScale, sizeof( float ) );
+	result[1] = (uint32_t)winding;
+	result[2] = (uint32_t)numContours;
+	return result;
+}
+
+uint64_t hashKey( const vector<uint32_t> &key )
+{
+	uint64_t result = 0xcbf29ce484222325ULL;
+	for( uint32_t word : key )
+		result = ( result ^ word ) * 0x100000001b3ULL;
+	return result ^ ( result >> 29 );
+}
+
+} // anonymous namespace
+
 Triangulator::Triangulator( const Path2d &path, float approximationScale )
 {	
 	allocate();
@@ -66,6 +264,7 @@ Triangulator::Triangulator()
 void Triangulator::allocate()
 {
 	mAllocated = 0;
+	mContourOffsets.assign( 1, 0 );
 	
 	TESSalloc ma;
 	memset( &ma, 0, sizeof(ma) );
@@ -81,50 +280,260 @@ void Triangulator::allocate()
 
 void Triangulator::addShape( const Shape2d &shape, float approximationScale )
 {
-	size_t numContours = shape.getContours().size();
-	for( size_t p = 0; p < numContours; ++p ) {
-		addPath( shape.getContour(p), approximationScale );
-	}	
+	vector<vec2> points;
+	vector<uint32_t> contourOffsets;
+	shape.flatten( &points, &contourOffsets, approximationScale );
+	const uint32_t offset = (uint32_t)mPoints.size();
+	mPoints.insert( mPoints.end(), points.begin(), points.end() );
+	for( size_t c = 1; c < contourOffsets.size(); ++c ) {
+		if( contourOffsets[c] > contourOffsets[c - 1] )
+			mContourOffsets.push_back( offset + contourOffsets[c] );
+	}
 }
 
 void Triangulator::addPath( const Path2d &path, float approximationScale )
 {
-	vector<vec2> subdivided = path.subdivide( approximationScale );
-	tessAddContour( mTess.get(), 2, &subdivided[0], sizeof(float) * 2, (int)subdivided.size() );
+	path.flatten( &mPoints, approximationScale );
+	if( mPoints.size() > mContourOffsets.back() )
+		mContourOffsets.push_back( (uint32_t)mPoints.size() );
 }
 
 void Triangulator::addPolyLine( const PolyLine2f &polyLine )
 {
-	if( polyLine.size() > 0 )
-		tessAddContour( mTess.get(), 2, &polyLine.getPoints()[0], sizeof(float) * 2, (int)polyLine.size() );
+	addPolyLine( polyLine.getPoints().data(), polyLine.size() );
 }
 
 void Triangulator::addPolyLine( const vec2 *points, size_t numPoints )
 {
-	if( numPoints > 0 )
-		tessAddContour( mTess.get(), 2, &points, sizeof(vec2), (int)numPoints );
+	if( numPoints > 0 ) {
+		mPoints.insert( mPoints.end(), points, points + numPoints );
+		mContourOffsets.push_back( (uint32_t)mPoints.size() );
+	}
+}
+
+void Triangulator::calcMesh( vector<vec2> *resultPositions, vector<uint32_t> *resultIndices, Winding winding )
+{
+	// libtess2 fills a lone simple contour under each of these rules, whatever its orientation
+	const bool fillsSimpleContour = winding == WINDING_ODD || winding == WINDING_NONZERO || winding == WINDING_POSITIVE;
+	if( ! ( mContourOffsets.size() == 2 && fillsSimpleContour && earClip( mPoints.data(), mPoints.size(), resultPositions, resultIndices ) ) ) {
+		for( size_t c = 0; c + 1 < mContourOffsets.size(); ++c )
+			tessAddContour( mTess.get(), 2, &mPoints[mContourOffsets[c]], sizeof(float) * 2, (int)( mContourOffsets[c + 1] - mContourOffsets[c] ) );
+		resultPositions->clear();
+		resultIndices->clear();
+		// libtess2 leaves stale output counts behind when it fails or has nothing to tesselate
+		if( mContourOffsets.size() > 1 && tessTesselate( mTess.get(), (int)winding, TESS_POLYGONS, 3, 2, 0 ) && tessGetVertices( mTess.get() ) ) {
+			const vec2 *vertices = (const vec2*)tessGetVertices( mTess.get() );
+			const uint32_t *elements = (const uint32_t*)tessGetElements( mTess.get() );
+			resultPositions->assign( vertices, vertices + tessGetVertexCount( mTess.get() ) );
+			resultIndices->assign( elements, elements + tessGetElementCount( mTess.get() ) * 3 );
+		}
+	}
+
+	mPoints.clear();
+	mContourOffsets.assign( 1, 0 );
 }
 
 TriMesh Triangulator::calcMesh( Winding winding )
 {
 	TriMesh result( TriMesh::Format().positions( 2 ) );
 	
-	tessTesselate( mTess.get(), (int)winding, TESS_POLYGONS, 3, 2, 0 );
-	result.appendPositions( (vec2*)tessGetVertices( mTess.get() ), tessGetVertexCount( mTess.get() ) );
-	result.appendIndices( (uint32_t*)( tessGetElements( mTess.get() ) ), tessGetElementCount( mTess.get() ) * 3 );
+	vector<vec2> positions;
+	vector<uint32_t> indices;
+	calcMesh( &positions, &indices, winding );
+	result.appendPositions( positions.data(), positions.size() );
+	result.appendIndices( indices.data(), indices.size() );
 	
 	return result;
 }
 
 TriMeshRef Triangulator::createMesh( Winding winding )
 {
-	TriMeshRef result = make_shared<TriMesh>( TriMesh::Format().positions( 2 ) );
-	
-	tessTesselate( mTess.get(), (int)winding, TESS_POLYGONS, 3, 2, 0 );
-	result->appendPositions( (vec2*)tessGetVertices( mTess.get() ), tessGetVertexCount( mTess.get() ) );
-	result->appendIndices( (uint32_t*)( tessGetElements( mTess.get() ) ), tessGetElementCount( mTess.get() ) * 3 );
-	
+	return make_shared<TriMesh>( calcMesh( winding ) );
+}
+
+void Triangulator::calcMeshes( const vector<Shape2d> &shapes, Batch *result, float approximationScale, Winding winding )
+{
+	const size_t numShapes = shapes.size();
+	vector<vector<vec2>> positions( numShapes );
+	vector<vector<uint32_t>> indices( numShapes );
+	// one tesselator per range, reused for each shape in it; a few ranges per thread balance uneven shapes
+	const size_t grainSize = std::max<size_t>( 1, numShapes / ( getNumParallelThreads() * 4 ) );
+	parallelFor( numShapes, [&]( size_t begin, size_t end ) {
+		Triangulator triangulator;
+		for( size_t s = begin; s < end; ++s ) {
+			triangulator.addShape( shapes[s], approximationScale );
+			triangulator.calcMesh( &positions[s], &indices[s], winding );
+		}
+	}, grainSize );
+
+	result->mVertexOffsets.resize( numShapes + 1 );
+	result->mIndexOffsets.resize( numShapes + 1 );
+	result->mVertexOffsets[0] = result->mIndexOffsets[0] = 0;
+	for( size_t s = 0; s < numShapes; ++s ) {
+		result->mVertexOffsets[s + 1] = result->mVertexOffsets[s] + (uint32_t)positions[s].size();
+		result->mIndexOffsets[s + 1] = result->mIndexOffsets[s] + (uint32_t)indices[s].size();
+	}
+
+	result->mPositions.resize( result->mVertexOffsets.back() );
+	result->mIndices.resize( result->mIndexOffsets.back() );
+	parallelFor( numShapes, [&]( size_t begin, size_t end ) {
+		for( size_t s = begin; s < end; ++s ) {
+			std::copy( positions[s].begin(), positions[s].end(), result->mPositions.begin() + result->mVertexOffsets[s] );
+			const uint32_t vertexOffset = result->mVertexOffsets[s];
+			uint32_t *resultIndices = result->mIndices.data() + result->mIndexOffsets[s];
+			for( uint32_t index : indices[s] )
+				*resultIndices++ = index + vertexOffset;
+		}
+	}, grainSize );
+}
+
+TriMesh Triangulator::Batch::calcMesh() const
+{
+	TriMesh result( TriMesh::Format().positions( 2 ) );
+	result.appendPositions( mPositions.data(), mPositions.size() );
+	result.appendIndices( mIndices.data(), mIndices.size() );
 	return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////
+// TriangulatorCache
+TriangulatorCache::TriangulatorCache( size_t maxEntries, bool admitOnRepeat )
+	: mMaxEntries( maxEntries ), mNumHits( 0 ), mNumMisses( 0 ), mAdmitOnRepeat( admitOnRepeat )
+{
+}
+
+shared_ptr<const TriMesh> TriangulatorCache::get( const Shape2d &shape, float approximationScale, Triangulator::Winding winding )
+{
+	vector<uint32_t> key = makeKey( approximationScale, winding, shape.getContours().size() );
+	for( const auto &contour : shape.getContours() )
+		appendKey( contour, &key );
+
+	return get( key, [&]( Triangulator *triangulator ) { triangulator->addShape( shape, approximationScale ); }, winding );
+}
+
+shared_ptr<const TriMesh> TriangulatorCache::get( const Path2d &path, float approximationScale, Triangulator::Winding winding )
+{
+	// matches the key of a Shape2d holding only this path, which triangulates identically
+	vector<uint32_t> key = makeKey( approximationScale, winding, 1 );
+	appendKey( path, &key );
+
+	return get( key, [&]( Triangulator *triangulator ) { triangulator->addPath( path, approximationScale ); }, winding );
+}
+
+shared_ptr<const TriMesh> TriangulatorCache::get( const vector<uint32_t> &key, const function<void( Triangulator *triangulator )> &addContours, Triangulator::Winding winding )
+{
+	const uint64_t hash = hashKey( key );
+	auto find = [&]() -> shared_ptr<const TriMesh> {
+		auto range = mLookup.equal_range( hash );
+		for( auto it = range.first; it != range.second; ++it ) {
+			if( it->second->mKey == key ) {
+				mEntries.splice( mEntries.begin(), mEntries, it->second );
+				return it->second->mMesh;
+			}
+		}
+		return nullptr;
+	};
+
+	bool admitted;
+	{
+		lock_guard<mutex> lock( mMutex );
+		if( auto mesh = find() ) {
+			++mNumHits;
+			return mesh;
+		}
+		++mNumMisses;
+		admitted = admit( hash );
+	}
+
+	// tesselate without holding the lock, so that other threads keep using the cache meanwhile
+	Triangulator triangulator;
+	addContours( &triangulator );
+	shared_ptr<const TriMesh> mesh = triangulator.createMesh( winding );
+	if( ! admitted )
+		return mesh;
+
+	lock_guard<mutex> lock( mMutex );
+	// another thread may have inserted the same shape in the meantime
+	if( auto existing = find() )
+		return existing;
+	mEntries.push_front( Entry{ hash, key, mesh } );
+	mLookup.emplace( hash, mEntries.begin() );
+	trim();
+
+	return mesh;
+}
+
+bool TriangulatorCache::admit( uint64_t hash )
+{
+	if( ! mAdmitOnRepeat )
+		return true;
+
+	// a hash collision only admits a key early
+	auto seen = std::find( mSeenOnce.begin(), mSeenOnce.end(), hash );
+	if( seen != mSeenOnce.end() ) {
+		mSeenOnce.erase( seen );
+		return true;
+	}
+
+	mSeenOnce.push_back( hash );
+	if( mSeenOnce.size() > mMaxEntries )
+		mSeenOnce.pop_front();
+	return false;
+}
+
+void TriangulatorCache::trim()
+{
+	while( mSeenOnce.size() > mMaxEntries )
+		mSeenOnce.pop_front();
+	while( mEntries.size() > mMaxEntries ) {
+		auto range = mLookup.equal_range( mEntries.back().mHash );
+		for( auto it = range.first; it != range.second; ++it ) {
+			if( it->second == std::prev( mEntries.end() ) ) {
+				mLookup.erase( it );
+				break;
+			}
+		}
+		mEntries.pop_back();
+	}
+}
+
+void TriangulatorCache::clear()
+{
+	lock_guard<mutex> lock( mMutex );
+	mEntries.clear();
+	mLookup.clear();
+	mSeenOnce.clear();
+}
+
+size_t TriangulatorCache::getNumEntries() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mEntries.size();
+}
+
+size_t TriangulatorCache::getMaxEntries() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mMaxEntries;
+}
+
+void TriangulatorCache::setMaxEntries( size_t maxEntries )
+{
+	lock_guard<mutex> lock( mMutex );
+	mMaxEntries = maxEntries;
+	trim();
+}
+
+size_t TriangulatorCache::getNumHits() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mNumHits;
+}
+
+size_t TriangulatorCache::getNumMisses() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mNumMisses;
+}
+
 } // namespace cinder
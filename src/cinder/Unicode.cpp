@@ -45,9 +45,18 @@
  */
 
 #include "cinder/Unicode.h"
+#include <algorithm>
 #include <cstring>
 #include <string>
 
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_UNICODE_SSE2
+	#include <emmintrin.h>
+#elif defined( __aarch64__ ) || defined( _M_ARM64 )
+	#define CINDER_UNICODE_NEON
+	#include <arm_neon.h>
+#endif
+
 #include "utf8cpp/checked.h"
 extern "C" {
 #include "linebreak.h"
@@ -72,38 +81,225 @@ static const int halfShift = 10; // shift by 10 bits
 #define UNI_MAX_UTF32			(char32_t)0x7FFFFFFF
 #define UNI_MAX_LEGAL_UTF32		(char32_t)0x0010FFFF
 
+namespace {
+
+// Returns the length of the run of 7-bit ASCII units at the start of [str, str + length)
+size_t asciiPrefixLength( const char *str, size_t length )
+{
+	size_t i = 0;
+#if defined( CINDER_UNICODE_SSE2 )
+	for( ; i + 16 <= length; i += 16 )
+		if( _mm_movemask_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( str + i ) ) ) != 0 )
+			break;
+#elif defined( CINDER_UNICODE_NEON )
+	for( ; i + 16 <= length; i += 16 )
+		if( vmaxvq_u8( vld1q_u8( reinterpret_cast<const uint8_t*>( str + i ) ) ) >= 0x80 )
+			break;
+#endif
+	while( i < length && static_cast<unsigned char>( str[i] ) < 0x80 )
+		++i;
+	return i;
+}
+
+size_t asciiPrefixLength( const char16_t *str, size_t length )
+{
+	size_t i = 0;
+#if defined( CINDER_UNICODE_SSE2 )
+	const __m128i highBits = _mm_set1_epi16( (short)0xFF80 );
+	for( ; i + 8 <= length; i += 8 ) {
+		__m128i v = _mm_and_si128( _mm_loadu_si128( reinterpret_cast<const __m128i*>( str + i ) ), highBits );
+		if( _mm_movemask_epi8( _mm_cmpeq_epi16( v, _mm_setzero_si128() ) ) != 0xFFFF )
+			break;
+	}
+#elif defined( CINDER_UNICODE_NEON )
+	for( ; i + 8 <= length; i += 8 )
+		if( vmaxvq_u16( vld1q_u16( reinterpret_cast<const uint16_t*>( str + i ) ) ) >= 0x80 )
+			break;
+#endif
+	while( i < length && str[i] < 0x80 )
+		++i;
+	return i;
+}
+
+size_t asciiPrefixLength( const char32_t *str, size_t length )
+{
+	size_t i = 0;
+#if defined( CINDER_UNICODE_SSE2 )
+	const __m128i highBits = _mm_set1_epi32( (int)0xFFFFFF80 );
+	for( ; i + 4 <= length; i += 4 ) {
+		__m128i v = _mm_and_si128( _mm_loadu_si128( reinterpret_cast<const __m128i*>( str + i ) ), highBits );
+		if( _mm_movemask_epi8( _mm_cmpeq_epi32( v, _mm_setzero_si128() ) ) != 0xFFFF )
+			break;
+	}
+#elif defined( CINDER_UNICODE_NEON )
+	for( ; i + 4 <= length; i += 4 )
+		if( vmaxvq_u32( vld1q_u32( reinterpret_cast<const uint32_t*>( str + i ) ) ) >= 0x80 )
+			break;
+#endif
+	while( i < length && str[i] < 0x80 )
+		++i;
+	return i;
+}
+
+inline char16_t* appendCodePoint( uint32_t cp, char16_t *out )
+{
+	if( cp > 0xFFFF ) {
+		*out++ = static_cast<char16_t>( ( cp >> 10 ) + utf8::internal::LEAD_OFFSET );
+		*out++ = static_cast<char16_t>( ( cp & 0x3FF ) + utf8::internal::TRAIL_SURROGATE_MIN );
+	}
+	else
+		*out++ = static_cast<char16_t>( cp );
+	return out;
+}
+
+inline char32_t* appendCodePoint( uint32_t cp, char32_t *out )
+{
+	*out++ = static_cast<char32_t>( cp );
+	return out;
+}
+
+// ASCII runs are widened directly; everything else goes through utf8cpp so invalid input throws exactly as before
+template<typename CharT>
+std::basic_string<CharT> utf8ToUtfN( const char *utf8Str, size_t lengthInBytes )
+{
+	// a UTF-8 sequence never yields more code units than it has bytes
+	std::basic_string<CharT> result( lengthInBytes, 0 );
+	CharT *out = &result[0];
+	const char *it = utf8Str, *end = utf8Str + lengthInBytes;
+	while( it != end ) {
+		size_t asciiLength = asciiPrefixLength( it, end - it );
+		const unsigned char *ascii = reinterpret_cast<const unsigned char*>( it );
+		out = std::copy( ascii, ascii + asciiLength, out );
+		it += asciiLength;
+		while( it != end && static_cast<unsigned char>( *it ) >= 0x80 )
+			out = appendCodePoint( utf8::next( it, end ), out );
+	}
+
+	result.resize( out - result.data() );
+	return result;
+}
+
+template<typename CharT>
+void appendUtf8( const CharT *begin, const CharT *end, std::string *result );
+
+template<>
+void appendUtf8( const char16_t *begin, const char16_t *end, std::string *result )
+{
+	utf8::utf16to8( begin, end, back_inserter( *result ) );
+}
+
+template<>
+void appendUtf8( const char32_t *begin, const char32_t *end, std::string *result )
+{
+	utf8::utf32to8( begin, end, back_inserter( *result ) );
+}
+
+template<typename CharT>
+std::string utfNToUtf8( const CharT *str, size_t length )
+{
+	std::string result;
+	result.reserve( length );
+	const CharT *it = str, *end = str + length;
+	while( it != end ) {
+		size_t asciiLength = asciiPrefixLength( it, end - it );
+		if( asciiLength ) {
+			size_t offset = result.size();
+			result.resize( offset + asciiLength );
+			std::transform( it, it + asciiLength, &result[offset], []( CharT c ) { return static_cast<char>( c ); } );
+			it += asciiLength;
+		}
+		const CharT *runEnd = it;
+		while( runEnd != end && *runEnd >= 0x80 )
+			++runEnd;
+		appendUtf8( it, runEnd, &result );
+		it = runEnd;
+	}
+
+	return result;
+}
+
+// Returns the length of the prefix of \a str that doesn't end partway through a sequence
+size_t completeUtfLength( const char *str, size_t length )
+{
+	size_t lead = length;
+	while( lead > 0 && length - lead < 4 && ( static_cast<unsigned char>( str[lead - 1] ) & 0xC0 ) == 0x80 )
+		--lead;
+	if( lead == 0 )
+		return length;
+	size_t sequenceLength = utf8::internal::sequence_length( str + lead - 1 );
+	return ( lead - 1 + std::max<size_t>( sequenceLength, 1 ) > length ) ? lead - 1 : length;
+}
+
+size_t completeUtfLength( const char16_t *str, size_t length )
+{
+	return ( length > 0 && utf8::internal::is_lead_surrogate( str[length - 1] ) ) ? length - 1 : length;
+}
+
+size_t completeUtfLength( const char32_t * /*str*/, size_t length )
+{
+	return length;
+}
+
+// Reads \a input in chunks of whole SrcT sequences, converting each with \a convertFn and writing the result to \a output
+template<typename SrcT, typename ConvertFn>
+void transcodeStream( const IStreamRef &input, const OStreamRef &output, ConvertFn convertFn )
+{
+	const size_t chunkUnits = 16 * 1024;
+	std::vector<SrcT> chunk( chunkUnits );
+	size_t carriedBytes = 0; // bytes of an incomplete sequence held over from the previous chunk
+	bool eof = false;
+	while( ! eof ) {
+		uint8_t *chunkBytes = reinterpret_cast<uint8_t*>( chunk.data() );
+		size_t bytesRead = carriedBytes;
+		while( bytesRead < chunkUnits * sizeof( SrcT ) ) {
+			size_t n = input->isEof() ? 0 : input->readDataAvailable( chunkBytes + bytesRead, chunkUnits * sizeof( SrcT ) - bytesRead );
+			if( n == 0 ) {
+				eof = true;
+				break;
+			}
+			bytesRead += n;
+		}
+
+		size_t units = bytesRead / sizeof( SrcT );
+		size_t completeUnits = eof ? units : completeUtfLength( chunk.data(), units );
+		if( eof && units * sizeof( SrcT ) != bytesRead )
+			throw StreamExc( "Input ends partway through a code unit" );
+
+		const auto converted = convertFn( chunk.data(), completeUnits );
+		if( ! converted.empty() )
+			output->writeData( converted.data(), converted.size() * sizeof( converted[0] ) );
+
+		carriedBytes = bytesRead - completeUnits * sizeof( SrcT );
+		memmove( chunkBytes, chunkBytes + completeUnits * sizeof( SrcT ), carriedBytes );
+	}
+}
+
+} // anonymous namespace
+
 std::u16string toUtf16( const char *utf8Str, size_t lengthInBytes )
 {
 	if( lengthInBytes == 0 )
 		lengthInBytes = strlen( utf8Str );
-	
-	std::u16string result;
-	utf8::utf8to16( utf8Str, utf8Str + lengthInBytes, back_inserter( result ));
-	return result;
+
+	return utf8ToUtfN<char16_t>( utf8Str, lengthInBytes );
 }
 
 std::u16string toUtf16( const std::string &utf8Str )
 {
-	std::u16string result;
-	utf8::utf8to16( utf8Str.begin(), utf8Str.end(), back_inserter( result ));
-	return result;
+	return utf8ToUtfN<char16_t>( utf8Str.data(), utf8Str.size() );
 }
 
 std::u32string toUtf32( const char *utf8Str, size_t lengthInBytes )
 {
 	if( lengthInBytes == 0 )
 		lengthInBytes = strlen( utf8Str );
-	
-	std::u32string result;
-	utf8::utf8to32( utf8Str, utf8Str + lengthInBytes, back_inserter( result ));
-	return result;
+
+	return utf8ToUtfN<char32_t>( utf8Str, lengthInBytes );
 }
 
 std::u32string toUtf32( const std::string &utf8Str )
 {
-	std::u32string result;
-	utf8::utf8to32( utf8Str.begin(), utf8Str.end(), back_inserter( result ));
-	return result;
+	return utf8ToUtfN<char32_t>( utf8Str.data(), utf8Str.size() );
 }
 
 std::string toUtf8( const char16_t *utf16Str, size_t lengthInBytes )
@@ -114,16 +310,12 @@ std::string toUtf8( const char16_t *utf16Str, size_t lengthInBytes )
 	else
 		lengthInBytes /= 2;
 
-	std::string result;
-	utf8::utf16to8( utf16Str, utf16Str + lengthInBytes, back_inserter( result ));
-	return result;	
+	return utfNToUtf8( utf16Str, lengthInBytes );
 }
 
 std::string	toUtf8( const std::u16string &utf16Str )
 {
-	std::string result;
-	utf8::utf16to8( utf16Str.begin(), utf16Str.end(), back_inserter( result ));
-	return result;
+	return utfNToUtf8( utf16Str.data(), utf16Str.size() );
 }
 
 std::string toUtf8( const char32_t *utf32Str, size_t lengthInBytes )
@@ -134,16 +326,51 @@ std::string toUtf8( const char32_t *utf32Str, size_t lengthInBytes )
 	else
 		lengthInBytes /= 4;
 
-	std::string result;
-	utf8::utf32to8( utf32Str, utf32Str + lengthInBytes, back_inserter( result ));
-	return result;
+	return utfNToUtf8( utf32Str, lengthInBytes );
 }
 
 std::string	toUtf8( const std::u32string &utf32Str )
 {
-	std::string result;
-	utf8::utf32to8( utf32Str.begin(), utf32Str.end(), back_inserter( result ));
-	return result;
+	return utfNToUtf8( utf32Str.data(), utf32Str.size() );
+}
+
+void transcodeUtf8ToUtf16( const IStreamRef &utf8Input, const OStreamRef &utf16Output )
+{
+	transcodeStream<char>( utf8Input, utf16Output, []( const char *str, size_t length ) { return utf8ToUtfN<char16_t>( str, length ); } );
+}
+
+void transcodeUtf8ToUtf32( const IStreamRef &utf8Input, const OStreamRef &utf32Output )
+{
+	transcodeStream<char>( utf8Input, utf32Output, []( const char *str, size_t length ) { return utf8ToUtfN<char32_t>( str, length ); } );
+}
+
+void transcodeUtf16ToUtf8( const IStreamRef &utf16Input, const OStreamRef &utf8Output )
+{
+	transcodeStream<char16_t>( utf16Input, utf8Output, []( const char16_t *str, size_t length ) { return utfNToUtf8( str, length ); } );
+}
+
+void transcodeUtf32ToUtf8( const IStreamRef &utf32Input, const OStreamRef &utf8Output )
+{
+	transcodeStream<char32_t>( utf32Input, utf8Output, []( const char32_t *str, size_t length ) { return utfNToUtf8( str, length ); } );
+}
+
+bool isValidUtf8( const char *str, size_t lengthInBytes )
+{
+	if( lengthInBytes == 0 )
+		lengthInBytes = strlen( str );
+
+	const char *it = str, *end = str + lengthInBytes;
+	while( it != end ) {
+		it += asciiPrefixLength( it, end - it );
+		const char *runEnd = it;
+		while( runEnd != end && static_cast<unsigned char>( *runEnd ) >= 0x80 )
+			++runEnd;
+		if( utf8::find_invalid( it, runEnd ) != runEnd )
+			return false;
+		it = runEnd;
+	}
+
+	return true;
 }
 
 size_t stringLengthUtf8( const char *str, size_t lengthInBytes )
@@ -27,6 +27,7 @@
 #include "cinder/ImageSourceFileStbImage.h"
 #include "cinder/ImageTargetFileStbImage.h"
 #include "cinder/ImageFileTinyExr.h"
+#include "cinder/ImageFileCimg.h"
 #include "cinder/Utilities.h"
 #include "cinder/Log.h"
 
@@ -60,6 +61,8 @@ PlatformLinux::PlatformLinux()
 	ImageTargetFileStbImage::registerSelf();
 	ImageSourceFileTinyExr::registerSelf();
 	ImageTargetFileTinyExr::registerSelf();
+	ImageSourceFileCimg::registerSelf();
+	ImageTargetFileCimg::registerSelf();
 }
 
 PlatformLinux::~PlatformLinux()
@@ -32,6 +32,7 @@
 #include "cinder/ImageFileTinyExr.h"
 #include "cinder/ImageSourceFileStbImage.h"
 #include "cinder/ImageTargetFileStbImage.h"
+#include "cinder/ImageFileCimg.h"
 
 #include <windows.h>
 #include <Shlwapi.h>
@@ -73,6 +74,8 @@ PlatformMsw::PlatformMsw()
 	ImageTargetFileTinyExr::registerSelf();
 	ImageSourceFileStbImage::registerSelf();
 	ImageTargetFileStbImage::registerSelf();
+	ImageSourceFileCimg::registerSelf();
+	ImageTargetFileCimg::registerSelf();
 }
 
 DataSourceRef PlatformMsw::loadResource( const fs::path &resourcePath, int mswID, const std::string &mswType )
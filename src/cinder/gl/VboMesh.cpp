@@ -255,34 +255,34 @@ void VboMesh::Layout::allocate( size_t numVertices, geom::BufferLayout *resultBu
 
 ///////////////////////////////////////////////////////////////////////////////////////
 // VboMesh
-VboMeshRef VboMesh::create( const geom::Source &source )
+VboMeshRef VboMesh::create( const geom::Source &source, geom::SourceCache *cache )
 {
 	// Pass an empty std::vector<pair<Layout,VboRef>> to imply we want to pull data from the Source
-	return VboMeshRef( new VboMesh( source, std::vector<pair<Layout,VboRef>>(), VboRef() ) );
+	return VboMeshRef( new VboMesh( source, std::vector<pair<Layout,VboRef>>(), VboRef(), cache ) );
 }
 
-VboMeshRef VboMesh::create( const geom::Source &source, const geom::AttribSet &requestedAttribs )
+VboMeshRef VboMesh::create( const geom::Source &source, const geom::AttribSet &requestedAttribs, geom::SourceCache *cache )
 {
 	// make an interleaved VboMesh::Layout with 'requestedAttribs'
 	Layout layout;
 	for( const auto &attrib : requestedAttribs )
 		layout.attrib( attrib, 0 ); // 0 dim implies querying the Source for its dimension
 	
-	return VboMeshRef( new VboMesh( source, { { layout, nullptr } }, nullptr ) );
+	return VboMeshRef( new VboMesh( source, { { layout, nullptr } }, nullptr, cache ) );
 }
 
-VboMeshRef VboMesh::create( const geom::Source &source, const std::vector<VboMesh::Layout> &vertexArrayLayouts )
+VboMeshRef VboMesh::create( const geom::Source &source, const std::vector<VboMesh::Layout> &vertexArrayLayouts, geom::SourceCache *cache )
 {
 	std::vector<std::pair<VboMesh::Layout,VboRef>> layoutVbos;
 	for( const auto &vertexArrayLayout : vertexArrayLayouts )
 		layoutVbos.push_back( std::make_pair( vertexArrayLayout, (VboRef)nullptr ) );
 
-	return VboMeshRef( new VboMesh( source, layoutVbos, nullptr ) );
+	return VboMeshRef( new VboMesh( source, layoutVbos, nullptr, cache ) );
 }
 
-VboMeshRef VboMesh::create( const geom::Source &source, const std::vector<std::pair<VboMesh::Layout,VboRef>> &vertexArrayLayouts, const VboRef &indexVbo )
+VboMeshRef VboMesh::create( const geom::Source &source, const std::vector<std::pair<VboMesh::Layout,VboRef>> &vertexArrayLayouts, const VboRef &indexVbo, geom::SourceCache *cache )
 {
-	return VboMeshRef( new VboMesh( source, vertexArrayLayouts, indexVbo ) );
+	return VboMeshRef( new VboMesh( source, vertexArrayLayouts, indexVbo, cache ) );
 }
 
 VboMeshRef VboMesh::create( uint32_t numVertices, GLenum glPrimitive, const std::vector<pair<geom::BufferLayout,VboRef>> &vertexArrayBuffers, uint32_t numIndices, GLenum indexType, const VboRef &indexVbo )
@@ -295,7 +295,7 @@ VboMeshRef VboMesh::create( uint32_t numVertices, GLenum glPrimitive, const std:
 	return VboMeshRef( new VboMesh( numVertices, numIndices, glPrimitive, indexType, vertexArrayLayouts, indexVbo ) );
 }
 
-VboMesh::VboMesh( const geom::Source &source, std::vector<pair<Layout,VboRef>> vertexArrayBuffers, const VboRef &indexArrayVbo )
+VboMesh::VboMesh( const geom::Source &source, std::vector<pair<Layout,VboRef>> vertexArrayBuffers, const VboRef &indexArrayVbo, geom::SourceCache *cache )
 {
 	// An empty vertexArrayBuffers implies we should just pull whatever attribs the Source is pushing. We arrived here from VboMesh::create( Source& )
 	if( vertexArrayBuffers.empty() ) {
@@ -339,7 +339,10 @@ VboMesh::VboMesh( const geom::Source &source, std::vector<pair<Layout,VboRef>> v
 	mIndices = indexArrayVbo;
 	
 	VboMeshGeomTarget target( source.getPrimitive(), this );
-	source.loadInto( &target, requestedAttribs );
+	if( cache )
+		cache->loadInto( source, &target, requestedAttribs );
+	else
+		source.loadInto( &target, requestedAttribs );
 	// we need to let the target know it can copy from its internal buffers to our vertexData VBOs
 	target.copyBuffers();
 }
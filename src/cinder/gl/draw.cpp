@@ -326,9 +326,12 @@ void draw( const TextureRef &texture, const vec2 &dstOffset )
 	draw( texture, texture->getBounds(), Rectf( texture->getBounds() ) + dstOffset );
 }
 
-void draw( const Path2d &path, float approximationScale )
+namespace {
+
+//! Draws the line strips of \a points delimited by \a contourOffsets from a single upload
+void drawLineStrips( const vector<vec2> &points, const vector<uint32_t> &contourOffsets )
 {
-	if( path.getNumSegments() == 0 || path.getNumPoints() == 0 )
+	if( points.empty() )
 		return;
 
 	auto ctx = context();
@@ -338,7 +341,6 @@ void draw( const Path2d &path, float approximationScale )
 		return;
 	}
 
-	vector<vec2> points = path.subdivide( approximationScale );
 	VboRef arrayVbo = ctx->getDefaultArrayVbo( sizeof(vec2) * points.size() );
 	arrayVbo->bufferSubData( 0, sizeof(vec2) * points.size(), points.data() );
 
@@ -353,14 +355,34 @@ void draw( const Path2d &path, float approximationScale )
 
 	ctx->getDefaultVao()->replacementBindEnd();
 	ctx->setDefaultShaderVars();
-	ctx->drawArrays( GL_LINE_STRIP, 0, (GLsizei)points.size() );
+	for( size_t c = 0; c + 1 < contourOffsets.size(); ++c )
+		ctx->drawArrays( GL_LINE_STRIP, (GLint)contourOffsets[c], (GLsizei)( contourOffsets[c + 1] - contourOffsets[c] ) );
 	ctx->popVao();
 }
 
+} // anonymous namespace
+
+void draw( const Path2d &path, float approximationScale )
+{
+	if( path.getNumSegments() == 0 || path.getNumPoints() == 0 )
+		return;
+
+	vector<vec2> points;
+	path.flatten( &points, approximationScale );
+	drawLineStrips( points, { 0, (uint32_t)points.size() } );
+}
+
 void draw( const Shape2d &shape, float approximationScale )
 {
-	for( const auto &path : shape.getContours() )
-		gl::draw( path, approximationScale );
+	vector<vec2> points;
+	vector<uint32_t> contourOffsets;
+	shape.flatten( &points, &contourOffsets, approximationScale );
+	drawLineStrips( points, contourOffsets );
+}
+
+void draw( const Shape2dFlattenCache &shape )
+{
+	drawLineStrips( shape.getPoints(), shape.getContourOffsets() );
 }
 
 void draw( const PolyLine2 &polyLine )
@@ -599,7 +621,7 @@ class DefaultVboTarget : public geom::Target {
 
 } // anonymous namespace
 
-void draw( const geom::Source &source )
+void draw( const geom::Source &source, geom::SourceCache *cache )
 {
 	auto ctx = context();
 	auto curGlslProg = ctx->getGlslProg();
@@ -619,7 +641,10 @@ void draw( const geom::Source &source )
 	ctx->getDefaultVao()->replacementBindBegin();
 
 	DefaultVboTarget target( &source );
-	source.loadInto( &target, requestedAttribs );
+	if( cache )
+		cache->loadInto( source, &target, requestedAttribs );
+	else
+		source.loadInto( &target, requestedAttribs );
 
 	ctx->getDefaultVao()->replacementBindEnd();
 
@@ -907,14 +932,23 @@ void drawVerticalCross( const gl::TextureCubeMapRef &texture, const Rectf &rect,
 	drawCrossImpl( texture, positions, texCoords, lod );
 }
 
-void drawSolid( const Path2d &path, float /*approximationScale*/ )
+namespace {
+// shapes drawn every frame are only tesselated on their first two draws, while shapes that change every frame are never cached
+TriangulatorCache& getDrawSolidCache()
+{
+	static TriangulatorCache cache( 256, true );
+	return cache;
+}
+} // anonymous namespace
+
+void drawSolid( const Path2d &path, float approximationScale )
 {
-	draw( Triangulator( path ).calcMesh() );
+	draw( *getDrawSolidCache().get( path, approximationScale ) );
 }
 
-void drawSolid( const Shape2d &shape, float /*approximationScale*/ )
+void drawSolid( const Shape2d &shape, float approximationScale )
 {
-	draw( Triangulator( shape ).calcMesh() );
+	draw( *getDrawSolidCache().get( shape, approximationScale ) );
 }
 
 void drawSolid( const PolyLine2 &polyLine )
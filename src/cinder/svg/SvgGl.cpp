@@ -0,0 +1,363 @@
+/*
+ Copyright (c) 2024, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/svg/SvgGl.h"
+#include "cinder/gl/scoped.h"
+#include "cinder/gl/Shader.h"
+#include "cinder/GeomIo.h"
+#include "cinder/Thread.h"
+#include "cinder/TriMesh.h"
+
+#include <limits>
+
+using namespace std;
+
+namespace cinder { namespace svg {
+
+namespace {
+
+bool operator==( const Paint &a, const Paint &b )
+{
+	return a.mType == b.mType && a.mStops == b.mStops && a.mCoords0 == b.mCoords0 && a.mCoords1 == b.mCoords1 && a.mRadius == b.mRadius
+		&& a.mUseObjectBoundingBox == b.mUseObjectBoundingBox && a.mSpecifiesTransform == b.mSpecifiesTransform && a.mTransform == b.mTransform;
+}
+
+bool operator!=( const Paint &a, const Paint &b )
+{
+	return ! ( a == b );
+}
+
+//! Evaluates a Paint at points in the coordinates of the node it fills or strokes
+class PaintEvaluator {
+  public:
+	PaintEvaluator( const Paint &paint, float opacity, const Rectf &bounds )
+		: mPaint( paint ), mOpacity( opacity ), mGradient( ( paint.isLinearGradient() || paint.isRadialGradient() ) && paint.getNumColors() > 0 )
+	{
+		// maps points into the space of the gradient's coordinates
+		mToGradient = mat3();
+		if( paint.useObjectBoundingBox() ) {
+			const vec2 size = glm::max( bounds.getSize(), vec2( 1e-6f ) );
+			mToGradient = mat3( 1 / size.x, 0, 0, 0, 1 / size.y, 0, -bounds.x1 / size.x, -bounds.y1 / size.y, 1 );
+		}
+		if( paint.specifiesTransform() )
+			mToGradient = inverse( paint.getTransform() ) * mToGradient;
+		if( ! mGradient && paint.getNumColors() > 0 )
+			mColor = calcStopColor( 0 );
+	}
+
+	ColorAf operator()( const vec2 &pt ) const
+	{
+		if( ! mGradient )
+			return mColor;
+
+		const vec2 p = vec2( mToGradient * vec3( pt, 1 ) );
+		float t;
+		if( mPaint.isLinearGradient() ) {
+			const vec2 dir = mPaint.getCoords1() - mPaint.getCoords0();
+			const float lengthSquared = dot( dir, dir );
+			t = ( lengthSquared > 0 ) ? dot( p - mPaint.getCoords0(), dir ) / lengthSquared : 1.0f;
+		}
+		else
+			t = ( mPaint.getRadius() > 0 ) ? distance( p, mPaint.getCoords0() ) / mPaint.getRadius() : 1.0f;
+
+		if( t <= mPaint.getOffset( 0 ) )
+			return calcStopColor( 0 );
+		for( size_t s = 1; s < mPaint.getNumColors(); ++s ) {
+			if( t < mPaint.getOffset( s ) ) {
+				const float range = mPaint.getOffset( s ) - mPaint.getOffset( s - 1 );
+				const float f = ( range > 0 ) ? ( t - mPaint.getOffset( s - 1 ) ) / range : 1.0f;
+				return calcStopColor( s - 1 ).lerp( f, calcStopColor( s ) );
+			}
+		}
+		return calcStopColor( mPaint.getNumColors() - 1 );
+	}
+
+  private:
+	ColorAf calcStopColor( size_t idx ) const
+	{
+		ColorAf result( mPaint.getColor( idx ) );
+		result.a *= mOpacity;
+		return result;
+	}
+
+	const Paint		&mPaint;
+	float			mOpacity;
+	bool			mGradient;
+	mat3			mToGradient;
+	ColorAf			mColor;
+};
+
+const geom::Stroke::Join sStrokeJoins[] = { geom::Stroke::JOIN_MITER, geom::Stroke::JOIN_ROUND, geom::Stroke::JOIN_BEVEL };
+const geom::Stroke::Cap sStrokeCaps[] = { geom::Stroke::CAP_BUTT, geom::Stroke::CAP_ROUND, geom::Stroke::CAP_SQUARE };
+
+} // anonymous namespace
+
+DocMesh::DocMesh( const Doc &doc, float approximationScale )
+	: mDoc( doc ), mApproximationScale( approximationScale ), mDirtyPositionsBegin( numeric_limits<size_t>::max() ), mDirtyPositionsEnd( 0 ),
+		mDirtyColorsBegin( numeric_limits<size_t>::max() ), mDirtyColorsEnd( 0 ), mBuffersDirty( true )
+{
+	update();
+}
+
+void DocMesh::collectNodes( const Node &node, NodeStyle style, vector<NodeMesh> *result ) const
+{
+	const Style &nodeStyle = node.getStyle();
+	if( node.specifiesTransform() )
+		style.mTransform = style.mTransform * node.getTransform();
+	if( nodeStyle.specifiesFill() )
+		style.mFill = nodeStyle.getFill();
+	if( nodeStyle.specifiesStroke() )
+		style.mStroke = nodeStyle.getStroke();
+	if( nodeStyle.specifiesOpacity() )
+		style.mOpacity *= nodeStyle.getOpacity();
+	if( nodeStyle.specifiesFillOpacity() )
+		style.mFillOpacity = nodeStyle.getFillOpacity();
+	if( nodeStyle.specifiesStrokeOpacity() )
+		style.mStrokeOpacity = nodeStyle.getStrokeOpacity();
+	if( nodeStyle.specifiesStrokeWidth() )
+		style.mStrokeWidth = nodeStyle.getStrokeWidth();
+	if( nodeStyle.specifiesFillRule() )
+		style.mFillRule = nodeStyle.getFillRule();
+	if( nodeStyle.specifiesLineCap() )
+		style.mLineCap = nodeStyle.getLineCap();
+	if( nodeStyle.specifiesLineJoin() )
+		style.mLineJoin = nodeStyle.getLineJoin();
+	if( nodeStyle.specifiesVisible() )
+		style.mVisible = nodeStyle.isVisible();
+	// unlike visibility, display: none can't be overridden by descendants
+	style.mDisplayed = style.mDisplayed && ! nodeStyle.isDisplayNone();
+
+	if( auto group = dynamic_cast<const Group*>( &node ) ) {
+		for( auto child : group->getChildren() )
+			collectNodes( *child, style, result );
+	}
+	else if( auto use = dynamic_cast<const Use*>( &node ) ) {
+		if( use->getReferenced() )
+			collectNodes( *use->getReferenced(), style, result );
+	}
+	else if( dynamic_cast<const Path*>( &node ) || dynamic_cast<const Polygon*>( &node ) || dynamic_cast<const Polyline*>( &node ) || dynamic_cast<const Line*>( &node )
+		|| dynamic_cast<const Rect*>( &node ) || dynamic_cast<const Circle*>( &node ) || dynamic_cast<const Ellipse*>( &node ) ) {
+		result->emplace_back();
+		result->back().mNode = &node;
+		result->back().mStyle = style;
+		result->back().mDirty = true;
+	}
+}
+
+void DocMesh::tessellateNodes()
+{
+	parallelFor( mNodes.size(), [&]( size_t begin, size_t end ) {
+		for( size_t n = begin; n < end; ++n ) {
+			NodeMesh &node = mNodes[n];
+			if( ! node.mDirty )
+				continue;
+
+			const NodeStyle &style = node.mStyle;
+			const Shape2d shape = node.mNode->getShape();
+			node.mLocalBounds = shape.calcBoundingBox();
+			// flatten as finely as the node is scaled up by its transform
+			const float scale = mApproximationScale * std::max( length( vec2( style.mTransform[0] ) ), length( vec2( style.mTransform[1] ) ) );
+
+			node.mLocalPositions.clear();
+			node.mLocalIndices.clear();
+			if( ! style.mFill.isNone() && ! dynamic_cast<const Line*>( node.mNode ) ) {
+				const Triangulator::Winding winding = ( style.mFillRule == FILL_RULE_NONZERO ) ? Triangulator::WINDING_NONZERO : Triangulator::WINDING_ODD;
+				Triangulator( shape, scale ).calcMesh( &node.mLocalPositions, &node.mLocalIndices, winding );
+			}
+			node.mNumFillVertices = node.mLocalPositions.size();
+
+			if( ! style.mStroke.isNone() && style.mStrokeWidth > 0 ) {
+				geom::Stroke stroke;
+				stroke.width( style.mStrokeWidth ).join( sStrokeJoins[style.mLineJoin] ).cap( sStrokeCaps[style.mLineCap] ).approximationScale( scale ).append( shape );
+				const TriMesh strokeMesh( stroke, TriMesh::Format().positions( 2 ) );
+				const uint32_t firstVertex = (uint32_t)node.mLocalPositions.size();
+				node.mLocalPositions.insert( node.mLocalPositions.end(), strokeMesh.getPositions<2>(), strokeMesh.getPositions<2>() + strokeMesh.getNumVertices() );
+				for( uint32_t index : strokeMesh.getIndices() )
+					node.mLocalIndices.push_back( firstVertex + index );
+			}
+			node.mDirty = false;
+		}
+	}, 16 );
+}
+
+void DocMesh::layoutNodes()
+{
+	size_t numVertices = 0, numIndices = 0;
+	for( auto &node : mNodes ) {
+		node.mVertexOffset = numVertices;
+		node.mIndexOffset = numIndices;
+		numVertices += node.mLocalPositions.size();
+		numIndices += node.mLocalIndices.size();
+	}
+	mPositions.resize( numVertices );
+	mColors.resize( numVertices );
+	mIndices.resize( numIndices );
+
+	parallelFor( mNodes.size(), [&]( size_t begin, size_t end ) {
+		for( size_t n = begin; n < end; ++n ) {
+			const NodeMesh &node = mNodes[n];
+			for( size_t i = 0; i < node.mLocalIndices.size(); ++i )
+				mIndices[node.mIndexOffset + i] = (uint32_t)node.mVertexOffset + node.mLocalIndices[i];
+			updatePositions( node );
+			updateColors( node );
+		}
+	}, 64 );
+
+	mBuffersDirty = true;
+}
+
+void DocMesh::updatePositions( const NodeMesh &node )
+{
+	vec2 *positions = mPositions.data() + node.mVertexOffset;
+	// invisible nodes are collapsed into degenerate triangles, which rasterize nothing
+	if( ! ( node.mStyle.mVisible && node.mStyle.mDisplayed ) ) {
+		std::fill( positions, positions + node.mLocalPositions.size(), vec2( 0 ) );
+		return;
+	}
+
+	const mat3 &transform = node.mStyle.mTransform;
+	for( size_t v = 0; v < node.mLocalPositions.size(); ++v )
+		positions[v] = vec2( transform * vec3( node.mLocalPositions[v], 1 ) );
+}
+
+void DocMesh::updateColors( const NodeMesh &node )
+{
+	const NodeStyle &style = node.mStyle;
+	ColorAf *colors = mColors.data() + node.mVertexOffset;
+
+	const PaintEvaluator fill( style.mFill, style.mOpacity * style.mFillOpacity, node.mLocalBounds );
+	for( size_t v = 0; v < node.mNumFillVertices; ++v )
+		colors[v] = fill( node.mLocalPositions[v] );
+
+	const PaintEvaluator stroke( style.mStroke, style.mOpacity * style.mStrokeOpacity, node.mLocalBounds );
+	for( size_t v = node.mNumFillVertices; v < node.mLocalPositions.size(); ++v )
+		colors[v] = stroke( node.mLocalPositions[v] );
+}
+
+void DocMesh::markDirty( const Node *node )
+{
+	for( auto &nodeMesh : mNodes )
+		if( nodeMesh.mNode == node )
+			nodeMesh.mDirty = true;
+}
+
+void DocMesh::update()
+{
+	NodeStyle rootStyle;
+	rootStyle.mFill = Style::getFillDefault();
+	rootStyle.mStroke = Style::getStrokeDefault();
+	rootStyle.mOpacity = Style::getOpacityDefault();
+	rootStyle.mFillOpacity = Style::getFillOpacityDefault();
+	rootStyle.mStrokeOpacity = Style::getStrokeOpacityDefault();
+	rootStyle.mStrokeWidth = Style::getStrokeWidthDefault();
+	rootStyle.mFillRule = Style::getFillRuleDefault();
+	rootStyle.mLineCap = Style::getLineCapDefault();
+	rootStyle.mLineJoin = Style::getLineJoinDefault();
+	rootStyle.mVisible = rootStyle.mDisplayed = true;
+
+	vector<NodeMesh> nodes;
+	nodes.reserve( mNodes.size() );
+	collectNodes( mDoc, rootStyle, &nodes );
+
+	bool sameNodes = nodes.size() == mNodes.size();
+	for( size_t n = 0; sameNodes && n < nodes.size(); ++n )
+		sameNodes = nodes[n].mNode == mNodes[n].mNode;
+	if( ! sameNodes ) {
+		mNodes = std::move( nodes );
+		tessellateNodes();
+		layoutNodes();
+		return;
+	}
+
+	vector<size_t> movedNodes, repaintedNodes;
+	bool retessellate = false;
+	for( size_t n = 0; n < nodes.size(); ++n ) {
+		NodeMesh &node = mNodes[n];
+		const NodeStyle &prev = node.mStyle, &cur = nodes[n].mStyle;
+		if( prev.mFill.isNone() != cur.mFill.isNone() || prev.mStroke.isNone() != cur.mStroke.isNone() || prev.mStrokeWidth != cur.mStrokeWidth
+			|| prev.mFillRule != cur.mFillRule || prev.mLineCap != cur.mLineCap || prev.mLineJoin != cur.mLineJoin )
+			node.mDirty = true;
+		retessellate = retessellate || node.mDirty;
+		if( prev.mTransform != cur.mTransform || prev.mVisible != cur.mVisible || prev.mDisplayed != cur.mDisplayed )
+			movedNodes.push_back( n );
+		if( prev.mFill != cur.mFill || prev.mStroke != cur.mStroke || prev.mOpacity != cur.mOpacity || prev.mFillOpacity != cur.mFillOpacity || prev.mStrokeOpacity != cur.mStrokeOpacity )
+			repaintedNodes.push_back( n );
+		node.mStyle = cur;
+	}
+
+	// re-tessellated nodes may have changed size, shifting everything after them
+	if( retessellate ) {
+		tessellateNodes();
+		layoutNodes();
+		return;
+	}
+
+	for( size_t n : movedNodes ) {
+		updatePositions( mNodes[n] );
+		mDirtyPositionsBegin = std::min( mDirtyPositionsBegin, mNodes[n].mVertexOffset );
+		mDirtyPositionsEnd = std::max( mDirtyPositionsEnd, mNodes[n].mVertexOffset + mNodes[n].mLocalPositions.size() );
+	}
+	for( size_t n : repaintedNodes ) {
+		updateColors( mNodes[n] );
+		mDirtyColorsBegin = std::min( mDirtyColorsBegin, mNodes[n].mVertexOffset );
+		mDirtyColorsEnd = std::max( mDirtyColorsEnd, mNodes[n].mVertexOffset + mNodes[n].mLocalPositions.size() );
+	}
+}
+
+gl::BatchRef DocMesh::getBatch()
+{
+	if( mBuffersDirty ) {
+		mPositionVbo = gl::Vbo::create( GL_ARRAY_BUFFER, mPositions, GL_DYNAMIC_DRAW );
+		mColorVbo = gl::Vbo::create( GL_ARRAY_BUFFER, mColors, GL_DYNAMIC_DRAW );
+		auto indexVbo = gl::Vbo::create( GL_ELEMENT_ARRAY_BUFFER, mIndices );
+
+		geom::BufferLayout positionLayout, colorLayout;
+		positionLayout.append( geom::Attrib::POSITION, 2, 0, 0 );
+		colorLayout.append( geom::Attrib::COLOR, 4, 0, 0 );
+		auto vboMesh = gl::VboMesh::create( (uint32_t)mPositions.size(), GL_TRIANGLES, { { positionLayout, mPositionVbo }, { colorLayout, mColorVbo } },
+											(uint32_t)mIndices.size(), GL_UNSIGNED_INT, indexVbo );
+		mBatch = gl::Batch::create( vboMesh, gl::getStockShader( gl::ShaderDef().color() ) );
+		mBuffersDirty = false;
+	}
+	else {
+		if( mDirtyPositionsBegin < mDirtyPositionsEnd )
+			mPositionVbo->bufferSubData( mDirtyPositionsBegin * sizeof( vec2 ), ( mDirtyPositionsEnd - mDirtyPositionsBegin ) * sizeof( vec2 ), &mPositions[mDirtyPositionsBegin] );
+		if( mDirtyColorsBegin < mDirtyColorsEnd )
+			mColorVbo->bufferSubData( mDirtyColorsBegin * sizeof( ColorAf ), ( mDirtyColorsEnd - mDirtyColorsBegin ) * sizeof( ColorAf ), &mColors[mDirtyColorsBegin] );
+	}
+
+	mDirtyPositionsBegin = mDirtyColorsBegin = std::numeric_limits<size_t>::max();
+	mDirtyPositionsEnd = mDirtyColorsEnd = 0;
+	return mBatch;
+}
+
+void DocMesh::draw()
+{
+	auto batch = getBatch();
+	if( ! mIndices.empty() ) {
+		gl::ScopedBlendAlpha blendScope;
+		batch->draw();
+	}
+}
+
+} } // namespace cinder::svg
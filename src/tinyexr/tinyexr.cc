@@ -1,2 +1,3 @@
 #define TINYEXR_IMPLEMENTATION
+#define TINYEXR_USE_THREAD 1
 #include "tinyexr.h"
@@ -0,0 +1,83 @@
+// Reports deflate throughput of compressBuffer() versus the chunked, multi-core compressBufferChunked() and the
+// CompressingOStream / DecompressingIStream pair. Pass the data size in megabytes as the first argument, e.g. CompressionBenchmark 512
+
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/Buffer.h"
+#include "cinder/Stream.h"
+#include "cinder/Thread.h"
+#include "cinder/Timer.h"
+#include "cinder/Utilities.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+class CompressionBenchmarkApp : public App {
+  public:
+	void setup() override;
+	void draw() override;
+
+	void	benchmark( const std::string &name, size_t numBytes, const std::function<size_t()> &fn );
+
+	static void prepareSettings( App::Settings *settings ) { getArgs() = Platform::get()->getCommandLineArgs(); }
+	static vector<string>& getArgs() { static vector<string> args; return args; }
+};
+
+void CompressionBenchmarkApp::benchmark( const std::string &name, size_t numBytes, const std::function<size_t()> &fn )
+{
+	Timer timer( true );
+	size_t resultSize = fn();
+	double seconds = timer.getSeconds();
+	console() << "  " << name << ": " << numBytes / ( 1024.0 * 1024.0 ) / seconds << " MB/s, " << resultSize << " bytes" << std::endl;
+}
+
+void CompressionBenchmarkApp::setup()
+{
+	const size_t numBytes = ( ( getArgs().size() >= 2 ) ? fromString<size_t>( getArgs()[1] ) : 128 ) * 1024 * 1024;
+
+	// snapshot-like data: runs of slowly varying values interleaved with noise
+	Buffer input( numBytes );
+	uint32_t *values = reinterpret_cast<uint32_t*>( input.getData() );
+	uint32_t state = 1;
+	for( size_t i = 0; i < numBytes / 4; ++i ) {
+		state = state * 1664525 + 1013904223;
+		values[i] = ( i % 4 == 3 ) ? state : (uint32_t)( i / 256 );
+	}
+
+	console() << "Deflate " << numBytes / ( 1024 * 1024 ) << "MB, " << getNumParallelThreads() << " threads" << std::endl;
+	for( int8_t level : { 1, 6 } ) {
+		console() << " level " << (int)level << std::endl;
+		Buffer compressed;
+		benchmark( "compressBuffer", numBytes, [&] { return compressBuffer( input, level ).getSize(); } );
+		benchmark( "compressBufferChunked", numBytes, [&] { compressed = compressBufferChunked( input, level ); return compressed.getSize(); } );
+		benchmark( "decompressBuffer", numBytes, [&] { return decompressBuffer( compressed ).getSize(); } );
+
+		auto memStream = OStreamMem::create( numBytes / 2 );
+		benchmark( "CompressingOStream (1MB writes)", numBytes, [&] {
+			auto compressor = CompressingOStream::create( memStream, level );
+			for( size_t offset = 0; offset < numBytes; offset += 1024 * 1024 )
+				compressor->writeData( reinterpret_cast<const uint8_t*>( input.getData() ) + offset, std::min<size_t>( 1024 * 1024, numBytes - offset ) );
+			compressor->finish();
+			return (size_t)memStream->tell();
+		} );
+		benchmark( "DecompressingIStream (1MB reads)", numBytes, [&] {
+			auto decompressor = DecompressingIStream::create( IStreamMem::create( memStream->getBuffer(), (size_t)memStream->tell() ) );
+			vector<uint8_t> chunk( 1024 * 1024 );
+			size_t total = 0;
+			while( ! decompressor->isEof() )
+				total += decompressor->readDataAvailable( chunk.data(), chunk.size() );
+			return total;
+		} );
+	}
+
+	quit();
+}
+
+void CompressionBenchmarkApp::draw()
+{
+	gl::clear();
+}
+
+CINDER_APP( CompressionBenchmarkApp, RendererGl, &CompressionBenchmarkApp::prepareSettings )
@@ -0,0 +1,86 @@
+// Times OpenEXR writing and loading of a synthetic 8K RGBA image, including channel and area subsets.
+// Pass the image width as the first argument to benchmark a different size, e.g. ExrBenchmark 4096
+
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/ImageFileTinyExr.h"
+#include "cinder/Surface.h"
+#include "cinder/Thread.h"
+#include "cinder/Timer.h"
+#include "cinder/Utilities.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+class ExrBenchmarkApp : public App {
+  public:
+	void setup() override;
+	void draw() override;
+
+	void	benchmark( const std::string &name, const std::function<void()> &fn );
+
+	static void prepareSettings( App::Settings *settings ) { getArgs() = Platform::get()->getCommandLineArgs(); }
+	static vector<string>& getArgs() { static vector<string> args; return args; }
+};
+
+void ExrBenchmarkApp::benchmark( const std::string &name, const std::function<void()> &fn )
+{
+	Timer timer( true );
+	fn();
+	console() << "  " << name << ": " << timer.getSeconds() * 1000 << "ms" << std::endl;
+}
+
+void ExrBenchmarkApp::setup()
+{
+	int32_t width = ( getArgs().size() >= 2 ) ? fromString<int32_t>( getArgs()[1] ) : 7680;
+	int32_t height = width * 9 / 16;
+
+	Surface32f surface( width, height, true );
+	parallelFor( height, [&]( size_t begin, size_t end ) {
+		for( int32_t y = (int32_t)begin; y < (int32_t)end; ++y ) {
+			float *p = surface.getData( ivec2( 0, y ) );
+			for( int32_t x = 0; x < width; ++x, p += 4 ) {
+				p[0] = x / (float)width;
+				p[1] = y / (float)height;
+				p[2] = ( ( x ^ y ) & 0xFF ) / 255.0f;
+				p[3] = 1;
+			}
+		}
+	}, 16 );
+
+	console() << "OpenEXR " << width << "x" << height << " RGBA, " << getNumParallelThreads() << " threads" << std::endl;
+	const fs::path path = fs::temp_directory_path() / "cinder_ExrBenchmark.exr";
+
+	const pair<string, ImageTargetFileTinyExr::Compression> compressions[] = {
+		{ "NONE", ImageTargetFileTinyExr::COMPRESSION_NONE }, { "ZIP", ImageTargetFileTinyExr::COMPRESSION_ZIP }, { "PIZ", ImageTargetFileTinyExr::COMPRESSION_PIZ } };
+	for( const auto &compression : compressions ) {
+		console() << " " << compression.first << std::endl;
+		benchmark( "write", [&] {
+			auto exrOptions = ImageTargetFileTinyExr::ExrOptions().compression( compression.second );
+			writeImage( ImageTargetFileTinyExr::create( writeFile( path ), surface, ImageTarget::Options(), "exr", exrOptions ), surface );
+		} );
+		benchmark( "load all channels", [&] {
+			Surface32f result( ImageSourceFileTinyExr::create( loadFile( path ) ) );
+		} );
+		benchmark( "load channel G", [&] {
+			auto exrOptions = ImageSourceFileTinyExr::ExrOptions().channels( { "G" } );
+			Channel32f result( ImageSourceFileTinyExr::create( loadFile( path ), ImageSource::Options(), exrOptions ) );
+		} );
+		benchmark( "load 1/16th area", [&] {
+			auto exrOptions = ImageSourceFileTinyExr::ExrOptions().area( Area( 0, 0, width / 4, height / 4 ) );
+			Surface32f result( ImageSourceFileTinyExr::create( loadFile( path ), ImageSource::Options(), exrOptions ) );
+		} );
+	}
+
+	fs::remove( path );
+	quit();
+}
+
+void ExrBenchmarkApp::draw()
+{
+	gl::clear();
+}
+
+CINDER_APP( ExrBenchmarkApp, RendererGl, &ExrBenchmarkApp::prepareSettings )
@@ -0,0 +1,83 @@
+// Times ObjLoader parsing and TriMesh construction for a generated grid OBJ with positions, texcoords and normals.
+// Pass the grid resolution as the first argument to benchmark a different size, e.g. ObjLoaderBenchmark 500
+
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/ObjLoader.h"
+#include "cinder/Thread.h"
+#include "cinder/Timer.h"
+#include "cinder/TriMesh.h"
+#include "cinder/Utilities.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+class ObjLoaderBenchmarkApp : public App {
+  public:
+	void setup() override;
+	void draw() override;
+
+	void	benchmark( const std::string &name, const std::function<void()> &fn );
+
+	static void prepareSettings( App::Settings *settings ) { getArgs() = Platform::get()->getCommandLineArgs(); }
+	static vector<string>& getArgs() { static vector<string> args; return args; }
+};
+
+void ObjLoaderBenchmarkApp::benchmark( const std::string &name, const std::function<void()> &fn )
+{
+	Timer timer( true );
+	fn();
+	console() << "  " << name << ": " << timer.getSeconds() * 1000 << "ms" << std::endl;
+}
+
+void ObjLoaderBenchmarkApp::setup()
+{
+	const int res = ( getArgs().size() >= 2 ) ? fromString<int>( getArgs()[1] ) : 1000;
+
+	// a wavy grid; every vertex gets its own texcoord and normal so deduplication sees a realistic key mix
+	std::string data;
+	data.reserve( (size_t)( res + 1 ) * ( res + 1 ) * 110 + (size_t)res * res * 50 );
+	char line[128];
+	for( int y = 0; y <= res; ++y ) {
+		for( int x = 0; x <= res; ++x ) {
+			const float u = x / (float)res, v = y / (float)res;
+			const float h = sin( u * 20 ) * cos( v * 20 ) * 0.05f;
+			data.append( line, snprintf( line, sizeof( line ), "v %f %f %f\nvt %f %f\nvn %f %f 1\n", u, v, h, u, v, -h, h ) );
+		}
+	}
+	for( int y = 0; y < res; ++y ) {
+		for( int x = 0; x < res; ++x ) {
+			const int i = y * ( res + 1 ) + x + 1, j = i + res + 1;
+			data.append( line, snprintf( line, sizeof( line ), "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", i, i, i, i + 1, i + 1, i + 1, j + 1, j + 1, j + 1, j, j, j ) );
+		}
+	}
+
+	const fs::path path = fs::temp_directory_path() / "cinder_ObjLoaderBenchmark.obj";
+	writeFile( path )->getStream()->writeData( data.data(), data.size() );
+
+	console() << "OBJ " << res << "x" << res << " grid, " << res * res * 2 << " triangles, " << data.size() / ( 1024 * 1024 ) << "MB, " << getNumParallelThreads() << " threads" << std::endl;
+	std::unique_ptr<ObjLoader> loader;
+	benchmark( "parse file (mapped)", [&] {
+		loader.reset( new ObjLoader( loadFile( path ) ) );
+	} );
+	benchmark( "parse stream", [&] {
+		ObjLoader result( IStreamMem::create( data.data(), data.size() ) );
+	} );
+	TriMeshRef mesh;
+	benchmark( "build TriMesh", [&] {
+		mesh = TriMesh::create( *loader );
+	} );
+	console() << "  " << mesh->getNumVertices() << " unique vertices" << std::endl;
+
+	fs::remove( path );
+	quit();
+}
+
+void ObjLoaderBenchmarkApp::draw()
+{
+	gl::clear();
+}
+
+CINDER_APP( ObjLoaderBenchmarkApp, RendererGl, &ObjLoaderBenchmarkApp::prepareSettings )
@@ -0,0 +1,121 @@
+// Times KdTree against PointIndex for a flocking-style workload: rebuilding over a set of particles and querying each particle's neighbors.
+// Pass the particle count as the first argument to benchmark a different size, e.g. PointIndexBenchmark 20000
+
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/KdTree.h"
+#include "cinder/PointIndex.h"
+#include "cinder/Rand.h"
+#include "cinder/Thread.h"
+#include "cinder/Timer.h"
+#include "cinder/Utilities.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+namespace {
+
+// KdTree::lookup() passes its processor as const, so the tally has to be mutable
+struct CountingLookupProc {
+	CountingLookupProc() : mCount( 0 ) {}
+	void process( uint32_t id, float distSqrd, float &maxDistSqrd ) const { ++mCount; }
+
+	mutable size_t	mCount;
+};
+
+} // anonymous namespace
+
+class PointIndexBenchmarkApp : public App {
+  public:
+	void setup() override;
+	void draw() override;
+
+	void	benchmark( const std::string &name, const std::function<void()> &fn );
+
+	static void prepareSettings( App::Settings *settings ) { getArgs() = Platform::get()->getCommandLineArgs(); }
+	static vector<string>& getArgs() { static vector<string> args; return args; }
+};
+
+void PointIndexBenchmarkApp::benchmark( const std::string &name, const std::function<void()> &fn )
+{
+	Timer timer( true );
+	fn();
+	console() << "  " << name << ": " << timer.getSeconds() * 1000 << "ms" << std::endl;
+}
+
+void PointIndexBenchmarkApp::setup()
+{
+	const size_t numPoints = ( getArgs().size() >= 2 ) ? fromString<size_t>( getArgs()[1] ) : 100000;
+	const size_t k = 16;
+
+	// particles fill a unit cube; the radius is chosen so each one has around 20 neighbors
+	Rand rnd( 1234 );
+	std::vector<vec3> points( numPoints );
+	for( auto &point : points )
+		point = vec3( rnd.nextFloat(), rnd.nextFloat(), rnd.nextFloat() );
+	const float radius = std::cbrt( 20.0f / ( numPoints * 4.18879f ) );
+
+	console() << numPoints << " particles, " << getNumParallelThreads() << " threads" << std::endl;
+
+	size_t checksum = 0;
+	console() << "KdTree" << std::endl;
+	std::unique_ptr<KdTree<vec3, 3, CountingLookupProc>> kdTree;
+	benchmark( "build", [&] {
+		kdTree.reset( new KdTree<vec3, 3, CountingLookupProc>( points ) );
+	} );
+	benchmark( "nearest neighbor of each particle", [&] {
+		for( const auto &point : points ) {
+			float p[3] = { point.x + 1e-4f, point.y, point.z }, result[3];
+			uint32_t index;
+			kdTree->findNearest( p, result, &index );
+			checksum += index;
+		}
+	} );
+	benchmark( "neighbors within radius of each particle", [&] {
+		CountingLookupProc proc;
+		for( const auto &point : points )
+			kdTree->lookup( point, proc, radius );
+		checksum += proc.mCount;
+	} );
+
+	console() << "PointIndex" << std::endl;
+	PointIndex3 index;
+	benchmark( "build", [&] {
+		index.build( points );
+	} );
+	benchmark( "rebuild (reusing storage)", [&] {
+		index.build( points );
+	} );
+	benchmark( "nearest neighbor of each particle", [&] {
+		for( const auto &point : points )
+			checksum += index.findNearest( point + vec3( 1e-4f, 0, 0 ) );
+	} );
+	std::vector<PointIndex3::Neighbor> neighbors( numPoints * k );
+	std::vector<size_t> counts( numPoints );
+	benchmark( "neighbors within radius of each particle, batched", [&] {
+		index.findInRadius( points.data(), numPoints, radius, neighbors.data(), k, counts.data() );
+	} );
+	size_t numInRadius = 0;
+	for( size_t count : counts )
+		numInRadius += count;
+	console() << "  " << numInRadius / (double)numPoints << " neighbors per particle on average" << std::endl;
+	benchmark( to_string( k ) + " nearest neighbors of each particle, batched", [&] {
+		index.findNearest( points.data(), numPoints, k, neighbors.data() );
+	} );
+	benchmark( to_string( k ) + " nearest neighbors of each particle, one by one", [&] {
+		for( size_t i = 0; i < numPoints; ++i )
+			checksum += index.findNearest( points[i], k, neighbors.data() + i * k );
+	} );
+
+	console() << "(checksum " << checksum << ")" << std::endl;
+	quit();
+}
+
+void PointIndexBenchmarkApp::draw()
+{
+	gl::clear();
+}
+
+CINDER_APP( PointIndexBenchmarkApp, RendererGl, &PointIndexBenchmarkApp::prepareSettings )
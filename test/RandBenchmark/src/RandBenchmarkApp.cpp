@@ -0,0 +1,107 @@
+// Times Rand against FastRand for uniform floats, Gaussians and points on the sphere, one at a time and through the fill functions, and FastRand::threadLocal() across threads.
+// Pass the number of values in millions as the first argument to benchmark a different size, e.g. RandBenchmark 100
+
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/Rand.h"
+#include "cinder/Thread.h"
+#include "cinder/Timer.h"
+#include "cinder/Utilities.h"
+
+#include <numeric>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+class RandBenchmarkApp : public App {
+  public:
+	void setup() override;
+	void draw() override;
+
+	//! Prints the time \a fn takes and a checksum of \a values, which also keeps the generation from being optimized away
+	template<typename T>
+	void	benchmark( const std::string &name, vector<T> *values, const std::function<void()> &fn );
+
+	static void prepareSettings( App::Settings *settings ) { getArgs() = Platform::get()->getCommandLineArgs(); }
+	static vector<string>& getArgs() { static vector<string> args; return args; }
+};
+
+namespace {
+
+float checksum( const vector<float> &values )
+{
+	return std::accumulate( values.begin(), values.end(), 0.0f );
+}
+
+float checksum( const vector<vec3> &values )
+{
+	float result = 0;
+	for( const vec3 &v : values )
+		result += v.x + v.y + v.z;
+	return result;
+}
+
+} // anonymous namespace
+
+template<typename T>
+void RandBenchmarkApp::benchmark( const std::string &name, vector<T> *values, const std::function<void()> &fn )
+{
+	Timer timer( true );
+	fn();
+	const double seconds = timer.getSeconds();
+	console() << "  " << name << ": " << seconds * 1000 << "ms, " << values->size() / seconds / 1e6 << "M/s (checksum " << checksum( *values ) << ")" << std::endl;
+}
+
+void RandBenchmarkApp::setup()
+{
+	const size_t count = size_t( ( getArgs().size() >= 2 ) ? fromString<int>( getArgs()[1] ) : 20 ) * 1000000;
+	vector<float> floats( count );
+	vector<vec3> points( count / 4 );
+	Rand rand( 1234 );
+	FastRand fastRand( 1234 );
+
+	console() << "Uniform floats: " << count << std::endl;
+	benchmark( "Rand::nextFloat()", &floats, [&] { for( float &v : floats ) v = rand.nextFloat(); } );
+	benchmark( "randFloat()", &floats, [&] { for( float &v : floats ) v = randFloat(); } );
+	benchmark( "FastRand::nextFloat()", &floats, [&] { for( float &v : floats ) v = fastRand.nextFloat(); } );
+	benchmark( "FastRand::fill()", &floats, [&] { fastRand.fill( floats.data(), floats.size() ); } );
+
+	console() << "Gaussians: " << count << std::endl;
+	benchmark( "Rand::nextGaussian()", &floats, [&] { for( float &v : floats ) v = rand.nextGaussian(); } );
+	benchmark( "randGaussian()", &floats, [&] { for( float &v : floats ) v = randGaussian(); } );
+	benchmark( "FastRand::nextGaussian()", &floats, [&] { for( float &v : floats ) v = fastRand.nextGaussian(); } );
+	benchmark( "FastRand::fillGaussian()", &floats, [&] { fastRand.fillGaussian( floats.data(), floats.size() ); } );
+
+	console() << "Points on the unit sphere: " << points.size() << std::endl;
+	benchmark( "Rand::nextVec3()", &points, [&] { for( vec3 &v : points ) v = rand.nextVec3(); } );
+	benchmark( "FastRand::fillVec3OnSphere()", &points, [&] { fastRand.fillVec3OnSphere( points.data(), points.size() ); } );
+
+	console() << "Uniform floats across " << getNumParallelThreads() << " threads: " << count << std::endl;
+	benchmark( "FastRand::threadLocal().fill()", &floats, [&] {
+		parallelFor( floats.size(), [&]( size_t begin, size_t end ) {
+			FastRand::threadLocal().fill( floats.data() + begin, end - begin );
+		}, 1 << 16 );
+	} );
+	benchmark( "seedThreadLocal() per block, then fill()", &floats, [&] {
+		// seeding each fixed-size block by its index gives the same results however many threads run them, in whatever order
+		const size_t blockSize = 1 << 16, numBlocks = ( floats.size() + blockSize - 1 ) / blockSize;
+		parallelFor( numBlocks, [&]( size_t beginBlock, size_t endBlock ) {
+			for( size_t block = beginBlock; block < endBlock; ++block ) {
+				FastRand::seedThreadLocal( 1234, block );
+				const size_t begin = block * blockSize;
+				FastRand::threadLocal().fill( floats.data() + begin, std::min( blockSize, floats.size() - begin ) );
+			}
+		} );
+	} );
+
+	quit();
+}
+
+void RandBenchmarkApp::draw()
+{
+	gl::clear();
+}
+
+CINDER_APP( RandBenchmarkApp, RendererGl, &RandBenchmarkApp::prepareSettings )
@@ -0,0 +1,144 @@
+// Times Triangulator on font glyph outlines and on a generated SVG scene: one shape at a time, as a parallel batch, and through TriangulatorCache.
+// Pass the number of text lines as the first argument to benchmark a different size, e.g. TriangulateBenchmark 200
+
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/svg/Svg.h"
+#include "cinder/Font.h"
+#include "cinder/Rand.h"
+#include "cinder/Thread.h"
+#include "cinder/Timer.h"
+#include "cinder/Triangulate.h"
+#include "cinder/Utilities.h"
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+namespace {
+
+void collectShapes( const svg::Node *node, vector<Shape2d> *result )
+{
+	if( auto group = dynamic_cast<const svg::Group*>( node ) ) {
+		for( auto child : group->getChildren() )
+			collectShapes( child, result );
+	}
+	else
+		result->push_back( node->getShapeAbsolute() );
+}
+
+} // anonymous namespace
+
+class TriangulateBenchmarkApp : public App {
+  public:
+	void setup() override;
+	void draw() override;
+
+	void	benchmark( const std::string &name, const std::function<void()> &fn );
+	void	benchmarkShapes( const std::string &name, const vector<Shape2d> &shapes, const vector<Shape2d> &untranslatedShapes );
+
+	static void prepareSettings( App::Settings *settings ) { getArgs() = Platform::get()->getCommandLineArgs(); }
+	static vector<string>& getArgs() { static vector<string> args; return args; }
+};
+
+void TriangulateBenchmarkApp::benchmark( const std::string &name, const std::function<void()> &fn )
+{
+	Timer timer( true );
+	fn();
+	console() << "  " << name << ": " << timer.getSeconds() * 1000 << "ms" << std::endl;
+}
+
+// \a untranslatedShapes holds the same shapes before placement, which is what a renderer drawing each one under its own transform would triangulate
+void TriangulateBenchmarkApp::benchmarkShapes( const std::string &name, const vector<Shape2d> &shapes, const vector<Shape2d> &untranslatedShapes )
+{
+	size_t numPoints = 0;
+	for( const auto &shape : shapes )
+		for( const auto &contour : shape.getContours() )
+			numPoints += contour.calcNumFlattenedPoints( 1.0f );
+	console() << name << ": " << shapes.size() << " shapes, " << numPoints << " flattened points, " << getNumParallelThreads() << " threads" << std::endl;
+
+	size_t numTriangles = 0;
+	benchmark( "one at a time", [&] {
+		Triangulator triangulator;
+		for( const auto &shape : shapes ) {
+			triangulator.addShape( shape );
+			numTriangles += triangulator.calcMesh().getNumTriangles();
+		}
+	} );
+	Triangulator::Batch batch;
+	benchmark( "batch", [&] {
+		Triangulator::calcMeshes( shapes, &batch );
+	} );
+	console() << "  " << numTriangles << " triangles, " << batch.mIndices.size() / 3 << " in batch" << std::endl;
+
+	TriangulatorCache cache( untranslatedShapes.size() );
+	benchmark( "cache, first frame", [&] {
+		for( const auto &shape : untranslatedShapes )
+			cache.get( shape );
+	} );
+	benchmark( "cache, next frame", [&] {
+		for( const auto &shape : untranslatedShapes )
+			cache.get( shape );
+	} );
+	console() << "  " << cache.getNumEntries() << " unique shapes" << std::endl;
+}
+
+void TriangulateBenchmarkApp::setup()
+{
+	const int numLines = ( getArgs().size() >= 2 ) ? fromString<int>( getArgs()[1] ) : 100;
+
+	// glyph outlines, laid out as lines of text
+	const Font font( Font::getDefault().getName(), 32 );
+	const string text = "The quick brown fox jumps over the lazy dog 0123456789 &@%?";
+	const vector<Font::Glyph> glyphs = font.getGlyphs( text );
+	vector<Shape2d> glyphShapes, untranslatedGlyphShapes;
+	for( int line = 0; line < numLines; ++line ) {
+		for( size_t g = 0; g < glyphs.size(); ++g ) {
+			Shape2d shape = font.getGlyphShape( glyphs[g] );
+			untranslatedGlyphShapes.push_back( shape );
+			shape.translate( vec2( g * 20.0f, line * 40.0f ) );
+			glyphShapes.push_back( shape );
+		}
+	}
+	benchmarkShapes( "Glyphs", glyphShapes, untranslatedGlyphShapes );
+
+	// an SVG scene of stars, rounded rectangles and circles, each drawn many times through its own transform
+	Rand rnd( 1234 );
+	string svgText = "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" width=\"2000\" height=\"2000\"><defs>";
+	for( int i = 0; i < 16; ++i ) {
+		svgText += "<path id=\"star" + toString( i ) + "\" d=\"M";
+		const int numPoints = 5 + i;
+		for( int p = 0; p < numPoints * 2; ++p ) {
+			const float angle = p * (float)M_PI / numPoints, radius = ( p & 1 ) ? 10.0f : 25.0f;
+			svgText += " " + toString( cos( angle ) * radius ) + " " + toString( sin( angle ) * radius );
+		}
+		svgText += " Z\"/>";
+	}
+	svgText += "</defs>";
+	vector<Shape2d> svgUntranslatedShapes;
+	for( int i = 0; i < numLines * 20; ++i ) {
+		const string transform = "translate(" + toString( rnd.nextFloat( 2000 ) ) + "," + toString( rnd.nextFloat( 2000 ) ) + ")";
+		switch( i % 3 ) {
+			case 0: svgText += "<use xlink:href=\"#star" + toString( i % 16 ) + "\" transform=\"" + transform + "\"/>"; break;
+			case 1: svgText += "<rect x=\"0\" y=\"0\" width=\"40\" height=\"20\" rx=\"5\" transform=\"" + transform + "\"/>"; break;
+			default: svgText += "<circle cx=\"0\" cy=\"0\" r=\"15\" transform=\"" + transform + "\"/>"; break;
+		}
+	}
+	svgText += "</svg>";
+	svg::DocRef doc = svg::Doc::create( DataSourceBuffer::create( Buffer::create( (void*)svgText.data(), svgText.size() ) ) );
+	vector<Shape2d> svgShapes;
+	collectShapes( doc.get(), &svgShapes );
+	for( auto child : doc->getChildren() )
+		svgUntranslatedShapes.push_back( child->getShape() );
+	benchmarkShapes( "SVG scene", svgShapes, svgUntranslatedShapes );
+
+	quit();
+}
+
+void TriangulateBenchmarkApp::draw()
+{
+	gl::clear();
+}
+
+CINDER_APP( TriangulateBenchmarkApp, RendererGl, &TriangulateBenchmarkApp::prepareSettings )
@@ -43,4 +43,35 @@ TEST_CASE("Base64")
 			}
 		}
 	}
+	SECTION("Long input matches across whitespace, padding and line breaks.")
+	{
+		std::string test;
+		for( int t = 0; t < 5000; ++t )
+			test += (char)( ( t * 131 ) ^ ( t >> 3 ) );
+
+		std::string base64 = toBase64( test );
+		REQUIRE( toString( fromBase64( base64 ) ) == test );
+		REQUIRE( toString( fromBase64( toBase64( test, 76 ) ) ) == test );
+
+		// characters outside the alphabet are skipped wherever they fall
+		std::string noisy = base64;
+		for( size_t pos = 7; pos < noisy.size(); pos += 53 )
+			noisy.insert( pos, ( pos % 2 ) ? "\r\n" : " " );
+		REQUIRE( toString( fromBase64( noisy ) ) == test );
+	}
+	SECTION("Streams round trip.")
+	{
+		std::string test;
+		for( int t = 0; t < 200000; ++t )
+			test += (char)( t * 7 + ( t >> 8 ) );
+
+		auto encoded = OStreamMem::create();
+		toBase64( IStreamMem::create( test.data(), test.size() ), encoded, 64 );
+		std::string base64( static_cast<const char*>( encoded->getBuffer() ), (size_t)encoded->tell() );
+		REQUIRE( base64 == toBase64( test, 64 ) );
+
+		auto decoded = OStreamMem::create();
+		fromBase64( IStreamMem::create( base64.data(), base64.size() ), decoded );
+		REQUIRE( std::string( static_cast<const char*>( decoded->getBuffer() ), (size_t)decoded->tell() ) == test );
+	}
 }
@@ -0,0 +1,186 @@
+#include "cinder/ImageFileTinyExr.h"
+#include "cinder/Surface.h"
+#include "cinder/Channel.h"
+#include "cinder/DataSource.h"
+#include "tinyexr/tinyexr.h"
+
+#include "catch.hpp"
+
+#include <thread>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+const int32_t WIDTH = 37, HEIGHT = 70;
+// alphabetical, as OpenEXR stores them
+const vector<string> CHANNEL_NAMES = { "A", "B", "G", "R", "depth.Z", "diffuse.B", "diffuse.G", "diffuse.R" };
+
+// every sample encodes its channel and position
+float sampleValue( size_t channel, int32_t x, int32_t y )
+{
+	return channel * 10000.0f + y * 100.0f + x;
+}
+
+size_t channelIndex( const string &name )
+{
+	return find( CHANNEL_NAMES.begin(), CHANNEL_NAMES.end(), name ) - CHANNEL_NAMES.begin();
+}
+
+fs::path writeTestFile()
+{
+	vector<vector<float>> planes( CHANNEL_NAMES.size(), vector<float>( WIDTH * HEIGHT ) );
+	vector<float*> planePtrs;
+	for( size_t c = 0; c < planes.size(); ++c ) {
+		for( int32_t y = 0; y < HEIGHT; ++y )
+			for( int32_t x = 0; x < WIDTH; ++x )
+				planes[c][y * WIDTH + x] = sampleValue( c, x, y );
+		planePtrs.push_back( planes[c].data() );
+	}
+
+	EXRImage image;
+	InitEXRImage( &image );
+	image.num_channels = (int)planes.size();
+	image.images = reinterpret_cast<unsigned char**>( planePtrs.data() );
+	image.width = WIDTH;
+	image.height = HEIGHT;
+
+	vector<EXRChannelInfo> channels( CHANNEL_NAMES.size() );
+	vector<int> pixelTypes( CHANNEL_NAMES.size(), TINYEXR_PIXELTYPE_FLOAT );
+	for( size_t c = 0; c < channels.size(); ++c )
+		strncpy( channels[c].name, CHANNEL_NAMES[c].c_str(), 255 );
+
+	EXRHeader header;
+	InitEXRHeader( &header );
+	header.num_channels = (int)channels.size();
+	header.channels = channels.data();
+	header.pixel_types = pixelTypes.data();
+	header.requested_pixel_types = pixelTypes.data();
+	header.compression_type = TINYEXR_COMPRESSIONTYPE_ZIP;
+
+	const fs::path path = fs::temp_directory_path() / "cinder_ExrTest.exr";
+	const char *error = nullptr;
+	REQUIRE( SaveEXRImageToFile( &image, &header, path.string().c_str(), &error ) == TINYEXR_SUCCESS );
+	return path;
+}
+
+// Records the order and thread of each row written by an ImageSource
+class RecordingTarget : public ImageTarget {
+  public:
+	RecordingTarget( int32_t width, int32_t height )
+		: mWidth( width ), mData( width * height * 4 )
+	{
+		setDataType( ImageIo::FLOAT32 );
+		setColorModel( ImageIo::CM_RGB );
+		setChannelOrder( ImageIo::ChannelOrder::RGBA );
+	}
+
+	void* getRowPointer( int32_t row ) override
+	{
+		mRows.push_back( row );
+		mThreads.push_back( this_thread::get_id() );
+		return &mData[row * mWidth * 4];
+	}
+
+	int32_t					mWidth;
+	vector<float>			mData;
+	vector<int32_t>			mRows;
+	vector<thread::id>		mThreads;
+};
+
+} // anonymous namespace
+
+TEST_CASE( "ImageFileTinyExr" )
+{
+	const fs::path path = writeTestFile();
+
+	SECTION( "Default layer loads as RGBA" )
+	{
+		auto source = ImageSourceFileTinyExr::create( loadFile( path ) );
+		REQUIRE( source->getWidth() == WIDTH );
+		REQUIRE( source->getHeight() == HEIGHT );
+		REQUIRE( source->getChannelOrder() == ImageIo::ChannelOrder::RGBA );
+
+		Surface32f surface( source );
+		for( int32_t y : { 0, 17, HEIGHT - 1 } ) {
+			for( int32_t x : { 0, 5, WIDTH - 1 } ) {
+				ColorA pixel = surface.getPixel( ivec2( x, y ) );
+				REQUIRE( pixel.r == sampleValue( channelIndex( "R" ), x, y ) );
+				REQUIRE( pixel.g == sampleValue( channelIndex( "G" ), x, y ) );
+				REQUIRE( pixel.b == sampleValue( channelIndex( "B" ), x, y ) );
+				REQUIRE( pixel.a == sampleValue( channelIndex( "A" ), x, y ) );
+			}
+		}
+	}
+
+	SECTION( "Layer selection" )
+	{
+		auto source = ImageSourceFileTinyExr::create( loadFile( path ), ImageSource::Options(), ImageSourceFileTinyExr::ExrOptions().layer( "diffuse" ) );
+		REQUIRE( source->getChannelOrder() == ImageIo::ChannelOrder::RGB );
+
+		Surface32f surface( source );
+		for( int32_t y : { 0, 33, HEIGHT - 1 } ) {
+			for( int32_t x : { 0, 20, WIDTH - 1 } ) {
+				ColorA pixel = surface.getPixel( ivec2( x, y ) );
+				REQUIRE( pixel.r == sampleValue( channelIndex( "diffuse.R" ), x, y ) );
+				REQUIRE( pixel.g == sampleValue( channelIndex( "diffuse.G" ), x, y ) );
+				REQUIRE( pixel.b == sampleValue( channelIndex( "diffuse.B" ), x, y ) );
+			}
+		}
+	}
+
+	SECTION( "Channel selection" )
+	{
+		auto source = ImageSourceFileTinyExr::create( loadFile( path ), ImageSource::Options(), ImageSourceFileTinyExr::ExrOptions().channels( { "depth.Z" } ) );
+		REQUIRE( source->getChannelOrder() == ImageIo::ChannelOrder::Y );
+
+		Channel32f channel( source );
+		for( int32_t y = 0; y < HEIGHT; ++y )
+			for( int32_t x = 0; x < WIDTH; ++x )
+				REQUIRE( channel.getValue( ivec2( x, y ) ) == sampleValue( channelIndex( "depth.Z" ), x, y ) );
+
+		REQUIRE_THROWS_AS( ImageSourceFileTinyExr::create( loadFile( path ), ImageSource::Options(), ImageSourceFileTinyExr::ExrOptions().channels( { "missing.Z" } ) ), ImageIoExceptionFailedLoad );
+	}
+
+	SECTION( "Area selection" )
+	{
+		// spans several 16-scanline ZIP blocks, with blocks above and below it skipped
+		const Area area( 3, 21, 30, 52 );
+		auto source = ImageSourceFileTinyExr::create( loadFile( path ), ImageSource::Options(), ImageSourceFileTinyExr::ExrOptions().channels( { "G", "depth.Z" } ).area( area ) );
+		REQUIRE( source->getWidth() == area.getWidth() );
+		REQUIRE( source->getHeight() == area.getHeight() );
+		REQUIRE( source->getChannelOrder() == ImageIo::ChannelOrder::YA );
+
+		Surface32f surface( source );
+		for( int32_t y = 0; y < area.getHeight(); ++y ) {
+			for( int32_t x = 0; x < area.getWidth(); ++x ) {
+				ColorA pixel = surface.getPixel( ivec2( x, y ) );
+				REQUIRE( pixel.r == sampleValue( channelIndex( "G" ), x + area.x1, y + area.y1 ) );
+				REQUIRE( pixel.a == sampleValue( channelIndex( "depth.Z" ), x + area.x1, y + area.y1 ) );
+			}
+		}
+
+		// clipped to the data window
+		auto clipped = ImageSourceFileTinyExr::create( loadFile( path ), ImageSource::Options(), ImageSourceFileTinyExr::ExrOptions().area( Area( 30, 60, 100, 100 ) ) );
+		REQUIRE( clipped->getWidth() == WIDTH - 30 );
+		REQUIRE( clipped->getHeight() == HEIGHT - 60 );
+	}
+
+	SECTION( "Rows are written in order from the calling thread" )
+	{
+		const Area area( 0, 5, WIDTH, 64 );
+		auto source = ImageSourceFileTinyExr::create( loadFile( path ), ImageSource::Options(), ImageSourceFileTinyExr::ExrOptions().area( area ) );
+		auto target = make_shared<RecordingTarget>( area.getWidth(), area.getHeight() );
+		source->load( target );
+
+		REQUIRE( target->mRows.size() == (size_t)area.getHeight() );
+		for( int32_t row = 0; row < area.getHeight(); ++row ) {
+			REQUIRE( target->mRows[row] == row );
+			REQUIRE( target->mThreads[row] == this_thread::get_id() );
+		}
+		REQUIRE( target->mData[( 10 * area.getWidth() + 4 ) * 4] == sampleValue( channelIndex( "R" ), 4, 10 + area.y1 ) );
+	}
+
+	fs::remove( path );
+}
@@ -0,0 +1,68 @@
+#include "cinder/Frustum.h"
+#include "cinder/Camera.h"
+
+#include "catch.hpp"
+
+#include <random>
+
+using namespace ci;
+using namespace std;
+
+TEST_CASE( "Frustum" )
+{
+	CameraPersp cam( 640, 480, 60.0f, 1.0f, 100.0f );
+	cam.lookAt( vec3( 3, 4, 20 ), vec3( 0, 1, 0 ) );
+	const Frustum frustum( cam );
+
+	// spread around the frustum so a good share is culled by each plane, with some volumes straddling its edges
+	std::mt19937 rng( 42 );
+	std::uniform_real_distribution<float> position( -60, 60 ), size( 0, 4 );
+	const size_t numVolumes = 40000 + 13; // several parallel chunks and a scalar tail
+	std::vector<float> x( numVolumes ), y( numVolumes ), z( numVolumes ), ex( numVolumes ), ey( numVolumes ), ez( numVolumes );
+	for( size_t i = 0; i < numVolumes; ++i ) {
+		x[i] = position( rng ); y[i] = position( rng ); z[i] = position( rng ) - 40;
+		ex[i] = size( rng ); ey[i] = size( rng ); ez[i] = ( i % 10 == 0 ) ? 0 : size( rng );
+	}
+
+	SECTION( "Batch sphere culling matches intersects()" )
+	{
+		std::vector<uint32_t> visible( numVolumes ), expected;
+		for( size_t i = 0; i < numVolumes; ++i )
+			if( frustum.intersects( vec3( x[i], y[i], z[i] ), ex[i] ) )
+				expected.push_back( (uint32_t)i );
+
+		const Frustum::CullResult result = frustum.cullSpheres( x.data(), y.data(), z.data(), ex.data(), numVolumes, visible.data() );
+		REQUIRE( result.mNumTested == numVolumes );
+		REQUIRE( result.mNumVisible == expected.size() );
+		REQUIRE( result.getNumCulled() == numVolumes - expected.size() );
+		REQUIRE( std::vector<uint32_t>( visible.begin(), visible.begin() + result.mNumVisible ) == expected );
+		REQUIRE( expected.size() > numVolumes / 20 );
+		REQUIRE( expected.size() < numVolumes / 2 );
+	}
+
+	SECTION( "Batch box culling matches intersects()" )
+	{
+		std::vector<uint32_t> visible( numVolumes ), expected;
+		for( size_t i = 0; i < numVolumes; ++i ) {
+			const vec3 center( x[i], y[i], z[i] ), extents( ex[i], ey[i], ez[i] );
+			if( frustum.intersects( AxisAlignedBox( center - extents, center + extents ) ) )
+				expected.push_back( (uint32_t)i );
+		}
+
+		const Frustum::CullResult result = frustum.cullBoxes( x.data(), y.data(), z.data(), ex.data(), ey.data(), ez.data(), numVolumes, visible.data() );
+		REQUIRE( result.mNumVisible == expected.size() );
+		REQUIRE( std::vector<uint32_t>( visible.begin(), visible.begin() + result.mNumVisible ) == expected );
+	}
+
+	SECTION( "Small batches" )
+	{
+		uint32_t visible[3];
+		const float cx[3] = { 3, 500, 3 }, cy[3] = { 4, 4, 4 }, cz[3] = { 0, 0, 30 }, r[3] = { 1, 1, 1 };
+		Frustum::CullResult result = frustum.cullSpheres( cx, cy, cz, r, 3, visible );
+		REQUIRE( result.mNumVisible == 1 );
+		REQUIRE( visible[0] == 0 );
+		result = frustum.cullBoxes( cx, cy, cz, r, r, r, 0, visible );
+		REQUIRE( result.mNumTested == 0 );
+		REQUIRE( result.mNumVisible == 0 );
+	}
+}
@@ -0,0 +1,160 @@
+#include "cinder/ImageFileCimg.h"
+#include "cinder/DataSource.h"
+#include "cinder/DataTarget.h"
+#include "cinder/Surface.h"
+
+#include "catch.hpp"
+
+#include <thread>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+Surface8u makeTestSurface( int32_t width, int32_t height )
+{
+	Surface8u result( width, height, true, SurfaceChannelOrder::RGBA );
+	for( int32_t y = 0; y < height; ++y )
+		for( int32_t x = 0; x < width; ++x )
+			result.setPixel( ivec2( x, y ), ColorA8u( x * 7, y * 13, ( x ^ y ) & 0xFF, 255 - x ) );
+	return result;
+}
+
+DataSourceRef writeToMemory( const Surface8u &surface, const ImageTargetFileCimg::CimgOptions &options )
+{
+	auto stream = OStreamMem::create();
+	writeImage( ImageTargetFileCimg::create( DataTargetStream::createRef( stream ), surface, ImageTarget::Options(), "cimg", options ), surface );
+	auto buffer = make_shared<Buffer>( (size_t)stream->tell() );
+	memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+	return DataSourceBuffer::create( buffer );
+}
+
+// Records the order and thread of each row written by an ImageSource
+class RecordingTarget : public ImageTarget {
+  public:
+	RecordingTarget( int32_t width, int32_t height )
+		: mWidth( width ), mData( width * height * 4 )
+	{
+		setDataType( ImageIo::UINT8 );
+		setColorModel( ImageIo::CM_RGB );
+		setChannelOrder( ImageIo::RGBA );
+	}
+
+	void* getRowPointer( int32_t row ) override
+	{
+		mRows.push_back( row );
+		mThreads.push_back( this_thread::get_id() );
+		return &mData[row * mWidth * 4];
+	}
+
+	int32_t					mWidth;
+	vector<uint8_t>			mData;
+	vector<int32_t>			mRows;
+	vector<thread::id>		mThreads;
+};
+
+bool surfacesMatch( const Surface8u &a, const Surface8u &b )
+{
+	if( a.getSize() != b.getSize() )
+		return false;
+	for( int32_t y = 0; y < a.getHeight(); ++y )
+		for( int32_t x = 0; x < a.getWidth(); ++x )
+			if( a.getPixel( ivec2( x, y ) ) != b.getPixel( ivec2( x, y ) ) )
+				return false;
+	return true;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageFileCimg" )
+{
+	const Surface8u surface = makeTestSurface( 37, 21 );
+
+	SECTION( "Uncompressed round trip" )
+	{
+		auto source = ImageSourceFileCimg::createRef( writeToMemory( surface, ImageTargetFileCimg::CimgOptions() ) );
+		REQUIRE( source->getDataType() == ImageIo::UINT8 );
+		REQUIRE( source->getChannelOrder() == ImageIo::RGBA );
+		REQUIRE( source->isMappable() );
+		REQUIRE( surfacesMatch( Surface8u( source ), surface ) );
+	}
+
+	SECTION( "Compressed round trip" )
+	{
+		auto options = ImageTargetFileCimg::CimgOptions().compress().tileHeight( 4 );
+		auto source = ImageSourceFileCimg::createRef( writeToMemory( surface, options ) );
+		REQUIRE_FALSE( source->isMappable() );
+		REQUIRE( surfacesMatch( Surface8u( source ), surface ) );
+		REQUIRE_THROWS_AS( source->createSurfaceRef<uint8_t>(), ImageSourceFileCimgException );
+	}
+
+	SECTION( "Mip chain" )
+	{
+		auto dataSource = writeToMemory( surface, ImageTargetFileCimg::CimgOptions().mipmap() );
+		auto source = ImageSourceFileCimg::createRef( dataSource );
+		REQUIRE( source->getNumMipLevels() == 6 ); // 37x21 -> 18x10 -> 9x5 -> 4x2 -> 2x1 -> 1x1
+		REQUIRE( source->getCount() == 6 );
+
+		Surface8u level1( ImageSourceFileCimg::create( dataSource, ImageSource::Options().index( 1 ) ) );
+		REQUIRE( level1.getSize() == ivec2( 18, 10 ) );
+		ColorA8u expected = surface.getPixel( ivec2( 2, 2 ) ), p1 = surface.getPixel( ivec2( 3, 2 ) ), p2 = surface.getPixel( ivec2( 2, 3 ) ), p3 = surface.getPixel( ivec2( 3, 3 ) );
+		REQUIRE( (int)level1.getPixel( ivec2( 1, 1 ) ).r == ( expected.r + p1.r + p2.r + p3.r + 2 ) / 4 );
+
+		Surface8u last( ImageSourceFileCimg::create( dataSource, ImageSource::Options().index( 5 ) ) );
+		REQUIRE( last.getSize() == ivec2( 1, 1 ) );
+		REQUIRE_THROWS_AS( ImageSourceFileCimg::create( dataSource, ImageSource::Options().index( 6 ) ), ImageSourceFileCimgException );
+	}
+
+	SECTION( "Zero-copy Surface" )
+	{
+		auto dataSource = writeToMemory( surface, ImageTargetFileCimg::CimgOptions().rowAlignment( 64 ) );
+		auto mapped = ImageSourceFileCimg::createRef( dataSource )->createSurfaceRef<uint8_t>();
+		REQUIRE( mapped->getRowBytes() == 192 );
+		REQUIRE( mapped->getData() == (uint8_t*)dataSource->getBuffer()->getData() + 128 );
+		REQUIRE( surfacesMatch( *mapped, surface ) );
+		REQUIRE_THROWS_AS( ImageSourceFileCimg::createRef( dataSource )->createSurfaceRef<float>(), ImageSourceFileCimgException );
+	}
+
+	SECTION( "Gray zero-copy Channel" )
+	{
+		Channel8u channel( surface.getChannelGreen() );
+		auto stream = OStreamMem::create();
+		writeImage( ImageTargetFileCimg::create( DataTargetStream::createRef( stream ), channel, ImageTarget::Options(), "cimg" ), channel );
+		auto buffer = make_shared<Buffer>( (size_t)stream->tell() );
+		memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+		auto mapped = ImageSourceFileCimg::createRef( DataSourceBuffer::create( buffer ) )->createChannelRef<uint8_t>();
+		REQUIRE( mapped->getSize() == surface.getSize() );
+		REQUIRE( mapped->getValue( ivec2( 5, 7 ) ) == surface.getPixel( ivec2( 5, 7 ) ).g );
+	}
+
+	SECTION( "Rows are written in order from the calling thread" )
+	{
+		for( bool compress : { false, true } ) {
+			auto source = ImageSourceFileCimg::createRef( writeToMemory( surface, ImageTargetFileCimg::CimgOptions().compress( compress ).tileHeight( 2 ) ) );
+			auto target = make_shared<RecordingTarget>( surface.getWidth(), surface.getHeight() );
+			source->load( target );
+
+			REQUIRE( target->mRows.size() == (size_t)surface.getHeight() );
+			for( int32_t row = 0; row < surface.getHeight(); ++row ) {
+				REQUIRE( target->mRows[row] == row );
+				REQUIRE( target->mThreads[row] == this_thread::get_id() );
+			}
+			REQUIRE( target->mData[( 20 * surface.getWidth() + 3 ) * 4 + 1] == surface.getPixel( ivec2( 3, 20 ) ).g );
+		}
+	}
+
+	SECTION( "Rejects corrupt data" )
+	{
+		auto buffer = make_shared<Buffer>( 64 );
+		memset( buffer->getData(), 0, 64 );
+		REQUIRE_THROWS_AS( ImageSourceFileCimg::create( DataSourceBuffer::create( buffer ) ), ImageSourceFileCimgException );
+
+		// an uncompressed file, with a tile height of 0, whose level claims a tile
+		auto uncompressed = writeToMemory( surface, ImageTargetFileCimg::CimgOptions() )->getBuffer();
+		uint8_t *data = static_cast<uint8_t*>( uncompressed->getData() );
+		const size_t headerSize = data[6] | ( data[7] << 8 );
+		data[headerSize + 8] = 1;
+		REQUIRE_THROWS_AS( ImageSourceFileCimg::create( DataSourceBuffer::create( uncompressed ) ), ImageSourceFileCimgException );
+	}
+}
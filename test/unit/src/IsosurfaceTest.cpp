@@ -0,0 +1,127 @@
+#include "cinder/GeomIo.h"
+#include "cinder/TriMesh.h"
+
+#include "catch.hpp"
+
+#include <map>
+#include <thread>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+//! Returns whether every directed edge is matched by exactly one opposite edge, so the surface is closed and consistently oriented
+bool isClosedManifold( const TriMesh &mesh )
+{
+	map<pair<uint32_t, uint32_t>, int> edges;
+	const auto &indices = mesh.getIndices();
+	for( size_t t = 0; t < indices.size(); t += 3 )
+		for( int k = 0; k < 3; ++k )
+			edges[make_pair( indices[t + k], indices[t + ( k + 1 ) % 3] )]++;
+	for( const auto &edge : edges ) {
+		auto opposite = edges.find( make_pair( edge.first.second, edge.first.first ) );
+		if( edge.second != 1 || opposite == edges.end() || opposite->second != 1 )
+			return false;
+	}
+	return true;
+}
+
+vector<float> sampleGrid( const geom::Isosurface::FieldFn &fieldFn, const AxisAlignedBox &bounds, const ivec3 &resolution )
+{
+	vector<float> result;
+	const vec3 spacing = bounds.getSize() / vec3( resolution - ivec3( 1 ) );
+	for( int k = 0; k < resolution.z; ++k )
+		for( int j = 0; j < resolution.y; ++j )
+			for( int i = 0; i < resolution.x; ++i )
+				result.push_back( fieldFn( bounds.getMin() + spacing * vec3( i, j, k ) ) );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "Isosurface" )
+{
+	const float radius = 0.7f;
+	const auto sphere = [radius]( const vec3 &p ) { return length( p ) - radius; };
+	const AxisAlignedBox bounds( vec3( -1 ), vec3( 1 ) );
+
+	SECTION( "A sphere is closed, with outward normals" )
+	{
+		TriMesh mesh( geom::Isosurface( sphere, bounds, ivec3( 33, 21, 40 ) ) );
+		REQUIRE( mesh.getNumTriangles() > 1000 );
+		REQUIRE( isClosedManifold( mesh ) );
+		// Euler characteristic of a sphere
+		REQUIRE( int( mesh.getNumVertices() ) - int( mesh.getNumIndices() / 2 ) + int( mesh.getNumTriangles() ) == 2 );
+
+		const vec3 *positions = mesh.getPositions<3>();
+		for( size_t v = 0; v < mesh.getNumVertices(); ++v ) {
+			REQUIRE( length( positions[v] ) == Approx( radius ).margin( 0.02f ) );
+			REQUIRE( dot( mesh.getNormals()[v], normalize( positions[v] ) ) > 0.99f );
+		}
+		for( size_t t = 0; t < mesh.getNumTriangles(); ++t ) {
+			vec3 a, b, c;
+			mesh.getTriangleVertices( t, &a, &b, &c );
+			REQUIRE( dot( cross( b - a, c - a ), a + b + c ) >= 0 );
+		}
+	}
+
+	SECTION( "Ambiguous configurations stay watertight" )
+	{
+		auto waves = []( const vec3 &p ) {
+			return std::max( sin( p.x * 13 ) * sin( p.y * 11 ) * sin( p.z * 17 ) + 0.3f * sin( p.x * 31 + p.y * 7 ), length( p ) - 0.8f );
+		};
+		TriMesh mesh( geom::Isosurface( waves, bounds, ivec3( 40 ) ) );
+		REQUIRE( mesh.getNumTriangles() > 10000 );
+		REQUIRE( isClosedManifold( mesh ) );
+	}
+
+	SECTION( "Dense grids match callbacks" )
+	{
+		const ivec3 resolution( 20, 24, 17 );
+		geom::Isosurface fromCallback( sphere, bounds, resolution );
+		geom::Isosurface fromGrid( sampleGrid( sphere, bounds, resolution ), bounds, resolution );
+		TriMesh a( fromCallback ), b( fromGrid );
+		REQUIRE( a.getIndices() == b.getIndices() );
+		REQUIRE( a.getBufferPositions() == b.getBufferPositions() );
+
+		REQUIRE_THROWS_AS( geom::Isosurface( vector<float>( 10 ), bounds, resolution ), geom::ExcIllegalSourceDimensions );
+	}
+
+	SECTION( "Only dirty slabs are extracted again" )
+	{
+		const ivec3 resolution( 32 );
+		geom::Isosurface iso( sampleGrid( sphere, bounds, resolution ), bounds, resolution );
+		REQUIRE( iso.getNumIndices() > 0 );
+		REQUIRE( iso.getNumSlabsExtracted() == iso.getNumSlabs() );
+
+		// move the sphere's top cap down where z > 0.5
+		auto moved = [&]( const vec3 &p ) { return p.z > 0.5f ? length( p ) - radius * 0.9f : sphere( p ); };
+		iso.getSamples() = sampleGrid( moved, bounds, resolution );
+		iso.markDirty( AxisAlignedBox( vec3( -1, -1, 0.5f ), vec3( 1 ) ) );
+		TriMesh incremental( iso );
+		REQUIRE( iso.getNumSlabsExtracted() < iso.getNumSlabs() / 2 );
+		REQUIRE( iso.getNumSlabsExtracted() > 0 );
+
+		TriMesh full( geom::Isosurface( sampleGrid( moved, bounds, resolution ), bounds, resolution ) );
+		REQUIRE( incremental.getIndices() == full.getIndices() );
+		REQUIRE( incremental.getBufferPositions() == full.getBufferPositions() );
+		REQUIRE( incremental.getNormals() == full.getNormals() );
+	}
+
+	SECTION( "Concurrent loads share one extraction" )
+	{
+		const geom::Isosurface iso( sphere, bounds, ivec3( 24 ) );
+		vector<vector<uint32_t>> indices( 4 );
+		vector<std::thread> threads;
+		for( auto &result : indices )
+			threads.emplace_back( [&iso, &result] { result = TriMesh( iso ).getIndices(); } );
+		for( auto &thread : threads )
+			thread.join();
+
+		REQUIRE( iso.getNumSlabsExtracted() == iso.getNumSlabs() );
+		REQUIRE( ! indices[0].empty() );
+		for( const auto &result : indices )
+			REQUIRE( result == indices[0] );
+	}
+}
@@ -0,0 +1,141 @@
+#include "cinder/MeshBvh.h"
+
+#include "catch.hpp"
+
+#include <random>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+// a soup of random triangles, including some degenerate and overlapping ones
+TriMesh makeTriangleSoup( size_t numTriangles, std::mt19937 &rng )
+{
+	std::uniform_real_distribution<float> position( -10, 10 ), offset( -1, 1 );
+	TriMesh result( TriMesh::Format().positions() );
+	for( size_t t = 0; t < numTriangles; ++t ) {
+		vec3 center( position( rng ), position( rng ), position( rng ) );
+		result.appendPosition( center + vec3( offset( rng ), offset( rng ), offset( rng ) ) );
+		result.appendPosition( center + vec3( offset( rng ), offset( rng ), offset( rng ) ) );
+		result.appendPosition( ( t % 50 == 0 ) ? center : center + vec3( offset( rng ), offset( rng ), offset( rng ) ) );
+		result.appendTriangle( (uint32_t)t * 3, (uint32_t)t * 3 + 1, (uint32_t)t * 3 + 2 );
+	}
+	return result;
+}
+
+float bruteForceRaycast( const TriMesh &mesh, const Ray &ray, uint32_t *triangle )
+{
+	float best = std::numeric_limits<float>::max();
+	*triangle = MeshBvh::INVALID_TRIANGLE;
+	for( size_t t = 0; t < mesh.getNumTriangles(); ++t ) {
+		vec3 a, b, c;
+		float distance;
+		mesh.getTriangleVertices( t, &a, &b, &c );
+		if( ray.calcTriangleIntersection( a, b, c, &distance ) && distance >= 0 && distance < best ) {
+			best = distance;
+			*triangle = (uint32_t)t;
+		}
+	}
+	return best;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "MeshBvh" )
+{
+	std::mt19937 rng( 1234 );
+	std::uniform_real_distribution<float> unit( -1, 1 );
+	const TriMesh soup = makeTriangleSoup( 5000, rng );
+	const MeshBvh bvh( soup );
+
+	SECTION( "Raycasts match a brute force search" )
+	{
+		REQUIRE( bvh.getNumTriangles() == soup.getNumTriangles() );
+		std::vector<Ray> rays;
+		for( int r = 0; r < 300; ++r )
+			rays.emplace_back( vec3( unit( rng ), unit( rng ), unit( rng ) ) * 15.0f, vec3( unit( rng ), unit( rng ), unit( rng ) ) );
+		rays.emplace_back( vec3( -20, 0.5f, 0.5f ), vec3( 1, 0, 0 ) ); // axis-aligned directions exercise infinite inverse components
+
+		std::vector<MeshBvh::RayHit> batch( rays.size() );
+		bvh.raycast( rays.data(), rays.size(), batch.data() );
+
+		size_t numHits = 0;
+		for( size_t r = 0; r < rays.size(); ++r ) {
+			uint32_t expectedTriangle;
+			const float expected = bruteForceRaycast( soup, rays[r], &expectedTriangle );
+			MeshBvh::RayHit hit;
+			const bool isHit = bvh.raycast( rays[r], &hit );
+			REQUIRE( isHit == ( expectedTriangle != MeshBvh::INVALID_TRIANGLE ) );
+			REQUIRE( bvh.raycastAny( rays[r] ) == isHit );
+			REQUIRE( batch[r].mTriangle == hit.mTriangle );
+			if( isHit ) {
+				++numHits;
+				REQUIRE( hit.mDistance == Approx( expected ) );
+				vec3 a, b, c;
+				soup.getTriangleVertices( hit.mTriangle, &a, &b, &c );
+				const vec3 barycentricPoint = a * ( 1 - hit.mBarycentric.x - hit.mBarycentric.y ) + b * hit.mBarycentric.x + c * hit.mBarycentric.y;
+				REQUIRE( length( barycentricPoint - rays[r].calcPosition( hit.mDistance ) ) < 1e-3f );
+				REQUIRE_FALSE( bvh.raycast( rays[r], &hit, expected * 0.99f ) );
+			}
+		}
+		REQUIRE( numHits > 50 );
+	}
+
+	SECTION( "Closest points and sphere overlaps match a brute force search" )
+	{
+		for( int q = 0; q < 100; ++q ) {
+			const vec3 point = vec3( unit( rng ), unit( rng ), unit( rng ) ) * 12.0f;
+			vec3 closest;
+			uint32_t triangle;
+			REQUIRE( bvh.calcClosestPoint( point, &closest, &triangle ) );
+
+			float expected = std::numeric_limits<float>::max();
+			for( size_t t = 0; t < soup.getNumTriangles(); ++t ) {
+				vec3 a, b, c;
+				soup.getTriangleVertices( t, &a, &b, &c );
+				// sample the triangle densely enough to bound the true distance from above
+				for( int i = 0; i <= 10; ++i )
+					for( int j = 0; j <= 10 - i; ++j )
+						expected = std::min( expected, distance( point, a + ( b - a ) * ( i / 10.0f ) + ( c - a ) * ( j / 10.0f ) ) );
+			}
+			REQUIRE( distance( point, closest ) <= expected + 1e-4f );
+			REQUIRE( distance( point, closest ) > expected - 0.3f );
+
+			const Sphere sphere( point, distance( point, closest ) + 0.5f );
+			std::vector<uint32_t> found;
+			bvh.findTriangles( sphere, &found );
+			REQUIRE( std::find( found.begin(), found.end(), triangle ) != found.end() );
+			REQUIRE( bvh.intersects( sphere ) );
+			REQUIRE_FALSE( bvh.intersects( Sphere( point, distance( point, closest ) * 0.99f ) ) );
+		}
+	}
+
+	SECTION( "Refitting follows moved vertices" )
+	{
+		TriMesh moved = soup;
+		for( size_t v = 0; v < moved.getNumVertices(); ++v )
+			moved.getPositions<3>()[v] += vec3( 100, 0, 0 );
+		MeshBvh refitted( soup );
+		refitted.refit( moved );
+
+		REQUIRE( refitted.getBounds().getMin().x == Approx( bvh.getBounds().getMin().x + 100 ) );
+		Ray ray( vec3( 100, 0, -50 ), vec3( 0, 0, 1 ) );
+		MeshBvh::RayHit expected, hit;
+		bvh.raycast( Ray( vec3( 0, 0, -50 ), vec3( 0, 0, 1 ) ), &expected );
+		REQUIRE( refitted.raycast( ray, &hit ) == expected.isHit() );
+		REQUIRE( hit.mTriangle == expected.mTriangle );
+		REQUIRE_THROWS_AS( refitted.refit( moved.getPositions<3>(), 3 ), MeshBvhExc );
+	}
+
+	SECTION( "MeshBvh builds from a geom::Source" )
+	{
+		const MeshBvh sphere( geom::Sphere().radius( 2 ).subdivisions( 32 ) );
+		MeshBvh::RayHit hit;
+		REQUIRE( sphere.raycast( Ray( vec3( 0, 0, -10 ), vec3( 0, 0, 1 ) ), &hit ) );
+		REQUIRE( hit.mDistance == Approx( 8 ).epsilon( 0.01 ) );
+		REQUIRE_FALSE( sphere.raycast( Ray( vec3( 0, 0, -10 ), vec3( 0, 0, -1 ) ), &hit ) );
+		REQUIRE( sphere.intersects( Sphere( vec3( 2.5f, 0, 0 ), 0.6f ) ) );
+		REQUIRE_FALSE( sphere.intersects( Sphere( vec3( 0 ), 1.5f ) ) );
+	}
+}
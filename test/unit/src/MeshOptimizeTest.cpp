@@ -0,0 +1,148 @@
+#include "cinder/TriMesh.h"
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <set>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+// every triangle gets its own vertices, in random order, as a naive exporter would produce
+TriMesh makeTriangleSoup( const TriMesh &source )
+{
+	vector<uint32_t> order( source.getNumTriangles() );
+	iota( order.begin(), order.end(), 0 );
+	shuffle( order.begin(), order.end(), std::mt19937( 7 ) );
+
+	TriMesh result( TriMesh::Format().positions().normals().texCoords() );
+	const vec3 *positions = source.getPositions<3>();
+	const vec2 *texCoords = source.getTexCoords0<2>();
+	for( uint32_t t : order ) {
+		for( int k = 0; k < 3; ++k ) {
+			const uint32_t v = source.getIndices()[t * 3 + k];
+			result.appendPosition( positions[v] );
+			result.appendNormal( source.getNormals()[v] );
+			result.appendTexCoord( texCoords[v] );
+		}
+		const uint32_t first = (uint32_t)result.getNumVertices() - 3;
+		result.appendTriangle( first, first + 1, first + 2 );
+	}
+	return result;
+}
+
+typedef array<float, 9> TriangleKey;
+
+//! The set of triangles by their rotation-normalized positions, independent of triangle and vertex order
+multiset<TriangleKey> triangleSet( const TriMesh &mesh )
+{
+	multiset<TriangleKey> result;
+	for( size_t t = 0; t < mesh.getNumTriangles(); ++t ) {
+		vec3 v[3];
+		mesh.getTriangleVertices( t, &v[0], &v[1], &v[2] );
+		int first = 0;
+		for( int k = 1; k < 3; ++k )
+			if( lexicographical_compare( &v[k].x, &v[k].x + 3, &v[first].x, &v[first].x + 3 ) )
+				first = k;
+		TriangleKey key;
+		for( int k = 0; k < 3; ++k )
+			for( int d = 0; d < 3; ++d )
+				key[k * 3 + d] = v[( first + k ) % 3][d];
+		result.insert( key );
+	}
+	return result;
+}
+
+class IndexSizeTarget : public geom::Target {
+  public:
+	uint8_t	getAttribDims( geom::Attrib ) const override { return 0; }
+	void	copyAttrib( geom::Attrib, uint8_t, size_t, const float *, size_t ) override {}
+	void	copyIndices( geom::Primitive, const uint32_t *, size_t, uint8_t requiredBytesPerIndex ) override { mBytesPerIndex = requiredBytesPerIndex; }
+
+	uint8_t	mBytesPerIndex = 0;
+};
+
+} // anonymous namespace
+
+TEST_CASE( "MeshOptimize" )
+{
+	const TriMesh sphere( geom::Sphere().subdivisions( 32 ) );
+	const multiset<TriangleKey> sphereTriangles = triangleSet( sphere );
+
+	SECTION( "Welding restores shared vertices" )
+	{
+		TriMesh mesh = makeTriangleSoup( sphere );
+		const TriMesh::OptimizeResult result = mesh.weld();
+		REQUIRE( mesh.getNumVertices() == sphere.getNumVertices() );
+		REQUIRE( triangleSet( mesh ) == sphereTriangles );
+		REQUIRE( result.mBefore.mAtvr == Approx( 1.0f ) );
+		REQUIRE( result.mAfter.mAtvr > result.mBefore.mAtvr );
+
+		// nudged positions only weld with a large enough epsilon
+		TriMesh nudged = makeTriangleSoup( sphere );
+		for( size_t v = 0; v < nudged.getNumVertices(); v += 3 )
+			nudged.getPositions<3>()[v] += vec3( 1e-5f );
+		TriMesh exact = nudged;
+		exact.weld();
+		REQUIRE( exact.getNumVertices() > sphere.getNumVertices() );
+		nudged.weld( 1e-4f );
+		REQUIRE( nudged.getNumVertices() == sphere.getNumVertices() );
+	}
+
+	SECTION( "Cache and overdraw optimization reorder triangles and reduce cache misses" )
+	{
+		TriMesh mesh = makeTriangleSoup( sphere );
+		mesh.weld();
+		TriMesh overdraw = mesh;
+
+		const TriMesh::OptimizeResult cache = mesh.optimizeVertexCache();
+		REQUIRE( cache.mAfter.mAcmr < 0.7f );
+		REQUIRE( cache.mAfter.mAcmr < cache.mBefore.mAcmr );
+		REQUIRE( cache.mAfter.mAtvr < 1.3f );
+		REQUIRE( triangleSet( mesh ) == sphereTriangles );
+
+		const TriMesh::OptimizeResult result = overdraw.optimizeOverdraw();
+		REQUIRE( result.mAfter.mAcmr <= cache.mAfter.mAcmr * 1.1f );
+		REQUIRE( triangleSet( overdraw ) == sphereTriangles );
+	}
+
+	SECTION( "Vertex fetch optimization follows the triangle order" )
+	{
+		TriMesh mesh = sphere;
+		mesh.optimizeVertexCache();
+		const TriMesh::VertexCacheStats before = mesh.calcVertexCacheStats();
+		mesh.optimizeVertexFetch();
+		REQUIRE( mesh.calcVertexCacheStats().mAcmr == before.mAcmr );
+		REQUIRE( triangleSet( mesh ) == sphereTriangles );
+
+		uint32_t nextNew = 0;
+		for( uint32_t index : mesh.getIndices() ) {
+			REQUIRE( index <= nextNew );
+			nextNew = std::max( nextNew, index + 1 );
+		}
+		REQUIRE( nextNew == mesh.getNumVertices() );
+	}
+
+	SECTION( "optimize() runs the whole pipeline" )
+	{
+		TriMesh mesh = makeTriangleSoup( sphere );
+		const TriMesh::OptimizeResult result = mesh.optimize();
+		REQUIRE( result.mBefore.mAcmr == Approx( 3.0f ) );
+		REQUIRE( result.mAfter.mAcmr < 0.7f );
+		REQUIRE( mesh.getNumVertices() == sphere.getNumVertices() );
+		REQUIRE( triangleSet( mesh ) == sphereTriangles );
+	}
+
+	SECTION( "Indices narrow to 16 bits when the vertices fit" )
+	{
+		IndexSizeTarget small, large;
+		sphere.loadInto( &small, { geom::Attrib::POSITION } );
+		REQUIRE( small.mBytesPerIndex == 2 );
+		TriMesh( geom::Plane().subdivisions( ivec2( 300 ) ) ).loadInto( &large, { geom::Attrib::POSITION } );
+		REQUIRE( large.mBytesPerIndex == 4 );
+	}
+}
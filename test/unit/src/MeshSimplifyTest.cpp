@@ -0,0 +1,196 @@
+#include "cinder/TriMesh.h"
+#include "cinder/GeomIo.h"
+
+#include "catch.hpp"
+
+#include <set>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+typedef tuple<float,float,float> PositionKey;
+
+set<PositionKey> positionSet( const TriMesh &mesh )
+{
+	set<PositionKey> result;
+	const vec3 *positions = mesh.getPositions<3>();
+	for( size_t v = 0; v < mesh.getNumVertices(); ++v )
+		result.insert( PositionKey( positions[v].x, positions[v].y, positions[v].z ) );
+	return result;
+}
+
+float calcArea( const TriMesh &mesh )
+{
+	float result = 0;
+	for( size_t t = 0; t < mesh.getNumTriangles(); ++t ) {
+		vec3 a, b, c;
+		mesh.getTriangleVertices( t, &a, &b, &c );
+		result += 0.5f * length( cross( b - a, c - a ) );
+	}
+	return result;
+}
+
+// widest horizontal texture coordinate range of any triangle; a torn seam produces triangles which span the whole texture
+float calcMaxTexCoordSpan( const TriMesh &mesh )
+{
+	float result = 0;
+	const vec2 *texCoords = mesh.getTexCoords0<2>();
+	const vector<uint32_t> &indices = mesh.getIndices();
+	for( size_t i = 0; i < indices.size(); i += 3 ) {
+		const float a = texCoords[indices[i]].x, b = texCoords[indices[i + 1]].x, c = texCoords[indices[i + 2]].x;
+		result = std::max( result, std::max( a, std::max( b, c ) ) - std::min( a, std::min( b, c ) ) );
+	}
+	return result;
+}
+
+// rejects data which doesn't match the counts the Source promised, like gl::VboMesh does
+class CountingTarget : public geom::Target {
+  public:
+	CountingTarget( const geom::Source &source )
+		: mSource( source ), mNumVertices( source.getNumVertices() ), mNumIndices( source.getNumIndices() ), mMismatches( 0 ), mNumAttribs( 0 )
+	{}
+
+	uint8_t	getAttribDims( geom::Attrib attr ) const override { return mSource.getAttribDims( attr ); }
+
+	void copyAttrib( geom::Attrib /*attr*/, uint8_t /*dims*/, size_t /*strideBytes*/, const float * /*srcData*/, size_t count ) override
+	{
+		++mNumAttribs;
+		if( count != mNumVertices )
+			++mMismatches;
+	}
+
+	void copyIndices( geom::Primitive /*primitive*/, const uint32_t * /*source*/, size_t numIndices, uint8_t /*requiredBytesPerIndex*/ ) override
+	{
+		if( numIndices != mNumIndices )
+			++mMismatches;
+	}
+
+	const geom::Source	&mSource;
+	size_t				mNumVertices, mNumIndices, mMismatches, mNumAttribs;
+};
+
+} // anonymous namespace
+
+TEST_CASE( "MeshSimplify" )
+{
+	const TriMesh sphere( geom::Sphere().subdivisions( 48 ) );
+
+	SECTION( "Simplify reaches the target ratio and keeps vertices on the surface" )
+	{
+		TriMesh mesh = sphere;
+		const float error = mesh.simplify( 0.25f );
+		REQUIRE( mesh.getNumTriangles() <= sphere.getNumTriangles() / 4 );
+		REQUIRE( mesh.getNumTriangles() > sphere.getNumTriangles() / 5 );
+		REQUIRE( error > 0 );
+		REQUIRE( error < 0.05f );
+		const vec3 *positions = mesh.getPositions<3>();
+		for( size_t v = 0; v < mesh.getNumVertices(); ++v )
+			REQUIRE( length( positions[v] ) == Approx( 1.0f ).margin( 1e-5f ) );
+		REQUIRE( mesh.calcBoundingBox().getMax().y == Approx( 1.0f ) );
+		REQUIRE( mesh.calcBoundingBox().getMin().y == Approx( -1.0f ) );
+	}
+
+	SECTION( "Texture seams stay intact" )
+	{
+		REQUIRE( calcMaxTexCoordSpan( sphere ) < 0.1f );
+		TriMesh mesh( sphere >> geom::Simplify().ratio( 0.05f ) );
+		REQUIRE( mesh.getNumTriangles() < sphere.getNumTriangles() / 10 );
+		REQUIRE( calcMaxTexCoordSpan( mesh ) < 0.5f );
+	}
+
+	SECTION( "The error limit stops simplification early" )
+	{
+		float error = 0;
+		TriMesh mesh( sphere >> geom::Simplify().ratio( 0 ).maxError( 0.01f ).resultError( &error ) );
+		REQUIRE( mesh.getNumTriangles() > 0 );
+		REQUIRE( mesh.getNumTriangles() < sphere.getNumTriangles() );
+		REQUIRE( error <= 0.01f );
+	}
+
+	SECTION( "Open boundaries are preserved" )
+	{
+		const TriMesh plane( geom::Plane().subdivisions( ivec2( 16 ) ) );
+		set<PositionKey> boundary;
+		for( const auto &position : positionSet( plane ) )
+			if( std::abs( get<0>( position ) ) == 1 || std::abs( get<2>( position ) ) == 1 )
+				boundary.insert( position );
+
+		TriMesh locked( plane >> geom::Simplify().ratio( 0 ).preserveBoundaries() );
+		const set<PositionKey> remaining = positionSet( locked );
+		REQUIRE( locked.getNumTriangles() < plane.getNumTriangles() / 4 );
+		for( const auto &position : boundary )
+			REQUIRE( remaining.count( position ) == 1 );
+		REQUIRE( calcArea( locked ) == Approx( 4.0f ) );
+
+		// a flat plane has no error until its corners move
+		TriMesh sliding( plane >> geom::Simplify().ratio( 0 ).maxError( 1e-4f ) );
+		REQUIRE( sliding.getNumTriangles() < locked.getNumTriangles() );
+		REQUIRE( calcArea( sliding ) == Approx( 4.0f ) );
+		REQUIRE( sliding.calcBoundingBox().getSize() == plane.calcBoundingBox().getSize() );
+	}
+
+	SECTION( "Reported counts are exact and each load simplifies once" )
+	{
+		size_t numCalls = 0;
+		auto source = sphere >> geom::AttribFn<vec3, vec3>( geom::POSITION, [&]( vec3 p ) { ++numCalls; return p; } ) >> geom::Simplify().ratio( 0.25f ) >> geom::Translate( 1, 0, 0 );
+		CountingTarget target( source );
+		source.loadInto( &target, { geom::POSITION, geom::NORMAL } );
+		REQUIRE( target.mNumVertices < sphere.getNumVertices() / 2 );
+		REQUIRE( target.mNumAttribs >= 2 );
+		REQUIRE( target.mMismatches == 0 );
+		REQUIRE( numCalls == sphere.getNumVertices() );
+
+		// a different request produces the same mesh, simplified again
+		CountingTarget texCoordTarget( source );
+		source.loadInto( &texCoordTarget, { geom::POSITION, geom::TEX_COORD_0 } );
+		REQUIRE( texCoordTarget.mMismatches == 0 );
+		REQUIRE( texCoordTarget.mNumVertices == target.mNumVertices );
+		REQUIRE( numCalls == 2 * sphere.getNumVertices() );
+	}
+
+	SECTION( "Changes to a referenced upstream Source are picked up" )
+	{
+		TriMesh mesh( geom::Sphere().subdivisions( 24 ) );
+		auto source = &mesh >> geom::Simplify().ratio( 0.5f );
+		const TriMesh first( source );
+		REQUIRE( first.getNumVertices() > 0 );
+
+		// same counts, different positions
+		vec3 *positions = mesh.getPositions<3>();
+		for( size_t v = 0; v < mesh.getNumVertices(); ++v )
+			positions[v] *= 2.0f;
+		const TriMesh second( source );
+		REQUIRE( second.getNumVertices() == first.getNumVertices() );
+		REQUIRE( second.calcBoundingBox().getSize().x == Approx( 2.0f * first.calcBoundingBox().getSize().x ) );
+	}
+
+	SECTION( "Simplification is deterministic" )
+	{
+		const TriMesh big( geom::Torus().subdivisionsAxis( 200 ).subdivisionsHeight( 100 ) );
+		const TriMesh first( big >> geom::Simplify().ratio( 0.2f ) );
+		for( int run = 0; run < 3; ++run ) {
+			const TriMesh again( big >> geom::Simplify().ratio( 0.2f ) );
+			REQUIRE( again.getIndices() == first.getIndices() );
+		}
+	}
+
+	SECTION( "LOD chains come from a single collapse sequence" )
+	{
+		const vector<float> ratios = { 0.1f, 0.5f, 0.25f };
+		const vector<TriMeshRef> chain = sphere.buildLodChain( ratios );
+		REQUIRE( chain.size() == ratios.size() );
+		for( size_t level = 0; level < ratios.size(); ++level ) {
+			REQUIRE( chain[level]->getNumTriangles() <= size_t( sphere.getNumTriangles() * ratios[level] ) );
+			REQUIRE( chain[level]->getNumTriangles() > size_t( sphere.getNumTriangles() * ratios[level] * 0.8f ) );
+			REQUIRE( chain[level]->hasNormals() );
+			REQUIRE( chain[level]->hasTexCoords0() );
+		}
+
+		// vertices stay in place, so every coarser level keeps a subset of the finer level's positions
+		const set<PositionKey> fine = positionSet( *chain[1] ), medium = positionSet( *chain[2] ), coarse = positionSet( *chain[0] );
+		REQUIRE( includes( fine.begin(), fine.end(), medium.begin(), medium.end() ) );
+		REQUIRE( includes( medium.begin(), medium.end(), coarse.begin(), coarse.end() ) );
+	}
+}
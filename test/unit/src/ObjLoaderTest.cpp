@@ -94,4 +94,50 @@ SECTION( "ObjLoader successfully parses faces with line continuations." )
 	REQUIRE( matchesExpectedPositions( mesh->getPositions<3>() ) );
 }
 
+SECTION( "ObjLoader parses large files spanning several chunks identically from a file and a stream." )
+{
+	// a 400x400 grid split across two groups, the second using relative indices; a few MB of text so it's parsed in several chunks
+	const int res = 400;
+	std::string data = "# grid\n";
+	for( int y = 0; y <= res; ++y )
+		for( int x = 0; x <= res; ++x )
+			data += "v " + std::to_string( x * 0.25f ) + " " + std::to_string( y * 0.5f ) + " 0\nvt " + std::to_string( x / (float)res ) + " " + std::to_string( y / (float)res ) + "\n";
+	data += "vn 0 0 1\ng first\n";
+	for( int y = 0; y < res; ++y ) {
+		if( y == res / 2 )
+			data += "g second\n";
+		for( int x = 0; x < res; ++x ) {
+			int i = y * ( res + 1 ) + x + 1;
+			if( y < res / 2 )
+				data += "f " + std::to_string( i ) + "/" + std::to_string( i ) + "/1 " + std::to_string( i + 1 ) + "/" + std::to_string( i + 1 ) + "/1 "
+						+ std::to_string( i + res + 2 ) + "/" + std::to_string( i + res + 2 ) + "/1 " + std::to_string( i + res + 1 ) + "/" + std::to_string( i + res + 1 ) + "/1\n";
+			else {
+				const int base = ( res + 1 ) * ( res + 1 ) + 1;
+				data += "f " + std::to_string( i - base ) + "/" + std::to_string( i - base ) + "/-1 " + std::to_string( i + 1 - base ) + "/" + std::to_string( i + 1 - base ) + "/-1 "
+						+ std::to_string( i + res + 2 - base ) + "/" + std::to_string( i + res + 2 - base ) + "/-1 " + std::to_string( i + res + 1 - base ) + "/" + std::to_string( i + res + 1 - base ) + "/-1\n";
+			}
+		}
+	}
+
+	const fs::path path = fs::temp_directory_path() / "cinder_ObjLoaderTest.obj";
+	writeFile( path )->getStream()->writeData( data.data(), data.size() );
+
+	ObjLoader fromStream( IStreamMem::create( data.c_str(), data.size() ) );
+	ObjLoader fromFile( loadFile( path ) );
+	fs::remove( path );
+
+	REQUIRE( fromFile.getGroups().size() == 2 );
+	REQUIRE( fromFile.getGroups()[1].mName == "second" );
+	REQUIRE( fromFile.getGroups()[1].mFaces.size() == size_t( res * res / 2 ) );
+	REQUIRE( fromFile.getGroups()[1].mFaces[0].mVertexIndices[0] == int( fromFile.getGroups()[0].mFaces.size() / res * ( res + 1 ) ) );
+
+	auto fileMesh = TriMesh::create( fromFile );
+	auto streamMesh = TriMesh::create( fromStream );
+	REQUIRE( fileMesh->getNumTriangles() == res * res * 2 );
+	REQUIRE( fileMesh->getNumVertices() == ( res + 1 ) * ( res + 1 ) );
+	REQUIRE( fileMesh->getIndices() == streamMesh->getIndices() );
+	REQUIRE( std::equal( fileMesh->getPositions<3>(), fileMesh->getPositions<3>() + fileMesh->getNumVertices(), streamMesh->getPositions<3>() ) );
+	REQUIRE( fileMesh->getPositions<3>()[fileMesh->getIndices().back()] == vec3( ( res - 1 ) * 0.25f, res * 0.5f, 0 ) );
+}
+
 } // ObjLoader tests
@@ -1,5 +1,6 @@
 #include "cinder/app/App.h"
 #include "cinder/Path2d.h"
+#include "cinder/Shape2d.h"
 #include "cinder/Rand.h"
 
 #include "catch.hpp"
@@ -170,6 +171,109 @@ TEST_CASE("Path2d")
 		REQUIRE( glm::distance( p.getPosition( t ), vec2( 50, 50 ) ) == Approx( 0 ).epsilon( 0.001 ) );
 	}
 	
+	SECTION("Path2dCalcCache")
+	{
+		Path2d p;
+		p.moveTo( 0, 0 );
+		p.curveTo( 100, 200, 300, -100, 400, 50 );
+		p.lineTo( 500, 300 );
+		p.quadTo( 600, 600, 200, 400 );
+		p.close();
+		Path2dCalcCache cache( p );
+		REQUIRE( cache.getLength() == Approx( p.calcLength() ) );
+
+		vector<float> distances;
+		for( int i = -10; i <= 110; ++i )
+			distances.push_back( cache.getLength() * i / 100.0f );
+		for( float d : distances ) {
+			const float t = cache.calcTimeForDistance( d );
+			REQUIRE( glm::distance( p.getPosition( t ), p.getPosition( p.calcTimeForDistance( d, false, 1.0e-04f, 32 ) ) ) == Approx( 0 ).margin( 0.01 ) );
+			if( d >= 0 && d < cache.getLength() )
+				REQUIRE( cache.calcNormalizedTime( d / cache.getLength() ) == Approx( t ).margin( 1e-5 ) );
+		}
+
+		// batches match individual queries, wrapping around the closed path
+		vector<vec2> positions( distances.size() ), tangents( distances.size() );
+		cache.calcPositionsForDistances( distances.data(), distances.size(), positions.data(), tangents.data(), true );
+		for( size_t i = 0; i < distances.size(); ++i ) {
+			const float t = cache.calcTimeForDistance( distances[i], true );
+			REQUIRE( glm::distance( positions[i], cache.getPosition( t ) ) == Approx( 0 ).margin( 0.01 ) );
+			REQUIRE( glm::distance( tangents[i], cache.getTangent( t ) ) == Approx( 0 ).margin( 0.01 ) );
+		}
+
+		// moving a point only updates the segments using it
+		Path2dCalcCache updated( p );
+		updated.setPoint( 0, vec2( -20, 10 ) );
+		updated.setPoint( 4, vec2( 520, 280 ) );
+		p.setPoint( 0, vec2( -20, 10 ) );
+		p.setPoint( 4, vec2( 520, 280 ) );
+		Path2dCalcCache rebuilt( p );
+		for( size_t s = 0; s < p.getNumSegments(); ++s )
+			REQUIRE( updated.getSegmentLength( s ) == Approx( rebuilt.getSegmentLength( s ) ) );
+		REQUIRE( updated.getLength() == Approx( p.calcLength() ) );
+	}
+
+	SECTION("flatten")
+	{
+		Path2d p;
+		p.moveTo( 0, 0 );
+		p.curveTo( 100, 200, 300, -100, 400, 50 );
+		p.lineTo( 500, 300 );
+		p.quadTo( 600, 600, 200, 400 );
+		p.close();
+
+		for( float scale : { 1.0f, 4.0f } ) {
+			vector<vec2> points( 3 ); // appends to existing contents
+			p.flatten( &points, scale );
+			REQUIRE( points.size() == 3 + p.calcNumFlattenedPoints( scale ) );
+			points.erase( points.begin(), points.begin() + 3 );
+			REQUIRE( points.front() == p.getPoint( 0 ) );
+			REQUIRE( points.back() == p.getPoint( 0 ) );
+			REQUIRE( points.size() < p.subdivide( scale ).size() );
+
+			// every point of the curve lies within the tolerance of the polyline
+			float maxError = 0;
+			for( int i = 0; i <= 1000; ++i ) {
+				const vec2 pt = p.getPosition( i / 1000.0f );
+				float error = FLT_MAX;
+				for( size_t k = 0; k + 1 < points.size(); ++k ) {
+					const vec2 edge = points[k + 1] - points[k];
+					const float t = glm::clamp( dot( pt - points[k], edge ) / dot( edge, edge ), 0.0f, 1.0f );
+					error = std::min( error, glm::distance( pt, points[k] + edge * t ) );
+				}
+				maxError = std::max( maxError, error );
+			}
+			REQUIRE( maxError <= 0.5f / scale );
+		}
+
+		Shape2d shape;
+		shape.appendContour( p );
+		shape.moveTo( 10, 10 );
+		shape.lineTo( 20, 10 );
+		shape.appendContour( p );
+		vector<vec2> points;
+		vector<uint32_t> offsets;
+		shape.flatten( &points, &offsets );
+		REQUIRE( offsets.size() == 4 );
+		REQUIRE( offsets[1] == p.calcNumFlattenedPoints() );
+		REQUIRE( offsets[2] - offsets[1] == 2 );
+		REQUIRE( offsets[3] == points.size() );
+		vector<vec2> single;
+		p.flatten( &single );
+		REQUIRE( std::equal( single.begin(), single.end(), points.begin() + offsets[2] ) );
+
+		Shape2dFlattenCache cache( shape );
+		REQUIRE( cache.isDirty() );
+		REQUIRE( cache.getPoints() == points );
+		REQUIRE( ! cache.isDirty() );
+		cache.getShape2d().translate( vec2( 5, 0 ) );
+		REQUIRE( cache.getPoints() == points );
+		cache.markDirty();
+		REQUIRE( cache.getPoints()[0] == points[0] + vec2( 5, 0 ) );
+		cache.setApproximationScale( 8 );
+		REQUIRE( cache.getContourOffsets().back() > offsets.back() );
+	}
+
 	SECTION("translate")
 	{
 		Path2d p;
@@ -0,0 +1,131 @@
+#include "cinder/Perlin.h"
+#include "cinder/Channel.h"
+#include "cinder/Surface.h"
+#include "cinder/Rand.h"
+
+#include "catch.hpp"
+
+#include <vector>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+template<typename V>
+vector<V> randomPoints( size_t count, float range )
+{
+	Rand rnd( 1234 );
+	vector<V> result( count );
+	for( auto &p : result )
+		for( int c = 0; c < V::length(); ++c )
+			p[c] = rnd.nextFloat( -range, range );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "Perlin batch" )
+{
+	Perlin perlin( 4, 42 );
+	// odd count, so the last group of points is partial
+	const auto points2 = randomPoints<vec2>( 1001, 50.0f );
+	const auto points3 = randomPoints<vec3>( 1001, 50.0f );
+
+	SECTION( "noise and fBm match scalar" )
+	{
+		vector<float> noise2( points2.size() ), noise3( points3.size() ), fbm2( points2.size() ), fbm3( points3.size() );
+		perlin.noise( points2.data(), points2.size(), noise2.data() );
+		perlin.noise( points3.data(), points3.size(), noise3.data() );
+		perlin.fBm( points2.data(), points2.size(), fbm2.data() );
+		perlin.fBm( points3.data(), points3.size(), fbm3.data() );
+		for( size_t i = 0; i < points2.size(); ++i ) {
+			REQUIRE( noise2[i] == Approx( perlin.noise( points2[i] ) ).margin( 1e-5f ) );
+			REQUIRE( noise3[i] == Approx( perlin.noise( points3[i] ) ).margin( 1e-5f ) );
+			REQUIRE( fbm2[i] == Approx( perlin.fBm( points2[i] ) ).margin( 1e-5f ) );
+			REQUIRE( fbm3[i] == Approx( perlin.fBm( points3[i] ) ).margin( 1e-5f ) );
+		}
+	}
+
+	SECTION( "dfBm matches scalar" )
+	{
+		vector<vec2> d2( points2.size() );
+		vector<vec3> d3( points3.size() );
+		perlin.dfBm( points2.data(), points2.size(), d2.data() );
+		perlin.dfBm( points3.data(), points3.size(), d3.data() );
+		for( size_t i = 0; i < points2.size(); ++i ) {
+			REQUIRE( distance( d2[i], perlin.dfBm( points2[i] ) ) < 1e-4f );
+			REQUIRE( distance( d3[i], perlin.dfBm( points3[i] ) ) < 1e-4f );
+		}
+	}
+
+	SECTION( "Channel and Surface fills match scalar" )
+	{
+		Channel32f channel( 37, 23 );
+		Surface32f surface( 37, 23, false );
+		const vec3 origin( 1.5f, -2.0f, 0.25f );
+		const vec2 scale( 0.1f, 0.2f );
+		perlin.fBm( &channel, channel.getBounds(), origin, scale );
+		perlin.dfBm( &surface, surface.getBounds(), vec2( origin ), scale );
+		for( int32_t y = 0; y < channel.getHeight(); ++y ) {
+			for( int32_t x = 0; x < channel.getWidth(); ++x ) {
+				const vec3 p( origin.x + x * scale.x, origin.y + y * scale.y, origin.z );
+				REQUIRE( channel.getValue( ivec2( x, y ) ) == Approx( perlin.fBm( p ) ).margin( 1e-5f ) );
+				const vec2 d = perlin.dfBm( vec2( p ) );
+				const ColorAf c = surface.getPixel( ivec2( x, y ) );
+				REQUIRE( distance( vec2( c.r, c.g ), d ) < 1e-4f );
+			}
+		}
+	}
+}
+
+TEST_CASE( "Simplex" )
+{
+	Simplex simplex( 4, 7 );
+	const auto points2 = randomPoints<vec2>( 503, 20.0f );
+	const auto points3 = randomPoints<vec3>( 503, 20.0f );
+
+	SECTION( "batch matches scalar" )
+	{
+		vector<float> fbm2( points2.size() ), fbm3( points3.size() );
+		vector<vec3> d3( points3.size() );
+		simplex.fBm( points2.data(), points2.size(), fbm2.data() );
+		simplex.fBm( points3.data(), points3.size(), fbm3.data() );
+		simplex.dfBm( points3.data(), points3.size(), d3.data() );
+		for( size_t i = 0; i < points2.size(); ++i ) {
+			REQUIRE( fbm2[i] == Approx( simplex.fBm( points2[i] ) ).margin( 1e-5f ) );
+			REQUIRE( fbm3[i] == Approx( simplex.fBm( points3[i] ) ).margin( 1e-5f ) );
+			REQUIRE( distance( d3[i], simplex.dfBm( points3[i] ) ) < 1e-4f );
+		}
+	}
+
+	SECTION( "noise is bounded and dnoise is its derivative" )
+	{
+		const float h = 1e-3f;
+		for( const auto &p : points3 ) {
+			const float n = simplex.noise( p );
+			REQUIRE( n >= -1.05f );
+			REQUIRE( n <= 1.05f );
+			const vec3 d = simplex.dnoise( p );
+			const vec3 fd( simplex.noise( p + vec3( h, 0, 0 ) ) - simplex.noise( p - vec3( h, 0, 0 ) ),
+						   simplex.noise( p + vec3( 0, h, 0 ) ) - simplex.noise( p - vec3( 0, h, 0 ) ),
+						   simplex.noise( p + vec3( 0, 0, h ) ) - simplex.noise( p - vec3( 0, 0, h ) ) );
+			REQUIRE( distance( d, fd / ( 2 * h ) ) < 0.1f );
+		}
+		for( const auto &p : points2 ) {
+			const vec2 d = simplex.dnoise( p );
+			const vec2 fd( simplex.noise( p + vec2( h, 0 ) ) - simplex.noise( p - vec2( h, 0 ) ),
+						   simplex.noise( p + vec2( 0, h ) ) - simplex.noise( p - vec2( 0, h ) ) );
+			REQUIRE( distance( d, fd / ( 2 * h ) ) < 0.1f );
+		}
+	}
+
+	SECTION( "seed changes the field" )
+	{
+		Simplex other( 4, 8 );
+		float diff = 0;
+		for( const auto &p : points2 )
+			diff += std::abs( simplex.fBm( p ) - other.fBm( p ) );
+		REQUIRE( diff > 1.0f );
+	}
+}
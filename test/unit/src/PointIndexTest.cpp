@@ -0,0 +1,168 @@
+#include "cinder/PointIndex.h"
+
+#include "catch.hpp"
+
+#include <random>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+// clustered points with some exact duplicates, which exercise ties and degenerate splits
+template<typename VecT>
+std::vector<VecT> makePoints( size_t numPoints, std::mt19937 &rng )
+{
+	std::uniform_real_distribution<float> position( -10, 10 ), offset( -0.5f, 0.5f );
+	std::vector<VecT> result;
+	VecT center;
+	for( size_t i = 0; i < numPoints; ++i ) {
+		if( i % 100 == 0 )
+			for( int d = 0; d < PointIndexT<VecT>::DIMS; ++d )
+				center[d] = position( rng );
+		if( i % 37 == 0 && i > 0 )
+			result.push_back( result.back() );
+		else {
+			VecT point = center;
+			for( int d = 0; d < PointIndexT<VecT>::DIMS; ++d )
+				point[d] += offset( rng ) * ( ( i % 3 ) ? 1.0f : 8.0f );
+			result.push_back( point );
+		}
+	}
+	return result;
+}
+
+template<typename VecT>
+std::vector<float> bruteForceDistances( const std::vector<VecT> &points, const VecT &query )
+{
+	std::vector<float> result;
+	for( const auto &point : points )
+		result.push_back( glm::dot( point - query, point - query ) );
+	return result;
+}
+
+template<typename VecT>
+void testPointIndex( uint32_t maxLeafPoints )
+{
+	typedef PointIndexT<VecT> IndexT;
+	typedef typename IndexT::Neighbor Neighbor;
+
+	std::mt19937 rng( 4321 );
+	const std::vector<VecT> points = makePoints<VecT>( 3000, rng );
+	const IndexT index( points, maxLeafPoints );
+	REQUIRE( index.getNumPoints() == points.size() );
+
+	std::vector<VecT> queries = makePoints<VecT>( 200, rng );
+	queries.push_back( points[5] );
+	queries.push_back( VecT( 100 ) );
+
+	const size_t k = 12;
+	const float radius = 0.75f;
+	std::vector<Neighbor> batchKnn( queries.size() * k ), batchRadius( queries.size() * 16 );
+	std::vector<size_t> knnCounts( queries.size() ), radiusCounts( queries.size() );
+	index.findNearest( queries.data(), queries.size(), k, batchKnn.data(), knnCounts.data() );
+	index.findInRadius( queries.data(), queries.size(), radius, batchRadius.data(), 16, radiusCounts.data() );
+
+	for( size_t q = 0; q < queries.size(); ++q ) {
+		const std::vector<float> distances = bruteForceDistances( points, queries[q] );
+		std::vector<float> sorted = distances;
+		std::sort( sorted.begin(), sorted.end() );
+
+		float nearestDistance;
+		const uint32_t nearest = index.findNearest( queries[q], &nearestDistance );
+		REQUIRE( nearest < points.size() );
+		REQUIRE( nearestDistance == sorted[0] );
+		REQUIRE( distances[nearest] == sorted[0] );
+
+		Neighbor knn[k];
+		REQUIRE( index.findNearest( queries[q], k, knn ) == k );
+		REQUIRE( knnCounts[q] == k );
+		for( size_t i = 0; i < k; ++i ) {
+			REQUIRE( knn[i].mDistanceSquared == sorted[i] );
+			REQUIRE( distances[knn[i].mIndex] == sorted[i] );
+			REQUIRE( batchKnn[q * k + i].mDistanceSquared == sorted[i] );
+		}
+
+		// enough neighbors to switch to a heap
+		Neighbor manyKnn[40];
+		REQUIRE( index.findNearest( queries[q], 40, manyKnn ) == 40 );
+		for( size_t i = 0; i < 40; ++i )
+			REQUIRE( manyKnn[i].mDistanceSquared == sorted[i] );
+
+		std::vector<uint32_t> expected;
+		for( size_t i = 0; i < points.size(); ++i )
+			if( distances[i] <= radius * radius )
+				expected.push_back( (uint32_t)i );
+		std::vector<Neighbor> found;
+		REQUIRE( index.findInRadius( queries[q], radius, &found ) == expected.size() );
+		std::vector<uint32_t> foundIndices;
+		for( const auto &neighbor : found ) {
+			foundIndices.push_back( neighbor.mIndex );
+			REQUIRE( neighbor.mDistanceSquared == distances[neighbor.mIndex] );
+		}
+		std::sort( foundIndices.begin(), foundIndices.end() );
+		REQUIRE( foundIndices == expected );
+
+		REQUIRE( radiusCounts[q] == expected.size() );
+		for( size_t i = 0; i < std::min<size_t>( radiusCounts[q], 16 ); ++i )
+			REQUIRE( std::binary_search( expected.begin(), expected.end(), batchRadius[q * 16 + i].mIndex ) );
+
+		// a limited search only reports points within its maximum distance
+		const float maxDistance = std::sqrt( sorted[3] );
+		const size_t limited = index.findNearest( queries[q], k, knn, maxDistance );
+		REQUIRE( limited == (size_t)( std::upper_bound( sorted.begin(), sorted.end(), maxDistance * maxDistance ) - sorted.begin() ) );
+		REQUIRE( index.findNearest( queries[q], nullptr, std::sqrt( sorted[0] ) * 0.99f ) == ( sorted[0] > 0 ? IndexT::INVALID_INDEX : nearest ) );
+	}
+}
+
+} // anonymous namespace
+
+TEST_CASE( "PointIndex" )
+{
+	SECTION( "Queries match a brute force search in 3D" )
+	{
+		testPointIndex<vec3>( 8 );
+		testPointIndex<vec3>( 1 );
+	}
+
+	SECTION( "Queries match a brute force search in 2D" )
+	{
+		testPointIndex<vec2>( 8 );
+		testPointIndex<vec2>( 33 );
+	}
+
+	SECTION( "Large indices are built in parallel" )
+	{
+		std::mt19937 rng( 99 );
+		const std::vector<vec3> points = makePoints<vec3>( 40000, rng );
+		const PointIndex3 index( points );
+		for( const auto &query : makePoints<vec3>( 50, rng ) ) {
+			const std::vector<float> distances = bruteForceDistances( points, query );
+			float nearestDistance;
+			index.findNearest( query, &nearestDistance );
+			REQUIRE( nearestDistance == *std::min_element( distances.begin(), distances.end() ) );
+			std::vector<PointIndex3::Neighbor> found;
+			REQUIRE( index.findInRadius( query, 0.5f, &found ) == (size_t)std::count_if( distances.begin(), distances.end(), []( float d ) { return d <= 0.25f; } ) );
+		}
+	}
+
+	SECTION( "Empty and tiny indices" )
+	{
+		PointIndex3 index;
+		PointIndex3::Neighbor neighbors[4];
+		REQUIRE( index.empty() );
+		REQUIRE( index.findNearest( vec3( 0 ) ) == PointIndex3::INVALID_INDEX );
+		REQUIRE( index.findNearest( vec3( 0 ), 4, neighbors ) == 0 );
+		REQUIRE( index.findInRadius( vec3( 0 ), 1.0f, neighbors, 4 ) == 0 );
+
+		const std::vector<vec3> points = { vec3( 1, 0, 0 ), vec3( 0, 2, 0 ) };
+		index.build( points );
+		REQUIRE( index.findNearest( vec3( 0 ), 4, neighbors ) == 2 );
+		REQUIRE( neighbors[0].mIndex == 0 );
+		REQUIRE( neighbors[1].mIndex == 1 );
+		REQUIRE( neighbors[1].mDistanceSquared == 4.0f );
+		REQUIRE( index.findInRadius( vec3( 0 ), 2.0f, neighbors, 1 ) == 2 );
+		REQUIRE( index.findInRadius( vec3( 0 ), -1.0f, neighbors, 4 ) == 0 );
+		REQUIRE( index.findNearest( vec3( 0 ), 0, neighbors ) == 0 );
+	}
+}
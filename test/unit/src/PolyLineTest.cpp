@@ -178,5 +178,86 @@ TEST_CASE("PolyLine2f")
 
 		CHECK( poly.calcCentroid() == vec2( 0.5, 0.5 ) );
 	}
-}
 
+	SECTION("simplify")
+	{
+		// a noisy wave, sampled densely
+		PolyLine2f wave;
+		for( int i = 0; i <= 2000; ++i )
+			wave.push_back( vec2( i * 0.1f, sin( i * 0.01f ) * 20 + ( ( i * 7919 ) % 13 ) * 0.01f ) );
+
+		auto distanceToLine = []( const vec2 &p, const PolyLine2f &line ) {
+			float result = FLT_MAX;
+			for( size_t s = 0; s + 1 < line.size(); ++s ) {
+				const vec2 &a = line.getPoints()[s], &b = line.getPoints()[s + 1];
+				const float t = glm::clamp( dot( p - a, b - a ) / dot( b - a, b - a ), 0.0f, 1.0f );
+				result = std::min( result, distance( p, a + ( b - a ) * t ) );
+			}
+			return result;
+		};
+
+		PolyLine2f douglasPeucker = wave.simplified( 0.25f );
+		CHECK( douglasPeucker.size() < wave.size() / 10 );
+		CHECK( douglasPeucker.getPoints().front() == wave.getPoints().front() );
+		CHECK( douglasPeucker.getPoints().back() == wave.getPoints().back() );
+		float maxDistance = 0;
+		for( const auto &p : wave )
+			maxDistance = std::max( maxDistance, distanceToLine( p, douglasPeucker ) );
+		CHECK( maxDistance <= 0.25f );
+
+		PolyLine2f visvalingam = wave.simplified( 0.5f, PolyLine2f::SIMPLIFY_VISVALINGAM );
+		CHECK( visvalingam.size() < wave.size() / 4 );
+		CHECK( visvalingam.getPoints().front() == wave.getPoints().front() );
+		CHECK( visvalingam.getPoints().back() == wave.getPoints().back() );
+
+		// a closed square with a nearly straight extra point
+		PolyLine2f square( { vec2( 0, 0 ), vec2( 5, 0.01f ), vec2( 10, 0 ), vec2( 10, 10 ), vec2( 0, 10 ) }, true );
+		CHECK( square.simplified( 0.1f ).size() == 4 );
+		CHECK( square.simplified( 1.0f, PolyLine2f::SIMPLIFY_VISVALINGAM ).size() == 4 );
+		CHECK( square.simplified( 1000.0f, PolyLine2f::SIMPLIFY_VISVALINGAM ).size() == 3 );
+
+		vector<PolyLine2f> batch( 100, wave );
+		PolyLine2f::simplify( &batch, 0.25f );
+		for( const auto &line : batch )
+			CHECK( line.getPoints() == douglasPeucker.getPoints() );
+	}
+
+	SECTION("resampleUniform")
+	{
+		PolyLine2f corner( { vec2( 0, 0 ), vec2( 10, 0 ), vec2( 10, 10 ) } );
+		PolyLine2f resampled = corner.resampledUniform( 1.9f );
+		// a length of 20 is divided into 11 intervals of 20 / 11
+		REQUIRE( resampled.size() == 12 );
+		CHECK( resampled.getPoints().front() == corner.getPoints().front() );
+		CHECK( resampled.getPoints().back() == corner.getPoints().back() );
+		for( size_t i = 1; i < 5; ++i )
+			CHECK( resampled.getPoints()[i].x == Approx( i * 20 / 11.0f ) );
+
+		PolyLine2f square( { vec2( 0, 0 ), vec2( 10, 0 ), vec2( 10, 10 ), vec2( 0, 10 ) }, true );
+		CHECK( square.resampledUniform( 1 ).size() == 40 );
+	}
+
+	SECTION("smooth")
+	{
+		PolyLine2f corner( { vec2( 0, 0 ), vec2( 10, 0 ), vec2( 10, 10 ) } );
+		PolyLine2f chaikin = corner.smoothed( PolyLine2f::SMOOTH_CHAIKIN, 2 );
+		CHECK( chaikin.size() == 12 );
+		CHECK( chaikin.getPoints().front() == corner.getPoints().front() );
+		CHECK( chaikin.getPoints().back() == corner.getPoints().back() );
+		CHECK( chaikin.getPoints()[1] == vec2( 0.625f, 0 ) );
+
+		PolyLine2f catmullRom = corner.smoothed( PolyLine2f::SMOOTH_CATMULL_ROM, 3 );
+		REQUIRE( catmullRom.size() == 9 );
+		// the spline passes through the original points
+		CHECK( catmullRom.getPoints()[0] == corner.getPoints()[0] );
+		CHECK( catmullRom.getPoints()[4] == corner.getPoints()[1] );
+		CHECK( catmullRom.getPoints()[8] == corner.getPoints()[2] );
+		// and bulges outward around the corner
+		CHECK( catmullRom.getPoints()[3].y < 0 );
+		CHECK( catmullRom.getPoints()[5].x > 10 );
+
+		PolyLine2f square( { vec2( 0, 0 ), vec2( 10, 0 ), vec2( 10, 10 ), vec2( 0, 10 ) }, true );
+		CHECK( square.smoothed( PolyLine2f::SMOOTH_CHAIKIN, 1 ).size() == 8 );
+		CHECK( square.smoothed( PolyLine2f::SMOOTH_CATMULL_ROM, 1 ).size() == 8 );
+	}
+}
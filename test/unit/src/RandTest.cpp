@@ -5,6 +5,7 @@
 #include "catch.hpp"
 
 #include <algorithm>
+#include <thread>
 
 using namespace ci;
 using namespace ci::app;
@@ -133,3 +134,106 @@ TEST_CASE("Rand", "[noisy]")
 	}
 	#endif // not DEBUG
 } // rand
+
+TEST_CASE("FastRand")
+{
+	SECTION("the same seed and stream repeat, other streams differ")
+	{
+		FastRand a( 1234, 0 ), b( 1234, 0 ), c( 1234, 1 );
+		int numDifferent = 0;
+		for( int i = 0; i < 1000; ++i ) {
+			const uint32_t v = a.nextUint();
+			REQUIRE( v == b.nextUint() );
+			if( v != c.nextUint() )
+				++numDifferent;
+		}
+		REQUIRE( numDifferent > 990 );
+	}
+
+	SECTION("fills return the same values as a series of next calls")
+	{
+		FastRand a( 99 ), b( 99 );
+		// start partway through the buffered words
+		for( int i = 0; i < 5; ++i )
+			REQUIRE( a.nextUint() == b.nextUint() );
+
+		vector<float> floats( 10007 );
+		a.fill( floats.data(), floats.size(), -2.0f, 3.0f );
+		for( float v : floats )
+			REQUIRE( v == b.nextFloat( -2.0f, 3.0f ) );
+
+		vector<uint32_t> uints( 333 );
+		a.fill( uints.data(), uints.size() );
+		for( uint32_t v : uints )
+			REQUIRE( v == b.nextUint() );
+
+		vector<float> gaussians( 1000 );
+		a.fillGaussian( gaussians.data(), gaussians.size() );
+		for( float v : gaussians )
+			REQUIRE( v == b.nextGaussian() );
+
+		vector<vec3> points( 100 );
+		a.fillVec3OnSphere( points.data(), points.size() );
+		for( const vec3 &p : points )
+			REQUIRE( p == b.nextVec3() );
+		REQUIRE( a.nextUint() == b.nextUint() );
+	}
+
+	SECTION("values are in range")
+	{
+		FastRand rnd;
+		for( int i = 0; i < 10000; ++i ) {
+			const float f = rnd.nextFloat( 2.0f, 10.0f );
+			REQUIRE( f >= 2.0f );
+			REQUIRE( f < 10.0f );
+			const int32_t v = rnd.nextInt( 345, 6789 );
+			REQUIRE( v >= 345 );
+			REQUIRE( v < 6789 );
+		}
+		REQUIRE( rnd.nextUint( 0 ) == 0 );
+
+		vector<vec3> points( 10000 );
+		rnd.fillVec3OnSphere( points.data(), points.size() );
+		vec3 sum( 0 );
+		for( const vec3 &p : points ) {
+			REQUIRE( length( p ) == Approx( 1.0f ).epsilon( 1e-4f ) );
+			sum += p;
+		}
+		REQUIRE( length( sum / (float)points.size() ) < 0.05f );
+	}
+
+	SECTION("fillGaussian() has the requested mean and standard deviation")
+	{
+		FastRand rnd( 7 );
+		vector<float> values( 200000 );
+		rnd.fillGaussian( values.data(), values.size(), 5.0f, 2.0f );
+		double sum = 0, sumSquares = 0;
+		size_t numBeyond3Sigma = 0;
+		for( float v : values ) {
+			sum += v;
+			sumSquares += (double)v * v;
+			if( std::abs( v - 5.0f ) > 6.0f )
+				++numBeyond3Sigma;
+		}
+		const double mean = sum / values.size(), variance = sumSquares / values.size() - mean * mean;
+		REQUIRE( mean == Approx( 5.0 ).margin( 0.02 ) );
+		REQUIRE( std::sqrt( variance ) == Approx( 2.0 ).epsilon( 0.01 ) );
+		// 0.27% of a normal distribution lies beyond 3 standard deviations
+		REQUIRE( numBeyond3Sigma / (double)values.size() == Approx( 0.0027 ).margin( 0.0006 ) );
+	}
+
+	SECTION("seedThreadLocal() makes a thread's stream reproducible")
+	{
+		vector<uint32_t> fromThread( 100 );
+		std::thread thread( [&] {
+			FastRand::seedThreadLocal( 42, 3 );
+			FastRand::threadLocal().fill( fromThread.data(), fromThread.size() );
+		} );
+		thread.join();
+
+		FastRand expected( 42, 3 );
+		for( uint32_t v : fromThread )
+			REQUIRE( v == expected.nextUint() );
+		REQUIRE( &FastRand::threadLocal() == &FastRand::threadLocal() );
+	}
+}
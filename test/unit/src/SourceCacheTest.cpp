@@ -0,0 +1,184 @@
+#include "cinder/TriMesh.h"
+#include "cinder/GeomIo.h"
+
+#include "catch.hpp"
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+bool sameMesh( const TriMesh &a, const TriMesh &b )
+{
+	if( a.getNumVertices() != b.getNumVertices() || a.getIndices() != b.getIndices() )
+		return false;
+	for( size_t v = 0; v < a.getNumVertices(); ++v ) {
+		if( a.getPositions<3>()[v] != b.getPositions<3>()[v] || a.getNormals()[v] != b.getNormals()[v] || a.getTexCoords0<2>()[v] != b.getTexCoords0<2>()[v] )
+			return false;
+	}
+	return true;
+}
+
+const geom::AttribSet sAttribs = { geom::POSITION, geom::NORMAL, geom::TEX_COORD_0 };
+
+// A subclass with state of its own, which Sphere's cache key doesn't capture
+class TaggedSphere : public geom::Sphere {
+  public:
+	TaggedSphere( int tag ) : mTag( tag ) {}
+
+  protected:
+	int		mTag;
+};
+
+class KeyedSphere : public TaggedSphere {
+  public:
+	KeyedSphere( int tag ) : TaggedSphere( tag ) {}
+
+	bool calcCacheKey( geom::CacheKey *key ) const override
+	{
+		if( ! key->appendType( *this ) )
+			return false;
+		*key << mTag << mCenter << mRadius << mSubdivisions << mHasColors;
+		return true;
+	}
+};
+
+} // anonymous namespace
+
+TEST_CASE( "SourceCache" )
+{
+	SECTION( "Cache keys identify type and parameters" )
+	{
+		geom::CacheKey a, b, c, d;
+		REQUIRE( geom::Sphere().radius( 2 ).calcCacheKey( &a ) );
+		REQUIRE( geom::Sphere().radius( 2 ).calcCacheKey( &b ) );
+		REQUIRE( geom::Sphere().radius( 3 ).calcCacheKey( &c ) );
+		REQUIRE( geom::Icosphere().calcCacheKey( &d ) );
+		REQUIRE( a == b );
+		REQUIRE( a != c );
+		REQUIRE( a != d );
+		geom::CacheKey rect;
+		REQUIRE_FALSE( geom::Rect().calcCacheKey( &rect ) );
+	}
+
+	SECTION( "Subclasses are only cached when they override calcCacheKey()" )
+	{
+		geom::CacheKey tagged, keyed1, keyed2, sphere;
+		REQUIRE_FALSE( TaggedSphere( 1 ).calcCacheKey( &tagged ) );
+		REQUIRE( KeyedSphere( 1 ).calcCacheKey( &keyed1 ) );
+		REQUIRE( KeyedSphere( 2 ).calcCacheKey( &keyed2 ) );
+		REQUIRE( geom::Sphere().calcCacheKey( &sphere ) );
+		REQUIRE( keyed1 != keyed2 );
+		REQUIRE( keyed1 != sphere );
+
+		geom::SourceCache cache;
+		REQUIRE( cache.get( TaggedSphere( 1 ), sAttribs ) != cache.get( TaggedSphere( 1 ), sAttribs ) );
+		REQUIRE( cache.getNumEntries() == 0 );
+		REQUIRE( cache.get( KeyedSphere( 1 ), sAttribs ) == cache.get( KeyedSphere( 1 ), sAttribs ) );
+		REQUIRE( cache.getNumEntries() == 1 );
+
+		// library subclasses which only preset parameters are cached, keyed by their own type
+		geom::CacheKey helix, torus, translate, transform;
+		REQUIRE( geom::Helix().calcCacheKey( &helix ) );
+		REQUIRE( geom::Torus().calcCacheKey( &torus ) );
+		REQUIRE( helix != torus );
+		REQUIRE( geom::Translate( 1, 2, 3 ).calcCacheKey( &translate ) );
+		REQUIRE( geom::Transform( glm::translate( vec3( 1, 2, 3 ) ) ).calcCacheKey( &transform ) );
+		REQUIRE( translate != transform );
+	}
+
+	SECTION( "Equal Sources share their geometry" )
+	{
+		geom::SourceCache cache;
+		auto first = cache.get( geom::Sphere().subdivisions( 40 ), sAttribs );
+		auto second = cache.get( geom::Sphere().subdivisions( 40 ), sAttribs );
+		REQUIRE( first == second );
+		REQUIRE( cache.getNumHits() == 1 );
+		REQUIRE( cache.getNumMisses() == 1 );
+		REQUIRE( cache.getNumEntries() == 1 );
+		REQUIRE( cache.getNumBytes() == first->getNumBytes() );
+
+		// other parameters or attributes are separate entries
+		auto bigger = cache.get( geom::Sphere().subdivisions( 40 ).radius( 2 ), sAttribs );
+		auto positions = cache.get( geom::Sphere().subdivisions( 40 ), { geom::POSITION } );
+		REQUIRE( bigger != first );
+		REQUIRE( positions != first );
+		REQUIRE( positions->getAttribData( geom::NORMAL ) == nullptr );
+		REQUIRE( cache.getNumEntries() == 3 );
+		REQUIRE( cache.getNumMisses() == 3 );
+	}
+
+	SECTION( "Cached geometry matches the Source" )
+	{
+		geom::SourceCache cache;
+		auto source = geom::Torus().subdivisionsAxis( 50 ).subdivisionsHeight( 20 ) >> geom::Translate( 1, 2, 3 ) >> geom::Twist();
+		TriMesh direct( source, TriMesh::Format().positions().normals().texCoords() );
+		TriMesh cold( *cache.get( source, sAttribs ), TriMesh::Format().positions().normals().texCoords() );
+		TriMesh warm( *cache.get( source, sAttribs ), TriMesh::Format().positions().normals().texCoords() );
+		REQUIRE( cache.getNumHits() == 1 );
+		REQUIRE( sameMesh( direct, cold ) );
+		REQUIRE( sameMesh( direct, warm ) );
+
+		auto cached = cache.get( source, sAttribs );
+		REQUIRE( cached->getAttribDims( geom::POSITION ) == 3 );
+		REQUIRE( cached->getIndices() == direct.getIndices() );
+		REQUIRE( equal( direct.getPositions<3>(), direct.getPositions<3>() + direct.getNumVertices(), reinterpret_cast<const vec3*>( cached->getAttribData( geom::POSITION ) ) ) );
+		REQUIRE( cache.getNumHits() == 2 );
+	}
+
+	SECTION( "Modifier chains with functions aren't cached" )
+	{
+		geom::SourceCache cache;
+		auto source = geom::Sphere() >> geom::AttribFn<vec3, vec3>( geom::POSITION, []( vec3 p ) { return p * 2.0f; } );
+		geom::CacheKey key;
+		REQUIRE_FALSE( source.calcCacheKey( &key ) );
+		auto first = cache.get( source, sAttribs );
+		auto second = cache.get( source, sAttribs );
+		REQUIRE( first != second );
+		REQUIRE( first->getNumVertices() == second->getNumVertices() );
+		REQUIRE( cache.getNumEntries() == 0 );
+		REQUIRE( cache.getNumMisses() == 0 );
+	}
+
+	SECTION( "Least recently used geometry is evicted" )
+	{
+		geom::SourceCache cache;
+		size_t sphereBytes = cache.get( geom::Sphere().subdivisions( 30 ), sAttribs )->getNumBytes();
+		cache.clear();
+		cache.setMaxBytes( sphereBytes * 2 );
+		cache.get( geom::Sphere().subdivisions( 30 ).radius( 1 ), sAttribs );
+		cache.get( geom::Sphere().subdivisions( 30 ).radius( 2 ), sAttribs );
+		cache.get( geom::Sphere().subdivisions( 30 ).radius( 1 ), sAttribs );
+		cache.get( geom::Sphere().subdivisions( 30 ).radius( 3 ), sAttribs );
+		REQUIRE( cache.getNumEntries() == 2 );
+		REQUIRE( cache.getNumBytes() <= cache.getMaxBytes() );
+
+		size_t hits = cache.getNumHits();
+		cache.get( geom::Sphere().subdivisions( 30 ).radius( 1 ), sAttribs );
+		REQUIRE( cache.getNumHits() == hits + 1 );
+		cache.get( geom::Sphere().subdivisions( 30 ).radius( 2 ), sAttribs );
+		REQUIRE( cache.getNumHits() == hits + 1 );
+
+		cache.setMaxBytes( 0 );
+		REQUIRE( cache.getNumEntries() == 0 );
+		REQUIRE( cache.getNumBytes() == 0 );
+	}
+
+	SECTION( "Geometry estimated to exceed the budget isn't kept" )
+	{
+		auto source = geom::Sphere().subdivisions( 40 );
+		const size_t estimatedBytes = ( source.getNumVertices() * 8 + source.getNumIndices() ) * sizeof( float );
+		geom::SourceCache cache( estimatedBytes - 1 );
+		auto first = cache.get( source, sAttribs );
+		auto second = cache.get( source, sAttribs );
+		REQUIRE( first != second );
+		REQUIRE( first->getNumVertices() == source.getNumVertices() );
+		REQUIRE( first->getIndices().size() == source.getNumIndices() );
+		REQUIRE( cache.getNumEntries() == 0 );
+		REQUIRE( cache.getNumBytes() == 0 );
+
+		cache.setMaxBytes( estimatedBytes );
+		REQUIRE( cache.get( source, sAttribs ) == cache.get( source, sAttribs ) );
+		REQUIRE( cache.getNumBytes() == estimatedBytes );
+	}
+}
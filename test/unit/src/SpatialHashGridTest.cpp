@@ -0,0 +1,198 @@
+#include "cinder/SpatialHashGrid.h"
+
+#include "catch.hpp"
+
+#include <random>
+#include <set>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+template<typename VecT>
+std::vector<VecT> makePoints( size_t numPoints, float extent, std::mt19937 &rng )
+{
+	std::uniform_real_distribution<float> position( -extent, extent );
+	std::vector<VecT> result( numPoints );
+	for( auto &point : result )
+		for( int d = 0; d < SpatialHashGridT<VecT>::DIMS; ++d )
+			point[d] = position( rng );
+	// exact duplicates and points on cell boundaries
+	for( size_t i = 0; i + 1 < numPoints; i += 97 )
+		result[i + 1] = result[i];
+	for( size_t i = 2; i < numPoints; i += 89 )
+		result[i] = glm::floor( result[i] );
+	return result;
+}
+
+template<typename VecT>
+void testGrid( size_t numPoints, float extent, float cellSize, size_t tableSize )
+{
+	typedef SpatialHashGridT<VecT> GridT;
+
+	std::mt19937 rng( 5678 );
+	const std::vector<VecT> points = makePoints<VecT>( numPoints, extent, rng );
+	GridT grid( cellSize, tableSize );
+	grid.build( points );
+	REQUIRE( grid.getNumPoints() == points.size() );
+
+	// the sorted arrays are a permutation of the input
+	std::vector<uint32_t> sortedIndices = grid.getSortedIndices();
+	for( size_t p = 0; p < sortedIndices.size(); ++p )
+		REQUIRE( grid.getSortedPoints()[p] == points[sortedIndices[p]] );
+	std::sort( sortedIndices.begin(), sortedIndices.end() );
+	for( size_t i = 0; i < sortedIndices.size(); ++i )
+		REQUIRE( sortedIndices[i] == i );
+
+	for( const auto &query : makePoints<VecT>( 100, extent * 1.1f, rng ) ) {
+		for( float radius : { cellSize * 0.5f, cellSize, cellSize * 2.5f } ) {
+			std::vector<uint32_t> expected, found;
+			for( size_t i = 0; i < points.size(); ++i )
+				if( glm::dot( points[i] - query, points[i] - query ) <= radius * radius )
+					expected.push_back( (uint32_t)i );
+			REQUIRE( grid.findInRadius( query, radius, &found ) == expected.size() );
+			std::sort( found.begin(), found.end() );
+			REQUIRE( found == expected );
+		}
+
+		std::vector<uint32_t> neighborhood;
+		grid.forEachInNeighborhood( query, [&]( uint32_t index ) { neighborhood.push_back( index ); } );
+		std::sort( neighborhood.begin(), neighborhood.end() );
+		REQUIRE( std::adjacent_find( neighborhood.begin(), neighborhood.end() ) == neighborhood.end() );
+		for( size_t i = 0; i < points.size(); ++i ) {
+			const bool adjacent = glm::all( glm::lessThanEqual( glm::abs( grid.getCell( points[i] ) - grid.getCell( query ) ), typename GridT::CellT( 1 ) ) );
+			REQUIRE( std::binary_search( neighborhood.begin(), neighborhood.end(), (uint32_t)i ) == adjacent );
+		}
+	}
+
+	const float radius = cellSize * 0.8f;
+	std::set<std::pair<uint32_t, uint32_t>> expectedPairs;
+	for( uint32_t i = 0; i < points.size(); ++i )
+		for( uint32_t j = i + 1; j < points.size(); ++j )
+			if( glm::dot( points[i] - points[j], points[i] - points[j] ) <= radius * radius )
+				expectedPairs.insert( std::make_pair( i, j ) );
+
+	// pairs gathered in chunks are each reported once, in either order
+	std::vector<std::pair<uint32_t, uint32_t>> pairs;
+	const size_t chunk = points.size() / 3 + 1;
+	for( size_t begin = 0; begin < points.size(); begin += chunk )
+		grid.forEachPair( radius, begin, std::min( begin + chunk, points.size() ), [&]( uint32_t a, uint32_t b, float d2 ) {
+			REQUIRE( d2 == glm::dot( points[a] - points[b], points[a] - points[b] ) );
+			pairs.push_back( std::make_pair( std::min( a, b ), std::max( a, b ) ) );
+		} );
+	REQUIRE( pairs.size() == expectedPairs.size() );
+	REQUIRE( std::set<std::pair<uint32_t, uint32_t>>( pairs.begin(), pairs.end() ) == expectedPairs );
+
+	// calls for each index come from a single thread, so per-index tallies need no synchronization
+	std::vector<uint32_t> neighborCounts( points.size(), 0 ), selfCounts( points.size(), 0 );
+	grid.forEachNeighborParallel( radius, [&]( uint32_t index, uint32_t neighbor, float ) {
+		++neighborCounts[index];
+		selfCounts[index] += ( index == neighbor ) ? 1 : 0;
+	} );
+	REQUIRE( std::count( selfCounts.begin(), selfCounts.end(), 0u ) == (ptrdiff_t)points.size() );
+	std::vector<uint32_t> expectedCounts( points.size(), 0 );
+	for( const auto &pair : expectedPairs ) {
+		++expectedCounts[pair.first];
+		++expectedCounts[pair.second];
+	}
+	REQUIRE( neighborCounts == expectedCounts );
+}
+
+// Exposes how the grid's cells are distributed over its buckets
+class BucketStatsGrid : public SpatialHashGrid3 {
+  public:
+	BucketStatsGrid( float cellSize ) : SpatialHashGrid3( cellSize ) {}
+
+	size_t	calcNumOccupiedBuckets() const
+	{
+		size_t result = 0;
+		for( size_t b = 0; b < getTableSize(); ++b )
+			result += ( mCellStart[b + 1] > mCellStart[b] ) ? 1 : 0;
+		return result;
+	}
+
+	size_t	calcMaxBucketSize() const
+	{
+		size_t result = 0;
+		for( size_t b = 0; b < getTableSize(); ++b )
+			result = std::max<size_t>( result, mCellStart[b + 1] - mCellStart[b] );
+		return result;
+	}
+};
+
+} // anonymous namespace
+
+TEST_CASE( "SpatialHashGrid" )
+{
+	SECTION( "Queries match a brute force search in 3D" )
+	{
+		testGrid<vec3>( 2000, 10, 1.0f, 0 );
+	}
+
+	SECTION( "Queries match a brute force search in 2D" )
+	{
+		testGrid<vec2>( 2000, 10, 0.5f, 0 );
+	}
+
+	SECTION( "Colliding buckets are told apart" )
+	{
+		testGrid<vec3>( 1000, 20, 1.0f, 16 );
+		testGrid<vec2>( 1000, 20, 1.0f, 3 );
+	}
+
+	SECTION( "Planar point sets spread over the buckets" )
+	{
+		// one point in each cell of a 64x64 patch of the z = 0 and then the y = 0 plane
+		for( int plane : { 2, 1 } ) {
+			std::vector<vec3> points;
+			for( int u = 0; u < 64; ++u ) {
+				for( int v = 0; v < 64; ++v ) {
+					vec3 point( 0.5f );
+					point[( plane + 1 ) % 3] = u + 0.5f;
+					point[( plane + 2 ) % 3] = v + 0.5f;
+					points.push_back( point );
+				}
+			}
+			BucketStatsGrid grid( 1.0f );
+			grid.build( points );
+			REQUIRE( grid.getTableSize() == 8192 );
+			// a uniform hash occupies about 1 - e^-0.5 of the table; the coordinates' low bits alone would occupy 512 buckets
+			REQUIRE( grid.calcNumOccupiedBuckets() > 3000 );
+			REQUIRE( grid.calcMaxBucketSize() <= 8 );
+		}
+	}
+
+	SECTION( "Rebuilding follows moved points" )
+	{
+		std::mt19937 rng( 11 );
+		std::vector<vec3> points = makePoints<vec3>( 50000, 30, rng );
+		SpatialHashGrid3 grid( 1.0f );
+		grid.build( points );
+		for( auto &point : points )
+			point += vec3( 100, -3, 0.5f );
+		grid.build( points );
+
+		const vec3 query = points[123];
+		std::vector<uint32_t> found, expected;
+		grid.findInRadius( query, 1.5f, &found );
+		for( size_t i = 0; i < points.size(); ++i )
+			if( distance2( points[i], query ) <= 1.5f * 1.5f )
+				expected.push_back( (uint32_t)i );
+		std::sort( found.begin(), found.end() );
+		REQUIRE( found == expected );
+		REQUIRE( grid.getTableSize() == 128 * 1024 );
+	}
+
+	SECTION( "Empty grids" )
+	{
+		SpatialHashGrid2 grid( 1.0f );
+		std::vector<uint32_t> found;
+		REQUIRE( grid.findInRadius( vec2( 0 ), 1.0f, &found ) == 0 );
+		grid.build( std::vector<vec2>() );
+		REQUIRE( grid.findInRadius( vec2( 0 ), 1.0f, &found ) == 0 );
+		size_t numPairs = 0;
+		grid.forEachPair( 1.0f, [&]( uint32_t, uint32_t, float ) { ++numPairs; } );
+		REQUIRE( numPairs == 0 );
+	}
+}
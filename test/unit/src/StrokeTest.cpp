@@ -0,0 +1,132 @@
+#include "cinder/GeomIo.h"
+#include "cinder/TriMesh.h"
+
+#include "catch.hpp"
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+//! Returns the total area of the triangles, counting overlaps more than once
+double calcCoveredArea( const TriMesh &mesh )
+{
+	double result = 0;
+	const vec2 *positions = mesh.getPositions<2>();
+	const auto &indices = mesh.getIndices();
+	for( size_t t = 0; t < indices.size(); t += 3 ) {
+		const vec2 &a = positions[indices[t]], &b = positions[indices[t + 1]], &c = positions[indices[t + 2]];
+		result += 0.5 * fabs( ( (double)b.x - a.x ) * ( (double)c.y - a.y ) - ( (double)b.y - a.y ) * ( (double)c.x - a.x ) );
+	}
+	return result;
+}
+
+TriMesh strokeMesh( const geom::Stroke &stroke )
+{
+	return TriMesh( stroke, TriMesh::Format().positions( 2 ).texCoords0( 2 ).colors( 4 ) );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "Stroke" )
+{
+	// two 100-long segments, 10 wide, turning 90 degrees
+	const PolyLine2f corner( { vec2( 0, 0 ), vec2( 100, 0 ), vec2( 100, 100 ) } );
+
+	SECTION( "Joins fill the outside of each turn" )
+	{
+		REQUIRE( calcCoveredArea( strokeMesh( geom::Stroke( corner, 10 ).join( geom::Stroke::JOIN_MITER ) ) ) == Approx( 2025 ) );
+		REQUIRE( calcCoveredArea( strokeMesh( geom::Stroke( corner, 10 ).join( geom::Stroke::JOIN_BEVEL ) ) ) == Approx( 2012.5 ) );
+		const double round = calcCoveredArea( strokeMesh( geom::Stroke( corner, 10 ).join( geom::Stroke::JOIN_ROUND ) ) );
+		REQUIRE( round > 2012.5 );
+		REQUIRE( round <= 2000 + M_PI * 25 / 4 );
+	}
+
+	SECTION( "Sharp miters fall back to bevels beyond the miter limit" )
+	{
+		const PolyLine2f spike( { vec2( 0, 0 ), vec2( 100, 0 ), vec2( 0, 10 ) } );
+		const size_t beveled = strokeMesh( geom::Stroke( spike, 10 ) ).getNumVertices();
+		const size_t mitered = strokeMesh( geom::Stroke( spike, 10 ).miterLimit( 100 ) ).getNumVertices();
+		REQUIRE( mitered == beveled + 1 );
+	}
+
+	SECTION( "Caps extend open lines" )
+	{
+		REQUIRE( calcCoveredArea( strokeMesh( geom::Stroke( corner, 10 ).cap( geom::Stroke::CAP_SQUARE ) ) ) == Approx( 2125 ) );
+		const double round = calcCoveredArea( strokeMesh( geom::Stroke( corner, 10 ).cap( geom::Stroke::CAP_ROUND ) ) );
+		REQUIRE( round > 2025 + 50 );
+		REQUIRE( round <= 2025 + M_PI * 25 );
+	}
+
+	SECTION( "Closed lines are joined all around" )
+	{
+		PolyLine2f square( { vec2( 0, 0 ), vec2( 100, 0 ), vec2( 100, 100 ), vec2( 0, 100 ) } );
+		square.setClosed();
+		REQUIRE( calcCoveredArea( strokeMesh( geom::Stroke( square, 10 ) ) ) == Approx( 4100 ) );
+
+		Path2d path;
+		path.moveTo( 0, 0 );
+		path.lineTo( 100, 0 );
+		path.lineTo( 100, 100 );
+		path.lineTo( 0, 100 );
+		path.close();
+		REQUIRE( calcCoveredArea( strokeMesh( geom::Stroke( path, 10 ) ) ) == Approx( 4100 ) );
+	}
+
+	SECTION( "Dashes" )
+	{
+		geom::Stroke stroke( PolyLine2f( { vec2( 0, 0 ), vec2( 60, 0 ), vec2( 100, 0 ) } ), 2 );
+		// dashes at 0-10, 15-25, ... 90-100
+		REQUIRE( calcCoveredArea( strokeMesh( stroke.dashes( { 10, 5 } ) ) ) == Approx( 140 ) );
+		// shifted by 5: dashes at 0-5, 10-20, ... 85-95
+		REQUIRE( calcCoveredArea( strokeMesh( stroke.dashes( { 10, 5 }, 5 ) ) ) == Approx( 130 ) );
+		// an odd pattern is repeated: dashes at 0-10, 20-30, ... 80-90
+		REQUIRE( calcCoveredArea( strokeMesh( stroke.dashes( { 10 } ) ) ) == Approx( 100 ) );
+	}
+
+	SECTION( "Per-point widths and colors" )
+	{
+		const PolyLine2f line( { vec2( 0, 0 ), vec2( 100, 0 ) } );
+		geom::Stroke stroke;
+		stroke.append( line, { 0, 20 }, { ColorAf( 1, 0, 0, 1 ), ColorAf( 0, 0, 1, 1 ) } );
+		TriMesh mesh = strokeMesh( stroke );
+		REQUIRE( calcCoveredArea( mesh ) == Approx( 1000 ) );
+		REQUIRE( mesh.getColors<4>()[0] == ColorAf( 1, 0, 0, 1 ) );
+		REQUIRE( mesh.getColors<4>()[1] == ColorAf( 0, 0, 1, 1 ) );
+		REQUIRE( mesh.getTexCoords0<2>()[1] == vec2( 100, 0 ) );
+		REQUIRE( mesh.getTexCoords0<2>()[3] == vec2( 100, 1 ) );
+
+		REQUIRE_THROWS_AS( stroke.append( line, { 1 } ), geom::Exc );
+	}
+
+	SECTION( "Lines are batched into one mesh" )
+	{
+		geom::Stroke stroke;
+		stroke.width( 2 ).join( geom::Stroke::JOIN_ROUND ).cap( geom::Stroke::CAP_ROUND );
+		for( int l = 0; l < 500; ++l ) {
+			PolyLine2f zigzag;
+			for( int i = 0; i < 20; ++i )
+				zigzag.push_back( vec2( i * 10, l * 20 + ( i & 1 ) * 10 ) );
+			stroke.append( zigzag );
+		}
+		REQUIRE( stroke.getNumLines() == 500 );
+		TriMesh mesh = strokeMesh( stroke );
+		REQUIRE( mesh.getNumVertices() == stroke.getNumVertices() );
+		bool indicesValid = true;
+		for( uint32_t index : mesh.getIndices() )
+			indicesValid = indicesValid && index < mesh.getNumVertices();
+		REQUIRE( indicesValid );
+
+		// each line covers the same area
+		geom::Stroke single;
+		single.width( 2 ).join( geom::Stroke::JOIN_ROUND ).cap( geom::Stroke::CAP_ROUND );
+		PolyLine2f zigzag;
+		for( int i = 0; i < 20; ++i )
+			zigzag.push_back( vec2( i * 10, ( i & 1 ) * 10 ) );
+		single.append( zigzag );
+		REQUIRE( calcCoveredArea( mesh ) == Approx( calcCoveredArea( strokeMesh( single ) ) * 500 ).epsilon( 1e-4 ) );
+
+		stroke.clear();
+		REQUIRE( stroke.getNumVertices() == 0 );
+	}
+}
@@ -0,0 +1,104 @@
+#include "cinder/svg/SvgGl.h"
+
+#include "catch.hpp"
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+svg::DocRef loadDoc( const string &body )
+{
+	const string text = "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" width=\"200\" height=\"200\">" + body + "</svg>";
+	return svg::Doc::create( DataSourceBuffer::create( Buffer::create( (void*)text.data(), text.size() ) ) );
+}
+
+//! Returns the total area of the triangles in \a mesh, counting overlaps more than once
+double calcCoveredArea( const svg::DocMesh &mesh )
+{
+	double result = 0;
+	const auto &positions = mesh.getPositions();
+	const auto &indices = mesh.getIndices();
+	for( size_t t = 0; t < indices.size(); t += 3 ) {
+		const vec2 &a = positions[indices[t]], &b = positions[indices[t + 1]], &c = positions[indices[t + 2]];
+		result += 0.5 * fabs( ( (double)b.x - a.x ) * ( (double)c.y - a.y ) - ( (double)b.y - a.y ) * ( (double)c.x - a.x ) );
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "SvgDocMesh" )
+{
+	SECTION( "fills and strokes in document coordinates" )
+	{
+		auto doc = loadDoc( "<g transform=\"translate(10,20)\"><rect x=\"0\" y=\"0\" width=\"40\" height=\"20\" fill=\"#ff0000\"/></g>"
+							"<rect x=\"100\" y=\"100\" width=\"10\" height=\"10\" fill=\"none\" stroke=\"#0000ff\" stroke-width=\"2\"/>" );
+		auto mesh = svg::DocMesh::create( *doc );
+		REQUIRE( mesh->getNumNodes() == 2 );
+		// a 40x20 fill plus a 12x12 stroke outline minus its 8x8 hole
+		REQUIRE( calcCoveredArea( *mesh ) == Approx( 800 + 144 - 64 ).epsilon( 0.01 ) );
+
+		Rectf fillBounds( mesh->getPositions()[0], mesh->getPositions()[0] );
+		for( size_t v = 0; v < mesh->getPositions().size(); ++v ) {
+			if( mesh->getColors()[v].r > 0.5f )
+				fillBounds.include( mesh->getPositions()[v] );
+			else
+				REQUIRE( mesh->getColors()[v] == ColorAf( 0, 0, 1, 1 ) );
+		}
+		REQUIRE( fillBounds.getUpperLeft() == vec2( 10, 20 ) );
+		REQUIRE( fillBounds.getLowerRight() == vec2( 50, 40 ) );
+	}
+
+	SECTION( "use and opacity" )
+	{
+		auto doc = loadDoc( "<defs><rect id=\"r\" width=\"10\" height=\"10\"/></defs>"
+							"<g opacity=\"0.5\"><use xlink:href=\"#r\" fill-opacity=\"0.5\"/><use xlink:href=\"#r\" transform=\"translate(50,0)\"/></g>" );
+		auto mesh = svg::DocMesh::create( *doc );
+		REQUIRE( mesh->getNumNodes() == 2 );
+		REQUIRE( calcCoveredArea( *mesh ) == Approx( 200 ) );
+		REQUIRE( mesh->getColors().front().a == Approx( 0.25f ) );
+		REQUIRE( mesh->getColors().back().a == Approx( 0.5f ) );
+		REQUIRE( mesh->getPositions().back().x >= 50 );
+	}
+
+	SECTION( "linear gradient" )
+	{
+		auto doc = loadDoc( "<defs><linearGradient id=\"grad\" x1=\"0\" y1=\"0\" x2=\"1\" y2=\"0\"><stop offset=\"0\" stop-color=\"#000000\"/><stop offset=\"1\" stop-color=\"#ffffff\"/></linearGradient></defs>"
+							"<rect x=\"0\" y=\"0\" width=\"100\" height=\"10\" fill=\"url(#grad)\"/>" );
+		auto mesh = svg::DocMesh::create( *doc );
+		for( size_t v = 0; v < mesh->getPositions().size(); ++v )
+			REQUIRE( mesh->getColors()[v].r == Approx( mesh->getPositions()[v].x / 100 ).margin( 0.01 ) );
+	}
+
+	SECTION( "update rewrites changed nodes" )
+	{
+		auto doc = loadDoc( "<rect id=\"a\" width=\"10\" height=\"10\"/><rect id=\"b\" x=\"20\" width=\"10\" height=\"10\"/>" );
+		auto mesh = svg::DocMesh::create( *doc );
+		const size_t numVertices = mesh->getPositions().size();
+		svg::Rect *b = doc->find<svg::Rect>( "b" );
+		REQUIRE( b );
+
+		b->setTransform( mat3( 1, 0, 0, 0, 1, 0, 0, 100, 1 ) );
+		svg::Style style = b->getStyle();
+		style.setFill( svg::Paint( ColorA8u( 0, 255, 0, 255 ) ) );
+		b->setStyle( style );
+		mesh->update();
+		REQUIRE( mesh->getPositions().size() == numVertices );
+		REQUIRE( mesh->getPositions().back().y >= 100 );
+		REQUIRE( mesh->getColors().back() == ColorAf( 0, 1, 0, 1 ) );
+		REQUIRE( mesh->getColors().front() == ColorAf( 0, 0, 0, 1 ) );
+
+		style.setVisible( false );
+		b->setStyle( style );
+		mesh->update();
+		REQUIRE( calcCoveredArea( *mesh ) == Approx( 100 ) );
+
+		// a stroke changes the geometry
+		style.setVisible( true );
+		style.setStroke( svg::Paint( ColorA8u( 0, 0, 255, 255 ) ) );
+		b->setStyle( style );
+		mesh->update();
+		REQUIRE( mesh->getPositions().size() > numVertices );
+	}
+}
@@ -0,0 +1,202 @@
+#include "cinder/TriMesh.h"
+#include "cinder/DataSource.h"
+#include "cinder/DataTarget.h"
+
+#include "catch.hpp"
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+DataSourceRef writeToMemory( const TriMesh &mesh, const TriMesh::BinaryOptions *options )
+{
+	auto stream = OStreamMem::create();
+	if( options )
+		mesh.write( DataTargetStream::createRef( stream ), *options );
+	else
+		mesh.write( DataTargetStream::createRef( stream ) );
+	auto buffer = make_shared<Buffer>( (size_t)stream->tell() );
+	memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+	return DataSourceBuffer::create( buffer );
+}
+
+template<typename T>
+bool buffersMatch( const vector<T> &a, const vector<T> &b, float epsilon = 0 )
+{
+	if( a.size() != b.size() )
+		return false;
+	for( size_t i = 0; i < a.size(); ++i )
+		if( glm::any( glm::greaterThan( glm::abs( a[i] - b[i] ), T( epsilon ) ) ) )
+			return false;
+	return true;
+}
+
+bool buffersMatch( const vector<float> &a, const vector<float> &b, float epsilon = 0 )
+{
+	if( a.size() != b.size() )
+		return false;
+	for( size_t i = 0; i < a.size(); ++i )
+		if( std::abs( a[i] - b[i] ) > epsilon )
+			return false;
+	return true;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "TriMesh" )
+{
+	const auto source = geom::Sphere().subdivisions( 24 ) >> geom::Constant( geom::COLOR, vec3( 1, 0.5f, 0.25f ) );
+	TriMesh mesh( source, TriMesh::Format().positions().normals().texCoords().colors().tangents() );
+	mesh.recalculateTangents();
+
+	SECTION( "Version 3 files round trip exactly" )
+	{
+		TriMesh::BinaryOptions options;
+		TriMesh result;
+		result.read( writeToMemory( mesh, &options ) );
+
+		REQUIRE( result.getIndices() == mesh.getIndices() );
+		REQUIRE( buffersMatch( result.getBufferPositions(), mesh.getBufferPositions() ) );
+		REQUIRE( buffersMatch( result.getNormals(), mesh.getNormals() ) );
+		REQUIRE( buffersMatch( result.getTangents(), mesh.getTangents() ) );
+		REQUIRE( buffersMatch( result.getBufferTexCoords0(), mesh.getBufferTexCoords0() ) );
+		REQUIRE( buffersMatch( result.getBufferColors(), mesh.getBufferColors() ) );
+		REQUIRE( result.getAttribDims( geom::COLOR ) == 3 );
+	}
+
+	SECTION( "Quantized version 3 files decode within tolerance" )
+	{
+		auto options = TriMesh::BinaryOptions().quantizePositions().quantizeNormals().attribs( { geom::POSITION, geom::NORMAL } );
+		auto full = writeToMemory( mesh, nullptr );
+		auto quantized = writeToMemory( mesh, &options );
+		REQUIRE( quantized->getBuffer()->getSize() < full->getBuffer()->getSize() / 2 );
+
+		TriMesh result;
+		result.read( quantized );
+		REQUIRE( result.getIndices() == mesh.getIndices() );
+		REQUIRE( buffersMatch( result.getBufferPositions(), mesh.getBufferPositions(), 1e-3f ) );
+		REQUIRE( buffersMatch( result.getNormals(), mesh.getNormals(), 1e-3f ) );
+		REQUIRE( result.getTangents().empty() );
+	}
+
+	SECTION( "TriMeshBinary loads a mapped file as a geom::Source" )
+	{
+		const fs::path path = fs::temp_directory_path() / "cinder_TriMeshTest.trimesh";
+		mesh.write( writeFile( path ), TriMesh::BinaryOptions().quantizeNormals() );
+		{
+			TriMeshBinary binary( loadFile( path ) );
+			REQUIRE( binary.getNumVertices() == mesh.getNumVertices() );
+			REQUIRE( binary.getNumIndices() == mesh.getNumIndices() );
+			REQUIRE( binary.getAttribData( geom::POSITION ) != nullptr );
+			REQUIRE( binary.isAttribQuantized( geom::NORMAL ) );
+			REQUIRE( binary.getAttribData( geom::NORMAL ) == nullptr );
+
+			TriMesh result( binary );
+			REQUIRE( result.getIndices() == mesh.getIndices() );
+			REQUIRE( buffersMatch( result.getBufferPositions(), mesh.getBufferPositions() ) );
+			REQUIRE( buffersMatch( result.getNormals(), mesh.getNormals(), 1e-3f ) );
+			REQUIRE( buffersMatch( result.getBufferTexCoords0(), mesh.getBufferTexCoords0() ) );
+		}
+		fs::remove( path );
+	}
+
+	SECTION( "Version 2 files still read" )
+	{
+		TriMesh result;
+		result.read( writeToMemory( mesh, nullptr ) );
+		REQUIRE( result.getIndices() == mesh.getIndices() );
+		REQUIRE( buffersMatch( result.getBufferPositions(), mesh.getBufferPositions() ) );
+		REQUIRE( buffersMatch( result.getNormals(), mesh.getNormals() ) );
+	}
+
+	SECTION( "Corrupt version 3 files are rejected" )
+	{
+		TriMesh::BinaryOptions options;
+		auto data = writeToMemory( mesh, &options );
+		auto buffer = data->getBuffer();
+		static_cast<uint8_t*>( buffer->getData() )[buffer->getSize() - 1] ^= 1;
+		REQUIRE_THROWS_AS( TriMeshBinary( data ), TriMeshBinaryExc );
+
+		auto truncated = make_shared<Buffer>( buffer->getData(), buffer->getSize() / 2 );
+		REQUIRE_THROWS_AS( TriMeshBinary( DataSourceBuffer::create( truncated ) ), TriMeshBinaryExc );
+
+		// a vertex count that disagrees with the position stream, in the header that the checksum doesn't cover
+		auto miscounted = writeToMemory( mesh, &options )->getBuffer();
+		static_cast<uint8_t*>( miscounted->getData() )[16] += 1;
+		REQUIRE_THROWS_AS( TriMeshBinary( DataSourceBuffer::create( miscounted ) ), TriMeshBinaryExc );
+
+		// an index past the last vertex, with the checksum left unverified
+		auto badIndex = writeToMemory( mesh, &options )->getBuffer();
+		uint8_t *bytes = static_cast<uint8_t*>( badIndex->getData() );
+		const size_t headerSize = bytes[4] | ( bytes[5] << 8 );
+		const size_t indexOffset = bytes[headerSize + 16] | ( bytes[headerSize + 17] << 8 ) | ( bytes[headerSize + 18] << 16 );
+		bytes[indexOffset] = bytes[indexOffset + 1] = 0xFF;
+		TriMeshBinary unverified( DataSourceBuffer::create( badIndex ), false );
+		REQUIRE_THROWS_AS( TriMesh( unverified ), TriMeshBinaryExc );
+	}
+
+	SECTION( "Recalculated normals match the analytic normals" )
+	{
+		// large enough to be accumulated in parallel ranges
+		TriMesh sphere( geom::Sphere().subdivisions( 200 ), TriMesh::Format().positions().normals().texCoords() );
+		const vector<vec3> analytic = sphere.getNormals();
+		const vec3 *positions = sphere.getPositions<3>();
+		for( bool weighted : { false, true } ) {
+			REQUIRE( sphere.recalculateNormals( false, weighted ) );
+			float maxError = 0;
+			for( size_t v = 0; v < analytic.size(); ++v )
+				if( abs( positions[v].y ) < 0.99f ) // pole vertices only touch degenerate triangles
+					maxError = std::max( maxError, length( sphere.getNormals()[v] - analytic[v] ) );
+			REQUIRE( maxError < 0.05f );
+		}
+
+		// the seam vertices only agree with their twins when smoothed
+		auto seamError = [&] {
+			float result = 0;
+			for( size_t v = 0; v < analytic.size(); ++v )
+				result = std::max( result, length( sphere.getNormals()[v] - analytic[v] ) );
+			return result;
+		};
+		REQUIRE( sphere.recalculateNormals( true ) );
+		REQUIRE( seamError() < 0.01f );
+	}
+
+	SECTION( "Smooth normals average coincident vertices" )
+	{
+		TriMesh cube( geom::Cube(), TriMesh::Format().positions().normals() );
+		REQUIRE( cube.recalculateNormals( true ) );
+		const vec3 *positions = cube.getPositions<3>();
+		for( size_t v = 0; v < cube.getNumVertices(); ++v ) {
+			REQUIRE( glm::all( glm::greaterThan( cube.getNormals()[v] * positions[v], vec3( 0 ) ) ) );
+			for( size_t w = 0; w < v; ++w )
+				if( positions[w] == positions[v] )
+					REQUIRE( cube.getNormals()[w] == cube.getNormals()[v] );
+		}
+
+		REQUIRE( cube.recalculateNormals( false ) );
+		for( size_t v = 0; v < cube.getNumVertices(); ++v )
+			REQUIRE( dot( cube.getNormals()[v], normalize( positions[v] ) ) == Approx( 1 / sqrt( 3.0f ) ) );
+	}
+
+	SECTION( "Recalculated tangents follow the texture coordinates" )
+	{
+		TriMesh plane( geom::Plane().subdivisions( ivec2( 4 ) ), TriMesh::Format().positions().normals().texCoords() );
+		REQUIRE( plane.recalculateTangents() );
+		REQUIRE( plane.recalculateBitangents() );
+		for( size_t v = 0; v < plane.getNumVertices(); ++v ) {
+			REQUIRE( plane.getTangents()[v].x == Approx( 1 ) );
+			REQUIRE( abs( dot( plane.getBitangents()[v], vec3( 0, 0, 1 ) ) ) == Approx( 1 ) );
+		}
+
+		// away from the degenerate poles, the tangents agree with geom::calculateTangents()
+		vector<vec3> reference;
+		geom::calculateTangents( mesh.getNumIndices(), mesh.getIndices().data(), mesh.getNumVertices(), mesh.getPositions<3>(), mesh.getNormals().data(),
+								mesh.getTexCoords0<2>(), &reference, nullptr );
+		for( size_t v = 0; v < mesh.getNumVertices(); ++v ) {
+			REQUIRE( dot( mesh.getTangents()[v], mesh.getNormals()[v] ) == Approx( 0 ).margin( 1e-5 ) );
+			if( abs( mesh.getPositions<3>()[v].y ) < 0.99f )
+				REQUIRE( dot( mesh.getTangents()[v], reference[v] ) > 0.99f );
+		}
+	}
+}
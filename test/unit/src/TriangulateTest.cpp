@@ -0,0 +1,203 @@
+#include "cinder/Triangulate.h"
+#include "cinder/Rand.h"
+
+#include "catch.hpp"
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+double calcSignedArea( const vector<vec2> &positions, const vector<uint32_t> &indices )
+{
+	double result = 0;
+	for( size_t t = 0; t + 2 < indices.size(); t += 3 ) {
+		const vec2 &a = positions[indices[t]], &b = positions[indices[t + 1]], &c = positions[indices[t + 2]];
+		result += 0.5 * ( ( (double)b.x - a.x ) * ( (double)c.y - a.y ) - ( (double)b.y - a.y ) * ( (double)c.x - a.x ) );
+	}
+	return result;
+}
+
+double calcSignedArea( const vector<vec2> &polygon )
+{
+	double result = 0;
+	for( size_t i = 0; i < polygon.size(); ++i ) {
+		const vec2 &a = polygon[i], &b = polygon[( i + 1 ) % polygon.size()];
+		result += 0.5 * ( (double)a.x * b.y - (double)b.x * a.y );
+	}
+	return result;
+}
+
+//! A random star-shaped, and therefore simple, polygon
+vector<vec2> makeStar( Rand *rand, int numPoints )
+{
+	vector<vec2> result;
+	for( int i = 0; i < numPoints; ++i ) {
+		const float angle = i * 2 * (float)M_PI / numPoints;
+		result.push_back( vec2( cos( angle ), sin( angle ) ) * rand->nextFloat( 20, 100 ) );
+	}
+	return result;
+}
+
+Shape2d makeGlyphLikeShape( const vec2 &offset )
+{
+	// an outer contour and a hole, like an 'o'
+	Shape2d result;
+	result.moveTo( offset + vec2( 0, -10 ) );
+	result.curveTo( offset + vec2( 14, -10 ), offset + vec2( 14, 10 ), offset + vec2( 0, 10 ) );
+	result.curveTo( offset + vec2( -14, 10 ), offset + vec2( -14, -10 ), offset + vec2( 0, -10 ) );
+	result.close();
+	result.moveTo( offset + vec2( 0, -6 ) );
+	result.curveTo( offset + vec2( -8, -6 ), offset + vec2( -8, 6 ), offset + vec2( 0, 6 ) );
+	result.curveTo( offset + vec2( 8, 6 ), offset + vec2( 8, -6 ), offset + vec2( 0, -6 ) );
+	result.close();
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "Triangulator" )
+{
+	SECTION( "Ear clipping covers simple polygons of either orientation" )
+	{
+		Rand rand( 17 );
+		for( int iter = 0; iter < 200; ++iter ) {
+			vector<vec2> polygon = makeStar( &rand, 3 + iter );
+			if( iter & 1 )
+				std::reverse( polygon.begin(), polygon.end() );
+			Triangulator triangulator;
+			triangulator.addPolyLine( polygon.data(), polygon.size() );
+			vector<vec2> positions;
+			vector<uint32_t> indices;
+			triangulator.calcMesh( &positions, &indices );
+			REQUIRE( indices.size() == ( polygon.size() - 2 ) * 3 );
+			REQUIRE( calcSignedArea( positions, indices ) == Approx( calcSignedArea( polygon ) ).epsilon( 1e-4 ) );
+		}
+	}
+
+	SECTION( "Ear clipping matches libtess2 on closed paths with collinear points" )
+	{
+		Path2d path;
+		path.moveTo( 0, 0 );
+		path.lineTo( 5, 0 );
+		path.lineTo( 10, 0 );
+		path.lineTo( 10, 10 );
+		path.lineTo( 5, 5 );
+		path.lineTo( 0, 10 );
+		path.close();
+		TriMesh mesh = Triangulator( path ).calcMesh();
+		REQUIRE( calcSignedArea( vector<vec2>( mesh.getPositions<2>(), mesh.getPositions<2>() + mesh.getNumVertices() ), mesh.getIndices() ) == Approx( 75 ) );
+	}
+
+	SECTION( "Self-intersecting polygons and holes fall back to libtess2" )
+	{
+		// a bowtie covers two triangles of area 25 with opposite orientations
+		PolyLine2f bowtie( { vec2( 0, 0 ), vec2( 10, 10 ), vec2( 10, 0 ), vec2( 0, 10 ) } );
+		TriMesh mesh = Triangulator( bowtie ).calcMesh();
+		REQUIRE( mesh.getNumTriangles() == 2 );
+
+		TriMesh ring = Triangulator( makeGlyphLikeShape( vec2( 0 ) ), 4 ).calcMesh();
+		vector<vec2> positions( ring.getPositions<2>(), ring.getPositions<2>() + ring.getNumVertices() );
+		const double area = fabs( calcSignedArea( positions, ring.getIndices() ) );
+		REQUIRE( area > 100 );
+		REQUIRE( area < 300 );
+	}
+
+	SECTION( "The winding rule still applies to a single contour" )
+	{
+		PolyLine2f square( { vec2( 0, 0 ), vec2( 10, 0 ), vec2( 10, 10 ), vec2( 0, 10 ) } );
+		REQUIRE( Triangulator( square ).calcMesh( Triangulator::WINDING_ODD ).getNumTriangles() == 2 );
+		REQUIRE( Triangulator( square ).calcMesh( Triangulator::WINDING_ABS_GEQ_TWO ).getNumTriangles() == 0 );
+	}
+
+	SECTION( "A Triangulator can be reused after calcMesh()" )
+	{
+		PolyLine2f square( { vec2( 0, 0 ), vec2( 10, 0 ), vec2( 10, 10 ), vec2( 0, 10 ) } );
+		Triangulator triangulator( square );
+		REQUIRE( triangulator.calcMesh().getNumTriangles() == 2 );
+		REQUIRE( triangulator.calcMesh().getNumTriangles() == 0 );
+		triangulator.addShape( makeGlyphLikeShape( vec2( 0 ) ) );
+		REQUIRE( triangulator.calcMesh().getNumTriangles() > 0 );
+	}
+
+	SECTION( "Batch triangulation matches individual triangulations" )
+	{
+		vector<Shape2d> shapes;
+		for( int i = 0; i < 100; ++i )
+			shapes.push_back( makeGlyphLikeShape( vec2( i * 30, ( i % 7 ) * 30 ) ) );
+		Shape2d square;
+		square.moveTo( 0, 0 );
+		square.lineTo( 10, 0 );
+		square.lineTo( 10, 10 );
+		square.lineTo( 0, 10 );
+		square.close();
+		shapes.push_back( square );
+		shapes.push_back( Shape2d() );
+
+		Triangulator::Batch batch;
+		Triangulator::calcMeshes( shapes, &batch, 2 );
+		REQUIRE( batch.getNumShapes() == shapes.size() );
+		REQUIRE( batch.mVertexOffsets.back() == batch.mPositions.size() );
+		REQUIRE( batch.mIndexOffsets.back() == batch.mIndices.size() );
+		for( size_t s = 0; s < shapes.size(); ++s ) {
+			TriMesh mesh = Triangulator( shapes[s], 2 ).calcMesh();
+			REQUIRE( batch.mVertexOffsets[s + 1] - batch.mVertexOffsets[s] == mesh.getNumVertices() );
+			REQUIRE( batch.mIndexOffsets[s + 1] - batch.mIndexOffsets[s] == mesh.getNumIndices() );
+			for( size_t i = 0; i < mesh.getNumIndices(); ++i ) {
+				const uint32_t index = batch.mIndices[batch.mIndexOffsets[s] + i];
+				REQUIRE( index >= batch.mVertexOffsets[s] );
+				REQUIRE( batch.mPositions[index] == mesh.getPositions<2>()[mesh.getIndices()[i]] );
+			}
+		}
+		REQUIRE( batch.calcMesh().getNumTriangles() * 3 == batch.mIndices.size() );
+	}
+}
+
+TEST_CASE( "TriangulatorCache" )
+{
+	TriangulatorCache cache( 4 );
+	Shape2d shape = makeGlyphLikeShape( vec2( 0 ) );
+	auto mesh = cache.get( shape );
+	REQUIRE( mesh->getNumTriangles() > 0 );
+	REQUIRE( cache.get( shape ) == mesh );
+	REQUIRE( cache.getNumHits() == 1 );
+	REQUIRE( cache.getNumMisses() == 1 );
+
+	// a different scale, winding or geometry is a different entry
+	REQUIRE( cache.get( shape, 2 ) != mesh );
+	REQUIRE( cache.get( shape, 1, Triangulator::WINDING_NONZERO ) != mesh );
+	REQUIRE( cache.get( makeGlyphLikeShape( vec2( 1, 0 ) ) ) != mesh );
+	REQUIRE( cache.getNumEntries() == 4 );
+
+	// a Path2d shares the entry of a single-contour Shape2d
+	Shape2d single;
+	single.appendContour( shape.getContour( 0 ) );
+	auto singleMesh = cache.get( single );
+	REQUIRE( cache.get( shape.getContour( 0 ) ) == singleMesh );
+
+	// the least recently used entry was discarded
+	REQUIRE( cache.getNumEntries() == 4 );
+	REQUIRE( cache.get( shape ) != mesh );
+
+	cache.setMaxEntries( 1 );
+	REQUIRE( cache.getNumEntries() == 1 );
+	cache.clear();
+	REQUIRE( cache.getNumEntries() == 0 );
+
+	SECTION( "Only repeated shapes are admitted" )
+	{
+		TriangulatorCache repeated( 4, true );
+		// shapes that change on every request never displace the others
+		for( int frame = 0; frame < 10; ++frame )
+			REQUIRE( repeated.get( makeGlyphLikeShape( vec2( frame + 1.0f, 0 ) ) )->getNumTriangles() > 0 );
+		REQUIRE( repeated.getNumEntries() == 0 );
+
+		auto first = repeated.get( shape );
+		REQUIRE( repeated.getNumEntries() == 0 );
+		auto second = repeated.get( shape );
+		REQUIRE( second != first );
+		REQUIRE( repeated.getNumEntries() == 1 );
+		REQUIRE( repeated.get( shape ) == second );
+		REQUIRE( repeated.getNumHits() == 1 );
+	}
+}
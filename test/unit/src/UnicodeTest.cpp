@@ -8,6 +8,8 @@
 
 #include <string>
 
+#include "utf8cpp/checked.h"
+
 using namespace ci;
 using namespace std;
 using namespace ci::app;
@@ -46,4 +48,51 @@ TEST_CASE("Unicode")
 		REQUIRE( u32 == toUtf32( u16 ) );
 	}
 
+	SECTION("Long ASCII runs mixed with multi-byte characters convert and validate.")
+	{
+		string u8;
+		for( int i = 0; i < 1000; ++i ) {
+			u8 += string( i % 37, 'a' + i % 26 );
+			u8 += ( i % 3 == 0 ) ? "\xF0\x9F\x98\x80" : "\xC3\xA9"; // U+1F600, U+00E9
+		}
+		u16string u16;
+		utf8::utf8to16( u8.begin(), u8.end(), back_inserter( u16 ) );
+		u32string u32;
+		utf8::utf8to32( u8.begin(), u8.end(), back_inserter( u32 ) );
+
+		REQUIRE( toUtf16( u8 ) == u16 );
+		REQUIRE( toUtf32( u8 ) == u32 );
+		REQUIRE( toUtf8( u16 ) == u8 );
+		REQUIRE( toUtf8( u32 ) == u8 );
+		REQUIRE( isValidUtf8( u8.c_str(), u8.size() ) );
+
+		string truncated = u8 + string( 40, 'z' ) + "\xE2\x82" + string( 40, 'z' );
+		REQUIRE_FALSE( isValidUtf8( truncated.c_str(), truncated.size() ) );
+		REQUIRE_THROWS_AS( toUtf16( truncated ), utf8::exception );
+	}
+
+	SECTION("Streams transcode across chunk boundaries.")
+	{
+		string u8;
+		for( int i = 0; i < 50000; ++i )
+			u8 += ( i % 5 == 0 ) ? "\xF0\x9F\x98\x80" : ( i % 7 == 0 ) ? "\xE4\xB8\xAD" : "ab";
+		const u16string u16 = toUtf16( u8 );
+		const u32string u32 = toUtf32( u8 );
+
+		auto out16 = OStreamMem::create();
+		transcodeUtf8ToUtf16( IStreamMem::create( u8.data(), u8.size() ), out16 );
+		REQUIRE( u16string( static_cast<const char16_t*>( out16->getBuffer() ), (size_t)out16->tell() / 2 ) == u16 );
+
+		auto out32 = OStreamMem::create();
+		transcodeUtf8ToUtf32( IStreamMem::create( u8.data(), u8.size() ), out32 );
+		REQUIRE( u32string( static_cast<const char32_t*>( out32->getBuffer() ), (size_t)out32->tell() / 4 ) == u32 );
+
+		auto out8 = OStreamMem::create();
+		transcodeUtf16ToUtf8( IStreamMem::create( u16.data(), u16.size() * 2 ), out8 );
+		REQUIRE( string( static_cast<const char*>( out8->getBuffer() ), (size_t)out8->tell() ) == u8 );
+
+		out8 = OStreamMem::create();
+		transcodeUtf32ToUtf8( IStreamMem::create( u32.data(), u32.size() * 4 ), out8 );
+		REQUIRE( string( static_cast<const char*>( out8->getBuffer() ), (size_t)out8->tell() ) == u8 );
+	}
 }
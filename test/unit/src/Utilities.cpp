@@ -3,9 +3,12 @@
 #include "cinder/Cinder.h"
 #include "cinder/Utilities.h"
 #include "cinder/ConcurrentCircularBuffer.h"
+#include "cinder/Stream.h"
 #include "cinder/app/App.h"
 
+#include <atomic>
 #include <iostream>
+#include <thread>
 
 using namespace std;
 using namespace ci;
@@ -186,6 +189,62 @@ TEST_CASE( "Utilities" )
 		REQUIRE( dSum == sum );
 	}
 
+	SECTION( "Compress Buffer Chunked" )
+	{
+		// mildly compressible data spanning several blocks, so that blocks are primed from their predecessors
+		vector<uint32_t> d( 300000 );
+		uint32_t state = 1;
+		for( size_t i = 0; i < d.size(); ++i ) {
+			state = state * 1664525 + 1013904223;
+			d[i] = ( state >> 24 ) + (uint32_t)( i / 64 );
+		}
+		Buffer b( d.data(), d.size() * sizeof(uint32_t) );
+
+		for( bool gzip : { false, true } ) {
+			Buffer compressed = compressBufferChunked( b, DEFAULT_COMPRESSION_LEVEL, gzip, 65536 );
+			REQUIRE( compressed.getSize() < b.getSize() );
+
+			Buffer decompressed = decompressBuffer( compressed, true, gzip );
+			REQUIRE( decompressed.getSize() == b.getSize() );
+			REQUIRE( memcmp( decompressed.getData(), b.getData(), b.getSize() ) == 0 );
+		}
+
+		Buffer empty = decompressBuffer( compressBufferChunked( Buffer( d.data(), 0 ) ) );
+		REQUIRE( empty.getSize() == 0 );
+	}
+
+	SECTION( "Compressing / Decompressing streams" )
+	{
+		auto memStream = OStreamMem::create();
+		{
+			auto compressor = CompressingOStream::create( memStream, 1, false, 4096 );
+			for( int i = 0; i < 20000; ++i )
+				compressor->writeLittle( (int32_t)i );
+			compressor->write( string( "line one\r\nline two" ) );
+			REQUIRE( compressor->tell() == 20000 * 4 + 19 );
+		}
+
+		auto decompressor = DecompressingIStream::create( IStreamMem::create( memStream->getBuffer(), (size_t)memStream->tell() ) );
+		bool valuesMatch = true;
+		for( int i = 0; i < 20000; ++i ) {
+			int32_t v;
+			decompressor->readLittle( &v );
+			valuesMatch = valuesMatch && ( v == i );
+		}
+		REQUIRE( valuesMatch );
+		REQUIRE( decompressor->readLine() == "line one" );
+		REQUIRE( decompressor->readLine() == string( "line two" ) + '\0' );
+		REQUIRE( decompressor->isEof() );
+
+		// compressBuffer() output is a standard zlib stream, readable incrementally
+		Buffer source( memStream->getBuffer(), 1000 );
+		Buffer compressed = compressBuffer( source );
+		auto bufferDecompressor = DecompressingIStream::create( IStreamMem::create( compressed.getData(), compressed.getSize() ) );
+		auto roundTrip = loadStreamBuffer( bufferDecompressor );
+		REQUIRE( roundTrip->getSize() == 1000 );
+		REQUIRE( memcmp( roundTrip->getData(), source.getData(), 1000 ) == 0 );
+	}
+
 	SECTION( "toString / fromString" )
 	{
 		REQUIRE( toString( 123 ) == string( "123" ) );
@@ -304,4 +363,140 @@ TEST_CASE( "Utilities" )
 		testStreamingBufferBlockSize( 10 ); // wrap for i/o
 		testStreamingBufferBlockSize( 65535 ); // no wrap for i/o
 	}
+
+	SECTION( "StreamingBuffer spans" )
+	{
+		StreamingBuffer sb( 8, 1 );
+		size_t size;
+		uint8_t *dest = reinterpret_cast<uint8_t*>( sb.acquireWrite( 5, &size ) );
+		REQUIRE( size == 5 );
+		memcpy( dest, "hello", 5 );
+		REQUIRE( sb.getSize() == 0 ); // not yet committed
+		sb.commitWrite( 5 );
+		REQUIRE( sb.getSize() == 5 );
+
+		// only 3 bytes remain in the first block
+		dest = reinterpret_cast<uint8_t*>( sb.acquireWrite( 6, &size ) );
+		REQUIRE( size == 3 );
+		memcpy( dest, " wo", 3 );
+		sb.commitWrite( 3 );
+		sb.pushFront( "rld", 3 );
+
+		const char *src = reinterpret_cast<const char*>( sb.peekRead( &size ) );
+		REQUIRE( size == 8 );
+		REQUIRE( std::string( src, 6 ) == "hello " );
+		sb.consume( 6 );
+		char rest[5] = { 0 };
+		REQUIRE( sb.copyTo( rest, 5 ) == 5 );
+		REQUIRE( std::string( rest, 5 ) == "world" );
+		sb.consume( 2 );
+		src = reinterpret_cast<const char*>( sb.peekRead( &size ) );
+		REQUIRE( std::string( src, size ) == "rld" );
+		sb.consume( 3 );
+		REQUIRE( sb.empty() );
+		sb.peekRead( &size );
+		REQUIRE( size == 0 );
+	}
+
+	SECTION( "StreamingBuffer concurrent producer / consumer" )
+	{
+		StreamingBuffer sb( 1000 );
+		const uint32_t count = 500000;
+		std::thread producer( [&] {
+			uint32_t next = 0;
+			while( next < count ) {
+				// alternate between copying and span writes of varying lengths
+				if( next % 3 ) {
+					uint32_t values[7];
+					uint32_t n = std::min<uint32_t>( 1 + next % 7, count - next );
+					for( uint32_t i = 0; i < n; ++i )
+						values[i] = next++;
+					sb.pushFront( values, n * sizeof(uint32_t) );
+				}
+				else {
+					size_t size;
+					uint8_t *dest = reinterpret_cast<uint8_t*>( sb.acquireWrite( sizeof(uint32_t), &size ) );
+					if( size == sizeof(uint32_t) ) {
+						memcpy( dest, &next, sizeof(uint32_t) );
+						sb.commitWrite( sizeof(uint32_t) );
+					}
+					else
+						sb.pushFront( &next, sizeof(uint32_t) );
+					++next;
+				}
+			}
+		} );
+
+		uint32_t expected = 0;
+		bool inOrder = true;
+		while( expected < count ) {
+			uint32_t value;
+			if( sb.getSize() >= sizeof(uint32_t) ) {
+				sb.popBack( &value, sizeof(uint32_t) );
+				inOrder = inOrder && ( value == expected );
+				++expected;
+			}
+			else
+				std::this_thread::yield();
+		}
+		producer.join();
+
+		REQUIRE( inOrder );
+		REQUIRE( sb.empty() );
+	}
+
+	SECTION( "StreamingBuffer clear() from another thread" )
+	{
+		StreamingBuffer sb( 4 );
+		sb.pushFront( "abcdefghij", 10 );
+		std::thread( [&] { sb.clear(); } ).join();
+		REQUIRE( sb.empty() );
+		char rest[4] = { 0 };
+		REQUIRE( sb.copyTo( rest, 4 ) == 0 );
+
+		sb.pushFront( "xyz", 3 );
+		REQUIRE( sb.getSize() == 3 );
+		REQUIRE( sb.copyTo( rest, 4 ) == 3 );
+		REQUIRE( std::string( rest, 3 ) == "xyz" );
+		REQUIRE( sb.popBack( rest, 4 ) == 3 );
+		REQUIRE( std::string( rest, 3 ) == "xyz" );
+		REQUIRE( sb.empty() );
+	}
+
+	SECTION( "StreamingBuffer shrinkToFit() and clear() alongside producer / consumer" )
+	{
+		// the producer clears now and then; the consumer must only ever see increasing values
+		StreamingBuffer sb( 64, 1 );
+		const uint32_t count = 200000;
+		std::atomic<bool> done( false );
+		std::thread producer( [&] {
+			for( uint32_t next = 1; next <= count; ++next ) {
+				sb.pushFront( &next, sizeof(uint32_t) );
+				if( next % 1000 == 0 )
+					sb.clear();
+			}
+			done = true;
+		} );
+		std::thread shrinker( [&] {
+			while( ! done )
+				sb.shrinkToFit();
+		} );
+
+		uint32_t last = 0;
+		bool increasing = true;
+		while( ! done || ! sb.empty() ) {
+			uint32_t value;
+			if( sb.getSize() >= sizeof(uint32_t) && sb.popBack( &value, sizeof(uint32_t) ) == sizeof(uint32_t) ) {
+				increasing = increasing && ( value > last );
+				last = value;
+			}
+			else
+				std::this_thread::yield();
+		}
+		producer.join();
+		shrinker.join();
+
+		REQUIRE( increasing );
+		REQUIRE( sb.empty() );
+	}
 }
@@ -0,0 +1,70 @@
+// Converts images to and from Cinder's .cimg container, e.g. for baking runtime asset bundles:
+//   cimgconvert [--compress] [--mipmap] [--align <bytes>] [--tile-height <rows>] <input> <output>
+// Any format ImageIo can load is accepted as input. Options only apply when <output> ends in .cimg;
+// other extensions are written through ImageIo as usual, which allows converting .cimg files back.
+
+#include "cinder/app/Platform.h"
+#include "cinder/ImageFileCimg.h"
+#include "cinder/Utilities.h"
+
+#include <iostream>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+void printUsage()
+{
+	cerr << "usage: cimgconvert [--compress] [--mipmap] [--align <bytes>] [--tile-height <rows>] <input> <output>" << endl;
+}
+
+} // anonymous namespace
+
+int main( int argc, char *argv[] )
+{
+	ImageTargetFileCimg::CimgOptions options;
+	vector<string> paths;
+	for( int i = 1; i < argc; ++i ) {
+		const string arg = argv[i];
+		if( arg == "--compress" )
+			options.compress();
+		else if( arg == "--mipmap" )
+			options.mipmap();
+		else if( arg == "--align" && i + 1 < argc )
+			options.rowAlignment( fromString<size_t>( argv[++i] ) );
+		else if( arg == "--tile-height" && i + 1 < argc )
+			options.tileHeight( fromString<int32_t>( argv[++i] ) );
+		else if( arg.size() > 1 && arg[0] == '-' ) {
+			printUsage();
+			return 1;
+		}
+		else
+			paths.push_back( arg );
+	}
+
+	if( paths.size() != 2 ) {
+		printUsage();
+		return 1;
+	}
+
+	// the Platform registers the ImageIo handlers available on this system, including .cimg
+	app::Platform::get();
+
+	try {
+		const fs::path input = paths[0], output = paths[1];
+		ImageSourceRef source = loadImage( input );
+		if( output.extension() == ".cimg" )
+			writeImage( ImageTargetFileCimg::create( writeFile( output ), source, ImageTarget::Options(), "cimg", options ), source );
+		else
+			writeImage( output, source );
+
+		cout << input.string() << " (" << source->getWidth() << "x" << source->getHeight() << ") -> " << output.string() << " (" << fs::file_size( output ) << " bytes)" << endl;
+	}
+	catch( const std::exception &exc ) {
+		cerr << "cimgconvert: " << exc.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}